@@ -18,6 +18,7 @@
 
 #import <XCTest/XCTest.h>
 
+#import "RLMSyncManager_Private.h"
 #import "RLMSyncSessionRefreshHandle+ObjectServerTests.h"
 
 @interface RLMAncillaryObjectServerTests : XCTestCase
@@ -55,4 +56,24 @@
     XCTAssertLessThan(fireDate.timeIntervalSinceReferenceDate, date.timeIntervalSinceReferenceDate);
 }
 
+/// Ensure requests to the authentication server use a session built from `authSessionConfiguration`.
+- (void)testAuthSessionConfiguration {
+    RLMSyncManager *manager = [RLMSyncManager sharedManager];
+    XCTAssertTrue(manager.authSessionConfiguration.HTTPShouldUsePipelining);
+    NSURLSession *defaultSession = manager._authSession;
+    XCTAssertNotEqual(defaultSession, [NSURLSession sharedSession]);
+    XCTAssertEqual(defaultSession, manager._authSession);
+
+    NSURLSessionConfiguration *configuration = [NSURLSessionConfiguration ephemeralSessionConfiguration];
+    configuration.HTTPMaximumConnectionsPerHost = 2;
+    manager.authSessionConfiguration = configuration;
+    XCTAssertEqual(manager.authSessionConfiguration.HTTPMaximumConnectionsPerHost, 2);
+    XCTAssertNotEqual(manager._authSession, defaultSession);
+    XCTAssertEqual(manager._authSession.configuration.HTTPMaximumConnectionsPerHost, 2);
+
+    manager.authSessionConfiguration = nil;
+    XCTAssertTrue(manager.authSessionConfiguration.HTTPShouldUsePipelining);
+    XCTAssertNotEqual(manager._authSession.configuration.HTTPMaximumConnectionsPerHost, 2);
+}
+
 @end
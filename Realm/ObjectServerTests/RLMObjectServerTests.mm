@@ -18,6 +18,7 @@
 
 #import "RLMSyncTestCase.h"
 #import "RLMSyncSessionRefreshHandle+ObjectServerTests.h"
+#import "RLMSyncSession_Private.hpp"
 #import "RLMSyncUser+ObjectServerTests.h"
 #import "RLMSyncUtil_Private.h"
 #import "RLMRealmConfiguration_Private.h"
@@ -188,6 +189,29 @@
 
 #pragma mark - Users
 
+/// Concurrent logins with the same credentials should share one request and return the same user.
+- (void)testConcurrentLoginsWithSameCredentials {
+    RLMSyncCredentials *credentials = [RLMObjectServerTests basicCredentialsWithName:ACCOUNT_NAME() register:YES];
+    NSMutableArray<RLMSyncUser *> *users = [NSMutableArray array];
+    for (int i = 0; i < 3; i++) {
+        XCTestExpectation *ex = [self expectationWithDescription:@"login"];
+        [RLMSyncUser logInWithCredentials:credentials
+                            authServerURL:[RLMObjectServerTests authServerURL]
+                             onCompletion:^(RLMSyncUser *user, NSError *error) {
+            XCTAssertNil(error);
+            XCTAssertNotNil(user);
+            @synchronized (users) {
+                [users addObject:user];
+            }
+            [ex fulfill];
+        }];
+    }
+    [self waitForExpectationsWithTimeout:4.0 handler:nil];
+    XCTAssertEqual(users.count, 3U);
+    XCTAssertEqual(users[0], users[1]);
+    XCTAssertEqual(users[1], users[2]);
+}
+
 /// `[RLMSyncUser all]` should be updated once a user is logged in.
 - (void)testBasicUserPersistence {
     XCTAssertNil([RLMSyncUser currentUser]);
@@ -1042,6 +1066,71 @@
               @(transferred), @(transferrable));
 }
 
+- (void)testMetricsNotifications {
+    const NSInteger NUMBER_OF_BIG_OBJECTS = 2;
+    NSURL *url = REALM_URL();
+    RLMSyncUser *user = [self logInUserForCredentials:[RLMObjectServerTests basicCredentialsWithName:ACCOUNT_NAME()
+                                                                                            register:self.isParent]
+                                               server:[RLMObjectServerTests authServerURL]];
+    RLMRealm *realm = [self openRealmForURL:url user:user];
+    RLMSyncSession *session = [user sessionForURL:url];
+    XCTAssertNotNil(session);
+
+    XCTestExpectation *ex = [self expectationWithDescription:@"metrics-expectation"];
+    __block BOOL hasBeenFulfilled = NO;
+    RLMProgressNotificationToken *token = [session addMetricsNotificationBlock:^(NSDictionary *metrics) {
+        XCTAssertGreaterThanOrEqual([metrics[@"uploadableBytes"] unsignedLongLongValue],
+                                    [metrics[@"uploadedBytes"] unsignedLongLongValue]);
+        XCTAssertGreaterThanOrEqual([metrics[@"uploadRate"] doubleValue], 0);
+        XCTAssertNotNil(metrics[@"downloadBacklog"]);
+        if ([metrics[@"uploadedBytes"] unsignedLongLongValue] > 0
+            && [metrics[@"uploadBacklog"] unsignedLongLongValue] == 0 && !hasBeenFulfilled) {
+            hasBeenFulfilled = YES;
+            [ex fulfill];
+        }
+    }];
+    XCTAssertNotNil(token);
+    [realm beginWriteTransaction];
+    for (NSInteger i=0; i<NUMBER_OF_BIG_OBJECTS; i++) {
+        [realm addObject:[HugeSyncObject object]];
+    }
+    [realm commitWriteTransaction];
+    [self waitForExpectationsWithTimeout:10.0 handler:nil];
+    [token stop];
+}
+
+- (void)testUploadBacklogNotifications {
+    const NSInteger NUMBER_OF_BIG_OBJECTS = 2;
+    NSURL *url = REALM_URL();
+    RLMSyncUser *user = [self logInUserForCredentials:[RLMObjectServerTests basicCredentialsWithName:ACCOUNT_NAME()
+                                                                                            register:self.isParent]
+                                               server:[RLMObjectServerTests authServerURL]];
+    RLMRealm *realm = [self openRealmForURL:url user:user];
+    RLMSyncSession *session = [user sessionForURL:url];
+    XCTAssertNotNil(session);
+
+    XCTestExpectation *exceededEx = [self expectationWithDescription:@"backlog exceeded"];
+    XCTestExpectation *drainedEx = [self expectationWithDescription:@"backlog drained"];
+    RLMProgressNotificationToken *token = [session addUploadBacklogNotificationWithHighWaterMark:1024
+                                                                                            block:^(NSUInteger backlog, BOOL exceeded) {
+        if (exceeded) {
+            XCTAssertGreaterThan(backlog, 1024U);
+            [exceededEx fulfill];
+        } else {
+            XCTAssertLessThanOrEqual(backlog, 1024U);
+            [drainedEx fulfill];
+        }
+    }];
+    XCTAssertNotNil(token);
+    [realm beginWriteTransaction];
+    for (NSInteger i=0; i<NUMBER_OF_BIG_OBJECTS; i++) {
+        [realm addObject:[HugeSyncObject object]];
+    }
+    [realm commitWriteTransaction];
+    [self waitForExpectationsWithTimeout:10.0 handler:nil];
+    [token stop];
+}
+
 #pragma mark - Download Realm
 
 - (void)testDownloadRealm {
@@ -1096,6 +1185,46 @@
     }
 }
 
+- (void)testDownloadRealmWithInitialDownloadSize {
+    const NSInteger NUMBER_OF_BIG_OBJECTS = 2;
+    NSURL *url = REALM_URL();
+    // Log in the user.
+    RLMSyncUser *user = [self logInUserForCredentials:[RLMObjectServerTests basicCredentialsWithName:ACCOUNT_NAME()
+                                                                                            register:self.isParent]
+                                               server:[RLMObjectServerTests authServerURL]];
+    if (self.isParent) {
+        // Wait for the child process to upload everything.
+        RLMRunChildAndWait();
+        XCTestExpectation *ex = [self expectationWithDescription:@"download-realm"];
+        RLMRealmConfiguration *c = [RLMRealmConfiguration defaultConfiguration];
+        c.syncConfiguration = [[RLMSyncConfiguration alloc] initWithUser:user realmURL:url];
+        __block RLMRealm *openedRealm;
+        [RLMRealm asyncOpenWithConfiguration:c
+                         initialDownloadSize:1
+                               callbackQueue:dispatch_get_main_queue()
+                                    callback:^(RLMRealm * _Nullable realm, NSError * _Nullable error) {
+            XCTAssertNil(error);
+            XCTAssertNotNil(realm);
+            openedRealm = realm;
+            [ex fulfill];
+        }];
+        [self waitForExpectationsWithTimeout:10.0 handler:nil];
+        // The rest of the content keeps downloading once the Realm is open
+        [self waitForDownloadsForUser:user url:url];
+        [openedRealm refresh];
+        CHECK_COUNT(NUMBER_OF_BIG_OBJECTS, HugeSyncObject, openedRealm);
+    } else {
+        RLMRealm *realm = [self openRealmForURL:url user:user];
+        [realm beginWriteTransaction];
+        for (NSInteger i=0; i<NUMBER_OF_BIG_OBJECTS; i++) {
+            [realm addObject:[HugeSyncObject object]];
+        }
+        [realm commitWriteTransaction];
+        [self waitForUploadsForUser:user url:url];
+        CHECK_COUNT(NUMBER_OF_BIG_OBJECTS, HugeSyncObject, realm);
+    }
+}
+
 - (void)testDownloadAlreadyOpenRealm {
     const NSInteger NUMBER_OF_BIG_OBJECTS = 2;
     NSURL *url = REALM_URL();
@@ -1248,6 +1377,42 @@
     [token stop];
 }
 
+/// Submit several permission changes at once and wait for all of them to be processed.
+- (void)testBatchedPermissionChanges {
+    NSString *userNameA = [ACCOUNT_NAME() stringByAppendingString:@"_A"];
+    RLMSyncUser *userA = [self logInUserForCredentials:[RLMObjectServerTests basicCredentialsWithName:userNameA
+                                                                                             register:self.isParent]
+                                               server:[RLMObjectServerTests authServerURL]];
+
+    NSString *userNameB = [ACCOUNT_NAME() stringByAppendingString:@"_B"];
+    RLMSyncUser *userB = [self logInUserForCredentials:[RLMObjectServerTests basicCredentialsWithName:userNameB
+                                                                                             register:self.isParent]
+                                                server:[RLMObjectServerTests authServerURL]];
+
+    NSMutableArray *changes = [NSMutableArray array];
+    for (NSString *suffix in @[@"1", @"2", @"3"]) {
+        NSURL *url = [REALM_URL() URLByAppendingPathComponent:suffix];
+        RLMRealm *realm = [self openRealmForURL:url user:userA];
+        NSString *realmURL = realm.configuration.syncConfiguration.realmURL.absoluteString;
+        [changes addObject:[RLMSyncPermissionChange permissionChangeWithRealmURL:realmURL
+                                                                          userID:userB.identity
+                                                                            read:@YES
+                                                                           write:@NO
+                                                                          manage:@NO]];
+    }
+
+    XCTestExpectation *ex = [self expectationWithDescription:@"batched permission changes"];
+    [userA applyPermissionChanges:changes completion:^(NSArray *failedChanges, NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertEqual(failedChanges.count, 0U);
+        [ex fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:10.0 handler:nil];
+    for (RLMSyncPermissionChange *change in changes) {
+        XCTAssertEqual(change.status, RLMSyncManagementObjectStatusSuccess);
+    }
+}
+
 /// Grant/revoke access a user's Realm to another user. Another user has no access permission by default.
 - (void)testPermissionChange {
     NSString *userNameA = [ACCOUNT_NAME() stringByAppendingString:@"_A"];
@@ -1787,3 +1952,216 @@
 }
 
 @end
+
+#pragma mark - Benchmarks
+
+// The shape of the workload used by the sync benchmarks. Each changeset is a
+// single write transaction creating objects holding a total of
+// REALM_SYNC_BENCHMARK_CHANGESET_SIZE bytes of string data (default 1024), and
+// each benchmark writes REALM_SYNC_BENCHMARK_CHANGESETS of them (default 100),
+// split across REALM_SYNC_BENCHMARK_SESSIONS Realms (default 4) for the
+// fan-out benchmark. The defaults are small enough for the benchmarks to run
+// as part of the regular suite.
+static NSUInteger syncBenchmarkParameter(const char *name, NSUInteger defaultValue) {
+    const char *value = getenv(name);
+    return value ? (NSUInteger)strtoull(value, NULL, 10) : defaultValue;
+}
+
+static NSUInteger syncBenchmarkChangesets() {
+    return syncBenchmarkParameter("REALM_SYNC_BENCHMARK_CHANGESETS", 100);
+}
+
+static NSUInteger syncBenchmarkChangesetSize() {
+    return syncBenchmarkParameter("REALM_SYNC_BENCHMARK_CHANGESET_SIZE", 1024);
+}
+
+static NSUInteger syncBenchmarkSessions() {
+    return MAX(syncBenchmarkParameter("REALM_SYNC_BENCHMARK_SESSIONS", 4), 1U);
+}
+
+// The results of each benchmark, keyed by test name, which are written out as
+// JSON if REALM_SYNC_BENCHMARK_OUTPUT is set
+static NSMutableDictionary<NSString *, NSDictionary *> *s_syncBenchmarkResults;
+
+@interface RLMSyncBenchmarkTests : RLMSyncTestCase
+@end
+
+@implementation RLMSyncBenchmarkTests
+
++ (void)tearDown {
+    const char *outputPath = getenv("REALM_SYNC_BENCHMARK_OUTPUT");
+    if (outputPath && s_syncBenchmarkResults) {
+        NSData *json = [NSJSONSerialization dataWithJSONObject:@{@"changesets": @(syncBenchmarkChangesets()),
+                                                                 @"changesetSize": @(syncBenchmarkChangesetSize()),
+                                                                 @"sessions": @(syncBenchmarkSessions()),
+                                                                 @"results": s_syncBenchmarkResults}
+                                                       options:NSJSONWritingPrettyPrinted error:nil];
+        [json writeToFile:@(outputPath) atomically:YES];
+    }
+    [super tearDown];
+}
+
+- (RLMSyncUser *)logInBenchmarkUserForTest:(SEL)test {
+    return [self logInUserForCredentials:[RLMSyncBenchmarkTests basicCredentialsWithName:NSStringFromSelector(test)
+                                                                                register:self.isParent]
+                                  server:[RLMSyncBenchmarkTests authServerURL]];
+}
+
+// Write `count` changesets of the benchmark size to the Realm, starting the
+// object descriptions at `first` so that the changesets for each Realm differ
+- (void)writeChangesets:(NSUInteger)count toRealm:(RLMRealm *)realm first:(NSUInteger)first {
+    NSUInteger size = syncBenchmarkChangesetSize();
+    NSString *padding = [@"" stringByPaddingToLength:size withString:@"abcdefghijklmnopqrstuvwxyz" startingAtIndex:0];
+    for (NSUInteger i = first; i < first + count; ++i) {
+        [realm beginWriteTransaction];
+        NSString *prefix = [NSString stringWithFormat:@"%lu:", (unsigned long)i];
+        NSString *value = [prefix stringByAppendingString:[padding substringFromIndex:MIN(prefix.length, size)]];
+        [SyncObject createInRealm:realm withValue:@[value]];
+        [realm commitWriteTransaction];
+    }
+}
+
+// Wait for the session to finish uploading or downloading, with a timeout
+// long enough for the larger workloads
+- (void)waitForSession:(RLMSyncSession *)session uploads:(BOOL)uploads {
+    XCTestExpectation *ex = [self expectationWithDescription:@"Benchmark transfer"];
+    dispatch_queue_t queue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_HIGH, 0);
+    if (uploads) {
+        [session waitForUploadCompletionOnQueue:queue callback:^{ [ex fulfill]; }];
+    }
+    else {
+        [session waitForDownloadCompletionOnQueue:queue callback:^{ [ex fulfill]; }];
+    }
+    [self waitForExpectationsWithTimeout:300.0 handler:nil];
+}
+
+// Record the measured duration of a benchmark which transferred `changesets`
+// changesets, along with the throughput derived from it
+- (void)recordBenchmark:(CFTimeInterval)seconds changesets:(NSUInteger)changesets {
+    NSString *name = NSStringFromSelector(self.invocation.selector);
+    double bytes = (double)changesets * syncBenchmarkChangesetSize();
+    NSMutableDictionary *result = [@{@"seconds": @(seconds)} mutableCopy];
+    if (changesets && seconds > 0) {
+        result[@"changesetsPerSecond"] = @(changesets / seconds);
+        result[@"bytesPerSecond"] = @(bytes / seconds);
+    }
+    NSLog(@"Sync benchmark %@: %@", name, result);
+    if (!s_syncBenchmarkResults) {
+        s_syncBenchmarkResults = [NSMutableDictionary dictionary];
+    }
+    s_syncBenchmarkResults[name] = result;
+}
+
+/// Time from the first local commit until the server has acknowledged all of
+/// the changesets.
+- (void)testUploadThroughput {
+    NSURL *url = REALM_URL();
+    RLMSyncUser *user = [self logInBenchmarkUserForTest:_cmd];
+    RLMRealm *realm = [self openRealmForURL:url user:user];
+    NSUInteger changesets = syncBenchmarkChangesets();
+
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    [self writeChangesets:changesets toRealm:realm first:0];
+    [self waitForSession:[user sessionForURL:url] uploads:YES];
+    [self recordBenchmark:CFAbsoluteTimeGetCurrent() - start changesets:changesets];
+    CHECK_COUNT((NSInteger)changesets, SyncObject, realm);
+}
+
+/// Time for a fresh device to download and integrate changesets uploaded by
+/// another device, once its session is bound.
+- (void)testDownloadThroughput {
+    NSURL *url = REALM_URL();
+    RLMSyncUser *user = [self logInBenchmarkUserForTest:_cmd];
+    NSUInteger changesets = syncBenchmarkChangesets();
+    if (self.isParent) {
+        RLMRunChildAndWait();
+        RLMRealm *realm = [self openRealmForURL:url user:user];
+        CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+        [self waitForSession:[user sessionForURL:url] uploads:NO];
+        [realm refresh];
+        [self recordBenchmark:CFAbsoluteTimeGetCurrent() - start changesets:changesets];
+        CHECK_COUNT((NSInteger)changesets, SyncObject, realm);
+    } else {
+        RLMRealm *realm = [self openRealmForURL:url user:user];
+        [self writeChangesets:changesets toRealm:realm first:0];
+        [self waitForSession:[user sessionForURL:url] uploads:YES];
+    }
+}
+
+/// Time from calling asyncOpen on a fresh device until the callback is given
+/// a Realm with all of the server's data.
+- (void)testAsyncOpenTimeToReady {
+    NSURL *url = REALM_URL();
+    RLMSyncUser *user = [self logInBenchmarkUserForTest:_cmd];
+    NSUInteger changesets = syncBenchmarkChangesets();
+    if (self.isParent) {
+        RLMRunChildAndWait();
+        RLMRealmConfiguration *c = [RLMRealmConfiguration defaultConfiguration];
+        c.syncConfiguration = [[RLMSyncConfiguration alloc] initWithUser:user realmURL:url];
+        XCTestExpectation *ex = [self expectationWithDescription:@"async open"];
+        __block CFAbsoluteTime end = 0;
+        CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+        [RLMRealm asyncOpenWithConfiguration:c
+                               callbackQueue:dispatch_get_main_queue()
+                                    callback:^(RLMRealm *realm, NSError *error) {
+            end = CFAbsoluteTimeGetCurrent();
+            XCTAssertNil(error);
+            CHECK_COUNT((NSInteger)changesets, SyncObject, realm);
+            [ex fulfill];
+        }];
+        [self waitForExpectationsWithTimeout:300.0 handler:nil];
+        [self recordBenchmark:end - start changesets:changesets];
+    } else {
+        RLMRealm *realm = [self openRealmForURL:url user:user];
+        [self writeChangesets:changesets toRealm:realm first:0];
+        [self waitForSession:[user sessionForURL:url] uploads:YES];
+    }
+}
+
+/// Time from resuming a session which was suspended while changesets were
+/// written until all of them have been uploaded.
+- (void)testReconnectRecovery {
+    NSURL *url = REALM_URL();
+    RLMSyncUser *user = [self logInBenchmarkUserForTest:_cmd];
+    RLMRealm *realm = [self openRealmForURL:url user:user];
+    RLMSyncSession *session = [user sessionForURL:url];
+    NSUInteger changesets = syncBenchmarkChangesets();
+
+    [session suspend];
+    [self writeChangesets:changesets toRealm:realm first:0];
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    [session resume];
+    [self waitForSession:session uploads:YES];
+    [self recordBenchmark:CFAbsoluteTimeGetCurrent() - start changesets:changesets];
+    CHECK_COUNT((NSInteger)changesets, SyncObject, realm);
+}
+
+/// Time for several sessions syncing at once to upload the changesets written
+/// to each of their Realms, which together add up to the benchmark workload.
+- (void)testMultiSessionFanOut {
+    RLMSyncUser *user = [self logInBenchmarkUserForTest:_cmd];
+    NSUInteger sessions = syncBenchmarkSessions();
+    NSUInteger perSession = MAX(syncBenchmarkChangesets() / sessions, 1U);
+
+    NSMutableArray<NSURL *> *urls = [NSMutableArray array];
+    NSMutableArray<RLMRealm *> *realms = [NSMutableArray array];
+    for (NSUInteger i = 0; i < sessions; ++i) {
+        NSURL *url = CUSTOM_REALM_URL(([NSString stringWithFormat:@"%lu", (unsigned long)i]));
+        [urls addObject:url];
+        [realms addObject:[self openRealmForURL:url user:user]];
+    }
+
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    for (NSUInteger i = 0; i < sessions; ++i) {
+        [self writeChangesets:perSession toRealm:realms[i] first:i * perSession];
+    }
+    for (NSURL *url in urls) {
+        [self waitForSession:[user sessionForURL:url] uploads:YES];
+    }
+    [self recordBenchmark:CFAbsoluteTimeGetCurrent() - start changesets:perSession * sessions];
+    for (RLMRealm *realm in realms) {
+        CHECK_COUNT((NSInteger)perSession, SyncObject, realm);
+    }
+}
+
+@end
@@ -43,6 +43,29 @@ Class RLMUnmanagedAccessorClassForObjectClass(Class objectClass, RLMObjectSchema
 FOUNDATION_EXTERN void RLMDynamicValidatedSet(RLMObjectBase *obj, NSString *propName, id __nullable val);
 FOUNDATION_EXTERN id __nullable RLMDynamicGet(RLMObjectBase *obj, RLMProperty *prop);
 FOUNDATION_EXTERN id __nullable RLMDynamicGetByName(RLMObjectBase *obj, NSString *propName, bool asList);
+// Variants of the above which take the index of the persisted property in the
+// object's schema, for callers which look properties up once and then access
+// them repeatedly
+FOUNDATION_EXTERN void RLMDynamicValidatedSetByIndex(RLMObjectBase *obj, NSUInteger propertyIndex, id __nullable val);
+FOUNDATION_EXTERN id __nullable RLMDynamicGetByIndex(RLMObjectBase *obj, NSUInteger propertyIndex, bool asList);
+// Read the values of the named properties into `values`, with NSNull for nil,
+// checking the object's validity only once
+FOUNDATION_EXTERN void RLMDynamicGetValues(RLMObjectBase *obj, NSArray<NSString *> *propNames, NSMutableDictionary *values);
+FOUNDATION_EXTERN void RLMDynamicWithBinaryProperty(RLMObjectBase *obj, NSString *propName,
+                                                    NS_NOESCAPE void (^block)(const void *__nullable bytes, NSUInteger length));
+// The number of objects linking to the object through a linking objects
+// property, read from the backlinks without creating an RLMLinkingObjects
+FOUNDATION_EXTERN NSUInteger RLMDynamicLinkingObjectsCount(RLMObjectBase *obj, NSString *propName);
+// Add to the value of an integer property in place
+FOUNDATION_EXTERN void RLMDynamicIncrement(RLMObjectBase *obj, NSString *propName, int64_t amount);
+// The property of an object schema with the given name, checked to be an
+// integer property which can be incremented
+RLMProperty *RLMValidatedIncrementedProperty(RLMObjectSchema *objectSchema, NSString *propName);
+// Make unmanaged copies of managed objects and everything reachable from them
+// through links, with a single copy of each object however many times it is
+// reached
+FOUNDATION_EXTERN RLMObjectBase *RLMDetachedCopy(RLMObjectBase *obj);
+FOUNDATION_EXTERN NSArray *RLMDetachedCopies(id<NSFastEnumeration> objects);
 
 // by property/column
 void RLMDynamicSet(RLMObjectBase *obj, RLMProperty *prop, id val, RLMCreationOptions options);
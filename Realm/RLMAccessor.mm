@@ -20,6 +20,7 @@
 
 #import "RLMArray_Private.hpp"
 #import "RLMListBase.h"
+#import "RLMObjectBase_Dynamic.h"
 #import "RLMObjectSchema_Private.hpp"
 #import "RLMObjectStore.h"
 #import "RLMObject_Private.hpp"
@@ -35,6 +36,11 @@
 #import <objc/runtime.h>
 #import <realm/descriptor.hpp>
 
+#import <map>
+#import <mutex>
+#import <utility>
+#import <vector>
+
 template<typename T>
 static inline T get(__unsafe_unretained RLMObjectBase *const obj, NSUInteger index) {
     RLMVerifyAttached(obj);
@@ -76,20 +82,136 @@ static inline void RLMSetValue(__unsafe_unretained RLMObjectBase *const obj, NSU
     obj->_row.get_table()->set_bool(colIndex, obj->_row.get_index(), val, setDefault);
 }
 
+// An NSString which refers directly to ASCII string data in the Realm file
+// rather than copying it. The Realm copies the data before the read transaction
+// the string was read in ends by calling -detach, after which the string is
+// backed by the copy. The string may still be read from other threads while
+// this happens, so the data is only accessed with the mutex held, and -copy
+// returns an ordinary string rather than another mapped one.
+@interface RLMMappedString : NSString
+- (instancetype)initWithStringData:(realm::StringData)str realm:(RLMRealm *)realm;
+- (void)detach;
+@end
+
+@implementation RLMMappedString {
+    std::mutex _mutex;
+    const char *_bytes;
+    NSUInteger _length;
+    NSString *_copy;
+    // Keeps the file mapped until the string is detached
+    RLMRealm *_realm;
+}
+
+- (instancetype)initWithStringData:(realm::StringData)str realm:(RLMRealm *)realm {
+    self = [super init];
+    if (self) {
+        _bytes = str.data();
+        _length = str.size();
+        _realm = realm;
+        [realm registerMappedValue:self];
+    }
+    return self;
+}
+
+- (void)detach {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_copy) {
+        _copy = [[NSString alloc] initWithBytes:_bytes length:_length encoding:NSASCIIStringEncoding];
+        _bytes = nullptr;
+        _realm = nil;
+    }
+}
+
+- (id)copyWithZone:(NSZone *)zone {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_copy) {
+        return [_copy copyWithZone:zone];
+    }
+    return [[NSString allocWithZone:zone] initWithBytes:_bytes length:_length encoding:NSASCIIStringEncoding];
+}
+
+- (NSUInteger)length {
+    // The length doesn't change when the string is detached
+    return _length;
+}
+
+- (unichar)characterAtIndex:(NSUInteger)index {
+    if (index >= _length) {
+        @throw [NSException exceptionWithName:NSRangeException
+                                       reason:[NSString stringWithFormat:@"Index %llu beyond bounds (%llu)",
+                                               (unsigned long long)index, (unsigned long long)_length]
+                                     userInfo:nil];
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_copy) {
+        return [_copy characterAtIndex:index];
+    }
+    return static_cast<unsigned char>(_bytes[index]);
+}
+
+- (void)getCharacters:(unichar *)buffer range:(NSRange)range {
+    if (NSMaxRange(range) > _length) {
+        @throw [NSException exceptionWithName:NSRangeException
+                                       reason:[NSString stringWithFormat:@"Range %@ beyond bounds (%llu)",
+                                               NSStringFromRange(range), (unsigned long long)_length]
+                                     userInfo:nil];
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_copy) {
+        return [_copy getCharacters:buffer range:range];
+    }
+    for (NSUInteger i = 0; i < range.length; ++i) {
+        buffer[i] = static_cast<unsigned char>(_bytes[range.location + i]);
+    }
+}
+
+@end
+
+// Values shorter than this are cheap enough to copy that it isn't worth
+// tracking them
+static const size_t s_minimumMappedValueSize = 64;
+
+static bool RLMIsASCII(realm::StringData str) {
+    for (size_t i = 0; i < str.size(); ++i) {
+        if (static_cast<unsigned char>(str[i]) >= 0x80) {
+            return false;
+        }
+    }
+    return true;
+}
+
 // string getter/setter
 static inline NSString *RLMGetString(__unsafe_unretained RLMObjectBase *const obj, NSUInteger colIndex) {
-    return RLMStringDataToNSString(get<realm::StringData>(obj, colIndex));
+    auto str = get<realm::StringData>(obj, colIndex);
+    // Data read in a write transaction can be modified in place by later
+    // writes, so it has to be copied
+    RLMRealm *realm = obj->_realm;
+    if (realm.readsStringsWithoutCopying && !str.is_null() && str.size() >= s_minimumMappedValueSize
+        && !realm.inWriteTransaction && RLMIsASCII(str)) {
+        return [[RLMMappedString alloc] initWithStringData:str realm:realm];
+    }
+    if (auto interned = obj->_info->internedStrings(colIndex)) {
+        return interned->get(str);
+    }
+    return RLMStringDataToNSString(str);
 }
 static inline void RLMSetValue(__unsafe_unretained RLMObjectBase *const obj, NSUInteger colIndex, __unsafe_unretained NSString *const val, bool setDefault) {
     RLMVerifyInWriteTransaction(obj);
     try {
-        obj->_row.get_table()->set_string(colIndex, obj->_row.get_index(), RLMStringDataWithNSString(val), setDefault);
+        obj->_row.get_table()->set_string(colIndex, obj->_row.get_index(), RLMStringDataBuffer(val), setDefault);
     }
     catch (std::exception const& e) {
         @throw RLMException(e);
     }
 }
 
+// Update the folded copy of a string property listed in +foldedIndexedProperties
+static inline void RLMSetFoldedValue(__unsafe_unretained RLMObjectBase *const obj,
+                                     __unsafe_unretained NSString *const foldedPropertyName,
+                                     __unsafe_unretained NSString *const val, bool setDefault) {
+    RLMSetValue(obj, obj->_info->tableColumn(foldedPropertyName), RLMFoldedString(val), setDefault);
+}
+
 static inline void setNull(realm::Table& table, size_t colIndex, size_t rowIndex, bool setDefault) {
     try {
         table.set_null(colIndex, rowIndex, setDefault);
@@ -137,10 +259,16 @@ static inline RLMObjectBase *RLMGetLinkedObjectForValue(__unsafe_unretained RLMR
                                                         __unsafe_unretained NSString *const className,
                                                         __unsafe_unretained id const value,
                                                         RLMCreationOptions creationOptions) {
+    // Only the options which describe how to update existing objects apply to
+    // the linked objects
+    RLMCreationOptions linkOptions = creationOptions & (RLMCreationOptionsCreateOrUpdate
+                                                        | RLMCreationOptionsUpdateChangedOnly
+                                                        | RLMCreationOptionsSkipValidation);
+
     RLMObjectBase *link = RLMDynamicCast<RLMObjectBase>(value);
     if (!link || ![link->_objectSchema.className isEqualToString:className]) {
         // create from non-rlmobject
-        return RLMCreateObjectInRealmWithValue(realm, className, value, creationOptions & RLMCreationOptionsCreateOrUpdate);
+        return RLMCreateObjectInRealmWithValue(realm, className, value, linkOptions);
     }
 
     if (link.isInvalidated) {
@@ -160,7 +288,7 @@ static inline RLMObjectBase *RLMGetLinkedObjectForValue(__unsafe_unretained RLMR
     }
 
     // copy from another realm or copy from unmanaged
-    return RLMCreateObjectInRealmWithValue(realm, className, link, creationOptions & RLMCreationOptionsCreateOrUpdate);
+    return RLMCreateObjectInRealmWithValue(realm, className, link, linkOptions);
 }
 
 // link getter/setter
@@ -172,7 +300,31 @@ static inline RLMObjectBase *RLMGetLink(__unsafe_unretained RLMObjectBase *const
         return nil;
     }
     NSUInteger index = obj->_row.get_link(colIndex);
-    return RLMCreateObjectAccessor(obj->_realm, obj->_info->linkTargetType(propertyIndex), index);
+    RLMClassInfo& targetInfo = obj->_info->linkTargetType(propertyIndex);
+
+    // Reuse the accessor from the last read of this link if it still points
+    // to the same row. Row accessors are kept up to date by core as the Realm
+    // advances, and writing to the link changes the row it points to, so this
+    // never returns a stale object. The cache only ever holds accessors it
+    // created, so it can't form retain cycles.
+    auto& cache = obj->_linkCache;
+    if (cache && propertyIndex < cache->size()) {
+        RLMObjectBase *cached = (*cache)[propertyIndex];
+        if (cached && cached->_info == &targetInfo && cached->_row.is_attached()
+            && cached->_row.get_index() == index) {
+            return cached;
+        }
+    }
+
+    RLMObjectBase *link = RLMCreateObjectAccessor(obj->_realm, targetInfo, index);
+    if (!cache) {
+        cache = std::make_unique<std::vector<RLMObjectBase *>>();
+    }
+    if (propertyIndex >= cache->size()) {
+        cache->resize(obj->_info->objectSchema->persisted_properties.size());
+    }
+    (*cache)[propertyIndex] = link;
+    return link;
 }
 
 static inline void RLMSetValue(__unsafe_unretained RLMObjectBase *const obj, NSUInteger colIndex,
@@ -267,7 +419,7 @@ static inline void RLMSetValue(__unsafe_unretained RLMObjectBase *const obj, NSU
 static inline RLMLinkingObjects *RLMGetLinkingObjects(__unsafe_unretained RLMObjectBase *const obj,
                                                       __unsafe_unretained RLMProperty *const property) {
     RLMVerifyAttached(obj);
-    auto& objectInfo = obj->_realm->_info[property.objectClassName];
+    auto& objectInfo = obj->_realm->_info.targetOf(property);
     auto linkingProperty = objectInfo.objectSchema->property_for_name(property.linkOriginPropertyName.UTF8String);
     auto backlinkView = obj->_row.get_table()->get_backlink_view(obj->_row.get_index(), objectInfo.table(), linkingProperty->table_column);
     realm::Results results(obj->_realm->_realm, std::move(backlinkView));
@@ -375,9 +527,119 @@ static id RLMAccessorGetter(RLMProperty *prop, const char *type) {
     }
 }
 
+// Getters for the first few properties of each object are plain C functions
+// with the property index as a template argument rather than blocks capturing
+// it, which skips the block trampoline and the load of the captured index on
+// every property read. Properties past the end of the table and types which
+// need the RLMProperty (links, lists, linking objects) use the block getters.
+static const NSUInteger c_specializedGetterCount = 16;
+
+template<typename T, typename StorageType, NSUInteger Index>
+static T specializedGetter(__unsafe_unretained RLMObjectBase *const obj, SEL) {
+    return static_cast<T>(get<StorageType>(obj, Index));
+}
+
+template<typename T, NSUInteger Index>
+static NSNumber *specializedBoxedGetter(__unsafe_unretained RLMObjectBase *const obj, SEL) {
+    return getBoxed<T>(obj, Index);
+}
+
+template<NSUInteger Index>
+static NSString *specializedStringGetter(__unsafe_unretained RLMObjectBase *const obj, SEL) {
+    return RLMGetString(obj, Index);
+}
+
+template<NSUInteger Index>
+static NSDate *specializedDateGetter(__unsafe_unretained RLMObjectBase *const obj, SEL) {
+    return RLMGetDate(obj, Index);
+}
+
+template<NSUInteger Index>
+static NSData *specializedDataGetter(__unsafe_unretained RLMObjectBase *const obj, SEL) {
+    return RLMGetData(obj, Index);
+}
+
+template<typename Getter, size_t... Index>
+static IMP specializedGetterForIndex(NSUInteger index, std::index_sequence<Index...>) {
+    static const IMP imps[] = {Getter::template imp<Index>()...};
+    return imps[index];
+}
+
+template<typename T, typename StorageType>
+struct SpecializedGetter {
+    template<size_t Index>
+    static IMP imp() { return reinterpret_cast<IMP>(&specializedGetter<T, StorageType, Index>); }
+};
+
+template<typename T>
+struct SpecializedBoxedGetter {
+    template<size_t Index>
+    static IMP imp() { return reinterpret_cast<IMP>(&specializedBoxedGetter<T, Index>); }
+};
+
+#define REALM_SPECIALIZED_OBJECT_GETTER(Name, Function) \
+    struct Name { \
+        template<size_t Index> \
+        static IMP imp() { return reinterpret_cast<IMP>(&Function<Index>); } \
+    }
+REALM_SPECIALIZED_OBJECT_GETTER(SpecializedStringGetter, specializedStringGetter);
+REALM_SPECIALIZED_OBJECT_GETTER(SpecializedDateGetter, specializedDateGetter);
+REALM_SPECIALIZED_OBJECT_GETTER(SpecializedDataGetter, specializedDataGetter);
+#undef REALM_SPECIALIZED_OBJECT_GETTER
+
+template<typename Getter>
+static IMP specializedGetterImp(NSUInteger index) {
+    return specializedGetterForIndex<Getter>(index, std::make_index_sequence<c_specializedGetterCount>());
+}
+
+// returns nil if there is no specialized getter for the property
+static IMP RLMSpecializedAccessorGetter(RLMProperty *prop, const char *type) {
+    NSUInteger index = prop.index;
+    if (index >= c_specializedGetterCount) {
+        return nil;
+    }
+
+    bool boxed = prop.optional || *type == '@';
+    switch (prop.type) {
+        case RLMPropertyTypeInt:
+            if (boxed) {
+                return specializedGetterImp<SpecializedBoxedGetter<long long>>(index);
+            }
+            switch (*type) {
+                case 'c': return specializedGetterImp<SpecializedGetter<char, int64_t>>(index);
+                case 's': return specializedGetterImp<SpecializedGetter<short, int64_t>>(index);
+                case 'i': return specializedGetterImp<SpecializedGetter<int, int64_t>>(index);
+                case 'l': return specializedGetterImp<SpecializedGetter<long, int64_t>>(index);
+                case 'q': return specializedGetterImp<SpecializedGetter<long long, int64_t>>(index);
+                default:  return nil;
+            }
+        case RLMPropertyTypeFloat:
+            return boxed ? specializedGetterImp<SpecializedBoxedGetter<float>>(index)
+                         : specializedGetterImp<SpecializedGetter<float, float>>(index);
+        case RLMPropertyTypeDouble:
+            return boxed ? specializedGetterImp<SpecializedBoxedGetter<double>>(index)
+                         : specializedGetterImp<SpecializedGetter<double, double>>(index);
+        case RLMPropertyTypeBool:
+            return boxed ? specializedGetterImp<SpecializedBoxedGetter<bool>>(index)
+                         : specializedGetterImp<SpecializedGetter<bool, bool>>(index);
+        case RLMPropertyTypeString:
+            return specializedGetterImp<SpecializedStringGetter>(index);
+        case RLMPropertyTypeDate:
+            return specializedGetterImp<SpecializedDateGetter>(index);
+        case RLMPropertyTypeData:
+            return specializedGetterImp<SpecializedDataGetter>(index);
+        default:
+            return nil;
+    }
+}
+
 template<typename Function>
 static void RLMWrapSetter(__unsafe_unretained RLMObjectBase *const obj, __unsafe_unretained NSString *const name, Function&& f) {
-    if (RLMObservationInfo *info = RLMGetObservationInfo(obj->_observationInfo, obj->_row.get_index(), *obj->_info)) {
+    if (obj->_realm->_bulkWrite) {
+        // Observers are notified when the bulk write is committed
+        f();
+    }
+    else if (RLMObservationInfo *info = RLMGetObservationInfo(obj->_observationInfo, obj->_row.get_index(), *obj->_info)) {
         info->willChange(name);
         f();
         info->didChange(name);
@@ -387,6 +649,25 @@ static void RLMWrapSetter(__unsafe_unretained RLMObjectBase *const obj, __unsafe
     }
 }
 
+// The exception thrown when setting a property which is computed from other
+// properties whenever they're set
+static NSException *RLMComputedPropertySetException(__unsafe_unretained RLMProperty *const prop) {
+    if (prop.derivedInputNames) {
+        return RLMException(@"Property '%@' is derived from other properties and can't be set directly.", prop.name);
+    }
+    return RLMException(@"Property '%@' holds the keys of a %@ and can't be set directly.", prop.name,
+                        prop.geoIndexCoordinateNames ? @"geo index" : prop.collationSourceName ? @"collation key" : @"compound index");
+}
+
+// Update the properties computed from the property at `index` after it has
+// been set, if there are any
+static inline void RLMUpdateComputedProperties(__unsafe_unretained RLMObjectBase *const obj, NSUInteger index) {
+    RLMProperty *prop = obj->_info->rlmObjectSchema.properties[index];
+    if (prop.hasComputedProperties) {
+        obj->_info->updateComputedProperties(obj->_row.get_index(), prop);
+    }
+}
+
 template<typename ArgType, typename StorageType=ArgType>
 static id makeSetter(__unsafe_unretained RLMProperty *const prop) {
     NSUInteger index = prop.index;
@@ -396,6 +677,15 @@ static id makeSetter(__unsafe_unretained RLMProperty *const prop) {
             @throw RLMException(@"Primary key can't be changed after an object is inserted.");
         };
     }
+    if (prop.hasComputedProperties) {
+        return ^(__unsafe_unretained RLMObjectBase *const obj, ArgType val) {
+            RLMWrapSetter(obj, name, [&] {
+                RLMSetValue(obj, obj->_info->objectSchema->persisted_properties[index].table_column,
+                            static_cast<StorageType>(val), false);
+                RLMUpdateComputedProperties(obj, index);
+            });
+        };
+    }
     return ^(__unsafe_unretained RLMObjectBase *const obj, ArgType val) {
         RLMWrapSetter(obj, name, [&] {
             RLMSetValue(obj, obj->_info->objectSchema->persisted_properties[index].table_column,
@@ -404,9 +694,29 @@ static id makeSetter(__unsafe_unretained RLMProperty *const prop) {
     };
 }
 
+// setter for a string property which also updates its folded copy
+static id makeFoldedStringSetter(__unsafe_unretained RLMProperty *const prop) {
+    NSUInteger index = prop.index;
+    NSString *name = prop.name;
+    NSString *foldedName = prop.foldedPropertyName;
+    return ^(__unsafe_unretained RLMObjectBase *const obj, NSString *val) {
+        RLMWrapSetter(obj, name, [&] {
+            RLMSetValue(obj, obj->_info->objectSchema->persisted_properties[index].table_column, val, false);
+            RLMSetFoldedValue(obj, foldedName, val, false);
+            RLMUpdateComputedProperties(obj, index);
+        });
+    };
+}
+
 // dynamic setter with column closure
 static id RLMAccessorSetter(RLMProperty *prop, const char *type) {
     bool boxed = prop.optional || *type == '@';
+    if (prop.isComputed) {
+        RLMProperty *computed = prop;
+        return ^(__unused RLMObjectBase *obj, __unused id val) {
+            @throw RLMComputedPropertySetException(computed);
+        };
+    }
     switch (prop.type) {
         case RLMPropertyTypeInt:
             if (boxed) {
@@ -427,9 +737,26 @@ static id RLMAccessorSetter(RLMProperty *prop, const char *type) {
             return boxed ? makeSetter<NSNumber<RLMDouble> *>(prop) : makeSetter<double>(prop);
         case RLMPropertyTypeBool:
             return boxed ? makeSetter<NSNumber<RLMBool> *>(prop) : makeSetter<BOOL>(prop);
-        case RLMPropertyTypeString:         return makeSetter<NSString *>(prop);
+        case RLMPropertyTypeString:
+            if (prop.isFolded) {
+                NSString *name = prop.name;
+                return ^(__unused RLMObjectBase *obj, __unused NSString *val) {
+                    @throw RLMException(@"Property '%@' holds a folded copy of another property and can't be set directly.", name);
+                };
+            }
+            return prop.foldedPropertyName ? makeFoldedStringSetter(prop) : makeSetter<NSString *>(prop);
         case RLMPropertyTypeDate:           return makeSetter<NSDate *>(prop);
-        case RLMPropertyTypeData:           return makeSetter<NSData *>(prop);
+        case RLMPropertyTypeData:
+            if (prop.vectorDimension) {
+                // The length of vectors is checked before they're stored
+                RLMProperty *vector = prop;
+                void (^set)(RLMObjectBase *, NSData *) = makeSetter<NSData *>(prop);
+                return ^(__unsafe_unretained RLMObjectBase *const obj, NSData *val) {
+                    RLMValidateValueForProperty(val, vector);
+                    set(obj, val);
+                };
+            }
+            return makeSetter<NSData *>(prop);
         case RLMPropertyTypeObject:         return makeSetter<RLMObjectBase *>(prop);
         case RLMPropertyTypeArray:          return makeSetter<RLMArray *>(prop);
         case RLMPropertyTypeAny:            return makeSetter<id>(prop);
@@ -541,7 +868,10 @@ static void addMethod(Class cls, __unsafe_unretained RLMProperty *const prop,
     }
 
     const char *getterType = method_getTypeEncoding(getterMethod);
-    if (id block = getter(prop, getterType)) {
+    if (IMP imp = getter == RLMAccessorGetter ? RLMSpecializedAccessorGetter(prop, getterType) : nil) {
+        class_addMethod(cls, sel, imp, getterType);
+    }
+    else if (id block = getter(prop, getterType)) {
         class_addMethod(cls, sel, imp_implementationWithBlock(block), getterType);
     }
 
@@ -589,11 +919,63 @@ Class RLMManagedAccessorClassForObjectClass(Class objectClass, RLMObjectSchema *
     return RLMCreateAccessorClass(objectClass, schema, name, RLMAccessorGetter, RLMAccessorSetter);
 }
 
+// Whether any of the properties has a getter or setter which the unmanaged
+// accessor class would override
+static bool RLMNeedsUnmanagedAccessors(Class objectClass, NSArray<RLMProperty *> *properties) {
+    for (RLMProperty *prop in properties) {
+        if (prop.type != RLMPropertyTypeArray && prop.type != RLMPropertyTypeLinkingObjects) {
+            continue;
+        }
+        if (class_getInstanceMethod(objectClass, prop.getterSel)
+            || (prop.setterSel && class_getInstanceMethod(objectClass, prop.setterSel))) {
+            return true;
+        }
+    }
+    return false;
+}
+
 Class RLMUnmanagedAccessorClassForObjectClass(Class objectClass, RLMObjectSchema *schema) {
+    // Unmanaged objects only need an accessor class to lazily create their
+    // arrays and linking objects; objects of classes with neither are left as
+    // instances of their own class and store their values in its ivars, which
+    // makes creating them as cheap as creating any other object
+    if (!RLMNeedsUnmanagedAccessors(objectClass, schema.properties)
+        && !RLMNeedsUnmanagedAccessors(objectClass, schema.computedProperties)) {
+        return objectClass;
+    }
     return RLMCreateAccessorClass(objectClass, schema, [@"RLM:Unmanaged " stringByAppendingString:schema.className].UTF8String,
                                   RLMAccessorUnmanagedGetter, RLMAccessorUnmanagedSetter);
 }
 
+static RLMProperty *RLMPropertyForIndex(__unsafe_unretained RLMObjectBase *const obj, NSUInteger propertyIndex) {
+    NSArray *properties = obj->_objectSchema.properties;
+    if (propertyIndex >= properties.count) {
+        @throw RLMException(@"Invalid property index %llu for class '%@' with %llu properties.",
+                            (unsigned long long)propertyIndex, obj->_objectSchema.className,
+                            (unsigned long long)properties.count);
+    }
+    return properties[propertyIndex];
+}
+
+static void RLMValidatedSet(__unsafe_unretained RLMObjectBase *const obj, __unsafe_unretained RLMProperty *const prop,
+                            __unsafe_unretained id const val) {
+    if (prop.isPrimary) {
+        @throw RLMException(@"Primary key can't be changed to '%@' after an object is inserted.", val);
+    }
+    if (prop.isFolded) {
+        @throw RLMException(@"Property '%@' holds a folded copy of another property and can't be set directly.", prop.name);
+    }
+    if (prop.isComputed) {
+        @throw RLMComputedPropertySetException(prop);
+    }
+    if (!RLMIsObjectValidForProperty(val, prop)) {
+        @throw RLMException(@"Invalid property value '%@' for property '%@' of class '%@'",
+                            val, prop.name, obj->_objectSchema.className);
+    }
+
+    RLMDynamicSet(obj, prop, RLMCoerceToNil(val), RLMCreationOptionsPromoteUnmanaged);
+}
+
 void RLMDynamicValidatedSet(RLMObjectBase *obj, NSString *propName, id val) {
     RLMObjectSchema *schema = obj->_objectSchema;
     RLMProperty *prop = schema[propName];
@@ -601,62 +983,138 @@ void RLMDynamicValidatedSet(RLMObjectBase *obj, NSString *propName, id val) {
         @throw RLMException(@"Invalid property name '%@' for class '%@'.",
                             propName, obj->_objectSchema.className);
     }
-    if (prop.isPrimary) {
-        @throw RLMException(@"Primary key can't be changed to '%@' after an object is inserted.", val);
+    RLMValidatedSet(obj, prop, val);
+}
+
+void RLMDynamicValidatedSetByIndex(RLMObjectBase *obj, NSUInteger propertyIndex, id val) {
+    RLMValidatedSet(obj, RLMPropertyForIndex(obj, propertyIndex), val);
+}
+
+// Check if the given value is equal to the value currently stored in the column
+// Only valid for non-link properties
+static bool RLMValueIsUnchanged(__unsafe_unretained RLMObjectBase *const obj, size_t col,
+                                __unsafe_unretained RLMProperty *const prop, __unsafe_unretained id const val) {
+    RLMVerifyAttached(obj);
+    auto& table = *obj->_row.get_table();
+    size_t row = obj->_row.get_index();
+    if (!val || val == NSNull.null) {
+        return table.is_nullable(col) && table.is_null(col, row);
     }
-    if (!RLMIsObjectValidForProperty(val, prop)) {
-        @throw RLMException(@"Invalid property value '%@' for property '%@' of class '%@'",
-                            val, propName, obj->_objectSchema.className);
+    if (table.is_nullable(col) && table.is_null(col, row)) {
+        return false;
+    }
+    switch (prop.type) {
+        case RLMPropertyTypeInt:    return table.get_int(col, row) == [val longLongValue];
+        case RLMPropertyTypeFloat:  return table.get_float(col, row) == [val floatValue];
+        case RLMPropertyTypeDouble: return table.get_double(col, row) == [val doubleValue];
+        case RLMPropertyTypeBool:   return table.get_bool(col, row) == [val boolValue];
+        case RLMPropertyTypeString: return table.get_string(col, row) == StringData(RLMStringDataBuffer(val));
+        case RLMPropertyTypeDate:   return table.get_timestamp(col, row) == RLMTimestampForNSDate(val);
+        case RLMPropertyTypeData:   return table.get_binary(col, row) == RLMBinaryDataForNSData(val);
+        default:                    return false;
     }
+}
 
-    RLMDynamicSet(obj, prop, RLMCoerceToNil(val), RLMCreationOptionsPromoteUnmanaged);
+static bool RLMLinkIsUnchanged(__unsafe_unretained RLMObjectBase *const obj, size_t col,
+                               __unsafe_unretained RLMObjectBase *const link) {
+    RLMVerifyAttached(obj);
+    if (obj->_row.is_null_link(col)) {
+        return !link;
+    }
+    return link && obj->_row.get_link(col) == link->_row.get_index();
+}
+
+static bool RLMListIsUnchanged(__unsafe_unretained RLMObjectBase *const obj, size_t col,
+                               __unsafe_unretained NSArray<RLMObjectBase *> *const links) {
+    RLMVerifyAttached(obj);
+    realm::LinkViewRef linkView = obj->_row.get_linklist(col);
+    if (linkView->size() != links.count) {
+        return false;
+    }
+    size_t i = 0;
+    for (RLMObjectBase *link in links) {
+        if (linkView->get(i++).get_index() != link->_row.get_index()) {
+            return false;
+        }
+    }
+    return true;
 }
 
 // Precondition: the property is not a primary key
 void RLMDynamicSet(__unsafe_unretained RLMObjectBase *const obj, __unsafe_unretained RLMProperty *const prop,
                    __unsafe_unretained id const val, RLMCreationOptions creationOptions) {
     REALM_ASSERT_DEBUG(!prop.isPrimary);
+    if (prop.isFolded || prop.isComputed) {
+        // Folded copies and computed properties are written along with the
+        // properties they're derived from
+        return;
+    }
     bool setDefault = creationOptions & RLMCreationOptionsSetDefault;
+    bool changedOnly = creationOptions & RLMCreationOptionsUpdateChangedOnly;
 
     auto col = obj->_info->tableColumn(prop);
+
+    // Links have to be resolved (which may create or update the linked
+    // objects) before we can tell if they differ from the current value
+    if (prop.type == RLMPropertyTypeObject) {
+        RLMObjectBase *link = nil;
+        if (val && val != NSNull.null) {
+            link = RLMGetLinkedObjectForValue(obj->_realm, prop.objectClassName, val, creationOptions);
+        }
+        if (changedOnly && RLMLinkIsUnchanged(obj, col, link)) {
+            return;
+        }
+        RLMWrapSetter(obj, prop.name, [&] {
+            RLMSetValue(obj, col, link, setDefault);
+        });
+        return;
+    }
+    if (prop.type == RLMPropertyTypeArray) {
+        NSMutableArray *links = nil;
+        if (val && val != NSNull.null) {
+            id<NSFastEnumeration> rawLinks = val;
+            links = [NSMutableArray array];
+            for (id rawLink in rawLinks) {
+                [links addObject:RLMGetLinkedObjectForValue(obj->_realm, prop.objectClassName, rawLink, creationOptions)];
+            }
+        }
+        if (changedOnly && RLMListIsUnchanged(obj, col, links)) {
+            return;
+        }
+        RLMWrapSetter(obj, prop.name, [&] {
+            RLMSetValue(obj, col, (id<NSFastEnumeration>)links, setDefault);
+        });
+        return;
+    }
+
+    if (changedOnly && RLMValueIsUnchanged(obj, col, prop, val)) {
+        return;
+    }
+
     RLMWrapSetter(obj, prop.name, [&] {
         switch (prop.type) {
             case RLMPropertyTypeInt:    RLMSetValue(obj, col, (NSNumber<RLMInt> *)val, setDefault); break;
             case RLMPropertyTypeFloat:  RLMSetValue(obj, col, (NSNumber<RLMFloat> *)val, setDefault); break;
             case RLMPropertyTypeDouble: RLMSetValue(obj, col, (NSNumber<RLMDouble> *)val, setDefault); break;
             case RLMPropertyTypeBool:   RLMSetValue(obj, col, (NSNumber<RLMBool> *)val, setDefault); break;
-            case RLMPropertyTypeString: RLMSetValue(obj, col, (NSString *)val, setDefault); break;
-            case RLMPropertyTypeDate:   RLMSetValue(obj, col, (NSDate *)val, setDefault); break;
-            case RLMPropertyTypeData:   RLMSetValue(obj, col, (NSData *)val, setDefault); break;
-            case RLMPropertyTypeObject: {
-                if (!val || val == NSNull.null) {
-                    RLMSetValue(obj, col, (RLMObjectBase *)nil, setDefault);
-                }
-                else {
-                    auto linkedObj = RLMGetLinkedObjectForValue(obj->_realm, prop.objectClassName, val, creationOptions);
-                    RLMSetValue(obj, col, linkedObj, setDefault);
+            case RLMPropertyTypeString:
+                RLMSetValue(obj, col, (NSString *)val, setDefault);
+                if (prop.foldedPropertyName) {
+                    RLMSetFoldedValue(obj, prop.foldedPropertyName, val, setDefault);
                 }
                 break;
-            }
+            case RLMPropertyTypeDate:   RLMSetValue(obj, col, (NSDate *)val, setDefault); break;
+            case RLMPropertyTypeData:   RLMSetValue(obj, col, (NSData *)val, setDefault); break;
+            case RLMPropertyTypeObject:
             case RLMPropertyTypeArray:
-                if (!val || val == NSNull.null) {
-                    RLMSetValue(obj, col, (id<NSFastEnumeration>)nil, setDefault);
-                }
-                else {
-                    id<NSFastEnumeration> rawLinks = val;
-                    NSMutableArray *links = [NSMutableArray array];
-                    for (id rawLink in rawLinks) {
-                        [links addObject:RLMGetLinkedObjectForValue(obj->_realm, prop.objectClassName, rawLink, creationOptions)];
-                    }
-                    RLMSetValue(obj, col, links, setDefault);
-                }
-                break;
+                REALM_UNREACHABLE();
             case RLMPropertyTypeAny:
                 RLMSetValue(obj, col, val, setDefault);
                 break;
             case RLMPropertyTypeLinkingObjects:
                 @throw RLMException(@"Linking objects properties are read-only");
         }
+        RLMUpdateComputedProperties(obj, prop.index);
     });
 }
 
@@ -677,11 +1135,8 @@ id RLMDynamicGet(__unsafe_unretained RLMObjectBase *const obj, __unsafe_unretain
     }
 }
 
-id RLMDynamicGetByName(__unsafe_unretained RLMObjectBase *const obj, __unsafe_unretained NSString *const propName, bool asList) {
-    RLMProperty *prop = obj->_objectSchema[propName];
-    if (!prop) {
-        @throw RLMException(@"Invalid property name '%@' for class '%@'.", propName, obj->_objectSchema.className);
-    }
+static id RLMDynamicGetForProperty(__unsafe_unretained RLMObjectBase *const obj,
+                                   __unsafe_unretained RLMProperty *const prop, bool asList) {
     if (asList && prop.type == RLMPropertyTypeArray && prop.swiftIvar) {
         RLMListBase *list = object_getIvar(obj, prop.swiftIvar);
         if (!list._rlmArray) {
@@ -692,3 +1147,354 @@ id RLMDynamicGetByName(__unsafe_unretained RLMObjectBase *const obj, __unsafe_un
 
     return RLMDynamicGet(obj, prop);
 }
+
+id RLMDynamicGetByName(__unsafe_unretained RLMObjectBase *const obj, __unsafe_unretained NSString *const propName, bool asList) {
+    RLMProperty *prop = obj->_objectSchema[propName];
+    if (!prop) {
+        @throw RLMException(@"Invalid property name '%@' for class '%@'.", propName, obj->_objectSchema.className);
+    }
+    return RLMDynamicGetForProperty(obj, prop, asList);
+}
+
+id RLMDynamicGetByIndex(__unsafe_unretained RLMObjectBase *const obj, NSUInteger propertyIndex, bool asList) {
+    return RLMDynamicGetForProperty(obj, RLMPropertyForIndex(obj, propertyIndex), asList);
+}
+
+void RLMDynamicGetValues(__unsafe_unretained RLMObjectBase *const obj, __unsafe_unretained NSArray<NSString *> *const propNames,
+                         __unsafe_unretained NSMutableDictionary *const values) {
+    RLMObjectSchema *objectSchema = obj->_objectSchema;
+    for (NSString *propName in propNames) {
+        if (!objectSchema[propName]) {
+            @throw RLMException(@"Invalid property name '%@' for class '%@'.", propName, objectSchema.className);
+        }
+    }
+
+    if (!obj->_realm) {
+        for (NSString *propName in propNames) {
+            values[propName] = [obj valueForKey:propName] ?: NSNull.null;
+        }
+        return;
+    }
+
+    // Check the row once and then read the numeric columns straight from the
+    // table; everything else needs an object wrapping the value anyway, so
+    // the per-property checks in the normal getters don't matter
+    RLMVerifyAttached(obj);
+    auto& table = *obj->_row.get_table();
+    size_t row = obj->_row.get_index();
+    auto& persistedProperties = obj->_info->objectSchema->persisted_properties;
+    for (NSString *propName in propNames) {
+        RLMProperty *prop = objectSchema[propName];
+        id value;
+        if (prop.swiftIvar || (prop.type == RLMPropertyTypeArray && obj->_observationInfo)) {
+            // Swift generic properties and observed lists have to return the
+            // same object every time, which valueForKey: takes care of
+            value = [obj valueForKey:propName];
+        }
+        else {
+            size_t col = prop.type == RLMPropertyTypeLinkingObjects ? realm::npos
+                                                                   : persistedProperties[prop.index].table_column;
+            switch (prop.type) {
+                case RLMPropertyTypeInt:
+                    value = table.is_null(col, row) ? nil : @(table.get_int(col, row));
+                    break;
+                case RLMPropertyTypeFloat:
+                    value = table.is_null(col, row) ? nil : @(table.get_float(col, row));
+                    break;
+                case RLMPropertyTypeDouble:
+                    value = table.is_null(col, row) ? nil : @(table.get_double(col, row));
+                    break;
+                case RLMPropertyTypeBool:
+                    value = table.is_null(col, row) ? nil : @(table.get_bool(col, row));
+                    break;
+                default:
+                    value = RLMDynamicGet(obj, prop);
+                    break;
+            }
+        }
+        values[propName] = value ?: NSNull.null;
+    }
+}
+
+void RLMDynamicWithBinaryProperty(__unsafe_unretained RLMObjectBase *const obj, __unsafe_unretained NSString *const propName,
+                                  __unsafe_unretained NS_NOESCAPE void (^const block)(const void *, NSUInteger)) {
+    RLMProperty *prop = obj->_objectSchema[propName];
+    if (!prop) {
+        @throw RLMException(@"Invalid property name '%@' for class '%@'.", propName, obj->_objectSchema.className);
+    }
+    if (prop.type != RLMPropertyTypeData) {
+        @throw RLMException(@"Property '%@' of '%@' is of type '%@', not 'data'.",
+                            propName, obj->_objectSchema.className, RLMTypeToString(prop.type));
+    }
+    if (!obj->_realm) {
+        NSData *data = [obj valueForKey:propName];
+        block(data.bytes, data.length);
+        return;
+    }
+
+    auto data = get<realm::BinaryData>(obj, prop.index);
+    block(data.data(), data.size());
+}
+
+id RLMObjectBaseValueForHandle(__unsafe_unretained RLMObjectBase *const obj, RLMPropertyHandle handle) {
+    if (!obj->_realm) {
+        return [obj valueForKey:RLMPropertyForIndex(obj, handle).name];
+    }
+    return RLMDynamicGetByIndex(obj, handle, false);
+}
+
+void RLMObjectBaseSetValueForHandle(__unsafe_unretained RLMObjectBase *const obj, RLMPropertyHandle handle,
+                                    __unsafe_unretained id const value) {
+    if (!obj->_realm) {
+        [obj setValue:value forKey:RLMPropertyForIndex(obj, handle).name];
+        return;
+    }
+    RLMDynamicValidatedSetByIndex(obj, handle, value);
+}
+
+BOOL RLMObjectBaseIsNullForHandle(__unsafe_unretained RLMObjectBase *const obj, RLMPropertyHandle handle) {
+    RLMProperty *prop = RLMPropertyForIndex(obj, handle);
+    if (!obj->_realm || prop.type == RLMPropertyTypeObject || prop.type == RLMPropertyTypeArray) {
+        return RLMCoerceToNil(RLMObjectBaseValueForHandle(obj, handle)) == nil;
+    }
+    RLMVerifyAttached(obj);
+    return obj->_row.is_null(obj->_info->objectSchema->persisted_properties[handle].table_column);
+}
+
+// The property a handle refers to, which must be of the given type
+static RLMProperty *RLMPropertyForHandle(__unsafe_unretained RLMObjectBase *const obj, RLMPropertyHandle handle,
+                                         RLMPropertyType type) {
+    RLMProperty *prop = RLMPropertyForIndex(obj, handle);
+    if (prop.type != type) {
+        @throw RLMException(@"Property '%@' of '%@' is of type '%@', not '%@'.", prop.name,
+                            obj->_objectSchema.className, RLMTypeToString(prop.type), RLMTypeToString(type));
+    }
+    return prop;
+}
+
+static inline long long RLMUnboxNumber(__unsafe_unretained NSNumber *const value, long long) { return value.longLongValue; }
+static inline bool RLMUnboxNumber(__unsafe_unretained NSNumber *const value, bool) { return value.boolValue; }
+static inline float RLMUnboxNumber(__unsafe_unretained NSNumber *const value, float) { return value.floatValue; }
+static inline double RLMUnboxNumber(__unsafe_unretained NSNumber *const value, double) { return value.doubleValue; }
+
+template<typename T>
+static T RLMGetNumberForHandle(__unsafe_unretained RLMObjectBase *const obj, RLMPropertyHandle handle, RLMPropertyType type) {
+    RLMProperty *prop = RLMPropertyForHandle(obj, handle, type);
+    if (!obj->_realm) {
+        return RLMUnboxNumber([obj valueForKey:prop.name], T());
+    }
+    RLMVerifyAttached(obj);
+    auto col = obj->_info->objectSchema->persisted_properties[handle].table_column;
+    if (obj->_row.is_null(col)) {
+        return T();
+    }
+    return obj->_row.get_table()->get<T>(col, obj->_row.get_index());
+}
+
+// Only the plain properties are written directly; the rest are set through
+// the general path, which rejects or also updates them as needed
+template<typename T, typename StorageType=T>
+static void RLMSetNumberForHandle(__unsafe_unretained RLMObjectBase *const obj, RLMPropertyHandle handle,
+                                  RLMPropertyType type, T value) {
+    RLMProperty *prop = RLMPropertyForHandle(obj, handle, type);
+    if (!obj->_realm) {
+        [obj setValue:@(value) forKey:prop.name];
+        return;
+    }
+    if (prop.isPrimary || prop.isComputed || prop.hasComputedProperties) {
+        RLMValidatedSet(obj, prop, @(value));
+        return;
+    }
+    RLMWrapSetter(obj, prop.name, [&] {
+        RLMSetValue(obj, obj->_info->objectSchema->persisted_properties[handle].table_column,
+                    static_cast<StorageType>(value), false);
+    });
+}
+
+int64_t RLMObjectBaseGetIntForHandle(__unsafe_unretained RLMObjectBase *const obj, RLMPropertyHandle handle) {
+    return RLMGetNumberForHandle<long long>(obj, handle, RLMPropertyTypeInt);
+}
+
+BOOL RLMObjectBaseGetBoolForHandle(__unsafe_unretained RLMObjectBase *const obj, RLMPropertyHandle handle) {
+    return RLMGetNumberForHandle<bool>(obj, handle, RLMPropertyTypeBool);
+}
+
+float RLMObjectBaseGetFloatForHandle(__unsafe_unretained RLMObjectBase *const obj, RLMPropertyHandle handle) {
+    return RLMGetNumberForHandle<float>(obj, handle, RLMPropertyTypeFloat);
+}
+
+double RLMObjectBaseGetDoubleForHandle(__unsafe_unretained RLMObjectBase *const obj, RLMPropertyHandle handle) {
+    return RLMGetNumberForHandle<double>(obj, handle, RLMPropertyTypeDouble);
+}
+
+NSString *RLMObjectBaseGetStringForHandle(__unsafe_unretained RLMObjectBase *const obj, RLMPropertyHandle handle) {
+    RLMProperty *prop = RLMPropertyForHandle(obj, handle, RLMPropertyTypeString);
+    return obj->_realm ? RLMGetString(obj, handle) : [obj valueForKey:prop.name];
+}
+
+NSDate *RLMObjectBaseGetDateForHandle(__unsafe_unretained RLMObjectBase *const obj, RLMPropertyHandle handle) {
+    RLMProperty *prop = RLMPropertyForHandle(obj, handle, RLMPropertyTypeDate);
+    return obj->_realm ? RLMGetDate(obj, handle) : [obj valueForKey:prop.name];
+}
+
+void RLMObjectBaseSetIntForHandle(__unsafe_unretained RLMObjectBase *const obj, RLMPropertyHandle handle, int64_t value) {
+    RLMSetNumberForHandle<long long>(obj, handle, RLMPropertyTypeInt, value);
+}
+
+void RLMObjectBaseSetBoolForHandle(__unsafe_unretained RLMObjectBase *const obj, RLMPropertyHandle handle, BOOL value) {
+    RLMSetNumberForHandle<BOOL>(obj, handle, RLMPropertyTypeBool, value);
+}
+
+void RLMObjectBaseSetFloatForHandle(__unsafe_unretained RLMObjectBase *const obj, RLMPropertyHandle handle, float value) {
+    RLMSetNumberForHandle<float>(obj, handle, RLMPropertyTypeFloat, value);
+}
+
+void RLMObjectBaseSetDoubleForHandle(__unsafe_unretained RLMObjectBase *const obj, RLMPropertyHandle handle, double value) {
+    RLMSetNumberForHandle<double>(obj, handle, RLMPropertyTypeDouble, value);
+}
+
+NSUInteger RLMDynamicLinkingObjectsCount(__unsafe_unretained RLMObjectBase *const obj,
+                                         __unsafe_unretained NSString *const propName) {
+    RLMProperty *prop = obj->_objectSchema[propName];
+    if (!prop) {
+        @throw RLMException(@"Invalid property name '%@' for class '%@'.", propName, obj->_objectSchema.className);
+    }
+    if (prop.type != RLMPropertyTypeLinkingObjects) {
+        @throw RLMException(@"Property '%@' of '%@' is of type '%@', not 'linking objects'.",
+                            propName, obj->_objectSchema.className, RLMTypeToString(prop.type));
+    }
+    if (!obj->_realm && !obj.invalidated) {
+        // unmanaged objects have no backlinks
+        return 0;
+    }
+
+    RLMVerifyAttached(obj);
+    auto& objectInfo = obj->_realm->_info.targetOf(prop);
+    auto linkingProperty = objectInfo.objectSchema->property_for_name(prop.linkOriginPropertyName.UTF8String);
+    return obj->_row.get_table()->get_backlink_count(obj->_row.get_index(), *objectInfo.table(),
+                                                     linkingProperty->table_column);
+}
+
+RLMProperty *RLMValidatedIncrementedProperty(__unsafe_unretained RLMObjectSchema *const objectSchema,
+                                             __unsafe_unretained NSString *const propName) {
+    RLMProperty *prop = objectSchema[propName];
+    if (!prop) {
+        @throw RLMException(@"Invalid property name '%@' for class '%@'.", propName, objectSchema.className);
+    }
+    if (prop.type != RLMPropertyTypeInt) {
+        @throw RLMException(@"Property '%@' of '%@' is of type '%@' and can't be incremented; only 'int' properties can.",
+                            propName, objectSchema.className, RLMTypeToString(prop.type));
+    }
+    if (prop.isPrimary) {
+        @throw RLMException(@"Primary key can't be changed after an object is inserted.");
+    }
+    if (prop.isComputed) {
+        @throw RLMComputedPropertySetException(prop);
+    }
+    return prop;
+}
+
+void RLMDynamicIncrement(__unsafe_unretained RLMObjectBase *const obj, __unsafe_unretained NSString *const propName,
+                         int64_t amount) {
+    RLMProperty *prop = RLMValidatedIncrementedProperty(obj->_objectSchema, propName);
+    if (!obj->_realm && !obj.invalidated) {
+        NSNumber *value = [obj valueForKey:prop.name];
+        if (!value) {
+            @throw RLMException(@"Property '%@' of '%@' can't be incremented because it is nil.",
+                                propName, obj->_objectSchema.className);
+        }
+        [obj setValue:@(value.longLongValue + amount) forKey:prop.name];
+        return;
+    }
+
+    RLMVerifyInWriteTransaction(obj);
+    size_t col = obj->_info->tableColumn(prop);
+    auto& table = *obj->_row.get_table();
+    size_t row = obj->_row.get_index();
+    if (table.is_null(col, row)) {
+        @throw RLMException(@"Property '%@' of '%@' can't be incremented because it is nil.",
+                            propName, obj->_objectSchema.className);
+    }
+    // Adding in place rather than setting the sum is recorded as an addition,
+    // so concurrent increments of the same counter from different devices
+    // are all kept when the changes are merged
+    RLMWrapSetter(obj, prop.name, [&] {
+        table.add_int(col, row, amount);
+        RLMUpdateComputedProperties(obj, prop.index);
+    });
+}
+
+namespace {
+// Copies are created when an object is first reached and filled in afterwards
+// from a worklist, so that cycles resolve to the copy being built and long
+// chains of links don't recurse
+class RLMDetachedCopier {
+public:
+    RLMObjectBase *copy(__unsafe_unretained RLMObjectBase *const obj) {
+        if (!obj) {
+            return nil;
+        }
+        if (!obj->_realm) {
+            @throw RLMException(@"Only objects managed by a Realm can be detached.");
+        }
+        RLMVerifyAttached(obj);
+        if (obj->_realm.dynamic) {
+            @throw RLMException(@"Objects read from a dynamic Realm can't be detached, as they have no class to copy them into.");
+        }
+
+        auto key = std::make_pair(obj->_info, obj->_row.get_index());
+        auto it = _copies.find(key);
+        if (it != _copies.end()) {
+            return it->second;
+        }
+        RLMObjectBase *copy = [[obj->_objectSchema.unmanagedClass alloc] init];
+        _copies.emplace(key, copy);
+        _pending.emplace_back(obj, copy);
+        return copy;
+    }
+
+    void finish() {
+        while (!_pending.empty()) {
+            RLMObjectBase *source = _pending.back().first;
+            RLMObjectBase *copy = _pending.back().second;
+            _pending.pop_back();
+
+            for (RLMProperty *prop in source->_objectSchema.properties) {
+                id value = RLMDynamicGet(source, prop);
+                if (prop.type == RLMPropertyTypeObject) {
+                    value = this->copy(value);
+                }
+                else if (prop.type == RLMPropertyTypeArray) {
+                    NSMutableArray *objects = [NSMutableArray new];
+                    for (RLMObjectBase *target in (id<NSFastEnumeration>)value) {
+                        [objects addObject:this->copy(target)];
+                    }
+                    value = objects;
+                }
+                [copy setValue:value forKey:prop.name];
+            }
+        }
+    }
+
+private:
+    std::map<std::pair<RLMClassInfo *, size_t>, RLMObjectBase *> _copies;
+    std::vector<std::pair<RLMObjectBase *, RLMObjectBase *>> _pending;
+};
+} // anonymous namespace
+
+RLMObjectBase *RLMDetachedCopy(__unsafe_unretained RLMObjectBase *const obj) {
+    RLMDetachedCopier copier;
+    RLMObjectBase *copy = copier.copy(obj);
+    copier.finish();
+    return copy;
+}
+
+NSArray *RLMDetachedCopies(__unsafe_unretained id<NSFastEnumeration> const objects) {
+    RLMDetachedCopier copier;
+    NSMutableArray *copies = [NSMutableArray new];
+    for (RLMObjectBase *obj in objects) {
+        [copies addObject:copier.copy(obj)];
+    }
+    copier.finish();
+    return copies;
+}
@@ -22,7 +22,7 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
-@class RLMObject, RLMRealm, RLMResults<RLMObjectType: RLMObject *>, RLMNotificationToken;
+@class RLMObject, RLMRealm, RLMResults<RLMObjectType: RLMObject *>, RLMNotificationToken, RLMArrayView<RLMObjectType: RLMObject *>;
 
 /**
  `RLMArray` is the container type in Realm used to define to-many relationships.
@@ -92,6 +92,39 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (RLMObjectType)objectAtIndex:(NSUInteger)index;
 
+/**
+ Returns the objects at the given indexes.
+
+ This is equivalent to calling `objectAtIndex:` for each index, but checks the
+ array's thread and validity only once, which makes reading a batch of
+ objects, such as the rows passed to `-tableView:prefetchRowsAtIndexPaths:`,
+ faster.
+
+ @param indexes The indexes of the objects to return.
+
+ @return An array of the objects at the given indexes, in order of their index.
+ */
+- (NSArray<RLMObjectType> *)objectsAtIndexes:(NSIndexSet *)indexes;
+
+/**
+ Returns an object which fast-enumerates the objects in the array, resolving
+ the to-one relationships along the given key paths for each batch of objects
+ at once.
+
+ Reading `post.author.name` for every post in a loop otherwise looks up the
+ link and creates an accessor for the author of each post separately. Included
+ key paths are instead resolved for every object in a batch before the batch
+ is enumerated, one relationship at a time, and objects which link to the same
+ object share a single accessor for it, so reading the relationship in the
+ loop body is only a check that the link hasn't changed.
+
+ @param keyPaths    Key paths made up of to-one relationships, such as
+                    `@"author"` or `@"author.team"`.
+
+ @return An object to use in a `for...in` loop.
+ */
+- (id<NSFastEnumeration>)objectsIncludingKeyPaths:(NSArray<NSString *> *)keyPaths;
+
 /**
  Returns the first object in the array.
 
@@ -182,6 +215,24 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (void)replaceObjectAtIndex:(NSUInteger)index withObject:(RLMObjectType)anObject;
 
+/**
+ Replaces the objects in the given range with the objects in an enumerable.
+
+ The new objects are validated before the array is changed, and as many of the
+ existing objects as possible are overwritten in place, so this is much faster
+ than removing and inserting the objects one at a time. The number of new
+ objects does not need to match the length of the range.
+
+ Throws an exception if the range exceeds the bounds of the array.
+
+ @warning This method may only be called during a write transaction.
+
+ @param range   The range of the objects to replace.
+ @param objects An enumerable object such as `NSArray` or `RLMResults` which
+                contains objects of the same class as the array.
+ */
+- (void)replaceObjectsInRange:(NSRange)range withObjects:(id<NSFastEnumeration>)objects;
+
 /**
  Moves the object at the given source index to the given destination index.
 
@@ -206,6 +257,19 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (void)exchangeObjectAtIndex:(NSUInteger)index1 withObjectAtIndex:(NSUInteger)index2;
 
+/**
+ Sorts the objects in the array in place.
+
+ Objects which compare equal keep their existing relative order. For managed
+ arrays the objects are moved into their new positions rather than removed and
+ re-added, and collection notifications report the new order as moves.
+
+ @warning This method may only be called during a write transaction.
+
+ @param properties  An array of `RLMSortDescriptor`s to sort by.
+ */
+- (void)sortUsingDescriptors:(NSArray<RLMSortDescriptor *> *)properties;
+
 #pragma mark - Querying an Array
 
 /**
@@ -289,6 +353,27 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (RLMResults<RLMObjectType> *)sortedResultsUsingDescriptors:(NSArray<RLMSortDescriptor *> *)properties;
 
+/**
+ Returns a live view of the objects in the array which match a predicate, sorted by the given sort descriptors.
+
+ Unlike the results returned by `-objectsWithPredicate:` and `-sortedResultsUsingDescriptors:`, which run their
+ query again over the whole array each time it changes, the view is updated from the changes to the array: only
+ objects which were inserted into the array or modified are tested against the predicate, and they are merged into
+ the objects already in the view.
+
+ The view is updated when the array's notifications are delivered, so it must be created on a thread with a run loop,
+ and objects are tested with `-[NSPredicate evaluateWithObject:]`.
+
+ @warning This method may only be called on a managed array.
+
+ @param predicate       The predicate with which to filter the objects, or `nil` to include every object.
+ @param sortDescriptors The sort descriptors to sort the objects by, or `nil` to keep them in the order of the array.
+
+ @return An `RLMArrayView` of the matching objects.
+ */
+- (RLMArrayView<RLMObjectType> *)viewWithPredicate:(nullable NSPredicate *)predicate
+                                   sortDescriptors:(nullable NSArray<RLMSortDescriptor *> *)sortDescriptors;
+
 /// :nodoc:
 - (RLMObjectType)objectAtIndexedSubscript:(NSUInteger)index;
 
@@ -355,6 +440,91 @@ NS_ASSUME_NONNULL_BEGIN
                                                          RLMCollectionChange *__nullable changes,
                                                          NSError *__nullable error))block __attribute__((warn_unused_result));
 
+/**
+ Registers a block to be called each time the array changes, but only reports
+ modifications to objects which changed the values at the given key paths.
+
+ This works like `-addNotificationBlock:`, except that an object is only
+ reported as modified if the value at at least one of `keyPaths` changed, and
+ the block is not called at all if the only changes were to other properties
+ of the objects in the array or to objects they link to. Insertions and
+ deletions are always reported.
+
+ Each key path is either the name of a property of the objects in the array or
+ a path through to-one links such as `@"owner.name"`.
+
+ @warning This method cannot be called during a write transaction, or when the
+          containing Realm is read-only.
+ @warning This method may only be called on a managed array.
+
+ @param block    The block to be called each time the array changes.
+ @param keyPaths The key paths of the properties whose changes should be reported.
+ @return A token which must be held for as long as you want updates to be delivered.
+ */
+- (RLMNotificationToken *)addNotificationBlock:(void (^)(RLMArray<RLMObjectType> *__nullable array,
+                                                         RLMCollectionChange *__nullable changes,
+                                                         NSError *__nullable error))block
+                                      keyPaths:(NSArray<NSString *> *)keyPaths __attribute__((warn_unused_result));
+
+/**
+ Registers a block to be called each time the array changes, but no more
+ often than once per `minimumInterval` seconds.
+
+ This works like `-addNotificationBlock:keyPaths:`, except that changes which
+ are committed within `minimumInterval` seconds of the last time the block was
+ called are not reported right away. They are merged together, and the block
+ is called once with the combined changes when the interval has passed. The
+ combined `RLMCollectionChange` describes the changes since the previous call,
+ so it can be applied to a `UITableView` in the same way as a single change,
+ while the table view is reloaded at a bounded rate.
+
+ Pass `nil` for `keyPaths` to report modifications to any property.
+
+ @warning This method cannot be called during a write transaction, or when the
+          containing Realm is read-only.
+ @warning This method may only be called on a managed array.
+
+ @param block           The block to be called whenever a change occurs.
+ @param keyPaths        The key paths of the properties whose changes should be
+                        reported, or `nil` for all properties.
+ @param minimumInterval The minimum time in seconds between calls to the block.
+ @return A token which must be held for as long as you want updates to be delivered.
+ */
+- (RLMNotificationToken *)addNotificationBlock:(void (^)(RLMArray<RLMObjectType> *__nullable array,
+                                                         RLMCollectionChange *__nullable changes,
+                                                         NSError *__nullable error))block
+                                      keyPaths:(nullable NSArray<NSString *> *)keyPaths
+                               minimumInterval:(NSTimeInterval)minimumInterval __attribute__((warn_unused_result));
+
+/**
+ Registers a block to be called on the given dispatch queue each time the
+ array changes.
+
+ This works like `-addNotificationBlock:`, except that the block is called
+ asynchronously on `queue` rather than on the current thread, and the current
+ thread does not need to run a run loop. The notifications for all queues are
+ computed on a single background thread managed by Realm.
+
+ The `RLMArray` passed to the block belongs to a Realm opened for the thread
+ which the queue is running the block on, and must not be used after the
+ block returns. Use an `RLMThreadSafeReference` to pass it to other threads.
+
+ The token returned by this method cannot be passed to
+ `-[RLMRealm commitWriteTransactionWithoutNotifying:error:]`.
+
+ @warning This method cannot be called during a write transaction, or when the
+          containing Realm is read-only.
+ @warning This method may only be called on a managed array.
+
+ @param block The block to be called whenever a change occurs.
+ @param queue The serial queue to call the block on.
+ @return A token which must be held for as long as you want updates to be delivered.
+ */
+- (RLMNotificationToken *)addNotificationBlock:(void (^)(RLMArray<RLMObjectType> *__nullable array,
+                                                         RLMCollectionChange *__nullable changes,
+                                                         NSError *__nullable error))block
+                                         queue:(dispatch_queue_t)queue __attribute__((warn_unused_result));
+
 #pragma mark - Aggregating Property Values
 
 /**
@@ -413,6 +583,21 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (nullable NSNumber *)averageOfProperty:(NSString *)property;
 
+/**
+ Returns the count, minimum, maximum, sum, average and variance of the values of a given property over the objects in
+ the array, all computed in a single pass over the objects.
+
+     RLMPropertyStatistics *stats = [object.arrayProperty statisticsForProperty:@"age"];
+
+ @warning You cannot use this method on `RLMObject`, `RLMArray`, and `NSData` properties.
+
+ @param property The property whose statistics should be calculated. Only
+                 properties of types `int`, `float`, and `double` are supported.
+
+ @return The statistics of the given property.
+ */
+- (RLMPropertyStatistics *)statisticsForProperty:(NSString *)property;
+
 
 #pragma mark - Unavailable Methods
 
@@ -430,6 +615,63 @@ NS_ASSUME_NONNULL_BEGIN
 
 @end
 
+/**
+ An `RLMArrayView` is a live, filtered and sorted view of the objects in an `RLMArray`, created with
+ `-[RLMArray viewWithPredicate:sortDescriptors:]`.
+
+ Each time the array changes, only the objects which were inserted into it or modified are tested against the
+ predicate and placed in the sort order, so keeping the view up to date costs time proportional to the number of
+ changed objects rather than to the size of the array.
+ */
+@interface RLMArrayView<RLMObjectType: RLMObject *> : NSObject
+
+/// The array whose objects are viewed.
+@property (nonatomic, readonly) RLMArray<RLMObjectType> *array;
+
+/// The predicate which objects in the view match, if any.
+@property (nonatomic, readonly, nullable) NSPredicate *predicate;
+
+/// The sort descriptors which the objects in the view are sorted by.
+@property (nonatomic, readonly) NSArray<RLMSortDescriptor *> *sortDescriptors;
+
+/// The number of objects in the view.
+@property (nonatomic, readonly) NSUInteger count;
+
+/**
+ Returns the object at the index specified.
+
+ @param index   The index to look up.
+ */
+- (RLMObjectType)objectAtIndex:(NSUInteger)index;
+
+/// :nodoc:
+- (RLMObjectType)objectAtIndexedSubscript:(NSUInteger)index;
+
+/**
+ Registers a block to be called each time the view changes.
+
+ The block is called asynchronously with the initial view and a `nil` change, and then after each write transaction
+ which changes the objects in the view, after the view has been updated, with the indexes of the objects which were
+ deleted, inserted or modified in the view.
+
+ You must retain the returned token for as long as you want updates to continue to be sent to the block. To stop
+ receiving updates, call `-stop` on the token.
+
+ @param block The block to be called whenever a change occurs.
+ @return A token which must be held for as long as you want updates to be delivered.
+ */
+- (RLMNotificationToken *)addNotificationBlock:(void (^)(RLMArrayView<RLMObjectType> *__nullable view,
+                                                         RLMCollectionChange *__nullable change,
+                                                         NSError *__nullable error))block __attribute__((warn_unused_result));
+
+/// :nodoc:
+- (instancetype)init __attribute__((unavailable("RLMArrayView cannot be created directly")));
+
+/// :nodoc:
++ (instancetype)new __attribute__((unavailable("RLMArrayView cannot be created directly")));
+
+@end
+
 /// :nodoc:
 @interface RLMArray (Swift)
 // for use only in Swift class definitions
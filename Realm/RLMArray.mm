@@ -234,6 +234,40 @@ static void RLMValidateArrayBounds(__unsafe_unretained RLMArray *const ar,
     });
 }
 
+- (void)replaceObjectsInRange:(NSRange)range withObjects:(id<NSFastEnumeration>)objects {
+    NSUInteger count = _backingArray.count;
+    if (range.location > count || range.length > count - range.location) {
+        @throw RLMException(@"Range %@ is out of bounds (must be within 0 to %llu)",
+                            NSStringFromRange(range), (unsigned long long)count);
+    }
+    NSMutableArray *newObjects = [NSMutableArray new];
+    for (id obj in objects) {
+        RLMValidateMatchingObjectType(self, obj);
+        [newObjects addObject:obj];
+    }
+
+    NSUInteger replaced = std::min<NSUInteger>(range.length, newObjects.count);
+    if (replaced) {
+        changeArray(self, NSKeyValueChangeReplacement, NSMakeRange(range.location, replaced), ^{
+            [_backingArray replaceObjectsInRange:NSMakeRange(range.location, replaced)
+                            withObjectsFromArray:[newObjects subarrayWithRange:NSMakeRange(0, replaced)]];
+        });
+    }
+    if (newObjects.count > replaced) {
+        NSRange inserted = NSMakeRange(range.location + replaced, newObjects.count - replaced);
+        changeArray(self, NSKeyValueChangeInsertion, inserted, ^{
+            [_backingArray insertObjects:[newObjects subarrayWithRange:NSMakeRange(replaced, inserted.length)]
+                               atIndexes:[NSIndexSet indexSetWithIndexesInRange:inserted]];
+        });
+    }
+    else if (range.length > replaced) {
+        NSRange removed = NSMakeRange(range.location + replaced, range.length - replaced);
+        changeArray(self, NSKeyValueChangeRemoval, removed, ^{
+            [_backingArray removeObjectsInRange:removed];
+        });
+    }
+}
+
 - (void)removeObjectAtIndex:(NSUInteger)index {
     RLMValidateArrayBounds(self, index);
     changeArray(self, NSKeyValueChangeRemoval, index, ^{
@@ -281,6 +315,30 @@ static void RLMValidateArrayBounds(__unsafe_unretained RLMArray *const ar,
     });
 }
 
+- (void)sortUsingDescriptors:(NSArray<RLMSortDescriptor *> *)properties {
+    if (properties.count == 0 || _backingArray.count < 2) {
+        return;
+    }
+
+    NSMutableArray *descriptors = [NSMutableArray arrayWithCapacity:properties.count];
+    for (RLMSortDescriptor *descriptor in properties) {
+        [descriptors addObject:[NSSortDescriptor sortDescriptorWithKey:descriptor.keyPath
+                                                             ascending:descriptor.ascending]];
+    }
+    NSArray *sorted = [_backingArray sortedArrayWithOptions:NSSortStable usingComparator:^(id obj1, id obj2) {
+        for (NSSortDescriptor *descriptor in descriptors) {
+            NSComparisonResult result = [descriptor compareObject:obj1 toObject:obj2];
+            if (result != NSOrderedSame) {
+                return result;
+            }
+        }
+        return NSOrderedSame;
+    }];
+    changeArray(self, NSKeyValueChangeReplacement, NSMakeRange(0, _backingArray.count), ^{
+        [_backingArray setArray:sorted];
+    });
+}
+
 - (NSUInteger)indexOfObject:(RLMObject *)object {
     RLMValidateMatchingObjectType(self, object);
     NSUInteger index = 0;
@@ -346,9 +404,9 @@ static void RLMValidateArrayBounds(__unsafe_unretained RLMArray *const ar,
     [_backingArray setValue:value forKey:key];
 }
 
-- (void)validateAggregateProperty:(NSString *)propertyName
-                           method:(SEL)aggregateMethod
-                        allowDate:(bool)allowDate {
+- (RLMProperty *)validateAggregateProperty:(NSString *)propertyName
+                                    method:(SEL)aggregateMethod
+                                 allowDate:(bool)allowDate {
     RLMObjectSchema *objectSchema;
     if (_backingArray.count) {
         objectSchema = [_backingArray[0] objectSchema];
@@ -373,6 +431,7 @@ static void RLMValidateArrayBounds(__unsafe_unretained RLMArray *const ar,
                                 NSStringFromSelector(aggregateMethod),
                                 RLMTypeToString(prop.type), _objectClassName, propertyName);
     }
+    return prop;
 }
 
 - (id)minOfProperty:(NSString *)property {
@@ -395,6 +454,24 @@ static void RLMValidateArrayBounds(__unsafe_unretained RLMArray *const ar,
     return [_backingArray valueForKeyPath:[@"@avg." stringByAppendingString:property]];
 }
 
+- (RLMPropertyStatistics *)statisticsForProperty:(NSString *)property {
+    RLMProperty *prop = [self validateAggregateProperty:property method:_cmd allowDate:false];
+    RLMStatisticsAccumulator accumulator(prop.type);
+    for (id object in _backingArray) {
+        id value = [object valueForKey:property];
+        if (!value || value == NSNull.null) {
+            continue;
+        }
+        if (prop.type == RLMPropertyTypeInt) {
+            accumulator.add((int64_t)[value longLongValue]);
+        }
+        else {
+            accumulator.add([value doubleValue]);
+        }
+    }
+    return accumulator.statistics();
+}
+
 - (NSUInteger)indexOfObjectWithPredicate:(NSPredicate *)predicate {
     if (!_backingArray) {
         return NSNotFound;
@@ -411,6 +488,11 @@ static void RLMValidateArrayBounds(__unsafe_unretained RLMArray *const ar,
     return [_backingArray objectsAtIndexes:indexes];
 }
 
+- (id<NSFastEnumeration>)objectsIncludingKeyPaths:(__unused NSArray<NSString *> *)keyPaths {
+    // The objects in an unmanaged array are already resolved
+    return self;
+}
+
 - (void)addObserver:(NSObject *)observer forKeyPath:(NSString *)keyPath options:(NSKeyValueObservingOptions)options context:(void *)context {
     RLMValidateArrayObservationKey(keyPath, self);
     [super addObserver:observer forKeyPath:keyPath options:options context:context];
@@ -443,6 +525,11 @@ static void RLMValidateArrayBounds(__unsafe_unretained RLMArray *const ar,
     @throw RLMException(@"This method may only be called on RLMArray instances retrieved from an RLMRealm");
 }
 
+- (RLMArrayView *)viewWithPredicate:(NSPredicate *)predicate sortDescriptors:(NSArray<RLMSortDescriptor *> *)sortDescriptors
+{
+    @throw RLMException(@"This method may only be called on RLMArray instances retrieved from an RLMRealm");
+}
+
 // The compiler complains about the method's argument type not matching due to
 // it not having the generic type attached, but it doesn't seem to be possible
 // to actually include the generic type
@@ -451,6 +538,22 @@ static void RLMValidateArrayBounds(__unsafe_unretained RLMArray *const ar,
 - (RLMNotificationToken *)addNotificationBlock:(void (^)(RLMArray *, RLMCollectionChange *, NSError *))block {
     @throw RLMException(@"This method may only be called on RLMArray instances retrieved from an RLMRealm");
 }
+
+- (RLMNotificationToken *)addNotificationBlock:(void (^)(RLMArray *, RLMCollectionChange *, NSError *))block
+                                      keyPaths:(NSArray<NSString *> *)keyPaths {
+    @throw RLMException(@"This method may only be called on RLMArray instances retrieved from an RLMRealm");
+}
+
+- (RLMNotificationToken *)addNotificationBlock:(void (^)(RLMArray *, RLMCollectionChange *, NSError *))block
+                                      keyPaths:(NSArray<NSString *> *)keyPaths
+                               minimumInterval:(NSTimeInterval)minimumInterval {
+    @throw RLMException(@"This method may only be called on RLMArray instances retrieved from an RLMRealm");
+}
+
+- (RLMNotificationToken *)addNotificationBlock:(void (^)(RLMArray *, RLMCollectionChange *, NSError *))block
+                                         queue:(dispatch_queue_t)queue {
+    @throw RLMException(@"This method may only be called on RLMArray instances retrieved from an RLMRealm");
+}
 #pragma clang diagnostic pop
 
 - (NSUInteger)indexOfObjectWhere:(NSString *)predicateFormat, ...
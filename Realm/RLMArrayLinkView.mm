@@ -34,6 +34,13 @@
 
 #import <realm/table_view.hpp>
 #import <objc/runtime.h>
+#import <algorithm>
+#import <unordered_map>
+#import <unordered_set>
+
+// Lists at least this long get a row -> position index built the first time
+// indexOfObject: is called on them outside of a write transaction
+static const size_t c_positionIndexMinimumSize = 1000;
 
 @interface RLMArrayLinkViewHandoverMetadata : NSObject
 @property (nonatomic) NSString *parentClassName;
@@ -46,6 +53,13 @@
 @interface RLMArrayLinkView () <RLMThreadConfined_Private>
 @end
 
+@interface RLMArrayView ()
+- (instancetype)initWithArray:(RLMArrayLinkView *)array
+                    predicate:(NSPredicate *)predicate
+              sortDescriptors:(NSArray<RLMSortDescriptor *> *)sortDescriptors;
+- (void)removeToken:(RLMNotificationToken *)token;
+@end
+
 //
 // RLMArray implementation
 //
@@ -56,6 +70,11 @@
     RLMClassInfo *_objectInfo;
     RLMClassInfo *_ownerInfo;
     std::unique_ptr<RLMObservationInfo> _observationInfo;
+
+    // Maps target row indices to the first position they appear at in the
+    // list. Only valid while _realm->_readGeneration == _positionIndexGeneration.
+    std::unordered_map<size_t, size_t> _positionIndex;
+    uint64_t _positionIndexGeneration;
 }
 
 - (RLMArrayLinkView *)initWithList:(realm::List)list
@@ -169,10 +188,17 @@ template<typename IndexSetFactory>
 static void changeArray(__unsafe_unretained RLMArrayLinkView *const ar,
                         NSKeyValueChange kind, dispatch_block_t f, IndexSetFactory&& is) {
     translateErrors([&] { ar->_backingList.verify_in_transaction(); });
+    if (ar->_realm->_bulkWrite) {
+        // Observers are notified when the bulk write is committed
+        translateErrors([&] { f(); });
+        return;
+    }
     RLMObservationInfo *info = RLMGetObservationInfo(ar->_observationInfo.get(),
                                                      ar->_backingList.get_origin_row_index(),
                                                      *ar->_ownerInfo);
-    if (info) {
+    // Observation infos outlive the observers which caused them to be created,
+    // so skip building the index set if nothing is actually observing the row
+    if (info && info->rowHasObservers()) {
         NSIndexSet *indexes = is();
         info->willChange(ar->_key, kind, indexes);
         try {
@@ -273,12 +299,32 @@ static void RLMInsertObject(RLMArrayLinkView *ar, RLMObject *object, NSUInteger
     RLMInsertObject(self, object, index);
 }
 
+// Validate all of the objects to be added in one pass before changing the
+// list, so that a bad object doesn't leave the list partially modified and the
+// actual modification is just a loop over the row indices
+static std::vector<size_t> rowIndicesForObjectsToAdd(__unsafe_unretained RLMArrayLinkView *const ar,
+                                                      __unsafe_unretained id<NSFastEnumeration> const objects) {
+    std::vector<size_t> rows;
+    if ([(id)objects respondsToSelector:@selector(count)]) {
+        rows.reserve([(id)objects count]);
+    }
+    for (RLMObject *obj in objects) {
+        validateObjectToAdd(ar, obj);
+        rows.push_back(obj->_row.get_index());
+    }
+    return rows;
+}
+
 - (void)insertObjects:(id<NSFastEnumeration>)objects atIndexes:(NSIndexSet *)indexes {
+    auto rows = rowIndicesForObjectsToAdd(self, objects);
+    if (rows.size() != indexes.count) {
+        @throw RLMException(@"Number of objects (%zu) does not match number of indexes (%llu)",
+                            rows.size(), (unsigned long long)indexes.count);
+    }
     changeArray(self, NSKeyValueChangeInsertion, indexes, ^{
         NSUInteger index = [indexes firstIndex];
-        for (RLMObject *obj in objects) {
-            validateObjectToAdd(self, obj);
-            _backingList.insert(index, obj->_row.get_index());
+        for (size_t row : rows) {
+            _backingList.insert(index, row);
             index = [indexes indexGreaterThanIndex:index];
         }
     });
@@ -292,22 +338,75 @@ static void RLMInsertObject(RLMArrayLinkView *ar, RLMObject *object, NSUInteger
 }
 
 - (void)removeObjectsAtIndexes:(NSIndexSet *)indexes {
+    NSUInteger count = self.count;
+    if (indexes.lastIndex != NSNotFound && indexes.lastIndex >= count) {
+        @throw RLMException(@"Index %llu is out of bounds (must be less than %llu)",
+                            (unsigned long long)indexes.lastIndex, (unsigned long long)count);
+    }
     changeArray(self, NSKeyValueChangeRemoval, indexes, ^{
+        // removing everything is a single operation rather than one per row
+        if (indexes.count == count) {
+            _backingList.remove_all();
+            return;
+        }
         [indexes enumerateIndexesWithOptions:NSEnumerationReverse usingBlock:^(NSUInteger idx, BOOL *) {
             _backingList.remove(idx);
         }];
     });
 }
 
-- (void)addObjectsFromArray:(NSArray *)array {
-    changeArray(self, NSKeyValueChangeInsertion, NSMakeRange(self.count, array.count), ^{
-        for (RLMObject *obj in array) {
-            validateObjectToAdd(self, obj);
-            _backingList.add(obj->_row.get_index());
+static void RLMAddRows(__unsafe_unretained RLMArrayLinkView *const ar, std::vector<size_t> const& rows) {
+    changeArray(ar, NSKeyValueChangeInsertion, NSMakeRange(ar.count, rows.size()), ^{
+        for (size_t row : rows) {
+            ar->_backingList.add(row);
         }
     });
 }
 
+- (void)addObjectsFromArray:(NSArray *)array {
+    RLMAddRows(self, rowIndicesForObjectsToAdd(self, array));
+}
+
+- (void)addObjects:(id<NSFastEnumeration>)objects {
+    RLMAddRows(self, rowIndicesForObjectsToAdd(self, objects));
+}
+
+- (void)replaceObjectsInRange:(NSRange)range withObjects:(id<NSFastEnumeration>)objects {
+    NSUInteger count = self.count;
+    if (range.location > count || range.length > count - range.location) {
+        @throw RLMException(@"Range %@ is out of bounds (must be within 0 to %llu)",
+                            NSStringFromRange(range), (unsigned long long)count);
+    }
+    auto rows = rowIndicesForObjectsToAdd(self, objects);
+
+    // Overwrite the rows the range and the new objects have in common in
+    // place, and then insert or remove only the difference
+    NSUInteger replaced = std::min<NSUInteger>(range.length, rows.size());
+    if (replaced) {
+        changeArray(self, NSKeyValueChangeReplacement, NSMakeRange(range.location, replaced), ^{
+            for (NSUInteger i = 0; i < replaced; ++i) {
+                _backingList.set(range.location + i, rows[i]);
+            }
+        });
+    }
+    if (rows.size() > replaced) {
+        NSRange inserted = NSMakeRange(range.location + replaced, rows.size() - replaced);
+        changeArray(self, NSKeyValueChangeInsertion, inserted, ^{
+            for (NSUInteger i = 0; i < inserted.length; ++i) {
+                _backingList.insert(inserted.location + i, rows[replaced + i]);
+            }
+        });
+    }
+    else if (range.length > replaced) {
+        NSRange removed = NSMakeRange(range.location + replaced, range.length - replaced);
+        changeArray(self, NSKeyValueChangeRemoval, removed, ^{
+            for (NSUInteger i = removed.length; i > 0; --i) {
+                _backingList.remove(removed.location + i - 1);
+            }
+        });
+    }
+}
+
 - (void)removeAllObjects {
     changeArray(self, NSKeyValueChangeRemoval, NSMakeRange(0, self.count), ^{
         _backingList.remove_all();
@@ -339,6 +438,146 @@ static void RLMInsertObject(RLMArrayLinkView *ar, RLMObject *object, NSUInteger
     });
 }
 
+// Computes the moves which turn the list into the given order, where
+// `sources[i]` is the current position of the object that belongs at position i.
+// Only the objects not in the longest run which is already in the right relative
+// order are moved, so the number of moves is the minimum possible.
+static std::vector<std::pair<size_t, size_t>> movesForPermutation(std::vector<size_t> const& sources) {
+    size_t count = sources.size();
+
+    // Longest increasing subsequence of `sources`
+    std::vector<size_t> tails, predecessors(count, realm::npos);
+    for (size_t i = 0; i < count; ++i) {
+        auto it = std::lower_bound(tails.begin(), tails.end(), i, [&](size_t a, size_t b) {
+            return sources[a] < sources[b];
+        });
+        if (it != tails.begin()) {
+            predecessors[i] = *(it - 1);
+        }
+        if (it == tails.end()) {
+            tails.push_back(i);
+        }
+        else {
+            *it = i;
+        }
+    }
+    std::vector<bool> inPlace(count);
+    for (size_t i = tails.empty() ? realm::npos : tails.back(); i != realm::npos; i = predecessors[i]) {
+        inPlace[i] = true;
+    }
+
+    // Move each remaining object to directly after the object which precedes
+    // it in the final order, in final order. The objects moved after each
+    // object which stays in place (or to the front) then form a run in final
+    // order directly after it, so the list is always a subset of a fixed
+    // sequence of slots: the current positions, each followed by the run of
+    // the object there if it stays in place. An object's position is the
+    // number of occupied slots before its slot, which a Fenwick tree over the
+    // slots counts in O(log n).
+    std::vector<size_t> originalSlot(count), movedSlot(count);
+    size_t slotCount = 0;
+    for (size_t i = 0; i < count && !inPlace[i]; ++i) {
+        movedSlot[i] = slotCount++;
+    }
+    // `current[p]` is the final position of the object currently at position p
+    std::vector<size_t> current(count);
+    for (size_t i = 0; i < count; ++i) {
+        current[sources[i]] = i;
+    }
+    for (size_t p = 0; p < count; ++p) {
+        size_t object = current[p];
+        originalSlot[object] = slotCount++;
+        if (inPlace[object]) {
+            for (size_t i = object + 1; i < count && !inPlace[i]; ++i) {
+                movedSlot[i] = slotCount++;
+            }
+        }
+    }
+
+    std::vector<ptrdiff_t> occupied(slotCount + 1);
+    auto update = [&](size_t slot, ptrdiff_t delta) {
+        for (++slot; slot <= slotCount; slot += slot & -slot) {
+            occupied[slot] += delta;
+        }
+    };
+    auto positionOf = [&](size_t slot) {
+        ptrdiff_t position = 0;
+        for (; slot > 0; slot -= slot & -slot) {
+            position += occupied[slot];
+        }
+        return static_cast<size_t>(position);
+    };
+    for (size_t i = 0; i < count; ++i) {
+        update(originalSlot[i], 1);
+    }
+
+    std::vector<std::pair<size_t, size_t>> moves;
+    for (size_t i = 0; i < count; ++i) {
+        if (inPlace[i]) {
+            continue;
+        }
+        size_t from = positionOf(originalSlot[i]);
+        update(originalSlot[i], -1);
+        size_t to = positionOf(movedSlot[i]);
+        update(movedSlot[i], 1);
+        if (from != to) {
+            moves.emplace_back(from, to);
+        }
+    }
+    return moves;
+}
+
+- (void)sortUsingDescriptors:(NSArray<RLMSortDescriptor *> *)properties {
+    translateErrors([&] { _backingList.verify_in_transaction(); });
+    if (properties.count == 0) {
+        return;
+    }
+
+    auto order = RLMSortDescriptorFromDescriptors(*_objectInfo, properties);
+    auto sources = translateErrors([&] {
+        size_t count = _backingList.size();
+
+        // Current positions of each target row, last first, so that duplicate
+        // entries are matched up in their existing order
+        std::unordered_map<size_t, std::vector<size_t>> positions;
+        for (size_t i = count; i > 0; --i) {
+            positions[_backingList.get(i - 1).get_index()].push_back(i - 1);
+        }
+
+        auto sorted = _backingList.sort(std::move(order));
+        std::vector<size_t> sources;
+        sources.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            auto& rowPositions = positions[sorted.get(i).get_index()];
+            sources.push_back(rowPositions.back());
+            rowPositions.pop_back();
+        }
+        return sources;
+    });
+
+    NSMutableIndexSet *changed = [NSMutableIndexSet new];
+    for (size_t i = 0, count = sources.size(); i < count; ++i) {
+        if (sources[i] == i) {
+            continue;
+        }
+        size_t start = i;
+        while (i + 1 < count && sources[i + 1] != i + 1) {
+            ++i;
+        }
+        [changed addIndexesInRange:NSMakeRange(start, i - start + 1)];
+    }
+    if (changed.count == 0) {
+        return;
+    }
+
+    auto moves = movesForPermutation(sources);
+    changeArray(self, NSKeyValueChangeReplacement, changed, ^{
+        for (auto& move : moves) {
+            _backingList.move(move.first, move.second);
+        }
+    });
+}
+
 - (NSUInteger)indexOfObject:(RLMObject *)object {
     if (object.invalidated) {
         @throw RLMException(@"Object has been deleted or invalidated");
@@ -350,7 +589,30 @@ static void RLMInsertObject(RLMArrayLinkView *ar, RLMObject *object, NSUInteger
                             object->_objectSchema.className, _objectClassName);
     }
 
-    return translateErrors([&] { return RLMConvertNotFound(_backingList.find(object->_row)); });
+    return translateErrors([&] {
+        size_t size = _backingList.size();
+        if (size < c_positionIndexMinimumSize || _realm.inWriteTransaction || object->_info != _objectInfo) {
+            return RLMConvertNotFound(_backingList.find(object->_row));
+        }
+
+        // Nothing can modify the list without either beginning a write
+        // transaction or advancing the read transaction, both of which bump
+        // the generation, so the index stays valid until that happens
+        if (_positionIndex.empty() || _positionIndexGeneration != _realm->_readGeneration) {
+            _positionIndex.clear();
+            _positionIndex.reserve(size);
+            for (size_t i = 0; i < size; ++i) {
+                _positionIndex.emplace(_backingList.get(i).get_index(), i);
+            }
+            _positionIndexGeneration = _realm->_readGeneration;
+        }
+
+        auto it = _positionIndex.find(object->_row.get_index());
+        if (it == _positionIndex.end()) {
+            return (NSUInteger)NSNotFound;
+        }
+        return (NSUInteger)it->second;
+    });
 }
 
 - (id)valueForKeyPath:(NSString *)keyPath {
@@ -411,6 +673,10 @@ static void RLMInsertObject(RLMArrayLinkView *ar, RLMObject *object, NSUInteger
     return [self aggregate:property method:&realm::List::average methodName:@"averageOfProperty"];
 }
 
+- (RLMPropertyStatistics *)statisticsForProperty:(NSString *)property {
+    return RLMStatisticsForProperty(self.tableView, *_objectInfo, property);
+}
+
 - (void)deleteObjectsFromRealm {
     // delete all target rows from the realm
     RLMTrackDeletions(_realm, ^{
@@ -426,18 +692,32 @@ static void RLMInsertObject(RLMArrayLinkView *ar, RLMObject *object, NSUInteger
 
     auto order = RLMSortDescriptorFromDescriptors(*_objectInfo, properties);
     auto results = translateErrors([&] { return _backingList.sort(std::move(order)); });
-    return [RLMResults resultsWithObjectInfo:*_objectInfo results:std::move(results)];
+    RLMResults *sorted = [RLMResults resultsWithObjectInfo:*_objectInfo results:std::move(results)];
+    sorted.sortDescriptors = properties;
+    return sorted;
 }
 
 - (RLMResults *)objectsWithPredicate:(NSPredicate *)predicate {
-    auto query = RLMPredicateToQuery(predicate, _objectInfo->rlmObjectSchema, _realm.schema, _realm.group);
+    auto query = RLMPredicateToQuery(predicate, *_objectInfo);
     auto results = translateErrors([&] { return _backingList.filter(std::move(query)); });
-    return [RLMResults resultsWithObjectInfo:*_objectInfo results:std::move(results)];
+    RLMResults *filtered = [RLMResults resultsWithObjectInfo:*_objectInfo results:std::move(results)];
+    filtered.filters = @[predicate];
+    return filtered;
+}
+
+- (RLMArrayView *)viewWithPredicate:(NSPredicate *)predicate sortDescriptors:(NSArray<RLMSortDescriptor *> *)sortDescriptors {
+    [_realm verifyNotificationsAreSupported];
+    // Converting the sort descriptors validates them against the schema, even
+    // though the view doesn't sort with them as a query
+    if (sortDescriptors.count) {
+        RLMSortDescriptorFromDescriptors(*_objectInfo, sortDescriptors);
+    }
+    return [[RLMArrayView alloc] initWithArray:self predicate:predicate sortDescriptors:sortDescriptors];
 }
 
 - (NSUInteger)indexOfObjectWithPredicate:(NSPredicate *)predicate {
     auto query = translateErrors([&] { return _backingList.get_query(); });
-    query.and_query(RLMPredicateToQuery(predicate, _objectInfo->rlmObjectSchema, _realm.schema, _realm.group));
+    query.and_query(RLMPredicateToQuery(predicate, *_objectInfo));
 #if REALM_VER_MAJOR >= 2
     auto indexInTable = query.find();
     if (indexInTable == realm::not_found) {
@@ -450,10 +730,32 @@ static void RLMInsertObject(RLMArrayLinkView *ar, RLMObject *object, NSUInteger
 #endif
 }
 
-- (NSArray *)objectsAtIndexes:(__unused NSIndexSet *)indexes {
-    // FIXME: this is called by KVO when array changes are made. It's not clear
-    // why, and returning nil seems to work fine.
-    return nil;
+- (id<NSFastEnumeration>)objectsIncludingKeyPaths:(NSArray<NSString *> *)keyPaths {
+    translateErrors([&] { _backingList.verify_attached(); });
+    return [[RLMIncludingKeyPathsEnumerable alloc] initWithCollection:self keyPaths:keyPaths];
+}
+
+- (NSArray *)objectsAtIndexes:(NSIndexSet *)indexes {
+    // KVO calls this for the old values of changes to the array, including
+    // ones made while the array is being invalidated, when there's nothing left
+    // to read
+    if (!translateErrors([&] { return _backingList.is_valid(); })) {
+        return nil;
+    }
+
+    // Checking the count verifies the thread and the list once, so each row
+    // can then be read without repeating either
+    NSUInteger count = self.count;
+    if (indexes.lastIndex != NSNotFound && indexes.lastIndex >= count) {
+        @throw RLMException(@"Index %llu is out of bounds (must be less than %llu)",
+                            (unsigned long long)indexes.lastIndex, (unsigned long long)count);
+    }
+
+    NSMutableArray *objects = [NSMutableArray arrayWithCapacity:indexes.count];
+    for (NSUInteger index = indexes.firstIndex; index != NSNotFound; index = [indexes indexGreaterThanIndex:index]) {
+        [objects addObject:RLMCreateObjectAccessor(_realm, *_objectInfo, _backingList.get_unchecked(index))];
+    }
+    return objects;
 }
 
 - (void)addObserver:(id)observer
@@ -482,6 +784,25 @@ static void RLMInsertObject(RLMArrayLinkView *ar, RLMObject *object, NSUInteger
     [_realm verifyNotificationsAreSupported];
     return RLMAddNotificationBlock(self, _backingList, block);
 }
+
+- (RLMNotificationToken *)addNotificationBlock:(void (^)(RLMArray *, RLMCollectionChange *, NSError *))block
+                                      keyPaths:(NSArray<NSString *> *)keyPaths {
+    [_realm verifyNotificationsAreSupported];
+    return RLMAddNotificationBlock(self, _backingList, block, false, keyPaths);
+}
+
+- (RLMNotificationToken *)addNotificationBlock:(void (^)(RLMArray *, RLMCollectionChange *, NSError *))block
+                                      keyPaths:(NSArray<NSString *> *)keyPaths
+                               minimumInterval:(NSTimeInterval)minimumInterval {
+    [_realm verifyNotificationsAreSupported];
+    return RLMAddNotificationBlock(self, _backingList, block, false, keyPaths, minimumInterval);
+}
+
+- (RLMNotificationToken *)addNotificationBlock:(void (^)(RLMArray *, RLMCollectionChange *, NSError *))block
+                                         queue:(dispatch_queue_t)queue {
+    [_realm verifyNotificationsAreSupported];
+    return RLMAddNotificationBlockOnQueue(self, block, queue);
+}
 #pragma clang diagnostic pop
 
 #pragma mark - Thread Confined Protocol Conformance
@@ -516,3 +837,324 @@ static void RLMInsertObject(RLMArrayLinkView *ar, RLMObject *object, NSUInteger
 }
 
 @end
+
+@interface RLMArrayViewNotificationToken : RLMNotificationToken
+@end
+
+@implementation RLMArrayViewNotificationToken {
+@public
+    RLMArrayView *_view;
+    void (^_block)(RLMArrayView *, RLMCollectionChange *, NSError *);
+    bool _suppressNext;
+}
+
+- (RLMRealm *)realm {
+    return _view.array.realm;
+}
+
+- (void)suppressNextNotification {
+    _suppressNext = true;
+}
+
+- (void)stop {
+    RLMArrayView *view = _view;
+    _view = nil;
+    _block = nil;
+    [view removeToken:self];
+}
+
+- (void)dealloc {
+    [self stop];
+}
+
+@end
+
+namespace {
+struct RLMArrayViewEntry {
+    size_t listIndex;
+    id object;
+    // The values of the object's sort key paths, read once when the object is
+    // added to the view
+    NSArray *sortValues;
+};
+
+NSComparisonResult RLMCompareSortValues(id a, id b) {
+    // Nulls sort before every other value, as they do in queries
+    bool aIsNull = a == NSNull.null, bIsNull = b == NSNull.null;
+    if (aIsNull || bIsNull) {
+        return aIsNull == bIsNull ? NSOrderedSame : aIsNull ? NSOrderedAscending : NSOrderedDescending;
+    }
+    return [a compare:b];
+}
+}
+
+@implementation RLMArrayView {
+    RLMArrayLinkView *_linkView;
+    // The predicate as a query on the objects' table, which is evaluated for a
+    // single row to test an object
+    std::unique_ptr<realm::Query> _query;
+
+    // The objects in the array which match the predicate, in sorted order.
+    // Entries which sort equally are kept in the order of the array.
+    std::vector<RLMArrayViewEntry> _entries;
+
+    RLMNotificationToken *_token;
+    NSPointerArray *_tokens;
+    bool _receivedInitialNotification;
+}
+
+- (instancetype)initWithArray:(RLMArrayLinkView *)array
+                    predicate:(NSPredicate *)predicate
+              sortDescriptors:(NSArray<RLMSortDescriptor *> *)sortDescriptors {
+    self = [super init];
+    if (self) {
+        _array = array;
+        _linkView = array;
+        _predicate = predicate;
+        if (predicate) {
+            _query = std::make_unique<realm::Query>(RLMPredicateToQuery(predicate, *array->_objectInfo));
+        }
+        _sortDescriptors = [sortDescriptors copy] ?: @[];
+        _tokens = [NSPointerArray weakObjectsPointerArray];
+        [self computeEntries];
+
+        __weak RLMArrayView *weakSelf = self;
+        _token = [array addNotificationBlock:^(__unused RLMArray *array, RLMCollectionChange *change, NSError *error) {
+            [weakSelf deliverChange:change error:error];
+        }];
+    }
+    return self;
+}
+
+- (bool)entry:(RLMArrayViewEntry const&)a precedes:(RLMArrayViewEntry const&)b {
+    NSUInteger i = 0;
+    for (RLMSortDescriptor *descriptor in _sortDescriptors) {
+        NSComparisonResult result = RLMCompareSortValues(a.sortValues[i], b.sortValues[i]);
+        ++i;
+        if (result != NSOrderedSame) {
+            return (result == NSOrderedAscending) == descriptor.ascending;
+        }
+    }
+    return a.listIndex < b.listIndex;
+}
+
+// Tests the object at an index in the array against the predicate, and returns
+// whether it matched, filling in the entry for it if it did
+- (bool)evaluateEntry:(RLMArrayViewEntry&)entry atIndex:(size_t)listIndex {
+    if (_query) {
+        size_t row = translateErrors([&] { return _linkView->_backingList.get(listIndex).get_index(); });
+        if (_query->count(row, row + 1, 1) == 0) {
+            return false;
+        }
+    }
+    [self makeEntry:entry atIndex:listIndex];
+    return true;
+}
+
+// Fills in the entry for the object at an index in the array, which matches
+// the predicate
+- (void)makeEntry:(RLMArrayViewEntry&)entry atIndex:(size_t)listIndex {
+    id object = [_array objectAtIndex:listIndex];
+    NSMutableArray *sortValues = [NSMutableArray arrayWithCapacity:_sortDescriptors.count];
+    for (RLMSortDescriptor *descriptor in _sortDescriptors) {
+        [sortValues addObject:[object valueForKeyPath:descriptor.keyPath] ?: NSNull.null];
+    }
+    entry = {listIndex, object, sortValues};
+}
+
+- (void)computeEntries {
+    _entries.clear();
+
+    // Run the predicate as a query on the list once, rather than evaluating it
+    // for each object
+    std::unordered_set<size_t> matches;
+    if (_query) {
+        translateErrors([&] {
+            auto query = _linkView->_backingList.get_query();
+            query.and_query(*_query);
+            auto tv = query.find_all();
+            for (size_t i = 0, count = tv.size(); i < count; ++i) {
+                matches.insert(tv.get_source_ndx(i));
+            }
+        });
+    }
+
+    RLMArrayViewEntry entry;
+    for (size_t i = 0, count = _array.count; i < count; ++i) {
+        if (_query) {
+            size_t row = translateErrors([&] { return _linkView->_backingList.get(i).get_index(); });
+            if (!matches.count(row)) {
+                continue;
+            }
+        }
+        [self makeEntry:entry atIndex:i];
+        _entries.push_back(std::move(entry));
+    }
+    std::stable_sort(_entries.begin(), _entries.end(), [&](auto const& a, auto const& b) {
+        return [self entry:a precedes:b];
+    });
+}
+
+- (NSUInteger)count {
+    return _entries.size();
+}
+
+- (id)objectAtIndex:(NSUInteger)index {
+    if (index >= _entries.size()) {
+        @throw RLMException(@"Index %llu is out of bounds (must be less than %llu).",
+                            (unsigned long long)index, (unsigned long long)_entries.size());
+    }
+    return _entries[index].object;
+}
+
+- (id)objectAtIndexedSubscript:(NSUInteger)index {
+    return [self objectAtIndex:index];
+}
+
+// Update the view for a change to the array, and describe the change in terms
+// of the indexes in the view before and after it. Only the inserted and
+// modified objects are tested and sorted again; the rest of the view keeps its
+// order, and only has the indexes of its objects in the array shifted.
+- (RLMCollectionChange *)applyChange:(RLMCollectionChange *)change {
+    auto& changes = [change changeSet];
+    realm::CollectionChangeSet viewChanges;
+
+    // The index in the view of each modified object before the change, and the
+    // number of unmodified objects which preceded it
+    std::unordered_map<size_t, std::pair<size_t, size_t>> modified;
+    std::vector<RLMArrayViewEntry> entries;
+    entries.reserve(_entries.size());
+    for (size_t i = 0; i < _entries.size(); ++i) {
+        auto& entry = _entries[i];
+        if (changes.deletions.contains(entry.listIndex)) {
+            viewChanges.deletions.add(i);
+            continue;
+        }
+        entry.listIndex = changes.insertions.shift(changes.deletions.unshift(entry.listIndex));
+        if (changes.modifications_new.contains(entry.listIndex)) {
+            modified[entry.listIndex] = {i, entries.size()};
+            continue;
+        }
+        entries.push_back(std::move(entry));
+    }
+
+    auto insert = [&](size_t listIndex) {
+        RLMArrayViewEntry entry;
+        if ([self evaluateEntry:entry atIndex:listIndex]) {
+            auto it = std::upper_bound(entries.begin(), entries.end(), entry, [&](auto const& a, auto const& b) {
+                return [self entry:a precedes:b];
+            });
+            entries.insert(it, std::move(entry));
+        }
+    };
+    for (auto index : changes.insertions.as_indexes()) {
+        insert(index);
+    }
+    for (auto index : changes.modifications_new.as_indexes()) {
+        if (!changes.insertions.contains(index)) {
+            insert(index);
+        }
+    }
+
+    // A modified object which is still between the same unmodified objects is
+    // reported as a modification, and one which moved as a deletion followed
+    // by an insertion
+    size_t unmodifiedCount = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        size_t listIndex = entries[i].listIndex;
+        if (changes.insertions.contains(listIndex)) {
+            viewChanges.insertions.add(i);
+            continue;
+        }
+        auto it = modified.find(listIndex);
+        if (it == modified.end()) {
+            // A modified object which didn't match the predicate before
+            if (changes.modifications_new.contains(listIndex)) {
+                viewChanges.insertions.add(i);
+            }
+            else {
+                ++unmodifiedCount;
+            }
+            continue;
+        }
+        if (it->second.second == unmodifiedCount) {
+            viewChanges.modifications.add(it->second.first);
+            viewChanges.modifications_new.add(i);
+        }
+        else {
+            viewChanges.deletions.add(it->second.first);
+            viewChanges.insertions.add(i);
+        }
+        modified.erase(it);
+    }
+    // The modified objects which no longer match the predicate
+    for (auto& m : modified) {
+        viewChanges.deletions.add(m.second.first);
+    }
+
+    _entries = std::move(entries);
+    if (viewChanges.deletions.empty() && viewChanges.insertions.empty() && viewChanges.modifications.empty()) {
+        return nil;
+    }
+    return [[RLMCollectionChange alloc] initWithChanges:std::move(viewChanges)];
+}
+
+- (void)deliverChange:(RLMCollectionChange *)change error:(NSError *)error {
+    RLMCollectionChange *viewChange;
+    if (!error) {
+        if (!change) {
+            // The initial notification may include changes made since the view
+            // was computed, so it's computed again
+            [self computeEntries];
+            _receivedInitialNotification = true;
+        }
+        else if (!(viewChange = [self applyChange:change])) {
+            return;
+        }
+    }
+
+    for (RLMArrayViewNotificationToken *token in _tokens.allObjects) {
+        if (token->_suppressNext) {
+            token->_suppressNext = false;
+            continue;
+        }
+        if (auto block = token->_block) {
+            error ? block(nil, nil, error) : block(self, viewChange, nil);
+        }
+    }
+}
+
+- (RLMNotificationToken *)addNotificationBlock:(void (^)(RLMArrayView *, RLMCollectionChange *, NSError *))block {
+    RLMArrayViewNotificationToken *token = [RLMArrayViewNotificationToken new];
+    token->_view = self;
+    token->_block = block;
+
+    if (_receivedInitialNotification) {
+        // The view's notification has already delivered the initial view, so
+        // this block is sent it on its own
+        CFRunLoopRef runLoop = CFRunLoopGetCurrent();
+        CFRunLoopPerformBlock(runLoop, kCFRunLoopCommonModes, ^{
+            if (auto block = token->_block) {
+                block(token->_view, nil, nil);
+            }
+        });
+        CFRunLoopWakeUp(runLoop);
+    }
+    [_tokens addPointer:(__bridge void *)token];
+    return token;
+}
+
+- (void)removeToken:(RLMNotificationToken *)token {
+    for (NSUInteger i = 0; i < _tokens.count; ++i) {
+        if ([_tokens pointerAtIndex:i] == (__bridge void *)token) {
+            [_tokens removePointerAtIndex:i];
+            break;
+        }
+    }
+}
+
+- (void)dealloc {
+    [_token stop];
+}
+
+@end
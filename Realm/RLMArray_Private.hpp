@@ -25,10 +25,11 @@
 #import <realm/link_view_fwd.hpp>
 
 namespace realm {
+    class List;
     class Results;
 }
 
-@class RLMObjectBase, RLMObjectSchema, RLMProperty;
+@class RLMListBase, RLMObjectBase, RLMObjectSchema, RLMProperty;
 class RLMClassInfo;
 class RLMObservationInfo;
 
@@ -47,6 +48,10 @@ class RLMObservationInfo;
 //
 @interface RLMArrayLinkView : RLMArray <RLMFastEnumerable>
 - (instancetype)initWithParent:(RLMObjectBase *)parentObject property:(RLMProperty *)property;
+- (instancetype)initWithList:(realm::List)list
+                       realm:(RLMRealm *)realm
+                  parentInfo:(RLMClassInfo *)parentInfo
+                    property:(RLMProperty *)property;
 
 // deletes all objects in the RLMArray from their containing realms
 - (void)deleteObjectsFromRealm;
@@ -58,6 +63,10 @@ void RLMValidateArrayObservationKey(NSString *keyPath, RLMArray *array);
 void RLMEnsureArrayObservationInfo(std::unique_ptr<RLMObservationInfo>& info,
                                    NSString *keyPath, RLMArray *array, id observed);
 
+// Point a Swift List property of a managed object at the object's list, which
+// is read the first time the List is used
+void RLMListBaseSetParent(RLMListBase *list, RLMObjectBase *parent, RLMProperty *property);
+
 
 //
 // RLMResults private methods
@@ -66,5 +75,21 @@ void RLMEnsureArrayObservationInfo(std::unique_ptr<RLMObservationInfo>& info,
 + (instancetype)resultsWithObjectInfo:(RLMClassInfo&)info
                               results:(realm::Results)results;
 
+// The descriptors the results are sorted by, which are needed to limit them
+@property (nonatomic, copy) NSArray<RLMSortDescriptor *> *sortDescriptors;
+// The predicates, or descriptions of other conditions such as text searches,
+// the results were filtered by in order, which are needed to explain them
+@property (nonatomic, copy) NSArray *filters;
+// Whether the results are all objects of a class or filtered from them, rather
+// than derived from a list or linking objects
+@property (nonatomic) BOOL derivedFromTable;
+// A description of the class, predicates and sort descriptors which produced
+// the results, which is equal for results of the same query and is used to
+// share a notifier between them, or nil if the results can't share one
+@property (nonatomic, copy) NSString *queryIdentity;
+
 - (void)deleteObjectsFromRealm;
+// Reads every value of the objects in the results, so that the pages of the
+// file they are stored in are in memory before they are used
+- (void)touchObjects;
 @end
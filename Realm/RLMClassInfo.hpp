@@ -17,18 +17,26 @@
 ////////////////////////////////////////////////////////////////////////////
 
 #import <Foundation/Foundation.h>
+
+#import "binding_context.hpp"
+
+#import <limits>
+#import <memory>
+#import <string>
 #import <unordered_map>
 #import <vector>
 
 namespace realm {
     class ObjectSchema;
     class Schema;
+    class StringData;
     class Table;
     struct Property;
 }
 
 class RLMObservationInfo;
-@class RLMRealm, RLMSchema, RLMObjectSchema, RLMProperty;
+class RLMQueryCache;
+@class RLMRealm, RLMSchema, RLMObjectSchema, RLMProperty, RLMObjectBase;
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -46,6 +54,57 @@ template<> struct equal_to<NSString *> {
 };
 }
 
+// Interned strings for the values of a property listed in
+// +[RLMObject internedStringProperties], so that reading one of its few
+// distinct values returns an existing NSString rather than creating a new one
+class RLMStringInternTable {
+public:
+    NSString *_Nullable get(realm::StringData value);
+    void clear() { m_strings.clear(); }
+
+private:
+    // Strings stop being added once there are this many, so that a property
+    // with more distinct values than expected doesn't grow the table forever
+    static const size_t s_maxSize = 1024;
+    // Keyed by the hash of the value; values whose hash is already taken by
+    // a different value aren't interned
+    std::unordered_map<uint64_t, std::pair<std::string, NSString *>> m_strings;
+};
+
+// The rows found by looking up objects of a class by primary key, so that
+// repeatedly looking up the same keys doesn't search the table each time. Only
+// valid while the read transaction the rows were found in is current, which
+// is when RLMRealm's _readGeneration still equals `generation`; keys with no
+// object are cached as realm::not_found.
+struct RLMPrimaryKeyCache {
+    // The cache is cleared rather than grown past this many keys
+    static const size_t s_maxSize = 4096;
+
+    uint64_t generation = std::numeric_limits<uint64_t>::max();
+    std::unordered_map<int64_t, size_t> ints;
+    std::unordered_map<std::string, size_t> strings;
+    bool hasNullRow = false;
+    size_t nullRow;
+
+    size_t size() const { return ints.size() + strings.size() + hasNullRow; }
+    void clear() {
+        ints.clear();
+        strings.clear();
+        hasNullRow = false;
+    }
+};
+
+// The accessors most recently created for the rows of a table, held weakly so
+// that reading a row again returns the accessor which is still in use for it.
+// Only valid while RLMRealm's _readGeneration still equals `generation`.
+struct RLMAccessorCache {
+    // The cache is cleared rather than grown past this many rows
+    static const size_t s_maxSize = 4096;
+
+    uint64_t generation = std::numeric_limits<uint64_t>::max();
+    std::unordered_map<size_t, __weak RLMObjectBase *> accessors;
+};
+
 // The per-RLMRealm object schema information which stores the cached table
 // reference, handles table column lookups, and tracks observed objects
 class RLMClassInfo {
@@ -59,13 +118,43 @@ public:
     // Storage for the functionality in RLMObservation for handling indirect
     // changes to KVO-observed things
     std::vector<RLMObservationInfo *> observedObjects;
+    // The entries of observedObjects keyed by their row, so that the infos for
+    // a row can be found without looping over all of them. Deleting rows and
+    // advancing the read transaction can move rows, after which the index is
+    // marked as stale and rebuilt the next time it's used.
+    std::unordered_map<size_t, RLMObservationInfo *> observedRows;
+    bool observedRowsStale = false;
+    // The observed rows in the form reported to the BindingContext before
+    // advancing the read transaction, sorted by row. Kept between refreshes
+    // and only rebuilt when observedObjects changes or a row has moved, so
+    // refreshing with many observed objects doesn't rebuild and re-sort it.
+    std::vector<realm::BindingContext::ObserverState> observerStates;
+    bool observerStatesStale = true;
+
+    // Queries built by RLMPredicateToQuery() for recently used predicates.
+    // Created lazily, and discarded along with the table as they refer to it.
+    std::shared_ptr<RLMQueryCache> queryCache;
+
+    // The column indices resolved for the key paths this class has been sorted
+    // by, so that re-sorting doesn't validate and look up each key path again.
+    // Discarded along with the table.
+    std::unordered_map<NSString *, std::vector<size_t>> sortColumnIndices;
+
+    // The rows of recently looked up primary keys. Discarded along with the
+    // table, and whenever the read transaction advances.
+    RLMPrimaryKeyCache primaryKeyCache;
+
+    // The accessors returned for rows of this table while the Realm's
+    // reusesObjectAccessors is enabled. Discarded along with the table.
+    RLMAccessorCache accessorCache;
 
     // Get the table for this object type. Will return nullptr only if it's a
     // read-only Realm that is missing the table entirely.
     realm::Table *_Nullable table() const;
 
     // Get the RLMProperty for a given table column, or `nil` if it is a column
-    // not used by the current schema
+    // not used by the current schema. Uses a table from column to property
+    // index which is rebuilt whenever the table's columns have changed.
     RLMProperty *_Nullable propertyForTableColumn(NSUInteger) const noexcept;
 
     // Get the RLMProperty that's used as the primary key, or `nil` if there is
@@ -80,31 +169,115 @@ public:
     // Get the info for the target of the link at the given property index.
     RLMClassInfo &linkTargetType(size_t propertyIndex);
 
-    void releaseTable() { m_table = nullptr; }
+    // Get the default values of the object type's properties. If the class
+    // declares them static with +hasStaticDefaultPropertyValues, they are
+    // computed the first time this is called and are then cached until
+    // RLMInvalidateCachedDefaultValues() is called. Otherwise they are computed
+    // for each call, as they may be generated separately for each object.
+    NSDictionary *_Nullable defaultValues();
+
+    // Get the interned strings for the property at the given index, or nullptr
+    // if the property isn't listed in +internedStringProperties
+    RLMStringInternTable *_Nullable internedStrings(NSUInteger propertyIndex) {
+        return propertyIndex < m_internedStrings.size() ? m_internedStrings[propertyIndex].get() : nullptr;
+    }
+
+    // Recompute the values of the properties computed from `property` for the
+    // object at `row`, or of all computed properties if it is nil
+    void updateComputedProperties(size_t row, RLMProperty *_Nullable property = nil);
+
+    void releaseTable() {
+        m_table = nullptr;
+        releaseDerivedCaches();
+        m_propertyIndexByColumn.clear();
+    }
+
+    // Discard the caches which only speed up repeated operations and are
+    // rebuilt as needed
+    void releaseDerivedCaches() {
+        queryCache = nullptr;
+        sortColumnIndices.clear();
+        primaryKeyCache.clear();
+        primaryKeyCache.generation = std::numeric_limits<uint64_t>::max();
+        accessorCache.accessors.clear();
+        accessorCache.generation = std::numeric_limits<uint64_t>::max();
+    }
+
+    // Discard every cache which can be rebuilt, including the ones which
+    // remain valid for as long as the table does
+    void releaseCaches() {
+        releaseDerivedCaches();
+        observerStates.clear();
+        observerStates.shrink_to_fit();
+        observerStatesStale = true;
+        for (auto& strings : m_internedStrings) {
+            if (strings) {
+                strings->clear();
+            }
+        }
+    }
 
 private:
     mutable realm::Table *_Nullable m_table = nullptr;
     std::vector<RLMClassInfo *> m_linkTargets;
+
+    // Indexed by table column; npos for columns not used by the schema
+    mutable std::vector<size_t> m_propertyIndexByColumn;
+
+    // Indexed by property index; null for properties which aren't interned
+    std::vector<std::unique_ptr<RLMStringInternTable>> m_internedStrings;
+
+    // Only used if the class declares its default values static
+    bool m_hasStaticDefaultValues;
+    NSDictionary *_Nullable m_defaultValues;
+    uint64_t m_defaultValuesVersion = 0;
 };
 
+// Discard the static default property values cached by every RLMClassInfo, so
+// that they are recomputed the next time they are needed
+void RLMInvalidateCachedDefaultValues();
+
 // A per-RLMRealm object schema map which stores RLMClassInfo keyed on the name
+//
+// Each object class name is also given a small integer ID which is unique
+// within the process. The IDs are stored on the RLMObjectSchemas in the schema
+// and on the RLMProperties which link to them, so that lookups from either of
+// those can index an array rather than hashing the class name.
 class RLMSchemaInfo {
     using impl = std::unordered_map<NSString *, RLMClassInfo>;
 public:
     RLMSchemaInfo() = default;
     RLMSchemaInfo(RLMRealm *realm);
 
+    // The class ID index points into m_objects, so only moves are allowed
+    RLMSchemaInfo(RLMSchemaInfo&&) = default;
+    RLMSchemaInfo& operator=(RLMSchemaInfo&&) = default;
+    RLMSchemaInfo(RLMSchemaInfo const&) = delete;
+    RLMSchemaInfo& operator=(RLMSchemaInfo const&) = delete;
+
     RLMSchemaInfo clone(realm::Schema const& source_schema, RLMRealm *target_realm);
 
     // Look up by name, throwing if it's not present
     RLMClassInfo& operator[](NSString *name);
 
+    // Look up by the class ID of the object schema, falling back to its name
+    // if it has not been given the ID of a class in this schema
+    RLMClassInfo& operator[](RLMObjectSchema *objectSchema);
+
+    // Look up the class which a link, array or linking objects property refers
+    // to by its class ID, falling back to the name
+    RLMClassInfo& targetOf(RLMProperty *property);
+
     impl::iterator begin() noexcept;
     impl::iterator end() noexcept;
     impl::const_iterator begin() const noexcept;
     impl::const_iterator end() const noexcept;
 private:
     std::unordered_map<NSString *, RLMClassInfo> m_objects;
+    // Indexed by class ID; null for classes not in this schema
+    std::vector<RLMClassInfo *> m_byClassID;
+
+    void buildClassIDIndex();
 };
 
 NS_ASSUME_NONNULL_END
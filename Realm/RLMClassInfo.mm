@@ -18,9 +18,12 @@
 
 #import "RLMClassInfo.hpp"
 
+#import "RLMAccessor.h"
 #import "RLMRealm_Private.hpp"
+#import "RLMObject.h"
 #import "RLMObjectSchema_Private.h"
-#import "RLMSchema.h"
+#import "RLMObjectStore.h"
+#import "RLMSchema_Private.h"
 #import "RLMProperty_Private.h"
 #import "RLMQueryUtil.hpp"
 #import "RLMUtil.hpp"
@@ -32,11 +35,77 @@
 
 #import <realm/table.hpp>
 
+#import <algorithm>
+#import <atomic>
+#import <mutex>
+
 using namespace realm;
 
+// Version of the cached default values; bumped to invalidate all of them.
+// Starts at 1 so that a newly created RLMClassInfo has to compute them.
+static std::atomic<uint64_t> s_defaultValuesVersion{1};
+
+void RLMInvalidateCachedDefaultValues() {
+    ++s_defaultValuesVersion;
+}
+
+// Class IDs start at 1 so that 0 can mean that an RLMObjectSchema or
+// RLMProperty has not been given one
+static uint32_t classIDForName(NSString *className) {
+    static std::mutex mutex;
+    static NSMutableDictionary<NSString *, NSNumber *> *ids = [NSMutableDictionary new];
+    std::lock_guard<std::mutex> lock(mutex);
+    if (NSNumber *classID = ids[className]) {
+        return classID.unsignedIntValue;
+    }
+    uint32_t classID = (uint32_t)ids.count + 1;
+    ids[className] = @(classID);
+    return classID;
+}
+
+NSString *RLMStringInternTable::get(realm::StringData value) {
+    if (value.is_null()) {
+        return nil;
+    }
+
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < value.size(); ++i) {
+        hash = (hash ^ static_cast<unsigned char>(value[i])) * 1099511628211ULL;
+    }
+
+    auto it = m_strings.find(hash);
+    if (it != m_strings.end()) {
+        auto& interned = it->second.first;
+        if (interned.size() == value.size() && std::equal(interned.begin(), interned.end(), value.data())) {
+            return it->second.second;
+        }
+        return RLMStringDataToNSString(value);
+    }
+
+    NSString *str = RLMStringDataToNSString(value);
+    if (m_strings.size() < s_maxSize) {
+        m_strings.emplace(hash, std::make_pair(std::string(value.data(), value.size()), str));
+    }
+    return str;
+}
+
 RLMClassInfo::RLMClassInfo(RLMRealm *realm, RLMObjectSchema *rlmObjectSchema,
                              const realm::ObjectSchema *objectSchema)
-: realm(realm), rlmObjectSchema(rlmObjectSchema), objectSchema(objectSchema) { }
+: realm(realm), rlmObjectSchema(rlmObjectSchema), objectSchema(objectSchema)
+{
+    Class objectClass = rlmObjectSchema.objectClass;
+    m_hasStaticDefaultValues = [objectClass respondsToSelector:@selector(hasStaticDefaultPropertyValues)]
+                            && [objectClass hasStaticDefaultPropertyValues];
+
+    NSArray<RLMProperty *> *properties = rlmObjectSchema.properties;
+    for (NSUInteger i = 0; i < properties.count; ++i) {
+        if (properties[i].internsStrings) {
+            m_internedStrings.resize(properties.count);
+            m_internedStrings[i] = std::make_unique<RLMStringInternTable>();
+        }
+    }
+}
 
 realm::Table *RLMClassInfo::table() const {
     if (!m_table) {
@@ -47,12 +116,29 @@ realm::Table *RLMClassInfo::table() const {
 
 RLMProperty *RLMClassInfo::propertyForTableColumn(NSUInteger col) const noexcept {
     auto const& props = objectSchema->persisted_properties;
-    for (size_t i = 0; i < props.size(); ++i) {
-        if (props[i].table_column == col) {
-            return rlmObjectSchema.properties[i];
+    auto table = this->table();
+    if (!table) {
+        return nil;
+    }
+
+    // Adding or removing columns changes the column count, and columns being
+    // shifted by an insertion is caught when the entry for `col` is checked
+    size_t columnCount = table->get_column_count();
+    auto& byColumn = m_propertyIndexByColumn;
+    if (byColumn.size() != columnCount
+        || (col < columnCount && byColumn[col] != npos && props[byColumn[col]].table_column != col)) {
+        byColumn.assign(columnCount, npos);
+        for (size_t i = 0; i < props.size(); ++i) {
+            if (props[i].table_column < columnCount) {
+                byColumn[props[i].table_column] = i;
+            }
         }
     }
-    return nil;
+
+    if (col >= columnCount || byColumn[col] == npos) {
+        return nil;
+    }
+    return rlmObjectSchema.properties[byColumn[col]];
 }
 
 RLMProperty *RLMClassInfo::propertyForPrimaryKey() const noexcept {
@@ -74,10 +160,136 @@ RLMClassInfo &RLMClassInfo::linkTargetType(size_t propertyIndex) {
     if (m_linkTargets.size() <= propertyIndex) {
         m_linkTargets.resize(propertyIndex + 1);
     }
-    m_linkTargets[propertyIndex] = &realm->_info[rlmObjectSchema.properties[propertyIndex].objectClassName];
+    m_linkTargets[propertyIndex] = &realm->_info.targetOf(rlmObjectSchema.properties[propertyIndex]);
     return *m_linkTargets[propertyIndex];
 }
 
+NSDictionary *RLMClassInfo::defaultValues() {
+    if (!m_hasStaticDefaultValues) {
+        return RLMDefaultValuesForObjectSchema(rlmObjectSchema);
+    }
+    uint64_t version = s_defaultValuesVersion.load(std::memory_order_relaxed);
+    if (m_defaultValuesVersion != version) {
+        m_defaultValues = RLMDefaultValuesForObjectSchema(rlmObjectSchema);
+        m_defaultValuesVersion = version;
+    }
+    return m_defaultValues;
+}
+
+void RLMClassInfo::updateComputedProperties(size_t row, __unsafe_unretained RLMProperty *const property) {
+    Table& table = *this->table();
+    RLMObjectBase *accessor;
+    auto update = [&](RLMProperty *key) {
+        NSString *keyName = key.name;
+        if (key.derivedInputNames) {
+            // Derived values are computed by the object itself from the
+            // already-written values of its other properties
+            if (!accessor) {
+                accessor = RLMCreateObjectAccessor(realm, *this, row);
+
+                // In a migration the accessor is an RLMDynamicObject, which
+                // can't compute them, so they're computed by an unmanaged
+                // instance of the model class holding the values of all of
+                // the properties derived values are computed from instead
+                Class modelClass = [RLMSchema classForString:rlmObjectSchema.className];
+                if (modelClass && ![accessor isKindOfClass:modelClass]) {
+                    RLMObjectBase *model = [[modelClass alloc] init];
+                    for (RLMProperty *prop in rlmObjectSchema.properties) {
+                        for (NSString *name in prop.derivedInputNames) {
+                            [model setValue:RLMDynamicGetByName(accessor, name, false) forKey:name];
+                        }
+                    }
+                    accessor = model;
+                }
+            }
+            id value = [(RLMObject *)accessor valueForDerivedProperty:keyName];
+            if (value == NSNull.null) {
+                value = nil;
+            }
+            if (!RLMIsObjectValidForProperty(value, key)) {
+                @throw RLMException(@"Invalid value '%@' computed for the derived property '%@' of class '%@'.",
+                                    value, keyName, rlmObjectSchema.className);
+            }
+            size_t col = tableColumn(key);
+            if (!value) {
+                table.set_null(col, row);
+                return;
+            }
+            switch (key.type) {
+                case RLMPropertyTypeInt:    table.set_int(col, row, [value longLongValue]); break;
+                case RLMPropertyTypeBool:   table.set_bool(col, row, [value boolValue]); break;
+                case RLMPropertyTypeFloat:  table.set_float(col, row, [value floatValue]); break;
+                case RLMPropertyTypeDouble: table.set_double(col, row, [value doubleValue]); break;
+                case RLMPropertyTypeString: table.set_string(col, row, RLMStringDataWithNSString(value)); break;
+                case RLMPropertyTypeDate:   table.set_timestamp(col, row, RLMTimestampForNSDate(value)); break;
+                default: REALM_UNREACHABLE();
+            }
+            return;
+        }
+        if (NSArray<NSString *> *coordinateNames = key.geoIndexCoordinateNames) {
+            auto coordinate = [&](NSString *name) {
+                size_t col = tableColumn(rlmObjectSchema[name]);
+                return table.is_null(col, row) ? util::Optional<double>() : util::Optional<double>(table.get_double(col, row));
+            };
+            auto cell = RLMGeoIndexKey(coordinate(coordinateNames[0]), coordinate(coordinateNames[1]));
+            if (cell) {
+                table.set_int(tableColumn(key), row, *cell);
+            }
+            else {
+                table.set_null(tableColumn(key), row);
+            }
+            return;
+        }
+        if (NSString *sourceName = key.collationSourceName) {
+            size_t col = tableColumn(rlmObjectSchema[sourceName]);
+            NSLocale *locale = key.collationLocaleIdentifier ? [NSLocale localeWithLocaleIdentifier:key.collationLocaleIdentifier] : nil;
+            NSString *collationKey = RLMCollationKey(RLMStringDataToNSString(table.get_string(col, row)), locale);
+            table.set_string(tableColumn(key), row, RLMStringDataWithNSString(collationKey));
+            return;
+        }
+        NSMutableArray *components = [NSMutableArray arrayWithCapacity:key.compoundIndexComponents.count];
+        NSMutableArray *values = [NSMutableArray arrayWithCapacity:key.compoundIndexComponents.count];
+        for (NSString *componentName in key.compoundIndexComponents) {
+            RLMProperty *component = rlmObjectSchema[componentName];
+            size_t col = tableColumn(component);
+            id value = NSNull.null;
+            if (!table.is_null(col, row)) {
+                switch (component.type) {
+                    case RLMPropertyTypeInt:    value = @(table.get_int(col, row)); break;
+                    case RLMPropertyTypeBool:   value = @(table.get_bool(col, row)); break;
+                    case RLMPropertyTypeString: value = RLMStringDataToNSString(table.get_string(col, row)); break;
+                    case RLMPropertyTypeDate:   value = RLMTimestampToNSDate(table.get_timestamp(col, row)); break;
+                    default: REALM_UNREACHABLE();
+                }
+            }
+            [components addObject:component];
+            [values addObject:value];
+        }
+        table.set_string(tableColumn(key), row, RLMStringDataWithNSString(RLMCompoundIndexKey(components, values)));
+    };
+
+    if (!property) {
+        for (RLMProperty *prop in rlmObjectSchema.properties) {
+            if (prop.isComputed) {
+                update(prop);
+            }
+        }
+        return;
+    }
+    for (NSString *keyName in property.compoundIndexKeyNames) {
+        update(rlmObjectSchema[keyName]);
+    }
+    for (NSString *keyName in property.geoIndexKeyNames) {
+        update(rlmObjectSchema[keyName]);
+    }
+    if (NSString *keyName = property.collationKeyName) {
+        update(rlmObjectSchema[keyName]);
+    }
+    for (NSString *derivedName in property.derivedPropertyNames) {
+        update(rlmObjectSchema[derivedName]);
+    }
+}
+
 RLMSchemaInfo::impl::iterator RLMSchemaInfo::begin() noexcept { return m_objects.begin(); }
 RLMSchemaInfo::impl::iterator RLMSchemaInfo::end() noexcept { return m_objects.end(); }
 RLMSchemaInfo::impl::const_iterator RLMSchemaInfo::begin() const noexcept { return m_objects.begin(); }
@@ -94,6 +306,44 @@ RLMClassInfo& RLMSchemaInfo::operator[](NSString *name) {
     return *&it->second;
 }
 
+RLMClassInfo& RLMSchemaInfo::operator[](__unsafe_unretained RLMObjectSchema *const objectSchema) {
+    uint32_t classID = objectSchema.classID;
+    if (classID < m_byClassID.size() && m_byClassID[classID]) {
+        return *m_byClassID[classID];
+    }
+    return (*this)[objectSchema.className];
+}
+
+RLMClassInfo& RLMSchemaInfo::targetOf(__unsafe_unretained RLMProperty *const property) {
+    uint32_t classID = property.objectClassID;
+    if (classID < m_byClassID.size() && m_byClassID[classID]) {
+        return *m_byClassID[classID];
+    }
+    return (*this)[property.objectClassName];
+}
+
+void RLMSchemaInfo::buildClassIDIndex() {
+    m_byClassID.clear();
+    for (auto& pair : m_objects) {
+        RLMObjectSchema *objectSchema = pair.second.rlmObjectSchema;
+        objectSchema.classID = classIDForName(pair.first);
+        if (m_byClassID.size() <= objectSchema.classID) {
+            m_byClassID.resize(objectSchema.classID + 1);
+        }
+        m_byClassID[objectSchema.classID] = &pair.second;
+
+        auto assignTargetID = [](RLMProperty *prop) {
+            prop.objectClassID = prop.objectClassName ? classIDForName(prop.objectClassName) : 0;
+        };
+        for (RLMProperty *prop in objectSchema.properties) {
+            assignTargetID(prop);
+        }
+        for (RLMProperty *prop in objectSchema.computedProperties) {
+            assignTargetID(prop);
+        }
+    }
+}
+
 RLMSchemaInfo::RLMSchemaInfo(RLMRealm *realm) {
     RLMSchema *rlmSchema = realm.schema;
     realm::Schema const& schema = realm->_realm->schema();
@@ -106,6 +356,7 @@ RLMSchemaInfo::RLMSchemaInfo(RLMRealm *realm) {
                           std::forward_as_tuple(realm, rlmObjectSchema,
                                                 &*schema.find(rlmObjectSchema.objectName.UTF8String)));
     }
+    buildClassIDIndex();
 }
 
 RLMSchemaInfo RLMSchemaInfo::clone(realm::Schema const& source_schema,
@@ -121,5 +372,6 @@ RLMSchemaInfo RLMSchemaInfo::clone(realm::Schema const& source_schema,
                                std::forward_as_tuple(target_realm, pair.second.rlmObjectSchema,
                                                      &*schema.begin() + idx));
     }
+    info.buildClassIDIndex();
     return info;
 }
@@ -357,6 +357,42 @@ NS_ASSUME_NONNULL_BEGIN
 
 @end
 
+/**
+ An `RLMPropertyStatistics` object holds the count, minimum, maximum, sum,
+ average and variance of the values of a numeric property, which are all
+ computed in a single pass over a collection by `statisticsForProperty:`.
+
+ Objects whose value for the property is `nil` are not included in any of the
+ statistics.
+ */
+@interface RLMPropertyStatistics : NSObject
+
+/// The number of objects with a value for the property.
+@property (nonatomic, readonly) NSUInteger count;
+
+/// The minimum value of the property, or `nil` if there are no values.
+@property (nonatomic, readonly, nullable) NSNumber *minimum;
+
+/// The maximum value of the property, or `nil` if there are no values.
+@property (nonatomic, readonly, nullable) NSNumber *maximum;
+
+/// The sum of the values of the property, which is zero if there are no values.
+@property (nonatomic, readonly) NSNumber *sum;
+
+/// The average value of the property, or `nil` if there are no values.
+@property (nonatomic, readonly, nullable) NSNumber *average;
+
+/// The population variance of the values of the property, or `nil` if there are no values.
+@property (nonatomic, readonly, nullable) NSNumber *variance;
+
+/// :nodoc:
+- (instancetype)init __attribute__((unavailable("RLMPropertyStatistics cannot be created directly")));
+
+/// :nodoc:
++ (instancetype)new __attribute__((unavailable("RLMPropertyStatistics cannot be created directly")));
+
+@end
+
 /**
  A `RLMCollectionChange` object encapsulates information about changes to collections
  that are reported by Realm notifications.
@@ -406,6 +442,44 @@ NS_ASSUME_NONNULL_BEGIN
 
 /// Returns the index paths of the modification indices in the given section.
 - (NSArray<NSIndexPath *> *)modificationsInSection:(NSUInteger)section;
+
+/**
+ The deletion indices as an index set.
+
+ The index sets and the range enumeration methods below are built from the
+ ranges of indices which changed, rather than creating an object for each
+ changed index, and so are much cheaper than the arrays for large changes.
+ */
+@property (nonatomic, readonly) NSIndexSet *deletionIndexes;
+
+/// The insertion indices as an index set.
+@property (nonatomic, readonly) NSIndexSet *insertionIndexes;
+
+/// The modification indices as an index set.
+@property (nonatomic, readonly) NSIndexSet *modificationIndexes;
+
+/// Calls the block with each range of contiguous deletion indices in ascending
+/// order. Setting `stop` to `YES` stops the enumeration.
+- (void)enumerateDeletionRangesUsingBlock:(void (NS_NOESCAPE ^)(NSRange range, BOOL *stop))block;
+
+/// Calls the block with each range of contiguous insertion indices in ascending
+/// order. Setting `stop` to `YES` stops the enumeration.
+- (void)enumerateInsertionRangesUsingBlock:(void (NS_NOESCAPE ^)(NSRange range, BOOL *stop))block;
+
+/// Calls the block with each range of contiguous modification indices in
+/// ascending order. Setting `stop` to `YES` stops the enumeration.
+- (void)enumerateModificationRangesUsingBlock:(void (NS_NOESCAPE ^)(NSRange range, BOOL *stop))block;
+
+/**
+ Calls the block with the old and new index of each object which was moved
+ within the collection, such as by `-[RLMArray sortUsingDescriptors:]`.
+
+ Moved objects are also reported as a deletion of the old index and an
+ insertion of the new index, so this only needs to be used by code which can
+ animate moves, such as with `-[UITableView moveRowAtIndexPath:toIndexPath:]`.
+ Setting `stop` to `YES` stops the enumeration.
+ */
+- (void)enumerateMovesUsingBlock:(void (NS_NOESCAPE ^)(NSUInteger from, NSUInteger to, BOOL *stop))block;
 @end
 
 NS_ASSUME_NONNULL_END
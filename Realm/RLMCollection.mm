@@ -18,17 +18,32 @@
 
 #import "RLMCollection_Private.hpp"
 
+#import "RLMAccessor.h"
 #import "RLMArray_Private.h"
 #import "RLMObjectSchema_Private.hpp"
 #import "RLMObjectStore.h"
 #import "RLMObject_Private.hpp"
+#import "RLMObservation.hpp"
 #import "RLMProperty_Private.h"
+#import "RLMRealmConfiguration_Private.hpp"
+#import "RLMRealmUtil.hpp"
+#import "RLMRealm_Private.hpp"
+#import "RLMSchema.h"
+#import "RLMThreadSafeReference.h"
+#import "RLMUtil.hpp"
 
 #import "collection_notifications.hpp"
+#import "impl/collection_change_builder.hpp"
 #import "list.hpp"
 #import "results.hpp"
+#import "shared_realm.hpp"
 
+#import <realm/group_shared.hpp>
 #import <realm/table_view.hpp>
+#import <algorithm>
+#import <atomic>
+#import <cmath>
+#import <unordered_map>
 
 static const int RLMEnumerationBufferSize = 16;
 
@@ -48,13 +63,29 @@ static const int RLMEnumerationBufferSize = 16;
     // instead so that mutating the collection during enumeration works.
     id<RLMFastEnumerable> _collection;
     realm::TableView _tableView;
+
+    bool _reuseAccessor;
+    RLMObject *_reusedAccessor;
+
+    // The to-one links along each key path to prefetch for every batch
+    NSArray<NSArray<RLMProperty *> *> *_includedLinks;
+
+    // Set once every object in the collection has been handed out, at which
+    // point there's nothing left which would need to be read from a snapshot
+    bool _exhausted;
 }
 
 - (instancetype)initWithCollection:(id<RLMFastEnumerable>)collection objectSchema:(RLMClassInfo&)info {
+    return [self initWithCollection:collection objectSchema:info reusingAccessor:false];
+}
+
+- (instancetype)initWithCollection:(id<RLMFastEnumerable>)collection objectSchema:(RLMClassInfo&)info
+                   reusingAccessor:(bool)reuseAccessor {
     self = [super init];
     if (self) {
         _realm = collection.realm;
         _info = &info;
+        _reuseAccessor = reuseAccessor;
 
         if (_realm.inWriteTransaction) {
             _tableView = [collection tableView];
@@ -67,14 +98,66 @@ static const int RLMEnumerationBufferSize = 16;
     return self;
 }
 
+- (instancetype)initWithCollection:(id<RLMFastEnumerable>)collection objectSchema:(RLMClassInfo&)info
+                     includedLinks:(NSArray<NSArray<RLMProperty *> *> *)includedLinks {
+    self = [self initWithCollection:collection objectSchema:info reusingAccessor:false];
+    if (self) {
+        _includedLinks = includedLinks;
+    }
+    return self;
+}
+
 - (void)dealloc {
     if (_collection) {
         [_realm unregisterEnumerator:self];
     }
 }
 
+// Resolve the links along each included key path for a whole batch at once,
+// one link property at a time, and store the targets in the link caches of
+// the objects they're linked from. Objects which link to the same row share a
+// single accessor for it.
+- (void)prefetchLinksForBatch:(NSUInteger)batchCount {
+    for (NSArray<RLMProperty *> *links in _includedLinks) {
+        std::vector<RLMObjectBase *> objects(_strongBuffer, _strongBuffer + batchCount);
+        for (RLMProperty *link in links) {
+            std::unordered_map<size_t, RLMObjectBase *> targets;
+            std::vector<RLMObjectBase *> next;
+            for (RLMObjectBase *obj : objects) {
+                if (!obj->_row.is_attached()) {
+                    continue;
+                }
+                size_t col = obj->_info->tableColumn(link);
+                if (obj->_row.is_null_link(col)) {
+                    continue;
+                }
+                size_t index = obj->_row.get_link(col);
+                RLMObjectBase *&target = targets[index];
+                if (!target) {
+                    target = RLMCreateObjectAccessor(_realm, obj->_info->linkTargetType(link.index), index);
+                    next.push_back(target);
+                }
+                auto& cache = obj->_linkCache;
+                if (!cache) {
+                    cache = std::make_unique<std::vector<RLMObjectBase *>>();
+                }
+                if (link.index >= cache->size()) {
+                    cache->resize(obj->_info->objectSchema->persisted_properties.size());
+                }
+                (*cache)[link.index] = target;
+            }
+            objects = std::move(next);
+        }
+    }
+}
+
 - (void)detach {
-    _tableView = [_collection tableView];
+    // Enumerators whose loop has already reached the end (but which haven't
+    // been asked for the final empty batch yet) don't need a snapshot, and
+    // copying the collection's rows for them would be wasted work
+    if (!_exhausted) {
+        _tableView = [_collection tableView];
+    }
     _collection = nil;
 }
 
@@ -82,6 +165,14 @@ static const int RLMEnumerationBufferSize = 16;
                                     count:(NSUInteger)len {
     [_realm verifyThread];
     if (!_tableView.is_attached() && !_collection) {
+        // Detached after the last object was handed out
+        if (_exhausted) {
+            for (auto& obj : _strongBuffer) {
+                obj = nil;
+            }
+            _reusedAccessor = nil;
+            return 0;
+        }
         @throw RLMException(@"Collection is no longer valid");
     }
     // The fast enumeration buffer size is currently a hardcoded number in the
@@ -90,12 +181,33 @@ static const int RLMEnumerationBufferSize = 16;
     if (len > RLMEnumerationBufferSize) {
         len = RLMEnumerationBufferSize;
     }
+    // Every object in a batch would be the same accessor, so only one object
+    // can be produced at a time when reusing it
+    if (_reuseAccessor) {
+        len = 1;
+    }
 
     NSUInteger batchCount = 0, count = state->extra[1];
 
     Class accessorClass = _info->rlmObjectSchema.accessorClass;
+    bool reusesObjectAccessors = !_reuseAccessor && _realm.reusesObjectAccessors;
     for (NSUInteger index = state->state; index < count && batchCount < len; ++index) {
-        RLMObject *accessor = RLMCreateManagedAccessor(accessorClass, _realm, _info);
+        if (reusesObjectAccessors && (_collection || _tableView.is_row_attached(index))) {
+            size_t row = _collection ? [_collection indexInSource:index] : _tableView.get_source_ndx(index);
+            _strongBuffer[batchCount++] = RLMCreateObjectAccessor(_realm, *_info, row);
+            continue;
+        }
+        RLMObject *accessor;
+        if (_reuseAccessor) {
+            if (!_reusedAccessor) {
+                _reusedAccessor = RLMCreateManagedAccessor(accessorClass, _realm, _info);
+            }
+            accessor = _reusedAccessor;
+            accessor->_row = realm::Row();
+        }
+        else {
+            accessor = RLMCreateManagedAccessor(accessorClass, _realm, _info);
+        }
         if (_collection) {
             accessor->_row = (*_info->table())[[_collection indexInSource:index]];
         }
@@ -110,11 +222,16 @@ static const int RLMEnumerationBufferSize = 16;
     for (NSUInteger i = batchCount; i < len; ++i) {
         _strongBuffer[i] = nil;
     }
+    if (_includedLinks && batchCount) {
+        [self prefetchLinksForBatch:batchCount];
+    }
+    _exhausted = state->state + batchCount >= count;
 
     if (batchCount == 0) {
         // Release our data if we're done, as we're autoreleased and so may
         // stick around for a while
         _collection = nil;
+        _reusedAccessor = nil;
         if (_tableView.is_attached()) {
             _tableView = {};
         }
@@ -131,6 +248,135 @@ static const int RLMEnumerationBufferSize = 16;
 }
 @end
 
+@implementation RLMReusingAccessorEnumerable {
+    id<RLMFastEnumerable> _collection;
+}
+
+- (instancetype)initWithCollection:(id<RLMFastEnumerable>)collection {
+    self = [super init];
+    if (self) {
+        _collection = collection;
+    }
+    return self;
+}
+
+- (NSUInteger)countByEnumeratingWithState:(NSFastEnumerationState *)state
+                                  objects:(__unused __unsafe_unretained id [])buffer
+                                    count:(NSUInteger)len {
+    RLMClassInfo *info = _collection.objectInfo;
+    if (!info) {
+        return 0;
+    }
+
+    __autoreleasing RLMFastEnumerator *enumerator;
+    if (state->state == 0) {
+        enumerator = [[RLMFastEnumerator alloc] initWithCollection:_collection objectSchema:*info
+                                                   reusingAccessor:true];
+        state->extra[0] = (long)enumerator;
+        state->extra[1] = _collection.count;
+    }
+    else {
+        enumerator = (__bridge id)(void *)state->extra[0];
+    }
+
+    return [enumerator countByEnumeratingWithState:state count:len];
+}
+@end
+
+@implementation RLMIncludingKeyPathsEnumerable {
+    id<RLMFastEnumerable> _collection;
+    NSArray<NSArray<RLMProperty *> *> *_includedLinks;
+}
+
+- (instancetype)initWithCollection:(id<RLMFastEnumerable>)collection keyPaths:(NSArray<NSString *> *)keyPaths {
+    self = [super init];
+    if (self) {
+        _collection = collection;
+
+        // Validate the key paths up front rather than when enumeration starts
+        NSMutableArray *includedLinks = [NSMutableArray arrayWithCapacity:keyPaths.count];
+        RLMClassInfo *info = collection.objectInfo;
+        for (NSString *keyPath in info ? keyPaths : nil) {
+            NSMutableArray *links = [NSMutableArray new];
+            RLMObjectSchema *objectSchema = info->rlmObjectSchema;
+            for (NSString *name in [keyPath componentsSeparatedByString:@"."]) {
+                RLMProperty *prop = objectSchema[name];
+                if (prop.type != RLMPropertyTypeObject) {
+                    @throw RLMException(@"Invalid key path '%@' to include: '%@' is not a to-one relationship of '%@'.",
+                                        keyPath, name, objectSchema.className);
+                }
+                [links addObject:prop];
+                objectSchema = collection.realm.schema[prop.objectClassName];
+            }
+            [includedLinks addObject:links];
+        }
+        _includedLinks = includedLinks;
+    }
+    return self;
+}
+
+- (NSUInteger)countByEnumeratingWithState:(NSFastEnumerationState *)state
+                                  objects:(__unused __unsafe_unretained id [])buffer
+                                    count:(NSUInteger)len {
+    RLMClassInfo *info = _collection.objectInfo;
+    if (!info) {
+        return 0;
+    }
+
+    __autoreleasing RLMFastEnumerator *enumerator;
+    if (state->state == 0) {
+        enumerator = [[RLMFastEnumerator alloc] initWithCollection:_collection objectSchema:*info
+                                                     includedLinks:_includedLinks];
+        state->extra[0] = (long)enumerator;
+        state->extra[1] = _collection.count;
+    }
+    else {
+        enumerator = (__bridge id)(void *)state->extra[0];
+    }
+
+    return [enumerator countByEnumeratingWithState:state count:len];
+}
+@end
+
+
+static bool RLMPropertyIsStoredInColumn(RLMPropertyType type) {
+    switch (type) {
+        case RLMPropertyTypeInt:
+        case RLMPropertyTypeBool:
+        case RLMPropertyTypeFloat:
+        case RLMPropertyTypeDouble:
+        case RLMPropertyTypeString:
+        case RLMPropertyTypeData:
+        case RLMPropertyTypeDate:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Read the value of a property stored directly in a column, boxed the same way
+// as the property's getter would, so that reading one property of every object
+// in a collection doesn't need an accessor
+static id RLMColumnValue(realm::Table& table, RLMPropertyType type, size_t column, size_t row,
+                         RLMStringInternTable *interned) {
+    if (table.is_null(column, row)) {
+        return nil;
+    }
+    switch (type) {
+        case RLMPropertyTypeInt:    return @(table.get_int(column, row));
+        case RLMPropertyTypeBool:   return @(table.get_bool(column, row));
+        case RLMPropertyTypeFloat:  return @(table.get_float(column, row));
+        case RLMPropertyTypeDouble: return @(table.get_double(column, row));
+        case RLMPropertyTypeData:   return RLMBinaryDataToNSData(table.get_binary(column, row));
+        case RLMPropertyTypeDate:   return RLMTimestampToNSDate(table.get_timestamp(column, row));
+        case RLMPropertyTypeString: {
+            auto str = table.get_string(column, row);
+            return interned ? interned->get(str) : RLMStringDataToNSString(str);
+        }
+        default:
+            REALM_UNREACHABLE();
+    }
+}
 
 NSArray *RLMCollectionValueForKey(id<RLMFastEnumerable> collection, NSString *key) {
     size_t count = collection.count;
@@ -161,8 +407,19 @@ NSArray *RLMCollectionValueForKey(id<RLMFastEnumerable> collection, NSString *ke
         }
     }
 
-    RLMObject *accessor = RLMCreateManagedAccessor(info->rlmObjectSchema.accessorClass, realm, info);
     realm::Table *table = info->table();
+    RLMProperty *prop = info->rlmObjectSchema[key];
+    if (prop && !prop.swiftIvar && RLMPropertyIsStoredInColumn(prop.type)) {
+        size_t column = info->tableColumn(prop);
+        auto interned = prop.type == RLMPropertyTypeString ? info->internedStrings(prop.index) : nullptr;
+        for (size_t i = 0; i < count; i++) {
+            size_t rowIndex = [collection indexInSource:i];
+            [results addObject:RLMColumnValue(*table, prop.type, column, rowIndex, interned) ?: NSNull.null];
+        }
+        return results;
+    }
+
+    RLMObject *accessor = RLMCreateManagedAccessor(info->rlmObjectSchema.accessorClass, realm, info);
     for (size_t i = 0; i < count; i++) {
         size_t rowIndex = [collection indexInSource:i];
         accessor->_row = (*table)[rowIndex];
@@ -173,6 +430,173 @@ NSArray *RLMCollectionValueForKey(id<RLMFastEnumerable> collection, NSString *ke
     return results;
 }
 
+template<typename Function>
+static void setForEachRow(realm::TableView& tv, Function&& f) {
+    for (size_t i = 0; i < tv.size(); ++i) {
+        if (tv.is_row_attached(i)) {
+            f(tv.get_source_ndx(i));
+        }
+    }
+}
+
+// Send the KVO notifications for all of the observed objects in a view
+// together around the writes to it rather than looking up each row's observers
+static std::vector<RLMObservationInfo *> observedObjectsInView(RLMClassInfo& info, realm::TableView& tv) {
+    std::vector<RLMObservationInfo *> observed;
+    if (!info.observedObjects.empty()) {
+        std::vector<bool> inView(info.table()->size());
+        setForEachRow(tv, [&](size_t row) { inView[row] = true; });
+        for (auto observationInfo : info.observedObjects) {
+            auto& row = observationInfo->getRow();
+            if (row.is_attached() && inView[row.get_index()]) {
+                observed.push_back(observationInfo);
+            }
+        }
+    }
+    return observed;
+}
+
+// Set a non-link property to the same value on every row in the TableView by
+// converting the value once and writing directly to the column. Returns false
+// without modifying anything if the value can't be set this way, in which case
+// it has to be set via each object's accessor.
+static bool bulkSetValue(RLMClassInfo& info, realm::TableView& tv, RLMProperty *prop, id value) {
+    if (!prop || prop.isPrimary || prop.isFolded || prop.foldedPropertyName
+        || prop.isComputed || prop.hasComputedProperties
+        || !RLMIsObjectValidForProperty(value, prop)) {
+        return false;
+    }
+    switch (prop.type) {
+        case RLMPropertyTypeInt:
+        case RLMPropertyTypeBool:
+        case RLMPropertyTypeFloat:
+        case RLMPropertyTypeDouble:
+        case RLMPropertyTypeString:
+        case RLMPropertyTypeDate:
+        case RLMPropertyTypeData:
+            break;
+        default:
+            return false;
+    }
+
+    realm::Table& table = *info.table();
+    size_t col = info.tableColumn(prop);
+
+    auto observed = observedObjectsInView(info, tv);
+    NSString *name = prop.name;
+    for (auto observationInfo : observed) {
+        observationInfo->willChange(name);
+    }
+
+    try {
+        if (!value || value == NSNull.null) {
+            setForEachRow(tv, [&](size_t row) { table.set_null(col, row); });
+        }
+        else {
+            switch (prop.type) {
+                case RLMPropertyTypeInt: {
+                    int64_t v = [value longLongValue];
+                    setForEachRow(tv, [&](size_t row) { table.set_int(col, row, v); });
+                    break;
+                }
+                case RLMPropertyTypeBool: {
+                    bool v = [value boolValue];
+                    setForEachRow(tv, [&](size_t row) { table.set_bool(col, row, v); });
+                    break;
+                }
+                case RLMPropertyTypeFloat: {
+                    float v = [value floatValue];
+                    setForEachRow(tv, [&](size_t row) { table.set_float(col, row, v); });
+                    break;
+                }
+                case RLMPropertyTypeDouble: {
+                    double v = [value doubleValue];
+                    setForEachRow(tv, [&](size_t row) { table.set_double(col, row, v); });
+                    break;
+                }
+                case RLMPropertyTypeString: {
+                    auto v = RLMStringDataWithNSString(value);
+                    setForEachRow(tv, [&](size_t row) { table.set_string(col, row, v); });
+                    break;
+                }
+                case RLMPropertyTypeDate: {
+                    auto v = RLMTimestampForNSDate(value);
+                    setForEachRow(tv, [&](size_t row) { table.set_timestamp(col, row, v); });
+                    break;
+                }
+                case RLMPropertyTypeData: {
+                    auto v = RLMBinaryDataForNSData(value);
+                    setForEachRow(tv, [&](size_t row) { table.set_binary(col, row, v); });
+                    break;
+                }
+                default:
+                    REALM_UNREACHABLE();
+            }
+        }
+    }
+    catch (std::exception const& e) {
+        @throw RLMException(e);
+    }
+
+    for (auto observationInfo : observed) {
+        observationInfo->didChange(name);
+    }
+    return true;
+}
+
+void RLMCollectionEnumerateValues(id<RLMFastEnumerable> collection, NSArray<NSString *> *propertyNames,
+                                  void (^block)(NSArray *values, NSUInteger index, BOOL *stop)) {
+    RLMRealm *realm = collection.realm;
+    RLMClassInfo *info = collection.objectInfo;
+    RLMObjectSchema *objectSchema = info->rlmObjectSchema;
+
+    // Resolve the properties once; those stored in a column are read straight
+    // from the table and the rest through an accessor for the row
+    struct Column {
+        RLMProperty *property;
+        size_t column;
+        RLMStringInternTable *interned;
+    };
+    std::vector<Column> columns;
+    columns.reserve(propertyNames.count);
+    bool needsAccessor = false;
+    for (NSString *name in propertyNames) {
+        RLMProperty *prop = objectSchema[name];
+        if (!prop) {
+            @throw RLMException(@"Invalid property name '%@' for class '%@'.", name, objectSchema.className);
+        }
+        if (!prop.swiftIvar && RLMPropertyIsStoredInColumn(prop.type)) {
+            auto interned = prop.type == RLMPropertyTypeString ? info->internedStrings(prop.index) : nullptr;
+            columns.push_back({prop, info->tableColumn(prop), interned});
+        }
+        else {
+            columns.push_back({prop, realm::npos, nullptr});
+            needsAccessor = true;
+        }
+    }
+
+    realm::TableView tv = [collection tableView];
+    realm::Table& table = *info->table();
+    BOOL stop = NO;
+    for (size_t i = 0, count = tv.size(); i < count && !stop; ++i) {
+        if (!tv.is_row_attached(i)) {
+            continue;
+        }
+        @autoreleasepool {
+            size_t row = tv.get_source_ndx(i);
+            RLMObjectBase *accessor = needsAccessor ? RLMCreateObjectAccessor(realm, *info, row) : nil;
+            NSMutableArray *values = [NSMutableArray arrayWithCapacity:columns.size()];
+            for (auto& column : columns) {
+                id value = column.column == realm::npos
+                         ? [accessor valueForKey:column.property.name]
+                         : RLMColumnValue(table, column.property.type, column.column, row, column.interned);
+                [values addObject:value ?: NSNull.null];
+            }
+            block(values, i, &stop);
+        }
+    }
+}
+
 void RLMCollectionSetValueForKey(id<RLMFastEnumerable> collection, NSString *key, id value) {
     realm::TableView tv = [collection tableView];
     if (tv.size() == 0) {
@@ -181,6 +605,13 @@ void RLMCollectionSetValueForKey(id<RLMFastEnumerable> collection, NSString *key
 
     RLMRealm *realm = collection.realm;
     RLMClassInfo *info = collection.objectInfo;
+    if (!realm.inWriteTransaction) {
+        @throw RLMException(@"Attempting to modify object outside of a write transaction - call beginWriteTransaction on an RLMRealm instance first.");
+    }
+    if (bulkSetValue(*info, tv, info->rlmObjectSchema[key], value)) {
+        return;
+    }
+
     RLMObject *accessor = RLMCreateManagedAccessor(info->rlmObjectSchema.accessorClass, realm, info);
     for (size_t i = 0; i < tv.size(); i++) {
         accessor->_row = tv[i];
@@ -189,6 +620,44 @@ void RLMCollectionSetValueForKey(id<RLMFastEnumerable> collection, NSString *key
     }
 }
 
+void RLMCollectionIncrementProperty(id<RLMFastEnumerable> collection, NSString *key, int64_t amount) {
+    RLMClassInfo *info = collection.objectInfo;
+    RLMProperty *prop = RLMValidatedIncrementedProperty(info->rlmObjectSchema, key);
+    realm::TableView tv = [collection tableView];
+    if (tv.size() == 0) {
+        return;
+    }
+    if (!collection.realm.inWriteTransaction) {
+        @throw RLMException(@"Attempting to modify object outside of a write transaction - call beginWriteTransaction on an RLMRealm instance first.");
+    }
+
+    realm::Table& table = *info->table();
+    size_t col = info->tableColumn(prop);
+    auto observed = observedObjectsInView(*info, tv);
+    NSString *name = prop.name;
+    for (auto observationInfo : observed) {
+        observationInfo->willChange(name);
+    }
+    try {
+        // Null values are left null rather than every increment failing
+        setForEachRow(tv, [&](size_t row) {
+            if (table.is_null(col, row)) {
+                return;
+            }
+            table.add_int(col, row, amount);
+            if (prop.hasComputedProperties) {
+                info->updateComputedProperties(row, prop);
+            }
+        });
+    }
+    catch (std::exception const& e) {
+        @throw RLMException(e);
+    }
+    for (auto observationInfo : observed) {
+        observationInfo->didChange(name);
+    }
+}
+
 NSString *RLMDescriptionWithMaxDepth(NSString *name,
                                      id<RLMCollection> collection,
                                      NSUInteger depth) {
@@ -229,9 +698,485 @@ NSString *RLMDescriptionWithMaxDepth(NSString *name,
     return str;
 }
 
+@implementation RLMPropertyStatistics
+- (instancetype)initWithCount:(NSUInteger)count minimum:(NSNumber *)minimum maximum:(NSNumber *)maximum
+                          sum:(NSNumber *)sum average:(NSNumber *)average variance:(NSNumber *)variance {
+    self = [super init];
+    if (self) {
+        _count = count;
+        _minimum = minimum;
+        _maximum = maximum;
+        _sum = sum;
+        _average = average;
+        _variance = variance;
+    }
+    return self;
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"RLMPropertyStatistics {count = %zu, minimum = %@, maximum = %@, sum = %@, average = %@, variance = %@}",
+            (size_t)_count, _minimum, _maximum, _sum, _average, _variance];
+}
+@end
+
+void RLMStatisticsAccumulator::addToVariance(double value) {
+    double delta = value - m_mean;
+    m_mean += delta / m_count;
+    m_squaredDifferences += delta * (value - m_mean);
+}
+
+void RLMStatisticsAccumulator::add(int64_t value) {
+    if (m_count++ == 0) {
+        m_intMin = m_intMax = value;
+    }
+    else {
+        m_intMin = std::min(m_intMin, value);
+        m_intMax = std::max(m_intMax, value);
+    }
+    m_intSum += value;
+    addToVariance(value);
+}
+
+void RLMStatisticsAccumulator::add(double value) {
+    if (m_count++ == 0) {
+        m_min = m_max = value;
+    }
+    else {
+        m_min = std::min(m_min, value);
+        m_max = std::max(m_max, value);
+    }
+    m_sum += value;
+    addToVariance(value);
+}
+
+RLMPropertyStatistics *RLMStatisticsAccumulator::statistics() const {
+    bool isInt = m_type == RLMPropertyTypeInt;
+    NSNumber *sum = isInt ? @(m_intSum) : @(m_sum);
+    if (m_count == 0) {
+        return [[RLMPropertyStatistics alloc] initWithCount:0 minimum:nil maximum:nil
+                                                        sum:sum average:nil variance:nil];
+    }
+
+    NSNumber *min, *max;
+    switch (m_type) {
+        case RLMPropertyTypeInt:
+            min = @(m_intMin);
+            max = @(m_intMax);
+            break;
+        case RLMPropertyTypeFloat:
+            min = @((float)m_min);
+            max = @((float)m_max);
+            break;
+        default:
+            min = @(m_min);
+            max = @(m_max);
+            break;
+    }
+    double average = (isInt ? (double)m_intSum : m_sum) / m_count;
+    return [[RLMPropertyStatistics alloc] initWithCount:m_count minimum:min maximum:max sum:sum
+                                                average:@(average) variance:@(m_squaredDifferences / m_count)];
+}
+
+template<typename Getter>
+static void accumulateColumn(realm::TableView const& tv, size_t column, RLMStatisticsAccumulator& accumulator,
+                             Getter getter) {
+    for (size_t i = 0, size = tv.size(); i < size; ++i) {
+        if (tv.is_row_attached(i) && !tv.is_null(column, i)) {
+            accumulator.add(getter(i));
+        }
+    }
+}
+
+RLMPropertyStatistics *RLMStatisticsForProperty(realm::TableView const& tv, RLMClassInfo& info, NSString *property) {
+    RLMProperty *prop = info.rlmObjectSchema[property];
+    if (!prop) {
+        @throw RLMException(@"Invalid property name '%@' for class '%@'.", property, info.rlmObjectSchema.className);
+    }
+
+    size_t column = info.tableColumn(prop);
+    RLMStatisticsAccumulator accumulator(prop.type);
+    switch (prop.type) {
+        case RLMPropertyTypeInt:
+            accumulateColumn(tv, column, accumulator, [&](size_t i) { return tv.get_int(column, i); });
+            break;
+        case RLMPropertyTypeFloat:
+            accumulateColumn(tv, column, accumulator, [&](size_t i) { return (double)tv.get_float(column, i); });
+            break;
+        case RLMPropertyTypeDouble:
+            accumulateColumn(tv, column, accumulator, [&](size_t i) { return tv.get_double(column, i); });
+            break;
+        default:
+            @throw RLMException(@"statisticsForProperty: is not supported for %@ property '%@'.",
+                                RLMTypeToString(prop.type), property);
+    }
+    return accumulator.statistics();
+}
+
+namespace {
+// The distance between a vector stored in the file and the query vector,
+// computed in a single pass. Stored vectors aren't necessarily aligned, so
+// they're read with memcpy, and the loop is split into independent lanes so
+// that the compiler can vectorize it with the target's SIMD instructions.
+template<RLMVectorDistanceMetric metric>
+float RLMVectorDistance(const char *stored, const float *query, size_t dimension, float queryNorm) {
+    constexpr size_t lanes = 8;
+    float products[lanes] = {}, norms[lanes] = {};
+    size_t i = 0;
+    for (; i + lanes <= dimension; i += lanes) {
+        float values[lanes];
+        memcpy(values, stored + i * sizeof(float), sizeof(values));
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            if (metric == RLMVectorDistanceMetricCosine) {
+                products[lane] += values[lane] * query[i + lane];
+                norms[lane] += values[lane] * values[lane];
+            }
+            else {
+                float difference = values[lane] - query[i + lane];
+                products[lane] += difference * difference;
+            }
+        }
+    }
+    float product = 0, norm = 0;
+    for (size_t lane = 0; lane < lanes; ++lane) {
+        product += products[lane];
+        norm += norms[lane];
+    }
+    for (; i < dimension; ++i) {
+        float value;
+        memcpy(&value, stored + i * sizeof(float), sizeof(float));
+        if (metric == RLMVectorDistanceMetricCosine) {
+            product += value * query[i];
+            norm += value * value;
+        }
+        else {
+            float difference = value - query[i];
+            product += difference * difference;
+        }
+    }
+
+    if (metric == RLMVectorDistanceMetricEuclidean) {
+        return std::sqrt(product);
+    }
+    float denominator = std::sqrt(norm) * queryNorm;
+    return denominator == 0 ? 1 : 1 - product / denominator;
+}
+
+template<RLMVectorDistanceMetric metric>
+std::vector<std::pair<float, size_t>> RLMNearestRows(realm::TableView const& tv, size_t column,
+                                                     const float *query, size_t dimension, size_t limit) {
+    float queryNorm = 0;
+    for (size_t i = 0; i < dimension; ++i) {
+        queryNorm += query[i] * query[i];
+    }
+    queryNorm = std::sqrt(queryNorm);
+
+    // A max-heap of the nearest rows found so far, by distance and then by
+    // position in the table view
+    std::vector<std::pair<float, size_t>> nearest;
+    nearest.reserve(limit + 1);
+    for (size_t i = 0, count = tv.size(); i < count; ++i) {
+        if (!tv.is_row_attached(i)) {
+            continue;
+        }
+        auto data = tv.get_binary(column, i);
+        if (data.is_null() || data.size() != dimension * sizeof(float)) {
+            continue;
+        }
+        float distance = RLMVectorDistance<metric>(data.data(), query, dimension, queryNorm);
+        // NaN distances (from NaN components) don't order against anything,
+        // which would break the heap, and aren't near to anything anyway
+        if (std::isnan(distance)) {
+            continue;
+        }
+        if (nearest.size() == limit) {
+            if (!(distance < nearest.front().first)) {
+                continue;
+            }
+            std::pop_heap(nearest.begin(), nearest.end());
+            nearest.pop_back();
+        }
+        nearest.emplace_back(distance, i);
+        std::push_heap(nearest.begin(), nearest.end());
+    }
+    std::sort_heap(nearest.begin(), nearest.end());
+    return nearest;
+}
+}
+
+NSArray *RLMObjectsNearestToVector(realm::TableView const& tv, RLMClassInfo& info, NSData *vector,
+                                   NSString *property, NSUInteger limit, RLMVectorDistanceMetric metric) {
+    RLMProperty *prop = info.rlmObjectSchema[property];
+    if (!prop) {
+        @throw RLMException(@"Invalid property name '%@' for class '%@'.", property, info.rlmObjectSchema.className);
+    }
+    if (!prop.vectorDimension) {
+        @throw RLMException(@"Property '%@.%@' is not listed in '+[%@ vectorProperties]'.",
+                            info.rlmObjectSchema.className, property, info.rlmObjectSchema.className);
+    }
+    if (vector.length != prop.vectorDimension * sizeof(float)) {
+        @throw RLMException(@"Vector must hold %llu floats (%llu bytes) to be compared with '%@', but holds %llu bytes.",
+                            (unsigned long long)prop.vectorDimension,
+                            (unsigned long long)(prop.vectorDimension * sizeof(float)), property,
+                            (unsigned long long)vector.length);
+    }
+    if (limit == 0) {
+        return @[];
+    }
+
+    // The query vector is copied so that it's aligned
+    std::vector<float> query(prop.vectorDimension);
+    memcpy(query.data(), vector.bytes, vector.length);
+    size_t column = info.tableColumn(prop);
+    auto nearest = metric == RLMVectorDistanceMetricCosine
+                 ? RLMNearestRows<RLMVectorDistanceMetricCosine>(tv, column, query.data(), query.size(), limit)
+                 : RLMNearestRows<RLMVectorDistanceMetricEuclidean>(tv, column, query.data(), query.size(), limit);
+
+    NSMutableArray *objects = [NSMutableArray arrayWithCapacity:nearest.size()];
+    for (auto& row : nearest) {
+        [objects addObject:RLMCreateObjectAccessor(info.realm, info, tv.get_source_ndx(row.second))];
+    }
+    return objects;
+}
+
+// A notifier shared by all of the RLMResults for the same query in a Realm
+// which have notification blocks, so that the query is run and its changes are
+// computed in the background once per version rather than once per RLMResults.
+// It observes a copy of the results of the first subscriber. The subscribers'
+// own results are left as they are, and are only referred to weakly, so a
+// subscriber whose RLMResults has gone away is simply not called.
+struct RLMSharedResultsNotifier {
+    using Callback = std::function<void(realm::CollectionChangeSet const&, std::exception_ptr)>;
+    struct Subscriber {
+        uint64_t id;
+        __weak RLMResults *results;
+        Callback callback;
+        bool suppressNext;
+        // Set for subscribers which joined after the first notification, until
+        // they're called for the first time
+        bool needsInitial;
+    };
+
+    realm::Results results;
+    realm::NotificationToken token;
+    std::vector<Subscriber> subscribers;
+    uint64_t nextID = 0;
+    bool delivered = false;
+
+    explicit RLMSharedResultsNotifier(realm::Results const& source) : results(source) { }
+
+    Subscriber *find(uint64_t id) {
+        auto it = std::find_if(subscribers.begin(), subscribers.end(), [&](auto& s) { return s.id == id; });
+        return it == subscribers.end() ? nullptr : &*it;
+    }
+
+    void remove(uint64_t id) {
+        subscribers.erase(std::remove_if(subscribers.begin(), subscribers.end(), [&](auto& s) { return s.id == id; }),
+                          subscribers.end());
+    }
+
+    void deliver(realm::CollectionChangeSet const& changes, std::exception_ptr err) {
+        if (!err) {
+            delivered = true;
+        }
+        // Callbacks can add and remove subscribers, so look each one up again
+        // rather than holding on to an iterator
+        std::vector<uint64_t> ids;
+        for (auto& subscriber : subscribers) {
+            ids.push_back(subscriber.id);
+        }
+        for (auto id : ids) {
+            auto subscriber = find(id);
+            if (!subscriber || !subscriber->results) {
+                continue;
+            }
+            // A subscriber which hasn't had its initial notification yet is
+            // given that now rather than a change from a version it never saw.
+            // This happens when a change is delivered synchronously, such as
+            // by beginning a write transaction, before its initial one runs.
+            if (subscriber->needsInitial && !err) {
+                subscriber->needsInitial = false;
+                subscriber->suppressNext = false;
+                auto callback = subscriber->callback;
+                callback({}, nullptr);
+                continue;
+            }
+            subscriber->needsInitial = false;
+            if (subscriber->suppressNext) {
+                subscriber->suppressNext = false;
+                continue;
+            }
+            auto callback = subscriber->callback;
+            callback(changes, err);
+        }
+    }
+};
+
+// A subscriber's registration with a shared notifier, which unregisters it when
+// destroyed. The notifier is destroyed along with its last subscription.
+struct RLMSharedResultsSubscription {
+    std::shared_ptr<RLMSharedResultsNotifier> notifier;
+    uint64_t id;
+
+    ~RLMSharedResultsSubscription() {
+        notifier->remove(id);
+    }
+};
+
+static std::shared_ptr<RLMSharedResultsSubscription>
+RLMSubscribeToSharedNotifier(RLMRealm *realm, NSString *identity, RLMResults *objcResults, realm::Results& results,
+                             RLMSharedResultsNotifier::Callback callback) {
+    auto& notifiers = realm->_sharedResultsNotifiers;
+    std::string key = identity.UTF8String;
+    auto notifier = notifiers[key].lock();
+    if (!notifier) {
+        // Drop the entries for queries which are no longer observed
+        for (auto it = notifiers.begin(); it != notifiers.end(); ) {
+            it = it->second.expired() ? notifiers.erase(it) : std::next(it);
+        }
+        notifier = std::make_shared<RLMSharedResultsNotifier>(results);
+        std::weak_ptr<RLMSharedResultsNotifier> weakNotifier = notifier;
+        notifier->token = notifier->results.add_notification_callback([=](realm::CollectionChangeSet const& changes,
+                                                                          std::exception_ptr err) {
+            if (auto notifier = weakNotifier.lock()) {
+                notifier->deliver(changes, err);
+            }
+        });
+        notifiers[key] = notifier;
+    }
+
+    uint64_t id = notifier->nextID++;
+    notifier->subscribers.push_back({id, objcResults, std::move(callback), false, notifier->delivered});
+
+    // A subscriber joining a notifier which has already delivered its initial
+    // notification is given its own on the next run loop iteration, as it
+    // would be if it had its own notifier. Common modes so that it isn't held
+    // back while the run loop is tracking a scroll view.
+    if (notifier->delivered) {
+        std::weak_ptr<RLMSharedResultsNotifier> weakNotifier = notifier;
+        CFRunLoopRef runLoop = CFRunLoopGetCurrent();
+        CFRunLoopPerformBlock(runLoop, kCFRunLoopCommonModes, ^{
+            auto notifier = weakNotifier.lock();
+            auto subscriber = notifier ? notifier->find(id) : nullptr;
+            if (!subscriber || !subscriber->needsInitial || !subscriber->results) {
+                return;
+            }
+            subscriber->needsInitial = false;
+            auto callback = subscriber->callback;
+            callback({}, nullptr);
+        });
+        CFRunLoopWakeUp(runLoop);
+    }
+
+    auto subscription = std::make_shared<RLMSharedResultsSubscription>();
+    subscription->notifier = std::move(notifier);
+    subscription->id = id;
+    return subscription;
+}
+
+static bool RLMIsPlainPredicate(NSPredicate *predicate, NSMutableString *constants);
+
+static bool RLMIsPlainValue(id value, NSMutableString *constants) {
+    if (!value || value == NSNull.null || [value isKindOfClass:[NSString class]]) {
+        return true;
+    }
+    if (auto number = RLMDynamicCast<NSNumber>(value)) {
+        // Numbers are formatted with too few digits to tell them apart, and
+        // a float and a double constant can select different rows
+        const char *type = number.objCType;
+        if (*type == 'f' || *type == 'd') {
+            [constants appendFormat:@"\n%s%a", type, number.doubleValue];
+        }
+        else {
+            [constants appendFormat:@"\n%s%@", type, number.stringValue];
+        }
+        return true;
+    }
+    if ([value isKindOfClass:[NSData class]]) {
+        // Long data is abbreviated in predicate formats
+        [constants appendFormat:@"\n%@", [value base64EncodedStringWithOptions:0]];
+        return true;
+    }
+    if ([value isKindOfClass:[NSDate class]]) {
+        [constants appendFormat:@"\n%a", [value timeIntervalSinceReferenceDate]];
+        return true;
+    }
+    if ([value isKindOfClass:[NSArray class]] || [value isKindOfClass:[NSSet class]]) {
+        for (id element in value) {
+            if (!RLMIsPlainValue(element, constants)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+static bool RLMIsPlainExpression(NSExpression *expression, NSMutableString *constants) {
+    switch (expression.expressionType) {
+        case NSConstantValueExpressionType:
+            return RLMIsPlainValue(expression.constantValue, constants);
+        case NSKeyPathExpressionType:
+        case NSVariableExpressionType:
+        case NSEvaluatedObjectExpressionType:
+            return true;
+        case NSAggregateExpressionType:
+            for (NSExpression *element in expression.collection) {
+                if (!RLMIsPlainExpression(element, constants)) {
+                    return false;
+                }
+            }
+            return true;
+        case NSSubqueryExpressionType:
+            return [expression.collection isKindOfClass:[NSExpression class]]
+                && RLMIsPlainExpression(expression.collection, constants)
+                && RLMIsPlainPredicate(expression.predicate, constants);
+        case NSFunctionExpressionType:
+            for (NSExpression *argument in expression.arguments) {
+                if (!RLMIsPlainExpression(argument, constants)) {
+                    return false;
+                }
+            }
+            return RLMIsPlainExpression(expression.operand, constants);
+        default:
+            return false;
+    }
+}
+
+static bool RLMIsPlainPredicate(NSPredicate *predicate, NSMutableString *constants) {
+    if (auto compound = RLMDynamicCast<NSCompoundPredicate>(predicate)) {
+        for (NSPredicate *subpredicate in compound.subpredicates) {
+            if (!RLMIsPlainPredicate(subpredicate, constants)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    if (auto comparison = RLMDynamicCast<NSComparisonPredicate>(predicate)) {
+        return comparison.predicateOperatorType != NSCustomSelectorPredicateOperatorType
+            && RLMIsPlainExpression(comparison.leftExpression, constants)
+            && RLMIsPlainExpression(comparison.rightExpression, constants);
+    }
+    return [predicate isEqual:[NSPredicate predicateWithValue:YES]]
+        || [predicate isEqual:[NSPredicate predicateWithValue:NO]];
+}
+
+NSString *RLMPredicateIdentity(NSPredicate *predicate) {
+    // The format of a predicate identifies it other than for the precision of
+    // the numbers, dates and data it compares against, so the exact value of
+    // each of them is appended to it
+    NSMutableString *constants = [NSMutableString string];
+    if (!RLMIsPlainPredicate(predicate, constants)) {
+        return nil;
+    }
+    return [predicate.predicateFormat stringByAppendingString:constants];
+}
+
 @implementation RLMCancellationToken {
     realm::NotificationToken _token;
     __unsafe_unretained RLMRealm *_realm;
+    std::function<realm::NotificationToken()> _registration;
+    std::shared_ptr<RLMSharedResultsSubscription> _subscription;
+    std::function<std::shared_ptr<RLMSharedResultsSubscription>()> _sharedRegistration;
 }
 - (instancetype)initWithToken:(realm::NotificationToken)token realm:(RLMRealm *)realm {
     self = [super init];
@@ -242,16 +1187,70 @@ NSString *RLMDescriptionWithMaxDepth(NSString *name,
     return self;
 }
 
+- (instancetype)initWithRealm:(RLMRealm *)realm registration:(std::function<realm::NotificationToken()>)registration {
+    self = [super init];
+    if (self) {
+        _realm = realm;
+        _registration = std::move(registration);
+        if (!realm.collectionNotificationsSuspended) {
+            _token = _registration();
+        }
+        [realm registerSuspendableToken:self];
+    }
+    return self;
+}
+
+- (instancetype)initWithRealm:(RLMRealm *)realm
+           sharedRegistration:(std::function<std::shared_ptr<RLMSharedResultsSubscription>()>)registration {
+    self = [super init];
+    if (self) {
+        _realm = realm;
+        _sharedRegistration = std::move(registration);
+        if (!realm.collectionNotificationsSuspended) {
+            _subscription = _sharedRegistration();
+        }
+        [realm registerSuspendableToken:self];
+    }
+    return self;
+}
+
+- (void)suspend {
+    // Dropping the callback lets the notifier stop computing change sets once
+    // it has no other callbacks
+    if (_registration) {
+        _token = {};
+    }
+    _subscription = nullptr;
+}
+
+- (void)resume {
+    if (_registration) {
+        _token = _registration();
+    }
+    if (_sharedRegistration) {
+        _subscription = _sharedRegistration();
+    }
+}
+
 - (RLMRealm *)realm {
     return _realm;
 }
 
 - (void)suppressNextNotification {
+    if (_subscription) {
+        if (auto subscriber = _subscription->notifier->find(_subscription->id)) {
+            subscriber->suppressNext = true;
+        }
+        return;
+    }
     _token.suppress_next();
 }
 
 - (void)stop {
     _token = {};
+    _registration = nullptr;
+    _subscription = nullptr;
+    _sharedRegistration = nullptr;
 }
 
 @end
@@ -268,6 +1267,10 @@ NSString *RLMDescriptionWithMaxDepth(NSString *name,
     return self;
 }
 
+- (realm::CollectionChangeSet const&)changeSet {
+    return _indices;
+}
+
 static NSArray *toArray(realm::IndexSet const& set) {
     NSMutableArray *ret = [NSMutableArray new];
     for (auto index : set.as_indexes()) {
@@ -311,13 +1314,286 @@ static NSArray *toIndexPathArray(realm::IndexSet const& set, NSUInteger section)
     return toIndexPathArray(_indices.modifications, section);
 
 }
+
+static NSIndexSet *toIndexSet(realm::IndexSet const& set) {
+    NSMutableIndexSet *ret = [NSMutableIndexSet new];
+    for (auto range : set) {
+        [ret addIndexesInRange:{range.first, range.second - range.first}];
+    }
+    return ret;
+}
+
+- (NSIndexSet *)deletionIndexes {
+    return toIndexSet(_indices.deletions);
+}
+
+- (NSIndexSet *)insertionIndexes {
+    return toIndexSet(_indices.insertions);
+}
+
+- (NSIndexSet *)modificationIndexes {
+    return toIndexSet(_indices.modifications);
+}
+
+static void enumerateRanges(realm::IndexSet const& set, void (NS_NOESCAPE ^block)(NSRange, BOOL *)) {
+    BOOL stop = NO;
+    for (auto range : set) {
+        block({range.first, range.second - range.first}, &stop);
+        if (stop) {
+            break;
+        }
+    }
+}
+
+- (void)enumerateDeletionRangesUsingBlock:(void (NS_NOESCAPE ^)(NSRange, BOOL *))block {
+    enumerateRanges(_indices.deletions, block);
+}
+
+- (void)enumerateInsertionRangesUsingBlock:(void (NS_NOESCAPE ^)(NSRange, BOOL *))block {
+    enumerateRanges(_indices.insertions, block);
+}
+
+- (void)enumerateModificationRangesUsingBlock:(void (NS_NOESCAPE ^)(NSRange, BOOL *))block {
+    enumerateRanges(_indices.modifications, block);
+}
+
+- (void)enumerateMovesUsingBlock:(void (NS_NOESCAPE ^)(NSUInteger, NSUInteger, BOOL *))block {
+    BOOL stop = NO;
+    for (auto& move : _indices.moves) {
+        block(move.from, move.to, &stop);
+        if (stop) {
+            break;
+        }
+    }
+}
 @end
 
+static void validateNotificationKeyPaths(RLMRealm *realm, NSString *className, NSArray<NSString *> *keyPaths) {
+    for (NSString *keyPath in keyPaths) {
+        RLMObjectSchema *objectSchema = realm.schema[className];
+        NSArray<NSString *> *components = [keyPath componentsSeparatedByString:@"."];
+        for (NSUInteger i = 0; i < components.count; ++i) {
+            RLMProperty *prop = objectSchema[components[i]];
+            if (!prop) {
+                @throw RLMException(@"Invalid key path '%@' for notifications: property '%@' not found in object of type '%@'",
+                                    keyPath, components[i], objectSchema.className);
+            }
+            if (i + 1 == components.count) {
+                break;
+            }
+            if (prop.type != RLMPropertyTypeObject) {
+                @throw RLMException(@"Invalid key path '%@' for notifications: property '%@.%@' is not a link to a single object",
+                                    keyPath, objectSchema.className, prop.name);
+            }
+            objectSchema = realm.schema[prop.objectClassName];
+        }
+    }
+}
+
+// Objects are compared by their primary keys, which also lets the values be
+// read by a Realm on another thread. Row indexes can't be used, as deleting
+// other objects of the class moves rows, and objects without a primary key
+// have no other stable identity, so they never compare as equal and a
+// modification reported for the object linking to them is always kept.
+static id observedValue(id value) {
+    if (RLMObjectBase *object = RLMDynamicCast<RLMObjectBase>(value)) {
+        if (RLMProperty *primaryKey = object->_info->propertyForPrimaryKey()) {
+            return RLMDynamicGet(object, primaryKey) ?: NSNull.null;
+        }
+        return [NSObject new];
+    }
+    return value ?: NSNull.null;
+}
+
+// The values at the observed key paths of the object at `index`, with
+// collections converted to arrays of their objects so that they compare by
+// contents rather than by identity
+static NSArray *observedValues(id collection, NSUInteger index, NSArray<NSString *> *keyPaths) {
+    id object = [collection objectAtIndex:index];
+    NSMutableArray *values = [NSMutableArray arrayWithCapacity:keyPaths.count];
+    for (NSString *keyPath in keyPaths) {
+        id value = [object valueForKeyPath:keyPath];
+        if ([value conformsToProtocol:@protocol(RLMCollection)]) {
+            NSMutableArray *objects = [NSMutableArray arrayWithCapacity:[value count]];
+            for (id obj in value) {
+                [objects addObject:observedValue(obj)];
+            }
+            value = objects;
+        }
+        [values addObject:observedValue(value)];
+    }
+    return values;
+}
+
+namespace {
+// The state for a notification block which is only interested in changes to
+// some key paths: the values at those key paths for each object in the
+// collection as of the last notification
+struct KeyPathFilter {
+    // Collections with more objects than this aren't read up front. Instead
+    // each object's values are read the first time it's reported as
+    // modified, and that modification is delivered unfiltered.
+    static const NSUInteger eagerReadLimit = 1000;
+
+    NSArray<NSString *> *keyPaths;
+    // The values at the key paths for each object, or nil if not read yet
+    std::vector<NSArray *> values;
+    bool initialized = false;
+
+    void reset(id collection) {
+        values.clear();
+        initialized = true;
+
+        NSUInteger count = [collection count];
+        if (count > eagerReadLimit) {
+            values.resize(count);
+            return;
+        }
+        values.reserve(count);
+        for (NSUInteger i = 0; i < count; ++i) {
+            values.push_back(observedValues(collection, i, keyPaths));
+        }
+    }
+
+    // Remove the modifications which did not change the values at any of the
+    // key paths. Only the objects reported as inserted or modified are read.
+    realm::CollectionChangeSet filter(id collection, realm::CollectionChangeSet const& changes) {
+        realm::CollectionChangeSet filtered = changes;
+        filtered.modifications = {};
+        filtered.modifications_new = {};
+
+        std::vector<NSArray *> newValues;
+        size_t count = [collection count];
+        newValues.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            if (changes.insertions.contains(i)) {
+                newValues.push_back(observedValues(collection, i, keyPaths));
+                continue;
+            }
+            size_t old = changes.deletions.shift(changes.insertions.unshift(i));
+            if (old < values.size() && !changes.modifications.contains(old)) {
+                newValues.push_back(values[old]);
+                continue;
+            }
+            NSArray *current = observedValues(collection, i, keyPaths);
+            if (old >= values.size() || !values[old] || ![current isEqualToArray:values[old]]) {
+                filtered.modifications.add(old);
+                filtered.modifications_new.add(i);
+            }
+            newValues.push_back(current);
+        }
+        values = std::move(newValues);
+        return filtered;
+    }
+};
+
+// The state for a notification block which should be called at most once
+// per `interval`: changes which arrive before the interval has passed since
+// the last call are merged and delivered together by a run loop timer
+struct NotificationThrottle {
+    NSTimeInterval interval;
+    CFAbsoluteTime lastDelivery = 0;
+    realm::util::Optional<realm::_impl::CollectionChangeBuilder> pending;
+    CFRunLoopTimerRef timer = nullptr;
+    std::function<void (realm::CollectionChangeSet const&)> deliver;
+    __weak RLMRealm *realm;
+
+    ~NotificationThrottle() {
+        cancelTimer();
+    }
+
+    void cancelTimer() {
+        if (timer) {
+            CFRunLoopTimerInvalidate(timer);
+            CFRelease(timer);
+            timer = nullptr;
+        }
+    }
+
+    void add(std::weak_ptr<NotificationThrottle> weakSelf, realm::CollectionChangeSet const& changes) {
+        realm::_impl::CollectionChangeBuilder builder(changes.deletions, changes.insertions,
+                                                      changes.modifications, changes.moves);
+        if (pending) {
+            pending->merge(std::move(builder));
+        }
+        else {
+            pending = std::move(builder);
+        }
+
+        if (timer) {
+            return;
+        }
+        CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+        if (now - lastDelivery >= interval) {
+            flush();
+        }
+        else {
+            schedule(std::move(weakSelf), lastDelivery + interval);
+        }
+    }
+
+    void schedule(std::weak_ptr<NotificationThrottle> weakSelf, CFAbsoluteTime fireDate) {
+        timer = CFRunLoopTimerCreateWithHandler(kCFAllocatorDefault, fireDate, 0, 0, 0, ^(CFRunLoopTimerRef) {
+            auto throttle = weakSelf.lock();
+            if (!throttle) {
+                return;
+            }
+            throttle->cancelTimer();
+            // The collection includes the uncommitted changes while in a
+            // write transaction, so wait until it's over
+            if (throttle->realm.inWriteTransaction) {
+                throttle->schedule(weakSelf, CFAbsoluteTimeGetCurrent() + throttle->interval);
+                return;
+            }
+            throttle->flush();
+        });
+        // Common modes so that delivery isn't held back while the run loop
+        // is tracking a scroll view or another modal interaction
+        CFRunLoopAddTimer(CFRunLoopGetCurrent(), timer, kCFRunLoopCommonModes);
+    }
+
+    void flush() {
+        cancelTimer();
+        if (!pending) {
+            return;
+        }
+        auto changes = std::move(*pending).finalize();
+        pending = realm::util::none;
+        lastDelivery = CFAbsoluteTimeGetCurrent();
+        if (!changes.empty()) {
+            deliver(changes);
+        }
+    }
+};
+
+// Results for the same query share a notifier, while each list has its own
+struct SharedNotifier {
+    static NSString *identity(id, realm::List&) {
+        return nil;
+    }
+    static NSString *identity(RLMResults *results, realm::Results&) {
+        return results.queryIdentity;
+    }
+
+    static std::shared_ptr<RLMSharedResultsSubscription> subscribe(RLMRealm *, NSString *, id, realm::List&,
+                                                                   RLMSharedResultsNotifier::Callback) {
+        REALM_UNREACHABLE();
+    }
+    static std::shared_ptr<RLMSharedResultsSubscription> subscribe(RLMRealm *realm, NSString *identity,
+                                                                   RLMResults *objcResults, realm::Results& results,
+                                                                   RLMSharedResultsNotifier::Callback callback) {
+        return RLMSubscribeToSharedNotifier(realm, identity, objcResults, results, std::move(callback));
+    }
+};
+}
+
 template<typename Collection>
 RLMNotificationToken *RLMAddNotificationBlock(id objcCollection,
                                               Collection& collection,
                                               void (^block)(id, RLMCollectionChange *, NSError *),
-                                              bool suppressInitialChange) {
+                                              bool suppressInitialChange,
+                                              NSArray<NSString *> *keyPaths,
+                                              NSTimeInterval minimumInterval) {
     struct IsValid {
         static bool call(realm::List const& list) {
             return list.is_valid();
@@ -327,6 +1603,38 @@ RLMNotificationToken *RLMAddNotificationBlock(id objcCollection,
         }
     };
 
+    // Time each call to the block for the notification timing block
+    auto userBlock = block;
+    __weak RLMRealm *weakRealm = [objcCollection realm];
+    NSString *className = [objcCollection objectClassName];
+    block = ^(id collection, RLMCollectionChange *change, NSError *error) {
+        RLMNotificationInterval interval(RLMNotificationStageCollectionBlock, weakRealm);
+        RLMSignpost signpost(RLMSignpostName::CollectionNotification, [&] { return className; });
+        if (signpost.active() && change) {
+            signpost.setRowCount(change.insertions.count + change.deletions.count + change.modifications.count);
+        }
+        userBlock(collection, change, error);
+    };
+
+    std::shared_ptr<KeyPathFilter> keyPathFilter;
+    if (keyPaths) {
+        validateNotificationKeyPaths([objcCollection realm], [objcCollection objectClassName], keyPaths);
+        keyPathFilter = std::make_shared<KeyPathFilter>();
+        keyPathFilter->keyPaths = [keyPaths copy];
+    }
+
+    std::shared_ptr<NotificationThrottle> throttle;
+    if (minimumInterval > 0) {
+        throttle = std::make_shared<NotificationThrottle>();
+        throttle->interval = minimumInterval;
+        throttle->realm = [objcCollection realm];
+        throttle->deliver = [=, &collection](realm::CollectionChangeSet const& changes) {
+            if (IsValid::call(collection)) {
+                block(objcCollection, [[RLMCollectionChange alloc] initWithChanges:changes], nil);
+            }
+        };
+    }
+
     auto skip = suppressInitialChange ? std::make_shared<bool>(true) : nullptr;
     auto cb = [=, &collection](realm::CollectionChangeSet const& changes,
                                std::exception_ptr err) {
@@ -337,6 +1645,10 @@ RLMNotificationToken *RLMAddNotificationBlock(id objcCollection,
             catch (...) {
                 NSError *error = nil;
                 RLMRealmTranslateException(&error);
+                if (throttle) {
+                    throttle->cancelTimer();
+                    throttle->pending = realm::util::none;
+                }
                 block(nil, nil, error);
                 return;
             }
@@ -348,20 +1660,285 @@ RLMNotificationToken *RLMAddNotificationBlock(id objcCollection,
 
         if (skip && *skip) {
             *skip = false;
+            if (keyPathFilter) {
+                keyPathFilter->reset(objcCollection);
+            }
+            if (throttle) {
+                throttle->lastDelivery = CFAbsoluteTimeGetCurrent();
+            }
             block(objcCollection, nil, nil);
+            return;
         }
-        else if (changes.empty()) {
+        if (changes.empty()) {
+            if (keyPathFilter && !keyPathFilter->initialized) {
+                keyPathFilter->reset(objcCollection);
+            }
             block(objcCollection, nil, nil);
+            return;
+        }
+
+        realm::CollectionChangeSet filtered;
+        auto *toDeliver = &changes;
+        if (keyPathFilter && keyPathFilter->initialized) {
+            filtered = keyPathFilter->filter(objcCollection, changes);
+            // Don't call the block at all if the only changes were to
+            // properties which it isn't interested in
+            if (filtered.empty()) {
+                return;
+            }
+            toDeliver = &filtered;
+        }
+        else if (keyPathFilter) {
+            keyPathFilter->reset(objcCollection);
+        }
+
+        if (throttle) {
+            throttle->add(throttle, *toDeliver);
         }
         else {
-            block(objcCollection, [[RLMCollectionChange alloc] initWithChanges:changes], nil);
+            block(objcCollection, [[RLMCollectionChange alloc] initWithChanges:*toDeliver], nil);
         }
     };
 
-    return [[RLMCancellationToken alloc] initWithToken:collection.add_notification_callback(cb)
-                                                 realm:(RLMRealm *)[objcCollection realm]];
+    // A callback registered when notifications resume is first called with
+    // no changes, which reloads the collection, so nothing which was pending
+    // before the suspension applies any more
+    auto reset = [=] {
+        if (throttle) {
+            throttle->cancelTimer();
+            throttle->pending = realm::util::none;
+        }
+        if (keyPathFilter) {
+            keyPathFilter->initialized = false;
+        }
+    };
+    // Callbacks are only registered when the token is created and when the
+    // Realm resumes notifications, so the registration doesn't need to keep
+    // the Realm alive
+    __unsafe_unretained RLMRealm *const realm = (RLMRealm *)[objcCollection realm];
+    if (NSString *identity = SharedNotifier::identity(objcCollection, collection)) {
+        auto registration = [=, &collection] {
+            reset();
+            return SharedNotifier::subscribe(realm, identity, objcCollection, collection, cb);
+        };
+        return [[RLMCancellationToken alloc] initWithRealm:realm sharedRegistration:registration];
+    }
+    auto registration = [=, &collection] {
+        reset();
+        return collection.add_notification_callback(cb);
+    };
+    return [[RLMCancellationToken alloc] initWithRealm:realm registration:registration];
 }
 
 // Explicitly instantiate the templated function for the two types we'll use it on
-template RLMNotificationToken *RLMAddNotificationBlock<realm::List>(id, realm::List&, void (^)(id, RLMCollectionChange *, NSError *), bool);
-template RLMNotificationToken *RLMAddNotificationBlock<realm::Results>(id, realm::Results&, void (^)(id, RLMCollectionChange *, NSError *), bool);
+template RLMNotificationToken *RLMAddNotificationBlock<realm::List>(id, realm::List&, void (^)(id, RLMCollectionChange *, NSError *), bool, NSArray<NSString *> *, NSTimeInterval);
+template RLMNotificationToken *RLMAddNotificationBlock<realm::Results>(id, realm::Results&, void (^)(id, RLMCollectionChange *, NSError *), bool, NSArray<NSString *> *, NSTimeInterval);
+
+// A background thread with a run loop which the collection notifications
+// delivered on dispatch queues are registered on. Notifications are delivered
+// to the thread which registered them while it's running its run loop, so a
+// single shared thread avoids needing a run loop thread per queue.
+@interface RLMNotificationThread : NSThread
+@end
+
+@implementation RLMNotificationThread {
+    @public
+    CFRunLoopRef _runLoop;
+    dispatch_semaphore_t _started;
+}
+
++ (instancetype)sharedThread {
+    static RLMNotificationThread *thread;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        thread = [RLMNotificationThread new];
+        thread.name = @"io.realm.notifications";
+        thread->_started = dispatch_semaphore_create(0);
+        [thread start];
+        dispatch_semaphore_wait(thread->_started, DISPATCH_TIME_FOREVER);
+    });
+    return thread;
+}
+
+- (void)main {
+    @autoreleasepool {
+        _runLoop = CFRunLoopGetCurrent();
+        // A run loop with no sources exits immediately
+        CFRunLoopSourceContext context = {};
+        CFRunLoopSourceRef source = CFRunLoopSourceCreate(kCFAllocatorDefault, 0, &context);
+        CFRunLoopAddSource(_runLoop, source, kCFRunLoopDefaultMode);
+        CFRelease(source);
+        dispatch_semaphore_signal(_started);
+    }
+    CFRunLoopRun();
+}
+
+- (void)performBlock:(dispatch_block_t)block {
+    CFRunLoopPerformBlock(_runLoop, kCFRunLoopDefaultMode, ^{
+        @autoreleasepool {
+            block();
+        }
+    });
+    CFRunLoopWakeUp(_runLoop);
+}
+
+- (void)performBlockAndWait:(dispatch_block_t)block {
+    if (NSThread.currentThread == self) {
+        block();
+        return;
+    }
+    dispatch_semaphore_t done = dispatch_semaphore_create(0);
+    [self performBlock:^{
+        block();
+        dispatch_semaphore_signal(done);
+    }];
+    dispatch_semaphore_wait(done, DISPATCH_TIME_FOREVER);
+}
+@end
+
+// A token for a notification block registered on the notification thread
+@interface RLMQueueNotificationToken : RLMNotificationToken
+@end
+
+namespace {
+// The notifications for queue-delivered blocks are computed for a Realm on the
+// notification thread rather than the Realm which commits the write whose
+// notification is suppressed, so the commit is identified by the version it
+// produces. A notification is only skipped if that commit is the only change
+// it describes, as changes made by other commits can't be separated from it.
+struct QueueNotificationSuppression {
+    std::atomic<uint64_t> suppressedVersion{0};
+    // Only accessed on the notification thread
+    uint64_t deliveredVersion = 0;
+
+    bool shouldSkip(uint64_t version) {
+        uint64_t previous = deliveredVersion;
+        deliveredVersion = version;
+        return version == suppressedVersion && previous + 1 == version;
+    }
+};
+
+uint64_t currentVersion(RLMRealm *realm) {
+    return _impl::RealmFriend::get_shared_group(*realm->_realm).get_version_of_current_transaction().version;
+}
+} // anonymous namespace
+
+@implementation RLMQueueNotificationToken {
+@public
+    RLMNotificationToken *_token;
+    __weak RLMRealm *_realm;
+    std::shared_ptr<QueueNotificationSuppression> _suppression;
+}
+
+- (RLMRealm *)realm {
+    return _realm;
+}
+
+- (void)suppressNextNotification {
+    RLMRealm *realm = _realm;
+    if (realm.inWriteTransaction) {
+        // Committing the write transaction produces the next version
+        _suppression->suppressedVersion = currentVersion(realm) + 1;
+    }
+}
+
+- (void)stop {
+    RLMNotificationToken *token = _token;
+    _token = nil;
+    // Wait for the token to be stopped on the notification thread so that
+    // the Realm it was observing has been released once this returns
+    if (token) {
+        [RLMNotificationThread.sharedThread performBlockAndWait:^{
+            [token stop];
+        }];
+    }
+}
+
+- (void)dealloc {
+    [self stop];
+}
+@end
+
+namespace {
+// Open the Realm which a queue-delivered notification resolves its collection
+// in. It's uncached and private to the delivery, as the delivery moves it to
+// the version the change was computed at rather than the latest version.
+RLMRealm *queueNotificationRealm(RLMRealmConfiguration *configuration, NSError **error) {
+    RLMRealmConfiguration *uncached = [configuration copy];
+    uncached.cache = false;
+    RLMRealm *realm = [RLMRealm realmWithConfiguration:uncached error:error];
+    if (realm) {
+        realm->_realm->set_auto_refresh(false);
+    }
+    return realm;
+}
+} // anonymous namespace
+
+RLMNotificationToken *RLMAddNotificationBlockOnQueue(id<RLMThreadConfined> collection,
+                                                     void (^block)(id, RLMCollectionChange *, NSError *),
+                                                     dispatch_queue_t queue) {
+    RLMRealmConfiguration *configuration = collection.realm.configuration;
+    RLMThreadSafeReference *reference = [RLMThreadSafeReference referenceWithThreadConfined:collection];
+    RLMQueueNotificationToken *token = [RLMQueueNotificationToken new];
+    token->_realm = collection.realm;
+    auto suppression = std::make_shared<QueueNotificationSuppression>();
+    token->_suppression = suppression;
+    __block NSException *exception;
+    [RLMNotificationThread.sharedThread performBlockAndWait:^{
+        @try {
+            RLMRealm *realm = [RLMRealm realmWithConfiguration:configuration error:nil];
+            id observed = [realm resolveThreadSafeReference:reference];
+            if (!observed) {
+                return;
+            }
+            token->_token = [(id<RLMCollection>)observed addNotificationBlock:^(id current, RLMCollectionChange *change, NSError *error) {
+                if (error) {
+                    dispatch_async(queue, ^{
+                        block(nil, nil, error);
+                    });
+                    return;
+                }
+                if (suppression->shouldSkip(currentVersion([(id<RLMCollection>)current realm])) && change) {
+                    return;
+                }
+
+                // The collection is handed over to the queue and resolved in
+                // a Realm opened for the delivery. GCD runs the queue's blocks
+                // on any of its worker threads and Realms are confined to the
+                // thread they were opened on, so one can't be kept for the
+                // queue. Ending the new Realm's read transaction first makes
+                // resolving the reference begin one at the version the change
+                // was computed at, rather than at the latest version, which the
+                // change doesn't describe. The Realm is invalidated once the
+                // block returns so that it doesn't keep that version alive.
+                RLMThreadSafeReference *reference = [RLMThreadSafeReference referenceWithThreadConfined:current];
+                dispatch_async(queue, ^{
+                    @autoreleasepool {
+                        NSError *error;
+                        RLMRealm *realm = queueNotificationRealm(configuration, &error);
+                        if (!realm) {
+                            block(nil, nil, error);
+                            return;
+                        }
+                        [realm invalidate];
+                        id resolved = [realm resolveThreadSafeReference:reference];
+                        // The collection may have been deleted, in which case
+                        // there is nothing to deliver
+                        if (resolved) {
+                            block(resolved, change, nil);
+                        }
+                        [realm invalidate];
+                    }
+                });
+            }];
+        }
+        @catch (NSException *e) {
+            exception = e;
+        }
+    }];
+    if (exception) {
+        @throw exception;
+    }
+    return token;
+}
+
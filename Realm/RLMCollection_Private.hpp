@@ -19,6 +19,9 @@
 #import <Realm/RLMCollection.h>
 
 #import <Realm/RLMRealm.h>
+#import <Realm/RLMResults.h>
+
+#import <functional>
 
 namespace realm {
     class List;
@@ -28,6 +31,8 @@ namespace realm {
     struct NotificationToken;
 }
 class RLMClassInfo;
+@class RLMProperty;
+@protocol RLMThreadConfined;
 
 @protocol RLMFastEnumerable
 @property (nonatomic, readonly) RLMRealm *realm;
@@ -45,6 +50,20 @@ class RLMClassInfo;
 - (instancetype)initWithCollection:(id<RLMFastEnumerable>)collection
                       objectSchema:(RLMClassInfo&)objectSchema;
 
+// Create an enumerator which yields a single accessor object rebound to each
+// row in turn rather than creating a new accessor for each row. Objects are
+// yielded one at a time, and each is only valid until the next is requested.
+- (instancetype)initWithCollection:(id<RLMFastEnumerable>)collection
+                      objectSchema:(RLMClassInfo&)objectSchema
+                   reusingAccessor:(bool)reuseAccessor;
+
+// Create an enumerator which resolves each of the given chains of to-one links
+// for every object in a batch before handing the batch out, so that reading
+// them goes through the objects' link caches.
+- (instancetype)initWithCollection:(id<RLMFastEnumerable>)collection
+                      objectSchema:(RLMClassInfo&)objectSchema
+                     includedLinks:(NSArray<NSArray<RLMProperty *> *> *)includedLinks;
+
 // Detach this enumerator from the source collection. Must be called before the
 // source collection is changed.
 - (void)detach;
@@ -53,25 +72,104 @@ class RLMClassInfo;
                                     count:(NSUInteger)len;
 @end
 
+// Fast-enumerates the given collection using an RLMFastEnumerator which reuses
+// a single accessor object for every row
+@interface RLMReusingAccessorEnumerable : NSObject <NSFastEnumeration>
+- (instancetype)initWithCollection:(id<RLMFastEnumerable>)collection;
+@end
+
+// Fast-enumerates the given collection using an RLMFastEnumerator which
+// prefetches the links along the given key paths for each batch
+@interface RLMIncludingKeyPathsEnumerable : NSObject <NSFastEnumeration>
+- (instancetype)initWithCollection:(id<RLMFastEnumerable>)collection keyPaths:(NSArray<NSString *> *)keyPaths;
+@end
+
 @interface RLMNotificationToken ()
 - (void)suppressNextNotification;
 - (RLMRealm *)realm;
 @end
 
+struct RLMSharedResultsSubscription;
+
 @interface RLMCancellationToken : RLMNotificationToken
 - (instancetype)initWithToken:(realm::NotificationToken)token realm:(RLMRealm *)realm;
+// Create a token whose callback is registered by calling `registration`, and
+// which is unregistered while the Realm's collection notifications are suspended
+- (instancetype)initWithRealm:(RLMRealm *)realm registration:(std::function<realm::NotificationToken()>)registration;
+// Create a token like the above whose callback is registered with a notifier
+// shared with other results for the same query
+- (instancetype)initWithRealm:(RLMRealm *)realm
+           sharedRegistration:(std::function<std::shared_ptr<RLMSharedResultsSubscription>()>)registration;
+- (void)suspend;
+- (void)resume;
+@end
+
+@interface RLMPropertyStatistics ()
+- (instancetype)initWithCount:(NSUInteger)count minimum:(NSNumber *)minimum maximum:(NSNumber *)maximum
+                          sum:(NSNumber *)sum average:(NSNumber *)average variance:(NSNumber *)variance;
 @end
 
 @interface RLMCollectionChange ()
 - (instancetype)initWithChanges:(realm::CollectionChangeSet)indices;
+- (realm::CollectionChangeSet const&)changeSet;
 @end
 
 template<typename Collection>
 RLMNotificationToken *RLMAddNotificationBlock(id objcCollection,
                                               Collection& collection,
                                               void (^block)(id, RLMCollectionChange *, NSError *),
-                                              bool suppressInitialChange=false);
+                                              bool suppressInitialChange=false,
+                                              NSArray<NSString *> *keyPaths=nil,
+                                              NSTimeInterval minimumInterval=0);
+
+// The identity of a predicate for RLMResults.queryIdentity, or nil if it
+// can't be used to tell whether two queries are the same, such as when it has
+// object arguments, whose descriptions don't identify them
+NSString *RLMPredicateIdentity(NSPredicate *predicate);
+
+// Registers the block on a background thread shared by all such blocks, and
+// calls it on `queue` with the collection resolved in a Realm opened on the
+// thread the queue runs it on
+RLMNotificationToken *RLMAddNotificationBlockOnQueue(id<RLMThreadConfined> collection,
+                                                     void (^block)(id, RLMCollectionChange *, NSError *),
+                                                     dispatch_queue_t queue);
+
+// Accumulates the statistics of the values of a numeric property in a single
+// pass. Values must be added using the overload matching the property type:
+// int64_t for int properties and double for float and double properties.
+class RLMStatisticsAccumulator {
+public:
+    explicit RLMStatisticsAccumulator(RLMPropertyType type) : m_type(type) { }
+
+    void add(int64_t value);
+    void add(double value);
+
+    RLMPropertyStatistics *statistics() const;
+
+private:
+    void addToVariance(double value);
+
+    RLMPropertyType m_type;
+    size_t m_count = 0;
+    int64_t m_intMin = 0, m_intMax = 0, m_intSum = 0;
+    double m_min = 0, m_max = 0, m_sum = 0;
+    // Running mean and sum of squared differences from it, which give the
+    // variance without a second pass over the values
+    double m_mean = 0, m_squaredDifferences = 0;
+};
+
+// Computes the statistics for a numeric property over the rows in a table view
+RLMPropertyStatistics *RLMStatisticsForProperty(realm::TableView const& tableView, RLMClassInfo& info,
+                                                NSString *property);
+
+// Finds the rows in a table view whose vectors in a vector property are nearest
+// to `vector`, and returns accessors for them, nearest first
+NSArray *RLMObjectsNearestToVector(realm::TableView const& tableView, RLMClassInfo& info, NSData *vector,
+                                   NSString *property, NSUInteger limit, RLMVectorDistanceMetric metric);
 
 NSArray *RLMCollectionValueForKey(id<RLMFastEnumerable> collection, NSString *key);
 void RLMCollectionSetValueForKey(id<RLMFastEnumerable> collection, NSString *key, id value);
+void RLMCollectionIncrementProperty(id<RLMFastEnumerable> collection, NSString *key, int64_t amount);
+void RLMCollectionEnumerateValues(id<RLMFastEnumerable> collection, NSArray<NSString *> *propertyNames,
+                                  void (^block)(NSArray *values, NSUInteger index, BOOL *stop));
 NSString *RLMDescriptionWithMaxDepth(NSString *name, id<RLMCollection> collection, NSUInteger depth);
@@ -146,6 +146,12 @@ typedef RLM_ERROR_ENUM(NSInteger, RLMError, RLMErrorDomain) {
 
     /** Denotes an error that occurs if there is a schema version mismatch, so that a migration is required. */
     RLMErrorSchemaMismatch = 10,
+
+    /**
+     Denotes an error that occurs if the write lock of a Realm could not be acquired
+     within the timeout given to `-[RLMRealm beginWriteTransactionWithTimeout:error:]`.
+     */
+    RLMErrorWriteLockTimeout = 11,
 };
 
 #pragma mark - Constants
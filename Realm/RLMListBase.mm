@@ -19,7 +19,14 @@
 #import "RLMListBase.h"
 
 #import "RLMArray_Private.hpp"
+#import "RLMClassInfo.hpp"
+#import "RLMObject_Private.hpp"
 #import "RLMObservation.hpp"
+#import "RLMRealm_Private.hpp"
+
+#import "list.hpp"
+
+#import <realm/link_view.hpp>
 
 @interface RLMArray (KVO)
 - (NSArray *)objectsAtIndexes:(__unused NSIndexSet *)indexes;
@@ -27,6 +34,14 @@
 
 @implementation RLMListBase {
     std::unique_ptr<RLMObservationInfo> _observationInfo;
+
+    // The parent object's row and property for a managed list whose RLMArray
+    // hasn't been created yet. Most lists on objects read while enumerating
+    // are never used, so creating the link view up front is wasted work.
+    realm::Row _parentRow;
+    RLMRealm *_parentRealm;
+    RLMClassInfo *_parentInfo;
+    __unsafe_unretained RLMProperty *_property;
 }
 
 - (instancetype)initWithArray:(RLMArray *)array {
@@ -37,24 +52,58 @@
     return self;
 }
 
+- (RLMArray *)_rlmArray {
+    if (!__rlmArray && _parentRealm) {
+        [_parentRealm verifyThread];
+        realm::LinkViewRef linkView;
+        if (_parentRow.is_attached()) {
+            linkView = _parentRow.get_linklist(_parentInfo->tableColumn(_property));
+        }
+        __rlmArray = [[RLMArrayLinkView alloc] initWithList:realm::List(_parentRealm->_realm, std::move(linkView))
+                                                      realm:_parentRealm
+                                                 parentInfo:_parentInfo
+                                                   property:_property];
+        _parentRow = {};
+        _parentRealm = nil;
+    }
+    return __rlmArray;
+}
+
+- (void)set_rlmArray:(RLMArray *)rlmArray {
+    __rlmArray = rlmArray;
+    _parentRow = {};
+    _parentRealm = nil;
+}
+
 - (id)valueForKey:(NSString *)key {
-    return [__rlmArray valueForKey:key];
+    return [self._rlmArray valueForKey:key];
 }
 
 - (NSUInteger)countByEnumeratingWithState:(NSFastEnumerationState *)state objects:(id __unsafe_unretained [])buffer count:(NSUInteger)len {
-    return [__rlmArray countByEnumeratingWithState:state objects:buffer count:len];
+    return [self._rlmArray countByEnumeratingWithState:state objects:buffer count:len];
 }
 
 - (NSArray *)objectsAtIndexes:(NSIndexSet *)indexes {
-    return [__rlmArray objectsAtIndexes:indexes];
+    return [self._rlmArray objectsAtIndexes:indexes];
 }
 
 - (void)addObserver:(id)observer
          forKeyPath:(NSString *)keyPath
             options:(NSKeyValueObservingOptions)options
             context:(void *)context {
-    RLMEnsureArrayObservationInfo(_observationInfo, keyPath, __rlmArray, self);
+    RLMEnsureArrayObservationInfo(_observationInfo, keyPath, self._rlmArray, self);
     [super addObserver:observer forKeyPath:keyPath options:options context:context];
 }
 
+// defined within the implementation for access to the ivars
+void RLMListBaseSetParent(__unsafe_unretained RLMListBase *const list,
+                          __unsafe_unretained RLMObjectBase *const parent,
+                          __unsafe_unretained RLMProperty *const property) {
+    list->__rlmArray = nil;
+    list->_parentRow = parent->_row;
+    list->_parentRealm = parent->_realm;
+    list->_parentInfo = parent->_info;
+    list->_property = property;
+}
+
 @end
@@ -65,6 +65,12 @@ typedef void (^RLMObjectMigrationBlock)(RLMObject * __nullable oldObject, RLMObj
  Enumerates all the objects of a given type in the Realm, providing both the old and new versions
  of each object. Within the block, object properties can only be accessed using keyed subscripting.
 
+ The cost of a migration is proportional to the number of objects enumerated, so only classes whose
+ data actually needs to be converted should be enumerated. Properties which are added or removed are
+ updated automatically without visiting each object, and properties which are populated from a single
+ old property can use the faster `-copyValuesFromOldProperty:toProperty:inClass:` and
+ `-transformProperty:inClass:fromOldProperty:usingBlock:` instead.
+
  @param className   The name of the `RLMObject` class to enumerate.
 
  @warning   All objects returned are of a type specific to the current migration and should not be cast
@@ -73,6 +79,45 @@ typedef void (^RLMObjectMigrationBlock)(RLMObject * __nullable oldObject, RLMObj
  */
 - (void)enumerateObjects:(NSString *)className block:(__attribute__((noescape)) RLMObjectMigrationBlock)block;
 
+/**
+ Sets a property of every object of a given type to a value computed from a property of the old version of
+ the object.
+
+ This is equivalent to setting `newObject[propertyName]` to the result of calling the block with
+ `oldObject[oldPropertyName]` for each object in `-enumerateObjects:block:`, but is much faster as no
+ `RLMObject`s are created to read and write the values. Objects which have been deleted with
+ `-deleteObject:` are skipped. If the property is the primary key, an exception is thrown when two of the
+ remaining objects would have the same value.
+
+ @param propertyName    The name of the property to set in the new schema.
+ @param className       The name of the class to update. This class must be present in both the old and
+                        new Realm schemas.
+ @param oldPropertyName The name of the property in the old schema whose value is passed to the block.
+ @param block           The block which computes the new value of the property from the old value. The
+                        value it returns must be valid for the property in the new schema.
+ */
+- (void)transformProperty:(NSString *)propertyName
+                  inClass:(NSString *)className
+          fromOldProperty:(NSString *)oldPropertyName
+               usingBlock:(__attribute__((noescape)) id _Nullable (^)(id _Nullable oldValue))block;
+
+/**
+ Copies the value of a property in the old version of every object of a given type to a property in the new version.
+
+ When both properties are of the same type, the values are copied directly between the underlying columns,
+ unless the new property is the primary key, whose values are checked for uniqueness as they're copied.
+ Otherwise each value must be valid for the new property, such as when copying an integer property to a
+ floating-point one. Objects which have been deleted with `-deleteObject:` are skipped.
+
+ @param oldPropertyName The name of the property in the old schema to copy the values from.
+ @param propertyName    The name of the property in the new schema to copy the values to.
+ @param className       The name of the class to update. This class must be present in both the old and
+                        new Realm schemas.
+ */
+- (void)copyValuesFromOldProperty:(NSString *)oldPropertyName
+                       toProperty:(NSString *)propertyName
+                          inClass:(NSString *)className;
+
 /**
  Creates and returns an `RLMObject` instance of type `className` in the Realm being migrated.
  
@@ -54,9 +54,43 @@ using namespace realm;
 }
 @end
 
+// Reports the progress of an operation over the objects of a class to the
+// migration's progress block every c_progressReportInterval objects, and once
+// more when the operation completes
+namespace {
+class RLMMigrationProgress {
+public:
+    RLMMigrationProgress(RLMMigrationProgressBlock block, NSString *className, size_t total)
+    : m_block(block), m_className(className), m_total(total) { }
+
+    void advance() {
+        if (m_block && ++m_processed % c_progressReportInterval == 0 && m_processed < m_total) {
+            m_block(m_className, m_processed, m_total);
+        }
+    }
+
+    void finish() {
+        if (m_block) {
+            m_block(m_className, m_total, m_total);
+        }
+    }
+
+private:
+    static const size_t c_progressReportInterval = 1000;
+
+    RLMMigrationProgressBlock m_block;
+    NSString *m_className;
+    size_t m_total;
+    size_t m_processed = 0;
+};
+}
+
 @implementation RLMMigration {
     realm::Schema *_schema;
-    NSMutableDictionary *deletedObjectIndices;
+    // Row indices of the objects of each type which have been deleted. The
+    // deletions are deferred until the end of the migration so that the rows
+    // of the old and new tables continue to line up during enumeration.
+    NSMutableDictionary<NSString *, NSMutableIndexSet *> *deletedObjectIndices;
 }
 
 - (instancetype)initWithRealm:(RLMRealm *)realm oldRealm:(RLMRealm *)oldRealm schema:(realm::Schema &)schema {
@@ -79,45 +113,57 @@ using namespace realm;
     return self.realm.schema;
 }
 
-- (void)enumerateObjects:(NSString *)className block:(RLMObjectMigrationBlock)block {
-    // get all objects
-    RLMResults *objects = [_realm.schema schemaForClassName:className] ? [_realm allObjects:className] : nil;
-    RLMResults *oldObjects = [_oldRealm.schema schemaForClassName:className] ? [_oldRealm allObjects:className] : nil;
-
-    if (objects && oldObjects) {
-        NSArray *deletedObjects = deletedObjectIndices[className];
-        if (!deletedObjects) {
-            deletedObjects = [NSMutableArray array];
-            deletedObjectIndices[className] = deletedObjects;
-        }
-
-        for (long i = oldObjects.count - 1; i >= 0; i--) {
-            @autoreleasepool {
-                if ([deletedObjects containsObject:@(i)]) {
-                    continue;
-                }
-                block(oldObjects[i], objects[i]);
-            }
-        }
+- (NSMutableIndexSet *)deletedObjectIndicesForClassName:(NSString *)className {
+    NSMutableIndexSet *indices = deletedObjectIndices[className];
+    if (!indices) {
+        indices = [NSMutableIndexSet indexSet];
+        deletedObjectIndices[className] = indices;
     }
-    else if (objects) {
-        for (long i = objects.count - 1; i >= 0; i--) {
-            @autoreleasepool {
-                block(nil, objects[i]);
-            }
-        }
+    return indices;
+}
+
+- (void)enumerateObjects:(NSString *)className block:(RLMObjectMigrationBlock)block {
+    // Accessors are created directly for each row of the tables rather than
+    // going through RLMResults, as new objects created in the block are
+    // appended to the table and so don't affect the indices of existing ones
+    RLMClassInfo *info = [_realm.schema schemaForClassName:className] ? &_realm->_info[className] : nullptr;
+    RLMClassInfo *oldInfo = [_oldRealm.schema schemaForClassName:className] ? &_oldRealm->_info[className] : nullptr;
+    if (!info && !oldInfo) {
+        return;
     }
-    else if (oldObjects) {
-        for (long i = oldObjects.count - 1; i >= 0; i--) {
-            @autoreleasepool {
-                block(oldObjects[i], nil);
+
+    size_t count = (oldInfo ?: info)->table()->size();
+    NSIndexSet *deletedObjects = info && oldInfo ? [self deletedObjectIndicesForClassName:className] : nil;
+    RLMMigrationProgress progress(_progressBlock, className, count);
+    for (size_t i = count; i > 0; --i) {
+        @autoreleasepool {
+            if (![deletedObjects containsIndex:i - 1]) {
+                block(oldInfo ? (RLMObject *)RLMCreateObjectAccessor(_oldRealm, *oldInfo, i - 1) : nil,
+                      info ? (RLMObject *)RLMCreateObjectAccessor(_realm, *info, i - 1) : nil);
             }
+            progress.advance();
         }
     }
+    progress.finish();
 }
 
 - (void)execute:(RLMMigrationBlock)block {
     @autoreleasepool {
+        RLMSignpost signpost(RLMSignpostName::Migration, [&] {
+            return [NSString stringWithFormat:@"%@: version %llu to %llu",
+                    @(_realm->_realm->config().path.c_str()).lastPathComponent,
+                    _oldRealm->_realm->schema_version(), _realm->_realm->config().schema_version];
+        });
+        if (signpost.active()) {
+            size_t rows = 0;
+            for (RLMObjectSchema *objectSchema in _oldRealm.schema.objectSchema) {
+                if (auto table = ObjectStore::table_for_object_type(_oldRealm.group, objectSchema.className.UTF8String)) {
+                    rows += table->size();
+                }
+            }
+            signpost.setRowCount(rows);
+        }
+
         // disable all primary keys for migration and use DynamicObject for all types
         for (RLMObjectSchema *objectSchema in _realm.schema.objectSchema) {
             objectSchema.accessorClass = RLMDynamicObject.class;
@@ -144,17 +190,160 @@ using namespace realm;
 }
 
 - (void)deleteObject:(RLMObject *)object {
-    [deletedObjectIndices[object.objectSchema.className] addObject:@(object->_row.get_index())];
+    [[self deletedObjectIndicesForClassName:object.objectSchema.className] addIndex:object->_row.get_index()];
 }
 
 - (void)deleteObjectsMarkedForDeletion {
-    for (NSString *className in deletedObjectIndices.allKeys) {
-        RLMResults *objects = [_realm allObjects:className];
-        for (NSNumber *index in deletedObjectIndices[className]) {
-            RLMObject *object = objects[index.longValue];
-            [_realm deleteObject:object];
+    for (NSString *className in deletedObjectIndices) {
+        RLMClassInfo *info = &_realm->_info[className];
+        // Deleting a row moves the last row of the table into its place, so
+        // delete from the end to avoid invalidating the indices still to go
+        [deletedObjectIndices[className] enumerateIndexesWithOptions:NSEnumerationReverse
+                                                          usingBlock:^(NSUInteger index, BOOL *) {
+            RLMDeleteObjectFromRealm(RLMCreateObjectAccessor(_realm, *info, index), _realm);
+        }];
+    }
+}
+
+// Copy the values of a column of the old table to a column of the same type in
+// the new table, skipping the given rows
+static void RLMCopyColumn(Table& from, size_t fromCol, Table& to, size_t toCol,
+                          RLMPropertyType type, NSIndexSet *skip, RLMMigrationProgress& progress,
+                          NSString *(^describe)()) {
+    bool fromNullable = from.is_nullable(fromCol);
+    bool toNullable = to.is_nullable(toCol);
+    for (size_t row = 0, count = from.size(); row < count; ++row) {
+        progress.advance();
+        if ([skip containsIndex:row]) {
+            continue;
+        }
+        if (fromNullable && from.is_null(fromCol, row)) {
+            if (!toNullable) {
+                @throw RLMException(@"Cannot copy nil value of %@ into required property", describe());
+            }
+            to.set_null(toCol, row);
+            continue;
+        }
+        switch (type) {
+            case RLMPropertyTypeInt:    to.set_int(toCol, row, from.get_int(fromCol, row)); break;
+            case RLMPropertyTypeFloat:  to.set_float(toCol, row, from.get_float(fromCol, row)); break;
+            case RLMPropertyTypeDouble: to.set_double(toCol, row, from.get_double(fromCol, row)); break;
+            case RLMPropertyTypeBool:   to.set_bool(toCol, row, from.get_bool(fromCol, row)); break;
+            case RLMPropertyTypeString: to.set_string(toCol, row, from.get_string(fromCol, row)); break;
+            case RLMPropertyTypeDate:   to.set_timestamp(toCol, row, from.get_timestamp(fromCol, row)); break;
+            case RLMPropertyTypeData:   to.set_binary(toCol, row, from.get_binary(fromCol, row)); break;
+            default: REALM_UNREACHABLE();
+        }
+    }
+}
+
+static bool RLMCanCopyColumn(RLMProperty *from, RLMProperty *to, bool toPrimaryKey) {
+    // The values copied into a primary key have to be checked for uniqueness
+    if (from.type != to.type || toPrimaryKey || to.foldedPropertyName || to.hasComputedProperties) {
+        return false;
+    }
+    // The values copied into a vector property have to be checked for the
+    // right length, which the setter does, unless they're already vectors of
+    // the same dimension
+    if (to.vectorDimension != from.vectorDimension) {
+        return false;
+    }
+    switch (to.type) {
+        case RLMPropertyTypeInt:
+        case RLMPropertyTypeFloat:
+        case RLMPropertyTypeDouble:
+        case RLMPropertyTypeBool:
+        case RLMPropertyTypeString:
+        case RLMPropertyTypeDate:
+        case RLMPropertyTypeData:
+            return true;
+        default:
+            return false;
+    }
+}
+
+- (void)updateProperty:(NSString *)propertyName inClass:(NSString *)className
+       fromOldProperty:(NSString *)oldPropertyName
+             transform:(id (^)(id))block {
+    RLMObjectSchema *objectSchema = [_realm.schema schemaForClassName:className];
+    RLMObjectSchema *oldObjectSchema = [_oldRealm.schema schemaForClassName:className];
+    if (!objectSchema || !oldObjectSchema) {
+        @throw RLMException(@"Class '%@' must be present in both the old and new schemas.", className);
+    }
+    RLMProperty *prop = objectSchema[propertyName];
+    if (!prop) {
+        @throw RLMException(@"Invalid property name '%@' for class '%@'.", propertyName, className);
+    }
+    RLMProperty *oldProp = oldObjectSchema[oldPropertyName];
+    if (!oldProp) {
+        @throw RLMException(@"Invalid property name '%@' for class '%@' in the old schema.", oldPropertyName, className);
+    }
+    if (prop.type == RLMPropertyTypeLinkingObjects || prop.isFolded) {
+        @throw RLMException(@"Property '%@' of class '%@' cannot be set.", propertyName, className);
+    }
+
+    RLMClassInfo& info = _realm->_info[className];
+    RLMClassInfo& oldInfo = _oldRealm->_info[className];
+    NSIndexSet *deleted = [self deletedObjectIndicesForClassName:className];
+    size_t count = oldInfo.table()->size();
+    RLMMigrationProgress progress(_progressBlock, className, count);
+
+    // Primary keys are turned off for the migration, so the property isn't
+    // marked as one, but its values still have to be unique when it ends
+    bool isPrimaryKey = [objectSchema.primaryKeyProperty.name isEqualToString:propertyName];
+    if (!block && RLMCanCopyColumn(oldProp, prop, isPrimaryKey)) {
+        RLMCopyColumn(*oldInfo.table(), oldInfo.tableColumn(oldProp),
+                      *info.table(), info.tableColumn(prop), prop.type, deleted, progress, ^{
+            return [NSString stringWithFormat:@"'%@.%@'", className, oldPropertyName];
+        });
+        progress.finish();
+        return;
+    }
+
+    // A single accessor for each of the old and new tables is pointed at each
+    // row in turn rather than creating two new objects per row
+    if (count == 0) {
+        progress.finish();
+        return;
+    }
+    RLMObjectBase *oldObject = RLMCreateObjectAccessor(_oldRealm, oldInfo, 0);
+    RLMObjectBase *newObject = RLMCreateObjectAccessor(_realm, info, 0);
+    NSMutableSet *primaryKeys = isPrimaryKey ? [NSMutableSet setWithCapacity:count] : nil;
+    for (size_t row = 0; row < count; ++row) {
+        @autoreleasepool {
+            progress.advance();
+            if ([deleted containsIndex:row]) {
+                continue;
+            }
+            oldObject->_row = (*oldInfo.table())[row];
+            newObject->_row = (*info.table())[row];
+            id value = RLMDynamicGet(oldObject, oldProp);
+            if (block) {
+                value = block(value);
+            }
+            if (primaryKeys) {
+                id key = RLMCoerceToNil(value) ?: NSNull.null;
+                if ([primaryKeys containsObject:key]) {
+                    @throw RLMException(@"Primary key property '%@.%@' cannot be set to the duplicate value '%@'.",
+                                        className, propertyName, RLMCoerceToNil(value));
+                }
+                [primaryKeys addObject:key];
+            }
+            RLMDynamicValidatedSetByIndex(newObject, prop.index, value);
         }
     }
+    progress.finish();
+}
+
+- (void)transformProperty:(NSString *)propertyName inClass:(NSString *)className
+          fromOldProperty:(NSString *)oldPropertyName
+               usingBlock:(id (^)(id))block {
+    [self updateProperty:propertyName inClass:className fromOldProperty:oldPropertyName transform:block];
+}
+
+- (void)copyValuesFromOldProperty:(NSString *)oldPropertyName toProperty:(NSString *)propertyName
+                          inClass:(NSString *)className {
+    [self updateProperty:propertyName inClass:className fromOldProperty:oldPropertyName transform:nil];
 }
 
 - (BOOL)deleteDataForClassName:(NSString *)name {
@@ -20,6 +20,7 @@
 
 #import "RLMRealmConfiguration.h"
 #import "RLMSyncErrorResponseModel.h"
+#import "RLMSyncManager_Private.h"
 #import "RLMSyncUtil_Private.h"
 
 typedef void(^RLMServerURLSessionCompletionBlock)(NSData *, NSURLResponse *, NSError *);
@@ -41,7 +42,7 @@ static NSRange RLM_rangeForErrorType(RLMServerHTTPErrorCodeType type) {
 @implementation RLMNetworkClient
 
 + (NSURLSession *)session {
-    return [NSURLSession sharedSession];
+    return [RLMSyncManager sharedManager]._authSession;
 }
 
 + (NSURL *)urlForServer:(NSURL *)serverURL endpoint:(RLMServerEndpoint)endpoint {
@@ -29,6 +29,7 @@ NS_ASSUME_NONNULL_BEGIN
 @class RLMPropertyDescriptor;
 @class RLMRealm;
 @class RLMResults;
+@class RLMSortDescriptor;
 
 /**
  `RLMObject` is a base class for model objects representing data stored in Realms.
@@ -52,7 +53,8 @@ NS_ASSUME_NONNULL_BEGIN
  - `NSInteger`, `int`, `long`, `float`, and `double`
  - `BOOL` or `bool`
  - `NSDate`
- - `NSData`
+ - `NSData`, of up to 16MB; larger values, such as attachments, should be stored in separate files with
+   their paths stored in the object
  - `NSNumber<X>`, where `X` is one of `RLMInt`, `RLMFloat`, `RLMDouble` or `RLMBool`, for optional number properties
  - `RLMObject` subclasses, to model many-to-one relationships.
  - `RLMArray<X>`, where `X` is an `RLMObject` subclass, to model many-to-many relationships.
@@ -224,6 +226,33 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (instancetype)createOrUpdateInRealm:(RLMRealm *)realm withValue:(id)value;
 
+/**
+ Creates or updates an Realm object within the default Realm, only writing the properties which have changed.
+
+ This behaves the same as `createOrUpdateInDefaultRealmWithValue:`, except that when updating an existing object,
+ properties whose current value is equal to the supplied value are not written. Unchanged properties then do not
+ produce KVO or collection notifications and do not add to the size of the write transaction.
+
+ @param value    The value used to populate the object.
+
+ @see   `createOrUpdateInDefaultRealmWithValue:`
+ */
++ (instancetype)createOrUpdateModifiedInDefaultRealmWithValue:(id)value;
+
+/**
+ Creates or updates an Realm object within a specified Realm, only writing the properties which have changed.
+
+ This behaves the same as `createOrUpdateInRealm:withValue:`, except that when updating an existing object,
+ properties whose current value is equal to the supplied value are not written. Unchanged properties then do not
+ produce KVO or collection notifications and do not add to the size of the write transaction.
+
+ @param realm    The Realm which should own the object.
+ @param value    The value used to populate the object.
+
+ @see   `createOrUpdateInRealm:withValue:`
+ */
++ (instancetype)createOrUpdateModifiedInRealm:(RLMRealm *)realm withValue:(id)value;
+
 #pragma mark - Properties
 
 /**
@@ -256,6 +285,170 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (NSArray<NSString *> *)indexedProperties;
 
+/**
+ Returns an array of property names for properties which should be indexed, but whose indexes should be built in the
+ background rather than when the Realm is opened.
+
+ Building an index on a table which already holds many objects can take a long time, and opening a Realm builds any
+ indexes which are missing from it. The indexes of properties listed here are instead built on a background queue
+ after the Realm has been opened, in a write transaction of their own. Queries on the property work while the index
+ is being built, and use it once it has been. If building an index in the background fails, it's built when the Realm
+ is next opened in the same process instead, and opening the Realm reports the error if it fails again.
+
+ Indexes of new classes, and of Realms which are opened read-only or are synchronized, are built as usual.
+
+ Only string, integer, boolean, and `NSDate` properties are supported.
+
+ @return    An array of property names.
+ */
++ (NSArray<NSString *> *)deferredIndexedProperties;
+
+/**
+ Returns a dictionary mapping the names of string properties to the names of properties which should hold a case- and
+ diacritic-folded copy of their values.
+
+ The folded properties must be optional string properties. They are indexed, and are updated automatically whenever
+ the property they are a copy of is set; they cannot be set directly. Queries which compare a property with a folded
+ copy using `==[cd]`, `!=[cd]`, `BEGINSWITH[cd]`, `ENDSWITH[cd]` or `CONTAINS[cd]` are performed on the folded copy,
+ which lets equality comparisons use its index.
+
+ Values of objects which existed before a folded copy was added to the schema are not filled in automatically, and
+ should be set in a migration by reassigning the original property.
+
+ @return    A dictionary mapping property names to the names of the properties holding their folded copies.
+ */
++ (NSDictionary<NSString *, NSString *> *)foldedIndexedProperties;
+
+/**
+ Returns an array of the names of string properties which have only a few distinct values, such as a status or a
+ country code.
+
+ Reading one of these properties returns the same `NSString` instance for each distinct value, rather than creating a
+ new string for every object read. Each `RLMRealm` instance keeps up to 1024 distinct values of each property.
+
+ When the schema of the Realm file is created or changed, including by a migration, the string columns of classes with
+ interned properties are converted to store a list of their distinct values and an index into it for each object,
+ if that makes them smaller, which makes equality queries on them faster.
+
+ @return    An array of property names.
+ */
++ (NSArray<NSString *> *)internedStringProperties;
+
+/**
+ Returns a dictionary mapping the names of string properties to the names of the properties whose combined values they
+ should hold, forming a compound index over those properties.
+
+ The key properties must be optional string properties. They are indexed, and are updated automatically whenever any
+ of the properties they combine is set; they cannot be set directly. Queries which compare each of the properties of a
+ compound index for equality with a value in a single `AND` group, such as `accountId == %@ AND deleted == NO`, are
+ performed as a single comparison with the key property, which finds the matching objects with one index lookup.
+
+ Only non-primary-key string, integer, boolean, and `NSDate` properties can be part of a compound index, and each
+ compound index must combine at least two properties.
+
+ Values of objects which existed before a compound index was added to the schema are not filled in automatically, and
+ should be set in a migration by reassigning one of the properties it combines.
+
+ @return    A dictionary mapping property names to the names of the properties they combine.
+ */
++ (NSDictionary<NSString *, NSArray<NSString *> *> *)compoundIndexes;
+
+/**
+ Returns a dictionary mapping the names of integer properties to the names of a latitude and a longitude property, in
+ that order, forming a geo index over the locations they describe.
+
+ The key properties must be optional integer properties. They are indexed, and hold the cell of a grid over the
+ surface of the Earth which contains the location; they are updated automatically whenever the latitude or longitude
+ is set, and cannot be set directly. Queries which bound both the latitude and the longitude of a geo index in a single
+ `AND` group, such as `lat BETWEEN {%@, %@} AND lng BETWEEN {%@, %@}`, first find the objects in the cells overlapping
+ the bounding box with a few range lookups, and only compare the coordinates of those objects. The index is also used
+ by `-[RLMResults objectsWithinDistance:ofLatitude:longitude:geoIndex:]`.
+
+ The latitude and longitude must be non-primary-key `double` properties, in degrees. Objects with a null latitude or
+ longitude have a null key and are never matched by a bounding box.
+
+ Values of objects which existed before a geo index was added to the schema are not filled in automatically, and
+ should be set in a migration by reassigning the latitude or longitude.
+
+ @return    A dictionary mapping property names to the names of the latitude and longitude properties they index.
+ */
++ (NSDictionary<NSString *, NSArray<NSString *> *> *)geoIndexes;
+
+/**
+ Returns a dictionary mapping the names of string properties to the names of the string properties they hold the
+ collation keys of.
+
+ The key properties must be optional string properties. They are updated automatically whenever the property they're
+ the key of is set, and cannot be set directly. Each key is the case-, diacritic- and width-folded form of the string
+ in the locale returned by `+collationLocaleIdentifier`, with numbers ordered by their value, so sorting by a key
+ orders the strings much like `-[NSString localizedStandardCompare:]` would while still being done by the database.
+ Sorting by a property which has a collation key uses the key, so sorted `RLMResults` order names correctly and stay
+ live; strings whose keys are equal, such as `"Résumé"` and `"resume"`, are in no particular order relative to each
+ other.
+
+ Values of objects which existed before a collation key was added to the schema are not filled in automatically, and
+ should be set in a migration by reassigning the property they're the key of.
+
+ @return    A dictionary mapping property names to the names of the properties they hold the collation keys of.
+ */
++ (NSDictionary<NSString *, NSString *> *)collationKeys;
+
+/**
+ Override this method to specify the identifier of the locale the keys listed in `+collationKeys` are folded in.
+
+ The keys are persisted, so changing the locale only affects the keys of the strings which are set afterwards. The
+ default implementation returns `nil`, which folds the keys without any locale.
+
+ @return    The identifier of a locale, or `nil`.
+ */
++ (nullable NSString *)collationLocaleIdentifier;
+
+/**
+ Returns a dictionary mapping the names of derived properties to the names of the properties they're computed from.
+
+ The value of a derived property is computed by `-valueForDerivedProperty:` and persisted whenever an object is
+ created or one of the properties it's computed from is set, so it can be indexed with `+indexedProperties` and be
+ queried and sorted on like any other property, without recomputing it for each object. Derived properties must be
+ `int`, `bool`, `float`, `double`, `string` or `date` properties, cannot be set directly, and cannot be computed from
+ array, linking objects or other derived properties. They may be computed from to-one relationships, but are only
+ recomputed when the relationship itself is set, not when the linked object changes.
+
+ Values of objects which existed before a derived property was added to the schema are not filled in automatically,
+ and should be set in a migration by reassigning one of the properties they're computed from.
+
+ @return    A dictionary mapping property names to the names of the properties they're computed from.
+ */
++ (NSDictionary<NSString *, NSArray<NSString *> *> *)derivedProperties;
+
+/**
+ Returns a dictionary mapping the names of `NSData` properties which hold vectors of 32-bit floats, such as
+ embeddings, to the number of floats in each vector.
+
+ The property can only be set to `nil`, if it's optional, or to data holding exactly that many floats in the host's
+ byte order. Objects can then be searched for the vectors nearest to a given one with
+ `-[RLMResults objectsNearestToVector:forProperty:limit:metric:]`, which reads the vectors directly from the Realm file
+ rather than copying each of them into an `NSData`.
+
+ @return    A dictionary mapping property names to the number of floats in their vectors.
+ */
++ (NSDictionary<NSString *, NSNumber *> *)vectorProperties;
+
+/**
+ Override this method to specify the name of an `NSDate` property holding the date at which each object expires.
+
+ Expired objects are deleted in the background in small write transactions, which are reported to notification blocks
+ and KVO observers like any other change. Purging starts when the Realm file is first opened and after each write
+ transaction which is committed while no purge is in progress, and is repeated at the earliest remaining expiration
+ date while the Realm is open. Objects whose expiration date is `nil` never expire. Objects which have expired but not
+ yet been purged can still be read and are still matched by queries.
+
+ The property is indexed automatically, and finding the expired objects uses the index rather than reading the
+ expiration date of every object. The property must be a non-primary-key `NSDate` property.
+
+ @return    The name of the property holding the expiration date.
+ */
++ (nullable NSString *)expirationProperty;
+
 /**
  Override this method to specify the default values to be used for each property.
 
@@ -263,6 +456,24 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (nullable NSDictionary *)defaultPropertyValues;
 
+/**
+ Override this method to return `YES` if `defaultPropertyValues` always returns the same values.
+
+ By default the default values are computed separately for each object created, so that values generated for each
+ object, such as a new unique identifier or the current date, aren't shared between objects. Default values declared
+ static are instead computed once per Realm instance and then reused for every object created in that Realm. If they
+ change, call `invalidateCachedDefaultPropertyValues` after they do.
+
+ @return    Whether the default values of this class can be cached.
+ */
++ (BOOL)hasStaticDefaultPropertyValues;
+
+/**
+ Discards the cached default property values of all Realm object types which declare them static, so that
+ `defaultPropertyValues` is called again the next time a default value is needed.
+ */
++ (void)invalidateCachedDefaultPropertyValues;
+
 /**
  Override this method to specify the name of a property to be used as the primary key.
 
@@ -356,6 +567,20 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (nullable instancetype)objectForPrimaryKey:(nullable id)primaryKey;
 
+/**
+ Retrieves the instances of this object type with the given primary keys from the default Realm.
+
+ Returns the objects which have the given primary keys, in the order of the keys, skipping keys which no object has.
+
+ This method requires that `primaryKey` be overridden on the receiving subclass.
+
+ @param primaryKeys The primary keys of the objects to retrieve.
+
+ @return    An array of the objects of this object type with the given primary keys.
+ @see       `-primaryKey`
+ */
++ (NSArray *)objectsForPrimaryKeys:(id<NSFastEnumeration>)primaryKeys;
+
 
 #pragma mark - Querying Specific Realms
 
@@ -391,6 +616,29 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (RLMResults *)objectsInRealm:(RLMRealm *)realm withPredicate:(nullable NSPredicate *)predicate;
 
+/**
+ Returns all objects of this object type matching the given predicate from each
+ of the specified Realms, such as the shards of a dataset split across several
+ files with `-[RLMRealmConfiguration configurationForShard:]`.
+
+ The objects from each Realm are sorted using the sort descriptors, and then
+ merged without sorting them all again, so that the array is in the same order
+ as if all of the objects were in one Realm. Objects which sort the same are
+ ordered by the Realm they are in, in the order of `realms`. If there are no
+ sort descriptors the objects from each Realm follow those from the one before.
+
+ Unlike `RLMResults`, the array is not updated when the Realms change.
+
+ @param realms          The Realms to query, which must all be on the current thread.
+ @param predicate       A predicate to use to filter the elements.
+ @param sortDescriptors The sort descriptors to order the objects by.
+
+ @return    An array of the objects of this type in all the given Realms that match the given predicate.
+ */
++ (NSArray *)objectsInRealms:(NSArray<RLMRealm *> *)realms
+               withPredicate:(nullable NSPredicate *)predicate
+             sortDescriptors:(NSArray<RLMSortDescriptor *> *)sortDescriptors;
+
 /**
  Retrieves the single instance of this object type with the given primary key from the specified Realm.
 
@@ -405,6 +653,26 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (nullable instancetype)objectInRealm:(RLMRealm *)realm forPrimaryKey:(nullable id)primaryKey;
 
+/**
+ Retrieves the instances of this object type with the given primary keys from the specified Realm.
+
+ Returns the objects which have the given primary keys, in the order of the keys, skipping keys which no object has.
+ This is equivalent to calling `objectInRealm:forPrimaryKey:` for each key, but validates the class and the Realm only
+ once.
+
+ Objects found by primary key are remembered until the Realm is refreshed or a write transaction begins, so that
+ looking up the same keys again doesn't search for them.
+
+ This method requires that `primaryKey` be overridden on the receiving subclass.
+
+ @param realm       The Realm to look the objects up in.
+ @param primaryKeys The primary keys of the objects to retrieve.
+
+ @return    An array of the objects of this object type with the given primary keys.
+ @see       `-primaryKey`
+ */
++ (NSArray *)objectsInRealm:(RLMRealm *)realm forPrimaryKeys:(id<NSFastEnumeration>)primaryKeys;
+
 #pragma mark - Notifications
 
 /**
@@ -433,12 +701,17 @@ typedef void (^RLMObjectChangeBlock)(BOOL deleted,
  deletes the object or modifies any of the managed properties of the object,
  including self-assignments that set a property to its existing value.
 
- For write transactions performed on different threads or in differen
+ For write transactions performed on different threads or in different
  processes, the block will be called when the managing Realm is
  (auto)refreshed to a version including the changes, while for local write
  transactions it will be called at some point in the future after the write
  transaction is committed.
 
+ The changes are computed on a background thread in the same way as for
+ collection notifications, and do not use key-value observing. Observing an
+ object this way does not add work to writes or to refreshing the Realm on
+ the observing thread, which KVO observation of a managed object does.
+
  Notifications are delivered via the standard run loop, and so can't be
  delivered while the run loop is blocked by other activity. When notifications
  can't be delivered instantly, multiple notifications may be coalesced into a
@@ -478,6 +751,109 @@ typedef void (^RLMObjectChangeBlock)(BOOL deleted,
  */
 - (BOOL)isEqualToObject:(RLMObject *)object;
 
+/**
+ Calls the given block with a pointer to the contents of a binary data property.
+
+ For managed objects the pointer refers directly to the data in the Realm file,
+ so no copy of the data is made. The pointer is only valid until the block
+ returns, and the Realm must not be written to or refreshed from within the
+ block. `bytes` is `NULL` if the property is `nil`.
+
+ @param propertyName    The name of an `NSData` property of the receiver.
+ @param block           The block to call with the property's contents.
+ */
+- (void)withBinaryProperty:(NSString *)propertyName
+                     block:(NS_NOESCAPE void (^)(const void * _Nullable bytes, NSUInteger length))block;
+
+/**
+ Copies the values of several properties of the object into a dictionary.
+
+ This is equivalent to calling `valueForKey:` for each property, but reads all
+ of the values in one pass, which is much faster for managed objects when
+ reading many properties at once, such as when serializing an object.
+ `dictionaryWithValuesForKeys:` uses this when all of its keys are properties
+ of the object.
+
+ @param propertyNames   The names of the properties to read.
+ @param values          The dictionary to add the values to, keyed by property
+                        name. `nil` values are stored as `NSNull`.
+ */
+- (void)copyValuesForProperties:(NSArray<NSString *> *)propertyNames
+                           into:(NSMutableDictionary<NSString *, id> *)values;
+
+/**
+ Returns the number of objects linking to the object through a linking objects
+ property.
+
+ This is equivalent to reading the `count` of the property, but reads the
+ number of links directly rather than creating an `RLMLinkingObjects`. To
+ filter objects by the number of objects linking to them, compare the
+ property's `@count` in a predicate, such as `parents.@count > 1`, which is
+ also evaluated from the number of links.
+
+ Unmanaged objects have no linking objects, and this returns 0 for them.
+
+ @param propertyName    The name of an `RLMLinkingObjects` property of the receiver.
+
+ @return    The number of objects linking to the receiver.
+ */
+- (NSUInteger)linkingObjectsCountForProperty:(NSString *)propertyName;
+
+/**
+ Adds an amount to the value of an integer property.
+
+ This is equivalent to setting the property to its current value plus
+ `amount`, but adds to the stored value directly rather than reading it and
+ writing the sum, and so is cheaper for counters such as unread counts. When
+ the Realm is synchronized, the change is recorded as an addition rather than
+ as a new value, so increments made concurrently on different devices are all
+ kept rather than only the last one being.
+
+ @warning For managed objects, this method may only be called during a write
+          transaction.
+
+ @param propertyName    The name of a non-primary-key `int` property whose
+                        value is not `nil`.
+ @param amount          The amount to add, which may be negative.
+ */
+- (void)incrementProperty:(NSString *)propertyName by:(NSInteger)amount;
+
+/**
+ Override this method to compute the values of the properties listed in `+derivedProperties`.
+
+ This is called within the write transaction which sets the properties the derived property is computed from, after
+ they have been set, and should only read the receiver's properties. The default implementation throws an exception.
+
+ @param propertyName    The name of the derived property to compute.
+
+ @return    The value of the property, which must be valid for its type, or `nil` for an optional property.
+ */
+- (nullable id)valueForDerivedProperty:(NSString *)propertyName;
+
+/**
+ Returns an unmanaged copy of the object, along with copies of all of the
+ objects it links to, directly or indirectly.
+
+ The copy is a snapshot of the object's current values which is not
+ confined to the thread the object was read on: once created, it can be read
+ from any thread, and it is unaffected by later changes to the Realm and by
+ the Realm being refreshed or closed. Each object reachable from the receiver
+ is copied once, even if it is linked to from several places, so cycles of
+ links are preserved among the copies. Linking objects properties of the
+ copies are empty.
+
+ Detached copies are intended to be read, not modified; if they are modified,
+ they must not be read from other threads at the same time. Making a detached
+ copy reads every object reachable from the receiver, which can be expensive
+ for large graphs of objects.
+
+ @warning This method can only be called on a managed object, and not on an
+          object read from a dynamic Realm.
+
+ @return An unmanaged copy of the object.
+ */
+- (instancetype)detachedCopy;
+
 #pragma mark - Dynamic Accessors
 
 /// :nodoc:
@@ -20,11 +20,13 @@
 
 #import "RLMAccessor.h"
 #import "RLMArray.h"
+#import "RLMClassInfo.hpp"
 #import "RLMCollection_Private.hpp"
 #import "RLMObjectSchema_Private.hpp"
 #import "RLMObjectStore.h"
 #import "RLMProperty.h"
 #import "RLMQueryUtil.hpp"
+#import "RLMRealmUtil.hpp"
 #import "RLMRealm_Private.hpp"
 #import "RLMSchema_Private.h"
 
@@ -73,11 +75,11 @@
 #pragma mark - Class-based Object Creation
 
 + (instancetype)createInDefaultRealmWithValue:(id)value {
-    return (RLMObject *)RLMCreateObjectInRealmWithValue([RLMRealm defaultRealm], [self className], value, false);
+    return (RLMObject *)RLMCreateObjectInRealmWithValue([RLMRealm defaultRealm], [self sharedSchema], value, RLMCreationOptionsNone);
 }
 
 + (instancetype)createInRealm:(RLMRealm *)realm withValue:(id)value {
-    return (RLMObject *)RLMCreateObjectInRealmWithValue(realm, [self className], value, false);
+    return (RLMObject *)RLMCreateObjectInRealmWithValue(realm, [self sharedSchema], value, RLMCreationOptionsNone);
 }
 
 + (instancetype)createOrUpdateInDefaultRealmWithValue:(id)value {
@@ -85,13 +87,26 @@
 }
 
 + (instancetype)createOrUpdateInRealm:(RLMRealm *)realm withValue:(id)value {
+    return [self createOrUpdateInRealm:realm withValue:value options:RLMCreationOptionsCreateOrUpdate];
+}
+
++ (instancetype)createOrUpdateModifiedInDefaultRealmWithValue:(id)value {
+    return [self createOrUpdateModifiedInRealm:[RLMRealm defaultRealm] withValue:value];
+}
+
++ (instancetype)createOrUpdateModifiedInRealm:(RLMRealm *)realm withValue:(id)value {
+    return [self createOrUpdateInRealm:realm withValue:value
+                               options:RLMCreationOptionsCreateOrUpdate | RLMCreationOptionsUpdateChangedOnly];
+}
+
++ (instancetype)createOrUpdateInRealm:(RLMRealm *)realm withValue:(id)value options:(RLMCreationOptions)options {
     // verify primary key
     RLMObjectSchema *schema = [self sharedSchema];
     if (!schema.primaryKeyProperty) {
         NSString *reason = [NSString stringWithFormat:@"'%@' does not have a primary key and can not be updated", schema.className];
         @throw [NSException exceptionWithName:@"RLMExecption" reason:reason userInfo:nil];
     }
-    return (RLMObject *)RLMCreateObjectInRealmWithValue(realm, [self className], value, true);
+    return (RLMObject *)RLMCreateObjectInRealmWithValue(realm, [self sharedSchema], value, options);
 }
 
 #pragma mark - Subscripting
@@ -107,11 +122,11 @@
 #pragma mark - Getting & Querying
 
 + (RLMResults *)allObjects {
-    return RLMGetObjects(RLMRealm.defaultRealm, self.className, nil);
+    return RLMGetObjects(RLMRealm.defaultRealm, self.sharedSchema, nil);
 }
 
 + (RLMResults *)allObjectsInRealm:(__unsafe_unretained RLMRealm *const)realm {
-    return RLMGetObjects(realm, self.className, nil);
+    return RLMGetObjects(realm, self.sharedSchema, nil);
 }
 
 + (RLMResults *)objectsWhere:(NSString *)predicateFormat, ... {
@@ -139,19 +154,33 @@
 }
 
 + (RLMResults *)objectsWithPredicate:(NSPredicate *)predicate {
-    return RLMGetObjects(RLMRealm.defaultRealm, self.className, predicate);
+    return RLMGetObjects(RLMRealm.defaultRealm, self.sharedSchema, predicate);
 }
 
 + (RLMResults *)objectsInRealm:(RLMRealm *)realm withPredicate:(NSPredicate *)predicate {
-    return RLMGetObjects(realm, self.className, predicate);
+    return RLMGetObjects(realm, self.sharedSchema, predicate);
+}
+
++ (NSArray *)objectsInRealms:(NSArray<RLMRealm *> *)realms
+               withPredicate:(NSPredicate *)predicate
+             sortDescriptors:(NSArray<RLMSortDescriptor *> *)sortDescriptors {
+    return RLMGetObjectsInRealms(realms, self.className, predicate, sortDescriptors);
 }
 
 + (instancetype)objectForPrimaryKey:(id)primaryKey {
-    return RLMGetObject(RLMRealm.defaultRealm, self.className, primaryKey);
+    return RLMGetObject(RLMRealm.defaultRealm, self.sharedSchema, primaryKey);
 }
 
 + (instancetype)objectInRealm:(RLMRealm *)realm forPrimaryKey:(id)primaryKey {
-    return RLMGetObject(realm, self.className, primaryKey);
+    return RLMGetObject(realm, self.sharedSchema, primaryKey);
+}
+
++ (NSArray *)objectsForPrimaryKeys:(id<NSFastEnumeration>)primaryKeys {
+    return RLMGetObjectsForPrimaryKeys(RLMRealm.defaultRealm, self.sharedSchema, primaryKeys);
+}
+
++ (NSArray *)objectsInRealm:(RLMRealm *)realm forPrimaryKeys:(id<NSFastEnumeration>)primaryKeys {
+    return RLMGetObjectsForPrimaryKeys(realm, self.sharedSchema, primaryKeys);
 }
 
 #pragma mark - Other Instance Methods
@@ -160,6 +189,31 @@
     return [object isKindOfClass:RLMObject.class] && RLMObjectBaseAreEqual(self, object);
 }
 
+- (void)withBinaryProperty:(NSString *)propertyName block:(NS_NOESCAPE void (^)(const void *, NSUInteger))block {
+    RLMDynamicWithBinaryProperty(self, propertyName, block);
+}
+
+- (void)copyValuesForProperties:(NSArray<NSString *> *)propertyNames into:(NSMutableDictionary *)values {
+    RLMDynamicGetValues(self, propertyNames, values);
+}
+
+- (NSUInteger)linkingObjectsCountForProperty:(NSString *)propertyName {
+    return RLMDynamicLinkingObjectsCount(self, propertyName);
+}
+
+- (void)incrementProperty:(NSString *)propertyName by:(NSInteger)amount {
+    RLMDynamicIncrement(self, propertyName, amount);
+}
+
+- (id)valueForDerivedProperty:(NSString *)propertyName {
+    @throw RLMException(@"'%@' must override -valueForDerivedProperty: to compute the derived property '%@'.",
+                        self.objectSchema.className, propertyName);
+}
+
+- (instancetype)detachedCopy {
+    return (RLMObject *)RLMDetachedCopy(self);
+}
+
 - (RLMNotificationToken *)addNotificationBlock:(RLMObjectChangeBlock)block {
     return RLMObjectAddNotificationBlock(self, ^(NSArray<NSString *> *propertyNames,
                                                  NSArray *oldValues, NSArray *newValues, NSError *error) {
@@ -193,6 +247,46 @@
     return @[];
 }
 
++ (NSArray *)deferredIndexedProperties {
+    return @[];
+}
+
++ (NSDictionary *)foldedIndexedProperties {
+    return @{};
+}
+
++ (NSArray *)internedStringProperties {
+    return @[];
+}
+
++ (NSDictionary *)compoundIndexes {
+    return @{};
+}
+
++ (NSDictionary *)geoIndexes {
+    return @{};
+}
+
++ (NSDictionary *)collationKeys {
+    return @{};
+}
+
++ (NSString *)collationLocaleIdentifier {
+    return nil;
+}
+
++ (NSDictionary *)derivedProperties {
+    return @{};
+}
+
++ (NSDictionary *)vectorProperties {
+    return @{};
+}
+
++ (NSString *)expirationProperty {
+    return nil;
+}
+
 + (NSDictionary *)linkingObjectsProperties {
     return @{};
 }
@@ -201,6 +295,14 @@
     return nil;
 }
 
++ (BOOL)hasStaticDefaultPropertyValues {
+    return NO;
+}
+
++ (void)invalidateCachedDefaultPropertyValues {
+    RLMInvalidateCachedDefaultValues();
+}
+
 + (NSString *)primaryKey {
     return nil;
 }
@@ -343,6 +445,7 @@ RLMNotificationToken *RLMObjectAddNotificationBlock(RLMObjectBase *obj, RLMObjec
 
         void after(realm::CollectionChangeSet const& c) {
             @autoreleasepool {
+                RLMNotificationInterval interval(RLMNotificationStageObjectBlock, object->_realm);
                 auto newValues = readValues(c);
                 if (deleted) {
                     block(nil, nil, nil, nil);
@@ -34,6 +34,8 @@
 
 #import "object.hpp"
 
+#import <atomic>
+
 using namespace realm;
 
 const NSUInteger RLMDescriptionMaxDepth = 5;
@@ -52,8 +54,11 @@ static bool maybeInitObjectSchemaForUnmanaged(RLMObjectBase *obj) {
         }
     }
 
-    // set unmanaged accessor class
-    object_setClass(obj, obj->_objectSchema.unmanagedClass);
+    // set unmanaged accessor class, if the class needs one
+    Class unmanagedClass = obj->_objectSchema.unmanagedClass;
+    if (unmanagedClass != object_getClass(obj)) {
+        object_setClass(obj, unmanagedClass);
+    }
     return true;
 }
 
@@ -154,7 +159,18 @@ static id validatedObjectForProperty(__unsafe_unretained id const obj,
     return self;
 }
 
+#if DEBUG
+static std::atomic<uint64_t> s_managedAccessorCount{0};
+
+uint64_t RLMDebugManagedAccessorCount() {
+    return s_managedAccessorCount.load(std::memory_order_relaxed);
+}
+#endif
+
 id RLMCreateManagedAccessor(Class cls, __unsafe_unretained RLMRealm *realm, RLMClassInfo *info) {
+#if DEBUG
+    s_managedAccessorCount.fetch_add(1, std::memory_order_relaxed);
+#endif
     RLMObjectBase *obj = [[cls alloc] initWithRealm:realm schema:info->rlmObjectSchema];
     obj->_info = info;
     return obj;
@@ -177,6 +193,22 @@ id RLMCreateManagedAccessor(Class cls, __unsafe_unretained RLMRealm *realm, RLMC
     return [super valueForKey:key];
 }
 
+- (NSDictionary<NSString *, id> *)dictionaryWithValuesForKeys:(NSArray<NSString *> *)keys {
+    // observed objects can be read after being deleted, which only the
+    // observation info knows how to handle
+    if (!_realm || _observationInfo) {
+        return [super dictionaryWithValuesForKeys:keys];
+    }
+    for (NSString *key in keys) {
+        if (!_objectSchema[key]) {
+            return [super dictionaryWithValuesForKeys:keys];
+        }
+    }
+    NSMutableDictionary *values = [NSMutableDictionary dictionaryWithCapacity:keys.count];
+    RLMDynamicGetValues(self, keys, values);
+    return values;
+}
+
 // Generic Swift properties can't be dynamic, so KVO doesn't work for them by default
 - (id)valueForUndefinedKey:(NSString *)key {
     if (Ivar ivar = _objectSchema[key].swiftIvar) {
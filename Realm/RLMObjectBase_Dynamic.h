@@ -17,6 +17,7 @@
 ////////////////////////////////////////////////////////////////////////////
 
 #import <Realm/RLMObject.h>
+#import <Realm/RLMObjectSchema.h>
 
 @class RLMObjectSchema, RLMRealm;
 
@@ -79,4 +80,55 @@ FOUNDATION_EXTERN id _Nullable RLMObjectBaseObjectForKeyedSubscript(RLMObjectBas
  */
 FOUNDATION_EXTERN void RLMObjectBaseSetObjectForKeyedSubscript(RLMObjectBase * _Nullable object, NSString *key, id _Nullable obj);
 
+/**
+ Returns the value of the property with a handle, as returned by `-[RLMObjectSchema handleForProperty:]`.
+
+ This is equivalent to `RLMObjectBaseObjectForKeyedSubscript()`, but doesn't need to look the property up by name.
+
+ @param object  An `RLMObjectBase` obtained via a Swift `Object` or `RLMObject`.
+ @param handle  The handle of the property in the object's schema.
+
+ @return The value of the property.
+ */
+FOUNDATION_EXTERN id _Nullable RLMObjectBaseValueForHandle(RLMObjectBase *object, RLMPropertyHandle handle);
+
+/**
+ Sets the value of the property with a handle, as returned by `-[RLMObjectSchema handleForProperty:]`.
+
+ This is equivalent to `RLMObjectBaseSetObjectForKeyedSubscript()`, but doesn't need to look the property up by name.
+
+ @param object  An `RLMObjectBase` obtained via a Swift `Object` or `RLMObject`.
+ @param handle  The handle of the property in the object's schema.
+ @param value   The value to set.
+ */
+FOUNDATION_EXTERN void RLMObjectBaseSetValueForHandle(RLMObjectBase *object, RLMPropertyHandle handle, id _Nullable value);
+
+/**
+ Returns whether the property with a handle is `nil`.
+
+ @param object  An `RLMObjectBase` obtained via a Swift `Object` or `RLMObject`.
+ @param handle  The handle of the property in the object's schema.
+ */
+FOUNDATION_EXTERN BOOL RLMObjectBaseIsNullForHandle(RLMObjectBase *object, RLMPropertyHandle handle);
+
+/**
+ Typed accessors for the properties with a handle, as returned by `-[RLMObjectSchema handleForProperty:]`.
+
+ These read and write the value of a property directly, without looking the property up by name or boxing its value.
+ The property must be of the accessor's type, or an exception is thrown. The numeric getters return zero for
+ properties whose value is `nil`; use `RLMObjectBaseIsNullForHandle()` to tell them apart. The setters may be used
+ on the same properties as `RLMObjectBaseSetValueForHandle()`, and send the same KVO notifications.
+ */
+FOUNDATION_EXTERN int64_t RLMObjectBaseGetIntForHandle(RLMObjectBase *object, RLMPropertyHandle handle);
+FOUNDATION_EXTERN BOOL RLMObjectBaseGetBoolForHandle(RLMObjectBase *object, RLMPropertyHandle handle);
+FOUNDATION_EXTERN float RLMObjectBaseGetFloatForHandle(RLMObjectBase *object, RLMPropertyHandle handle);
+FOUNDATION_EXTERN double RLMObjectBaseGetDoubleForHandle(RLMObjectBase *object, RLMPropertyHandle handle);
+FOUNDATION_EXTERN NSString *_Nullable RLMObjectBaseGetStringForHandle(RLMObjectBase *object, RLMPropertyHandle handle);
+FOUNDATION_EXTERN NSDate *_Nullable RLMObjectBaseGetDateForHandle(RLMObjectBase *object, RLMPropertyHandle handle);
+
+FOUNDATION_EXTERN void RLMObjectBaseSetIntForHandle(RLMObjectBase *object, RLMPropertyHandle handle, int64_t value);
+FOUNDATION_EXTERN void RLMObjectBaseSetBoolForHandle(RLMObjectBase *object, RLMPropertyHandle handle, BOOL value);
+FOUNDATION_EXTERN void RLMObjectBaseSetFloatForHandle(RLMObjectBase *object, RLMPropertyHandle handle, float value);
+FOUNDATION_EXTERN void RLMObjectBaseSetDoubleForHandle(RLMObjectBase *object, RLMPropertyHandle handle, double value);
+
 NS_ASSUME_NONNULL_END
@@ -22,6 +22,9 @@ NS_ASSUME_NONNULL_BEGIN
 
 @class RLMProperty;
 
+/// An opaque handle for a property of an `RLMObjectSchema`, returned by `-[RLMObjectSchema handleForProperty:]`.
+typedef NSUInteger RLMPropertyHandle;
+
 /**
  This class represents Realm model object schemas.
 
@@ -62,6 +65,20 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (nullable RLMProperty *)objectForKeyedSubscript:(NSString *)propertyName;
 
+/**
+ Returns a handle for a persisted property, for use with the typed accessors in `RLMObjectBase_Dynamic.h`.
+
+ Reading or writing a property through its handle skips looking the property up by name, and the typed accessors also
+ skip boxing the value, which makes generic code which reads many objects much faster. A handle is only valid for the
+ objects whose `objectSchema` is equal to the receiver, such as the objects of the class in the Realm whose schema the
+ receiver was obtained from.
+
+ @param propertyName The name of a property which isn't a linking objects property.
+
+ @return The handle for the property.
+ */
+- (RLMPropertyHandle)handleForProperty:(NSString *)propertyName;
+
 /**
  Returns whether two `RLMObjectSchema` instances are equal.
  */
@@ -18,6 +18,7 @@
 
 #import "RLMObjectSchema_Private.hpp"
 
+#import "RLMAccessor.h"
 #import "RLMArray.h"
 #import "RLMListBase.h"
 #import "RLMObject_Private.h"
@@ -30,8 +31,168 @@
 
 #import "object_store.hpp"
 
+#import <dlfcn.h>
+#import <mach-o/loader.h>
+#include <atomic>
+#include <mutex>
+
 using namespace realm;
 
+namespace {
+// Introspecting a class's properties gives the same result every time for a
+// given build of the binary which defines it, of the binary which defines the
+// class's RLMObjectUtil class (RealmSwift's for Swift classes), and of Realm's
+// own binary, so the results are cached on disk keyed by the UUIDs of all
+// three, and a new build of any of them uses a new cache file. Setting
+// REALM_DISABLE_SCHEMA_CACHE in the environment turns the cache off.
+//
+// The format version is part of the file name as well, and must be bumped
+// whenever -[RLMProperty schemaCacheRepresentation] changes.
+const int c_schemaCacheFormatVersion = 2;
+
+NSString *binaryUUIDForAddress(const void *address) {
+    Dl_info info;
+    if (!dladdr(address, &info) || !info.dli_fbase) {
+        return nil;
+    }
+
+    auto header = static_cast<const mach_header *>(info.dli_fbase);
+    auto command = reinterpret_cast<const char *>(header);
+    if (header->magic == MH_MAGIC_64) {
+        command += sizeof(mach_header_64);
+    }
+    else if (header->magic == MH_MAGIC) {
+        command += sizeof(mach_header);
+    }
+    else {
+        return nil;
+    }
+
+    for (uint32_t i = 0; i < header->ncmds; ++i) {
+        auto loadCommand = reinterpret_cast<const load_command *>(command);
+        if (loadCommand->cmd == LC_UUID) {
+            auto uuidCommand = reinterpret_cast<const uuid_command *>(command);
+            return [[NSUUID alloc] initWithUUIDBytes:uuidCommand->uuid].UUIDString;
+        }
+        command += loadCommand->cmdsize;
+    }
+    return nil;
+}
+
+class SchemaCache {
+public:
+    static SchemaCache& shared() {
+        static SchemaCache& cache = *new SchemaCache;
+        return cache;
+    }
+
+    NSArray *propertiesForClass(Class cls, Class objectUtil) {
+        NSString *binary = binaryKey(cls, objectUtil);
+        if (!binary) {
+            return nil;
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        NSMutableDictionary *classes = classesForBinary(binary);
+        NSArray *representations = RLMDynamicCast<NSArray>(classes[NSStringFromClass(cls)]);
+        if (!representations) {
+            return nil;
+        }
+
+        NSMutableArray *properties = [NSMutableArray arrayWithCapacity:representations.count];
+        for (id representation in representations) {
+            NSDictionary *dictionary = RLMDynamicCast<NSDictionary>(representation);
+            RLMProperty *prop = dictionary ? [[RLMProperty alloc] initWithSchemaCacheRepresentation:dictionary
+                                                                                        objectClass:cls] : nil;
+            if (!prop) {
+                // Unreadable entry, so discard it and introspect the class again
+                [classes removeObjectForKey:NSStringFromClass(cls)];
+                return nil;
+            }
+            [properties addObject:prop];
+        }
+        return properties;
+    }
+
+    void storeProperties(Class cls, Class objectUtil, NSArray<RLMProperty *> *properties) {
+        NSString *binary = binaryKey(cls, objectUtil);
+        if (!binary) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            classesForBinary(binary)[NSStringFromClass(cls)] = [properties valueForKey:@"schemaCacheRepresentation"];
+        }
+
+        // Write the file in the background, which usually covers all of the
+        // classes which were introspected together
+        dispatch_async(_queue, ^{
+            NSDictionary *classes;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                classes = [_binaries[binary] copy];
+                if ([_written[binary] isEqualToDictionary:classes]) {
+                    return;
+                }
+                _written[binary] = classes;
+            }
+            [[NSFileManager defaultManager] createDirectoryAtPath:_directory withIntermediateDirectories:YES
+                                                       attributes:nil error:nil];
+            [classes writeToFile:pathForBinary(binary) atomically:YES];
+        });
+    }
+
+private:
+    std::mutex _mutex;
+    NSString *_directory;
+    NSString *_realmBinary;
+    dispatch_queue_t _queue;
+    // binary key -> class name -> property representations
+    NSMutableDictionary<NSString *, NSMutableDictionary *> *_binaries = [NSMutableDictionary new];
+    NSMutableDictionary<NSString *, NSDictionary *> *_written = [NSMutableDictionary new];
+
+    SchemaCache() {
+        if (getenv("REALM_DISABLE_SCHEMA_CACHE")) {
+            return;
+        }
+        _realmBinary = binaryUUIDForAddress((__bridge const void *)RLMObjectSchema.class);
+        NSString *caches = NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES).firstObject;
+        if (!_realmBinary || !caches) {
+            return;
+        }
+        _directory = [caches stringByAppendingPathComponent:@"io.realm.schema-cache"];
+        _queue = dispatch_queue_create("io.realm.schema-cache", DISPATCH_QUEUE_SERIAL);
+    }
+
+    NSString *binaryKey(Class cls, Class objectUtil) {
+        if (!_directory) {
+            return nil;
+        }
+        NSString *classBinary = binaryUUIDForAddress((__bridge const void *)cls);
+        NSString *utilBinary = binaryUUIDForAddress((__bridge const void *)objectUtil);
+        if (!classBinary || !utilBinary) {
+            return nil;
+        }
+        return [NSString stringWithFormat:@"%@-%@", classBinary, utilBinary];
+    }
+
+    NSString *pathForBinary(NSString *binary) {
+        NSString *name = [NSString stringWithFormat:@"%@-%@-v%d.plist", binary, _realmBinary, c_schemaCacheFormatVersion];
+        return [_directory stringByAppendingPathComponent:name];
+    }
+
+    // Caller must hold _mutex
+    NSMutableDictionary *classesForBinary(NSString *binary) {
+        if (NSMutableDictionary *classes = _binaries[binary]) {
+            return classes;
+        }
+        NSDictionary *stored = [NSDictionary dictionaryWithContentsOfFile:pathForBinary(binary)];
+        _written[binary] = stored;
+        return _binaries[binary] = stored ? [stored mutableCopy] : [NSMutableDictionary new];
+    }
+};
+} // anonymous namespace
+
 // private properties
 @interface RLMObjectSchema ()
 @property (nonatomic, readwrite) NSDictionary<id, RLMProperty *> *allPropertiesByName;
@@ -40,6 +201,7 @@ using namespace realm;
 
 @implementation RLMObjectSchema {
     NSArray *_swiftGenericProperties;
+    std::atomic<bool> _needsManagedAccessorClass;
 }
 
 - (instancetype)initWithClassName:(NSString *)objectClassName objectClass:(Class)objectClass properties:(NSArray *)properties {
@@ -57,6 +219,18 @@ using namespace realm;
     return _allPropertiesByName[key];
 }
 
+- (RLMPropertyHandle)handleForProperty:(NSString *)propertyName {
+    RLMProperty *prop = _allPropertiesByName[propertyName];
+    if (!prop) {
+        @throw RLMException(@"Invalid property name '%@' for class '%@'.", propertyName, _className);
+    }
+    if ([_computedProperties indexOfObjectIdenticalTo:prop] != NSNotFound) {
+        @throw RLMException(@"Property '%@' of '%@' has no handle because it is not persisted.", propertyName, _className);
+    }
+    // Handles are the indices the accessors already use for the properties
+    return prop.index;
+}
+
 // create property map when setting property array
 - (void)setProperties:(NSArray *)properties {
     _properties = properties;
@@ -85,6 +259,15 @@ using namespace realm;
 }
 
 
+- (RLMProperty *)expirationProperty {
+    for (RLMProperty *prop in _properties) {
+        if (prop.isExpirationDate) {
+            return prop;
+        }
+    }
+    return nil;
+}
+
 - (void)setPrimaryKeyProperty:(RLMProperty *)primaryKeyProperty {
     _primaryKeyProperty.isPrimary = NO;
     primaryKeyProperty.isPrimary = YES;
@@ -160,6 +343,216 @@ using namespace realm;
         }
     }
 
+    [[objectClass foldedIndexedProperties] enumerateKeysAndObjectsUsingBlock:^(NSString *sourceName, NSString *foldedName, __unused BOOL *stop) {
+        RLMProperty *source = schema[sourceName];
+        RLMProperty *folded = schema[foldedName];
+        if (!source || !folded) {
+            @throw RLMException(@"Property '%@' listed in '+[%@ foldedIndexedProperties]' does not exist.",
+                                source ? foldedName : sourceName, className);
+        }
+        if (source.type != RLMPropertyTypeString || source.isPrimary || source.isFolded) {
+            @throw RLMException(@"Property '%@.%@' cannot have a folded copy because it is not a non-primary-key 'string' property.",
+                                className, sourceName);
+        }
+        if (folded.type != RLMPropertyTypeString || !folded.optional || folded.isPrimary
+            || folded.isFolded || folded.foldedPropertyName || folded == source) {
+            @throw RLMException(@"Property '%@.%@' cannot hold the folded copy of '%@' because it is not a separate optional 'string' property.",
+                                className, foldedName, sourceName);
+        }
+        source.foldedPropertyName = foldedName;
+        folded.isFolded = YES;
+        folded.indexed = YES;
+    }];
+
+    for (NSString *propertyName in [objectClass deferredIndexedProperties]) {
+        RLMProperty *property = schema[propertyName];
+        if (!property) {
+            @throw RLMException(@"Property '%@' listed in '+[%@ deferredIndexedProperties]' does not exist.",
+                                propertyName, className);
+        }
+        switch (property.type) {
+            case RLMPropertyTypeString:
+            case RLMPropertyTypeInt:
+            case RLMPropertyTypeBool:
+            case RLMPropertyTypeDate:
+                break;
+            default:
+                @throw RLMException(@"Property '%@.%@' of type '%@' cannot be indexed.",
+                                    className, propertyName, RLMTypeToString(property.type));
+        }
+        property.indexed = YES;
+        property.deferredIndex = !property.isPrimary;
+    }
+
+    for (NSString *propertyName in [objectClass internedStringProperties]) {
+        RLMProperty *property = schema[propertyName];
+        if (!property) {
+            @throw RLMException(@"Property '%@' listed in '+[%@ internedStringProperties]' does not exist.",
+                                propertyName, className);
+        }
+        if (property.type != RLMPropertyTypeString) {
+            @throw RLMException(@"Property '%@.%@' cannot be interned because it is not a 'string' property.",
+                                className, propertyName);
+        }
+        property.internsStrings = YES;
+    }
+
+    [[objectClass compoundIndexes] enumerateKeysAndObjectsUsingBlock:^(NSString *keyName, NSArray<NSString *> *componentNames, __unused BOOL *stop) {
+        RLMProperty *key = schema[keyName];
+        if (!key) {
+            @throw RLMException(@"Property '%@' listed in '+[%@ compoundIndexes]' does not exist.", keyName, className);
+        }
+        if (key.type != RLMPropertyTypeString || !key.optional || key.isPrimary || key.isFolded
+            || key.foldedPropertyName || key.isComputed || key.hasComputedProperties) {
+            @throw RLMException(@"Property '%@.%@' cannot hold the keys of a compound index because it is not a separate optional 'string' property.",
+                                className, keyName);
+        }
+        if (componentNames.count < 2) {
+            @throw RLMException(@"Compound index '%@.%@' must combine at least two properties.", className, keyName);
+        }
+        for (NSString *componentName in componentNames) {
+            RLMProperty *component = schema[componentName];
+            if (!component) {
+                @throw RLMException(@"Property '%@' listed in '+[%@ compoundIndexes]' does not exist.", componentName, className);
+            }
+            switch (component.type) {
+                case RLMPropertyTypeString:
+                case RLMPropertyTypeInt:
+                case RLMPropertyTypeBool:
+                case RLMPropertyTypeDate:
+                    break;
+                default:
+                    @throw RLMException(@"Property '%@.%@' cannot be part of a compound index because it is not a 'string', 'int', 'bool' or 'date' property.",
+                                        className, componentName);
+            }
+            if (component.isPrimary || component.isFolded || component.isComputed
+                || [component.compoundIndexKeyNames containsObject:keyName]) {
+                @throw RLMException(@"Property '%@.%@' cannot be part of the compound index '%@'.", className, componentName, keyName);
+            }
+            component.compoundIndexKeyNames = [component.compoundIndexKeyNames ?: @[] arrayByAddingObject:keyName];
+        }
+        key.compoundIndexComponents = componentNames;
+        key.indexed = YES;
+    }];
+
+    [[objectClass geoIndexes] enumerateKeysAndObjectsUsingBlock:^(NSString *keyName, NSArray<NSString *> *componentNames, __unused BOOL *stop) {
+        RLMProperty *key = schema[keyName];
+        if (!key) {
+            @throw RLMException(@"Property '%@' listed in '+[%@ geoIndexes]' does not exist.", keyName, className);
+        }
+        if (key.type != RLMPropertyTypeInt || !key.optional || key.isPrimary
+            || key.isComputed || key.hasComputedProperties) {
+            @throw RLMException(@"Property '%@.%@' cannot hold the keys of a geo index because it is not a separate optional 'int' property.",
+                                className, keyName);
+        }
+        if (componentNames.count != 2) {
+            @throw RLMException(@"Geo index '%@.%@' must combine a latitude and a longitude property.", className, keyName);
+        }
+        for (NSString *componentName in componentNames) {
+            RLMProperty *component = schema[componentName];
+            if (!component) {
+                @throw RLMException(@"Property '%@' listed in '+[%@ geoIndexes]' does not exist.", componentName, className);
+            }
+            if (component.type != RLMPropertyTypeDouble || component.isPrimary || component.isComputed
+                || [component.geoIndexKeyNames containsObject:keyName]) {
+                @throw RLMException(@"Property '%@.%@' cannot be part of the geo index '%@' because it is not a separate 'double' property.",
+                                    className, componentName, keyName);
+            }
+            component.geoIndexKeyNames = [component.geoIndexKeyNames ?: @[] arrayByAddingObject:keyName];
+        }
+        key.geoIndexCoordinateNames = componentNames;
+        key.indexed = YES;
+    }];
+
+    NSString *collationLocaleIdentifier = [objectClass collationLocaleIdentifier];
+    [[objectClass collationKeys] enumerateKeysAndObjectsUsingBlock:^(NSString *keyName, NSString *sourceName, __unused BOOL *stop) {
+        RLMProperty *key = schema[keyName];
+        if (!key) {
+            @throw RLMException(@"Property '%@' listed in '+[%@ collationKeys]' does not exist.", keyName, className);
+        }
+        if (key.type != RLMPropertyTypeString || !key.optional || key.isPrimary || key.isFolded
+            || key.foldedPropertyName || key.isComputed || key.hasComputedProperties) {
+            @throw RLMException(@"Property '%@.%@' cannot hold a collation key because it is not a separate optional 'string' property.",
+                                className, keyName);
+        }
+        RLMProperty *source = schema[sourceName];
+        if (!source) {
+            @throw RLMException(@"Property '%@' listed in '+[%@ collationKeys]' does not exist.", sourceName, className);
+        }
+        if (source.type != RLMPropertyTypeString || source.isFolded || source.isComputed || source.collationKeyName) {
+            @throw RLMException(@"Property '%@.%@' cannot have the collation key '%@' because it is not a separate 'string' property with no other collation key.",
+                                className, sourceName, keyName);
+        }
+        source.collationKeyName = keyName;
+        key.collationSourceName = sourceName;
+        key.collationLocaleIdentifier = collationLocaleIdentifier;
+    }];
+
+    [[objectClass derivedProperties] enumerateKeysAndObjectsUsingBlock:^(NSString *derivedName, NSArray<NSString *> *inputNames, __unused BOOL *stop) {
+        RLMProperty *derived = schema[derivedName];
+        if (!derived) {
+            @throw RLMException(@"Property '%@' listed in '+[%@ derivedProperties]' does not exist.", derivedName, className);
+        }
+        switch (derived.type) {
+            case RLMPropertyTypeInt: case RLMPropertyTypeBool: case RLMPropertyTypeFloat:
+            case RLMPropertyTypeDouble: case RLMPropertyTypeString: case RLMPropertyTypeDate:
+                break;
+            default:
+                @throw RLMException(@"Property '%@.%@' cannot be derived because it is of type '%@'.",
+                                    className, derivedName, RLMTypeToString(derived.type));
+        }
+        if (derived.isPrimary || derived.isFolded || derived.foldedPropertyName
+            || derived.isComputed || derived.hasComputedProperties) {
+            @throw RLMException(@"Property '%@.%@' cannot be derived because it is not a separate non-primary-key property.",
+                                className, derivedName);
+        }
+        if (inputNames.count == 0) {
+            @throw RLMException(@"Derived property '%@.%@' must be computed from at least one property.", className, derivedName);
+        }
+        for (NSString *inputName in inputNames) {
+            RLMProperty *input = schema[inputName];
+            if (!input) {
+                @throw RLMException(@"Property '%@' listed in '+[%@ derivedProperties]' does not exist.", inputName, className);
+            }
+            if (input == derived || input.type == RLMPropertyTypeArray || input.type == RLMPropertyTypeLinkingObjects
+                || input.isFolded || input.isComputed || [input.derivedPropertyNames containsObject:derivedName]) {
+                @throw RLMException(@"Property '%@.%@' cannot be derived from the property '%@' because it is not a separate non-list property.",
+                                    className, derivedName, inputName);
+            }
+            input.derivedPropertyNames = [input.derivedPropertyNames ?: @[] arrayByAddingObject:derivedName];
+        }
+        derived.derivedInputNames = inputNames;
+    }];
+
+    [[objectClass vectorProperties] enumerateKeysAndObjectsUsingBlock:^(NSString *vectorName, NSNumber *dimension, __unused BOOL *stop) {
+        RLMProperty *vector = schema[vectorName];
+        if (!vector) {
+            @throw RLMException(@"Property '%@' listed in '+[%@ vectorProperties]' does not exist.", vectorName, className);
+        }
+        if (vector.type != RLMPropertyTypeData || vector.isPrimary || vector.hasComputedProperties) {
+            @throw RLMException(@"Property '%@.%@' cannot hold vectors because it is not a 'data' property.",
+                                className, vectorName);
+        }
+        if (![dimension isKindOfClass:NSNumber.class] || dimension.longLongValue <= 0) {
+            @throw RLMException(@"Vector property '%@.%@' must have a positive number of dimensions, not '%@'.",
+                                className, vectorName, dimension);
+        }
+        vector.vectorDimension = dimension.unsignedIntegerValue;
+    }];
+
+    if (NSString *expirationName = [objectClass expirationProperty]) {
+        RLMProperty *expiration = schema[expirationName];
+        if (!expiration) {
+            @throw RLMException(@"Expiration property '%@' does not exist on object '%@'", expirationName, className);
+        }
+        if (expiration.type != RLMPropertyTypeDate || expiration.isPrimary) {
+            @throw RLMException(@"Property '%@.%@' cannot hold the expiration date of '%@' because it is not a non-primary-key 'date' property.",
+                                className, expirationName, className);
+        }
+        expiration.isExpirationDate = YES;
+        expiration.indexed = YES;
+    }
+
     for (RLMProperty *prop in schema.properties) {
         if (prop.optional && !RLMPropertyTypeIsNullable(prop.type)) {
             @throw RLMException(@"Property '%@.%@' cannot be made optional because optional '%@' properties are not supported.",
@@ -181,6 +574,16 @@ using namespace realm;
 }
 
 + (NSArray *)propertiesForClass:(Class)objectClass isSwift:(bool)isSwiftClass {
+    Class objectUtil = [objectClass objectUtilClass:isSwiftClass];
+    if (NSArray *cached = SchemaCache::shared().propertiesForClass(objectClass, objectUtil)) {
+        return cached;
+    }
+    NSArray *properties = [self introspectedPropertiesForClass:objectClass isSwift:isSwiftClass];
+    SchemaCache::shared().storeProperties(objectClass, objectUtil, properties);
+    return properties;
+}
+
++ (NSArray *)introspectedPropertiesForClass:(Class)objectClass isSwift:(bool)isSwiftClass {
     Class objectUtil = [objectClass objectUtilClass:isSwiftClass];
     NSArray *ignoredProperties = [objectUtil ignoredPropertiesForClass:objectClass];
     NSDictionary *linkingObjectsProperties = [objectUtil linkingObjectsPropertiesForClass:objectClass];
@@ -320,6 +723,33 @@ using namespace realm;
     return propArray;
 }
 
+- (void)setNeedsManagedAccessorClass {
+    if (_accessorClass == _objectClass) {
+        _needsManagedAccessorClass.store(true, std::memory_order_release);
+    }
+}
+
+- (Class)accessorClass {
+    if (_needsManagedAccessorClass.load(std::memory_order_acquire)) {
+        // schemas are shared between Realms on different threads, so the
+        // accessor class has to be created exactly once no matter who asks
+        static std::mutex s_mutex;
+        std::lock_guard<std::mutex> lock(s_mutex);
+        if (_needsManagedAccessorClass.load(std::memory_order_relaxed)) {
+            static unsigned long long s_count = 0;
+            NSString *name = [NSString stringWithFormat:@"RLM:Managed %llu %@", s_count++, _className];
+            _accessorClass = RLMManagedAccessorClassForObjectClass(_objectClass, self, name.UTF8String);
+            _needsManagedAccessorClass.store(false, std::memory_order_release);
+        }
+    }
+    return _accessorClass;
+}
+
+- (void)setAccessorClass:(Class)accessorClass {
+    _needsManagedAccessorClass.store(false, std::memory_order_relaxed);
+    _accessorClass = accessorClass;
+}
+
 - (id)copyWithZone:(NSZone *)zone {
     RLMObjectSchema *schema = [[RLMObjectSchema allocWithZone:zone] init];
     schema->_objectClass = _objectClass;
@@ -328,6 +758,7 @@ using namespace realm;
     schema->_accessorClass = _objectClass;
     schema->_unmanagedClass = _unmanagedClass;
     schema->_isSwiftClass = _isSwiftClass;
+    schema->_classID = _classID;
 
     // call property setter to reset map and primary key
     schema.properties = [[NSArray allocWithZone:zone] initWithArray:_properties copyItems:YES];
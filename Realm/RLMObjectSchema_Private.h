@@ -42,9 +42,21 @@ NS_ASSUME_NONNULL_BEGIN
 
 @property (nonatomic, readwrite, nullable) RLMProperty *primaryKeyProperty;
 
+// the property holding the date at which objects expire, if the class has one
+@property (nonatomic, readonly, nullable) RLMProperty *expirationProperty;
+
 @property (nonatomic, copy) NSArray<RLMProperty *> *computedProperties;
 @property (nonatomic, readonly) NSArray<RLMProperty *> *swiftGenericProperties;
 
+// the process-wide ID of the class name, assigned by RLMSchemaInfo when the
+// schema is used by a Realm, or 0 if it has not been
+@property (nonatomic) uint32_t classID;
+
+// request a managed accessor class for this schema's object class, which is
+// created the first time `accessorClass` is read; does nothing if the schema
+// already has a non-default accessor class
+- (void)setNeedsManagedAccessorClass;
+
 // returns a cached or new schema for a given object class
 + (instancetype)schemaForObjectClass:(Class)objectClass;
 @end
@@ -22,7 +22,7 @@
 extern "C" {
 #endif
 
-@class RLMRealm, RLMSchema, RLMObjectBase, RLMResults, RLMProperty;
+@class RLMRealm, RLMSchema, RLMObjectBase, RLMResults, RLMProperty, RLMPreparedObjects, RLMSortDescriptor, RLMColumnBuffer;
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -30,7 +30,8 @@ NS_ASSUME_NONNULL_BEGIN
 // Accessor Creation
 //
 
-// create or get cached accessors for the given schema
+// mark the given schema as needing managed accessors, which are created on
+// first use of each class
 void RLMRealmCreateAccessors(RLMSchema *schema);
 
 
@@ -48,6 +49,12 @@ typedef NS_OPTIONS(NSUInteger, RLMCreationOptions) {
     RLMCreationOptionsPromoteUnmanaged = 1 << 1,
     // Use the SetDefault instruction.
     RLMCreationOptionsSetDefault = 1 << 2,
+    // When updating an existing object, only write the properties whose new
+    // value differs from the current value.
+    RLMCreationOptionsUpdateChangedOnly = 1 << 3,
+    // The values are known to be valid for their properties, so skip checking
+    // them other than in debug builds.
+    RLMCreationOptionsSkipValidation = 1 << 4,
 };
 
 
@@ -58,9 +65,17 @@ typedef NS_OPTIONS(NSUInteger, RLMCreationOptions) {
 // add an object to the given realm
 void RLMAddObjectToRealm(RLMObjectBase *object, RLMRealm *realm, bool createOrUpdate);
 
+// add each object in the collection to the given realm, resolving the schema
+// information only once for each run of objects of the same type
+void RLMAddObjectsToRealm(RLMRealm *realm, id<NSFastEnumeration> objects, bool createOrUpdate);
+
 // delete an object from its realm
 void RLMDeleteObjectFromRealm(RLMObjectBase *object, RLMRealm *realm);
 
+// delete each object in the collection from the given realm, removing all of
+// the rows of each table in a single batch
+void RLMDeleteObjectsFromRealm(RLMRealm *realm, id<NSFastEnumeration> objects);
+
 // deletes all objects from a realm
 void RLMDeleteAllObjectsFromRealm(RLMRealm *realm);
 
@@ -71,9 +86,58 @@ NS_RETURNS_RETAINED;
 // get an object with the given primary key
 id _Nullable RLMGetObject(RLMRealm *realm, NSString *objectClassName, id _Nullable key) NS_RETURNS_RETAINED;
 
+// get the objects with the given primary keys, in the order of the keys,
+// skipping keys which no object has
+NSArray *RLMGetObjectsForPrimaryKeys(RLMRealm *realm, NSString *objectClassName, id<NSFastEnumeration> keys);
+
+// get the objects of a given class from each of several Realms, such as the
+// shards of a dataset, merged into one array in the order of the sort descriptors
+NSArray *RLMGetObjectsInRealms(NSArray<RLMRealm *> *realms, NSString *objectClassName,
+                               NSPredicate * _Nullable predicate, NSArray<RLMSortDescriptor *> *sortDescriptors);
+
 // create object from array or dictionary
-RLMObjectBase *RLMCreateObjectInRealmWithValue(RLMRealm *realm, NSString *className, id _Nullable value, bool createOrUpdate)
+RLMObjectBase *RLMCreateObjectInRealmWithValue(RLMRealm *realm, NSString *className, id _Nullable value,
+                                               RLMCreationOptions options)
 NS_RETURNS_RETAINED;
+
+// create or update objects from a collection of arrays or dictionaries,
+// resolving the schema and the rows for all of the primary keys once for the
+// whole batch. Accessors for the objects are only created if `returnObjects`
+// is true. The number of rows inserted and updated are reported through the
+// optional out parameters. If a value is invalid, the rows reserved for the
+// batch are removed again and the error is reported through `error`, or
+// thrown if `error` is NULL.
+NSArray<RLMObjectBase *> *_Nullable RLMCreateObjectsInRealmWithValues(RLMRealm *realm, NSString *className,
+                                                                     id<NSFastEnumeration> values,
+                                                                     RLMCreationOptions options, bool returnObjects,
+                                                                     NSUInteger *_Nullable insertedCount,
+                                                                     NSUInteger *_Nullable updatedCount,
+                                                                     NSError *_Nullable *_Nullable error);
+
+// copy managed objects from `sourceRealm`, along with the objects they link
+// to, into `realm` by copying the column values directly, returning the
+// copies in the same order. Objects with a primary key which already exists in
+// `realm` are reused as they are, or updated if `updateExisting` is true.
+NSArray<RLMObjectBase *> *RLMCopyObjectsFromRealm(RLMRealm *realm, RLMRealm *sourceRealm,
+                                                 id<NSFastEnumeration> objects, bool updateExisting);
+
+// append `rowCount` objects of the given class from buffers of their column
+// values, writing the values directly to the table columns. Buffers which are
+// the wrong size for `rowCount` are reported through `error` before anything
+// is appended.
+BOOL RLMAppendColumnsToRealm(RLMRealm *realm, NSString *className,
+                             NSDictionary<NSString *, RLMColumnBuffer *> *columns,
+                             NSUInteger rowCount, NSError **error);
+
+// create or update an object for each element of the top-level JSON array read
+// incrementally from `stream`. If the Realm is not already in a write
+// transaction, one is begun and then committed every `commitInterval` objects
+// (if non-zero) and at the end.
+BOOL RLMImportJSONFromStream(RLMRealm *realm, NSString *className, NSInputStream *stream,
+                             RLMCreationOptions options, NSUInteger commitInterval, NSError **error);
+
+// add objects whose values were converted ahead of time by RLMPreparedObjects
+void RLMAddPreparedObjects(RLMRealm *realm, RLMPreparedObjects *objects);
     
 
 //
@@ -93,6 +157,16 @@ namespace realm {
     using RowExpr = BasicRowExpr<Table>;
 }
 class RLMClassInfo;
+@class RLMObjectSchema;
+
+// Variants of the above which look up the class by the ID RLMSchemaInfo gave
+// the object schema rather than by name
+RLMResults *RLMGetObjects(RLMRealm *realm, RLMObjectSchema *objectSchema,
+                          NSPredicate * _Nullable predicate) NS_RETURNS_RETAINED;
+id _Nullable RLMGetObject(RLMRealm *realm, RLMObjectSchema *objectSchema, id _Nullable key) NS_RETURNS_RETAINED;
+NSArray *RLMGetObjectsForPrimaryKeys(RLMRealm *realm, RLMObjectSchema *objectSchema, id<NSFastEnumeration> keys);
+RLMObjectBase *RLMCreateObjectInRealmWithValue(RLMRealm *realm, RLMObjectSchema *objectSchema,
+                                               id _Nullable value, RLMCreationOptions options) NS_RETURNS_RETAINED;
 
 // Create accessors
 RLMObjectBase *RLMCreateObjectAccessor(RLMRealm *realm, RLMClassInfo& info,
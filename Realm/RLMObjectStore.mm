@@ -20,6 +20,7 @@
 
 #import "RLMAccessor.h"
 #import "RLMArray_Private.hpp"
+#import "RLMCollection_Private.hpp"
 #import "RLMListBase.h"
 #import "RLMObservation.hpp"
 #import "RLMObject_Private.hpp"
@@ -27,6 +28,7 @@
 #import "RLMOptionalBase.h"
 #import "RLMProperty_Private.h"
 #import "RLMQueryUtil.hpp"
+#import "RLMRealm_Dynamic.h"
 #import "RLMRealm_Private.hpp"
 #import "RLMSchema_Private.h"
 #import "RLMSwiftSupport.h"
@@ -36,26 +38,18 @@
 #import "results.hpp"
 #import "shared_realm.hpp"
 
+#import <algorithm>
+#import <map>
 #import <objc/message.h>
+#import <unordered_set>
 
 using namespace realm;
 
 void RLMRealmCreateAccessors(RLMSchema *schema) {
-    const size_t bufferSize = sizeof("RLM:Managed  ") // includes null terminator
-                            + std::numeric_limits<unsigned long long>::digits10
-                            + realm::Group::max_table_name_length;
-
-    char className[bufferSize] = "RLM:Managed ";
-    char *const start = className + strlen(className);
-
+    // accessor classes are created on first use of each class, as many
+    // processes only ever touch a few of the classes in their schema
     for (RLMObjectSchema *objectSchema in schema.objectSchema) {
-        if (objectSchema.accessorClass != objectSchema.objectClass) {
-            continue;
-        }
-
-        static unsigned long long count = 0;
-        sprintf(start, "%llu %s", count++, objectSchema.className.UTF8String);
-        objectSchema.accessorClass = RLMManagedAccessorClassForObjectClass(objectSchema.objectClass, objectSchema, className);
+        [objectSchema setNeedsManagedAccessorClass];
     }
 }
 
@@ -86,8 +80,7 @@ void RLMInitializeSwiftAccessorGenerics(__unsafe_unretained RLMObjectBase *const
 
     for (RLMProperty *prop in object->_objectSchema.swiftGenericProperties) {
         if (prop->_type == RLMPropertyTypeArray) {
-            RLMArray *array = [[RLMArrayLinkView alloc] initWithParent:object property:prop];
-            [object_getIvar(object, prop.swiftIvar) set_rlmArray:array];
+            RLMListBaseSetParent(object_getIvar(object, prop->_swiftIvar), object, prop);
         }
         else if (prop.type == RLMPropertyTypeLinkingObjects) {
             id linkingObjects = object_getIvar(object, prop.swiftIvar);
@@ -124,7 +117,7 @@ static NSUInteger getRowForObjectWithPrimaryKey(RLMClassInfo const& info, id pri
 
     switch (primaryProperty.type) {
         case RLMPropertyTypeString:
-            return info.table()->find_first_string(primaryPropertyColumn, RLMStringDataWithNSString(primaryValue));
+            return info.table()->find_first_string(primaryPropertyColumn, RLMStringDataBuffer(primaryValue));
 
         case RLMPropertyTypeInt:
             if (primaryValue) {
@@ -164,7 +157,7 @@ static NSUInteger createRowForObjectWithPrimaryKey(RLMClassInfo const& info, id
         switch (primaryProperty.type) {
             case RLMPropertyTypeString:
                 REALM_ASSERT_DEBUG(!primaryValue || [primaryValue isKindOfClass:NSString.class]);
-                row.set_string_unique(primaryColumnIndex, RLMStringDataWithNSString(primaryValue));
+                row.set_string_unique(primaryColumnIndex, RLMStringDataBuffer(primaryValue));
                 break;
 
             case RLMPropertyTypeInt:
@@ -238,11 +231,67 @@ static NSUInteger createOrGetRowForObject(RLMClassInfo const& info, F valueForPr
     }
 }
 
-void RLMAddObjectToRealm(__unsafe_unretained RLMObjectBase *const object,
-                         __unsafe_unretained RLMRealm *const realm,
-                         bool createOrUpdate) {
-    RLMVerifyInWriteTransaction(realm);
+// Whether the getter for the property returns an object, and so can be called
+// directly rather than through KVC, which is needed to box primitive values
+static bool propertyHasObjectGetter(__unsafe_unretained RLMProperty *const prop) {
+    switch (prop.type) {
+        case RLMPropertyTypeString:
+        case RLMPropertyTypeData:
+        case RLMPropertyTypeDate:
+        case RLMPropertyTypeObject:
+        case RLMPropertyTypeArray:
+        case RLMPropertyTypeAny:
+            return true;
+        default:
+            return prop.optional;
+    }
+}
+
+// Read the value of a property from an unmanaged object
+static id unmanagedValueForProperty(__unsafe_unretained RLMObjectBase *const object,
+                                    __unsafe_unretained RLMProperty *const prop) {
+    if (prop.swiftIvar) {
+        if (prop.type == RLMPropertyTypeArray) {
+            return static_cast<RLMListBase *>(object_getIvar(object, prop.swiftIvar))._rlmArray;
+        }
+        // optional
+        return static_cast<RLMOptionalBase *>(object_getIvar(object, prop.swiftIvar)).underlyingValue;
+    }
+    if (![object respondsToSelector:prop.getterSel]) {
+        return nil;
+    }
+    if (propertyHasObjectGetter(prop)) {
+        return ((id(*)(id, SEL))objc_msgSend)(object, prop.getterSel);
+    }
+    return [object valueForKey:prop.getterName];
+}
+
+static bool RLMObjectSchemaHasComputedProperties(__unsafe_unretained RLMObjectSchema *const objectSchema) {
+    for (RLMProperty *prop in objectSchema.properties) {
+        if (prop.isComputed) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Recompute the computed properties of a row whose properties were all just
+// written through RLMDynamicSet, which skips them
+static void updateComputedPropertiesForObject(__unsafe_unretained RLMObjectBase *const object) {
+    if (!RLMObjectSchemaHasComputedProperties(object->_info->rlmObjectSchema)) {
+        return;
+    }
+    try {
+        object->_info->updateComputedProperties(object->_row.get_index());
+    }
+    catch (std::exception const& e) {
+        @throw RLMException(e);
+    }
+}
 
+static void addObjectToRealm(__unsafe_unretained RLMObjectBase *const object,
+                             __unsafe_unretained RLMRealm *const realm,
+                             RLMClassInfo& info, bool createOrUpdate) {
     // verify that object is unmanaged
     if (object.invalidated) {
         @throw RLMException(@"Adding a deleted or invalidated object to a Realm is not permitted");
@@ -260,15 +309,13 @@ void RLMAddObjectToRealm(__unsafe_unretained RLMObjectBase *const object,
     }
 
     // set the realm and schema
-    NSString *objectClassName = object->_objectSchema.className;
-    auto& info = realm->_info[objectClassName];
     object->_info = &info;
     object->_objectSchema = info.rlmObjectSchema;
     object->_realm = realm;
 
     // get or create row
     bool foundExisting;
-    auto primaryGetter = [=](__unsafe_unretained RLMProperty *const p) { return [object valueForKey:p.name]; };
+    auto primaryGetter = [=](__unsafe_unretained RLMProperty *const p) { return unmanagedValueForProperty(object, p); };
     object->_row = (*info.table())[createOrGetRowForObject(info, primaryGetter, createOrUpdate, &foundExisting)];
 
     RLMCreationOptions creationOptions = RLMCreationOptionsPromoteUnmanaged;
@@ -282,20 +329,7 @@ void RLMAddObjectToRealm(__unsafe_unretained RLMObjectBase *const object,
         if (prop.isPrimary)
             continue;
 
-        // get object from ivar using key value coding
-        id value = nil;
-        if (prop.swiftIvar) {
-            if (prop.type == RLMPropertyTypeArray) {
-                value = static_cast<RLMListBase *>(object_getIvar(object, prop.swiftIvar))._rlmArray;
-            }
-            else { // optional
-                value = static_cast<RLMOptionalBase *>(object_getIvar(object, prop.swiftIvar)).underlyingValue;
-            }
-        }
-        else if ([object respondsToSelector:prop.getterSel]) {
-            value = [object valueForKey:prop.getterName];
-        }
-
+        id value = unmanagedValueForProperty(object, prop);
         if (!value && !prop.optional) {
             @throw RLMException(@"Nil value specified for required property '%@' in '%@'",
                                 prop.name, info.rlmObjectSchema.className);
@@ -316,19 +350,87 @@ void RLMAddObjectToRealm(__unsafe_unretained RLMObjectBase *const object,
         RLMDynamicSet(object, prop, RLMCoerceToNil(value), creationOptions);
     }
 
+    updateComputedPropertiesForObject(object);
+
     // set to proper accessor class
     object_setClass(object, info.rlmObjectSchema.accessorClass);
 
     RLMInitializeSwiftAccessorGenerics(object);
 }
 
+void RLMAddObjectToRealm(__unsafe_unretained RLMObjectBase *const object,
+                         __unsafe_unretained RLMRealm *const realm,
+                         bool createOrUpdate) {
+    RLMVerifyInWriteTransaction(realm);
+    addObjectToRealm(object, realm, realm->_info[object->_objectSchema], createOrUpdate);
+}
+
+void RLMAddObjectsToRealm(__unsafe_unretained RLMRealm *const realm,
+                          __unsafe_unretained id<NSFastEnumeration> const objects,
+                          bool createOrUpdate) {
+    RLMVerifyInWriteTransaction(realm);
+
+    // The objects are usually all of the same type, so only check the type and
+    // look up the class info when it differs from the previous object's
+    Class previousClass = nil;
+    RLMObjectSchema *previousSchema = nil;
+    RLMClassInfo *info = nullptr;
+    for (RLMObjectBase *object in objects) {
+        Class cls = object_getClass(object);
+        if (cls != previousClass) {
+            if (![object isKindOfClass:RLMObjectBase.class]) {
+                @throw RLMException(@"Cannot insert objects of type %@ with addObjects:. Only RLMObjects are supported.",
+                                    NSStringFromClass(object.class));
+            }
+            previousClass = cls;
+            info = nullptr;
+        }
+        if (!info || object->_objectSchema != previousSchema) {
+            if (createOrUpdate && !object->_objectSchema.primaryKeyProperty) {
+                @throw RLMException(@"'%@' does not have a primary key and can not be updated",
+                                    object->_objectSchema.className);
+            }
+            info = &realm->_info[object->_objectSchema];
+            previousSchema = object->_objectSchema;
+        }
+        addObjectToRealm(object, realm, *info, createOrUpdate);
+    }
+}
+
+// Validate a value for a property unless the caller has promised that its
+// values are already valid, in which case they are only checked in debug builds
+static void validateValueForProperty(__unsafe_unretained id const value, __unsafe_unretained RLMProperty *const prop,
+                                     RLMCreationOptions options) {
+    if (!(options & RLMCreationOptionsSkipValidation)) {
+        RLMValidateValueForProperty(value, prop);
+        return;
+    }
+    REALM_ASSERT_DEBUG(prop.type == RLMPropertyTypeObject || prop.type == RLMPropertyTypeArray
+                       || RLMIsObjectValidForProperty(value, prop));
+}
+
+static RLMObjectBase *createObjectInRealm(RLMRealm *realm, RLMClassInfo& info,
+                                          id value, RLMCreationOptions options) NS_RETURNS_RETAINED;
+
 RLMObjectBase *RLMCreateObjectInRealmWithValue(RLMRealm *realm, NSString *className,
-                                               id value, bool createOrUpdate = false) {
+                                               id value, RLMCreationOptions options) {
+    RLMVerifyInWriteTransaction(realm);
+    return createObjectInRealm(realm, realm->_info[className], value, options);
+}
+
+RLMObjectBase *RLMCreateObjectInRealmWithValue(RLMRealm *realm, RLMObjectSchema *objectSchema,
+                                               id value, RLMCreationOptions options) {
     RLMVerifyInWriteTransaction(realm);
+    return createObjectInRealm(realm, realm->_info[objectSchema], value, options);
+}
+
+static RLMObjectBase *createObjectInRealm(RLMRealm *realm, RLMClassInfo& info,
+                                          id value, RLMCreationOptions options) {
+    bool createOrUpdate = options & RLMCreationOptionsCreateOrUpdate;
 
     if (createOrUpdate && RLMIsObjectSubclass([value class])) {
         RLMObjectBase *obj = value;
-        if ([obj->_objectSchema.className isEqualToString:className] && obj->_realm == realm) {
+        if ([obj->_objectSchema.className isEqualToString:info.rlmObjectSchema.className] && obj->_realm == realm) {
             // This is a no-op if value is an RLMObject of the same type already backed by the target realm.
             return value;
         }
@@ -339,10 +441,11 @@ RLMObjectBase *RLMCreateObjectInRealmWithValue(RLMRealm *realm, NSString *classN
     }
 
     // create the object
-    auto& info = realm->_info[className];
     RLMObjectBase *object = RLMCreateManagedAccessor(info.rlmObjectSchema.accessorClass, realm, &info);
 
-    RLMCreationOptions creationOptions = createOrUpdate ? RLMCreationOptionsCreateOrUpdate : RLMCreationOptionsNone;
+    RLMCreationOptions creationOptions = options & (RLMCreationOptionsCreateOrUpdate
+                                                    | RLMCreationOptionsUpdateChangedOnly
+                                                    | RLMCreationOptionsSkipValidation);
 
     // create row, and populate
     if (NSArray *array = RLMDynamicCast<NSArray>(value)) {
@@ -373,7 +476,7 @@ RLMObjectBase *RLMCreateObjectInRealmWithValue(RLMRealm *realm, NSString *classN
             if (prop.isPrimary)
                 continue;
 
-            RLMValidateValueForProperty(val, prop);
+            validateValueForProperty(val, prop, creationOptions);
             RLMDynamicSet(object, prop, RLMCoerceToNil(val), creationOptions);
         }
     }
@@ -393,7 +496,7 @@ RLMObjectBase *RLMCreateObjectInRealmWithValue(RLMRealm *realm, NSString *classN
             usedDefault = !propValue && !foundExisting;
             if (usedDefault) {
                 if (!defaultValues) {
-                    defaultValues = RLMDefaultValuesForObjectSchema(info.rlmObjectSchema);
+                    defaultValues = info.defaultValues();
                 }
                 propValue = defaultValues[prop.name];
                 if (!propValue && (prop.type == RLMPropertyTypeObject || prop.type == RLMPropertyTypeArray)) {
@@ -417,7 +520,7 @@ RLMObjectBase *RLMCreateObjectInRealmWithValue(RLMRealm *realm, NSString *classN
                 if (usedDefault) {
                     propertyCreationOptions |= RLMCreationOptionsSetDefault;
                 }
-                RLMValidateValueForProperty(propValue, prop);
+                validateValueForProperty(propValue, prop, creationOptions);
                 RLMDynamicSet(object, prop, RLMCoerceToNil(propValue), propertyCreationOptions);
             }
             else if (!foundExisting && !prop.optional) {
@@ -426,125 +529,2198 @@ RLMObjectBase *RLMCreateObjectInRealmWithValue(RLMRealm *realm, NSString *classN
         }
     }
 
+    updateComputedPropertiesForObject(object);
+
     RLMInitializeSwiftAccessorGenerics(object);
     return object;
 }
 
-void RLMDeleteObjectFromRealm(__unsafe_unretained RLMObjectBase *const object,
-                              __unsafe_unretained RLMRealm *const realm) {
-    if (realm != object->_realm) {
-        @throw RLMException(@"Can only delete an object from the Realm it belongs to.");
+// Write a non-link value directly to the table, bypassing the accessor and the
+// KVO bookkeeping. Only valid for rows which cannot have observers yet.
+static void setColumnValue(Table& table, size_t col, size_t row, __unsafe_unretained RLMProperty *const prop,
+                           __unsafe_unretained id const value, bool setDefault) {
+    if (!value && prop.type != RLMPropertyTypeString && prop.type != RLMPropertyTypeData) {
+        table.set_null(col, row, setDefault);
+        return;
+    }
+    switch (prop.type) {
+        case RLMPropertyTypeInt:
+            table.set_int(col, row, [value longLongValue], setDefault);
+            break;
+        case RLMPropertyTypeFloat:
+            table.set_float(col, row, [value floatValue], setDefault);
+            break;
+        case RLMPropertyTypeDouble:
+            table.set_double(col, row, [value doubleValue], setDefault);
+            break;
+        case RLMPropertyTypeBool:
+            table.set_bool(col, row, [value boolValue], setDefault);
+            break;
+        case RLMPropertyTypeString:
+            table.set_string(col, row, RLMStringDataBuffer(value), setDefault);
+            break;
+        case RLMPropertyTypeDate:
+            table.set_timestamp(col, row, RLMTimestampForNSDate(value), setDefault);
+            break;
+        case RLMPropertyTypeData:
+            table.set_binary(col, row, value ? RLMBinaryDataForNSData(value) : BinaryData(), setDefault);
+            break;
+        default:
+            REALM_UNREACHABLE();
     }
+}
 
-    RLMVerifyInWriteTransaction(object->_realm);
+namespace {
+// A transient map from primary key value to row index for a single batch of
+// objects. Looking up each object in the batch separately is slow for large
+// batches, so instead the rows for all of the keys in the batch are resolved
+// up front, either by probing the search index once per key or, when the batch
+// is large relative to the table, by a single scan over the primary key column.
+class PrimaryKeyRowMap {
+public:
+    PrimaryKeyRowMap(RLMClassInfo const& info, NSArray *keys)
+    : m_table(*info.table())
+    , m_column(info.tableColumn(info.propertyForPrimaryKey()))
+    , m_isString(info.propertyForPrimaryKey().type == RLMPropertyTypeString)
+    {
+        // Past this point scanning the whole column is cheaper than looking up
+        // each key individually
+        const size_t scanThreshold = 8;
+        if (m_table.size() <= keys.count * scanThreshold) {
+            for (size_t row = 0, size = m_table.size(); row < size; ++row) {
+                if (m_table.is_null(m_column, row)) {
+                    m_nullRow = row;
+                }
+                else if (m_isString) {
+                    StringData str = m_table.get_string(m_column, row);
+                    m_strings.emplace(std::string(str.data(), str.size()), row);
+                }
+                else {
+                    m_ints.emplace(m_table.get_int(m_column, row), row);
+                }
+            }
+            return;
+        }
 
-    // move last row to row we are deleting
-    if (object->_row.is_attached()) {
-        RLMTrackDeletions(realm, ^{
-            object->_row.get_table()->move_last_over(object->_row.get_index());
-        });
+        for (__unsafe_unretained id key in keys) {
+            id value = RLMCoerceToNil(key);
+            if (find(value) != realm::not_found) {
+                continue;
+            }
+            size_t row = getRowForObjectWithPrimaryKey(info, value);
+            if (row != realm::not_found) {
+                insert(value, row);
+            }
+        }
     }
 
-    // set realm to nil
-    object->_realm = nil;
-}
+    size_t find(__unsafe_unretained id const key) const {
+        if (!key) {
+            return m_nullRow;
+        }
+        if (m_isString) {
+            auto it = m_strings.find(stringForKey(key));
+            return it == m_strings.end() ? realm::not_found : it->second;
+        }
+        auto it = m_ints.find([key longLongValue]);
+        return it == m_ints.end() ? realm::not_found : it->second;
+    }
 
-void RLMDeleteAllObjectsFromRealm(RLMRealm *realm) {
+    void insert(__unsafe_unretained id const key, size_t row) {
+        if (!key) {
+            m_nullRow = row;
+        }
+        else if (m_isString) {
+            m_strings.emplace(stringForKey(key), row);
+        }
+        else {
+            m_ints.emplace([key longLongValue], row);
+        }
+    }
+
+private:
+    Table& m_table;
+    size_t m_column;
+    bool m_isString;
+    size_t m_nullRow = realm::not_found;
+    std::unordered_map<std::string, size_t> m_strings;
+    std::unordered_map<int64_t, size_t> m_ints;
+
+    static std::string stringForKey(__unsafe_unretained NSString *const key) {
+        RLMStringDataBuffer buffer(key);
+        StringData str = buffer;
+        return std::string(str.data(), str.size());
+    }
+};
+} // anonymous namespace
+
+NSArray *RLMCreateObjectsInRealmWithValues(RLMRealm *realm, NSString *className,
+                                           id<NSFastEnumeration> values, RLMCreationOptions options,
+                                           bool returnObjects, NSUInteger *insertedCount,
+                                           NSUInteger *updatedCount, NSError **error) {
     RLMVerifyInWriteTransaction(realm);
+    bool createOrUpdate = options & RLMCreationOptionsCreateOrUpdate;
 
-    // clear table for each object schema
-    for (auto& info : realm->_info) {
-        RLMClearTable(info.second);
+    NSArray *valueArray = RLMDynamicCast<NSArray>(values);
+    if (!valueArray) {
+        NSMutableArray *copy = [NSMutableArray new];
+        for (id value in values) {
+            [copy addObject:value];
+        }
+        valueArray = copy;
+    }
+    NSUInteger count = valueArray.count;
+    if (insertedCount) {
+        *insertedCount = 0;
+    }
+    if (updatedCount) {
+        *updatedCount = 0;
+    }
+    if (count == 0) {
+        return returnObjects ? @[] : nil;
+    }
+    for (id value in valueArray) {
+        if (value == NSNull.null) {
+            @throw RLMException(@"Must provide a non-nil value.");
+        }
     }
-}
 
-RLMResults *RLMGetObjects(__unsafe_unretained RLMRealm *const realm,
-                          NSString *objectClassName,
-                          NSPredicate *predicate) {
-    RLMVerifyRealmRead(realm);
+    auto& info = realm->_info[className];
+    RLMObjectSchema *objectSchema = info.rlmObjectSchema;
+    NSArray *props = objectSchema.properties;
+    RLMProperty *primaryProperty = info.propertyForPrimaryKey();
+    Table& table = *info.table();
 
-    // create view from table and predicate
-    RLMClassInfo& info = realm->_info[objectClassName];
-    if (!info.table()) {
-        // read-only realms may be missing tables since we can't add any
-        // missing ones on init
-        return [RLMResults resultsWithObjectInfo:info results:{}];
+    if (createOrUpdate && !primaryProperty) {
+        @throw RLMException(@"'%@' does not have a primary key and can not be updated", className);
     }
 
-    if (predicate) {
-        realm::Query query = RLMPredicateToQuery(predicate, info.rlmObjectSchema, realm.schema, realm.group);
-        return [RLMResults resultsWithObjectInfo:info
-                                         results:realm::Results(realm->_realm, std::move(query))];
+    // Everything that depends only on the schema is resolved once for the batch
+    // rather than once per object
+    std::vector<size_t> columns;
+    columns.reserve(props.count);
+    for (RLMProperty *prop in props) {
+        columns.push_back(info.tableColumn(prop));
     }
 
-    return [RLMResults resultsWithObjectInfo:info
-                                     results:realm::Results(realm->_realm, *info.table())];
-}
+    // The default values are resolved separately for each object which needs
+    // them, as they may be generated for each object (such as a new unique
+    // primary key or the current date) and mustn't be shared between them
+    std::vector<id> defaultValues(count);
+
+    // Returns nil for properties which should be left untouched, and sets
+    // `usedDefault` if the value came from the class's default values. Missing
+    // values for existing rows are left as-is rather than replaced with defaults.
+    auto valueForProperty = [&](NSUInteger index, __unsafe_unretained RLMProperty *const prop,
+                                bool foundExisting, bool& usedDefault) -> id {
+        __unsafe_unretained id const value = valueArray[index];
+        usedDefault = false;
+        if (NSArray *array = RLMDynamicCast<NSArray>(value)) {
+            if (array.count > props.count) {
+                @throw RLMException(@"Invalid array input: more values (%llu) than properties (%llu).",
+                                    (unsigned long long)array.count, (unsigned long long)props.count);
+            }
+            if (prop.index >= array.count) {
+                if (prop.isPrimary) {
+                    @throw RLMException(@"Invalid array input: primary key must be present.");
+                }
+                return nil;
+            }
+            id propValue = array[prop.index];
+            validateValueForProperty(propValue, prop, options);
+            return propValue;
+        }
 
-id RLMGetObject(RLMRealm *realm, NSString *objectClassName, id key) {
-    RLMVerifyRealmRead(realm);
+        NSString *key = [value respondsToSelector:prop.getterSel] ? prop.getterName : prop.name;
+        id propValue = RLMValidatedValueForProperty(value, key, objectSchema.className);
+        if (!propValue && foundExisting) {
+            return nil;
+        }
+        if (!propValue) {
+            usedDefault = true;
+            if (!defaultValues[index]) {
+                defaultValues[index] = info.defaultValues() ?: @{};
+            }
+            propValue = defaultValues[index][prop.name];
+            if (!propValue && (prop.type == RLMPropertyTypeObject || prop.type == RLMPropertyTypeArray)) {
+                propValue = NSNull.null;
+            }
+        }
+        if (!propValue) {
+            if (!prop.optional) {
+                @throw RLMException(@"Property '%@' of object of type '%@' cannot be nil.",
+                                    prop.name, objectSchema.className);
+            }
+            return NSNull.null;
+        }
+        validateValueForProperty(propValue, prop, options);
+        return propValue;
+    };
+
+    // Reserve all of the rows up front. Tables with a primary key need to look
+    // up or create each row individually, but everything else can be added in
+    // a single step.
+    std::vector<size_t> rows;
+    std::vector<bool> existing(count, false);
+    rows.reserve(count);
+    NSUInteger inserted = 0;
+
+    // Removes the rows created by the batch if creating any of the objects
+    // fails, so that it doesn't leave empty objects behind, nor the linked
+    // objects already created for the values in other tables. Creating objects
+    // only ever appends rows, so the rows of the batch are the ones past the
+    // size each table had before it. They're removed from the last one so that
+    // moving the last row of the table over each one never moves another row.
+    // Changes made to existing objects when updating them are kept.
+    std::vector<std::pair<Table *, size_t>> tableSizes;
+    for (auto& classInfo : realm->_info) {
+        if (Table *classTable = classInfo.second.table()) {
+            tableSizes.emplace_back(classTable, classTable->size());
+        }
+    }
+    auto removeCreatedRows = [&] {
+        try {
+            for (auto& tableSize : tableSizes) {
+                while (tableSize.first->size() > tableSize.second) {
+                    tableSize.first->move_last_over(tableSize.first->size() - 1);
+                }
+            }
+        }
+        catch (std::exception const& e) {
+            @throw RLMException(e);
+        }
+    };
+
+    @try {
+        try {
+            if (primaryProperty) {
+                bool usedDefault;
+                NSMutableArray *keys = [NSMutableArray arrayWithCapacity:count];
+                for (NSUInteger i = 0; i < count; ++i) {
+                    [keys addObject:valueForProperty(i, primaryProperty, false, usedDefault) ?: NSNull.null];
+                }
 
-    RLMClassInfo& info = realm->_info[objectClassName];
-    auto primaryProperty = info.objectSchema->primary_key_property();
-    if (!primaryProperty) {
-        @throw RLMException(@"%@ does not have a primary key", objectClassName);
+                PrimaryKeyRowMap rowMap(info, keys);
+                for (NSUInteger i = 0; i < count; ++i) {
+                    id primaryValue = RLMCoerceToNil(keys[i]);
+                    size_t row = rowMap.find(primaryValue);
+                    if (row == realm::not_found) {
+                        row = createRowForObjectWithPrimaryKey(info, primaryValue);
+                        rowMap.insert(primaryValue, row);
+                        ++inserted;
+                    }
+                    else if (!createOrUpdate) {
+                        @throw RLMException(@"Can't create object with existing primary key value '%@'.", keys[i]);
+                    }
+                    else {
+                        existing[i] = true;
+                    }
+                    rows.push_back(row);
+                }
+            }
+            else {
+                size_t firstRow = table.add_empty_row(count);
+                for (size_t i = 0; i < count; ++i) {
+                    rows.push_back(firstRow + i);
+                }
+                inserted = count;
+            }
+        }
+        catch (std::exception const& e) {
+            @throw RLMException(e);
+        }
+
+        // Links and lists need an accessor to go through RLMDynamicSet, so share a
+        // single one for all of the rows
+        RLMObjectBase *linkAccessor;
+        RLMCreationOptions linkOptions = options & (RLMCreationOptionsCreateOrUpdate | RLMCreationOptionsSkipValidation);
+
+        // Populate the rows one column at a time
+        for (RLMProperty *prop in props) {
+            if (prop.isPrimary || prop.isFolded || prop.isComputed) {
+                continue;
+            }
+            size_t col = columns[prop.index];
+            size_t foldedCol = prop.foldedPropertyName ? info.tableColumn(prop.foldedPropertyName) : realm::npos;
+            bool isLink = prop.type == RLMPropertyTypeObject || prop.type == RLMPropertyTypeArray;
+            for (NSUInteger i = 0; i < count; ++i) {
+                bool usedDefault;
+                id propValue = valueForProperty(i, prop, existing[i], usedDefault);
+                if (!propValue) {
+                    continue;
+                }
+
+                if (isLink || prop.type == RLMPropertyTypeAny) {
+                    if (!linkAccessor) {
+                        linkAccessor = RLMCreateManagedAccessor(objectSchema.accessorClass, realm, &info);
+                    }
+                    linkAccessor->_row = table[rows[i]];
+                    RLMDynamicSet(linkAccessor, prop, RLMCoerceToNil(propValue),
+                                  usedDefault ? linkOptions | RLMCreationOptionsSetDefault : linkOptions);
+                    continue;
+                }
+
+                try {
+                    // Existing rows may be observed, so go through the accessor for
+                    // them to produce KVO notifications
+                    if (existing[i]) {
+                        if (!linkAccessor) {
+                            linkAccessor = RLMCreateManagedAccessor(objectSchema.accessorClass, realm, &info);
+                        }
+                        linkAccessor->_row = table[rows[i]];
+                        RLMDynamicSet(linkAccessor, prop, RLMCoerceToNil(propValue), linkOptions);
+                    }
+                    else {
+                        setColumnValue(table, col, rows[i], prop, RLMCoerceToNil(propValue), usedDefault);
+                        if (foldedCol != realm::npos) {
+                            setColumnValue(table, foldedCol, rows[i], prop, RLMFoldedString(RLMCoerceToNil(propValue)), usedDefault);
+                        }
+                    }
+                }
+                catch (std::exception const& e) {
+                    @throw RLMException(e);
+                }
+            }
+        }
+
+        // Computed properties depend on the other columns, so they're
+        // written once all of those have been
+        if (RLMObjectSchemaHasComputedProperties(objectSchema)) {
+            try {
+                for (size_t row : rows) {
+                    info.updateComputedProperties(row);
+                }
+            }
+            catch (std::exception const& e) {
+                @throw RLMException(e);
+            }
+        }
+    }
+    @catch (NSException *e) {
+        removeCreatedRows();
+        RLMSetErrorOrThrow(RLMMakeError(e), error);
+        return nil;
     }
 
-    auto table = info.table();
-    if (!table) {
-        // read-only realms may be missing tables since we can't add any
-        // missing ones on init
+    if (insertedCount) {
+        *insertedCount = inserted;
+    }
+    if (updatedCount) {
+        *updatedCount = count - inserted;
+    }
+    if (!returnObjects) {
         return nil;
     }
+    NSMutableArray *objects = [NSMutableArray arrayWithCapacity:count];
+    for (size_t row : rows) {
+        [objects addObject:RLMCreateObjectAccessor(realm, info, row)];
+    }
+    return objects;
+}
 
-    key = RLMCoerceToNil(key);
-    if (!key && !primaryProperty->is_nullable) {
-        @throw RLMException(@"Invalid null value for non-nullable primary key.");
+namespace {
+// Copies rows, along with the rows they link to, from one Realm to another by
+// reading and writing the column values directly rather than going through
+// accessors and KVC. Each source row is copied at most once, and rows of
+// classes with a primary key are matched against the existing rows of the
+// destination Realm by key, so shared link targets aren't duplicated.
+class ObjectGraphCopier {
+public:
+    ObjectGraphCopier(RLMRealm *realm, bool updateExisting)
+    : m_realm(realm), m_updateExisting(updateExisting) { }
+
+    // Get the destination info for a source class, verifying the first time
+    // that the two schemas agree on its persisted properties
+    RLMClassInfo& destinationInfo(RLMClassInfo& source);
+
+    // Find or allocate the destination rows for some rows of a source class.
+    // The new rows are only populated by populateRows().
+    std::vector<size_t> reserveRows(RLMClassInfo& source, std::vector<size_t> const& rows);
+
+    // Populate every row reserved so far, along with the rows reserved for
+    // their link targets while doing so
+    void populateRows();
+
+private:
+    struct PendingRow {
+        RLMClassInfo *source;
+        RLMClassInfo *destination;
+        size_t sourceRow;
+        size_t row;
+        bool existing;
+    };
+
+    RLMRealm *m_realm;
+    bool m_updateExisting;
+    std::map<std::pair<RLMClassInfo *, size_t>, size_t> m_copiedRows;
+    std::unordered_map<RLMClassInfo *, RLMClassInfo *> m_destinations;
+    std::vector<PendingRow> m_pending;
+
+    size_t rowForLinkTarget(RLMClassInfo& source, size_t row);
+    void populate(PendingRow const& pending);
+    void update(PendingRow const& pending);
+};
+
+RLMClassInfo& ObjectGraphCopier::destinationInfo(RLMClassInfo& source) {
+    auto it = m_destinations.find(&source);
+    if (it != m_destinations.end()) {
+        return *it->second;
     }
 
-    size_t row = realm::not_found;
-    switch (primaryProperty->type) {
-        case PropertyType::String: {
-            NSString *string = RLMDynamicCast<NSString>(key);
-            if (!key || string) {
-                row = table->find_first_string(primaryProperty->table_column, RLMStringDataWithNSString(string));
-            } else {
-                @throw RLMException(@"Invalid value '%@' of type '%@' for string primary key.", key, [key class]);
-            }
-            break;
+    RLMObjectSchema *sourceSchema = source.rlmObjectSchema;
+    NSString *className = sourceSchema.className;
+    if (![m_realm.schema schemaForClassName:className]) {
+        @throw RLMException(@"Cannot copy objects of type '%@': the class is not in the destination Realm's schema.",
+                            className);
+    }
+    auto& destination = m_realm->_info[className];
+    RLMProperty *primary = destination.propertyForPrimaryKey();
+    RLMProperty *sourcePrimary = source.propertyForPrimaryKey();
+    if (!primary != !sourcePrimary || (primary && ![primary.name isEqualToString:sourcePrimary.name])) {
+        @throw RLMException(@"Cannot copy objects of type '%@': the primary key differs between the two Realms.",
+                            className);
+    }
+    for (RLMProperty *prop in destination.rlmObjectSchema.properties) {
+        if (prop.isFolded || prop.isComputed) {
+            continue;
         }
-        case PropertyType::Int:
-            if (NSNumber *number = RLMDynamicCast<NSNumber>(key)) {
-                row = table->find_first_int(primaryProperty->table_column, number.longLongValue);
-            } else if (!key) {
-                row = table->find_first_null(primaryProperty->table_column);
-            } else {
-                @throw RLMException(@"Invalid value '%@' of type '%@' for int primary key.", key, [key class]);
+        RLMProperty *sourceProp = sourceSchema[prop.name];
+        if (!sourceProp || sourceProp.type != prop.type || sourceProp.optional != prop.optional
+            || (prop.objectClassName && ![prop.objectClassName isEqualToString:sourceProp.objectClassName])) {
+            @throw RLMException(@"Cannot copy objects of type '%@': property '%@' differs between the two Realms.",
+                                className, prop.name);
+        }
+    }
+    m_destinations[&source] = &destination;
+    return destination;
+}
+
+static id primaryKeyValueForRow(RLMClassInfo const& info, size_t row) {
+    RLMProperty *prop = info.propertyForPrimaryKey();
+    size_t col = info.tableColumn(prop);
+    Table const& table = *info.table();
+    if (table.is_null(col, row)) {
+        return NSNull.null;
+    }
+    if (prop.type == RLMPropertyTypeString) {
+        return RLMStringDataToNSString(table.get_string(col, row));
+    }
+    return @(table.get_int(col, row));
+}
+
+std::vector<size_t> ObjectGraphCopier::reserveRows(RLMClassInfo& source, std::vector<size_t> const& rows) {
+    auto& destination = destinationInfo(source);
+
+    // The rows which haven't already been copied, without duplicates
+    std::vector<size_t> newRows;
+    for (size_t row : rows) {
+        auto inserted = m_copiedRows.emplace(std::make_pair(&source, row), realm::npos);
+        if (inserted.second) {
+            newRows.push_back(row);
+        }
+    }
+
+    if (!newRows.empty() && destination.propertyForPrimaryKey()) {
+        NSMutableArray *keys = [NSMutableArray arrayWithCapacity:newRows.size()];
+        for (size_t row : newRows) {
+            [keys addObject:primaryKeyValueForRow(source, row)];
+        }
+        PrimaryKeyRowMap rowMap(destination, keys);
+        for (size_t i = 0; i < newRows.size(); ++i) {
+            id primaryValue = RLMCoerceToNil(keys[i]);
+            size_t row = rowMap.find(primaryValue);
+            bool existing = row != realm::not_found;
+            if (!existing) {
+                row = createRowForObjectWithPrimaryKey(destination, primaryValue);
+                rowMap.insert(primaryValue, row);
             }
-            break;
-        default:
-            REALM_UNREACHABLE();
+            m_copiedRows[{&source, newRows[i]}] = row;
+            // Existing objects are only linked to unless they're being updated
+            if (!existing || m_updateExisting) {
+                m_pending.push_back({&source, &destination, newRows[i], row, existing});
+            }
+        }
+    }
+    else if (!newRows.empty()) {
+        size_t firstRow = destination.table()->add_empty_row(newRows.size());
+        for (size_t i = 0; i < newRows.size(); ++i) {
+            m_copiedRows[{&source, newRows[i]}] = firstRow + i;
+            m_pending.push_back({&source, &destination, newRows[i], firstRow + i, false});
+        }
     }
 
-    if (row == realm::not_found) {
-        return nil;
+    std::vector<size_t> result;
+    result.reserve(rows.size());
+    for (size_t row : rows) {
+        result.push_back(m_copiedRows[{&source, row}]);
     }
+    return result;
+}
 
-    return RLMCreateObjectAccessor(realm, info, row);
+size_t ObjectGraphCopier::rowForLinkTarget(RLMClassInfo& source, size_t row) {
+    auto it = m_copiedRows.find({&source, row});
+    if (it != m_copiedRows.end()) {
+        return it->second;
+    }
+    return reserveRows(source, {row}).front();
 }
 
-RLMObjectBase *RLMCreateObjectAccessor(__unsafe_unretained RLMRealm *const realm,
-                                       RLMClassInfo& info,
-                                       NSUInteger index) {
-    return RLMCreateObjectAccessor(realm, info, (*info.table())[index]);
+void ObjectGraphCopier::populateRows() {
+    // Populating a row can reserve more rows for its link targets, so this
+    // can't use iterators
+    for (size_t i = 0; i < m_pending.size(); ++i) {
+        PendingRow pending = m_pending[i];
+        if (pending.existing) {
+            update(pending);
+        }
+        else {
+            populate(pending);
+        }
+    }
+    m_pending.clear();
 }
 
-// Create accessor and register with realm
-RLMObjectBase *RLMCreateObjectAccessor(__unsafe_unretained RLMRealm *const realm,
-                                       RLMClassInfo& info,
-                                       realm::RowExpr row) {
-    RLMObjectBase *accessor = RLMCreateManagedAccessor(info.rlmObjectSchema.accessorClass, realm, &info);
+void ObjectGraphCopier::populate(PendingRow const& pending) {
+    auto& source = *pending.source;
+    auto& destination = *pending.destination;
+    Table& sourceTable = *source.table();
+    Table& table = *destination.table();
+    size_t sourceRow = pending.sourceRow, row = pending.row;
+    RLMObjectSchema *sourceSchema = source.rlmObjectSchema;
+
+    for (RLMProperty *prop in destination.rlmObjectSchema.properties) {
+        if (prop.isPrimary || prop.isFolded || prop.isComputed) {
+            continue;
+        }
+        RLMProperty *sourceProp = sourceSchema[prop.name];
+        size_t sourceCol = source.tableColumn(sourceProp);
+        size_t col = destination.tableColumn(prop);
+
+        switch (prop.type) {
+            case RLMPropertyTypeObject:
+                if (!sourceTable.is_null_link(sourceCol, sourceRow)) {
+                    size_t target = rowForLinkTarget(source.linkTargetType(sourceProp.index),
+                                                     sourceTable.get_link(sourceCol, sourceRow));
+                    table.set_link(col, row, target);
+                }
+                continue;
+            case RLMPropertyTypeArray: {
+                auto sourceList = sourceTable.get_linklist(sourceCol, sourceRow);
+                if (sourceList->is_empty()) {
+                    continue;
+                }
+                auto& targetInfo = source.linkTargetType(sourceProp.index);
+                auto list = table.get_linklist(col, row);
+                for (size_t i = 0, size = sourceList->size(); i < size; ++i) {
+                    list->add(rowForLinkTarget(targetInfo, sourceList->get_target_row(i)));
+                }
+                continue;
+            }
+            case RLMPropertyTypeAny: {
+                // Mixed values have no direct column copy, so go through the accessors
+                RLMObjectBase *sourceObject = RLMCreateObjectAccessor(source.realm, source, sourceRow);
+                RLMObjectBase *object = RLMCreateObjectAccessor(m_realm, destination, row);
+                RLMDynamicSet(object, prop, RLMDynamicGet(sourceObject, sourceProp), RLMCreationOptionsNone);
+                continue;
+            }
+            case RLMPropertyTypeLinkingObjects:
+                continue;
+            default:
+                break;
+        }
+
+        if (prop.optional && sourceTable.is_null(sourceCol, sourceRow)) {
+            table.set_null(col, row);
+            continue;
+        }
+        switch (prop.type) {
+            case RLMPropertyTypeInt:
+                table.set_int(col, row, sourceTable.get_int(sourceCol, sourceRow));
+                break;
+            case RLMPropertyTypeBool:
+                table.set_bool(col, row, sourceTable.get_bool(sourceCol, sourceRow));
+                break;
+            case RLMPropertyTypeFloat:
+                table.set_float(col, row, sourceTable.get_float(sourceCol, sourceRow));
+                break;
+            case RLMPropertyTypeDouble:
+                table.set_double(col, row, sourceTable.get_double(sourceCol, sourceRow));
+                break;
+            case RLMPropertyTypeDate:
+                table.set_timestamp(col, row, sourceTable.get_timestamp(sourceCol, sourceRow));
+                break;
+            case RLMPropertyTypeData:
+                table.set_binary(col, row, sourceTable.get_binary(sourceCol, sourceRow));
+                break;
+            case RLMPropertyTypeString: {
+                StringData value = sourceTable.get_string(sourceCol, sourceRow);
+                table.set_string(col, row, value);
+                if (prop.foldedPropertyName) {
+                    setColumnValue(table, destination.tableColumn(prop.foldedPropertyName), row, prop,
+                                   RLMFoldedString(RLMStringDataToNSString(value)), false);
+                }
+                break;
+            }
+            default:
+                REALM_UNREACHABLE();
+        }
+    }
+
+    if (RLMObjectSchemaHasComputedProperties(destination.rlmObjectSchema)) {
+        destination.updateComputedProperties(row);
+    }
+}
+
+// Existing rows may be observed, so they're updated through an accessor to
+// produce KVO notifications
+void ObjectGraphCopier::update(PendingRow const& pending) {
+    auto& source = *pending.source;
+    auto& destination = *pending.destination;
+    RLMObjectSchema *sourceSchema = source.rlmObjectSchema;
+    RLMObjectBase *sourceObject = RLMCreateObjectAccessor(source.realm, source, pending.sourceRow);
+    RLMObjectBase *object = RLMCreateObjectAccessor(m_realm, destination, pending.row);
+    Table& sourceTable = *source.table();
+
+    for (RLMProperty *prop in destination.rlmObjectSchema.properties) {
+        if (prop.isPrimary || prop.isFolded || prop.isComputed) {
+            continue;
+        }
+        RLMProperty *sourceProp = sourceSchema[prop.name];
+        size_t sourceCol = source.tableColumn(sourceProp);
+        id value;
+        if (prop.type == RLMPropertyTypeObject) {
+            if (!sourceTable.is_null_link(sourceCol, pending.sourceRow)) {
+                auto& targetInfo = source.linkTargetType(sourceProp.index);
+                size_t target = rowForLinkTarget(targetInfo, sourceTable.get_link(sourceCol, pending.sourceRow));
+                value = RLMCreateObjectAccessor(m_realm, destinationInfo(targetInfo), target);
+            }
+        }
+        else if (prop.type == RLMPropertyTypeArray) {
+            auto sourceList = sourceTable.get_linklist(sourceCol, pending.sourceRow);
+            auto& targetInfo = source.linkTargetType(sourceProp.index);
+            auto& targetDestination = destinationInfo(targetInfo);
+            NSMutableArray *targets = [NSMutableArray arrayWithCapacity:sourceList->size()];
+            for (size_t i = 0, size = sourceList->size(); i < size; ++i) {
+                size_t target = rowForLinkTarget(targetInfo, sourceList->get_target_row(i));
+                [targets addObject:RLMCreateObjectAccessor(m_realm, targetDestination, target)];
+            }
+            value = targets;
+        }
+        else {
+            value = RLMCoerceToNil(RLMDynamicGet(sourceObject, sourceProp));
+        }
+        RLMDynamicSet(object, prop, value, RLMCreationOptionsNone);
+    }
+}
+} // anonymous namespace
+
+NSArray *RLMCopyObjectsFromRealm(RLMRealm *realm, RLMRealm *sourceRealm, id<NSFastEnumeration> objects,
+                                 bool updateExisting) {
+    RLMVerifyInWriteTransaction(realm);
+    RLMVerifyRealmRead(sourceRealm);
+    if (realm->_realm->config().path == sourceRealm->_realm->config().path) {
+        @throw RLMException(@"Cannot copy objects into the Realm file they are stored in.");
+    }
+
+    // Group the objects by class so that the rows for each class can be
+    // looked up and allocated in a single batch
+    std::vector<std::pair<RLMClassInfo *, size_t>> sources;
+    std::vector<RLMClassInfo *> classes;
+    std::unordered_map<RLMClassInfo *, std::vector<size_t>> rowsByClass;
+    for (__unsafe_unretained RLMObjectBase *object in objects) {
+        if (![object isKindOfClass:[RLMObjectBase class]] || object->_realm != sourceRealm) {
+            @throw RLMException(@"Objects to copy must be managed by the source Realm.");
+        }
+        if (!object->_row.is_attached()) {
+            @throw RLMException(@"Object has been deleted or invalidated.");
+        }
+        auto& rows = rowsByClass[object->_info];
+        if (rows.empty()) {
+            classes.push_back(object->_info);
+        }
+        rows.push_back(object->_row.get_index());
+        sources.emplace_back(object->_info, object->_row.get_index());
+    }
+
+    ObjectGraphCopier copier(realm, updateExisting);
+    std::map<std::pair<RLMClassInfo *, size_t>, size_t> copiedRows;
+    try {
+        for (auto info : classes) {
+            auto const& rows = rowsByClass[info];
+            auto copies = copier.reserveRows(*info, rows);
+            for (size_t i = 0; i < rows.size(); ++i) {
+                copiedRows[{info, rows[i]}] = copies[i];
+            }
+        }
+        copier.populateRows();
+    }
+    catch (std::exception const& e) {
+        @throw RLMException(e);
+    }
+
+    NSMutableArray *copies = [NSMutableArray arrayWithCapacity:sources.size()];
+    for (auto const& source : sources) {
+        [copies addObject:RLMCreateObjectAccessor(realm, copier.destinationInfo(*source.first),
+                                                  copiedRows[source])];
+    }
+    return copies;
+}
+
+namespace {
+// A column buffer which has been validated for the property it is being
+// appended to
+struct ColumnSource {
+    RLMProperty *prop;
+    size_t col;
+    const char *values;
+    const int32_t *offsets;
+    const uint8_t *validity;
+
+    bool isNull(size_t i) const {
+        return validity && !(validity[i / 8] & (1 << (i % 8)));
+    }
+
+    // Booleans are packed one per bit, like the validity bitmap
+    bool boolean(size_t i) const {
+        return values[i / 8] & (1 << (i % 8));
+    }
+
+    template<typename T>
+    T get(size_t i) const {
+        // The buffers may not be aligned for T
+        T value;
+        memcpy(&value, values + i * sizeof(T), sizeof(T));
+        return value;
+    }
+
+    StringData string(size_t i) const {
+        return StringData(values + offsets[i], offsets[i + 1] - offsets[i]);
+    }
+    BinaryData binary(size_t i) const {
+        return BinaryData(values + offsets[i], offsets[i + 1] - offsets[i]);
+    }
+};
+
+size_t columnBufferValueSize(RLMPropertyType type) {
+    switch (type) {
+        case RLMPropertyTypeInt:
+        case RLMPropertyTypeDate:
+            return sizeof(int64_t);
+        case RLMPropertyTypeFloat:
+            return sizeof(float);
+        case RLMPropertyTypeDouble:
+            return sizeof(double);
+        default:
+            return 0;
+    }
+}
+
+// Whether the bytes are well-formed UTF-8, which core requires strings to be
+// but doesn't check: no overlong or truncated sequences, surrogates or code
+// points past U+10FFFF
+bool isValidUTF8(const char *data, size_t size) {
+    auto str = reinterpret_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size;) {
+        unsigned char c = str[i];
+        if (c < 0x80) {
+            ++i;
+            continue;
+        }
+        size_t length;
+        uint32_t codePoint, minimum;
+        if ((c & 0xE0) == 0xC0) {
+            length = 2, codePoint = c & 0x1F, minimum = 0x80;
+        }
+        else if ((c & 0xF0) == 0xE0) {
+            length = 3, codePoint = c & 0x0F, minimum = 0x800;
+        }
+        else if ((c & 0xF8) == 0xF0) {
+            length = 4, codePoint = c & 0x07, minimum = 0x10000;
+        }
+        else {
+            return false;
+        }
+        if (size - i < length) {
+            return false;
+        }
+        for (size_t j = 1; j < length; ++j) {
+            if ((str[i + j] & 0xC0) != 0x80) {
+                return false;
+            }
+            codePoint = (codePoint << 6) | (str[i + j] & 0x3F);
+        }
+        if (codePoint < minimum || codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF)) {
+            return false;
+        }
+        i += length;
+    }
+    return true;
+}
+
+// Throws if a property which can't be nil has no default value to append
+void validateDefaultValue(id value, RLMProperty *prop, NSString *className) {
+    if (!value && !prop.optional && prop.type != RLMPropertyTypeObject && prop.type != RLMPropertyTypeArray) {
+        @throw RLMException(@"Property '%@' of object of type '%@' cannot be nil.", prop.name, className);
+    }
+}
+
+// Returns a description of why the buffer can't be appended to the property,
+// or nil if it can
+NSString *validateColumnBuffer(RLMColumnBuffer *buffer, RLMProperty *prop, NSUInteger rowCount) {
+    NSData *validity = buffer.validity;
+    if (validity) {
+        if (validity.length < (rowCount + 7) / 8) {
+            return [NSString stringWithFormat:@"The validity bitmap for property '%@' is too short for %zu objects.",
+                    prop.name, (size_t)rowCount];
+        }
+        if (!prop.optional) {
+            auto bits = static_cast<const uint8_t *>(validity.bytes);
+            for (NSUInteger i = 0; i < rowCount; ++i) {
+                if (!(bits[i / 8] & (1 << (i % 8)))) {
+                    return [NSString stringWithFormat:@"Property '%@' cannot be nil, but the value for object %zu is nil.",
+                            prop.name, (size_t)i];
+                }
+            }
+        }
+    }
+
+    if (prop.type == RLMPropertyTypeBool) {
+        if (buffer.values.length < (rowCount + 7) / 8) {
+            return [NSString stringWithFormat:@"The values for property '%@' are too short for %zu objects.",
+                    prop.name, (size_t)rowCount];
+        }
+        return nil;
+    }
+    if (size_t size = columnBufferValueSize(prop.type)) {
+        if (buffer.values.length < rowCount * size) {
+            return [NSString stringWithFormat:@"The values for property '%@' are too short for %zu objects.",
+                    prop.name, (size_t)rowCount];
+        }
+        return nil;
+    }
+
+    NSData *offsetData = buffer.offsets;
+    if (offsetData.length < (rowCount + 1) * sizeof(int32_t)) {
+        return [NSString stringWithFormat:@"The offsets for property '%@' are missing or too short for %zu objects.",
+                prop.name, (size_t)rowCount];
+    }
+    size_t maxSize = prop.type == RLMPropertyTypeString ? Table::max_string_size : Table::max_binary_size;
+    auto offsets = static_cast<const int32_t *>(offsetData.bytes);
+    auto bits = static_cast<const uint8_t *>(validity.bytes);
+    if (offsets[0] < 0 || static_cast<NSUInteger>(offsets[rowCount]) > buffer.values.length) {
+        return [NSString stringWithFormat:@"The offsets for property '%@' are outside of its values.", prop.name];
+    }
+    for (NSUInteger i = 0; i < rowCount; ++i) {
+        if (offsets[i + 1] < offsets[i]) {
+            return [NSString stringWithFormat:@"The offsets for property '%@' are not in ascending order.", prop.name];
+        }
+        if (static_cast<size_t>(offsets[i + 1] - offsets[i]) > maxSize) {
+            return [NSString stringWithFormat:@"The value for object %zu of property '%@' is too large.",
+                    (size_t)i, prop.name];
+        }
+        if (prop.vectorDimension && (!bits || (bits[i / 8] & (1 << (i % 8))))
+            && static_cast<size_t>(offsets[i + 1] - offsets[i]) != prop.vectorDimension * sizeof(float)) {
+            return [NSString stringWithFormat:@"The value for object %zu of vector property '%@' must be %llu floats (%llu bytes), but is %llu bytes.",
+                    (size_t)i, prop.name, (unsigned long long)prop.vectorDimension,
+                    (unsigned long long)(prop.vectorDimension * sizeof(float)),
+                    (unsigned long long)(offsets[i + 1] - offsets[i])];
+        }
+    }
+    if (prop.type == RLMPropertyTypeString) {
+        auto values = static_cast<const char *>(buffer.values.bytes);
+        for (NSUInteger i = 0; i < rowCount; ++i) {
+            if (bits && !(bits[i / 8] & (1 << (i % 8)))) {
+                continue;
+            }
+            if (!isValidUTF8(values + offsets[i], offsets[i + 1] - offsets[i])) {
+                return [NSString stringWithFormat:@"The value for object %zu of property '%@' is not valid UTF-8.",
+                        (size_t)i, prop.name];
+            }
+        }
+    }
+    return nil;
+}
+} // anonymous namespace
+
+BOOL RLMAppendColumnsToRealm(RLMRealm *realm, NSString *className,
+                             NSDictionary<NSString *, RLMColumnBuffer *> *columns,
+                             NSUInteger rowCount, NSError **error) {
+    RLMVerifyInWriteTransaction(realm);
+    auto& info = realm->_info[className];
+    RLMObjectSchema *objectSchema = info.rlmObjectSchema;
+    RLMProperty *primaryProperty = info.propertyForPrimaryKey();
+
+    for (NSString *name in columns) {
+        RLMProperty *prop = objectSchema[name];
+        if (!prop) {
+            @throw RLMException(@"Invalid property name '%@' for class '%@'.", name, className);
+        }
+        switch (prop.type) {
+            case RLMPropertyTypeObject:
+            case RLMPropertyTypeArray:
+            case RLMPropertyTypeLinkingObjects:
+            case RLMPropertyTypeAny:
+                @throw RLMException(@"Cannot append %@ property '%@'.", RLMTypeToString(prop.type), name);
+            default:
+                break;
+        }
+        if (prop.isFolded || prop.isComputed) {
+            @throw RLMException(@"Cannot append derived property '%@'.", name);
+        }
+    }
+
+    // Resolve all of the buffers before appending anything. Properties without
+    // a column are set to their default values, which are resolved separately
+    // for each row as they may be generated for each object. The first row's
+    // are resolved here to check that the required properties have one.
+    NSDictionary *firstDefaultValues = nil;
+    std::vector<ColumnSource> sources;
+    std::vector<RLMProperty *> defaultedProperties;
+    ColumnSource const* primarySource = nullptr;
+    for (RLMProperty *prop in objectSchema.properties) {
+        if (prop.isFolded || prop.isComputed) {
+            continue;
+        }
+        RLMColumnBuffer *buffer = columns[prop.name];
+        if (!buffer) {
+            if (prop.isPrimary) {
+                @throw RLMException(@"Primary key property '%@' must be given a column.", prop.name);
+            }
+            if (!firstDefaultValues) {
+                firstDefaultValues = info.defaultValues() ?: @{};
+            }
+            validateDefaultValue(firstDefaultValues[prop.name], prop, className);
+            defaultedProperties.push_back(prop);
+            continue;
+        }
+
+        if (NSString *reason = validateColumnBuffer(buffer, prop, rowCount)) {
+            RLMSetErrorOrThrow([NSError errorWithDomain:RLMErrorDomain code:RLMErrorFail
+                                               userInfo:@{NSLocalizedDescriptionKey: reason}], error);
+            return NO;
+        }
+        sources.push_back({prop, info.tableColumn(prop), static_cast<const char *>(buffer.values.bytes),
+                           static_cast<const int32_t *>(buffer.offsets.bytes),
+                           static_cast<const uint8_t *>(buffer.validity.bytes)});
+    }
+    for (auto const& source : sources) {
+        if (source.prop.isPrimary) {
+            primarySource = &source;
+        }
+    }
+    if (rowCount == 0) {
+        return YES;
+    }
+
+    Table& table = *info.table();
+    NSMutableArray *keys;
+    try {
+        if (primarySource) {
+            keys = [NSMutableArray arrayWithCapacity:rowCount];
+            for (size_t i = 0; i < rowCount; ++i) {
+                if (primarySource->isNull(i)) {
+                    [keys addObject:NSNull.null];
+                }
+                else if (primaryProperty.type == RLMPropertyTypeString) {
+                    [keys addObject:RLMStringDataToNSString(primarySource->string(i))];
+                }
+                else {
+                    [keys addObject:@(primarySource->get<int64_t>(i))];
+                }
+            }
+
+            // Check for keys which already exist, either in the table or
+            // earlier in the batch, before adding any rows
+            PrimaryKeyRowMap rowMap(info, keys);
+            for (size_t i = 0; i < rowCount; ++i) {
+                id key = RLMCoerceToNil(keys[i]);
+                if (rowMap.find(key) != realm::not_found) {
+                    @throw RLMException(@"Can't create object with existing primary key value '%@'.", keys[i]);
+                }
+                // The row is only a placeholder until the rows are added
+                rowMap.insert(key, i);
+            }
+        }
+    }
+    catch (std::exception const& e) {
+        @throw RLMException(e);
+    }
+
+    // Removes the appended rows if adding or populating them fails, so that a
+    // failure doesn't leave partially populated objects behind, nor the linked
+    // objects already created for the default values in other tables. Rows are
+    // only ever appended, so the rows of the batch are the ones past the size
+    // each table had before, and they're removed from the last one so that
+    // moving the last row over each one never moves another row.
+    std::vector<std::pair<Table *, size_t>> tableSizes;
+    for (auto& classInfo : realm->_info) {
+        if (Table *classTable = classInfo.second.table()) {
+            tableSizes.emplace_back(classTable, classTable->size());
+        }
+    }
+
+    @try {
+        try {
+            size_t firstRow = table.size();
+            if (keys) {
+                for (id key in keys) {
+                    createRowForObjectWithPrimaryKey(info, RLMCoerceToNil(key));
+                }
+            }
+            else {
+                table.add_empty_row(rowCount);
+            }
+
+            // Populate the rows one column at a time. New rows are null in every
+            // nullable column, so null values don't need to be written.
+            for (auto const& source : sources) {
+                RLMProperty *prop = source.prop;
+                if (prop.isPrimary) {
+                    continue;
+                }
+                size_t col = source.col;
+                size_t foldedCol = prop.foldedPropertyName ? info.tableColumn(prop.foldedPropertyName) : realm::npos;
+                for (size_t i = 0; i < rowCount; ++i) {
+                    if (source.isNull(i)) {
+                        continue;
+                    }
+                    size_t row = firstRow + i;
+                    switch (prop.type) {
+                        case RLMPropertyTypeInt:
+                            table.set_int(col, row, source.get<int64_t>(i));
+                            break;
+                        case RLMPropertyTypeBool:
+                            table.set_bool(col, row, source.boolean(i));
+                            break;
+                        case RLMPropertyTypeFloat:
+                            table.set_float(col, row, source.get<float>(i));
+                            break;
+                        case RLMPropertyTypeDouble:
+                            table.set_double(col, row, source.get<double>(i));
+                            break;
+                        case RLMPropertyTypeDate: {
+                            // Seconds and nanoseconds truncate towards zero, so
+                            // they have the same sign as required by Timestamp
+                            int64_t milliseconds = source.get<int64_t>(i);
+                            table.set_timestamp(col, row, Timestamp(milliseconds / 1000,
+                                                                    static_cast<int32_t>(milliseconds % 1000) * 1'000'000));
+                            break;
+                        }
+                        case RLMPropertyTypeString: {
+                            StringData value = source.string(i);
+                            table.set_string(col, row, value);
+                            if (foldedCol != realm::npos) {
+                                setColumnValue(table, foldedCol, row, prop,
+                                               RLMFoldedString(RLMStringDataToNSString(value)), false);
+                            }
+                            break;
+                        }
+                        case RLMPropertyTypeData:
+                            table.set_binary(col, row, source.binary(i));
+                            break;
+                        default:
+                            REALM_UNREACHABLE();
+                    }
+                }
+            }
+
+            // Links, lists and mixed values need an accessor to set their
+            // defaults, so share a single one for all of the rows
+            RLMObjectBase *accessor;
+            for (size_t i = 0; i < rowCount && !defaultedProperties.empty(); ++i) @autoreleasepool {
+                NSDictionary *defaultValues = i == 0 ? firstDefaultValues : info.defaultValues();
+                size_t row = firstRow + i;
+                for (RLMProperty *prop : defaultedProperties) {
+                    id value = defaultValues[prop.name];
+                    validateDefaultValue(value, prop, className);
+                    if (!value) {
+                        continue;
+                    }
+                    if (prop.type == RLMPropertyTypeObject || prop.type == RLMPropertyTypeArray
+                        || prop.type == RLMPropertyTypeAny) {
+                        if (!accessor) {
+                            accessor = RLMCreateManagedAccessor(objectSchema.accessorClass, realm, &info);
+                        }
+                        accessor->_row = table[row];
+                        RLMDynamicSet(accessor, prop, RLMCoerceToNil(value), RLMCreationOptionsSetDefault);
+                        continue;
+                    }
+                    setColumnValue(table, info.tableColumn(prop), row, prop, RLMCoerceToNil(value), true);
+                    if (prop.foldedPropertyName) {
+                        setColumnValue(table, info.tableColumn(prop.foldedPropertyName), row, prop,
+                                       RLMFoldedString(RLMCoerceToNil(value)), true);
+                    }
+                }
+            }
+
+            if (RLMObjectSchemaHasComputedProperties(objectSchema)) {
+                for (size_t i = 0; i < rowCount; ++i) {
+                    info.updateComputedProperties(firstRow + i);
+                }
+            }
+        }
+        catch (std::exception const& e) {
+            @throw RLMException(e);
+        }
+    }
+    @catch (NSException *e) {
+        try {
+            for (auto& tableSize : tableSizes) {
+                while (tableSize.first->size() > tableSize.second) {
+                    tableSize.first->move_last_over(tableSize.first->size() - 1);
+                }
+            }
+        }
+        catch (std::exception const& e) {
+            @throw RLMException(e);
+        }
+        RLMSetErrorOrThrow(RLMMakeError(e), error);
+        return NO;
+    }
+    return YES;
+}
+
+namespace {
+// A minimal incremental parser for a JSON document whose top-level value is an
+// array. The stream is read in fixed-size chunks and only a single element of
+// the top-level array is materialized at a time, so memory use depends on the
+// size of the largest element rather than the size of the document.
+class JSONStreamParser {
+public:
+    JSONStreamParser(NSInputStream *stream) : m_stream(stream), m_buffer(64 * 1024) { }
+
+    // Consume the opening bracket of the top-level array
+    void beginArray() {
+        skipWhitespace();
+        if (get() != '[') {
+            fail("Expected the JSON document to be an array");
+        }
+        m_first = true;
+    }
+
+    // Parse the next element of the top-level array, or return nil once the
+    // end of the array has been reached
+    id nextElement() {
+        skipWhitespace();
+        int c = peek();
+        if (c == ']') {
+            get();
+            skipWhitespace();
+            if (peek() != -1) {
+                fail("Unexpected data after the end of the array");
+            }
+            return nil;
+        }
+        if (!m_first) {
+            if (get() != ',') {
+                fail("Expected ',' or ']'");
+            }
+        }
+        m_first = false;
+        return parseValue(0);
+    }
+
+    // The error reported by the stream if reading from it failed
+    NSError *streamError() const { return m_streamError; }
+
+private:
+    static constexpr size_t s_maxDepth = 512;
+
+    __unsafe_unretained NSInputStream *const m_stream;
+    NSError *m_streamError = nil;
+    std::vector<uint8_t> m_buffer;
+    size_t m_pos = 0, m_end = 0;
+    size_t m_offset = 0;
+    bool m_eof = false;
+    bool m_first = true;
+    std::string m_scratch;
+
+    [[noreturn]] void fail(const char *message) {
+        throw std::runtime_error("Invalid JSON at offset " + std::to_string(m_offset) + ": " + message);
+    }
+
+    bool fill() {
+        if (m_eof) {
+            return false;
+        }
+        NSInteger read = [m_stream read:m_buffer.data() maxLength:m_buffer.size()];
+        if (read < 0) {
+            m_streamError = m_stream.streamError;
+            throw std::runtime_error(m_streamError ? m_streamError.localizedDescription.UTF8String
+                                                   : "Failed to read from the input stream");
+        }
+        if (read == 0) {
+            m_eof = true;
+            return false;
+        }
+        m_pos = 0;
+        m_end = read;
+        return true;
+    }
+
+    int peek() {
+        if (m_pos == m_end && !fill()) {
+            return -1;
+        }
+        return m_buffer[m_pos];
+    }
+
+    int get() {
+        int c = peek();
+        if (c != -1) {
+            ++m_pos;
+            ++m_offset;
+        }
+        return c;
+    }
+
+    void skipWhitespace() {
+        for (int c = peek(); c == ' ' || c == '\t' || c == '\n' || c == '\r'; c = peek()) {
+            get();
+        }
+    }
+
+    void expectLiteral(const char *literal) {
+        for (const char *p = literal; *p; ++p) {
+            if (get() != *p) {
+                fail("Invalid literal");
+            }
+        }
+    }
+
+    id parseValue(size_t depth) {
+        if (depth > s_maxDepth) {
+            fail("Nesting is too deep");
+        }
+        skipWhitespace();
+        int c = peek();
+        switch (c) {
+            case '{': return parseObject(depth + 1);
+            case '[': return parseArray(depth + 1);
+            case '"': get(); return parseString();
+            case 't': expectLiteral("true"); return @YES;
+            case 'f': expectLiteral("false"); return @NO;
+            case 'n': expectLiteral("null"); return NSNull.null;
+            case -1:  fail("Unexpected end of input");
+            default:
+                if (c == '-' || (c >= '0' && c <= '9')) {
+                    return parseNumber();
+                }
+                fail("Unexpected character");
+        }
+    }
+
+    NSDictionary *parseObject(size_t depth) {
+        get();
+        NSMutableDictionary *dictionary = [NSMutableDictionary new];
+        skipWhitespace();
+        if (peek() == '}') {
+            get();
+            return dictionary;
+        }
+        while (true) {
+            skipWhitespace();
+            if (get() != '"') {
+                fail("Expected a string key");
+            }
+            NSString *key = parseString();
+            skipWhitespace();
+            if (get() != ':') {
+                fail("Expected ':'");
+            }
+            dictionary[key] = parseValue(depth);
+            skipWhitespace();
+            int c = get();
+            if (c == '}') {
+                return dictionary;
+            }
+            if (c != ',') {
+                fail("Expected ',' or '}'");
+            }
+        }
+    }
+
+    NSArray *parseArray(size_t depth) {
+        get();
+        NSMutableArray *array = [NSMutableArray new];
+        skipWhitespace();
+        if (peek() == ']') {
+            get();
+            return array;
+        }
+        while (true) {
+            [array addObject:parseValue(depth)];
+            skipWhitespace();
+            int c = get();
+            if (c == ']') {
+                return array;
+            }
+            if (c != ',') {
+                fail("Expected ',' or ']'");
+            }
+        }
+    }
+
+    unsigned parseHexEscape() {
+        unsigned value = 0;
+        for (int i = 0; i < 4; ++i) {
+            int c = get();
+            value <<= 4;
+            if (c >= '0' && c <= '9') value |= c - '0';
+            else if (c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+            else fail("Invalid unicode escape");
+        }
+        return value;
+    }
+
+    void appendUTF8(unsigned codePoint) {
+        if (codePoint < 0x80) {
+            m_scratch += char(codePoint);
+        }
+        else if (codePoint < 0x800) {
+            m_scratch += char(0xC0 | (codePoint >> 6));
+            m_scratch += char(0x80 | (codePoint & 0x3F));
+        }
+        else if (codePoint < 0x10000) {
+            m_scratch += char(0xE0 | (codePoint >> 12));
+            m_scratch += char(0x80 | ((codePoint >> 6) & 0x3F));
+            m_scratch += char(0x80 | (codePoint & 0x3F));
+        }
+        else {
+            m_scratch += char(0xF0 | (codePoint >> 18));
+            m_scratch += char(0x80 | ((codePoint >> 12) & 0x3F));
+            m_scratch += char(0x80 | ((codePoint >> 6) & 0x3F));
+            m_scratch += char(0x80 | (codePoint & 0x3F));
+        }
+    }
+
+    // Parse the remainder of a string whose opening quote has been consumed
+    NSString *parseString() {
+        m_scratch.clear();
+        while (true) {
+            int c = get();
+            if (c == '"') {
+                break;
+            }
+            if (c == -1) {
+                fail("Unterminated string");
+            }
+            if (c < 0x20) {
+                fail("Unescaped control character in string");
+            }
+            if (c != '\\') {
+                m_scratch += char(c);
+                continue;
+            }
+            switch (get()) {
+                case '"':  m_scratch += '"'; break;
+                case '\\': m_scratch += '\\'; break;
+                case '/':  m_scratch += '/'; break;
+                case 'b':  m_scratch += '\b'; break;
+                case 'f':  m_scratch += '\f'; break;
+                case 'n':  m_scratch += '\n'; break;
+                case 'r':  m_scratch += '\r'; break;
+                case 't':  m_scratch += '\t'; break;
+                case 'u': {
+                    unsigned codePoint = parseHexEscape();
+                    if (codePoint >= 0xD800 && codePoint < 0xDC00) {
+                        if (get() != '\\' || get() != 'u') {
+                            fail("Unpaired surrogate in unicode escape");
+                        }
+                        unsigned low = parseHexEscape();
+                        if (low < 0xDC00 || low >= 0xE000) {
+                            fail("Unpaired surrogate in unicode escape");
+                        }
+                        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    else if (codePoint >= 0xDC00 && codePoint < 0xE000) {
+                        fail("Unpaired surrogate in unicode escape");
+                    }
+                    appendUTF8(codePoint);
+                    break;
+                }
+                default:
+                    fail("Invalid escape sequence");
+            }
+        }
+        NSString *str = [[NSString alloc] initWithBytes:m_scratch.data() length:m_scratch.size()
+                                               encoding:NSUTF8StringEncoding];
+        if (!str) {
+            fail("Invalid UTF-8 in string");
+        }
+        return str;
+    }
+
+    NSNumber *parseNumber() {
+        m_scratch.clear();
+        bool isInteger = true;
+        for (int c = peek(); c != -1; c = peek()) {
+            if (c == '.' || c == 'e' || c == 'E') {
+                isInteger = false;
+            }
+            else if (c != '-' && c != '+' && (c < '0' || c > '9')) {
+                break;
+            }
+            m_scratch += char(get());
+        }
+
+        const char *begin = m_scratch.c_str();
+        char *end;
+        errno = 0;
+        if (isInteger) {
+            long long value = strtoll(begin, &end, 10);
+            if (errno == 0 && end == begin + m_scratch.size()) {
+                return @(value);
+            }
+            errno = 0;
+        }
+        double value = strtod(begin, &end);
+        if (errno != 0 || end != begin + m_scratch.size()) {
+            fail("Invalid number");
+        }
+        return @(value);
+    }
+};
+} // anonymous namespace
+
+BOOL RLMImportJSONFromStream(RLMRealm *realm, NSString *className, NSInputStream *stream,
+                             RLMCreationOptions options, NSUInteger commitInterval, NSError **error) {
+    bool createOrUpdate = options & RLMCreationOptionsCreateOrUpdate;
+    if (createOrUpdate && !realm->_info[className].propertyForPrimaryKey()) {
+        @throw RLMException(@"'%@' does not have a primary key and can not be updated", className);
+    }
+
+    // Only manage the write transaction ourselves if the caller isn't already
+    // in one, as otherwise we can't commit part of the way through
+    bool ownsTransaction = !realm.inWriteTransaction;
+    bool openedStream = stream.streamStatus == NSStreamStatusNotOpen;
+    if (openedStream) {
+        [stream open];
+    }
+    if (ownsTransaction) {
+        [realm beginWriteTransaction];
+    }
+
+    auto failed = [&](NSError *err) {
+        if (ownsTransaction && realm.inWriteTransaction) {
+            [realm cancelWriteTransaction];
+        }
+        if (openedStream) {
+            [stream close];
+        }
+        if (error) {
+            *error = err;
+        }
+        return NO;
+    };
+
+    JSONStreamParser parser(stream);
+    NSUInteger uncommitted = 0;
+    // Errors from within the per-element autorelease pool are held here and
+    // only reported once the pool has been drained, as the error out-param is
+    // autoreleasing
+    NSError *elementError;
+    try {
+        parser.beginArray();
+        while (true) {
+            @autoreleasepool {
+                id value = parser.nextElement();
+                if (!value) {
+                    break;
+                }
+                @try {
+                    RLMCreateObjectInRealmWithValue(realm, className, value, options);
+                }
+                @catch (NSException *e) {
+                    elementError = RLMMakeError(e);
+                    break;
+                }
+
+                if (ownsTransaction && commitInterval && ++uncommitted == commitInterval) {
+                    NSError *commitError;
+                    if (![realm commitWriteTransaction:&commitError]) {
+                        elementError = commitError;
+                        break;
+                    }
+                    [realm beginWriteTransaction];
+                    uncommitted = 0;
+                }
+            }
+        }
+    }
+    catch (std::exception const& e) {
+        return failed(parser.streamError() ?: RLMMakeError(RLMErrorFail, e));
+    }
+    if (elementError) {
+        return failed(elementError);
+    }
+
+    if (openedStream) {
+        [stream close];
+    }
+    if (ownsTransaction) {
+        NSError *commitError;
+        if (![realm commitWriteTransaction:&commitError]) {
+            if (error) {
+                *error = commitError;
+            }
+            return NO;
+        }
+    }
+    return YES;
+}
+
+namespace {
+// The pre-encoded values of a single property for every object in an
+// RLMPreparedObjects. Only the storage for the property's type is used.
+struct PreparedColumn {
+    RLMProperty *property;
+    std::vector<bool> nulls;
+    // Whether each value was missing from the object's value and so is the
+    // property's default, which is written with the SetDefault flag
+    std::vector<bool> defaults;
+    std::vector<int64_t> ints;
+    std::vector<float> floats;
+    std::vector<double> doubles;
+    std::vector<Timestamp> timestamps;
+    // Strings and binary data are stored back-to-back in `bytes`, with the
+    // end offset of each value in `ends`
+    std::vector<size_t> ends;
+    std::string bytes;
+
+    BinaryData bytesAt(size_t i) const {
+        size_t begin = i == 0 ? 0 : ends[i - 1];
+        return BinaryData(bytes.data() + begin, ends[i] - begin);
+    }
+};
+} // anonymous namespace
+
+@interface RLMPreparedObjects () {
+@public
+    std::vector<PreparedColumn> _columns;
+    NSMutableArray *_primaryKeys;
+}
+@end
+
+@implementation RLMPreparedObjects
+
+- (instancetype)initWithObjectSchema:(RLMObjectSchema *)objectSchema values:(id<NSFastEnumeration>)values {
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+    _className = objectSchema.className;
+
+    NSArray *props = objectSchema.properties;
+    for (RLMProperty *prop in props) {
+        if (prop.type == RLMPropertyTypeObject || prop.type == RLMPropertyTypeArray) {
+            @throw RLMException(@"Property '%@' of '%@' is a link, and objects with links can not be prepared ahead of time.",
+                                prop.name, _className);
+        }
+        if (prop.type == RLMPropertyTypeAny) {
+            @throw RLMException(@"Property '%@' of '%@' is of type 'any', and objects with 'any' properties can not be prepared ahead of time.",
+                                prop.name, _className);
+        }
+        _columns.push_back({prop});
+    }
+    RLMProperty *primaryProperty = objectSchema.primaryKeyProperty;
+    if (primaryProperty) {
+        _primaryKeys = [NSMutableArray new];
+    }
+
+    for (id value in values) @autoreleasepool {
+        if (!value || value == NSNull.null) {
+            @throw RLMException(@"Must provide a non-nil value.");
+        }
+        // The default values are resolved separately for each object which
+        // needs them, as they may be generated for each object
+        NSDictionary *defaultValues = nil;
+        NSArray *array = RLMDynamicCast<NSArray>(value);
+        if (array.count > props.count) {
+            @throw RLMException(@"Invalid array input: more values (%llu) than properties (%llu).",
+                                (unsigned long long)array.count, (unsigned long long)props.count);
+        }
+
+        for (auto& column : _columns) {
+            RLMProperty *prop = column.property;
+            id propValue;
+            bool usedDefault = false;
+            if (array) {
+                if (prop.index >= array.count) {
+                    @throw RLMException(@"Invalid array input: number of values (%llu) does not match number of properties (%llu).",
+                                        (unsigned long long)array.count, (unsigned long long)props.count);
+                }
+                propValue = array[prop.index];
+            }
+            else {
+                NSString *key = [value respondsToSelector:prop.getterSel] ? prop.getterName : prop.name;
+                propValue = RLMValidatedValueForProperty(value, key, _className);
+                if (!propValue) {
+                    usedDefault = true;
+                    if (!defaultValues) {
+                        defaultValues = RLMDefaultValuesForObjectSchema(objectSchema) ?: @{};
+                    }
+                    propValue = defaultValues[prop.name];
+                }
+                if (!propValue && !prop.optional) {
+                    @throw RLMException(@"Property '%@' of object of type '%@' cannot be nil.", prop.name, _className);
+                }
+            }
+            RLMValidateValueForProperty(propValue, prop);
+            propValue = RLMCoerceToNil(propValue);
+            if (prop == primaryProperty) {
+                [_primaryKeys addObject:propValue ?: NSNull.null];
+            }
+            column.defaults.push_back(usedDefault);
+            [self appendValue:propValue toColumn:column];
+        }
+        ++_count;
+    }
+    return self;
+}
+
+- (void)appendValue:(id)value toColumn:(PreparedColumn&)column {
+    column.nulls.push_back(!value);
+    switch (column.property.type) {
+        case RLMPropertyTypeInt:
+            column.ints.push_back([value longLongValue]);
+            break;
+        case RLMPropertyTypeBool:
+            column.ints.push_back([value boolValue]);
+            break;
+        case RLMPropertyTypeFloat:
+            column.floats.push_back([value floatValue]);
+            break;
+        case RLMPropertyTypeDouble:
+            column.doubles.push_back([value doubleValue]);
+            break;
+        case RLMPropertyTypeDate:
+            column.timestamps.push_back(value ? RLMTimestampForNSDate(value) : Timestamp(0, 0));
+            break;
+        case RLMPropertyTypeString: {
+            RLMStringDataBuffer buffer(value);
+            StringData str = buffer;
+            column.bytes.append(str.data(), str.size());
+            column.ends.push_back(column.bytes.size());
+            break;
+        }
+        case RLMPropertyTypeData: {
+            BinaryData data = RLMBinaryDataForNSData(value);
+            column.bytes.append(data.data(), data.size());
+            column.ends.push_back(column.bytes.size());
+            break;
+        }
+        default:
+            REALM_UNREACHABLE();
+    }
+}
+
+@end
+
+void RLMAddPreparedObjects(RLMRealm *realm, RLMPreparedObjects *objects) {
+    RLMVerifyInWriteTransaction(realm);
+
+    auto& info = realm->_info[objects.className];
+    for (auto& column : objects->_columns) {
+        RLMProperty *prop = info.rlmObjectSchema[column.property.name];
+        if (!prop || prop.type != column.property.type || prop.optional != column.property.optional
+            || prop.index != column.property.index) {
+            @throw RLMException(@"The objects were prepared with a schema for '%@' which does not match the Realm's schema.",
+                                objects.className);
+        }
+    }
+
+    NSUInteger count = objects.count;
+    if (count == 0) {
+        return;
+    }
+
+    Table& table = *info.table();
+    std::vector<size_t> rows;
+    rows.reserve(count);
+    try {
+        if (NSArray *keys = objects->_primaryKeys) {
+            // Check for keys which already exist, either in the table or
+            // earlier in the batch, before adding any rows
+            PrimaryKeyRowMap rowMap(info, keys);
+            NSUInteger i = 0;
+            for (id key in keys) {
+                id primaryValue = RLMCoerceToNil(key);
+                if (rowMap.find(primaryValue) != realm::not_found) {
+                    @throw RLMException(@"Can't create object with existing primary key value '%@'.", key);
+                }
+                // The row is only a placeholder until the rows are added
+                rowMap.insert(primaryValue, i++);
+            }
+            for (id key in keys) {
+                rows.push_back(createRowForObjectWithPrimaryKey(info, RLMCoerceToNil(key)));
+            }
+        }
+        else {
+            size_t firstRow = table.add_empty_row(count);
+            for (size_t i = 0; i < count; ++i) {
+                rows.push_back(firstRow + i);
+            }
+        }
+
+        // The values are already in their storage format, so all that's left
+        // is appending them to the columns
+        for (auto& column : objects->_columns) {
+            RLMProperty *prop = column.property;
+            if (prop.isPrimary || prop.isFolded || prop.isComputed) {
+                continue;
+            }
+            size_t col = info.tableColumn(prop);
+            size_t foldedCol = prop.foldedPropertyName ? info.tableColumn(prop.foldedPropertyName) : realm::npos;
+            for (size_t i = 0; i < count; ++i) {
+                size_t row = rows[i];
+                bool isNull = column.nulls[i];
+                bool isDefault = column.defaults[i];
+                switch (prop.type) {
+                    case RLMPropertyTypeString: {
+                        BinaryData bytes = column.bytesAt(i);
+                        StringData str = isNull ? StringData() : StringData(bytes.data(), bytes.size());
+                        table.set_string(col, row, str, isDefault);
+                        if (foldedCol != realm::npos) {
+                            table.set_string(foldedCol, row, RLMStringDataBuffer(RLMFoldedString(RLMStringDataToNSString(str))),
+                                             isDefault);
+                        }
+                        continue;
+                    }
+                    case RLMPropertyTypeData:
+                        table.set_binary(col, row, isNull ? BinaryData() : column.bytesAt(i), isDefault);
+                        continue;
+                    default:
+                        break;
+                }
+                if (isNull) {
+                    table.set_null(col, row, isDefault);
+                    continue;
+                }
+                switch (prop.type) {
+                    case RLMPropertyTypeInt:    table.set_int(col, row, column.ints[i], isDefault); break;
+                    case RLMPropertyTypeBool:   table.set_bool(col, row, column.ints[i], isDefault); break;
+                    case RLMPropertyTypeFloat:  table.set_float(col, row, column.floats[i], isDefault); break;
+                    case RLMPropertyTypeDouble: table.set_double(col, row, column.doubles[i], isDefault); break;
+                    case RLMPropertyTypeDate:   table.set_timestamp(col, row, column.timestamps[i], isDefault); break;
+                    default: REALM_UNREACHABLE();
+                }
+            }
+        }
+
+        if (RLMObjectSchemaHasComputedProperties(info.rlmObjectSchema)) {
+            for (size_t row : rows) {
+                info.updateComputedProperties(row);
+            }
+        }
+    }
+    catch (std::exception const& e) {
+        @throw RLMException(e);
+    }
+}
+
+void RLMDeleteObjectFromRealm(__unsafe_unretained RLMObjectBase *const object,
+                              __unsafe_unretained RLMRealm *const realm) {
+    if (realm != object->_realm) {
+        @throw RLMException(@"Can only delete an object from the Realm it belongs to.");
+    }
+
+    RLMVerifyInWriteTransaction(object->_realm);
+
+    // move last row to row we are deleting
+    if (object->_row.is_attached()) {
+        RLMTrackDeletions(realm, ^{
+            object->_row.get_table()->move_last_over(object->_row.get_index());
+        });
+    }
+
+    // set realm to nil
+    object->_realm = nil;
+}
+
+void RLMDeleteObjectsFromRealm(__unsafe_unretained RLMRealm *const realm,
+                               __unsafe_unretained id<NSFastEnumeration> const objects) {
+    RLMVerifyInWriteTransaction(realm);
+
+    // Group the rows to delete by table so that each table is only modified
+    // once, rather than calling move_last_over() and sending a cascade
+    // notification for each object
+    std::vector<std::pair<RLMClassInfo *, std::vector<size_t>>> rowsByClass;
+    RLMClassInfo *previousInfo = nullptr;
+    std::vector<size_t> *rows = nullptr;
+    std::vector<RLMObjectBase *> deleted;
+    for (id obj in objects) {
+        if (![obj isKindOfClass:RLMObjectBase.class]) {
+            continue;
+        }
+        __unsafe_unretained RLMObjectBase *const object = obj;
+        if (realm != object->_realm) {
+            @throw RLMException(@"Can only delete an object from the Realm it belongs to.");
+        }
+        deleted.push_back(object);
+        if (object->_row.is_attached()) {
+            if (object->_info != previousInfo) {
+                previousInfo = object->_info;
+                auto it = std::find_if(rowsByClass.begin(), rowsByClass.end(),
+                                       [&](auto const& entry) { return entry.first == previousInfo; });
+                if (it == rowsByClass.end()) {
+                    it = rowsByClass.emplace(rowsByClass.end(), previousInfo, std::vector<size_t>());
+                }
+                rows = &it->second;
+            }
+            rows->push_back(object->_row.get_index());
+        }
+    }
+
+    for (auto& entry : rowsByClass) {
+        auto& indexes = entry.second;
+        std::sort(indexes.begin(), indexes.end());
+        indexes.erase(std::unique(indexes.begin(), indexes.end()), indexes.end());
+    }
+
+    // The objects are only detached from the Realm once their rows have been
+    // erased, so that an invalid object later in the collection leaves all of
+    // them untouched
+    if (!rowsByClass.empty()) {
+        RLMTrackDeletions(realm, ^{
+            auto& alloc = Allocator::get_default();
+            for (auto& entry : rowsByClass) {
+                auto& indexes = entry.second;
+                IntegerColumn column(IntegerColumn::unattached_root_tag(), alloc);
+                column.get_root_array()->init_from_ref(IntegerColumn::create(alloc));
+                try {
+                    for (size_t index : indexes) {
+                        column.add(index);
+                    }
+                    // batch_erase_rows() is private to Table, and is reached
+                    // the same way TableView::clear() reaches it
+                    _impl::TableFriend::batch_erase_rows(*entry.first->table(), column, true);
+                }
+                catch (...) {
+                    column.destroy();
+                    throw;
+                }
+                column.destroy();
+            }
+        });
+    }
+    for (RLMObjectBase *object : deleted) {
+        object->_realm = nil;
+    }
+}
+
+void RLMDeleteAllObjectsFromRealm(RLMRealm *realm) {
+    RLMVerifyInWriteTransaction(realm);
+
+    // clear table for each object schema
+    for (auto& info : realm->_info) {
+        RLMClearTable(info.second);
+    }
+}
+
+static RLMResults *getObjects(RLMRealm *realm, RLMClassInfo& info, NSPredicate *predicate) NS_RETURNS_RETAINED;
+
+RLMResults *RLMGetObjects(__unsafe_unretained RLMRealm *const realm,
+                          NSString *objectClassName,
+                          NSPredicate *predicate) {
+    RLMVerifyRealmRead(realm);
+    return getObjects(realm, realm->_info[objectClassName], predicate);
+}
+
+RLMResults *RLMGetObjects(__unsafe_unretained RLMRealm *const realm,
+                          __unsafe_unretained RLMObjectSchema *const objectSchema,
+                          NSPredicate *predicate) {
+    RLMVerifyRealmRead(realm);
+    return getObjects(realm, realm->_info[objectSchema], predicate);
+}
+
+static RLMResults *getObjects(__unsafe_unretained RLMRealm *const realm, RLMClassInfo& info,
+                              NSPredicate *predicate) {
+    // create view from table and predicate
+    if (!info.table()) {
+        // read-only realms may be missing tables since we can't add any
+        // missing ones on init
+        return [RLMResults resultsWithObjectInfo:info results:{}];
+    }
+
+    if (predicate) {
+        realm::Query query = RLMPredicateToQuery(predicate, info);
+        RLMResults *results = [RLMResults resultsWithObjectInfo:info
+                                                        results:realm::Results(realm->_realm, std::move(query))];
+        results.filters = @[predicate];
+        results.derivedFromTable = YES;
+        if (NSString *identity = RLMPredicateIdentity(predicate)) {
+            results.queryIdentity = [NSString stringWithFormat:@"%@\nfilter:%@", info.rlmObjectSchema.className, identity];
+        }
+        return results;
+    }
+
+    RLMResults *results = [RLMResults resultsWithObjectInfo:info
+                                                    results:realm::Results(realm->_realm, *info.table())];
+    results.derivedFromTable = YES;
+    results.queryIdentity = info.rlmObjectSchema.className;
+    return results;
+}
+
+static id getObject(RLMRealm *realm, RLMClassInfo& info, id key) NS_RETURNS_RETAINED;
+
+id RLMGetObject(RLMRealm *realm, NSString *objectClassName, id key) {
+    RLMVerifyRealmRead(realm);
+    return getObject(realm, realm->_info[objectClassName], key);
+}
+
+id RLMGetObject(RLMRealm *realm, RLMObjectSchema *objectSchema, id key) {
+    RLMVerifyRealmRead(realm);
+    return getObject(realm, realm->_info[objectSchema], key);
+}
+
+// Find the row with the given primary key, validating the key and using the
+// class's primary key cache outside of write transactions. Rows move when
+// objects are created and deleted, so the cache can't be used while objects
+// can be, and it's cleared whenever the read transaction advances.
+static size_t findRowForPrimaryKey(__unsafe_unretained RLMRealm *const realm, RLMClassInfo& info,
+                                   realm::Property const& primaryProperty, Table& table, id key) {
+    key = RLMCoerceToNil(key);
+    if (!key && !primaryProperty.is_nullable) {
+        @throw RLMException(@"Invalid null value for non-nullable primary key.");
+    }
+
+    NSString *string = nil;
+    NSNumber *number = nil;
+    switch (primaryProperty.type) {
+        case PropertyType::String:
+            string = RLMDynamicCast<NSString>(key);
+            if (key && !string) {
+                @throw RLMException(@"Invalid value '%@' of type '%@' for string primary key.", key, [key class]);
+            }
+            break;
+        case PropertyType::Int:
+            number = RLMDynamicCast<NSNumber>(key);
+            if (key && !number) {
+                @throw RLMException(@"Invalid value '%@' of type '%@' for int primary key.", key, [key class]);
+            }
+            break;
+        default:
+            REALM_UNREACHABLE();
+    }
+
+    auto find = [&] {
+        if (string || (!key && primaryProperty.type == PropertyType::String)) {
+            return table.find_first_string(primaryProperty.table_column, RLMStringDataBuffer(string));
+        }
+        if (number) {
+            return table.find_first_int(primaryProperty.table_column, number.longLongValue);
+        }
+        return table.find_first_null(primaryProperty.table_column);
+    };
+
+    if (realm->_realm->is_in_transaction() || realm->_realm->config().read_only()) {
+        return find();
+    }
+
+    auto& cache = info.primaryKeyCache;
+    if (cache.generation != realm->_readGeneration || cache.size() >= RLMPrimaryKeyCache::s_maxSize) {
+        cache.clear();
+        cache.generation = realm->_readGeneration;
+    }
+    if (!key) {
+        if (!cache.hasNullRow) {
+            cache.nullRow = find();
+            cache.hasNullRow = true;
+        }
+        return cache.nullRow;
+    }
+    if (number) {
+        auto it = cache.ints.find(number.longLongValue);
+        if (it == cache.ints.end()) {
+            it = cache.ints.emplace(number.longLongValue, find()).first;
+        }
+        return it->second;
+    }
+    RLMStringDataBuffer buffer(string);
+    StringData str = buffer;
+    std::string keyString(str.data(), str.size());
+    auto it = cache.strings.find(keyString);
+    if (it == cache.strings.end()) {
+        it = cache.strings.emplace(std::move(keyString), find()).first;
+    }
+    return it->second;
+}
+
+static id getObject(RLMRealm *realm, RLMClassInfo& info, id key) {
+    auto primaryProperty = info.objectSchema->primary_key_property();
+    if (!primaryProperty) {
+        @throw RLMException(@"%@ does not have a primary key", info.rlmObjectSchema.className);
+    }
+
+    auto table = info.table();
+    if (!table) {
+        // read-only realms may be missing tables since we can't add any
+        // missing ones on init
+        return nil;
+    }
+
+    size_t row = findRowForPrimaryKey(realm, info, *primaryProperty, *table, key);
+    if (row == realm::not_found) {
+        return nil;
+    }
+
+    return RLMCreateObjectAccessor(realm, info, row);
+}
+
+static NSArray *getObjectsForPrimaryKeys(RLMRealm *realm, RLMClassInfo& info, id<NSFastEnumeration> keys) {
+    auto primaryProperty = info.objectSchema->primary_key_property();
+    if (!primaryProperty) {
+        @throw RLMException(@"%@ does not have a primary key", info.rlmObjectSchema.className);
+    }
+
+    NSMutableArray *objects = [NSMutableArray array];
+    auto table = info.table();
+    if (!table) {
+        return objects;
+    }
+
+    for (id key in keys) {
+        size_t row = findRowForPrimaryKey(realm, info, *primaryProperty, *table, key);
+        if (row != realm::not_found) {
+            [objects addObject:RLMCreateObjectAccessor(realm, info, row)];
+        }
+    }
+    return objects;
+}
+
+NSArray *RLMGetObjectsForPrimaryKeys(RLMRealm *realm, NSString *objectClassName, id<NSFastEnumeration> keys) {
+    RLMVerifyRealmRead(realm);
+    return getObjectsForPrimaryKeys(realm, realm->_info[objectClassName], keys);
+}
+
+NSArray *RLMGetObjectsForPrimaryKeys(RLMRealm *realm, RLMObjectSchema *objectSchema, id<NSFastEnumeration> keys) {
+    RLMVerifyRealmRead(realm);
+    return getObjectsForPrimaryKeys(realm, realm->_info[objectSchema], keys);
+}
+
+// The values of an object at the sort descriptors' key paths, with NSNull for nil
+static NSArray *sortKeyForObject(id object, NSArray<RLMSortDescriptor *> *sortDescriptors) {
+    NSMutableArray *key = [NSMutableArray arrayWithCapacity:sortDescriptors.count];
+    for (RLMSortDescriptor *descriptor in sortDescriptors) {
+        [key addObject:[object valueForKeyPath:descriptor.keyPath] ?: NSNull.null];
+    }
+    return key;
+}
+
+// Orders sort keys the way a sorted RLMResults does, with nil before all
+// other values when ascending
+static NSComparisonResult compareSortKeys(NSArray *a, NSArray *b, NSArray<RLMSortDescriptor *> *sortDescriptors) {
+    for (NSUInteger i = 0; i < sortDescriptors.count; ++i) {
+        id lhs = a[i], rhs = b[i];
+        NSComparisonResult result;
+        if (lhs == NSNull.null || rhs == NSNull.null) {
+            result = lhs == rhs ? NSOrderedSame : lhs == NSNull.null ? NSOrderedAscending : NSOrderedDescending;
+        }
+        else {
+            result = [lhs compare:rhs];
+        }
+        if (result != NSOrderedSame) {
+            return sortDescriptors[i].ascending ? result : (NSComparisonResult)-result;
+        }
+    }
+    return NSOrderedSame;
+}
+
+NSArray *RLMGetObjectsInRealms(NSArray<RLMRealm *> *realms, NSString *objectClassName,
+                               NSPredicate *predicate, NSArray<RLMSortDescriptor *> *sortDescriptors) {
+    NSMutableArray<RLMResults *> *shards = [NSMutableArray arrayWithCapacity:realms.count];
+    NSUInteger total = 0;
+    for (RLMRealm *realm in realms) {
+        RLMResults *results = RLMGetObjects(realm, objectClassName, predicate);
+        if (sortDescriptors.count) {
+            results = [results sortedResultsUsingDescriptors:sortDescriptors];
+        }
+        [shards addObject:results];
+        total += results.count;
+    }
+
+    NSMutableArray *objects = [NSMutableArray arrayWithCapacity:total];
+    if (!sortDescriptors.count) {
+        for (RLMResults *results in shards) {
+            for (id object in results) {
+                [objects addObject:object];
+            }
+        }
+        return objects;
+    }
+
+    // Each shard is already sorted, so merge them by repeatedly taking the
+    // first remaining object of whichever shard's comes first. There are few
+    // enough shards that a linear scan for it is cheaper than a heap.
+    NSUInteger shardCount = shards.count;
+    std::vector<NSUInteger> next(shardCount, 0);
+    NSMutableArray *heads = [NSMutableArray arrayWithCapacity:shardCount];
+    NSMutableArray *keys = [NSMutableArray arrayWithCapacity:shardCount];
+    for (RLMResults *results in shards) {
+        id head = results.firstObject;
+        [heads addObject:head ?: NSNull.null];
+        [keys addObject:head ? sortKeyForObject(head, sortDescriptors) : NSNull.null];
+    }
+    while (objects.count < total) {
+        NSUInteger best = NSNotFound;
+        for (NSUInteger i = 0; i < shardCount; ++i) {
+            if (keys[i] != NSNull.null && (best == NSNotFound
+                                           || compareSortKeys(keys[i], keys[best], sortDescriptors) == NSOrderedAscending)) {
+                best = i;
+            }
+        }
+        if (best == NSNotFound) {
+            break;
+        }
+        [objects addObject:heads[best]];
+        if (++next[best] < shards[best].count) {
+            heads[best] = [shards[best] objectAtIndex:next[best]];
+            keys[best] = sortKeyForObject(heads[best], sortDescriptors);
+        }
+        else {
+            heads[best] = NSNull.null;
+            keys[best] = NSNull.null;
+        }
+    }
+    return objects;
+}
+
+RLMObjectBase *RLMCreateObjectAccessor(__unsafe_unretained RLMRealm *const realm,
+                                       RLMClassInfo& info,
+                                       NSUInteger index) {
+    return RLMCreateObjectAccessor(realm, info, (*info.table())[index]);
+}
+
+// Create accessor and register with realm
+RLMObjectBase *RLMCreateObjectAccessor(__unsafe_unretained RLMRealm *const realm,
+                                       RLMClassInfo& info,
+                                       realm::RowExpr row) {
+    if (!realm.reusesObjectAccessors || !row.is_attached()) {
+        RLMObjectBase *accessor = RLMCreateManagedAccessor(info.rlmObjectSchema.accessorClass, realm, &info);
+        accessor->_row = row;
+        RLMInitializeSwiftAccessorGenerics(accessor);
+        return accessor;
+    }
+
+    auto& cache = info.accessorCache;
+    if (cache.generation != realm->_readGeneration || cache.accessors.size() >= RLMAccessorCache::s_maxSize) {
+        cache.accessors.clear();
+        cache.generation = realm->_readGeneration;
+    }
+    // Deleting objects in a write transaction moves rows without changing the
+    // generation, so a cached accessor is only reused if it still refers to
+    // the row it was cached for
+    size_t index = row.get_index();
+    auto& cached = cache.accessors[index];
+    RLMObjectBase *accessor = cached;
+    if (accessor && accessor->_row.is_attached() && accessor->_row.get_index() == index) {
+        return accessor;
+    }
+    accessor = RLMCreateManagedAccessor(info.rlmObjectSchema.accessorClass, realm, &info);
     accessor->_row = row;
     RLMInitializeSwiftAccessorGenerics(accessor);
+    cached = accessor;
     return accessor;
 }
@@ -86,6 +86,12 @@ FOUNDATION_EXTERN Class RLMObjectUtilClass(BOOL isSwift);
 
 FOUNDATION_EXTERN const NSUInteger RLMDescriptionMaxDepth;
 
+#if DEBUG
+// The number of managed accessors created since launch, for measuring
+// allocation-elimination work in debug builds
+FOUNDATION_EXTERN uint64_t RLMDebugManagedAccessorCount(void);
+#endif
+
 @class RLMProperty, RLMArray;
 @interface RLMObjectUtil : NSObject
 
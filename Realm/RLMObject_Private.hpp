@@ -24,6 +24,9 @@
 #import <realm/link_view.hpp> // required by row.hpp
 #import <realm/row.hpp>
 
+#import <memory>
+#import <vector>
+
 class RLMObservationInfo;
 
 // RLMObject accessor and read/write realm
@@ -32,6 +35,9 @@ class RLMObservationInfo;
     realm::Row _row;
     RLMObservationInfo *_observationInfo;
     RLMClassInfo *_info;
+    // accessors for the targets of to-one links read through this accessor,
+    // indexed by property index; see RLMGetLink()
+    std::unique_ptr<std::vector<RLMObjectBase *>> _linkCache;
 }
 @end
 
@@ -71,6 +71,9 @@ public:
     void recordObserver(realm::Row& row, RLMClassInfo *objectInfo, RLMObjectSchema *objectSchema, NSString *keyPath);
     void removeObserver();
     bool hasObservers() const { return observerCount > 0; }
+    // Whether any of the observation infos for this row have observers, and so
+    // need to be sent change notifications
+    bool rowHasObservers() const;
 
     // valueForKey: on observed object and array properties needs to return the
     // same object each time for KVO to work at all. Doing this all the time
@@ -96,6 +99,8 @@ private:
     // Row being observed
     realm::Row row;
     RLMClassInfo *objectSchema = nullptr;
+    // Position in objectSchema->observedObjects of the head of the list
+    size_t observedIndex = 0;
 
     // Object doing the observing
     __unsafe_unretained id object = nil;
@@ -138,16 +143,22 @@ private:
 };
 
 // Get the the observation info chain for the given row
-// Will simply return info if it's non-null, and will search ojectSchema's array
-// for a matching one otherwise, and return null if there are none
+// Will simply return info if it's non-null, and will look up the row in
+// objectSchema's index of observed rows otherwise, and return null if there
+// are none
 RLMObservationInfo *RLMGetObservationInfo(RLMObservationInfo *info, size_t row, RLMClassInfo& objectSchema);
 
+// Mark the indexes of observed rows as stale for the object types where
+// advancing or rolling back the read transaction moved or deleted an observed
+// row
+void RLMInvalidateObservedRows(RLMSchemaInfo& schema);
+
 // delete all objects from a single table with change notifications
 void RLMClearTable(RLMClassInfo &realm);
 
 // invoke the block, sending notifications for cascading deletes/link nullifications
 void RLMTrackDeletions(RLMRealm *realm, dispatch_block_t block);
 
-std::vector<realm::BindingContext::ObserverState> RLMGetObservedRows(RLMSchemaInfo const& schema);
+std::vector<realm::BindingContext::ObserverState> RLMGetObservedRows(RLMSchemaInfo& schema);
 void RLMWillChange(std::vector<realm::BindingContext::ObserverState> const& observed, std::vector<void *> const& invalidated);
 void RLMDidChange(std::vector<realm::BindingContext::ObserverState> const& observed, std::vector<void *> const& invalidated);
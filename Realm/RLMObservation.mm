@@ -28,6 +28,8 @@
 
 #import <realm/group.hpp>
 
+#import <unordered_set>
+
 using namespace realm;
 
 namespace {
@@ -51,6 +53,37 @@ namespace {
     }
 }
 
+// The head of the observation info list for `row`, or null if it isn't
+// observed. The index is rebuilt from observedObjects if it's stale, and also
+// if it has an entry for the row which turns out to be for a different row,
+// which means that rows were moved without marking it as stale.
+static RLMObservationInfo *findObservedRow(RLMClassInfo& objectSchema, size_t row) {
+    auto& index = objectSchema.observedRows;
+    auto rebuild = [&] {
+        index.clear();
+        for (auto info : objectSchema.observedObjects) {
+            if (info->getRow().is_attached()) {
+                index[info->getRow().get_index()] = info;
+            }
+        }
+        objectSchema.observedRowsStale = false;
+    };
+
+    if (objectSchema.observedRowsStale) {
+        rebuild();
+    }
+    auto it = index.find(row);
+    if (it == index.end()) {
+        return nullptr;
+    }
+    if (it->second->isForRow(row)) {
+        return it->second;
+    }
+    rebuild();
+    it = index.find(row);
+    return it == index.end() ? nullptr : it->second;
+}
+
 RLMObservationInfo::RLMObservationInfo(RLMClassInfo &objectSchema, std::size_t row, id object)
 : object(object)
 , objectSchema(&objectSchema)
@@ -76,17 +109,36 @@ RLMObservationInfo::~RLMObservationInfo() {
     else if (objectSchema) {
         // The head of the list, so remove self from the object schema's array
         // of observation info, either replacing self with the next info or
-        // removing entirely if there is no next
-        auto end = objectSchema->observedObjects.end();
-        auto it = find(objectSchema->observedObjects.begin(), end, this);
-        if (it != end) {
+        // removing entirely if there is no next. The array is cleared when the
+        // table is, so self may no longer be in it.
+        auto& observed = objectSchema->observedObjects;
+        if (observedIndex < observed.size() && observed[observedIndex] == this) {
+            objectSchema->observerStatesStale = true;
             if (next) {
-                *it = next;
+                observed[observedIndex] = next;
+                next->observedIndex = observedIndex;
                 next->prev = nullptr;
             }
             else {
-                iter_swap(it, std::prev(end));
-                objectSchema->observedObjects.pop_back();
+                observed[observedIndex] = observed.back();
+                observed[observedIndex]->observedIndex = observedIndex;
+                observed.pop_back();
+            }
+
+            // Replace the index's entry for the row if it's up to date, and
+            // otherwise make sure it isn't used before being rebuilt
+            auto& index = objectSchema->observedRows;
+            auto it = row.is_attached() ? index.find(row.get_index()) : index.end();
+            if (it != index.end() && it->second == this) {
+                if (next) {
+                    it->second = next;
+                }
+                else {
+                    index.erase(it);
+                }
+            }
+            else {
+                objectSchema->observedRowsStale = true;
             }
         }
     }
@@ -130,6 +182,20 @@ void RLMObservationInfo::didChange(NSString *key, NSKeyValueChange kind, NSIndex
     }
 }
 
+bool RLMObservationInfo::rowHasObservers() const {
+    for (auto info = prev; info; info = info->prev) {
+        if (info->observerCount) {
+            return true;
+        }
+    }
+    for (auto info = this; info; info = info->next) {
+        if (info->observerCount) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void RLMObservationInfo::prepareForInvalidation() {
     REALM_ASSERT_DEBUG(objectSchema);
     REALM_ASSERT_DEBUG(!prev);
@@ -141,17 +207,18 @@ void RLMObservationInfo::setRow(realm::Table &table, size_t newRow) {
     REALM_ASSERT_DEBUG(!row);
     REALM_ASSERT_DEBUG(objectSchema);
     row = table[newRow];
-    for (auto info : objectSchema->observedObjects) {
-        if (info->row && info->row.get_index() == row.get_index()) {
-            prev = info;
-            next = info->next;
-            if (next)
-                next->prev = this;
-            info->next = this;
-            return;
-        }
+    if (auto info = findObservedRow(*objectSchema, newRow)) {
+        prev = info;
+        next = info->next;
+        if (next)
+            next->prev = this;
+        info->next = this;
+        return;
     }
+    observedIndex = objectSchema->observedObjects.size();
     objectSchema->observedObjects.push_back(this);
+    objectSchema->observerStatesStale = true;
+    objectSchema->observedRows[newRow] = this;
 }
 
 void RLMObservationInfo::recordObserver(realm::Row& objectRow, RLMClassInfo *objectInfo,
@@ -264,14 +331,34 @@ RLMObservationInfo *RLMGetObservationInfo(RLMObservationInfo *info, size_t row,
     if (info) {
         return info;
     }
+    if (objectSchema.observedObjects.empty()) {
+        return nullptr;
+    }
+    return findObservedRow(objectSchema, row);
+}
 
-    for (RLMObservationInfo *info : objectSchema.observedObjects) {
-        if (info->isForRow(row)) {
-            return info;
+// Check if the observer states reported for a table still match the rows of
+// the observed objects, i.e. no observed row has moved or been deleted
+static bool observerStatesAreCurrent(RLMClassInfo const& info) {
+    if (info.observerStatesStale) {
+        return false;
+    }
+    for (auto const& state : info.observerStates) {
+        auto const& row = static_cast<RLMObservationInfo *>(state.info)->getRow();
+        if (!row.is_attached() || row.get_index() != state.row_ndx) {
+            return false;
         }
     }
+    return true;
+}
 
-    return nullptr;
+void RLMInvalidateObservedRows(RLMSchemaInfo& schema) {
+    for (auto& info : schema) {
+        if (!info.second.observedObjects.empty() && !observerStatesAreCurrent(info.second)) {
+            info.second.observedRowsStale = true;
+            info.second.observerStatesStale = true;
+        }
+    }
 }
 
 void RLMClearTable(RLMClassInfo &objectSchema) {
@@ -292,13 +379,18 @@ void RLMClearTable(RLMClassInfo &objectSchema) {
     }
 
     objectSchema.observedObjects.clear();
+    objectSchema.observedRows.clear();
+    objectSchema.observedRowsStale = false;
+    objectSchema.observerStates.clear();
+    objectSchema.observerStatesStale = true;
 }
 
 void RLMTrackDeletions(__unsafe_unretained RLMRealm *const realm, dispatch_block_t block) {
-    std::vector<std::vector<RLMObservationInfo *> *> observers;
+    std::vector<RLMClassInfo *> observers;
 
-    // Build up an array of observation info arrays which is indexed by table
-    // index (the object schemata may be in an entirely different order)
+    // Build up an array of the object schemata with observed objects which is
+    // indexed by table index (the object schemata may be in an entirely
+    // different order)
     for (auto& info : realm->_info) {
         if (info.second.observedObjects.empty()) {
             continue;
@@ -307,7 +399,7 @@ void RLMTrackDeletions(__unsafe_unretained RLMRealm *const realm, dispatch_block
         if (ndx >= observers.size()) {
             observers.resize(std::max(observers.size() * 2, ndx + 1));
         }
-        observers[ndx] = &info.second.observedObjects;
+        observers[ndx] = &info.second;
     }
 
     // No need for change tracking if no objects are observed
@@ -321,13 +413,35 @@ void RLMTrackDeletions(__unsafe_unretained RLMRealm *const realm, dispatch_block
         __unsafe_unretained NSString *property;
         NSMutableIndexSet *indexes;
     };
+    struct change_key {
+        RLMObservationInfo *info;
+        size_t column;
+        bool operator==(change_key const& other) const {
+            return info == other.info && column == other.column;
+        }
+    };
+    struct change_key_hash {
+        size_t operator()(change_key const& key) const {
+            return std::hash<RLMObservationInfo *>()(key.info) ^ (std::hash<size_t>()(key.column) << 1);
+        }
+    };
 
     std::vector<change> changes;
+    std::unordered_map<change_key, size_t, change_key_hash> changeIndexes;
     std::vector<RLMObservationInfo *> invalidated;
 
     // This callback is called by core with a list of row deletions and
     // resulting link nullifications immediately before things are deleted and nullified
     realm.group.set_cascade_notification_handler([&](realm::Group::CascadeNotification const& cs) {
+        // The target rows being removed from each observed LinkView, so that
+        // each LinkView only has to be scanned once
+        std::unordered_map<change_key, std::unordered_set<size_t>, change_key_hash> removedTargets;
+
+        // The block may delete from more than one table, in which case this is
+        // called once per table and only the new changes should be announced
+        size_t firstChange = changes.size();
+        size_t firstInvalidated = invalidated.size();
+
         for (auto const& link : cs.links) {
             size_t table_ndx = link.origin_table->get_index_in_group();
             if (table_ndx >= observers.size() || !observers[table_ndx]) {
@@ -335,33 +449,31 @@ void RLMTrackDeletions(__unsafe_unretained RLMRealm *const realm, dispatch_block
                 continue;
             }
 
-            for (auto observer : *observers[table_ndx]) {
-                if (!observer->isForRow(link.origin_row_ndx)) {
-                    continue;
-                }
-
-                NSString *name = observer->columnName(link.origin_col_ndx);
-                if (observer->getRow().get_table()->get_column_type(link.origin_col_ndx) != type_LinkList) {
-                    changes.push_back({observer, name});
-                    continue;
-                }
+            auto observer = findObservedRow(*observers[table_ndx], link.origin_row_ndx);
+            if (!observer) {
+                continue;
+            }
 
-                auto c = find_if(begin(changes), end(changes), [&](auto const& c) {
-                    return c.info == observer && c.property == name;
-                });
-                if (c == end(changes)) {
-                    changes.push_back({observer, name, [NSMutableIndexSet new]});
-                    c = prev(end(changes));
-                }
+            change_key key{observer, link.origin_col_ndx};
+            bool isList = observer->getRow().get_table()->get_column_type(link.origin_col_ndx) == type_LinkList;
+            if (changeIndexes.emplace(key, changes.size()).second) {
+                changes.push_back({observer, observer->columnName(link.origin_col_ndx),
+                                   isList ? [NSMutableIndexSet new] : nil});
+            }
+            if (isList) {
+                removedTargets[key].insert(link.old_target_row_ndx);
+            }
+        }
 
-                // We know what row index is being removed from the LinkView,
-                // but what we actually want is the indexes in the LinkView that
-                // are going away
-                auto linkview = observer->getRow().get_linklist(link.origin_col_ndx);
-                size_t start = 0, index;
-                while ((index = linkview->find(link.old_target_row_ndx, start)) != realm::not_found) {
-                    [c->indexes addIndex:index];
-                    start = index + 1;
+        // We know what row indexes are being removed from each LinkView,
+        // but what we actually want is the indexes in the LinkView that
+        // are going away
+        for (auto const& targets : removedTargets) {
+            auto& c = changes[changeIndexes[targets.first]];
+            auto linkview = c.info->getRow().get_linklist(targets.first.column);
+            for (size_t i = 0, size = linkview->size(); i < size; ++i) {
+                if (targets.second.count(linkview->get_target_row(i))) {
+                    [c.indexes addIndex:i];
                 }
             }
         }
@@ -372,23 +484,29 @@ void RLMTrackDeletions(__unsafe_unretained RLMRealm *const realm, dispatch_block
                 continue;
             }
 
-            for (auto observer : *observers[row.table_ndx]) {
-                if (observer->isForRow(row.row_ndx)) {
-                    invalidated.push_back(observer);
-                    break;
-                }
+            if (auto observer = findObservedRow(*observers[row.table_ndx], row.row_ndx)) {
+                invalidated.push_back(observer);
             }
         }
 
         // The relative order of these loops is very important
-        for (auto info : invalidated) {
-            info->willChange(RLMInvalidatedKey);
+        for (size_t i = firstInvalidated; i < invalidated.size(); ++i) {
+            invalidated[i]->willChange(RLMInvalidatedKey);
         }
-        for (auto const& change : changes) {
+        for (size_t i = firstChange; i < changes.size(); ++i) {
+            auto const& change = changes[i];
             change.info->willChange(change.property, NSKeyValueChangeRemoval, change.indexes);
         }
-        for (auto info : invalidated) {
-            info->prepareForInvalidation();
+        for (size_t i = firstInvalidated; i < invalidated.size(); ++i) {
+            invalidated[i]->prepareForInvalidation();
+        }
+
+        // Deleting rows moves other rows of the same table into their places
+        for (auto const& row : cs.rows) {
+            if (row.table_ndx < observers.size() && observers[row.table_ndx]) {
+                observers[row.table_ndx]->observedRowsStale = true;
+                observers[row.table_ndx]->observerStatesStale = true;
+            }
         }
     });
 
@@ -421,20 +539,44 @@ void forEach(realm::BindingContext::ObserverState const& state, Func&& func) {
 }
 }
 
-std::vector<realm::BindingContext::ObserverState> RLMGetObservedRows(RLMSchemaInfo const& schema) {
-    std::vector<realm::BindingContext::ObserverState> observers;
+std::vector<realm::BindingContext::ObserverState> RLMGetObservedRows(RLMSchemaInfo& schema) {
+    // Each table's states are sorted by row, so the result only needs the
+    // tables to be put in order rather than sorting every observed row
+    std::vector<RLMClassInfo *> tables;
+    size_t count = 0;
     for (auto& table : schema) {
-        for (auto info : table.second.observedObjects) {
-            auto const& row = info->getRow();
-            if (!row.is_attached())
-                continue;
-            observers.push_back({
-                row.get_table()->get_index_in_group(),
-                row.get_index(),
-                info});
+        auto& info = table.second;
+        if (info.observedObjects.empty()) {
+            continue;
         }
+        if (!observerStatesAreCurrent(info)) {
+            info.observerStates.clear();
+            for (auto observed : info.observedObjects) {
+                auto const& row = observed->getRow();
+                if (!row.is_attached())
+                    continue;
+                info.observerStates.push_back({
+                    row.get_table()->get_index_in_group(),
+                    row.get_index(),
+                    observed});
+            }
+            sort(begin(info.observerStates), end(info.observerStates));
+            info.observerStatesStale = false;
+        }
+        if (!info.observerStates.empty()) {
+            tables.push_back(&info);
+            count += info.observerStates.size();
+        }
+    }
+    sort(begin(tables), end(tables), [](RLMClassInfo *a, RLMClassInfo *b) {
+        return a->observerStates.front().table_ndx < b->observerStates.front().table_ndx;
+    });
+
+    std::vector<realm::BindingContext::ObserverState> observers;
+    observers.reserve(count);
+    for (auto info : tables) {
+        observers.insert(observers.end(), info->observerStates.begin(), info->observerStates.end());
     }
-    sort(begin(observers), end(observers));
     return observers;
 }
 
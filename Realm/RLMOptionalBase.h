@@ -33,6 +33,15 @@ NS_ASSUME_NONNULL_BEGIN
 
 @property (nonatomic, strong, nullable) id underlyingValue;
 
+// Variants of `underlyingValue` for numeric and boolean properties which read
+// the value without boxing it in an NSNumber. They return NO if the value is
+// nil, and otherwise store the value in `value` and return YES. Each throws if
+// used on a property of a different type.
+- (BOOL)getIntValue:(int64_t *)value;
+- (BOOL)getFloatValue:(float *)value;
+- (BOOL)getDoubleValue:(double *)value;
+- (BOOL)getBoolValue:(BOOL *)value;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -17,8 +17,9 @@
 ////////////////////////////////////////////////////////////////////////////
 
 #import "RLMAccessor.h"
+#import "RLMClassInfo.hpp"
 #import "RLMOptionalBase.h"
-#import "RLMObject_Private.h"
+#import "RLMObject_Private.hpp"
 #import "RLMObjectStore.h"
 #import "RLMProperty_Private.h"
 #import "RLMUtil.hpp"
@@ -59,6 +60,62 @@
     }
 }
 
+static void RLMUnbox(__unsafe_unretained NSNumber *const number, int64_t *value) {
+    *value = number.longLongValue;
+}
+static void RLMUnbox(__unsafe_unretained NSNumber *const number, float *value) {
+    *value = number.floatValue;
+}
+static void RLMUnbox(__unsafe_unretained NSNumber *const number, double *value) {
+    *value = number.doubleValue;
+}
+static void RLMUnbox(__unsafe_unretained NSNumber *const number, BOOL *value) {
+    *value = number.boolValue;
+}
+
+template<typename T, typename U>
+static BOOL RLMGetUnboxedValue(__unsafe_unretained RLMOptionalBase *const optional,
+                               RLMPropertyType type, U *value) {
+    RLMProperty *property = optional->_property;
+    if (property.type != type) {
+        @throw RLMException(@"Cannot read %@ property '%@' as %@.",
+                            RLMTypeToString(property.type), property.name, RLMTypeToString(type));
+    }
+
+    RLMObjectBase *object = optional->_object;
+    if ((object && object->_realm) || object.isInvalidated) {
+        RLMVerifyAttached(object);
+        auto col = object->_info->tableColumn(property);
+        if (object->_row.is_null(col)) {
+            return NO;
+        }
+        *value = object->_row.get_table()->get<T>(col, object->_row.get_index());
+        return YES;
+    }
+
+    if (NSNumber *number = optional->_unmanagedValue) {
+        RLMUnbox(number, value);
+        return YES;
+    }
+    return NO;
+}
+
+- (BOOL)getIntValue:(int64_t *)value {
+    return RLMGetUnboxedValue<int64_t>(self, RLMPropertyTypeInt, value);
+}
+
+- (BOOL)getFloatValue:(float *)value {
+    return RLMGetUnboxedValue<float>(self, RLMPropertyTypeFloat, value);
+}
+
+- (BOOL)getDoubleValue:(double *)value {
+    return RLMGetUnboxedValue<double>(self, RLMPropertyTypeDouble, value);
+}
+
+- (BOOL)getBoolValue:(BOOL *)value {
+    return RLMGetUnboxedValue<bool>(self, RLMPropertyTypeBool, value);
+}
+
 - (BOOL)isKindOfClass:(Class)aClass {
     return [self.underlyingValue isKindOfClass:aClass] || RLMIsKindOfClass(object_getClass(self), aClass);
 }
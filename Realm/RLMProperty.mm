@@ -518,18 +518,90 @@ static bool rawTypeIsComputedProperty(NSString *rawType) {
     prop->_setterSel = _setterSel;
     prop->_isPrimary = _isPrimary;
     prop->_swiftIvar = _swiftIvar;
+    prop->_objectClassID = _objectClassID;
     prop->_optional = _optional;
     prop->_linkOriginPropertyName = _linkOriginPropertyName;
+    prop->_foldedPropertyName = _foldedPropertyName;
+    prop->_isFolded = _isFolded;
+    prop->_internsStrings = _internsStrings;
+    prop->_deferredIndex = _deferredIndex;
+    prop->_compoundIndexComponents = _compoundIndexComponents;
+    prop->_compoundIndexKeyNames = _compoundIndexKeyNames;
+    prop->_geoIndexCoordinateNames = _geoIndexCoordinateNames;
+    prop->_geoIndexKeyNames = _geoIndexKeyNames;
+    prop->_collationKeyName = _collationKeyName;
+    prop->_collationSourceName = _collationSourceName;
+    prop->_collationLocaleIdentifier = _collationLocaleIdentifier;
+    prop->_derivedInputNames = _derivedInputNames;
+    prop->_derivedPropertyNames = _derivedPropertyNames;
+    prop->_vectorDimension = _vectorDimension;
+    prop->_isExpirationDate = _isExpirationDate;
 
     return prop;
 }
 
+- (BOOL)isComputed {
+    return _compoundIndexComponents || _geoIndexCoordinateNames || _collationSourceName || _derivedInputNames;
+}
+
+- (BOOL)hasComputedProperties {
+    return _compoundIndexKeyNames || _geoIndexKeyNames || _collationKeyName || _derivedPropertyNames;
+}
+
 - (RLMProperty *)copyWithNewName:(NSString *)name {
     RLMProperty *prop = [self copy];
     prop.name = name;
     return prop;
 }
 
+- (NSDictionary *)schemaCacheRepresentation {
+    NSMutableDictionary *representation = [NSMutableDictionary dictionaryWithCapacity:9];
+    representation[@"name"] = _name;
+    representation[@"type"] = @(_type);
+    representation[@"objectClassName"] = _objectClassName;
+    representation[@"linkOriginPropertyName"] = _linkOriginPropertyName;
+    representation[@"indexed"] = @(_indexed);
+    representation[@"optional"] = @(_optional);
+    representation[@"getterName"] = _getterName;
+    representation[@"setterName"] = _setterName;
+    if (_swiftIvar) {
+        representation[@"swiftIvarOffset"] = @(ivar_getOffset(_swiftIvar));
+    }
+    return representation;
+}
+
+- (instancetype)initWithSchemaCacheRepresentation:(NSDictionary *)representation
+                                      objectClass:(Class)objectClass {
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+
+    _name = RLMDynamicCast<NSString>(representation[@"name"]);
+    _type = (RLMPropertyType)[representation[@"type"] intValue];
+    _objectClassName = RLMDynamicCast<NSString>(representation[@"objectClassName"]);
+    _linkOriginPropertyName = RLMDynamicCast<NSString>(representation[@"linkOriginPropertyName"]);
+    _indexed = [representation[@"indexed"] boolValue];
+    _optional = [representation[@"optional"] boolValue];
+    _getterName = RLMDynamicCast<NSString>(representation[@"getterName"]);
+    _setterName = RLMDynamicCast<NSString>(representation[@"setterName"]);
+    if (!_name.length) {
+        return nil;
+    }
+    if (NSNumber *offset = RLMDynamicCast<NSNumber>(representation[@"swiftIvarOffset"])) {
+        // The ivar is looked up by name as when introspecting, and must still
+        // be the one at the offset which was found then
+        _swiftIvar = class_getInstanceVariable(objectClass, _name.UTF8String);
+        if (!_swiftIvar || ivar_getOffset(_swiftIvar) != offset.longValue) {
+            return nil;
+        }
+    }
+    if (_getterName) {
+        [self updateAccessors];
+    }
+    return self;
+}
+
 - (BOOL)isEqual:(id)object {
     if (![object isKindOfClass:[RLMProperty class]]) {
         return NO;
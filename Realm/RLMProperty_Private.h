@@ -100,6 +100,55 @@ static inline NSString *RLMTypeToString(RLMPropertyType type) {
 @property (nonatomic, assign) NSUInteger index;
 @property (nonatomic, assign) BOOL isPrimary;
 @property (nonatomic, assign) Ivar swiftIvar;
+// the process-wide ID of objectClassName, assigned by RLMSchemaInfo when the
+// schema is used by a Realm, or 0 if it has not been
+@property (nonatomic, assign) uint32_t objectClassID;
+
+// the name of the property holding a folded copy of this property's values, if any
+@property (nonatomic, copy, nullable) NSString *foldedPropertyName;
+// whether this property holds the folded copy of another property's values
+@property (nonatomic, assign) BOOL isFolded;
+// whether this property's index is built in the background when it's missing
+// from an existing table, as it's listed in +[RLMObject deferredIndexedProperties]
+@property (nonatomic, assign) BOOL deferredIndex;
+// whether the values read from this property are interned, as it's listed in
+// +[RLMObject internedStringProperties]
+@property (nonatomic, assign) BOOL internsStrings;
+// the names of the properties combined by the compound index this property
+// holds the keys of, if any
+@property (nonatomic, copy, nullable) NSArray<NSString *> *compoundIndexComponents;
+// the names of the properties holding the keys of compound indexes which
+// combine this property, if any
+@property (nonatomic, copy, nullable) NSArray<NSString *> *compoundIndexKeyNames;
+// the names of the latitude and longitude properties of the geo index this
+// property holds the keys of, as it's returned by +[RLMObject geoIndexes], if any
+@property (nonatomic, copy, nullable) NSArray<NSString *> *geoIndexCoordinateNames;
+// the names of the properties holding the keys of geo indexes which this
+// property is a coordinate of, if any
+@property (nonatomic, copy, nullable) NSArray<NSString *> *geoIndexKeyNames;
+// the name of the property holding the collation key of this property, as
+// it's returned by +[RLMObject collationKeys], if any
+@property (nonatomic, copy, nullable) NSString *collationKeyName;
+// the name of the property this property holds the collation key of, if
+// any, and the identifier of the locale the key is folded in
+@property (nonatomic, copy, nullable) NSString *collationSourceName;
+@property (nonatomic, copy, nullable) NSString *collationLocaleIdentifier;
+// the names of the properties the value of this property is computed from,
+// as it's listed in +[RLMObject derivedProperties], if any
+@property (nonatomic, copy, nullable) NSArray<NSString *> *derivedInputNames;
+// the names of the derived properties computed from this property, if any
+@property (nonatomic, copy, nullable) NSArray<NSString *> *derivedPropertyNames;
+// the number of floats in the values of this data property, as it's listed
+// in +[RLMObject vectorProperties], or 0 if it isn't a vector property
+@property (nonatomic, assign) NSUInteger vectorDimension;
+// whether this property holds the date at which objects expire, as it's
+// returned by +[RLMObject expirationProperty]
+@property (nonatomic, assign) BOOL isExpirationDate;
+// whether this property's values are computed from the values of other
+// properties whenever those are set, and so can't be set directly
+@property (nonatomic, readonly) BOOL isComputed;
+// whether setting this property recomputes the values of other properties
+@property (nonatomic, readonly) BOOL hasComputedProperties;
 
 // getter and setter names
 @property (nonatomic, copy) NSString *getterName;
@@ -109,6 +158,15 @@ static inline NSString *RLMTypeToString(RLMPropertyType type) {
 
 - (RLMProperty *)copyWithNewName:(NSString *)name;
 
+// A property list representation of the property as built by introspecting
+// its class, and the inverse, used to cache the results of introspection. The
+// metadata which +[RLMObjectSchema schemaForObjectClass:] sets from the class
+// methods afterwards (the primary key, folded, compound, geo and collation
+// indexes, vectors and so on) isn't part of it, as it's set again each time.
+- (NSDictionary *)schemaCacheRepresentation;
+- (nullable instancetype)initWithSchemaCacheRepresentation:(NSDictionary *)representation
+                                               objectClass:(Class)objectClass;
+
 @end
 
 @interface RLMProperty (Dynamic)
@@ -23,10 +23,11 @@
 namespace realm {
     class Group;
     class Query;
+    class DistinctDescriptor;
     class SortDescriptor;
 }
 
-@class RLMObjectSchema, RLMProperty, RLMSchema, RLMSortDescriptor;
+@class RLMObjectSchema, RLMProperty, RLMQueryCondition, RLMSchema, RLMSortDescriptor;
 class RLMClassInfo;
 
 extern NSString * const RLMPropertiesComparisonTypeMismatchException;
@@ -35,8 +36,63 @@ extern NSString * const RLMUnsupportedTypesFoundInPropertyComparisonException;
 realm::Query RLMPredicateToQuery(NSPredicate *predicate, RLMObjectSchema *objectSchema,
                                  RLMSchema *schema, realm::Group &group);
 
+// Equivalent to the above, but reuses the query built for a previous call with
+// an equivalent predicate on the same class when possible
+realm::Query RLMPredicateToQuery(NSPredicate *predicate, RLMClassInfo& classInfo);
+
+// Build the query for an RLMQueryCondition, resolving the properties it
+// compares by name without parsing or validating key paths
+realm::Query RLMConditionToQuery(RLMClassInfo& classInfo, RLMQueryCondition *condition);
+
+// Build a query matching the objects where each word of `text` is the start of
+// a word in at least one of the given string properties, ignoring case and
+// diacritics. Properties with a folded copy are searched using the copy.
+realm::Query RLMTextSearchQuery(RLMClassInfo& classInfo, NSString *text, NSArray<NSString *> *propertyNames);
+
+// Build a query matching the objects whose location, as given by the latitude
+// and longitude of the geo index whose key is `geoIndex`, is within `distance`
+// meters of the given location. Only the objects in the cells of the index
+// overlapping the circle's bounding box are measured.
+realm::Query RLMGeoRadiusQuery(RLMClassInfo& classInfo, NSString *geoIndex,
+                               double latitude, double longitude, double distance);
+
+// Build a query matching the objects which come no later than the `limit`th
+// match of `query` when sorted by the given descriptors, or in table order if
+// there are none. Objects which tie with the last of them are also matched,
+// and if `query` has no more than `limit` matches the last of them is the
+// cutoff, so the query never matches everything that's added later.
+realm::Query RLMLimitedQuery(RLMClassInfo& classInfo, realm::Query query,
+                             NSArray<RLMSortDescriptor *> *descriptors, size_t limit);
+
+// Describe how the query built for `predicate` is evaluated: the tree of
+// conditions, the strategy used for each of them (e.g. "index", "scan" or
+// "linkTraversal"), and an estimate of the number of rows each looks at.
+NSDictionary<NSString *, id> *RLMExplainPredicate(NSPredicate *predicate, RLMClassInfo& classInfo);
+
+// Support for -[RLMResults materializeWithName:error:] and
+// -[RLMResults materializedResultsNamed:]. The rows matched by a
+// query are stored in the Realm file under a name, along with a key
+// identifying the query and the version of the file they were stored at, and
+// are used without evaluating the query while the file is at that version.
+
+// Build a query which matches the rows stored under `name` for the query
+// identified by `key` rather than evaluating `source`, for as long as the data
+// hasn't changed since they were stored, and which evaluates `source` once it
+// has. Returns false if no rows are stored for the query at `version`, the
+// version of the current read transaction.
+bool RLMStoredMaterializedQuery(RLMClassInfo& classInfo, realm::Query const& source,
+                                NSString *name, NSString *key, uint64_t version, realm::Query& query);
+
+// Evaluate `source` and store the rows it matches under `name`. Must be called
+// in a write transaction, with `version` being the version its commit produces.
+void RLMStoreMaterializedQuery(RLMClassInfo& classInfo, realm::Query source, NSString *name, NSString *key,
+                               uint64_t version);
+
 // return property - throw for invalid column name
 RLMProperty *RLMValidatedProperty(RLMObjectSchema *objectSchema, NSString *columnName);
 
 // validate the array of RLMSortDescriptors and convert it to a realm::SortDescriptor
 realm::SortDescriptor RLMSortDescriptorFromDescriptors(RLMClassInfo& classInfo, NSArray<RLMSortDescriptor *> *descriptors);
+
+// validate the array of key paths and convert it to a realm::DistinctDescriptor
+realm::DistinctDescriptor RLMDistinctDescriptorFromKeyPaths(RLMClassInfo& classInfo, NSArray<NSString *> *keyPaths);
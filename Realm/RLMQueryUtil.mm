@@ -19,10 +19,13 @@
 #import "RLMQueryUtil.hpp"
 
 #import "RLMArray.h"
+#import "RLMClassInfo.hpp"
 #import "RLMObjectSchema_Private.h"
 #import "RLMObject_Private.hpp"
 #import "RLMPredicateUtil.hpp"
 #import "RLMProperty_Private.h"
+#import "RLMRealm_Private.hpp"
+#import "RLMResults_Private.h"
 #import "RLMSchema.h"
 #import "RLMUtil.hpp"
 
@@ -31,8 +34,17 @@
 
 #include <realm/query_engine.hpp>
 #include <realm/query_expression.hpp>
+#include <realm/table_view.hpp>
+#include <realm/unicode.hpp>
 #include <realm/util/cf_ptr.hpp>
 
+#include <list>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+
 using namespace realm;
 
 NSString * const RLMPropertiesComparisonTypeMismatchException = @"RLMPropertiesComparisonTypeMismatchException";
@@ -146,16 +158,580 @@ struct FalseExpression : realm::Expression {
     }
 };
 
+// InSetExpression matches the rows whose value in an int or string column is
+// one of a fixed set of values. Each row is checked with a single hash lookup,
+// rather than being compared with each value in turn as it would be by an OR
+// group of equality conditions.
+
+struct StringDataHash {
+    size_t operator()(StringData str) const noexcept {
+        // FNV-1a
+        uint64_t hash = 14695981039346656037ULL;
+        for (size_t i = 0; i < str.size(); ++i) {
+            hash = (hash ^ static_cast<unsigned char>(str[i])) * 1099511628211ULL;
+        }
+        return static_cast<size_t>(hash);
+    }
+};
+
+struct IntSet {
+    std::unordered_set<int64_t> values;
+
+    void insert(id value) { values.insert([value longLongValue]); }
+    bool contains(const Table& table, size_t column, size_t row, bool matchesNull) const {
+        if (table.is_nullable(column) && table.is_null(column, row)) {
+            return matchesNull;
+        }
+        return values.count(table.get_int(column, row));
+    }
+};
+
+struct StringSet {
+    // The elements of an unordered_set are never moved, so `values` can
+    // refer to the strings owned by `storage`
+    std::unordered_set<std::string> storage;
+    std::unordered_set<StringData, StringDataHash> values;
+
+    void insert(id value) {
+        RLMStringDataBuffer buffer(value);
+        StringData str = buffer;
+        values.insert(*storage.emplace(str.data(), str.size()).first);
+    }
+    bool contains(const Table& table, size_t column, size_t row, bool matchesNull) const {
+        StringData value = table.get_string(column, row);
+        if (value.is_null()) {
+            return matchesNull;
+        }
+        return values.count(value);
+    }
+};
+
+template <typename Set>
+class InSetExpression : public realm::Expression {
+public:
+    InSetExpression(const Table* table, size_t column, id values)
+    : m_table(table), m_column(column), m_values(std::make_shared<Set>())
+    {
+        for (id value in values) {
+            if (value == NSNull.null) {
+                m_matches_null = true;
+            }
+            else {
+                m_values->insert(value);
+            }
+        }
+    }
+
+    size_t find_first(size_t start, size_t end) const override
+    {
+        REALM_ASSERT_DEBUG(m_table);
+        for (; start < end; ++start) {
+            if (m_values->contains(*m_table, m_column, start, m_matches_null)) {
+                return start;
+            }
+        }
+        return realm::not_found;
+    }
+    void set_base_table(const Table* table) override
+    {
+        if (table) {
+            m_table = table;
+        }
+    }
+    void verify_column() const override {}
+    const Table* get_base_table() const override { return m_table; }
+    std::unique_ptr<Expression> clone(QueryNodeHandoverPatches* patches) const override
+    {
+        if (patches) {
+            return std::unique_ptr<Expression>(new InSetExpression(*this, *patches));
+        }
+        return std::unique_ptr<Expression>(new InSetExpression(*this));
+    }
+    void apply_handover_patch(QueryNodeHandoverPatches&, Group& group) override
+    {
+        // Resolve the table in the group the query was handed over to, so
+        // that rows are read at that group's version
+        m_table = group.get_table(m_table_index).get();
+    }
+
+private:
+    const Table* m_table;
+    size_t m_table_index = realm::npos;
+    size_t m_column;
+    // Immutable once built, so it can be shared by copies of the query
+    std::shared_ptr<Set> m_values;
+    bool m_matches_null = false;
+
+    // A copy being handed over to another thread must not read through the
+    // source thread's table accessor, so it only records the table's index
+    // until the handover is applied
+    InSetExpression(InSetExpression const& other, QueryNodeHandoverPatches&)
+    : m_table(nullptr), m_table_index(other.m_table->get_index_in_group()), m_column(other.m_column)
+    , m_values(other.m_values), m_matches_null(other.m_matches_null)
+    {
+    }
+    InSetExpression(InSetExpression const&) = default;
+};
+
+// A view of a table sorted by one of its int or date columns, which lets range
+// comparisons on the column binary search for the matching rows rather than
+// comparing the value of every row. The view is shared by all of the range
+// expressions for the same column of a table accessor, and so is only used on
+// the thread the accessor belongs to. It's re-sorted the first time it's used
+// after the table changes.
+class SortedColumnView {
+public:
+    static std::shared_ptr<SortedColumnView> get(const Table& table, size_t column)
+    {
+        static std::mutex s_mutex;
+        static std::map<std::pair<const Table*, size_t>, std::weak_ptr<SortedColumnView>> s_views;
+
+        std::lock_guard<std::mutex> lock(s_mutex);
+        auto& entry = s_views[{&table, column}];
+        if (auto view = entry.lock()) {
+            return view;
+        }
+        // The views keep their table accessor alive, so an expired entry
+        // can't refer to a table which is still in use at the same address
+        for (auto it = s_views.begin(); it != s_views.end(); ) {
+            it = it->second.expired() && &it->second != &entry ? s_views.erase(it) : std::next(it);
+        }
+        auto view = std::make_shared<SortedColumnView>(table, column);
+        entry = view;
+        return view;
+    }
+
+    SortedColumnView(const Table& table, size_t column)
+    : m_view(table.get_sorted_view(column)), m_column(column) { }
+
+    // Bring the view up to date with the table, returning its version
+    uint_fast64_t sync() { return m_view.sync_if_needed(); }
+
+    // The rows whose value is within the given bounds, in table order
+    template<typename T>
+    std::vector<size_t> rows_in_range(util::Optional<T> const& lower, bool lower_inclusive,
+                                      util::Optional<T> const& upper, bool upper_inclusive) const
+    {
+        // Nulls are sorted before all other values and never match a range
+        size_t begin = partition_point(0, m_view.size(), [&](size_t i) { return m_view.is_null(m_column, i); });
+        if (lower) {
+            begin = partition_point(begin, m_view.size(), [&](size_t i) {
+                T value = get<T>(i);
+                return lower_inclusive ? value < *lower : !(*lower < value);
+            });
+        }
+        size_t end = m_view.size();
+        if (upper) {
+            end = partition_point(begin, end, [&](size_t i) {
+                T value = get<T>(i);
+                return upper_inclusive ? !(*upper < value) : value < *upper;
+            });
+        }
+
+        std::vector<size_t> rows;
+        rows.reserve(end - begin);
+        for (size_t i = begin; i < end; ++i) {
+            rows.push_back(m_view.get_source_ndx(i));
+        }
+        std::sort(rows.begin(), rows.end());
+        return rows;
+    }
+
+private:
+    ConstTableView m_view;
+    size_t m_column;
+
+    template<typename T> T get(size_t i) const;
+
+    // The first index in [begin, end) for which `pred` is false, given that
+    // it is true for all of the indices before that one
+    template<typename Predicate>
+    static size_t partition_point(size_t begin, size_t end, Predicate&& pred)
+    {
+        while (begin < end) {
+            size_t mid = begin + (end - begin) / 2;
+            if (pred(mid)) {
+                begin = mid + 1;
+            }
+            else {
+                end = mid;
+            }
+        }
+        return begin;
+    }
+};
+
+template<> int64_t SortedColumnView::get<int64_t>(size_t i) const { return m_view.get_int(m_column, i); }
+template<> Timestamp SortedColumnView::get<Timestamp>(size_t i) const { return m_view.get_timestamp(m_column, i); }
+
+// Matches the rows whose value in an indexed int or date column is within a
+// range, using a SortedColumnView to find them in O(log n + k) once the view
+// is sorted.
+template<typename T>
+class SortedRangeExpression : public realm::Expression {
+public:
+    SortedRangeExpression(const Table* table, size_t column,
+                          util::Optional<T> lower, bool lower_inclusive,
+                          util::Optional<T> upper, bool upper_inclusive)
+    : m_table(table), m_column(column)
+    , m_lower(std::move(lower)), m_upper(std::move(upper))
+    , m_lower_inclusive(lower_inclusive), m_upper_inclusive(upper_inclusive)
+    {
+    }
+
+    size_t find_first(size_t start, size_t end) const override
+    {
+        if (!m_view) {
+            m_view = SortedColumnView::get(*m_table, m_column);
+        }
+        auto version = m_view->sync();
+        if (!m_matches || version != m_matches_version) {
+            m_matches = std::make_shared<std::vector<size_t>>(m_view->rows_in_range(m_lower, m_lower_inclusive,
+                                                                                    m_upper, m_upper_inclusive));
+            m_matches_version = version;
+        }
+        auto it = std::lower_bound(m_matches->begin(), m_matches->end(), start);
+        return it != m_matches->end() && *it < end ? *it : realm::not_found;
+    }
+    void set_base_table(const Table* table) override
+    {
+        if (table && table != m_table) {
+            m_table = table;
+            m_view = nullptr;
+            m_matches = nullptr;
+        }
+    }
+    void verify_column() const override {}
+    const Table* get_base_table() const override { return m_table; }
+    std::unique_ptr<Expression> clone(QueryNodeHandoverPatches* patches) const override
+    {
+        if (patches) {
+            return std::unique_ptr<Expression>(new SortedRangeExpression(*this, *patches));
+        }
+        return std::unique_ptr<Expression>(new SortedRangeExpression(*this));
+    }
+    void apply_handover_patch(QueryNodeHandoverPatches&, Group& group) override
+    {
+        m_table = group.get_table(m_table_index).get();
+    }
+
+private:
+    const Table* m_table;
+    size_t m_table_index = realm::npos;
+    size_t m_column;
+    util::Optional<T> m_lower, m_upper;
+    bool m_lower_inclusive, m_upper_inclusive;
+
+    mutable std::shared_ptr<SortedColumnView> m_view;
+    mutable std::shared_ptr<std::vector<size_t>> m_matches;
+    mutable uint_fast64_t m_matches_version = 0;
+
+    // Queries handed over to another thread have to sort their own view of
+    // the table there, so the copy only records the table's index until the
+    // handover is applied (see InSetExpression)
+    SortedRangeExpression(SortedRangeExpression const& other, QueryNodeHandoverPatches&)
+    : m_table(nullptr), m_table_index(other.m_table->get_index_in_group()), m_column(other.m_column)
+    , m_lower(other.m_lower), m_upper(other.m_upper)
+    , m_lower_inclusive(other.m_lower_inclusive), m_upper_inclusive(other.m_upper_inclusive)
+    {
+    }
+    SortedRangeExpression(SortedRangeExpression const&) = default;
+};
+
+// The ranges of geo index keys (see RLMGeoIndexKey()) of the quadtree cells
+// which together cover the steps within a bounding box, sorted and with
+// adjacent ranges merged. Cells are split until they're within the box or
+// there would be too many ranges, so the ranges can also contain the keys of
+// locations near the box, but never miss any of the keys within it.
+std::vector<std::pair<int64_t, int64_t>> geo_index_ranges(uint32_t minLatitude, uint32_t maxLatitude,
+                                                          uint32_t minLongitude, uint32_t maxLongitude)
+{
+    const size_t maxRanges = 16;
+    struct Cell {
+        uint32_t latitude, longitude;
+        int level;
+    };
+    auto key_range = [](Cell const& cell) {
+        int shift = RLMGeoIndexBits - cell.level;
+        int64_t first = RLMGeoIndexKey(cell.latitude << shift, cell.longitude << shift);
+        return std::make_pair(first, first + ((int64_t(1) << (2 * shift)) - 1));
+    };
+
+    std::vector<std::pair<int64_t, int64_t>> ranges;
+    std::vector<Cell> cells = {{0, 0, 0}};
+    while (!cells.empty()) {
+        std::vector<Cell> partial;
+        for (auto& cell : cells) {
+            int shift = RLMGeoIndexBits - cell.level;
+            uint32_t last = (uint32_t(1) << shift) - 1;
+            uint32_t lat0 = cell.latitude << shift, lng0 = cell.longitude << shift;
+            if (lat0 + last < minLatitude || lat0 > maxLatitude || lng0 + last < minLongitude || lng0 > maxLongitude) {
+                continue;
+            }
+            if (shift == 0 || (lat0 >= minLatitude && lat0 + last <= maxLatitude
+                               && lng0 >= minLongitude && lng0 + last <= maxLongitude)) {
+                ranges.push_back(key_range(cell));
+            }
+            else {
+                partial.push_back(cell);
+            }
+        }
+        if (ranges.size() + partial.size() * 4 > maxRanges) {
+            for (auto& cell : partial) {
+                ranges.push_back(key_range(cell));
+            }
+            break;
+        }
+        cells.clear();
+        for (auto& cell : partial) {
+            for (uint32_t i = 0; i < 4; ++i) {
+                cells.push_back({cell.latitude << 1 | i >> 1, cell.longitude << 1 | (i & 1), cell.level + 1});
+            }
+        }
+    }
+
+    std::sort(ranges.begin(), ranges.end());
+    std::vector<std::pair<int64_t, int64_t>> merged;
+    for (auto& range : ranges) {
+        if (!merged.empty() && merged.back().second + 1 == range.first) {
+            merged.back().second = range.second;
+        }
+        else {
+            merged.push_back(range);
+        }
+    }
+    return merged;
+}
+
+// Matches the rows matched by a query of the locations within a bounding box
+// whose great-circle distance from a point is within a radius. The query
+// finds the candidates using the geo index, so only they are measured.
+class GeoDistanceExpression : public realm::Expression {
+public:
+    GeoDistanceExpression(const Table* table, size_t latitude_column, size_t longitude_column,
+                          double latitude, double longitude, double distance, Query candidates)
+    : m_table(table), m_latitude_column(latitude_column), m_longitude_column(longitude_column)
+    , m_latitude(latitude), m_longitude(longitude), m_distance(distance), m_candidates(std::move(candidates))
+    {
+    }
+
+    size_t find_first(size_t start, size_t end) const override
+    {
+        for (size_t row = m_candidates.find(start); row < end; row = m_candidates.find(row + 1)) {
+            if (!m_table->is_null(m_latitude_column, row) && !m_table->is_null(m_longitude_column, row)
+                && distance_to(m_table->get_double(m_latitude_column, row),
+                               m_table->get_double(m_longitude_column, row)) <= m_distance) {
+                return row;
+            }
+        }
+        return realm::not_found;
+    }
+    void set_base_table(const Table* table) override
+    {
+        if (table) {
+            m_table = table;
+        }
+    }
+    void verify_column() const override {}
+    const Table* get_base_table() const override { return m_table; }
+    std::unique_ptr<Expression> clone(QueryNodeHandoverPatches* patches) const override
+    {
+        if (patches) {
+            return std::unique_ptr<Expression>(new GeoDistanceExpression(*this, *patches));
+        }
+        return std::unique_ptr<Expression>(new GeoDistanceExpression(*this));
+    }
+    void apply_handover_patch(QueryNodeHandoverPatches& patches, Group& group) override
+    {
+        m_candidates.apply_patches(patches, group);
+        m_table = group.get_table(m_table_index).get();
+    }
+
+    // The mean radius of the Earth, in meters
+    static constexpr double earth_radius = 6371008.8;
+
+private:
+    const Table* m_table;
+    size_t m_table_index = realm::npos;
+    size_t m_latitude_column, m_longitude_column;
+    double m_latitude, m_longitude, m_distance;
+    mutable Query m_candidates;
+
+    // The copy reads the coordinates through the destination group's table
+    // once the handover is applied (see InSetExpression)
+    GeoDistanceExpression(GeoDistanceExpression const& other, QueryNodeHandoverPatches& patches)
+    : m_table(nullptr), m_table_index(other.m_table->get_index_in_group())
+    , m_latitude_column(other.m_latitude_column), m_longitude_column(other.m_longitude_column)
+    , m_latitude(other.m_latitude), m_longitude(other.m_longitude), m_distance(other.m_distance)
+    , m_candidates(other.m_candidates, patches, ConstSourcePayload::Copy)
+    {
+    }
+    GeoDistanceExpression(GeoDistanceExpression const&) = default;
+
+    // The haversine formula
+    double distance_to(double latitude, double longitude) const
+    {
+        const double radians = M_PI / 180;
+        double sinLatitude = sin((latitude - m_latitude) * radians / 2);
+        double sinLongitude = sin((longitude - m_longitude) * radians / 2);
+        double a = sinLatitude * sinLatitude
+                 + cos(m_latitude * radians) * cos(latitude * radians) * sinLongitude * sinLongitude;
+        return 2 * earth_radius * asin(std::min(1.0, sqrt(a)));
+    }
+};
+
+// Matches the rows of a table which link through one of its link list columns
+// to at least one of the rows of the target table matched by a query. The
+// query is evaluated once on the target table and its matches are mapped back
+// to the rows linking to them through the target table's backlinks, so the
+// cost is proportional to the number of matching targets rather than to the
+// number of rows times the length of their lists.
+class LinkedRowsExpression : public realm::Expression {
+public:
+    LinkedRowsExpression(const Table* table, size_t link_column, Query targets)
+    : m_table(table), m_link_column(link_column), m_target_query(std::move(targets))
+    {
+    }
+
+    size_t find_first(size_t start, size_t end) const override
+    {
+        if (!m_targets) {
+            m_targets = std::make_shared<TableView>(m_target_query.find_all());
+        }
+        // The target query depends on the backlinks from this table, so the
+        // view's version changes when either the targets or the links do
+        auto version = m_targets->sync_if_needed();
+        if (!m_matches || version != m_matches_version) {
+            m_matches = std::make_shared<std::vector<size_t>>(linking_rows());
+            m_matches_version = version;
+        }
+        auto it = std::lower_bound(m_matches->begin(), m_matches->end(), start);
+        return it != m_matches->end() && *it < end ? *it : realm::not_found;
+    }
+    void set_base_table(const Table* table) override
+    {
+        if (table && table != m_table) {
+            m_table = table;
+            m_targets = nullptr;
+            m_matches = nullptr;
+        }
+    }
+    void verify_column() const override {}
+    const Table* get_base_table() const override { return m_table; }
+    std::unique_ptr<Expression> clone(QueryNodeHandoverPatches* patches) const override
+    {
+        if (patches) {
+            return std::unique_ptr<Expression>(new LinkedRowsExpression(*this, *patches));
+        }
+        return std::unique_ptr<Expression>(new LinkedRowsExpression(*this));
+    }
+    void apply_handover_patch(QueryNodeHandoverPatches& patches, Group& group) override
+    {
+        m_target_query.apply_patches(patches, group);
+        m_table = group.get_table(m_table_index).get();
+    }
+
+private:
+    const Table* m_table;
+    size_t m_table_index = realm::npos;
+    size_t m_link_column;
+    mutable Query m_target_query;
+
+    mutable std::shared_ptr<TableView> m_targets;
+    mutable std::shared_ptr<std::vector<size_t>> m_matches;
+    mutable uint_fast64_t m_matches_version = 0;
+
+    // The copy follows the backlinks into the destination group's table once
+    // the handover is applied (see InSetExpression)
+    LinkedRowsExpression(LinkedRowsExpression const& other, QueryNodeHandoverPatches& patches)
+    : m_table(nullptr), m_table_index(other.m_table->get_index_in_group()), m_link_column(other.m_link_column)
+    , m_target_query(other.m_target_query, patches, ConstSourcePayload::Copy)
+    {
+    }
+    LinkedRowsExpression(LinkedRowsExpression const&) = default;
+
+    std::vector<size_t> linking_rows() const
+    {
+        const Table& target_table = *m_target_query.get_table();
+        std::vector<size_t> rows;
+        for (size_t i = 0, size = m_targets->size(); i < size; ++i) {
+            size_t target = m_targets->get_source_ndx(i);
+            for (size_t j = 0, count = target_table.get_backlink_count(target, *m_table, m_link_column); j < count; ++j) {
+                rows.push_back(target_table.get_backlink(target, *m_table, m_link_column, j));
+            }
+        }
+        std::sort(rows.begin(), rows.end());
+        rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+        return rows;
+    }
+};
 
 // Equal and ContainsSubstring are used by QueryBuilder::add_string_constraint as the comparator
 // for performing diacritic-insensitive comparisons.
 
+// ASCII characters have no diacritics, so when both strings are entirely ASCII
+// the comparison can be done directly on the UTF-8 bytes, folding case as
+// needed, rather than by creating CFStrings for them.
+bool is_ascii(StringData str)
+{
+    for (size_t i = 0; i < str.size(); ++i) {
+        if (static_cast<unsigned char>(str[i]) >= 0x80) {
+            return false;
+        }
+    }
+    return true;
+}
+
+char fold_ascii(char c, bool caseInsensitive)
+{
+    return caseInsensitive && c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c;
+}
+
+bool ascii_equal(const char *s1, const char *s2, size_t size, bool caseInsensitive)
+{
+    if (!caseInsensitive) {
+        return memcmp(s1, s2, size) == 0;
+    }
+    for (size_t i = 0; i < size; ++i) {
+        if (fold_ascii(s1[i], true) != fold_ascii(s2[i], true)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ascii_contains_substring(CFStringCompareFlags options, StringData haystack, StringData needle)
+{
+    bool caseInsensitive = options & kCFCompareCaseInsensitive;
+    if (needle.size() > haystack.size()) {
+        return false;
+    }
+    if (options & kCFCompareAnchored) {
+        size_t offset = options & kCFCompareBackwards ? haystack.size() - needle.size() : 0;
+        return ascii_equal(haystack.data() + offset, needle.data(), needle.size(), caseInsensitive);
+    }
+
+    char first = fold_ascii(needle[0], caseInsensitive);
+    for (size_t i = 0, end = haystack.size() - needle.size(); i <= end; ++i) {
+        if (fold_ascii(haystack[i], caseInsensitive) == first
+            && ascii_equal(haystack.data() + i + 1, needle.data() + 1, needle.size() - 1, caseInsensitive)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 bool equal(CFStringCompareFlags options, StringData v1, StringData v2)
 {
     if (v1.is_null() || v2.is_null()) {
         return v1.is_null() == v2.is_null();
     }
 
+    if (is_ascii(v1) && is_ascii(v2)) {
+        return v1.size() == v2.size()
+            && ascii_equal(v1.data(), v2.data(), v1.size(), options & kCFCompareCaseInsensitive);
+    }
+
     auto s1 = util::adoptCF(CFStringCreateWithBytesNoCopy(kCFAllocatorSystemDefault, (const UInt8*)v1.data(), v1.size(),
                                                           kCFStringEncodingUTF8, false, kCFAllocatorNull));
     auto s2 = util::adoptCF(CFStringCreateWithBytesNoCopy(kCFAllocatorSystemDefault, (const UInt8*)v2.data(), v2.size(),
@@ -195,6 +771,10 @@ bool contains_substring(CFStringCompareFlags options, StringData v1, StringData
         return true;
     }
 
+    if (is_ascii(v1) && is_ascii(v2)) {
+        return ascii_contains_substring(options, v1, v2);
+    }
+
     auto s1 = util::adoptCF(CFStringCreateWithBytesNoCopy(kCFAllocatorSystemDefault, (const UInt8*)v1.data(), v1.size(),
                                                           kCFStringEncodingUTF8, false, kCFAllocatorNull));
     auto s2 = util::adoptCF(CFStringCreateWithBytesNoCopy(kCFAllocatorSystemDefault, (const UInt8*)v2.data(), v2.size(),
@@ -218,53 +798,355 @@ struct ContainsSubstring {
 };
 
 
-NSString *operatorName(NSPredicateOperatorType operatorType)
-{
-    switch (operatorType) {
-        case NSLessThanPredicateOperatorType:
-            return @"<";
-        case NSLessThanOrEqualToPredicateOperatorType:
-            return @"<=";
-        case NSGreaterThanPredicateOperatorType:
-            return @">";
-        case NSGreaterThanOrEqualToPredicateOperatorType:
-            return @">=";
-        case NSEqualToPredicateOperatorType:
-            return @"==";
-        case NSNotEqualToPredicateOperatorType:
-            return @"!=";
-        case NSMatchesPredicateOperatorType:
-            return @"MATCHES";
-        case NSLikePredicateOperatorType:
-            return @"LIKE";
-        case NSBeginsWithPredicateOperatorType:
-            return @"BEGINSWITH";
-        case NSEndsWithPredicateOperatorType:
-            return @"ENDSWITH";
-        case NSInPredicateOperatorType:
-            return @"IN";
-        case NSContainsPredicateOperatorType:
-            return @"CONTAINS";
-        case NSBetweenPredicateOperatorType:
-            return @"BETWEEN";
-        case NSCustomSelectorPredicateOperatorType:
-            return @"custom selector";
-    }
+// TextSearchExpression matches the rows where each of a set of search words
+// is the start of a word in at least one of a set of string columns, ignoring
+// case and diacritics. All of the columns are checked in a single pass over
+// the rows.
 
-    return [NSString stringWithFormat:@"unknown operator %lu", (unsigned long)operatorType];
+bool is_word_byte(unsigned char c)
+{
+    // All bytes of multi-byte UTF-8 sequences are treated as part of a word
+    return c >= 0x80 || (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
 }
 
-Table& get_table(Group& group, RLMObjectSchema *objectSchema)
+// `word` must already be folded
+bool contains_word_prefix(StringData text, const std::string& word)
 {
-    return *ObjectStore::table_for_object_type(group, objectSchema.objectName.UTF8String);
+    if (word.size() > text.size()) {
+        return false;
+    }
+    for (size_t i = 0, end = text.size() - word.size(); i <= end; ++i) {
+        if (i > 0 && is_word_byte(text[i - 1])) {
+            continue;
+        }
+        bool match = true;
+        for (size_t j = 0; j < word.size(); ++j) {
+            char c = text[i + j];
+            if ((c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c) != word[j]) {
+                match = false;
+                break;
+            }
+        }
+        if (match) {
+            return true;
+        }
+    }
+    return false;
 }
 
-// A reference to a column within a query. Can be resolved to a Columns<T> for use in query expressions.
-class ColumnReference {
+class TextSearchExpression : public realm::Expression {
 public:
-    ColumnReference(Query& query, Group& group, RLMSchema *schema, RLMProperty* property, const std::vector<RLMProperty*>& links = {})
-    : m_links(links), m_property(property), m_schema(schema), m_group(&group), m_query(&query), m_table(query.get_table().get())
-    {
+    struct SearchColumn {
+        size_t index;
+        // Whether the column is the folded copy of a property, in which case
+        // its values never need to be folded
+        bool folded;
+    };
+
+    TextSearchExpression(const Table* table, std::vector<SearchColumn> columns, std::vector<std::string> words)
+    : m_table(table), m_columns(std::move(columns)), m_words(std::move(words))
+    , m_values(m_columns.size()), m_foldedValues(m_columns.size()) { }
+
+    size_t find_first(size_t start, size_t end) const override
+    {
+        for (; start < end; ++start) {
+            if (matches(start)) {
+                return start;
+            }
+        }
+        return realm::not_found;
+    }
+    void set_base_table(const Table* table) override
+    {
+        if (table) {
+            m_table = table;
+        }
+    }
+    void verify_column() const override {}
+    const Table* get_base_table() const override { return m_table; }
+    std::unique_ptr<Expression> clone(QueryNodeHandoverPatches* patches) const override
+    {
+        if (patches) {
+            return std::unique_ptr<Expression>(new TextSearchExpression(*this, *patches));
+        }
+        return std::unique_ptr<Expression>(new TextSearchExpression(*this));
+    }
+    void apply_handover_patch(QueryNodeHandoverPatches&, Group& group) override
+    {
+        m_table = group.get_table(m_table_index).get();
+    }
+
+private:
+    bool matches(size_t row) const
+    {
+        // ASCII values only need their case folded, which is done while
+        // comparing, so only other values have to be folded up front
+        for (size_t i = 0; i < m_columns.size(); ++i) {
+            StringData value = m_table->get_string(m_columns[i].index, row);
+            if (!m_columns[i].folded && !value.is_null() && !is_ascii(value)) {
+                NSString *folded = RLMFoldedString(RLMStringDataToNSString(value));
+                m_foldedValues[i] = folded.UTF8String;
+                value = m_foldedValues[i];
+            }
+            m_values[i] = value;
+        }
+
+        for (auto& word : m_words) {
+            bool found = false;
+            for (auto& value : m_values) {
+                if (!value.is_null() && contains_word_prefix(value, word)) {
+                    found = true;
+                    break;
+                }
+            }
+            if (!found) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const Table* m_table;
+    size_t m_table_index = realm::npos;
+    std::vector<SearchColumn> m_columns;
+    std::vector<std::string> m_words;
+    // Per-row scratch space, kept to avoid allocating for every row
+    mutable std::vector<StringData> m_values;
+    mutable std::vector<std::string> m_foldedValues;
+
+    // The copy reads the strings through the destination group's table once
+    // the handover is applied (see InSetExpression)
+    TextSearchExpression(TextSearchExpression const& other, QueryNodeHandoverPatches&)
+    : m_table(nullptr), m_table_index(other.m_table->get_index_in_group())
+    , m_columns(other.m_columns), m_words(other.m_words)
+    , m_values(m_columns.size()), m_foldedValues(m_columns.size())
+    {
+    }
+    TextSearchExpression(TextSearchExpression const&) = default;
+};
+
+// SortCutoffExpression matches the rows which come no later than a cutoff key
+// in a sort order, which lets a sorted query be limited to its first rows
+// without sorting every row which matches it. Values are compared in the same
+// way as core compares them when sorting, with nulls before all other values.
+
+struct SortKeyColumn {
+    // The column indices of the key path, with all but the last being links.
+    // An empty path sorts on the row index, which is the order of unsorted
+    // results.
+    std::vector<size_t> path;
+    DataType type;
+    bool ascending;
+};
+
+struct SortKeyValue {
+    bool null = true;
+    int64_t integer = 0;
+    double number = 0;
+    Timestamp timestamp;
+    std::string string;
+};
+
+using SortKey = std::vector<SortKeyValue>;
+
+void read_sort_key_value(const Table* table, SortKeyColumn const& column, size_t row, SortKeyValue& value)
+{
+    if (column.path.empty()) {
+        value.null = false;
+        value.integer = row;
+        return;
+    }
+    for (size_t i = 0; i + 1 < column.path.size(); ++i) {
+        size_t col = column.path[i];
+        if (table->is_null_link(col, row)) {
+            value.null = true;
+            return;
+        }
+        row = table->get_link(col, row);
+        table = table->get_link_target(col).get();
+    }
+
+    size_t col = column.path.back();
+    value.null = table->is_null(col, row);
+    if (value.null) {
+        return;
+    }
+    switch (column.type) {
+        case type_Int:
+            value.integer = table->get_int(col, row);
+            break;
+        case type_Bool:
+            value.integer = table->get_bool(col, row);
+            break;
+        case type_Float:
+            value.number = table->get_float(col, row);
+            break;
+        case type_Double:
+            value.number = table->get_double(col, row);
+            break;
+        case type_Timestamp:
+            value.timestamp = table->get_timestamp(col, row);
+            break;
+        case type_String: {
+            StringData string = table->get_string(col, row);
+            value.string.assign(string.data(), string.size());
+            break;
+        }
+        default:
+            REALM_UNREACHABLE();
+    }
+}
+
+void read_sort_key(const Table* table, std::vector<SortKeyColumn> const& columns, size_t row, SortKey& key)
+{
+    key.resize(columns.size());
+    for (size_t i = 0; i < columns.size(); ++i) {
+        read_sort_key_value(table, columns[i], row, key[i]);
+    }
+}
+
+template<typename T>
+int compare_values(T const& a, T const& b)
+{
+    return a < b ? -1 : b < a ? 1 : 0;
+}
+
+int compare_sort_keys(std::vector<SortKeyColumn> const& columns, SortKey const& a, SortKey const& b)
+{
+    for (size_t i = 0; i < columns.size(); ++i) {
+        auto& lhs = a[i], &rhs = b[i];
+        int result;
+        if (lhs.null || rhs.null) {
+            result = lhs.null == rhs.null ? 0 : lhs.null ? -1 : 1;
+        }
+        else {
+            switch (columns[i].type) {
+                case type_Int:
+                case type_Bool:
+                    result = compare_values(lhs.integer, rhs.integer);
+                    break;
+                case type_Float:
+                case type_Double:
+                    result = compare_values(lhs.number, rhs.number);
+                    break;
+                case type_Timestamp:
+                    result = compare_values(lhs.timestamp, rhs.timestamp);
+                    break;
+                case type_String:
+                    result = lhs.string == rhs.string ? 0 : utf8_compare(lhs.string, rhs.string) ? -1 : 1;
+                    break;
+                default:
+                    REALM_UNREACHABLE();
+            }
+        }
+        if (result != 0) {
+            return columns[i].ascending ? result : -result;
+        }
+    }
+    return 0;
+}
+
+class SortCutoffExpression : public realm::Expression {
+public:
+    SortCutoffExpression(const Table* table, std::vector<SortKeyColumn> columns, SortKey cutoff)
+    : m_table(table), m_columns(std::move(columns)), m_cutoff(std::move(cutoff)) { }
+
+    size_t find_first(size_t start, size_t end) const override
+    {
+        for (; start < end; ++start) {
+            read_sort_key(m_table, m_columns, start, m_key);
+            if (compare_sort_keys(m_columns, m_key, m_cutoff) <= 0) {
+                return start;
+            }
+        }
+        return realm::not_found;
+    }
+    void set_base_table(const Table* table) override
+    {
+        if (table) {
+            m_table = table;
+        }
+    }
+    void verify_column() const override {}
+    const Table* get_base_table() const override { return m_table; }
+    std::unique_ptr<Expression> clone(QueryNodeHandoverPatches* patches) const override
+    {
+        if (patches) {
+            return std::unique_ptr<Expression>(new SortCutoffExpression(*this, *patches));
+        }
+        return std::unique_ptr<Expression>(new SortCutoffExpression(*this));
+    }
+    void apply_handover_patch(QueryNodeHandoverPatches&, Group& group) override
+    {
+        m_table = group.get_table(m_table_index).get();
+    }
+
+private:
+    const Table* m_table;
+    size_t m_table_index = realm::npos;
+    std::vector<SortKeyColumn> m_columns;
+    SortKey m_cutoff;
+    // Per-row scratch space, kept to avoid allocating for every row
+    mutable SortKey m_key;
+
+    // The copy reads the sort keys through the destination group's table once
+    // the handover is applied (see InSetExpression)
+    SortCutoffExpression(SortCutoffExpression const& other, QueryNodeHandoverPatches&)
+    : m_table(nullptr), m_table_index(other.m_table->get_index_in_group())
+    , m_columns(other.m_columns), m_cutoff(other.m_cutoff)
+    {
+    }
+    SortCutoffExpression(SortCutoffExpression const&) = default;
+};
+
+
+NSString *operatorName(NSPredicateOperatorType operatorType)
+{
+    switch (operatorType) {
+        case NSLessThanPredicateOperatorType:
+            return @"<";
+        case NSLessThanOrEqualToPredicateOperatorType:
+            return @"<=";
+        case NSGreaterThanPredicateOperatorType:
+            return @">";
+        case NSGreaterThanOrEqualToPredicateOperatorType:
+            return @">=";
+        case NSEqualToPredicateOperatorType:
+            return @"==";
+        case NSNotEqualToPredicateOperatorType:
+            return @"!=";
+        case NSMatchesPredicateOperatorType:
+            return @"MATCHES";
+        case NSLikePredicateOperatorType:
+            return @"LIKE";
+        case NSBeginsWithPredicateOperatorType:
+            return @"BEGINSWITH";
+        case NSEndsWithPredicateOperatorType:
+            return @"ENDSWITH";
+        case NSInPredicateOperatorType:
+            return @"IN";
+        case NSContainsPredicateOperatorType:
+            return @"CONTAINS";
+        case NSBetweenPredicateOperatorType:
+            return @"BETWEEN";
+        case NSCustomSelectorPredicateOperatorType:
+            return @"custom selector";
+    }
+
+    return [NSString stringWithFormat:@"unknown operator %lu", (unsigned long)operatorType];
+}
+
+Table& get_table(Group& group, RLMObjectSchema *objectSchema)
+{
+    return *ObjectStore::table_for_object_type(group, objectSchema.objectName.UTF8String);
+}
+
+// A reference to a column within a query. Can be resolved to a Columns<T> for use in query expressions.
+class ColumnReference {
+public:
+    ColumnReference(Query& query, Group& group, RLMSchema *schema, RLMProperty* property, const std::vector<RLMProperty*>& links = {})
+    : m_links(links), m_property(property), m_schema(schema), m_group(&group), m_query(&query), m_table(query.get_table().get())
+    {
         auto& table = walk_link_chain([](Table&, size_t, RLMPropertyType) { });
         m_index = table.get_column_index(m_property.name.UTF8String);
     }
@@ -501,6 +1383,218 @@ private:
     util::Optional<ColumnReference> m_column;
 };
 
+// The aggregates of a numeric column of the objects in the lists of one of a
+// table's columns, for every row of the table. They're computed in a single
+// pass over the target table which adds each target's value to the aggregates
+// of the rows linking to it through its backlinks, rather than by following
+// each row's list separately. They're shared by all of the expressions on the
+// same table, list and column of a table accessor, and so are only used on the
+// thread the accessor belongs to, and are recomputed the first time they're
+// used after either table changes.
+template<typename T>
+class ListAggregates {
+public:
+    using SumType = typename std::conditional<std::is_integral<T>::value, int64_t, double>::type;
+    struct Aggregate {
+        size_t count = 0; // the number of non-null values
+        SumType sum = 0;
+        T min = 0, max = 0;
+    };
+
+    // `targets` is evaluated to find the target rows when the aggregates are
+    // first created, and must match the rows which are in any of the lists
+    static std::shared_ptr<ListAggregates> get(const Table& table, size_t link_column, size_t target_column,
+                                               Query& targets)
+    {
+        static std::mutex s_mutex;
+        static std::map<std::tuple<const Table*, size_t, size_t>, std::weak_ptr<ListAggregates>> s_aggregates;
+
+        std::lock_guard<std::mutex> lock(s_mutex);
+        auto& entry = s_aggregates[std::make_tuple(&table, link_column, target_column)];
+        if (auto aggregates = entry.lock()) {
+            return aggregates;
+        }
+        // The aggregates keep their table accessors alive, so an expired
+        // entry can't refer to a table which is still in use at the same address
+        for (auto it = s_aggregates.begin(); it != s_aggregates.end(); ) {
+            it = it->second.expired() && &it->second != &entry ? s_aggregates.erase(it) : std::next(it);
+        }
+        auto aggregates = std::make_shared<ListAggregates>(table, link_column, target_column, targets);
+        entry = aggregates;
+        return aggregates;
+    }
+
+    ListAggregates(const Table& table, size_t link_column, size_t target_column, Query& targets)
+    : m_table(table.get_table_ref()), m_link_column(link_column), m_target_column(target_column)
+    , m_targets(targets.find_all())
+    {
+    }
+
+    // Bring the aggregates up to date with the tables
+    void sync()
+    {
+        auto version = m_targets.sync_if_needed();
+        if (!m_computed || version != m_version) {
+            compute();
+            m_version = version;
+            m_computed = true;
+        }
+    }
+
+    const Aggregate& operator[](size_t row) const
+    {
+        static const Aggregate empty;
+        return row < m_aggregates.size() ? m_aggregates[row] : empty;
+    }
+
+private:
+    ConstTableRef m_table;
+    size_t m_link_column;
+    size_t m_target_column;
+    TableView m_targets;
+    std::vector<Aggregate> m_aggregates;
+    uint_fast64_t m_version = 0;
+    bool m_computed = false;
+
+    static T get(const Table& table, size_t column, size_t row);
+
+    void compute()
+    {
+        const Table& target = m_targets.get_parent();
+        bool nullable = target.is_nullable(m_target_column);
+        m_aggregates.assign(m_table->size(), Aggregate());
+        for (size_t i = 0, size = m_targets.size(); i < size; ++i) {
+            size_t target_row = m_targets.get_source_ndx(i);
+            if (nullable && target.is_null(m_target_column, target_row)) {
+                continue;
+            }
+            T value = get(target, m_target_column, target_row);
+            // A row has a backlink for each time the target is in its list
+            for (size_t j = 0, count = target.get_backlink_count(target_row, *m_table, m_link_column); j < count; ++j) {
+                auto& aggregate = m_aggregates[target.get_backlink(target_row, *m_table, m_link_column, j)];
+                if (aggregate.count++ == 0) {
+                    aggregate.min = aggregate.max = value;
+                }
+                else {
+                    aggregate.min = std::min(aggregate.min, value);
+                    aggregate.max = std::max(aggregate.max, value);
+                }
+                aggregate.sum += value;
+            }
+        }
+    }
+};
+
+template<> int64_t ListAggregates<int64_t>::get(const Table& table, size_t column, size_t row) { return table.get_int(column, row); }
+template<> float ListAggregates<float>::get(const Table& table, size_t column, size_t row) { return table.get_float(column, row); }
+template<> double ListAggregates<double>::get(const Table& table, size_t column, size_t row) { return table.get_double(column, row); }
+
+// Matches the rows for which @min, @max, @sum or @avg of a numeric column of
+// the objects in one of their lists compares with a constant in the way core's
+// link list aggregates do, reading the aggregates from a shared ListAggregates.
+template<typename T>
+class ListAggregateExpression : public realm::Expression {
+public:
+    ListAggregateExpression(const Table* table, size_t link_column, size_t target_column, Query targets,
+                            CollectionOperation::Type type, NSPredicateOperatorType operatorType, T value)
+    : m_table(table), m_link_column(link_column), m_target_column(target_column)
+    , m_target_query(std::move(targets)), m_type(type), m_operator(operatorType), m_value(value)
+    {
+    }
+
+    size_t find_first(size_t start, size_t end) const override
+    {
+        if (!m_aggregates) {
+            m_aggregates = ListAggregates<T>::get(*m_table, m_link_column, m_target_column, m_target_query);
+        }
+        m_aggregates->sync();
+        for (; start < end; ++start) {
+            if (matches((*m_aggregates)[start])) {
+                return start;
+            }
+        }
+        return realm::not_found;
+    }
+    void set_base_table(const Table* table) override
+    {
+        if (table && table != m_table) {
+            m_table = table;
+            m_aggregates = nullptr;
+        }
+    }
+    void verify_column() const override {}
+    const Table* get_base_table() const override { return m_table; }
+    std::unique_ptr<Expression> clone(QueryNodeHandoverPatches* patches) const override
+    {
+        if (patches) {
+            return std::unique_ptr<Expression>(new ListAggregateExpression(*this, *patches));
+        }
+        return std::unique_ptr<Expression>(new ListAggregateExpression(*this));
+    }
+    void apply_handover_patch(QueryNodeHandoverPatches& patches, Group& group) override
+    {
+        m_target_query.apply_patches(patches, group);
+        m_table = group.get_table(m_table_index).get();
+    }
+
+private:
+    const Table* m_table;
+    size_t m_table_index = realm::npos;
+    size_t m_link_column;
+    size_t m_target_column;
+    mutable Query m_target_query;
+    CollectionOperation::Type m_type;
+    NSPredicateOperatorType m_operator;
+    T m_value;
+
+    mutable std::shared_ptr<ListAggregates<T>> m_aggregates;
+
+    // The copy looks up the aggregates cached for the destination group's
+    // table once the handover is applied (see InSetExpression)
+    ListAggregateExpression(ListAggregateExpression const& other, QueryNodeHandoverPatches& patches)
+    : m_table(nullptr), m_table_index(other.m_table->get_index_in_group())
+    , m_link_column(other.m_link_column), m_target_column(other.m_target_column)
+    , m_target_query(other.m_target_query, patches, ConstSourcePayload::Copy)
+    , m_type(other.m_type), m_operator(other.m_operator), m_value(other.m_value)
+    {
+    }
+    ListAggregateExpression(ListAggregateExpression const&) = default;
+
+    bool matches(typename ListAggregates<T>::Aggregate const& aggregate) const
+    {
+        // The minimum, maximum and average of an empty list are null, which
+        // is only unequal to the value
+        switch (m_type) {
+            case CollectionOperation::Sum:
+                return compare(aggregate.sum, m_value);
+            case CollectionOperation::Minimum:
+                return aggregate.count ? compare(aggregate.min, m_value) : m_operator == NSNotEqualToPredicateOperatorType;
+            case CollectionOperation::Maximum:
+                return aggregate.count ? compare(aggregate.max, m_value) : m_operator == NSNotEqualToPredicateOperatorType;
+            case CollectionOperation::Average:
+                return aggregate.count ? compare(double(aggregate.sum) / aggregate.count, double(m_value))
+                                       : m_operator == NSNotEqualToPredicateOperatorType;
+            case CollectionOperation::Count:
+                break;
+        }
+        REALM_UNREACHABLE();
+    }
+
+    template<typename A, typename B>
+    bool compare(A a, B b) const
+    {
+        switch (m_operator) {
+            case NSLessThanPredicateOperatorType:             return a < b;
+            case NSLessThanOrEqualToPredicateOperatorType:    return a <= b;
+            case NSGreaterThanPredicateOperatorType:          return a > b;
+            case NSGreaterThanOrEqualToPredicateOperatorType: return a >= b;
+            case NSEqualToPredicateOperatorType:              return a == b;
+            case NSNotEqualToPredicateOperatorType:           return a != b;
+            default: REALM_UNREACHABLE();
+        }
+    }
+};
+
 class QueryBuilder {
 public:
     QueryBuilder(Query& query, Group& group, RLMSchema *schema)
@@ -511,6 +1605,13 @@ public:
 
     void apply_collection_operator_expression(RLMObjectSchema *desc, NSString *keyPath, id value, NSComparisonPredicate *pred);
     void apply_value_expression(RLMObjectSchema *desc, NSString *keyPath, id value, NSComparisonPredicate *pred);
+    bool add_in_set_constraint(RLMObjectSchema *desc, NSString *keyPath, const ColumnReference& column,
+                               id values, NSComparisonPredicateOptions options);
+    bool add_linked_rows_constraint(RLMObjectSchema *desc, NSString *keyPath, const ColumnReference& column,
+                                    id value, NSComparisonPredicate *pred);
+    void add_linked_rows_constraint(RLMProperty *linkList, Query targets);
+    bool add_list_aggregate_constraint(const CollectionOperation& operation, NSPredicateOperatorType operatorType,
+                                       id value, bool valueIsLeft);
     void apply_column_expression(RLMObjectSchema *desc, NSString *leftKeyPath, NSString *rightKeyPath, NSComparisonPredicate *predicate);
     void apply_subquery_count_expression(RLMObjectSchema *objectSchema, NSExpression *subqueryExpression,
                                          NSPredicateOperatorType operatorType, NSExpression *right);
@@ -550,6 +1651,8 @@ public:
     void do_add_constraint(RLMPropertyType, NSPredicateOperatorType, NSComparisonPredicateOptions, id, realm::null);
 
     void add_between_constraint(const ColumnReference& column, id value);
+    bool add_sorted_range_constraint(const ColumnReference& column, NSPredicateOperatorType operatorType,
+                                     id value, bool valueIsLeft);
 
     template<typename T>
     void add_binary_constraint(NSPredicateOperatorType operatorType, const ColumnReference& column, T value);
@@ -762,49 +1865,150 @@ void QueryBuilder::add_between_constraint(const ColumnReference& column, id valu
     m_query.end_group();
 }
 
-template<typename T>
-void QueryBuilder::add_binary_constraint(NSPredicateOperatorType operatorType,
-                                         const ColumnReference& column,
-                                         T value) {
-    RLMPrecondition(!column.has_links(), @"Unsupported operator", @"NSData properties cannot be queried over an object link.");
-
-    size_t index = column.index();
+// The operator which gives the same result when the operands of a comparison
+// are swapped
+NSPredicateOperatorType reversed_comparison(NSPredicateOperatorType operatorType) {
     switch (operatorType) {
-        case NSBeginsWithPredicateOperatorType:
-            m_query.begins_with(index, value);
-            break;
-        case NSEndsWithPredicateOperatorType:
-            m_query.ends_with(index, value);
-            break;
-        case NSContainsPredicateOperatorType:
-            m_query.contains(index, value);
-            break;
-        case NSEqualToPredicateOperatorType:
-            m_query.equal(index, value);
-            break;
-        case NSNotEqualToPredicateOperatorType:
-            m_query.not_equal(index, value);
-            break;
-        default:
-            @throw RLMPredicateException(@"Invalid operator type",
-                                         @"Operator '%@' not supported for binary type", operatorName(operatorType));
+        case NSLessThanPredicateOperatorType:             return NSGreaterThanPredicateOperatorType;
+        case NSLessThanOrEqualToPredicateOperatorType:    return NSGreaterThanOrEqualToPredicateOperatorType;
+        case NSGreaterThanPredicateOperatorType:          return NSLessThanPredicateOperatorType;
+        case NSGreaterThanOrEqualToPredicateOperatorType: return NSLessThanOrEqualToPredicateOperatorType;
+        default:                                          return operatorType;
     }
 }
 
-void QueryBuilder::add_binary_constraint(NSPredicateOperatorType operatorType, const ColumnReference& column, id value) {
-    add_binary_constraint(operatorType, column, RLMBinaryDataForNSData(value));
-}
-
-void QueryBuilder::add_binary_constraint(NSPredicateOperatorType operatorType, id value, const ColumnReference& column) {
+// Whether a comparison gives the same result with its operands swapped and the
+// operator replaced by reversed_comparison()
+bool is_reversible_comparison(NSPredicateOperatorType operatorType) {
     switch (operatorType) {
+        case NSLessThanPredicateOperatorType:
+        case NSLessThanOrEqualToPredicateOperatorType:
+        case NSGreaterThanPredicateOperatorType:
+        case NSGreaterThanOrEqualToPredicateOperatorType:
         case NSEqualToPredicateOperatorType:
         case NSNotEqualToPredicateOperatorType:
-            add_binary_constraint(operatorType, column, value);
-            break;
+            return true;
         default:
-            @throw RLMPredicateException(@"Invalid operator type",
-                                         @"Operator '%@' is not supported for binary type with key path on right side of operator",
-                                         operatorName(operatorType));
+            return false;
+    }
+}
+
+template<typename T>
+static T sorted_range_bound(id value);
+template<>
+int64_t sorted_range_bound<int64_t>(id value) { return [value longLongValue]; }
+template<>
+Timestamp sorted_range_bound<Timestamp>(id value) { return RLMTimestampForNSDate(value); }
+
+template<typename T>
+static std::unique_ptr<Expression> make_sorted_range_expression(const Table* table, size_t column,
+                                                                id lower, bool lower_inclusive,
+                                                                id upper, bool upper_inclusive) {
+    util::Optional<T> lowerBound, upperBound;
+    if (lower) {
+        lowerBound = sorted_range_bound<T>(lower);
+    }
+    if (upper) {
+        upperBound = sorted_range_bound<T>(upper);
+    }
+    return std::unique_ptr<Expression>(new SortedRangeExpression<T>(table, column, lowerBound, lower_inclusive,
+                                                                    upperBound, upper_inclusive));
+}
+
+// Range comparisons on indexed int and date properties of the queried table
+// are found by binary searching a sorted view of the table rather than by
+// comparing every row. Returns false if the comparison can't be done this way.
+bool QueryBuilder::add_sorted_range_constraint(const ColumnReference& column, NSPredicateOperatorType operatorType,
+                                               id value, bool valueIsLeft) {
+    if (column.has_links() || (column.type() != RLMPropertyTypeInt && column.type() != RLMPropertyTypeDate)) {
+        return false;
+    }
+    const Table* table = m_query.get_table().get();
+    if (!table->has_search_index(column.index())) {
+        return false;
+    }
+
+    id lower = nil, upper = nil;
+    bool lowerInclusive = false, upperInclusive = false;
+    if (operatorType == NSBetweenPredicateOperatorType) {
+        validate_and_extract_between_range(value, column.property(), &lower, &upper);
+        if (!RLMCoerceToNil(lower) || !RLMCoerceToNil(upper)) {
+            return false;
+        }
+        lowerInclusive = upperInclusive = true;
+    }
+    else {
+        if (!RLMCoerceToNil(value) || !RLMIsObjectValidForProperty(value, column.property())) {
+            return false;
+        }
+        // "value < key.path" is "key.path > value"
+        if (valueIsLeft) {
+            operatorType = reversed_comparison(operatorType);
+        }
+        switch (operatorType) {
+            case NSGreaterThanOrEqualToPredicateOperatorType: lowerInclusive = true; REALM_FALLTHROUGH;
+            case NSGreaterThanPredicateOperatorType:          lower = value; break;
+            case NSLessThanOrEqualToPredicateOperatorType:    upperInclusive = true; REALM_FALLTHROUGH;
+            case NSLessThanPredicateOperatorType:             upper = value; break;
+            default:
+                return false;
+        }
+    }
+
+    if (column.type() == RLMPropertyTypeInt) {
+        m_query.and_query(make_sorted_range_expression<int64_t>(table, column.index(), RLMCoerceToNil(lower), lowerInclusive,
+                                                                RLMCoerceToNil(upper), upperInclusive));
+    }
+    else {
+        m_query.and_query(make_sorted_range_expression<Timestamp>(table, column.index(), RLMCoerceToNil(lower), lowerInclusive,
+                                                                  RLMCoerceToNil(upper), upperInclusive));
+    }
+    return true;
+}
+
+template<typename T>
+void QueryBuilder::add_binary_constraint(NSPredicateOperatorType operatorType,
+                                         const ColumnReference& column,
+                                         T value) {
+    RLMPrecondition(!column.has_links(), @"Unsupported operator", @"NSData properties cannot be queried over an object link.");
+
+    size_t index = column.index();
+    switch (operatorType) {
+        case NSBeginsWithPredicateOperatorType:
+            m_query.begins_with(index, value);
+            break;
+        case NSEndsWithPredicateOperatorType:
+            m_query.ends_with(index, value);
+            break;
+        case NSContainsPredicateOperatorType:
+            m_query.contains(index, value);
+            break;
+        case NSEqualToPredicateOperatorType:
+            m_query.equal(index, value);
+            break;
+        case NSNotEqualToPredicateOperatorType:
+            m_query.not_equal(index, value);
+            break;
+        default:
+            @throw RLMPredicateException(@"Invalid operator type",
+                                         @"Operator '%@' not supported for binary type", operatorName(operatorType));
+    }
+}
+
+void QueryBuilder::add_binary_constraint(NSPredicateOperatorType operatorType, const ColumnReference& column, id value) {
+    add_binary_constraint(operatorType, column, RLMBinaryDataForNSData(value));
+}
+
+void QueryBuilder::add_binary_constraint(NSPredicateOperatorType operatorType, id value, const ColumnReference& column) {
+    switch (operatorType) {
+        case NSEqualToPredicateOperatorType:
+        case NSNotEqualToPredicateOperatorType:
+            add_binary_constraint(operatorType, column, value);
+            break;
+        default:
+            @throw RLMPredicateException(@"Invalid operator type",
+                                         @"Operator '%@' is not supported for binary type with key path on right side of operator",
+                                         operatorName(operatorType));
     }
 }
 
@@ -912,6 +2116,9 @@ Int convert<Int>(id value) {
 
 template <>
 String convert<String>(id value) {
+    // The constant is held by the expression being built after this returns,
+    // so it has to point into the string's own UTF-8 buffer rather than into
+    // an RLMStringDataBuffer
     return RLMStringDataWithNSString(value);
 }
 
@@ -1042,6 +2249,27 @@ KeyPath key_path_from_string(RLMSchema *schema, RLMObjectSchema *objectSchema, N
     return {std::move(links), property, keyPathContainsToManyRelationship};
 }
 
+// Whether comparisons with "ANY key.path" are evaluated as a semi-join by
+// QueryBuilder::add_linked_rows_constraint(), which is done for key paths
+// which follow a single list to a property which isn't a list
+bool is_linked_rows_key_path(const KeyPath& keyPath)
+{
+    return keyPath.links.size() == 1 && keyPath.links[0].type == RLMPropertyTypeArray
+        && keyPath.property.type != RLMPropertyTypeArray && keyPath.property.type != RLMPropertyTypeLinkingObjects;
+}
+
+// The comparison made by an "ANY list.property" predicate, comparing the
+// property of the list's target objects directly
+NSComparisonPredicate *link_target_predicate(NSString *propertyName, NSPredicateOperatorType operatorType,
+                                             NSComparisonPredicateOptions options, NSExpression *value)
+{
+    return [NSComparisonPredicate predicateWithLeftExpression:[NSExpression expressionForKeyPath:propertyName]
+                                              rightExpression:value
+                                                     modifier:NSDirectPredicateModifier
+                                                         type:operatorType
+                                                      options:options];
+}
+
 ColumnReference QueryBuilder::column_reference_from_key_path(RLMObjectSchema *objectSchema, NSString *keyPathString, bool isAggregate)
 {
     auto keyPath = key_path_from_string(m_schema, objectSchema, keyPathString);
@@ -1204,12 +2432,98 @@ CollectionOperation QueryBuilder::collection_operation_from_key_path(RLMObjectSc
     return {collectionOperationName, std::move(linkColumn), std::move(column)};
 }
 
+// Restrict a query on the target table of the list column `linkColumn` of
+// `table` to the objects which are in at least one of the lists. Besides
+// skipping targets which can't affect the lists' owners, this makes the query
+// depend on the backlinks, so that views of it are updated when the lists
+// change as well as when the targets do.
+void restrict_to_list_targets(Query& targets, const Table& table, size_t linkColumn)
+{
+    targets.and_query(targets.get_table()->column<Link>(table, linkColumn).count() > 0);
+}
+
+// Whether comparisons of @min, @max, @sum or @avg of `property` of the objects
+// in `linkList` are made by QueryBuilder::add_list_aggregate_constraint()
+bool is_list_aggregate_comparison(RLMProperty *linkList, RLMProperty *property,
+                                  NSPredicateOperatorType operatorType, id value)
+{
+    if (linkList.type != RLMPropertyTypeArray || ![value isKindOfClass:[NSNumber class]]) {
+        return false;
+    }
+    switch (property.type) {
+        case RLMPropertyTypeInt:
+        case RLMPropertyTypeFloat:
+        case RLMPropertyTypeDouble:
+            break;
+        default:
+            return false;
+    }
+    switch (operatorType) {
+        case NSLessThanPredicateOperatorType:
+        case NSLessThanOrEqualToPredicateOperatorType:
+        case NSGreaterThanPredicateOperatorType:
+        case NSGreaterThanOrEqualToPredicateOperatorType:
+        case NSEqualToPredicateOperatorType:
+        case NSNotEqualToPredicateOperatorType:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// @min, @max, @sum and @avg of a numeric property of the objects in a list of
+// the queried objects are compared with constants using aggregates computed
+// for every object at once (see ListAggregates), rather than by following the
+// list of each object. Returns false for other collection operations.
+bool QueryBuilder::add_list_aggregate_constraint(const CollectionOperation& operation,
+                                                 NSPredicateOperatorType operatorType,
+                                                 id value, bool valueIsLeft)
+{
+    const ColumnReference& linkColumn = operation.link_column();
+    if (operation.type() == CollectionOperation::Count || linkColumn.has_links()
+        || !is_list_aggregate_comparison(linkColumn.property(), operation.column().property(), operatorType, value)) {
+        return false;
+    }
+    // "value < list.@sum.property" is "list.@sum.property > value"
+    if (valueIsLeft) {
+        operatorType = reversed_comparison(operatorType);
+    }
+
+    const Table* table = m_query.get_table().get();
+    size_t targetColumn = operation.column().index();
+    Query targets = get_table(m_group, linkColumn.link_target_object_schema()).where();
+    restrict_to_list_targets(targets, *table, linkColumn.index());
+
+    std::unique_ptr<Expression> expression;
+    switch (operation.column().type()) {
+        case RLMPropertyTypeInt:
+            expression.reset(new ListAggregateExpression<int64_t>(table, linkColumn.index(), targetColumn, std::move(targets),
+                                                                  operation.type(), operatorType, convert<Int>(value)));
+            break;
+        case RLMPropertyTypeFloat:
+            expression.reset(new ListAggregateExpression<float>(table, linkColumn.index(), targetColumn, std::move(targets),
+                                                                operation.type(), operatorType, convert<Float>(value)));
+            break;
+        default:
+            expression.reset(new ListAggregateExpression<double>(table, linkColumn.index(), targetColumn, std::move(targets),
+                                                                 operation.type(), operatorType, convert<Double>(value)));
+            break;
+    }
+    m_query.and_query(std::move(expression));
+    return true;
+}
+
 void QueryBuilder::apply_collection_operator_expression(RLMObjectSchema *desc,
                                                         NSString *keyPath, id value,
                                                         NSComparisonPredicate *pred) {
     CollectionOperation operation = collection_operation_from_key_path(desc, keyPath);
     operation.validate_comparison(value);
 
+    bool valueIsLeft = pred.leftExpression.expressionType != NSKeyPathExpressionType;
+    if (add_list_aggregate_constraint(operation, pred.predicateOperatorType, value, valueIsLeft)) {
+        return;
+    }
+
     if (pred.leftExpression.expressionType == NSKeyPathExpressionType) {
         add_collection_operation_constraint(pred.predicateOperatorType, operation, operation, value);
     } else {
@@ -1217,6 +2531,159 @@ void QueryBuilder::apply_collection_operator_expression(RLMObjectSchema *desc,
     }
 }
 
+// [cd] comparisons with a property which has a folded copy (see
+// +[RLMObject foldedIndexedProperties]) can be performed as plain comparisons
+// on the folded copy instead, which is indexed. Returns whether a comparison
+// with the given operator, options and value can be rewritten this way if the
+// property has a folded copy.
+bool can_compare_folded_copy(NSPredicateOperatorType operatorType, NSComparisonPredicateOptions options, id value) {
+    if (options != (NSCaseInsensitivePredicateOption | NSDiacriticInsensitivePredicateOption)
+        || ![value isKindOfClass:[NSString class]]) {
+        return false;
+    }
+    switch (operatorType) {
+        case NSEqualToPredicateOperatorType:
+        case NSNotEqualToPredicateOperatorType:
+        case NSBeginsWithPredicateOperatorType:
+        case NSEndsWithPredicateOperatorType:
+        case NSContainsPredicateOperatorType:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Returns the predicate rewritten to compare the folded copy of its property,
+// or nil if the predicate can't be rewritten this way.
+NSComparisonPredicate *folded_copy_predicate(RLMSchema *schema, RLMObjectSchema *desc, NSString *keyPath,
+                                             id value, NSComparisonPredicate *pred) {
+    if (pred.leftExpression.expressionType != NSKeyPathExpressionType
+        || !can_compare_folded_copy(pred.predicateOperatorType, pred.options, value)) {
+        return nil;
+    }
+
+    NSString *foldedName = key_path_from_string(schema, desc, keyPath).property.foldedPropertyName;
+    if (!foldedName) {
+        return nil;
+    }
+    NSRange lastDot = [keyPath rangeOfString:@"." options:NSBackwardsSearch];
+    NSString *foldedKeyPath = lastDot.location == NSNotFound
+                            ? foldedName
+                            : [[keyPath substringToIndex:lastDot.location + 1] stringByAppendingString:foldedName];
+    return [NSComparisonPredicate predicateWithLeftExpression:[NSExpression expressionForKeyPath:foldedKeyPath]
+                                              rightExpression:[NSExpression expressionForConstantValue:RLMFoldedString(value)]
+                                                     modifier:pred.comparisonPredicateModifier
+                                                         type:pred.predicateOperatorType
+                                                      options:0];
+}
+
+bool QueryBuilder::add_in_set_constraint(RLMObjectSchema *desc, NSString *keyPath,
+                                         const ColumnReference& column, id values,
+                                         NSComparisonPredicateOptions options)
+{
+    // Only plain equality on a column of the queried table can be checked with
+    // a hash lookup. Indexed columns are left as OR groups, as core resolves
+    // each of the equality conditions using the search index.
+    if (column.has_links() || (options & (NSCaseInsensitivePredicateOption | NSDiacriticInsensitivePredicateOption))) {
+        return false;
+    }
+    if (column.type() != RLMPropertyTypeInt && column.type() != RLMPropertyTypeString) {
+        return false;
+    }
+    const Table* table = m_query.get_table().get();
+    if (table->has_search_index(column.index())) {
+        return false;
+    }
+
+    RLMPrecondition([values conformsToProtocol:@protocol(NSFastEnumeration)],
+                    @"Invalid value", @"IN clause requires an array of items");
+    NSMutableArray *normalized = [NSMutableArray new];
+    for (id item in values) {
+        id value = value_from_constant_expression_or_value(item);
+        validate_property_value(column, value,
+                                @"Expected object of type %@ in IN clause for property '%@' on object of type '%@', but received: %@", desc, keyPath);
+        [normalized addObject:value ?: NSNull.null];
+    }
+
+    std::unique_ptr<Expression> expression;
+    if (column.type() == RLMPropertyTypeInt) {
+        expression.reset(new InSetExpression<IntSet>(table, column.index(), normalized));
+    }
+    else {
+        expression.reset(new InSetExpression<StringSet>(table, column.index(), normalized));
+    }
+    m_query.and_query(std::move(expression));
+    return true;
+}
+
+// "ANY list.property" comparisons are evaluated as a semi-join rather than by
+// following every object's list: the comparison is made once on the list's
+// target table, using whatever index it has, and the matching targets are
+// mapped back to the objects whose lists contain them. Returns false if the
+// key path doesn't follow a single list.
+bool QueryBuilder::add_linked_rows_constraint(RLMObjectSchema *desc, NSString *keyPathString,
+                                              const ColumnReference& column, id value,
+                                              NSComparisonPredicate *pred)
+{
+    if (pred.comparisonPredicateModifier != NSAnyPredicateModifier) {
+        return false;
+    }
+    auto keyPath = key_path_from_string(m_schema, desc, keyPathString);
+    if (!is_linked_rows_key_path(keyPath)) {
+        return false;
+    }
+
+    // The comparison on the target table has the key path on the left, so a
+    // constant on the left, as in "5 < ANY list.x", reverses the operator.
+    // Operators which can't be reversed are left to the general path.
+    NSPredicateOperatorType operatorType = pred.predicateOperatorType;
+    if (pred.leftExpression.expressionType != NSKeyPathExpressionType) {
+        if (!is_reversible_comparison(operatorType)) {
+            return false;
+        }
+        operatorType = reversed_comparison(operatorType);
+    }
+
+    // Validate the value here so that errors name the full key path
+    switch (pred.predicateOperatorType) {
+        case NSBetweenPredicateOperatorType: {
+            id from, to;
+            validate_and_extract_between_range(value, column.property(), &from, &to);
+            break;
+        }
+        case NSInPredicateOperatorType:
+            RLMPrecondition([value conformsToProtocol:@protocol(NSFastEnumeration)],
+                            @"Invalid value", @"IN clause requires an array of items");
+            for (id item in value) {
+                validate_property_value(column, value_from_constant_expression_or_value(item),
+                                        @"Expected object of type %@ in IN clause for property '%@' on object of type '%@', but received: %@", desc, keyPathString);
+            }
+            break;
+        default:
+            validate_property_value(column, value, @"Expected object of type %@ for property '%@' on object of type '%@', but received: %@", desc, keyPathString);
+            break;
+    }
+
+    RLMObjectSchema *targetSchema = m_schema[keyPath.links[0].objectClassName];
+    NSString *propertyName = keyPath.property.name;
+    Query targets = get_table(m_group, targetSchema).where();
+    QueryBuilder(targets, m_group, m_schema).apply_value_expression(targetSchema, propertyName, value,
+                                                                    link_target_predicate(propertyName, operatorType, pred.options,
+                                                                                          [NSExpression expressionForConstantValue:value]));
+    add_linked_rows_constraint(keyPath.links[0], std::move(targets));
+    return true;
+}
+
+// Match the objects whose list `linkList` contains at least one of the
+// objects matched by `targets`
+void QueryBuilder::add_linked_rows_constraint(RLMProperty *linkList, Query targets)
+{
+    const Table* table = m_query.get_table().get();
+    size_t linkColumn = table->get_column_index(linkList.name.UTF8String);
+    restrict_to_list_targets(targets, *table, linkColumn);
+    m_query.and_query(std::unique_ptr<Expression>(new LinkedRowsExpression(table, linkColumn, std::move(targets))));
+}
+
 void QueryBuilder::apply_value_expression(RLMObjectSchema *desc,
                                           NSString *keyPath, id value,
                                           NSComparisonPredicate *pred)
@@ -1226,9 +2693,23 @@ void QueryBuilder::apply_value_expression(RLMObjectSchema *desc,
         return;
     }
 
+    if (NSComparisonPredicate *folded = folded_copy_predicate(m_schema, desc, keyPath, value, pred)) {
+        apply_value_expression(desc, folded.leftExpression.keyPath, folded.rightExpression.constantValue, folded);
+        return;
+    }
+
     bool isAny = pred.comparisonPredicateModifier == NSAnyPredicateModifier;
     ColumnReference column = column_reference_from_key_path(desc, keyPath, isAny);
 
+    if (add_linked_rows_constraint(desc, keyPath, column, value, pred)) {
+        return;
+    }
+
+    bool valueIsLeft = pred.leftExpression.expressionType != NSKeyPathExpressionType;
+    if (add_sorted_range_constraint(column, pred.predicateOperatorType, value, valueIsLeft)) {
+        return;
+    }
+
     // check to see if this is a between query
     if (pred.predicateOperatorType == NSBetweenPredicateOperatorType) {
         add_between_constraint(std::move(column), value);
@@ -1237,6 +2718,9 @@ void QueryBuilder::apply_value_expression(RLMObjectSchema *desc,
 
     // turn "key.path IN collection" into ored together ==. "collection IN key.path" is handled elsewhere.
     if (pred.predicateOperatorType == NSInPredicateOperatorType) {
+        if (add_in_set_constraint(desc, keyPath, column, value, pred.options)) {
+            return;
+        }
         process_or_group(m_query, value, [&](id item) {
             id normalized = value_from_constant_expression_or_value(item);
             validate_property_value(column, normalized,
@@ -1333,6 +2817,25 @@ void QueryBuilder::apply_subquery_count_expression(RLMObjectSchema *objectSchema
     subqueryPredicate = transformPredicate(subqueryPredicate, simplify_self_value_for_key_path_function_expression);
 
     Query subquery = RLMPredicateToQuery(subqueryPredicate, collectionMemberObjectSchema, m_schema, m_group);
+
+    // Checking whether any or none of the objects in a list match is a
+    // semi-join on the objects matching the subquery
+    if (!collectionColumn.has_links() && collectionColumn.type() == RLMPropertyTypeArray) {
+        bool any = (operatorType == NSGreaterThanPredicateOperatorType && value == 0)
+                || (operatorType == NSGreaterThanOrEqualToPredicateOperatorType && value == 1)
+                || (operatorType == NSNotEqualToPredicateOperatorType && value == 0);
+        bool none = (operatorType == NSEqualToPredicateOperatorType && value == 0)
+                 || (operatorType == NSLessThanPredicateOperatorType && value == 1)
+                 || (operatorType == NSLessThanOrEqualToPredicateOperatorType && value == 0);
+        if (any || none) {
+            if (none) {
+                m_query.Not();
+            }
+            add_linked_rows_constraint(collectionColumn.property(), std::move(subquery));
+            return;
+        }
+    }
+
     add_numeric_constraint(RLMPropertyTypeInt, operatorType,
                            collectionColumn.resolve<LinkList>(std::move(subquery)).count(), value);
 }
@@ -1360,6 +2863,193 @@ void QueryBuilder::apply_function_expression(RLMObjectSchema *objectSchema, NSEx
     }
 }
 
+// AND groups which compare each of the properties combined by a compound index
+// (see +[RLMObject compoundIndexes]) for equality with a value can instead
+// compare the index's key property with the combined values, which finds the
+// matches with a single index lookup. Returns the subpredicates of the group
+// with those comparisons replaced, or nil if no compound index applies.
+NSArray<NSPredicate *> *compound_index_subpredicates(RLMObjectSchema *desc, NSArray<NSPredicate *> *subpredicates)
+{
+    NSMutableDictionary<NSString *, NSComparisonPredicate *> *equalities = [NSMutableDictionary new];
+    NSMutableDictionary<NSString *, id> *values = [NSMutableDictionary new];
+    for (NSPredicate *subpredicate in subpredicates) {
+        if (![subpredicate isMemberOfClass:[NSComparisonPredicate class]]) {
+            continue;
+        }
+        NSComparisonPredicate *compp = (NSComparisonPredicate *)subpredicate;
+        if (compp.predicateOperatorType != NSEqualToPredicateOperatorType || compp.options
+            || compp.comparisonPredicateModifier != NSDirectPredicateModifier) {
+            continue;
+        }
+        NSExpression *keyPath = compp.leftExpression, *constant = compp.rightExpression;
+        if (keyPath.expressionType != NSKeyPathExpressionType) {
+            std::swap(keyPath, constant);
+        }
+        if (keyPath.expressionType != NSKeyPathExpressionType || constant.expressionType != NSConstantValueExpressionType) {
+            continue;
+        }
+        RLMProperty *prop = desc[keyPath.keyPath];
+        if (!prop.compoundIndexKeyNames || equalities[prop.name]
+            || !RLMIsObjectValidForProperty(constant.constantValue, prop)) {
+            continue;
+        }
+        equalities[prop.name] = compp;
+        values[prop.name] = constant.constantValue ?: NSNull.null;
+    }
+    if (equalities.count < 2) {
+        return nil;
+    }
+
+    // Use the compound index which covers the most comparisons
+    RLMProperty *key;
+    for (RLMProperty *prop in desc.properties) {
+        if (prop.compoundIndexComponents.count <= key.compoundIndexComponents.count) {
+            continue;
+        }
+        bool covered = true;
+        for (NSString *componentName in prop.compoundIndexComponents) {
+            covered = covered && equalities[componentName];
+        }
+        if (covered) {
+            key = prop;
+        }
+    }
+    if (!key) {
+        return nil;
+    }
+
+    NSMutableArray *components = [NSMutableArray arrayWithCapacity:key.compoundIndexComponents.count];
+    NSMutableArray *componentValues = [NSMutableArray arrayWithCapacity:key.compoundIndexComponents.count];
+    for (NSString *componentName in key.compoundIndexComponents) {
+        [components addObject:desc[componentName]];
+        [componentValues addObject:values[componentName]];
+    }
+    NSMutableArray *rewritten = [NSMutableArray arrayWithCapacity:subpredicates.count];
+    [rewritten addObject:[NSComparisonPredicate predicateWithLeftExpression:[NSExpression expressionForKeyPath:key.name]
+                                                            rightExpression:[NSExpression expressionForConstantValue:RLMCompoundIndexKey(components, componentValues)]
+                                                                   modifier:NSDirectPredicateModifier
+                                                                       type:NSEqualToPredicateOperatorType
+                                                                    options:0]];
+    for (NSPredicate *subpredicate in subpredicates) {
+        NSComparisonPredicate *compp = RLMDynamicCast<NSComparisonPredicate>(subpredicate);
+        NSString *name = compp.leftExpression.expressionType == NSKeyPathExpressionType
+                       ? compp.leftExpression.keyPath : compp.rightExpression.keyPath;
+        if (!compp || !name || equalities[name] != compp || ![key.compoundIndexComponents containsObject:name]) {
+            [rewritten addObject:subpredicate];
+        }
+    }
+    return rewritten;
+}
+
+// AND groups which bound both the latitude and the longitude of a geo index
+// (see +[RLMObject geoIndexes]) with constants can first find the objects whose
+// key is within the ranges covering the bounding box, using a sorted view of
+// the key, and only compare the coordinates of those objects. Returns the
+// subpredicates of the group with a comparison of the key added, or nil if no
+// geo index applies.
+NSArray<NSPredicate *> *geo_index_subpredicates(RLMObjectSchema *desc, NSArray<NSPredicate *> *subpredicates)
+{
+    // The tightest bounds of each coordinate given by BETWEEN, comparison and
+    // equality predicates
+    NSMutableDictionary<NSString *, NSNumber *> *lower = [NSMutableDictionary new];
+    NSMutableDictionary<NSString *, NSNumber *> *upper = [NSMutableDictionary new];
+    auto add_bound = [](NSMutableDictionary *bounds, NSString *name, id value, bool isLower) {
+        NSNumber *number = RLMDynamicCast<NSNumber>(value);
+        if (!number || std::isnan(number.doubleValue)) {
+            return;
+        }
+        NSNumber *current = bounds[name];
+        if (!current || (isLower ? number.doubleValue > current.doubleValue : number.doubleValue < current.doubleValue)) {
+            bounds[name] = number;
+        }
+    };
+    for (NSPredicate *subpredicate in subpredicates) {
+        if (![subpredicate isMemberOfClass:[NSComparisonPredicate class]]) {
+            continue;
+        }
+        NSComparisonPredicate *compp = (NSComparisonPredicate *)subpredicate;
+        if (compp.options || compp.comparisonPredicateModifier != NSDirectPredicateModifier) {
+            continue;
+        }
+        NSExpression *keyPath = compp.leftExpression, *constant = compp.rightExpression;
+        NSPredicateOperatorType operatorType = compp.predicateOperatorType;
+        if (keyPath.expressionType != NSKeyPathExpressionType) {
+            std::swap(keyPath, constant);
+            operatorType = reversed_comparison(operatorType);
+        }
+        if (keyPath.expressionType != NSKeyPathExpressionType || constant.expressionType != NSConstantValueExpressionType) {
+            continue;
+        }
+        RLMProperty *prop = desc[keyPath.keyPath];
+        if (prop.type != RLMPropertyTypeDouble || !prop.geoIndexKeyNames) {
+            continue;
+        }
+        id value = constant.constantValue;
+        switch (operatorType) {
+            case NSBetweenPredicateOperatorType: {
+                NSArray *array = RLMDynamicCast<NSArray>(value);
+                if (array.count == 2 && constant == compp.rightExpression) {
+                    add_bound(lower, prop.name, value_from_constant_expression_or_value(array.firstObject), true);
+                    add_bound(upper, prop.name, value_from_constant_expression_or_value(array.lastObject), false);
+                }
+                break;
+            }
+            case NSEqualToPredicateOperatorType:
+                add_bound(lower, prop.name, value, true);
+                add_bound(upper, prop.name, value, false);
+                break;
+            case NSGreaterThanPredicateOperatorType:
+            case NSGreaterThanOrEqualToPredicateOperatorType:
+                add_bound(lower, prop.name, value, true);
+                break;
+            case NSLessThanPredicateOperatorType:
+            case NSLessThanOrEqualToPredicateOperatorType:
+                add_bound(upper, prop.name, value, false);
+                break;
+            default:
+                break;
+        }
+    }
+
+    for (RLMProperty *key in desc.properties) {
+        if (!key.geoIndexCoordinateNames) {
+            continue;
+        }
+        NSString *latitude = key.geoIndexCoordinateNames[0], *longitude = key.geoIndexCoordinateNames[1];
+        if ((!lower[latitude] && !upper[latitude]) || (!lower[longitude] && !upper[longitude])) {
+            continue;
+        }
+        const uint32_t lastStep = (uint32_t(1) << RLMGeoIndexBits) - 1;
+        uint32_t minLatitude = lower[latitude] ? RLMGeoIndexStep(lower[latitude].doubleValue, -90, 90) : 0;
+        uint32_t maxLatitude = upper[latitude] ? RLMGeoIndexStep(upper[latitude].doubleValue, -90, 90) : lastStep;
+        uint32_t minLongitude = lower[longitude] ? RLMGeoIndexStep(lower[longitude].doubleValue, -180, 180) : 0;
+        uint32_t maxLongitude = upper[longitude] ? RLMGeoIndexStep(upper[longitude].doubleValue, -180, 180) : lastStep;
+        if (minLatitude > maxLatitude || minLongitude > maxLongitude) {
+            // The comparisons can't all be true, which core finds out quickly
+            return nil;
+        }
+
+        NSMutableArray *ranges = [NSMutableArray new];
+        for (auto& range : geo_index_ranges(minLatitude, maxLatitude, minLongitude, maxLongitude)) {
+            [ranges addObject:[NSComparisonPredicate predicateWithLeftExpression:[NSExpression expressionForKeyPath:key.name]
+                                                                rightExpression:[NSExpression expressionForConstantValue:@[@(range.first), @(range.second)]]
+                                                                       modifier:NSDirectPredicateModifier
+                                                                           type:NSBetweenPredicateOperatorType
+                                                                        options:0]];
+        }
+        NSPredicate *cells = ranges.count == 1 ? ranges[0] : [NSCompoundPredicate orPredicateWithSubpredicates:ranges];
+        return [@[cells] arrayByAddingObjectsFromArray:subpredicates];
+    }
+    return nil;
+}
+
+// The subpredicates of an AND group rewritten to use the compound and geo
+// indexes which apply to them, or nil if none do
+NSArray<NSPredicate *> *indexed_subpredicates(RLMObjectSchema *desc, NSArray<NSPredicate *> *subpredicates)
+{
+    NSArray *compound = compound_index_subpredicates(desc, subpredicates);
+    return geo_index_subpredicates(desc, compound ?: subpredicates) ?: compound;
+}
 
 void QueryBuilder::apply_predicate(NSPredicate *predicate, RLMObjectSchema *objectSchema)
 {
@@ -1372,7 +3062,8 @@ void QueryBuilder::apply_predicate(NSPredicate *predicate, RLMObjectSchema *obje
                 if (comp.subpredicates.count) {
                     // Add all of the subpredicates.
                     m_query.group();
-                    for (NSPredicate *subp in comp.subpredicates) {
+                    NSArray *subpredicates = indexed_subpredicates(objectSchema, comp.subpredicates) ?: comp.subpredicates;
+                    for (NSPredicate *subp in subpredicates) {
                         apply_predicate(subp, objectSchema);
                     }
                     m_query.end_group();
@@ -1479,16 +3170,20 @@ void QueryBuilder::apply_predicate(NSPredicate *predicate, RLMObjectSchema *obje
     }
 }
 
-std::vector<size_t> RLMValidatedColumnIndicesForSort(RLMClassInfo& classInfo, NSString *keyPathString)
+// `operation` and `operationName` are the verb and gerund describing what the
+// key path is used for in error messages, e.g. "sort" and "sorting"
+std::vector<size_t> RLMValidatedColumnIndices(RLMClassInfo& classInfo, NSString *keyPathString,
+                                              NSString *operation, NSString *operationName, bool collated = false)
 {
-    RLMPrecondition([keyPathString rangeOfString:@"@"].location == NSNotFound, @"Invalid key path for sort",
-                    @"Cannot sort on '%@': sorting on key paths that include collection operators is not supported.",
-                    keyPathString);
+    NSString *invalidKeyPath = [@"Invalid key path for " stringByAppendingString:operation];
+    RLMPrecondition([keyPathString rangeOfString:@"@"].location == NSNotFound, invalidKeyPath,
+                    @"Cannot %@ on '%@': %@ on key paths that include collection operators is not supported.",
+                    operation, keyPathString, operationName);
     auto keyPath = key_path_from_string(classInfo.realm.schema, classInfo.rlmObjectSchema, keyPathString);
 
-    RLMPrecondition(!keyPath.containsToManyRelationship, @"Invalid key path for sort",
-                    @"Cannot sort on '%@': sorting on key paths that include a to-many relationship is not supported.",
-                    keyPathString);
+    RLMPrecondition(!keyPath.containsToManyRelationship, invalidKeyPath,
+                    @"Cannot %@ on '%@': %@ on key paths that include a to-many relationship is not supported.",
+                    operation, keyPathString, operationName);
 
     switch (keyPath.property.type) {
         case RLMPropertyTypeBool:
@@ -1500,9 +3195,10 @@ std::vector<size_t> RLMValidatedColumnIndicesForSort(RLMClassInfo& classInfo, NS
             break;
 
         default:
-            @throw RLMPredicateException(@"Invalid sort property type",
-                                         @"Cannot sort on key path '%@' on object of type '%s': sorting is only supported on bool, date, double, float, integer, and string properties, but property is of type %@.",
-                                         keyPathString, classInfo.rlmObjectSchema.className, RLMTypeToString(keyPath.property.type));
+            @throw RLMPredicateException([NSString stringWithFormat:@"Invalid %@ property type", operation],
+                                         @"Cannot %@ on key path '%@' on object of type '%@': %@ is only supported on bool, date, double, float, integer, and string properties, but property is of type %@.",
+                                         operation, keyPathString, classInfo.rlmObjectSchema.className,
+                                         operationName, RLMTypeToString(keyPath.property.type));
     }
 
     std::vector<size_t> columnIndices;
@@ -1514,11 +3210,34 @@ std::vector<size_t> RLMValidatedColumnIndicesForSort(RLMClassInfo& classInfo, NS
         currentClassInfo = &currentClassInfo->linkTargetType(link.index);
         columnIndices.push_back(tableColumn);
     }
-    columnIndices.push_back(currentClassInfo->tableColumn(keyPath.property));
+    // Sorting a string which has a collation key sorts by the key instead
+    RLMProperty *property = keyPath.property;
+    if (collated && property.collationKeyName) {
+        property = currentClassInfo->rlmObjectSchema[property.collationKeyName];
+    }
+    columnIndices.push_back(currentClassInfo->tableColumn(property));
 
     return columnIndices;
 }
 
+// Only key paths which are valid are cached, so invalid ones throw every time
+std::vector<size_t> const& RLMValidatedColumnIndicesForSort(RLMClassInfo& classInfo, NSString *keyPathString)
+{
+    auto& cache = classInfo.sortColumnIndices;
+    auto it = cache.find(keyPathString);
+    if (it != cache.end()) {
+        return it->second;
+    }
+
+    auto columnIndices = RLMValidatedColumnIndices(classInfo, keyPathString, @"sort", @"sorting", true);
+    // Sorts use a handful of key paths in practice, so rather than evicting
+    // individual entries just start over if that isn't the case
+    if (cache.size() >= 64) {
+        cache.clear();
+    }
+    return cache.emplace([keyPathString copy], std::move(columnIndices)).first->second;
+}
+
 } // namespace
 
 realm::Query RLMPredicateToQuery(NSPredicate *predicate, RLMObjectSchema *objectSchema,
@@ -1532,6 +3251,7 @@ realm::Query RLMPredicateToQuery(NSPredicate *predicate, RLMObjectSchema *object
     }
 
     @autoreleasepool {
+        RLMSignpost signpost(RLMSignpostName::BuildQuery, [&] { return objectSchema.className; });
         QueryBuilder(query, group, schema).apply_predicate(predicate, objectSchema);
     }
 
@@ -1542,11 +3262,486 @@ realm::Query RLMPredicateToQuery(NSPredicate *predicate, RLMObjectSchema *object
     return query;
 }
 
-realm::SortDescriptor RLMSortDescriptorFromDescriptors(RLMClassInfo& classInfo, NSArray<RLMSortDescriptor *> *descriptors) {
-    std::vector<std::vector<size_t>> columnIndices;
-    std::vector<bool> ascending;
-    columnIndices.reserve(descriptors.count);
-    ascending.reserve(descriptors.count);
+namespace {
+// Append a description of `value` which is equal for two constants only if
+// they would produce the same query, returning false if queries containing
+// it can't be reused (e.g. because they reference a specific object).
+bool append_constant_key(NSMutableArray *key, id value) {
+    if (!value || value == NSNull.null) {
+        [key addObject:NSNull.null];
+        return true;
+    }
+    if ([value isKindOfClass:[NSNumber class]]) {
+        // -[NSNumber isEqual:] considers @YES, @1 and @1.0 equal, but they are
+        // not interchangeable in a query
+        [key addObject:@([value objCType])];
+        [key addObject:value];
+        return true;
+    }
+    if ([value isKindOfClass:[NSString class]] || [value isKindOfClass:[NSDate class]]
+        || [value isKindOfClass:[NSData class]]) {
+        [key addObject:[value copy]];
+        return true;
+    }
+    if ([value isKindOfClass:[NSArray class]]) {
+        [key addObject:@([value count])];
+        for (id item in value) {
+            if (!append_constant_key(key, item)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+bool append_expression_key(NSMutableArray *key, NSExpression *expression) {
+    [key addObject:@(expression.expressionType)];
+    switch (expression.expressionType) {
+        case NSKeyPathExpressionType:
+            [key addObject:expression.keyPath];
+            return true;
+        case NSConstantValueExpressionType:
+            return append_constant_key(key, expression.constantValue);
+        case NSAggregateExpressionType: {
+            NSArray *collection = expression.collection;
+            [key addObject:@(collection.count)];
+            for (NSExpression *subexpression in collection) {
+                if (![subexpression isKindOfClass:[NSExpression class]]
+                    || !append_expression_key(key, subexpression)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        default:
+            // Subqueries and functions build queries for other tables and are
+            // rare enough to not be worth caching
+            return false;
+    }
+}
+
+bool append_predicate_key(NSMutableArray *key, NSPredicate *predicate) {
+    if ([predicate isKindOfClass:[NSCompoundPredicate class]]) {
+        NSCompoundPredicate *comp = (NSCompoundPredicate *)predicate;
+        [key addObject:@"compound"];
+        [key addObject:@(comp.compoundPredicateType)];
+        [key addObject:@(comp.subpredicates.count)];
+        for (NSPredicate *subpredicate in comp.subpredicates) {
+            if (!append_predicate_key(key, subpredicate)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    if ([predicate isKindOfClass:[NSComparisonPredicate class]]) {
+        NSComparisonPredicate *compp = (NSComparisonPredicate *)predicate;
+        if (compp.predicateOperatorType == NSCustomSelectorPredicateOperatorType) {
+            return false;
+        }
+        [key addObject:@"comparison"];
+        [key addObject:@(compp.predicateOperatorType)];
+        [key addObject:@(compp.comparisonPredicateModifier)];
+        [key addObject:@(compp.options)];
+        return append_expression_key(key, compp.leftExpression)
+            && append_expression_key(key, compp.rightExpression);
+    }
+    if ([predicate isEqual:[NSPredicate predicateWithValue:YES]]) {
+        [key addObject:@"true"];
+        return true;
+    }
+    if ([predicate isEqual:[NSPredicate predicateWithValue:NO]]) {
+        [key addObject:@"false"];
+        return true;
+    }
+    return false;
+}
+
+struct ObjcHash {
+    size_t operator()(__unsafe_unretained id obj) const { return [obj hash]; }
+};
+struct ObjcEqual {
+    bool operator()(__unsafe_unretained id lhs, __unsafe_unretained id rhs) const { return [lhs isEqual:rhs]; }
+};
+} // anonymous namespace
+
+// A small LRU cache of the queries built for the predicates most recently
+// used with a single RLMClassInfo
+class RLMQueryCache {
+public:
+    static constexpr size_t capacity = 32;
+
+    Query const* find(NSArray *key) {
+        auto it = m_index.find(key);
+        if (it == m_index.end()) {
+            return nullptr;
+        }
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return &it->second->second;
+    }
+
+    void insert(NSArray *key, Query const& query) {
+        m_entries.emplace_front(key, query);
+        m_index.emplace(key, m_entries.begin());
+        if (m_entries.size() > capacity) {
+            m_index.erase(m_entries.back().first);
+            m_entries.pop_back();
+        }
+    }
+
+private:
+    std::list<std::pair<NSArray *, Query>> m_entries;
+    std::unordered_map<NSArray *, decltype(m_entries)::iterator, ObjcHash, ObjcEqual> m_index;
+};
+
+realm::Query RLMPredicateToQuery(NSPredicate *predicate, RLMClassInfo& classInfo) {
+    RLMRealm *realm = classInfo.realm;
+    if (!predicate) {
+        return RLMPredicateToQuery(predicate, classInfo.rlmObjectSchema, realm.schema, realm.group);
+    }
+
+    NSMutableArray *key = [NSMutableArray new];
+    if (!append_predicate_key(key, predicate)) {
+        return RLMPredicateToQuery(predicate, classInfo.rlmObjectSchema, realm.schema, realm.group);
+    }
+
+    if (!classInfo.queryCache) {
+        classInfo.queryCache = std::make_shared<RLMQueryCache>();
+    }
+    if (auto query = classInfo.queryCache->find(key)) {
+        return *query;
+    }
+
+    auto query = RLMPredicateToQuery(predicate, classInfo.rlmObjectSchema, realm.schema, realm.group);
+    classInfo.queryCache->insert(key, query);
+    return query;
+}
+
+realm::Query RLMTextSearchQuery(RLMClassInfo& classInfo, NSString *text, NSArray<NSString *> *propertyNames) {
+    RLMPrecondition(propertyNames.count > 0, @"Invalid properties", @"Text search requires at least one property.");
+
+    std::vector<TextSearchExpression::SearchColumn> columns;
+    columns.reserve(propertyNames.count);
+    for (NSString *propertyName in propertyNames) {
+        RLMProperty *prop = RLMValidatedProperty(classInfo.rlmObjectSchema, propertyName);
+        RLMPrecondition(prop.type == RLMPropertyTypeString, @"Invalid property type",
+                        @"Text search requires 'string' properties, but property '%@' is of type '%@'.",
+                        propertyName, RLMTypeToString(prop.type));
+        if (prop.foldedPropertyName) {
+            columns.push_back({classInfo.tableColumn(prop.foldedPropertyName), true});
+        }
+        else {
+            columns.push_back({classInfo.tableColumn(prop), false});
+        }
+    }
+
+    std::vector<std::string> words;
+    NSCharacterSet *separators = NSCharacterSet.alphanumericCharacterSet.invertedSet;
+    for (NSString *word in [RLMFoldedString(text) componentsSeparatedByCharactersInSet:separators]) {
+        if (word.length) {
+            words.push_back(word.UTF8String);
+        }
+    }
+
+    Table& table = *classInfo.table();
+    auto query = table.where();
+    if (!words.empty()) {
+        query.and_query(std::unique_ptr<Expression>(new TextSearchExpression(&table, std::move(columns), std::move(words))));
+    }
+    return query;
+}
+
+namespace {
+template<typename T>
+void add_condition_comparison(Query& query, size_t col, RLMQueryOperator op, T value) {
+    switch (op) {
+        case RLMQueryOperatorEqual:              query.equal(col, value); break;
+        case RLMQueryOperatorNotEqual:           query.not_equal(col, value); break;
+        case RLMQueryOperatorLessThan:           query.less(col, value); break;
+        case RLMQueryOperatorLessThanOrEqual:    query.less_equal(col, value); break;
+        case RLMQueryOperatorGreaterThan:        query.greater(col, value); break;
+        case RLMQueryOperatorGreaterThanOrEqual: query.greater_equal(col, value); break;
+        default: REALM_UNREACHABLE();
+    }
+}
+
+void add_condition_comparison(Query& query, size_t col, RLMQueryOperator op, StringData value, bool caseSensitive) {
+    switch (op) {
+        case RLMQueryOperatorEqual:      query.equal(col, value, caseSensitive); break;
+        case RLMQueryOperatorNotEqual:   query.not_equal(col, value, caseSensitive); break;
+        case RLMQueryOperatorBeginsWith: query.begins_with(col, value, caseSensitive); break;
+        case RLMQueryOperatorEndsWith:   query.ends_with(col, value, caseSensitive); break;
+        case RLMQueryOperatorContains:   query.contains(col, value, caseSensitive); break;
+        default: REALM_UNREACHABLE();
+    }
+}
+
+NSPredicateOperatorType predicate_operator_type(RLMQueryOperator op) {
+    switch (op) {
+        case RLMQueryOperatorEqual:              return NSEqualToPredicateOperatorType;
+        case RLMQueryOperatorNotEqual:           return NSNotEqualToPredicateOperatorType;
+        case RLMQueryOperatorLessThan:           return NSLessThanPredicateOperatorType;
+        case RLMQueryOperatorLessThanOrEqual:    return NSLessThanOrEqualToPredicateOperatorType;
+        case RLMQueryOperatorGreaterThan:        return NSGreaterThanPredicateOperatorType;
+        case RLMQueryOperatorGreaterThanOrEqual: return NSGreaterThanOrEqualToPredicateOperatorType;
+        case RLMQueryOperatorBeginsWith:         return NSBeginsWithPredicateOperatorType;
+        case RLMQueryOperatorEndsWith:           return NSEndsWithPredicateOperatorType;
+        case RLMQueryOperatorContains:           return NSContainsPredicateOperatorType;
+    }
+    REALM_UNREACHABLE();
+}
+
+void apply_condition(Query& query, RLMClassInfo& classInfo, RLMQueryCondition *condition) {
+    switch (condition.kind) {
+        case RLMQueryConditionKindAll:
+            query.group();
+            for (RLMQueryCondition *child in condition.conditions) {
+                apply_condition(query, classInfo, child);
+            }
+            query.end_group();
+            return;
+        case RLMQueryConditionKindAny:
+            if (condition.conditions.count == 0) {
+                query.and_query(std::unique_ptr<Expression>(new FalseExpression));
+                return;
+            }
+            query.group();
+            for (NSUInteger i = 0; i < condition.conditions.count; ++i) {
+                if (i > 0) {
+                    query.Or();
+                }
+                apply_condition(query, classInfo, condition.conditions[i]);
+            }
+            query.end_group();
+            return;
+        case RLMQueryConditionKindNot:
+            query.Not();
+            query.group();
+            apply_condition(query, classInfo, condition.conditions.firstObject);
+            query.end_group();
+            return;
+        case RLMQueryConditionKindComparison:
+            break;
+    }
+
+    RLMObjectSchema *objectSchema = classInfo.rlmObjectSchema;
+    RLMProperty *prop = RLMValidatedProperty(objectSchema, condition.propertyName);
+    RLMQueryOperator op = condition.queryOperator;
+    id value = condition.value;
+    bool isEquality = op == RLMQueryOperatorEqual || op == RLMQueryOperatorNotEqual;
+    bool isStringOperator = op == RLMQueryOperatorBeginsWith || op == RLMQueryOperatorEndsWith
+                         || op == RLMQueryOperatorContains;
+    RLMPrecondition(op >= RLMQueryOperatorEqual && op <= RLMQueryOperatorContains, @"Invalid operator",
+                    @"Unknown query operator %ld.", (long)op);
+
+    switch (prop.type) {
+        case RLMPropertyTypeInt:
+        case RLMPropertyTypeFloat:
+        case RLMPropertyTypeDouble:
+        case RLMPropertyTypeDate:
+            RLMPrecondition(!isStringOperator, @"Invalid operator type",
+                            @"String operators are not supported for type '%@'", RLMTypeToString(prop.type));
+            break;
+        case RLMPropertyTypeBool:
+            RLMPrecondition(isEquality, @"Invalid operator type",
+                            @"Only 'Equal' and 'Not Equal' operators supported for bool type");
+            break;
+        case RLMPropertyTypeString:
+            RLMPrecondition(isEquality || isStringOperator, @"Invalid operator type",
+                            @"Only equality and string operators are supported for string type");
+            break;
+        default:
+            @throw RLMPredicateException(@"Invalid property type",
+                                         @"Property '%@' of type '%@' cannot be compared by a query condition.",
+                                         prop.name, RLMTypeToString(prop.type));
+    }
+
+    size_t col = classInfo.tableColumn(prop);
+    if (!value || value == NSNull.null) {
+        RLMPrecondition(prop.optional && isEquality, @"Invalid value",
+                        @"Only optional properties can be compared with nil, and only for equality.");
+        if (op == RLMQueryOperatorEqual) {
+            query.equal(col, null());
+        }
+        else {
+            query.not_equal(col, null());
+        }
+        return;
+    }
+    RLMPrecondition(RLMIsObjectValidForProperty(value, prop), @"Invalid value",
+                    @"Cannot compare property '%@' of type '%@' with '%@'.",
+                    prop.name, RLMTypeToString(prop.type), value);
+    RLMPrecondition(!condition.caseInsensitive || prop.type == RLMPropertyTypeString, @"Invalid value",
+                    @"Only string properties can be compared ignoring case.");
+
+    if (condition.diacriticInsensitive) {
+        // Use the folded copy of the property where there is one, exactly as
+        // the equivalent [cd] predicate would
+        NSPredicateOperatorType operatorType = predicate_operator_type(op);
+        auto options = NSCaseInsensitivePredicateOption | NSDiacriticInsensitivePredicateOption;
+        if (prop.foldedPropertyName && can_compare_folded_copy(operatorType, options, value)) {
+            add_condition_comparison(query, classInfo.tableColumn(prop.foldedPropertyName), op,
+                                     RLMStringDataBuffer(RLMFoldedString(value)), true);
+        }
+        else {
+            QueryBuilder(query, classInfo.realm.group, classInfo.realm.schema)
+                .add_string_constraint(operatorType, options, query.get_table()->column<String>(col),
+                                       StringData(RLMStringDataBuffer(value)));
+        }
+        return;
+    }
+
+    switch (prop.type) {
+        case RLMPropertyTypeInt:
+            add_condition_comparison(query, col, op, int64_t([value longLongValue]));
+            break;
+        case RLMPropertyTypeFloat:
+            add_condition_comparison(query, col, op, [value floatValue]);
+            break;
+        case RLMPropertyTypeDouble:
+            add_condition_comparison(query, col, op, [value doubleValue]);
+            break;
+        case RLMPropertyTypeDate:
+            add_condition_comparison(query, col, op, RLMTimestampForNSDate(value));
+            break;
+        case RLMPropertyTypeBool:
+            // NOT == rather than != so that nil matches != as it does for predicates
+            if (op == RLMQueryOperatorNotEqual) {
+                query.Not();
+            }
+            query.equal(col, bool([value boolValue]));
+            break;
+        case RLMPropertyTypeString:
+            add_condition_comparison(query, col, op, RLMStringDataBuffer(value), !condition.caseInsensitive);
+            break;
+        default:
+            REALM_UNREACHABLE();
+    }
+}
+} // anonymous namespace
+
+realm::Query RLMConditionToQuery(RLMClassInfo& classInfo, RLMQueryCondition *condition) {
+    RLMPrecondition(condition, @"Invalid condition", @"The condition must not be nil.");
+    auto query = classInfo.table()->where();
+    apply_condition(query, classInfo, condition);
+
+    std::string validateMessage = query.validate();
+    RLMPrecondition(validateMessage.empty(), @"Invalid query", @"%.*s",
+                    (int)validateMessage.size(), validateMessage.c_str());
+    return query;
+}
+
+realm::Query RLMGeoRadiusQuery(RLMClassInfo& classInfo, NSString *geoIndex,
+                               double latitude, double longitude, double distance) {
+    RLMProperty *key = RLMValidatedProperty(classInfo.rlmObjectSchema, geoIndex);
+    RLMPrecondition(key.geoIndexCoordinateNames, @"Invalid property",
+                    @"Property '%@' of '%@' is not the key of a geo index.", geoIndex, classInfo.rlmObjectSchema.className);
+    RLMPrecondition(latitude >= -90 && latitude <= 90 && longitude >= -180 && longitude <= 180, @"Invalid location",
+                    @"The latitude must be within [-90, 90] and the longitude within [-180, 180].");
+    RLMPrecondition(distance >= 0, @"Invalid distance", @"The distance must not be negative.");
+
+    // The bounding box of the circle, which wraps around the antimeridian or
+    // spans all longitudes if the circle contains a pole
+    NSString *latitudeName = key.geoIndexCoordinateNames[0], *longitudeName = key.geoIndexCoordinateNames[1];
+    double angle = distance / GeoDistanceExpression::earth_radius;
+    double latitudeDelta = angle * 180 / M_PI;
+    NSArray *latitudes = @[@(std::max(-90.0, latitude - latitudeDelta)), @(std::min(90.0, latitude + latitudeDelta))];
+    NSMutableArray<NSArray *> *longitudes = [NSMutableArray new];
+    double cosLatitude = cos(latitude * M_PI / 180);
+    if (latitude + latitudeDelta >= 90 || latitude - latitudeDelta <= -90 || sin(angle) >= cosLatitude) {
+        [longitudes addObject:@[@-180.0, @180.0]];
+    }
+    else {
+        double longitudeDelta = asin(sin(angle) / cosLatitude) * 180 / M_PI;
+        double west = longitude - longitudeDelta, east = longitude + longitudeDelta;
+        if (west < -180) {
+            [longitudes addObject:@[@(west + 360), @180.0]];
+            west = -180;
+        }
+        if (east > 180) {
+            [longitudes addObject:@[@-180.0, @(east - 360)]];
+            east = 180;
+        }
+        [longitudes addObject:@[@(west), @(east)]];
+    }
+
+    NSMutableArray *boxes = [NSMutableArray arrayWithCapacity:longitudes.count];
+    for (NSArray *range in longitudes) {
+        [boxes addObject:[NSPredicate predicateWithFormat:@"%K BETWEEN %@ AND %K BETWEEN %@",
+                          latitudeName, latitudes, longitudeName, range]];
+    }
+    NSPredicate *predicate = boxes.count == 1 ? boxes[0] : [NSCompoundPredicate orPredicateWithSubpredicates:boxes];
+
+    Table& table = *classInfo.table();
+    auto query = table.where();
+    query.and_query(std::unique_ptr<Expression>(new GeoDistanceExpression(&table, classInfo.tableColumn(latitudeName),
+                                                                          classInfo.tableColumn(longitudeName),
+                                                                          latitude, longitude, distance,
+                                                                          RLMPredicateToQuery(predicate, classInfo))));
+    return query;
+}
+
+realm::Query RLMLimitedQuery(RLMClassInfo& classInfo, realm::Query query,
+                             NSArray<RLMSortDescriptor *> *descriptors, size_t limit) {
+    Table& table = *classInfo.table();
+    auto limited = table.where();
+    if (limit == 0) {
+        limited.and_query(std::unique_ptr<Expression>(new FalseExpression));
+        return limited;
+    }
+
+    std::vector<SortKeyColumn> columns;
+    for (RLMSortDescriptor *descriptor in descriptors) {
+        auto path = RLMValidatedColumnIndicesForSort(classInfo, descriptor.keyPath);
+        const Table* target = &table;
+        for (size_t i = 0; i + 1 < path.size(); ++i) {
+            target = target->get_link_target(path[i]).get();
+        }
+        DataType type = target->get_column_type(path.back());
+        columns.push_back({std::move(path), type, (bool)descriptor.ascending});
+    }
+    if (columns.empty()) {
+        columns.push_back({{}, type_Int, true});
+    }
+
+    // Keep the first `limit` keys in a max-heap, so that the last of them is
+    // always at the front and each row is compared with it only once. When
+    // there are no more than `limit` matches the cutoff is the last of them,
+    // so that the results stay limited as objects are added.
+    auto tv = query.find_all();
+    if (tv.size() == 0) {
+        limited.and_query(std::unique_ptr<Expression>(new FalseExpression));
+        return limited;
+    }
+    auto before = [&](SortKey const& a, SortKey const& b) {
+        return compare_sort_keys(columns, a, b) < 0;
+    };
+    std::vector<SortKey> heap;
+    heap.reserve(limit);
+    SortKey key;
+    for (size_t i = 0; i < tv.size(); ++i) {
+        read_sort_key(&table, columns, tv.get_source_ndx(i), key);
+        if (heap.size() < limit) {
+            heap.push_back(std::move(key));
+            std::push_heap(heap.begin(), heap.end(), before);
+        }
+        else if (before(key, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), before);
+            std::swap(heap.back(), key);
+            std::push_heap(heap.begin(), heap.end(), before);
+        }
+    }
+
+    limited.and_query(std::unique_ptr<Expression>(new SortCutoffExpression(&table, std::move(columns),
+                                                                           std::move(heap.front()))));
+    return limited;
+}
+
+realm::SortDescriptor RLMSortDescriptorFromDescriptors(RLMClassInfo& classInfo, NSArray<RLMSortDescriptor *> *descriptors) {
+    std::vector<std::vector<size_t>> columnIndices;
+    std::vector<bool> ascending;
+    columnIndices.reserve(descriptors.count);
+    ascending.reserve(descriptors.count);
 
     for (RLMSortDescriptor *descriptor in descriptors) {
         columnIndices.push_back(RLMValidatedColumnIndicesForSort(classInfo, descriptor.keyPath));
@@ -1555,3 +3750,431 @@ realm::SortDescriptor RLMSortDescriptorFromDescriptors(RLMClassInfo& classInfo,
 
     return {*classInfo.table(), std::move(columnIndices), std::move(ascending)};
 }
+
+realm::DistinctDescriptor RLMDistinctDescriptorFromKeyPaths(RLMClassInfo& classInfo, NSArray<NSString *> *keyPaths) {
+    std::vector<std::vector<size_t>> columnIndices;
+    columnIndices.reserve(keyPaths.count);
+    for (NSString *keyPath in keyPaths) {
+        columnIndices.push_back(RLMValidatedColumnIndices(classInfo, keyPath, @"distinct", @"distinct"));
+    }
+    return {*classInfo.table(), std::move(columnIndices)};
+}
+
+namespace {
+NSDictionary *explain_node(NSPredicate *predicate, RLMClassInfo& classInfo, size_t tableRows);
+
+// Whether QueryBuilder::add_sorted_range_constraint() handles the comparison
+// when the property is indexed
+bool is_sorted_range_comparison(NSComparisonPredicate *pred, RLMProperty *prop, id value) {
+    if (prop.type != RLMPropertyTypeInt && prop.type != RLMPropertyTypeDate) {
+        return false;
+    }
+    switch (pred.predicateOperatorType) {
+        case NSBetweenPredicateOperatorType:
+            // BETWEEN with a null bound falls back to comparing each row
+            if ([value isKindOfClass:[NSArray class]]) {
+                NSArray *bounds = value;
+                return bounds.count == 2 && RLMCoerceToNil(bounds[0]) && RLMCoerceToNil(bounds[1]);
+            }
+            return true;
+        case NSLessThanPredicateOperatorType:
+        case NSLessThanOrEqualToPredicateOperatorType:
+        case NSGreaterThanPredicateOperatorType:
+        case NSGreaterThanOrEqualToPredicateOperatorType:
+            return RLMCoerceToNil(value) && RLMIsObjectValidForProperty(value, prop);
+        default:
+            return false;
+    }
+}
+
+// Describe how the target objects of a semi-join on the list `linkList` are
+// found by `predicate`
+NSDictionary *explain_link_targets(RLMClassInfo& classInfo, RLMProperty *linkList, NSPredicate *predicate) {
+    RLMClassInfo& targetInfo = classInfo.realm->_info.targetOf(linkList);
+    return explain_node(predicate, targetInfo, targetInfo.table() ? targetInfo.table()->size() : 0);
+}
+
+// The target objects of "SUBQUERY(list, …).@count" comparisons which
+// QueryBuilder::apply_subquery_count_expression() evaluates as a semi-join,
+// or nil for other subqueries
+NSDictionary *explain_subquery_link_targets(NSComparisonPredicate *pred, RLMClassInfo& classInfo) {
+    NSExpression *function = pred.leftExpression, *right = pred.rightExpression;
+    if (function.expressionType != NSFunctionExpressionType || function.operand.expressionType != NSSubqueryExpressionType
+        || right.expressionType != NSConstantValueExpressionType || ![right.constantValue isKindOfClass:[NSNumber class]]) {
+        return nil;
+    }
+    NSExpression *subquery = function.operand;
+    if (subquery.collection.expressionType != NSKeyPathExpressionType) {
+        return nil;
+    }
+    RLMProperty *linkList = classInfo.rlmObjectSchema[subquery.collection.keyPath];
+    if (linkList.type != RLMPropertyTypeArray) {
+        return nil;
+    }
+
+    int64_t value = [right.constantValue longLongValue];
+    switch (pred.predicateOperatorType) {
+        case NSGreaterThanPredicateOperatorType:
+        case NSNotEqualToPredicateOperatorType:
+        case NSEqualToPredicateOperatorType:
+        case NSLessThanOrEqualToPredicateOperatorType:
+            if (value != 0) {
+                return nil;
+            }
+            break;
+        case NSGreaterThanOrEqualToPredicateOperatorType:
+        case NSLessThanPredicateOperatorType:
+            if (value != 1) {
+                return nil;
+            }
+            break;
+        default:
+            return nil;
+    }
+
+    NSPredicate *predicate = [subquery.predicate predicateWithSubstitutionVariables:@{subquery.variable: [NSExpression expressionForEvaluatedObject]}];
+    predicate = transformPredicate(predicate, simplify_self_value_for_key_path_function_expression);
+    return explain_link_targets(classInfo, linkList, predicate);
+}
+
+// Describe how a single comparison is evaluated, mirroring the choices made
+// by QueryBuilder::apply_predicate()
+NSDictionary *explain_comparison(NSComparisonPredicate *pred, RLMClassInfo& classInfo, size_t tableRows) {
+    NSMutableDictionary *node = [@{@"type": @"comparison",
+                                   @"predicate": pred.predicateFormat} mutableCopy];
+    NSExpression *left = pred.leftExpression, *right = pred.rightExpression;
+    NSString *strategy = @"scan";
+    size_t estimate = tableRows;
+
+    NSExpression *keyPathExpression = left.expressionType == NSKeyPathExpressionType ? left
+                                    : right.expressionType == NSKeyPathExpressionType ? right : nil;
+    bool isColumnComparison = left.expressionType == NSKeyPathExpressionType
+                           && right.expressionType == NSKeyPathExpressionType;
+
+    if (left.expressionType == NSFunctionExpressionType || left.expressionType == NSSubqueryExpressionType) {
+        strategy = @"subquery";
+        if (NSDictionary *targets = explain_subquery_link_targets(pred, classInfo)) {
+            strategy = @"semiJoin";
+            node[@"targets"] = targets;
+            estimate = [targets[@"estimatedRowsScanned"] unsignedLongLongValue];
+        }
+    }
+    else if (!keyPathExpression) {
+        strategy = @"constant";
+    }
+    else if (isColumnComparison) {
+        node[@"keyPath"] = left.keyPath;
+        strategy = key_path_contains_collection_operator(left.keyPath)
+                || key_path_contains_collection_operator(right.keyPath)
+                 ? @"collectionOperator" : @"columnComparison";
+    }
+    else if (key_path_contains_collection_operator(keyPathExpression.keyPath)) {
+        node[@"keyPath"] = keyPathExpression.keyPath;
+        strategy = @"collectionOperator";
+
+        NSString *leadingKeyPath, *trailingKey;
+        NSString *operation = get_collection_operation_name_from_key_path(keyPathExpression.keyPath,
+                                                                          &leadingKeyPath, &trailingKey);
+        NSExpression *valueExpression = keyPathExpression == left ? right : left;
+        if (trailingKey && ![operation isEqualToString:@"@count"]
+            && valueExpression.expressionType == NSConstantValueExpressionType) {
+            RLMProperty *linkList = classInfo.rlmObjectSchema[leadingKeyPath];
+            RLMProperty *property = linkList.type == RLMPropertyTypeArray
+                                  ? classInfo.realm.schema[linkList.objectClassName][trailingKey] : nil;
+            if (property && is_list_aggregate_comparison(linkList, property, pred.predicateOperatorType,
+                                                         valueExpression.constantValue)) {
+                // Each object's aggregate is read from ones computed for all
+                // of the objects by a single pass over the list's targets
+                strategy = @"listAggregate";
+            }
+        }
+    }
+    else {
+        NSString *keyPathString = keyPathExpression.keyPath;
+        NSExpression *valueExpression = keyPathExpression == left ? right : left;
+        id value = valueExpression.expressionType == NSConstantValueExpressionType ? valueExpression.constantValue : nil;
+        node[@"keyPath"] = keyPathString;
+
+        // "key.path IN %@" is evaluated as equality with each of the values
+        bool isIn = pred.predicateOperatorType == NSInPredicateOperatorType && keyPathExpression == left;
+        bool isEquality = pred.predicateOperatorType == NSEqualToPredicateOperatorType || isIn;
+        NSComparisonPredicate *folded = folded_copy_predicate(classInfo.realm.schema, classInfo.rlmObjectSchema,
+                                                              keyPathString, value, pred);
+        if (folded) {
+            keyPathString = folded.leftExpression.keyPath;
+            node[@"foldedKeyPath"] = keyPathString;
+        }
+
+        auto keyPath = key_path_from_string(classInfo.realm.schema, classInfo.rlmObjectSchema, keyPathString);
+        bool isIndexed = false;
+        if (keyPath.links.empty() && !keyPath.containsToManyRelationship) {
+            isIndexed = classInfo.table()->has_search_index(classInfo.tableColumn(keyPath.property));
+        }
+        node[@"indexed"] = @(isIndexed);
+
+        // "%@ IN list.property" is evaluated as "ANY list.property == %@"
+        bool isContainedIn = pred.predicateOperatorType == NSInPredicateOperatorType && keyPathExpression == right;
+        bool isReversed = keyPathExpression == right && !isContainedIn;
+        if ((pred.comparisonPredicateModifier == NSAnyPredicateModifier || isContainedIn) && is_linked_rows_key_path(keyPath)
+            && (!isReversed || is_reversible_comparison(pred.predicateOperatorType))) {
+            // The comparison is made on the list's target objects, and each
+            // match is mapped back through its backlinks
+            strategy = @"semiJoin";
+            NSComparisonPredicate *targetPredicate = folded ?: pred;
+            auto targets = explain_link_targets(classInfo, keyPath.links[0],
+                                                link_target_predicate(keyPath.property.name,
+                                                                      isContainedIn ? NSEqualToPredicateOperatorType
+                                                                      : isReversed ? reversed_comparison(pred.predicateOperatorType)
+                                                                      : targetPredicate.predicateOperatorType,
+                                                                      targetPredicate.options,
+                                                                      folded ? folded.rightExpression : valueExpression));
+            node[@"targets"] = targets;
+            estimate = [targets[@"estimatedRowsScanned"] unsignedLongLongValue];
+        }
+        else if (!keyPath.links.empty() || keyPath.containsToManyRelationship) {
+            strategy = keyPath.containsToManyRelationship ? @"toManyLinkTraversal" : @"linkTraversal";
+        }
+        else if (isIndexed && isEquality && (folded || pred.options == 0)) {
+            // Indexed equality only visits the rows with a matching value, so
+            // the number of matches is the number of rows looked at
+            strategy = folded ? @"foldedIndex" : keyPath.property.compoundIndexComponents ? @"compoundIndex" : @"index";
+            estimate = RLMPredicateToQuery(folded ?: pred, classInfo).count();
+        }
+        else if (isIndexed && is_sorted_range_comparison(pred, keyPath.property, value)) {
+            // Range comparisons on indexed int and date properties binary
+            // search a sorted view, and so only look at the matching rows
+            strategy = keyPath.property.geoIndexCoordinateNames ? @"geoIndex" : @"sortedRange";
+            estimate = RLMPredicateToQuery(pred, classInfo).count();
+        }
+        else if (isIn && pred.options == 0 && !isIndexed
+                 && (keyPath.property.type == RLMPropertyTypeInt || keyPath.property.type == RLMPropertyTypeString)) {
+            strategy = @"inSet";
+        }
+        else if (folded) {
+            strategy = @"foldedScan";
+        }
+    }
+
+    node[@"strategy"] = strategy;
+    node[@"estimatedRowsScanned"] = @(estimate);
+    return node;
+}
+
+NSDictionary *explain_compound(NSCompoundPredicate *comp, RLMClassInfo& classInfo, size_t tableRows) {
+    NSMutableArray *children = [NSMutableArray arrayWithCapacity:comp.subpredicates.count];
+    size_t estimate = 0;
+    NSString *type;
+    switch (comp.compoundPredicateType) {
+        case NSAndPredicateType:
+            // Core evaluates the cheapest condition of an AND group first and
+            // only checks the others against the rows it matches
+            type = @"and";
+            estimate = tableRows;
+            for (NSPredicate *subpredicate in indexed_subpredicates(classInfo.rlmObjectSchema, comp.subpredicates) ?: comp.subpredicates) {
+                NSDictionary *child = explain_node(subpredicate, classInfo, tableRows);
+                estimate = std::min<size_t>(estimate, [child[@"estimatedRowsScanned"] unsignedLongLongValue]);
+                [children addObject:child];
+            }
+            break;
+        case NSOrPredicateType:
+            type = @"or";
+            for (NSPredicate *subpredicate in comp.subpredicates) {
+                NSDictionary *child = explain_node(subpredicate, classInfo, tableRows);
+                estimate += [child[@"estimatedRowsScanned"] unsignedLongLongValue];
+                [children addObject:child];
+            }
+            estimate = std::min(estimate, tableRows);
+            break;
+        default:
+            type = @"not";
+            estimate = tableRows;
+            for (NSPredicate *subpredicate in comp.subpredicates) {
+                [children addObject:explain_node(subpredicate, classInfo, tableRows)];
+            }
+            break;
+    }
+    return @{@"type": type,
+             @"children": children,
+             @"estimatedRowsScanned": @(estimate)};
+}
+
+NSDictionary *explain_node(NSPredicate *predicate, RLMClassInfo& classInfo, size_t tableRows) {
+    if ([predicate isMemberOfClass:[NSCompoundPredicate class]]) {
+        return explain_compound((NSCompoundPredicate *)predicate, classInfo, tableRows);
+    }
+    if ([predicate isMemberOfClass:[NSComparisonPredicate class]]) {
+        return explain_comparison((NSComparisonPredicate *)predicate, classInfo, tableRows);
+    }
+    bool value = [predicate isEqual:[NSPredicate predicateWithValue:YES]];
+    return @{@"type": value ? @"true" : @"false",
+             @"strategy": @"constant",
+             @"estimatedRowsScanned": @(value ? tableRows : 0)};
+}
+} // anonymous namespace
+
+NSDictionary *RLMExplainPredicate(NSPredicate *predicate, RLMClassInfo& classInfo) {
+    size_t tableRows = classInfo.table() ? classInfo.table()->size() : 0;
+    return explain_node(predicate, classInfo, tableRows);
+}
+
+namespace {
+// The rows stored for -[RLMResults materializeWithName:error:] are kept in a
+// table which isn't part of the schema, along with the version of the Realm
+// file they were stored at. Every commit to the file, from any process,
+// produces a new version, so the rows are used only until the data next
+// changes and nothing has to be written to invalidate them.
+const char *const c_materializedTableName = "materialized_results";
+enum MaterializedColumn : size_t {
+    MaterializedNameColumn,
+    MaterializedKeyColumn,
+    MaterializedVersionColumn,
+    MaterializedRowsColumn,
+};
+
+// Matches the stored rows of a materialized query until the table changes,
+// and the rows the query itself matches once it has. The changes are tracked
+// through the version of an empty view of the table, which is bumped by
+// changes to the table and to the tables it links to (as in
+// LinkedRowsExpression).
+class MaterializedRowsExpression : public realm::Expression {
+public:
+    MaterializedRowsExpression(const Table* table, std::shared_ptr<const std::vector<size_t>> rows, Query source)
+    : m_table(table), m_rows(std::move(rows)), m_source(std::move(source))
+    {
+        track_changes();
+    }
+
+    size_t find_first(size_t start, size_t end) const override
+    {
+        if (m_rows && m_changes.sync_if_needed() != m_changes_version) {
+            m_rows = nullptr;
+        }
+        if (m_rows) {
+            auto it = std::lower_bound(m_rows->begin(), m_rows->end(), start);
+            return it != m_rows->end() && *it < end ? *it : realm::not_found;
+        }
+        TableView tv = m_source.find_all(start, end, 1);
+        return tv.size() ? tv.get_source_ndx(0) : realm::not_found;
+    }
+    void set_base_table(const Table* table) override
+    {
+        if (table && table != m_table) {
+            m_table = table;
+            track_changes();
+        }
+    }
+    void verify_column() const override {}
+    const Table* get_base_table() const override { return m_table; }
+    std::unique_ptr<Expression> clone(QueryNodeHandoverPatches* patches) const override
+    {
+        if (patches) {
+            return std::unique_ptr<Expression>(new MaterializedRowsExpression(*this, *patches));
+        }
+        return std::unique_ptr<Expression>(new MaterializedRowsExpression(*this));
+    }
+    void apply_handover_patch(QueryNodeHandoverPatches& patches, Group& group) override
+    {
+        m_source.apply_patches(patches, group);
+        // The destination group is at the version the query was handed over
+        // at, so changes are tracked from there
+        m_table = group.get_table(m_table_index).get();
+        track_changes();
+    }
+
+private:
+    const Table* m_table;
+    size_t m_table_index = realm::npos;
+    mutable std::shared_ptr<const std::vector<size_t>> m_rows;
+    mutable Query m_source;
+
+    mutable TableView m_changes;
+    uint_fast64_t m_changes_version = 0;
+
+    // The stored rows are handed over only if they're still valid at the
+    // version the query is handed over at
+    MaterializedRowsExpression(MaterializedRowsExpression const& other, QueryNodeHandoverPatches& patches)
+    : m_table(nullptr), m_table_index(other.m_table->get_index_in_group())
+    , m_rows(other.m_rows && other.m_changes.sync_if_needed() == other.m_changes_version ? other.m_rows : nullptr)
+    , m_source(other.m_source, patches, ConstSourcePayload::Copy)
+    {
+    }
+    MaterializedRowsExpression(MaterializedRowsExpression const&) = default;
+
+    void track_changes()
+    {
+        m_changes = m_table->where().find_all(0, realm::npos, 0);
+        m_changes_version = m_changes.sync_if_needed();
+    }
+};
+} // anonymous namespace
+
+bool RLMStoredMaterializedQuery(RLMClassInfo& classInfo, realm::Query const& source,
+                                NSString *name, NSString *key, uint64_t version, realm::Query& query) {
+    Group& group = classInfo.realm.group;
+    TableRef table = group.get_table(c_materializedTableName);
+    if (!table || !classInfo.table()) {
+        return false;
+    }
+
+    size_t row = table->find_first_string(MaterializedNameColumn, RLMStringDataBuffer(name));
+    if (row == realm::not_found || uint64_t(table->get_int(MaterializedVersionColumn, row)) != version
+        || table->get_string(MaterializedKeyColumn, row) != StringData(RLMStringDataBuffer(key))) {
+        return false;
+    }
+
+    BinaryData data = table->get_binary(MaterializedRowsColumn, row);
+    std::vector<uint64_t> stored(data.size() / sizeof(uint64_t));
+    memcpy(stored.data(), data.data(), stored.size() * sizeof(uint64_t));
+    auto rows = std::make_shared<std::vector<size_t>>(stored.begin(), stored.end());
+
+    query = classInfo.table()->where();
+    query.and_query(std::unique_ptr<Expression>(new MaterializedRowsExpression(classInfo.table(), std::move(rows),
+                                                                               source)));
+    return true;
+}
+
+void RLMStoreMaterializedQuery(RLMClassInfo& classInfo, realm::Query source, NSString *name, NSString *key,
+                               uint64_t version) {
+    Group& group = classInfo.realm.group;
+    TableRef table = group.get_or_add_table(c_materializedTableName);
+    if (table->get_column_count() == 0) {
+        table->add_column(type_String, "name");
+        table->add_column(type_String, "key");
+        table->add_column(type_Int, "version");
+        table->add_column(type_Binary, "rows");
+        table->add_search_index(MaterializedNameColumn);
+    }
+
+    // Nothing but the stored rows changes in the transaction, so the rows
+    // stored for other queries at the version it began at remain valid
+    for (size_t i = 0, size = table->size(); i < size; ++i) {
+        if (uint64_t(table->get_int(MaterializedVersionColumn, i)) + 1 == version) {
+            table->set_int(MaterializedVersionColumn, i, int64_t(version));
+        }
+    }
+
+    size_t row = table->find_first_string(MaterializedNameColumn, RLMStringDataBuffer(name));
+    if (row == realm::not_found) {
+        row = table->add_empty_row();
+        table->set_string(MaterializedNameColumn, row, RLMStringDataBuffer(name));
+    }
+
+    TableView view = source.find_all();
+    std::vector<uint64_t> rows;
+    rows.reserve(view.size());
+    for (size_t i = 0; i < view.size(); ++i) {
+        rows.push_back(view.get_source_ndx(i));
+    }
+    std::sort(rows.begin(), rows.end());
+    if (rows.size() * sizeof(uint64_t) > Table::max_binary_size) {
+        // Too many rows to store, so the query is evaluated as usual
+        table->move_last_over(row);
+        return;
+    }
+
+    table->set_string(MaterializedKeyColumn, row, RLMStringDataBuffer(key));
+    table->set_int(MaterializedVersionColumn, row, int64_t(version));
+    table->set_binary(MaterializedRowsColumn, row,
+                      BinaryData(reinterpret_cast<const char *>(rows.data()), rows.size() * sizeof(uint64_t)));
+}
+}
@@ -20,6 +20,7 @@
 #import "RLMConstants.h"
 
 @class RLMRealmConfiguration, RLMRealm, RLMObject, RLMSchema, RLMMigration, RLMNotificationToken, RLMThreadSafeReference;
+@class RLMRealmVersion, RLMObjectChanges, RLMResults;
 
 /**
  A callback block for opening Realms asynchronously.
@@ -28,6 +29,16 @@
  */
 typedef void(^RLMAsyncOpenRealmCallback)(RLMRealm * _Nullable realm, NSError * _Nullable error);
 
+/**
+ A callback block for prewarming Realms.
+
+ Returns the Realm and the prewarmed results in it if the Realm was opened
+ successfully, or an error otherwise.
+ */
+typedef void(^RLMPrewarmRealmCallback)(RLMRealm * _Nullable realm,
+                                       NSArray<RLMResults *> * _Nullable results,
+                                       NSError * _Nullable error);
+
 NS_ASSUME_NONNULL_BEGIN
 
 /**
@@ -88,6 +99,35 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (nullable instancetype)realmWithConfiguration:(RLMRealmConfiguration *)configuration error:(NSError **)error;
 
+/**
+ Opens a Realm with the given configuration, passes it to the block, and then
+ releases it before returning.
+
+ Realms returned by `+realmWithConfiguration:error:` are autoreleased, so code
+ which opens a Realm in each iteration of a loop without its own autorelease
+ pool keeps every instance, its read transaction and its file mappings alive
+ until the enclosing pool drains, which can cause the file to grow as old
+ versions can't be reclaimed. This method opens the Realm inside an
+ autorelease pool which is drained before it returns, and if the Realm was not
+ already open on this thread, invalidates it when the block returns so that
+ its read transaction is released even if objects from it are still retained.
+ Objects and collections obtained inside the block should not be used after
+ it returns.
+
+ If the block leaves a write transaction open, the transaction is cancelled.
+
+ @param configuration A configuration object to use when opening the Realm.
+ @param error         If the Realm could not be opened, upon return contains
+                      an `NSError` object that describes the problem. If you
+                      are not interested in possible errors, pass in `NULL`.
+ @param block         The block to call with the Realm.
+
+ @return Whether the Realm was opened and the block was called.
+ */
++ (BOOL)performWithConfiguration:(RLMRealmConfiguration *)configuration
+                           error:(NSError **)error
+                           block:(NS_NOESCAPE void (^)(RLMRealm *realm))block;
+
 /**
  Obtains an `RLMRealm` instance persisted at a specified file URL.
 
@@ -117,11 +157,80 @@ NS_ASSUME_NONNULL_BEGIN
        Because GCD does not guarantee that queues will always use the same
        thread, accessing the returned Realm outside the callback block (even if
        accessed from `callbackQueue`) is unsafe.
+
+ @note The sessions of all open synchronized Realms download at the same time
+       and share the available bandwidth. If the user is waiting on a small
+       Realm, open it before opening large Realms which aren't needed
+       immediately, rather than opening them all at launch.
+ */
++ (void)asyncOpenWithConfiguration:(RLMRealmConfiguration *)configuration
+                     callbackQueue:(dispatch_queue_t)callbackQueue
+                          callback:(RLMAsyncOpenRealmCallback)callback;
+
+/**
+ Asynchronously open a Realm and deliver it to a block on the given queue as
+ soon as part of its remote content is available.
+
+ This behaves like `+asyncOpenWithConfiguration:callbackQueue:callback:`,
+ except that a synchronized Realm is delivered once at least
+ `initialDownloadSize` bytes of its content have been downloaded, or once all
+ remote content has been downloaded if that comes first. The rest of the
+ content continues to download in the background, and the usual notifications
+ are sent as it is integrated. This lets an app show the first content of a
+ large Realm without waiting for all of it.
+
+ @param configuration       A configuration object to use when opening the Realm.
+ @param initialDownloadSize The number of downloaded bytes after which the
+                            Realm is delivered. Passing 0 waits for all remote
+                            content, as `+asyncOpenWithConfiguration:callbackQueue:callback:`
+                            does. Ignored for Realms which aren't synchronized.
+ @param callbackQueue       The dispatch queue on which the callback should be run.
+ @param callback            A callback block. If the Realm was successfully
+                            opened, it will be passed in as an argument.
+                            Otherwise, an `NSError` describing what went wrong
+                            will be passed to the block instead.
  */
 + (void)asyncOpenWithConfiguration:(RLMRealmConfiguration *)configuration
+               initialDownloadSize:(NSUInteger)initialDownloadSize
                      callbackQueue:(dispatch_queue_t)callbackQueue
                           callback:(RLMAsyncOpenRealmCallback)callback;
 
+/**
+ Open a Realm and evaluate the queries needed to display its first content on
+ a background queue, then deliver the Realm and the results of the queries to
+ a block on the main queue.
+
+ Displaying the first content of a Realm on launch opens the file, initializes
+ its schema, evaluates the queries of the displayed results and reads the
+ parts of the file their objects are stored in, which can mostly be waiting on
+ the file to be read if it isn't in the operating system's cache. Prewarming
+ the Realm does all of that work on a background queue: the `queries` block is
+ called there with a Realm opened on that queue, and each of the results it
+ returns is evaluated and every property of its objects is read, as
+ `-[RLMResults prefetchOnQueue:completion:]` does. The results are then handed
+ over to a Realm opened on the main queue, which reuses the schema from the
+ background Realm, and passed to `completion` in the same order.
+
+ Unlike `+asyncOpenWithConfiguration:callbackQueue:callback:`, prewarming a
+ synchronized Realm does not wait for its remote content to be downloaded.
+
+ @param configuration A configuration object to use when opening the Realm.
+ @param queries       A block called on a background queue with the Realm
+                      opened there, which returns the results to prewarm. All
+                      of them must be results of objects in that Realm.
+ @param completion    A block called on the main queue with the Realm and the
+                      prewarmed results, or with an `NSError` describing what
+                      went wrong if the Realm couldn't be opened, or the
+                      `queries` block threw an exception or returned anything
+                      other than results in the Realm passed to it.
+
+ @note The Realm and results passed to `completion` are confined to the main
+       thread.
+ */
++ (void)prewarmWithConfiguration:(RLMRealmConfiguration *)configuration
+                         queries:(NSArray<RLMResults *> *(^)(RLMRealm *realm))queries
+                      completion:(RLMPrewarmRealmCallback)completion;
+
 /**
  The `RLMSchema` used by the Realm.
  */
@@ -186,6 +295,86 @@ typedef void (^RLMNotificationBlock)(RLMNotification notification, RLMRealm *rea
  */
 - (RLMNotificationToken *)addNotificationBlock:(RLMNotificationBlock)block __attribute__((warn_unused_result));
 
+#pragma mark - Suspending Collection Notifications
+
+/**
+ Suspends the change notifications of the collections in this Realm until `-resumeCollectionNotifications` is called.
+
+ While suspended, the change sets of the `RLMResults` and `RLMArray` notification blocks added on this Realm are not
+ computed in the background at all, which avoids the work of keeping track of changes for a UI which isn't shown.
+ When notifications are resumed, each block is called once with a `nil` change, as it is when it's first added, so
+ that it reloads the collection as a whole rather than being sent the changes made in each intermediate version.
+
+ Notification blocks added while notifications are suspended are first called after they're resumed. Notifications of
+ objects and of the Realm itself are not suspended. Calling this method when notifications are already suspended does
+ nothing.
+ */
+- (void)suspendCollectionNotifications;
+
+/**
+ Resumes the collection notifications suspended by `-suspendCollectionNotifications`.
+
+ Calling this method when notifications aren't suspended does nothing.
+ */
+- (void)resumeCollectionNotifications;
+
+/**
+ Whether the collection notifications of this Realm are suspended while the app is in the background.
+
+ When `YES`, the notifications are suspended as with `-suspendCollectionNotifications` when the app enters the
+ background on iOS and tvOS, and resumed when it returns to the foreground. Setting this property back to `NO` resumes
+ notifications if they're suspended. As the app's lifecycle notifications are posted on the main thread, this may only
+ be set to `YES` on Realms confined to the main thread.
+
+ The default value is `NO`.
+ */
+@property (nonatomic) BOOL suspendsCollectionNotificationsInBackground;
+
+#pragma mark - Measuring Notification Delivery
+
+/**
+ The stages of delivering notifications on a thread which are timed by the
+ block set with `+[RLMRealm setNotificationTimingBlock:]`.
+ */
+typedef NS_ENUM(NSInteger, RLMNotificationStage) {
+    /// Advancing the Realm to the new version, including handing over the
+    /// results computed by the background notifier.
+    RLMNotificationStageRefresh,
+    /// Sending the key-value observing notifications for observed objects.
+    RLMNotificationStageKVO,
+    /// Calling the blocks added with `-[RLMRealm addNotificationBlock:]`.
+    RLMNotificationStageRealmBlocks,
+    /// Calling a block added to an `RLMResults` or `RLMArray`.
+    RLMNotificationStageCollectionBlock,
+    /// Calling a block added with `-[RLMObject addNotificationBlock:]`.
+    RLMNotificationStageObjectBlock,
+};
+
+/**
+ The type of a block which is called with the time spent in a stage of
+ delivering notifications.
+
+ @see `+[RLMRealm setNotificationTimingBlock:]`
+ */
+typedef void (^RLMNotificationTimingBlock)(RLMNotificationStage stage, NSString *realmPath, NSTimeInterval duration);
+
+/**
+ Sets a block to be called with the time spent in each stage of delivering
+ notifications, or `nil` to stop timing them.
+
+ The block is called synchronously on the thread which the notifications are
+ being delivered on, immediately after the stage is over, and so should do as
+ little work as possible. The same stages are also reported as `os_signpost`
+ intervals in the "io.realm" subsystem's "Notifications" category when
+ signposts are supported and enabled, regardless of whether a block is set.
+
+ The time spent computing changes on the background notifier thread is not
+ included in any of the stages.
+
+ @param block The block to call with the timings.
+ */
++ (void)setNotificationTimingBlock:(nullable RLMNotificationTimingBlock)block;
+
 #pragma mark - Transactions
 
 
@@ -213,6 +402,103 @@ typedef void (^RLMNotificationBlock)(RLMNotification notification, RLMRealm *rea
  */
 - (void)beginWriteTransaction;
 
+/**
+ Begins a write transaction on the Realm in which changes to objects are not
+ reported to their key-value observers as they are made.
+
+ Every setter and array mutation in a normal write transaction checks whether
+ the object is being observed and, if it is, sends it individual will-change
+ and did-change notifications. For large imports whose results only need to
+ appear as a whole, this skips that work: instead, when the transaction is
+ committed, every observed object managed by this Realm is sent a single
+ notification for each of its properties. These notifications do not include
+ meaningful old values. Deleting an observed object still notifies its
+ observers immediately, as the object is invalidated.
+
+ Other `RLMRealm` instances, and notification blocks on this Realm, see the
+ changes in the usual way.
+ */
+- (void)beginBulkWriteTransaction;
+
+/**
+ Begins a write transaction on the Realm, waiting at most `timeout` seconds for
+ other write transactions to release the write lock.
+
+ Only one write transaction can be open at a time on a Realm file, across all
+ threads and processes, and `beginWriteTransaction` waits for as long as
+ another one is in progress. This method instead gives up and reports an
+ `RLMErrorWriteLockTimeout` error, whose description names the thread holding
+ the lock if it is in this process, so that for example the main thread can
+ avoid hanging while an app extension performs a large import.
+
+ @warning The timeout only applies to waiting for the write transactions which
+          are in progress while this method waits. The lock is then acquired
+          in the same way as by `beginWriteTransaction`, so a write
+          transaction which another thread or process begins in the instant
+          between the lock being released and this method acquiring it makes
+          this method wait until that transaction is committed or cancelled,
+          however long that takes.
+
+ @param timeout The maximum number of seconds to wait for the write lock.
+ @param error   If the write lock could not be acquired in time, upon return
+                contains an `NSError` object that describes the problem. If
+                you are not interested in possible errors, pass in `NULL`.
+
+ @return Whether the write transaction was begun.
+ */
+- (BOOL)beginWriteTransactionWithTimeout:(NSTimeInterval)timeout error:(NSError **)error;
+
+/**
+ Returns statistics about the write transactions performed by this process, for
+ diagnosing contention for the write lock.
+
+ The returned dictionary contains the following keys:
+
+ - `waits`: how long `beginWriteTransaction` took to acquire the write lock,
+   including advancing to the latest version of the Realm.
+ - `holds`: how long write transactions were held open, from acquiring the
+   write lock until the transaction was committed or cancelled.
+ - `timeouts`: the number of times `beginWriteTransactionWithTimeout:error:`
+   gave up.
+ - `holders`: the write transactions currently in progress in this process,
+   keyed by Realm file path, each a dictionary with the `thread` holding it
+   and the `heldTime` in seconds so far.
+
+ `waits` and `holds` are dictionaries with the `count` of transactions, their
+ `totalTime` and `maxTime` in seconds, and a `histogram` of counts for
+ durations under 1 millisecond, 10 milliseconds, 100 milliseconds, 1 second,
+ and longer.
+ */
++ (NSDictionary<NSString *, id> *)writeLockStatistics;
+
+/**
+ How much `+releaseCachedResourcesWithLevel:` releases.
+ */
+typedef NS_ENUM(NSUInteger, RLMCacheReleaseLevel) {
+    /// Release the caches which Realms keep to speed up repeated queries,
+    /// sorts and primary key lookups, and reading interned strings.
+    RLMCacheReleaseLevelModerate,
+    /// Also refresh the calling thread's idle Realms which autorefresh, so
+    /// that the versions they were reading no longer have to be kept.
+    RLMCacheReleaseLevelCritical,
+};
+
+/**
+ Releases memory which Realm holds only to speed up later operations.
+
+ This is called automatically when the system reports memory pressure, with
+ `RLMCacheReleaseLevelCritical` if the pressure is critical, and can also be
+ called directly, such as from an app's memory warning handler.
+
+ Realms can only be used on the thread they were opened on, so the caches of
+ the calling thread's Realms are released immediately, and Realms on other
+ threads release theirs the next time they refresh or begin a write
+ transaction.
+
+ @param level How much to release.
+ */
++ (void)releaseCachedResourcesWithLevel:(RLMCacheReleaseLevel)level;
+
 /**
  Commits all write operations in the current write transaction, and ends the
  transaction.
@@ -349,6 +635,37 @@ typedef void (^RLMNotificationBlock)(RLMNotification notification, RLMRealm *rea
  */
 - (BOOL)transactionWithBlock:(__attribute__((noescape)) void(^)(void))block error:(NSError **)error;
 
+/**
+ Performs actions contained within the given block inside a write transaction
+ on a background thread, without blocking the calling thread.
+
+ The block is called on a background queue once the write lock for the Realm
+ file has been acquired, with an `RLMRealm` instance for the receiver's
+ configuration which is already in a write transaction. Objects managed by the
+ receiver can't be used within the block; pass them in with
+ `RLMThreadSafeReference` or look them up again by primary key. The transaction
+ is committed after the block returns unless the block cancels it.
+
+ Once the transaction has been committed, the receiver is refreshed if
+ `autorefresh` is enabled, so that the changes are visible to it, and then the
+ completion block is called on the thread this method was called on.
+
+ Asynchronous write transactions are performed one at a time, in the order they
+ were begun. If the configuration's `asyncWriteGroupingInterval` is set,
+ asynchronous writes begun close together are performed in a single
+ transaction.
+
+ @warning This method can only be called from a thread with a runloop, such as
+          the main thread.
+
+ @param block      The block containing actions to perform.
+ @param completion A block called on the current thread once the transaction
+                   has completed, with an error if the Realm could not be opened
+                   or the transaction could not be committed.
+ */
+- (void)beginAsyncWriteTransaction:(void(^)(RLMRealm *realm))block
+                        completion:(nullable void(^)(NSError *_Nullable error))completion;
+
 /**
  Updates the Realm and outstanding objects managed by the Realm to point to the
  most recent data.
@@ -395,6 +712,114 @@ typedef void (^RLMNotificationBlock)(RLMNotification notification, RLMRealm *rea
  */
 @property (nonatomic) BOOL autorefresh;
 
+/**
+ Set this property to `YES` to read long string properties without copying them.
+
+ When enabled, reading a string property outside of a write transaction returns
+ a string which refers directly to the data in the Realm file rather than a
+ copy of it, which avoids allocating and copying the string for every read.
+ Before the Realm advances to a newer version, is invalidated, or begins a write
+ transaction, all such strings are copied so that they remain valid.
+
+ Such strings can be read from any thread, but each read of their contents
+ takes a lock. Copying them with `-copy` returns an ordinary string which
+ does not refer to the Realm file.
+
+ Defaults to `NO`.
+ */
+@property (nonatomic) BOOL readsStringsWithoutCopying;
+
+/**
+ Set this property to `YES` to return the same object each time an object is read again from this Realm.
+
+ When enabled, looking up an object at an index of a collection, following a link or enumerating a collection returns
+ the object which was last returned for the same row, as long as it is still in use elsewhere, rather than creating
+ a new one. Objects are only shared within a single version of the Realm: once the Realm advances to a newer version
+ or begins a write transaction, reading a row creates a new object again.
+
+ Defaults to `NO`.
+ */
+@property (nonatomic) BOOL reusesObjectAccessors;
+
+/**
+ Returns statistics about the Realm file and the resources this instance is
+ using, for diagnosing unexpected growth of the file or of memory usage.
+
+ The returned dictionary contains the following keys:
+
+ - `fileSize`: the size of the Realm file in bytes, or `0` for in-memory Realms.
+ - `version`: the version of the Realm this instance is reading.
+ - `activeVersions`: the number of versions of the Realm which are being kept
+   in the file because some `RLMRealm`, in any thread or process, is still
+   reading them or something derived from them, such as an unresolved
+   `RLMThreadSafeReference`. A number which keeps growing means that some
+   thread is holding on to an old version, which keeps the space used by the
+   versions since then from being reused and makes the file grow.
+ - `objectCounts`: the number of objects of each type, keyed by class name.
+ - `observedObjects`: the number of objects this instance is tracking for
+   key-value observing and change notifications.
+ - `notificationBlocks`: the number of Realm notification blocks registered
+   with this instance.
+
+ The statistics are gathered each time this method is called.
+ */
+- (NSDictionary<NSString *, id> *)statistics;
+
+/**
+ Returns a token for the version of the Realm this instance is reading, which
+ can be passed to `-changesSinceVersion:` later to find out which objects have
+ changed since then.
+
+ The token keeps its version of the Realm in the file for as long as it
+ exists, as reading a version does, so tokens should be released once the
+ changes since them have been processed.
+
+ Tokens cannot be created for synchronized Realms.
+ */
+- (RLMRealmVersion *)currentVersion;
+
+/**
+ Returns the primary keys of the objects which have been inserted, modified and
+ deleted between the given version of the Realm and the version this instance
+ is reading, by class name, for keeping something outside of the Realm such as
+ a search index in sync with it.
+
+ The changes are read from the Realm's record of the transactions committed
+ since the version, so the time this takes depends on how much has changed
+ rather than on how much data the Realm holds. Only classes which have a
+ primary key are included, and only those which have changed.
+
+ An object which was deleted and then created again with the same primary key
+ is reported as modified.
+
+ @param version A token returned by `-currentVersion` on an `RLMRealm` for the same file.
+
+ @return A dictionary of the changes to the objects of each class, by class name.
+ */
+- (NSDictionary<NSString *, RLMObjectChanges *> *)changesSinceVersion:(RLMRealmVersion *)version;
+
+/**
+ Opens a new `RLMRealm` instance which reads the given past version of this Realm, so that the same queries can be run
+ against both versions and their results compared.
+
+ The returned Realm stays at the version for as long as it exists: it is not refreshed, cannot begin write
+ transactions and does not deliver notifications. Invalidating it detaches the objects read from it but leaves it at
+ the same version. Like the token itself, it keeps the version in the file until it is released.
+
+ Only versions whose schema matches the schema this Realm was opened with can be opened.
+
+ @param version A token returned by `-currentVersion` on an `RLMRealm` for the same file.
+ @param error   If an error occurs, upon return contains an `NSError` object
+                that describes the problem. If you are not interested in
+                possible errors, pass in `NULL`.
+
+ @return A Realm reading the version, or `nil` if the Realm could not be opened.
+ */
+- (nullable RLMRealm *)realmAtVersion:(RLMRealmVersion *)version error:(NSError **)error;
+
+/// The version this Realm was opened at with `-realmAtVersion:error:`, or `nil` if it reads the latest version.
+@property (nonatomic, readonly, nullable) RLMRealmVersion *pinnedVersion;
+
 /**
  Writes a compacted and optionally encrypted copy of the Realm to the given local URL.
 
@@ -414,6 +839,33 @@ typedef void (^RLMNotificationBlock)(RLMNotification notification, RLMRealm *rea
 */
 - (BOOL)writeCopyToURL:(NSURL *)fileURL encryptionKey:(nullable NSData *)key error:(NSError **)error;
 
+/**
+ Writes a compacted copy of the Realm to the given output stream on a
+ background queue, such as to upload a backup without first writing it to a
+ file.
+
+ The copy is of the latest version of the Realm at the time the background
+ queue reads it; changes made in a write transaction which hasn't been
+ committed yet are not included. The copy is never encrypted, even if the Realm
+ is, and can be opened as a Realm file once saved. It is written at utility
+ quality of service, so that it has little effect on the responsiveness of the
+ rest of the app.
+
+ The stream is opened if it isn't open already, and is then closed once the
+ copy has been written.
+
+ @param stream        The output stream to write the copy to.
+ @param callbackQueue The queue to call `progress` and `completion` on.
+ @param progress      A block called periodically with the number of bytes
+                      written so far.
+ @param completion    A block called once the copy has been written, with an
+                      error if it could not be.
+ */
+- (void)writeCopyToStream:(NSOutputStream *)stream
+            callbackQueue:(dispatch_queue_t)callbackQueue
+                 progress:(nullable void (^)(NSUInteger bytesWritten))progress
+               completion:(void (^)(NSError *_Nullable error))completion;
+
 /**
  Invalidates all `RLMObject`s, `RLMResults`, `RLMLinkingObjects`, and `RLMArray`s managed by the Realm.
 
@@ -527,6 +979,78 @@ NS_REFINED_FOR_SWIFT;
  */
 - (void)addOrUpdateObjectsFromArray:(id)array;
 
+/**
+ Options for `-copyObjects:fromRealm:options:`.
+ */
+typedef NS_OPTIONS(NSUInteger, RLMCopyOptions) {
+    /// Objects whose primary key already exists in the destination Realm are
+    /// left unchanged, and links to them are made to the existing objects.
+    RLMCopyOptionsNone           = 0,
+    /// Objects whose primary key already exists in the destination Realm are
+    /// updated with the values of the copied objects.
+    RLMCopyOptionsUpdateExisting = 1 << 0,
+};
+
+/**
+ Copies managed objects from another Realm into this Realm, along with all of
+ the objects they link to.
+
+ Unlike passing the objects to `-[RLMObject createInRealm:withValue:]`, this
+ copies the stored values directly rather than reading them through the
+ objects' properties and validating them again, and copies each object at most
+ once, so an object which is linked to by several of the copied objects is
+ copied only once. Objects with a primary key are matched with the objects
+ already in this Realm by their primary key, and are not duplicated.
+
+ Both Realms must contain the classes of all of the copied objects, with the
+ same persisted properties.
+
+ @warning This method may only be called during a write transaction.
+
+ @param objects An enumerable object such as `NSArray` or `RLMResults` which
+                contains objects managed by `realm`.
+ @param realm   The Realm which manages the objects. It must not be a Realm
+                for the same file as this Realm.
+ @param options Options controlling how existing objects are handled.
+
+ @return The copies of `objects` in this Realm, in the same order.
+ */
+- (NSArray<RLMObject *> *)copyObjects:(id<NSFastEnumeration>)objects
+                            fromRealm:(RLMRealm *)realm
+                              options:(RLMCopyOptions)options;
+
+/**
+ Appends a batch of objects of the given class, given as the values for each
+ of their properties in column-oriented buffers.
+
+ This writes the values directly to the Realm's columns rather than creating
+ the objects one at a time, and so is much faster than
+ `-[RLMObject createInRealm:withValue:]` for data which is already stored by
+ column, such as the batches sent by a server in the Apache Arrow format.
+
+ Properties which are not given a column are set to their default value, or to
+ `nil` for optional properties. The primary key, if the class has one, must be
+ given a column. Link, array and `id` properties can't be appended.
+
+ If the buffers are not valid for `rowCount` objects, or setting any of the
+ values fails, no objects are appended and `error` is set.
+
+ @warning This method may only be called during a write transaction.
+
+ @param columns   The buffers of each property's values, keyed by property name.
+ @param className The name of the class of the objects to append.
+ @param rowCount  The number of objects to append.
+ @param error     If an error occurs, upon return contains an `NSError` object
+                  that describes the problem. If you are not interested in
+                  possible errors, pass in `NULL`.
+
+ @return Whether the objects were appended.
+ */
+- (BOOL)appendColumns:(NSDictionary<NSString *, RLMColumnBuffer *> *)columns
+              toClass:(NSString *)className
+             rowCount:(NSUInteger)rowCount
+                error:(NSError **)error;
+
 /**
  Deletes an object from the Realm. Once the object is deleted it is considered invalidated.
 
@@ -572,9 +1096,27 @@ NS_REFINED_FOR_SWIFT;
  */
 typedef void (^RLMMigrationBlock)(RLMMigration *migration, uint64_t oldSchemaVersion);
 
+/**
+ The type of a block which is called periodically to report the progress of a migration.
+
+ The block is called from within the migration block each time a batch of objects has been processed by
+ `-[RLMMigration enumerateObjects:block:]` or one of the property transform methods, and once more when
+ the operation completes.
+
+ @param className   The name of the class whose objects are being processed.
+ @param processed   The number of objects which have been processed so far by the current operation.
+ @param total       The number of objects which the current operation will process.
+ */
+typedef void (^RLMMigrationProgressBlock)(NSString *className, NSUInteger processed, NSUInteger total);
+
 /**
  Returns the schema version for a Realm at a given local URL.
 
+ If the Realm has been opened before and isn't currently open in any process,
+ the version is read from the file without opening the Realm, so that checking
+ which of many files need to be migrated is cheap. Otherwise the Realm is
+ opened to read it, so that it's read safely while other processes write to it.
+
  @param fileURL Local URL to a Realm file.
  @param key     64-byte key used to encrypt the file, or `nil` if it is unencrypted.
  @param error   If an error occurs, upon return contains an `NSError` object
@@ -649,4 +1191,135 @@ __deprecated_msg("Use `performMigrationForConfiguration:error:`") NS_REFINED_FOR
 - (void)stop;
 @end
 
+/**
+ A token for a version of a Realm, returned by `-[RLMRealm currentVersion]`.
+
+ Tokens can be used on any thread, but not on more than one at a time.
+ */
+@interface RLMRealmVersion : NSObject
+/// The number of the version, which increases with every write transaction.
+@property (nonatomic, readonly) uint64_t version;
+
+/// :nodoc:
+- (instancetype)init __attribute__((unavailable("RLMRealmVersion cannot be created directly")));
+@end
+
+/**
+ The objects of one class which changed between two versions of a Realm, as
+ returned by `-[RLMRealm changesSinceVersion:]`.
+ */
+@interface RLMObjectChanges : NSObject
+/// The primary keys of the objects which were created.
+@property (nonatomic, readonly) NSArray *insertedPrimaryKeys;
+/// The primary keys of the objects which had one or more properties changed.
+@property (nonatomic, readonly) NSArray *modifiedPrimaryKeys;
+/// The primary keys of the objects which were deleted.
+@property (nonatomic, readonly) NSArray *deletedPrimaryKeys;
+@end
+
+/**
+ The values of a single property for a batch of objects appended with
+ `-[RLMRealm appendColumns:toClass:rowCount:error:]`, laid out in the same
+ way as an Apache Arrow array.
+
+ The layout of `values` depends on the type of the property:
+
+ * `int` properties: one `int64_t` per object.
+ * `bool` properties: one bit per object, with bit `i % 8` of byte `i / 8` set
+   if the value for object `i` is true.
+ * `float` and `double` properties: one `float` or `double` per object.
+ * `NSDate` properties: one `int64_t` per object, holding the number of
+   milliseconds since 1970-01-01 00:00:00 UTC.
+ * `NSString` and `NSData` properties: the UTF-8 strings or bytes for all of
+   the objects one after another, with `offsets` holding `rowCount + 1`
+   `int32_t` offsets into `values`, where the value for object `i` runs from
+   `offsets[i]` to `offsets[i + 1]`. Strings which aren't valid UTF-8 are
+   reported as invalid buffers.
+
+ All values are in the native byte order. If `validity` is set, bit `i % 8` of
+ byte `i / 8` is clear if the value for object `i` is `nil`, and the
+ corresponding entry in `values` is ignored.
+ */
+@interface RLMColumnBuffer : NSObject
+/// The values of the column.
+@property (nonatomic, readonly) NSData *values;
+/// The offsets of the values for `NSString` and `NSData` properties.
+@property (nonatomic, readonly, nullable) NSData *offsets;
+/// A bitmap of which values are not `nil`, or `nil` if none are `nil`.
+@property (nonatomic, readonly, nullable) NSData *validity;
+
+/**
+ Creates a column buffer.
+
+ The buffers are not copied, so they must not be modified until the column
+ has been appended.
+ */
++ (instancetype)bufferWithValues:(NSData *)values
+                         offsets:(nullable NSData *)offsets
+                        validity:(nullable NSData *)validity;
+
+/// :nodoc:
+- (instancetype)init __attribute__((unavailable("Use +bufferWithValues:offsets:validity:")));
+@end
+
+/**
+ A serial queue of write transactions for a Realm file, performed on a
+ dedicated background thread, returned by `-[RLMRealmConfiguration writeQueue]`.
+ The thread and its Realm instance are kept open while blocks are waiting to be
+ performed, and are closed once the queue has drained.
+
+ Blocks are performed in the order they were enqueued. Blocks which are waiting
+ when the thread becomes free are performed together in a single write
+ transaction, up to `maximumWritesPerTransaction` at a time, and if the
+ configuration's `asyncWriteGroupingInterval` is set the thread waits that long
+ for further blocks before beginning each transaction. If a block cancels the
+ transaction, only its own changes are discarded: the blocks before it in the
+ same transaction are performed again in a new transaction along with the
+ remaining blocks. If a block throws an exception, its completion is called
+ with an error describing it, and the other blocks of the transaction are
+ performed again, each in a transaction of its own.
+ */
+@interface RLMWriteQueue : NSObject
+
+/**
+ The largest number of blocks performed in a single write transaction.
+
+ Defaults to `1000`.
+ */
+@property (atomic) NSUInteger maximumWritesPerTransaction;
+
+/**
+ The queue completion blocks are called on.
+
+ Defaults to the main queue.
+ */
+@property (atomic, strong) dispatch_queue_t completionQueue;
+
+/**
+ Adds a block to the queue, to be called inside a write transaction on the
+ queue's thread.
+
+ Objects managed by other Realm instances can't be used within the block; pass
+ them in with `RLMThreadSafeReference` or look them up again by primary key.
+
+ @param block      The block containing actions to perform.
+ @param completion A block called on `completionQueue` once the transaction
+                   the block was performed in has been committed, with an error
+                   if the Realm could not be opened, the block threw an
+                   exception or the transaction could not be committed.
+ */
+- (void)enqueueWrite:(void (^)(RLMRealm *realm))block
+          completion:(nullable void (^)(NSError *_Nullable error))completion;
+
+/**
+ Blocks the calling thread until every block which has been enqueued so far
+ has been performed, its transaction committed and the queue's Realm closed.
+ */
+- (void)waitUntilAllWritesAreFinished;
+
+/// :nodoc:
+- (instancetype)init __attribute__((unavailable("Use -[RLMRealmConfiguration writeQueue]")));
+
+@end
+
 NS_ASSUME_NONNULL_END
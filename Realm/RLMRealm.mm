@@ -20,6 +20,7 @@
 
 #import "RLMAnalytics.hpp"
 #import "RLMArray_Private.hpp"
+#import "RLMCollection_Private.hpp"
 #import "RLMMigration_Private.h"
 #import "RLMObject_Private.h"
 #import "RLMObject_Private.hpp"
@@ -31,6 +32,7 @@
 #import "RLMQueryUtil.hpp"
 #import "RLMRealmConfiguration_Private.hpp"
 #import "RLMRealmUtil.hpp"
+#import "RLMRealm_Dynamic.h"
 #import "RLMSchema_Private.hpp"
 #import "RLMSyncManager_Private.h"
 #import "RLMSyncUtil_Private.hpp"
@@ -38,20 +40,44 @@
 #import "RLMUpdateChecker.hpp"
 #import "RLMUtil.hpp"
 
+#include "impl/collection_notifier.hpp"
 #include "impl/realm_coordinator.hpp"
+#include "impl/transact_log_handler.hpp"
 #include "object_store.hpp"
 #include "schema.hpp"
 #include "shared_realm.hpp"
 
 #include <realm/disable_sync_to_disk.hpp>
+#include <realm/group.hpp>
+#include <realm/group_shared.hpp>
+#include <realm/history.hpp>
 #include <realm/util/scope_exit.hpp>
 #include <realm/version.hpp>
 
+#include <algorithm>
+#include <copyfile.h>
+#include <fcntl.h>
+#include <pthread/qos.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 #import "sync/sync_session.hpp"
 
 using namespace realm;
 using util::File;
 
+RLMJSONImportOption const RLMJSONImportOptionUpdate         = @"update";
+RLMJSONImportOption const RLMJSONImportOptionCommitInterval = @"commitInterval";
+
 @interface RLMRealmNotificationToken : RLMNotificationToken
 @property (nonatomic, strong) RLMRealm *realm;
 @property (nonatomic, copy) RLMNotificationBlock block;
@@ -62,6 +88,10 @@ using util::File;
 - (void)sendNotifications:(RLMNotification)notification;
 @end
 
+@interface RLMPreparedQuery ()
+- (instancetype)initWithRealm:(RLMRealm *)realm className:(NSString *)className predicateFormat:(NSString *)format;
+@end
+
 void RLMDisableSyncToDisk() {
     realm::disable_sync_to_disk();
 }
@@ -98,6 +128,76 @@ void RLMDisableSyncToDisk() {
 }
 @end
 
+@interface RLMRealmVersion () {
+@public
+    std::string _path;
+    std::vector<char> _encryptionKey;
+    bool _inMemory;
+    std::unique_ptr<Replication> _history;
+    std::unique_ptr<SharedGroup> _sharedGroup;
+    Group *_group;
+    SharedGroup::VersionID _versionID;
+}
+@end
+
+@implementation RLMRealmVersion
+- (instancetype)initWithConfig:(Realm::Config const&)config version:(SharedGroup::VersionID)version {
+    if ((self = [super init])) {
+        _path = config.path;
+        _encryptionKey = config.encryption_key;
+        _inMemory = config.in_memory;
+        _versionID = version;
+        // The token reads its version with a transaction of its own, which
+        // keeps the version in the file until the token is released
+        _sharedGroup = [self openSharedGroup:_history];
+        _group = &const_cast<Group&>(_sharedGroup->begin_read(version));
+    }
+    return self;
+}
+
+- (std::unique_ptr<SharedGroup>)openSharedGroup:(std::unique_ptr<Replication>&)history {
+    history = make_in_realm_history(_path);
+    SharedGroupOptions options;
+    options.durability = _inMemory ? SharedGroupOptions::Durability::MemOnly : SharedGroupOptions::Durability::Full;
+    options.encryption_key = _encryptionKey.empty() ? nullptr : _encryptionKey.data();
+    return std::make_unique<SharedGroup>(*history, options);
+}
+
+- (uint64_t)version {
+    return _versionID.version;
+}
+@end
+
+@interface RLMObjectChanges ()
+- (instancetype)initWithInserted:(NSArray *)inserted modified:(NSArray *)modified deleted:(NSArray *)deleted;
+@end
+
+@implementation RLMObjectChanges
+- (instancetype)initWithInserted:(NSArray *)inserted modified:(NSArray *)modified deleted:(NSArray *)deleted {
+    if ((self = [super init])) {
+        _insertedPrimaryKeys = inserted;
+        _modifiedPrimaryKeys = modified;
+        _deletedPrimaryKeys = deleted;
+    }
+    return self;
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<RLMObjectChanges: %p> {\n\tinserted: %@\n\tmodified: %@\n\tdeleted: %@\n}",
+            self, _insertedPrimaryKeys, _modifiedPrimaryKeys, _deletedPrimaryKeys];
+}
+@end
+
+@implementation RLMColumnBuffer
++ (instancetype)bufferWithValues:(NSData *)values offsets:(NSData *)offsets validity:(NSData *)validity {
+    RLMColumnBuffer *buffer = [[self alloc] init];
+    buffer->_values = values;
+    buffer->_offsets = offsets;
+    buffer->_validity = validity;
+    return buffer;
+}
+@end
+
 static bool shouldForciblyDisableEncryption() {
     static bool disableEncryption = getenv("REALM_DISABLE_ENCRYPTION");
     return disableEncryption;
@@ -120,24 +220,631 @@ NSData *RLMRealmValidatedEncryptionKey(NSData *key) {
     return key;
 }
 
+namespace {
+// A fingerprint of the schema and schema version which a file was last opened
+// with is kept in a file next to it, so that reopening the file with the same
+// schema can skip validating the schema and checking whether it needs to be
+// updated, without writing anything to the Realm file itself. The fingerprint
+// is only a hint: it's stored along with the inode of the Realm file so that
+// replacing the file ignores it, the schema is still checked against the
+// file's tables before being used, and anything unexpected falls back to the
+// full update.
+std::string schemaFingerprintPath(std::string const& path) {
+    return path + ".schema";
+}
+
+struct StoredSchemaFingerprint {
+    uint64_t inode;
+    uint64_t value;
+};
+
+struct SchemaFingerprint {
+    uint64_t value = 14695981039346656037ULL;
+
+    void add(uint64_t v) {
+        for (int i = 0; i < 8; ++i, v >>= 8) {
+            value = (value ^ (v & 0xff)) * 1099511628211ULL;
+        }
+    }
+    void add(std::string const& str) {
+        add(str.size());
+        for (unsigned char c : str) {
+            value = (value ^ c) * 1099511628211ULL;
+        }
+    }
+    void add(Property const& prop) {
+        add(prop.name);
+        add((uint64_t)prop.type);
+        add(prop.object_type);
+        add(prop.link_origin_property_name);
+        add(prop.is_primary | prop.is_indexed << 1 | prop.is_nullable << 2);
+    }
+
+    SchemaFingerprint(Schema const& schema, uint64_t version) {
+        add(version);
+        for (auto const& objectSchema : schema) {
+            add(objectSchema.name);
+            add(objectSchema.primary_key);
+            add(objectSchema.persisted_properties.size());
+            for (auto const& prop : objectSchema.persisted_properties) {
+                add(prop);
+            }
+            add(objectSchema.computed_properties.size());
+            for (auto const& prop : objectSchema.computed_properties) {
+                add(prop);
+            }
+        }
+    }
+};
+
+uint64_t fileInode(std::string const& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 ? st.st_ino : 0;
+}
+
+bool fileMatchesSchemaFingerprint(std::string const& path, SchemaFingerprint const& fingerprint) {
+    StoredSchemaFingerprint stored;
+    int fd = open(schemaFingerprintPath(path).c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    ssize_t size = read(fd, &stored, sizeof(stored));
+    close(fd);
+    return size == sizeof(stored) && stored.value == fingerprint.value && stored.inode == fileInode(path);
+}
+
+// The number of times opening a Realm has taken the fast path, for tests
+std::atomic<uint64_t> s_schemaFingerprintMatches{0};
+
+void storeSchemaFingerprint(std::string const& path, SchemaFingerprint const& fingerprint) {
+    if (fileMatchesSchemaFingerprint(path, fingerprint)) {
+        return;
+    }
+    // Written atomically so that a process opening the file concurrently never
+    // reads part of it. Failing to write it only means the next open doesn't
+    // take the fast path.
+    StoredSchemaFingerprint stored{fileInode(path), fingerprint.value};
+    [[NSData dataWithBytes:&stored length:sizeof(stored)] writeToFile:@(schemaFingerprintPath(path).c_str())
+                                                           atomically:YES];
+}
+
+// Convert the string columns of the classes with properties listed in
+// +internedStringProperties to core's enumerated string columns, which store
+// each distinct value once. Table::optimize() converts every string column of
+// a table which would get smaller. This is done after the schema changes, as
+// that covers the migrations which may have filled the columns.
+void optimizeInternedStringColumns(Realm& realm, RLMSchema *schema) {
+    std::vector<TableRef> tables;
+    for (RLMObjectSchema *objectSchema in schema.objectSchema) {
+        for (RLMProperty *prop in objectSchema.properties) {
+            if (prop.internsStrings) {
+                if (auto table = ObjectStore::table_for_object_type(realm.read_group(), objectSchema.className.UTF8String)) {
+                    tables.push_back(table);
+                }
+                break;
+            }
+        }
+    }
+    if (tables.empty()) {
+        return;
+    }
+    realm.begin_transaction();
+    try {
+        for (auto& table : tables) {
+            table->optimize();
+        }
+        realm.commit_transaction();
+    }
+    catch (...) {
+        realm.cancel_transaction();
+        throw;
+    }
+}
+
+// The number of expired objects deleted by each write transaction of a purge,
+// which keeps each one short enough to not hold up writes on other threads
+constexpr NSUInteger RLMExpiredObjectPurgeBatchSize = 500;
+
+struct ExpiredObjectPurgeState {
+    // Incremented whenever a purge is scheduled, so that a purge scheduled for
+    // later can be superseded by one scheduled sooner
+    uint64_t generation = 0;
+    // Whether a purge has been scheduled and hasn't started yet, and when
+    // it's scheduled for as a time interval since the reference date
+    bool pending = false;
+    NSTimeInterval pendingDate = 0;
+    // Whether a purge is in progress, and whether a write transaction was
+    // committed by something else while it was
+    bool running = false;
+    bool rerun = false;
+};
+
+// The state of the purges of each Realm file, guarded by s_expiredObjectPurgeMutex
+std::mutex s_expiredObjectPurgeMutex;
+std::unordered_map<std::string, ExpiredObjectPurgeState> s_expiredObjectPurges;
+
+dispatch_queue_t expiredObjectPurgeQueue() {
+    static dispatch_queue_t queue = dispatch_queue_create("io.realm.expired-object-purge",
+                                                          dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_UTILITY, 0));
+    return queue;
+}
+
+// The class and property names of an index which hasn't been built yet
+using DeferredIndex = std::pair<std::string, std::string>;
+
+// The files whose deferred indexes are being built, guarded by
+// s_deferredIndexMutex, so that opening one again while they are doesn't
+// schedule another build
+std::mutex s_deferredIndexMutex;
+std::unordered_set<std::string> s_deferredIndexBuilds;
+// The deferred indexes which failed to be built in the background, by file,
+// guarded by s_deferredIndexMutex. They're built while opening the file the
+// next time it's opened, so that a failure is reported by opening it.
+std::unordered_map<std::string, std::vector<DeferredIndex>> s_failedDeferredIndexes;
+
+dispatch_queue_t deferredIndexQueue() {
+    static dispatch_queue_t queue = dispatch_queue_create("io.realm.deferred-index",
+                                                          dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_UTILITY, 0));
+    return queue;
+}
+
+// The Realms tracked by the long read transaction watchdog and when a write
+// transaction was last committed to each file they read, in
+// steady_clock::duration ticks, all guarded by s_readTransactionMutex.
+// s_watchingReadTransactions is set while any Realm is tracked, so that
+// commits only record their time when it's needed.
+std::mutex s_readTransactionMutex;
+std::vector<std::weak_ptr<RLMReadTransactionRecord>> s_readTransactionRecords;
+std::unordered_map<std::string, int64_t> s_lastCommitTimes;
+std::atomic<bool> s_watchingReadTransactions{false};
+dispatch_source_t s_readTransactionTimer;
+NSTimeInterval s_readTransactionCheckInterval;
+
+int64_t steadyNow() {
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+}
+} // anonymous namespace
+
+struct RLMReadTransactionRecord {
+    std::string path;
+    RLMLongReadTransactionBlock handler;
+    NSTimeInterval threshold;
+    NSDictionary<NSString *, id> *details;
+    // The run loop to refresh the Realm from, if it should be advanced
+    CFRunLoopRef runLoop = nullptr;
+    __weak RLMRealm *realm;
+    // When the Realm began reading the version it's reading, or 0 if it isn't
+    // reading one. Written only by the Realm's thread.
+    std::atomic<int64_t> readingSince{0};
+    // The value of readingSince which was last reported, so that each version
+    // is reported once
+    int64_t reported = 0;
+
+    ~RLMReadTransactionRecord() {
+        if (runLoop) {
+            CFRelease(runLoop);
+        }
+    }
+};
+
 @implementation RLMRealm {
     NSHashTable<RLMFastEnumerator *> *_collectionEnumerators;
+    NSHashTable *_mappedValues;
     bool _sendingNotifications;
+    // When the current write transaction began, if operations are being timed
+    std::chrono::steady_clock::time_point _writeTransactionStart;
+    // Whether the schema has classes whose objects expire, so that committing a
+    // write transaction should schedule a purge of the expired objects
+    bool _hasExpiringObjects;
+    // Whether this instance is the one purging expired objects in the background
+    bool _purgingExpiredObjects;
+    // The collection notification tokens which can be suspended, and the
+    // observers of the app's lifecycle notifications which suspend them
+    NSHashTable<RLMCancellationToken *> *_suspendableTokens;
+    NSArray *_lifecycleObservers;
 }
 
+@synthesize pinnedVersion = _pinnedVersion;
+
+@synthesize collectionNotificationsSuspended = _collectionNotificationsSuspended;
+
 + (BOOL)isCoreDebug {
     return realm::Version::has_feature(realm::feature_Debug);
 }
 
-+ (void)initialize {
-    static bool initialized;
-    if (initialized) {
+namespace {
+// Runs the current thread at the given quality of service until destroyed,
+// unless it is NSQualityOfServiceDefault
+class RLMScopedThreadQoS {
+public:
+    RLMScopedThreadQoS(NSQualityOfService qos) {
+        if (qos == NSQualityOfServiceDefault) {
+            return;
+        }
+        m_previous = qos_class_self();
+        if (m_previous == QOS_CLASS_UNSPECIFIED) {
+            m_previous = QOS_CLASS_DEFAULT;
+        }
+        // NSQualityOfService's values are the corresponding qos_class_t values
+        m_changed = pthread_set_qos_class_self_np(static_cast<qos_class_t>(qos), 0) == 0;
+    }
+
+    ~RLMScopedThreadQoS() {
+        if (m_changed) {
+            pthread_set_qos_class_self_np(m_previous, 0);
+        }
+    }
+
+    RLMScopedThreadQoS(RLMScopedThreadQoS const&) = delete;
+    RLMScopedThreadQoS& operator=(RLMScopedThreadQoS const&) = delete;
+
+private:
+    qos_class_t m_previous = QOS_CLASS_UNSPECIFIED;
+    bool m_changed = false;
+};
+} // anonymous namespace
+
+// Incremented by +releaseCachedResourcesWithLevel:, so that Realms which
+// haven't released their caches since can tell
+static std::atomic<uint64_t> s_cacheReleaseGeneration{0};
+
+static void RLMReleaseCachedResources(__unsafe_unretained RLMRealm *const realm) {
+    realm->_cacheReleaseGeneration = s_cacheReleaseGeneration.load();
+    for (auto& info : realm->_info) {
+        info.second.releaseCaches();
+    }
+}
+
+void RLMReleaseCachedResourcesIfNeeded(__unsafe_unretained RLMRealm *const realm) {
+    if (realm->_cacheReleaseGeneration != s_cacheReleaseGeneration.load()) {
+        RLMReleaseCachedResources(realm);
+    }
+}
+
+// Release cached resources when the system reports memory pressure, which is
+// the same signal that UIKit's memory warnings are sent for. The source is
+// handled on the main queue so that the main thread's Realms, which are the
+// ones most likely to be open, release their caches immediately.
+static dispatch_source_t s_memoryPressureSource;
+
+static void RLMInstallMemoryPressureHandler() {
+    s_memoryPressureSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_MEMORYPRESSURE, 0,
+                                                    DISPATCH_MEMORYPRESSURE_WARN | DISPATCH_MEMORYPRESSURE_CRITICAL,
+                                                    dispatch_get_main_queue());
+    dispatch_source_set_event_handler(s_memoryPressureSource, ^{
+        @autoreleasepool {
+            bool critical = dispatch_source_get_data(s_memoryPressureSource) & DISPATCH_MEMORYPRESSURE_CRITICAL;
+            [RLMRealm releaseCachedResourcesWithLevel:critical ? RLMCacheReleaseLevelCritical
+                                                               : RLMCacheReleaseLevelModerate];
+        }
+    });
+    dispatch_resume(s_memoryPressureSource);
+}
+
+// Check for updates and send analytics once the first Realm has been opened,
+// on a low-priority queue so that neither adds any work to app launch or to
+// opening that Realm
+static void RLMScheduleLaunchTasks() {
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        RLMInstallMemoryPressureHandler();
+        dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+            @autoreleasepool {
+                RLMCheckForUpdates();
+                RLMSendAnalytics();
+            }
+        });
+    });
+}
+
+// Remove the indexes of the properties listed in +deferredIndexedProperties
+// which are missing from tables which already exist in the file at `path`
+// from `target`, so that opening the Realm doesn't build them, and return
+// them. Tables which don't exist yet are created empty, so their indexes are
+// cheap to build. Indexes which failed to be built in the background are left
+// in `target`, so that they're built or fail while opening the Realm.
+static std::vector<DeferredIndex> RLMDeferMissingIndexes(RLMSchema *schema, Schema& target, Schema const& existing,
+                                                         std::string const& path) {
+    std::vector<DeferredIndex> failed;
+    {
+        std::lock_guard<std::mutex> lock(s_deferredIndexMutex);
+        auto it = s_failedDeferredIndexes.find(path);
+        if (it != s_failedDeferredIndexes.end()) {
+            failed = it->second;
+        }
+    }
+
+    std::vector<DeferredIndex> deferred;
+    for (auto& objectSchema : target) {
+        auto existingObjectSchema = existing.find(objectSchema.name);
+        if (existingObjectSchema == existing.end()) {
+            continue;
+        }
+        RLMObjectSchema *rlmObjectSchema = [schema schemaForClassName:@(objectSchema.name.c_str())];
+        for (auto& prop : objectSchema.persisted_properties) {
+            if (!prop.is_indexed || ![rlmObjectSchema[@(prop.name.c_str())] deferredIndex]) {
+                continue;
+            }
+            auto existingProp = existingObjectSchema->property_for_name(prop.name);
+            if (existingProp && existingProp->is_indexed) {
+                continue;
+            }
+            if (std::find(failed.begin(), failed.end(), DeferredIndex(objectSchema.name, prop.name)) != failed.end()) {
+                continue;
+            }
+            prop.is_indexed = false;
+            deferred.emplace_back(objectSchema.name, prop.name);
+        }
+    }
+    return deferred;
+}
+
+// Build the indexes which were left out when the Realm was opened with
+// `configuration`, each in a write transaction of its own so that other
+// writers wait for at most one index to be built
+static void RLMScheduleDeferredIndexBuild(RLMRealmConfiguration *configuration, std::vector<DeferredIndex> indexes) {
+    std::string path = configuration.config.path;
+    {
+        std::lock_guard<std::mutex> lock(s_deferredIndexMutex);
+        if (!s_deferredIndexBuilds.insert(path).second) {
+            return;
+        }
+    }
+
+    dispatch_async(deferredIndexQueue(), ^{
+        std::vector<DeferredIndex> failed;
+        @autoreleasepool {
+            RLMRealm *realm = [RLMRealm realmWithConfiguration:configuration error:nil];
+            for (auto const& index : indexes) {
+                if (!realm) {
+                    failed.push_back(index);
+                    continue;
+                }
+                [realm beginWriteTransaction];
+                try {
+                    TableRef table = ObjectStore::table_for_object_type(realm.group, index.first);
+                    size_t col = table ? table->get_column_index(index.second) : npos;
+                    if (col != npos && !table->has_search_index(col)) {
+                        table->add_search_index(col);
+                    }
+                    [realm commitWriteTransaction:nil];
+                }
+                catch (std::exception const& e) {
+                    [realm cancelWriteTransaction];
+                    NSLog(@"Failed to build the index of '%s.%s' in the Realm at '%s': %s",
+                          index.first.c_str(), index.second.c_str(), path.c_str(), e.what());
+                    failed.push_back(index);
+                }
+            }
+            [realm invalidate];
+        }
+
+        std::lock_guard<std::mutex> lock(s_deferredIndexMutex);
+        s_deferredIndexBuilds.erase(path);
+        if (!failed.empty()) {
+            s_failedDeferredIndexes[path] = std::move(failed);
+        }
+    });
+}
+
+// Forget the deferred indexes which failed to be built in the background for
+// the file at `path`, once opening it has built them
+static void RLMClearFailedDeferredIndexes(std::string const& path) {
+    std::lock_guard<std::mutex> lock(s_deferredIndexMutex);
+    s_failedDeferredIndexes.erase(path);
+}
+
+void RLMWaitForDeferredIndexBuilds() {
+    dispatch_sync(deferredIndexQueue(), ^{});
+}
+
+uint64_t RLMSchemaFingerprintMatchCount() {
+    return s_schemaFingerprintMatches.load();
+}
+
+// Report the tracked Realms which have been reading a version for longer than
+// their threshold while a newer one has been committed
+static void RLMCheckReadTransactions() {
+    std::vector<std::pair<std::shared_ptr<RLMReadTransactionRecord>, NSTimeInterval>> stale;
+    {
+        std::lock_guard<std::mutex> lock(s_readTransactionMutex);
+        int64_t now = steadyNow();
+        auto& records = s_readTransactionRecords;
+        records.erase(std::remove_if(records.begin(), records.end(), [](auto& record) { return record.expired(); }),
+                      records.end());
+        for (auto& weakRecord : records) {
+            auto record = weakRecord.lock();
+            int64_t since = record ? record->readingSince.load() : 0;
+            if (!since || since == record->reported) {
+                continue;
+            }
+            auto lastCommit = s_lastCommitTimes.find(record->path);
+            if (lastCommit == s_lastCommitTimes.end() || lastCommit->second <= since) {
+                continue;
+            }
+            NSTimeInterval age = std::chrono::duration<double>(std::chrono::steady_clock::duration(now - since)).count();
+            if (age > record->threshold) {
+                record->reported = since;
+                stale.emplace_back(std::move(record), age);
+            }
+        }
+        if (records.empty()) {
+            dispatch_source_cancel(s_readTransactionTimer);
+            s_readTransactionTimer = nil;
+            s_lastCommitTimes.clear();
+            s_watchingReadTransactions = false;
+        }
+    }
+
+    for (auto& report : stale) {
+        auto record = report.first;
+        record->handler(record->details, report.second);
+        if (auto runLoop = record->runLoop) {
+            CFRunLoopPerformBlock(runLoop, kCFRunLoopDefaultMode, ^{
+                RLMRealm *realm = record->realm;
+                if (realm && realm.autorefresh && !realm.inWriteTransaction) {
+                    [realm refresh];
+                }
+            });
+            CFRunLoopWakeUp(runLoop);
+        }
+    }
+}
+
+// Start tracking the versions read by a newly opened Realm if its
+// configuration has a long read transaction handler
+static void RLMWatchReadTransactions(__unsafe_unretained RLMRealm *const realm,
+                                     RLMRealmConfiguration *configuration) {
+    if (!configuration.longReadTransactionHandler || configuration.readOnly) {
+        return;
+    }
+
+    auto record = std::make_shared<RLMReadTransactionRecord>();
+    record->path = configuration.config.path;
+    record->handler = configuration.longReadTransactionHandler;
+    record->threshold = configuration.longReadTransactionThreshold;
+    record->realm = realm;
+    NSThread *thread = NSThread.currentThread;
+    NSMutableDictionary *details = [@{@"realmPath": @(record->path.c_str()),
+                                      @"threadName": thread.name.length ? thread.name
+                                                   : thread.isMainThread ? @"main" : thread.description} mutableCopy];
+#ifdef DEBUG
+    details[@"backtrace"] = NSThread.callStackSymbols;
+#endif
+    record->details = details;
+    if (configuration.advancesLongReadTransactions) {
+        record->runLoop = (CFRunLoopRef)CFRetain(CFRunLoopGetCurrent());
+    }
+    realm->_readTransactionRecord = record;
+
+    std::lock_guard<std::mutex> lock(s_readTransactionMutex);
+    s_readTransactionRecords.push_back(record);
+    s_watchingReadTransactions = true;
+
+    // Check a few times per threshold so that Realms are reported soon after
+    // they pass it
+    NSTimeInterval interval = std::max(record->threshold / 4, 0.01);
+    if (s_readTransactionTimer && interval >= s_readTransactionCheckInterval) {
+        return;
+    }
+    if (!s_readTransactionTimer) {
+        s_readTransactionTimer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0,
+                                                        dispatch_get_global_queue(QOS_CLASS_UTILITY, 0));
+        dispatch_source_set_event_handler(s_readTransactionTimer, ^{
+            @autoreleasepool {
+                RLMCheckReadTransactions();
+            }
+        });
+        dispatch_resume(s_readTransactionTimer);
+    }
+    s_readTransactionCheckInterval = interval;
+    uint64_t nanoseconds = uint64_t(interval * NSEC_PER_SEC);
+    dispatch_source_set_timer(s_readTransactionTimer, dispatch_time(DISPATCH_TIME_NOW, nanoseconds),
+                              nanoseconds, nanoseconds / 4);
+}
+
+void RLMRecordReadTransaction(__unsafe_unretained RLMRealm *const realm, bool reading) {
+    if (auto& record = realm->_readTransactionRecord) {
+        record->readingSince = reading ? steadyNow() : 0;
+    }
+}
+
+// Record for the long read transaction watchdog that a newer version of the
+// Realm's file has been committed
+static void RLMRecordCommitForWatchdog(__unsafe_unretained RLMRealm *const realm) {
+    if (!s_watchingReadTransactions) {
         return;
     }
-    initialized = true;
+    std::lock_guard<std::mutex> lock(s_readTransactionMutex);
+    s_lastCommitTimes[realm->_realm->config().path] = steadyNow();
+}
+
+static bool RLMSchemaHasExpiringObjects(RLMSchema *schema) {
+    for (RLMObjectSchema *objectSchema in schema.objectSchema) {
+        if (objectSchema.expirationProperty) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void RLMRunExpiredObjectPurge(RLMRealmConfiguration *configuration, uint64_t generation);
+
+// Schedule a purge of the expired objects of the Realm opened with
+// `configuration` at `date`, or immediately if it's nil. Opening a Realm only
+// schedules a purge if none is pending or running; committing a write schedules
+// one for the earliest expiration date, replacing any pending one scheduled for
+// later, or makes the running purge run again once it's done.
+static void RLMScheduleExpiredObjectPurge(RLMRealmConfiguration *configuration, NSDate *date, bool afterWrite) {
+    uint64_t generation;
+    {
+        std::lock_guard<std::mutex> lock(s_expiredObjectPurgeMutex);
+        auto& state = s_expiredObjectPurges[configuration.config.path];
+        if (state.running) {
+            state.rerun |= afterWrite;
+            return;
+        }
+        NSTimeInterval when = date ? date.timeIntervalSinceReferenceDate : 0;
+        if (state.pending && (!afterWrite || when >= state.pendingDate)) {
+            return;
+        }
+        generation = ++state.generation;
+        state.pending = true;
+        state.pendingDate = when;
+    }
+
+    NSTimeInterval delay = date.timeIntervalSinceNow;
+    dispatch_time_t when = delay > 0 ? dispatch_time(DISPATCH_TIME_NOW, int64_t(delay * NSEC_PER_SEC)) : DISPATCH_TIME_NOW;
+    dispatch_after(when, expiredObjectPurgeQueue(), ^{
+        RLMRunExpiredObjectPurge(configuration, generation);
+    });
+}
+
+static void RLMRunExpiredObjectPurge(RLMRealmConfiguration *configuration, uint64_t generation) {
+    std::string const& path = configuration.config.path;
+    {
+        std::lock_guard<std::mutex> lock(s_expiredObjectPurgeMutex);
+        auto& state = s_expiredObjectPurges[path];
+        if (state.generation != generation) {
+            return;
+        }
+        state.pending = false;
+        state.running = true;
+    }
+
+    NSDate *nextExpiration = nil;
+    @autoreleasepool {
+        // Nothing is purged from Realms which are no longer open anywhere in
+        // the process, so that closing a Realm or deleting its file stops the
+        // purges; they start again when it's next opened
+        RLMRealm *realm = RLMGetAnyCachedRealmForPath(path)
+                        ? [RLMRealm realmWithConfiguration:configuration error:nil] : nil;
+        if (realm) {
+            bool wasPurging = realm->_purgingExpiredObjects;
+            realm->_purgingExpiredObjects = true;
+            @try {
+                [realm purgeExpiredObjectsWithBatchSize:RLMExpiredObjectPurgeBatchSize];
+                nextExpiration = [realm earliestExpirationDate];
+            }
+            @catch (NSException *e) {
+                // the purge is retried after the next write transaction
+                NSLog(@"Failed to purge the expired objects of the Realm at '%s': %@", path.c_str(), e.reason);
+            }
+            realm->_purgingExpiredObjects = wasPurging;
+        }
+    }
 
-    RLMCheckForUpdates();
-    RLMSendAnalytics();
+    bool rerun;
+    {
+        std::lock_guard<std::mutex> lock(s_expiredObjectPurgeMutex);
+        auto& state = s_expiredObjectPurges[path];
+        rerun = state.rerun;
+        state.running = false;
+        state.rerun = false;
+    }
+    if (rerun || nextExpiration) {
+        RLMScheduleExpiredObjectPurge(configuration, rerun ? nil : nextExpiration, rerun);
+    }
 }
 
 - (instancetype)initPrivate {
@@ -163,6 +870,9 @@ NSData *RLMRealmValidatedEncryptionKey(NSData *key) {
 }
 
 - (realm::Group &)group {
+    if (_readTransactionRecord && !_readTransactionRecord->readingSince) {
+        RLMRecordReadTransaction(self, true);
+    }
     return _realm->read_group();
 }
 
@@ -171,6 +881,9 @@ NSData *RLMRealmValidatedEncryptionKey(NSData *key) {
 }
 
 - (void)setAutorefresh:(BOOL)autorefresh {
+    if (autorefresh && _pinnedVersion) {
+        @throw RLMException(@"Cannot enable autorefresh for a Realm opened at a past version.");
+    }
     _realm->set_auto_refresh(autorefresh);
 }
 
@@ -187,6 +900,14 @@ NSData *RLMRealmValidatedEncryptionKey(NSData *key) {
 + (void)asyncOpenWithConfiguration:(RLMRealmConfiguration *)configuration
                      callbackQueue:(dispatch_queue_t)callbackQueue
                           callback:(RLMAsyncOpenRealmCallback)callback {
+    [self asyncOpenWithConfiguration:configuration initialDownloadSize:0
+                       callbackQueue:callbackQueue callback:callback];
+}
+
++ (void)asyncOpenWithConfiguration:(RLMRealmConfiguration *)configuration
+               initialDownloadSize:(NSUInteger)initialDownloadSize
+                     callbackQueue:(dispatch_queue_t)callbackQueue
+                          callback:(RLMAsyncOpenRealmCallback)callback {
     RLMRealm *strongReferenceToSyncedRealm = nil;
     if (configuration.config.sync_config) {
         NSError *error = nil;
@@ -204,8 +925,19 @@ NSData *RLMRealmValidatedEncryptionKey(NSData *key) {
             if (strongReferenceToSyncedRealm) {
                 // Sync behavior: get the raw session, then wait for it to download.
                 if (auto session = sync_session_for_realm(strongReferenceToSyncedRealm)) {
-                    // Wait for the session to download, then open it.
-                    session->wait_for_download_completion([=](std::error_code error_code) {
+                    // Wait for the session to download, then open it. If an
+                    // initial download size was given, the Realm is opened as
+                    // soon as that much has been downloaded instead, and
+                    // whichever of the two happens second does nothing.
+                    auto delivered = std::make_shared<std::atomic<bool>>(false);
+                    auto signpost = std::make_shared<RLMSignpost>(RLMSignpostName::SyncDownload, [&] {
+                        return configuration.fileURL.lastPathComponent;
+                    });
+                    auto deliver = [=](std::error_code error_code) {
+                        if (delivered->exchange(true)) {
+                            return;
+                        }
+                        signpost->end();
                         dispatch_async(callbackQueue, ^{
                             (void)strongReferenceToSyncedRealm;
                             NSError *error = nil;
@@ -227,6 +959,24 @@ NSData *RLMRealmValidatedEncryptionKey(NSData *key) {
                                                                          }]);
                             }
                         });
+                    };
+
+                    auto progressToken = std::make_shared<uint64_t>(0);
+                    if (initialDownloadSize > 0) {
+                        *progressToken = session->register_progress_notifier([=](uint64_t transferred, uint64_t) {
+                            if (transferred >= initialDownloadSize) {
+                                deliver({});
+                            }
+                        }, SyncSession::NotifierType::download, true);
+                    }
+                    std::weak_ptr<SyncSession> weakSession = session;
+                    session->wait_for_download_completion([=](std::error_code error_code) {
+                        if (auto session = weakSession.lock()) {
+                            if (*progressToken) {
+                                session->unregister_progress_notifier(*progressToken);
+                            }
+                        }
+                        deliver(error_code);
                     });
                 } else {
                     dispatch_async(callbackQueue, ^{
@@ -239,16 +989,90 @@ NSData *RLMRealmValidatedEncryptionKey(NSData *key) {
                     return;
                 }
             } else {
-                // Default behavior: just dispatch onto the destination queue and open the Realm.
+                // Default behavior: open the Realm on this queue so that creating
+                // the file, compacting it and migrating or initializing the
+                // schema don't run on the destination queue. The instance is kept
+                // alive until the destination queue has opened its own, which can
+                // then reuse the schema from it rather than reinitializing it, and
+                // is then released on this queue, which it's cached for, as
+                // +prewarmWithConfiguration:queries:completion: does.
+                NSError *error = nil;
+                RLMRealm *backgroundRealm = [RLMRealm realmWithConfiguration:configuration error:&error];
+                if (!backgroundRealm) {
+                    dispatch_async(callbackQueue, ^{
+                        callback(nil, error);
+                    });
+                    return;
+                }
+                dispatch_semaphore_t opened = dispatch_semaphore_create(0);
                 dispatch_async(callbackQueue, ^{
                     @autoreleasepool {
                         NSError *error = nil;
                         RLMRealm *localRealm = [RLMRealm realmWithConfiguration:configuration error:&error];
+                        dispatch_semaphore_signal(opened);
                         callback(localRealm, error);
                     }
                 });
+                dispatch_semaphore_wait(opened, DISPATCH_TIME_FOREVER);
+                backgroundRealm = nil;
+                return;
+            }
+        }
+    });
+}
+
++ (void)prewarmWithConfiguration:(RLMRealmConfiguration *)configuration
+                         queries:(NSArray<RLMResults *> *(^)(RLMRealm *))queries
+                      completion:(RLMPrewarmRealmCallback)completion {
+    static dispatch_queue_t queue = dispatch_queue_create("io.realm.prewarmDispatchQueue", DISPATCH_QUEUE_CONCURRENT);
+    dispatch_async(queue, ^{
+        @autoreleasepool {
+            NSError *error = nil;
+            RLMRealm *backgroundRealm = [RLMRealm realmWithConfiguration:configuration error:&error];
+            if (!backgroundRealm) {
+                dispatch_async(dispatch_get_main_queue(), ^{
+                    completion(nil, nil, error);
+                });
                 return;
             }
+
+            auto fail = [&](NSError *error) {
+                dispatch_async(dispatch_get_main_queue(), ^{
+                    completion(nil, nil, error);
+                });
+            };
+
+            RLMThreadSafeReference *reference;
+            @try {
+                NSArray<RLMResults *> *results = queries(backgroundRealm) ?: @[];
+                for (RLMResults *result in results) {
+                    if (![result isKindOfClass:[RLMResults class]] || result.realm != backgroundRealm) {
+                        @throw RLMException(@"Prewarmed queries must be RLMResults in the Realm passed to the queries block");
+                    }
+                    [result touchObjects];
+                }
+                reference = [RLMThreadSafeReference referenceWithThreadConfinedObjects:results];
+            }
+            @catch (NSException *e) {
+                return fail(RLMMakeError(e));
+            }
+
+            // All of the results are handed over at the same version, and the
+            // background Realm is kept open until the main queue has opened
+            // its own so that the schema is reused rather than reinitialized.
+            // It's then released here, rather than on the main queue.
+            dispatch_semaphore_t opened = dispatch_semaphore_create(0);
+            dispatch_async(dispatch_get_main_queue(), ^{
+                @autoreleasepool {
+                    NSError *error = nil;
+                    RLMRealm *localRealm = [RLMRealm realmWithConfiguration:configuration error:&error];
+                    NSArray *localResults = localRealm ? [localRealm resolveThreadSafeReference:reference] : nil;
+                    dispatch_semaphore_signal(opened);
+                    completion(localRealm, localResults, error);
+                }
+            });
+            dispatch_semaphore_wait(opened, DISPATCH_TIME_FOREVER);
+            backgroundRealm = nil;
         }
     });
 }
@@ -331,6 +1155,39 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
     }
 }
 
+// Clone the configuration's seed file into place if the Realm file doesn't
+// exist yet. The clone is made under a temporary name and then renamed so that
+// a partially-copied file is never opened as the Realm.
+static bool RLMCloneSeedFileIfNeeded(RLMRealmConfiguration *configuration, NSError **error) {
+    auto& config = configuration.config;
+    NSURL *seedFileURL = configuration.seedFileURL;
+    if (!seedFileURL || config.in_memory || config.sync_config) {
+        return true;
+    }
+    if (File::exists(config.path)) {
+        return true;
+    }
+
+    NSString *tmpPath = [configuration.pathOnDisk stringByAppendingFormat:@".seed-%@", NSUUID.UUID.UUIDString];
+    // COPYFILE_CLONE makes a copy-on-write clone where the filesystem supports
+    // it and falls back to copying the data otherwise
+    if (copyfile(seedFileURL.path.UTF8String, tmpPath.UTF8String, nullptr, COPYFILE_CLONE | COPYFILE_DATA) != 0
+        || rename(tmpPath.UTF8String, config.path.c_str()) != 0) {
+        int err = errno;
+        unlink(tmpPath.UTF8String);
+        NSString *message = [NSString stringWithFormat:@"Unable to copy seed file '%@' to '%s': %s",
+                             seedFileURL.path, config.path.c_str(), strerror(err)];
+        RLMSetErrorOrThrow([NSError errorWithDomain:RLMErrorDomain code:RLMErrorFileAccess
+                                           userInfo:@{NSLocalizedDescriptionKey: message,
+                                                      NSFilePathErrorKey: seedFileURL.path,
+                                                      NSUnderlyingErrorKey: [NSError errorWithDomain:NSPOSIXErrorDomain
+                                                                                                code:err userInfo:nil]}],
+                           error);
+        return false;
+    }
+    return true;
+}
+
 + (instancetype)realmWithConfiguration:(RLMRealmConfiguration *)configuration error:(NSError **)error {
     bool dynamic = configuration.dynamic;
     bool cache = configuration.cache;
@@ -365,12 +1222,22 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
 
     RLMRealm *realm = [[RLMRealm alloc] initPrivate];
     realm->_dynamic = dynamic;
+    realm->_slowOperationHandler = configuration.slowOperationHandler;
+    realm->_slowOperationThreshold = configuration.slowOperationThreshold;
 
     // protects the realm cache and accessors cache
     static std::mutex& initLock = *new std::mutex();
     std::lock_guard<std::mutex> lock(initLock);
 
+    if (!RLMCloneSeedFileIfNeeded(configuration, error)) {
+        return nil;
+    }
+
     try {
+        // The thread which computes collection notifications for the file is
+        // started when it's first opened, and inherits this thread's QoS
+        RLMScopedThreadQoS qos(RLMGetAnyCachedRealmForPath(config.path) ? NSQualityOfServiceDefault
+                                                                        : configuration.notificationQualityOfService);
         realm->_realm = Realm::get_shared_realm(config);
     }
     catch (...) {
@@ -378,6 +1245,8 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
         return nil;
     }
 
+    std::vector<DeferredIndex> deferredIndexes;
+
     // if we have a cached realm on another thread we can skip a few steps and
     // just grab its schema
     @autoreleasepool {
@@ -400,6 +1269,7 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
 
         Realm::MigrationFunction migrationFunction;
         auto migrationBlock = configuration.migrationBlock;
+        auto migrationProgressBlock = configuration.migrationProgressBlock;
         if (migrationBlock && configuration.schemaVersion > 0) {
             migrationFunction = [=](SharedRealm old_realm, SharedRealm realm, Schema& mutableSchema) {
                 RLMSchema *oldSchema = [RLMSchema dynamicSchemaFromObjectStoreSchema:old_realm->schema()];
@@ -411,21 +1281,54 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
                 // are created
                 RLMRealm *newRealm = [RLMRealm realmWithSharedRealm:realm schema:schema.copy];
 
-                [[[RLMMigration alloc] initWithRealm:newRealm oldRealm:oldRealm schema:mutableSchema] execute:migrationBlock];
+                RLMMigration *migration = [[RLMMigration alloc] initWithRealm:newRealm oldRealm:oldRealm schema:mutableSchema];
+                migration.progressBlock = migrationProgressBlock;
+                [migration execute:migrationBlock];
 
                 oldRealm->_realm = nullptr;
                 newRealm->_realm = nullptr;
             };
         }
 
+        Schema objectStoreSchema = schema.objectStoreCopy;
+        if (!readOnly && !config.sync_config) {
+            deferredIndexes = RLMDeferMissingIndexes(schema, objectStoreSchema, realm->_realm->schema(), config.path);
+        }
+        // The fingerprint is only kept for local Realms stored on disk
+        SchemaFingerprint fingerprint(objectStoreSchema, config.schema_version);
+        bool useFingerprint = !config.sync_config && !config.in_memory;
+
+        bool schemaMatched = false;
+        if (useFingerprint && realm->_realm->schema_version() == config.schema_version
+            && fileMatchesSchemaFingerprint(config.path, fingerprint)) {
+            try {
+                realm->_realm->set_schema_subset(objectStoreSchema);
+                schemaMatched = true;
+                ++s_schemaFingerprintMatches;
+            }
+            catch (std::exception const&) {
+                // the file was changed without updating the fingerprint, so
+                // go through the normal path to report or fix the mismatch
+            }
+        }
+
         try {
-            realm->_realm->update_schema(schema.objectStoreCopy, config.schema_version,
-                                         std::move(migrationFunction));
+            if (!schemaMatched) {
+                realm->_realm->update_schema(std::move(objectStoreSchema), config.schema_version,
+                                             std::move(migrationFunction));
+                if (useFingerprint && !readOnly) {
+                    optimizeInternedStringColumns(*realm->_realm, schema);
+                    storeSchemaFingerprint(config.path, fingerprint);
+                }
+            }
         }
         catch (...) {
             RLMRealmTranslateException(error);
             return nil;
         }
+        if (!readOnly && !config.sync_config) {
+            RLMClearFailedDeferredIndexes(config.path);
+        }
 
         realm->_schema = schema;
         realm->_info = RLMSchemaInfo(realm);
@@ -446,9 +1349,53 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
         realm->_realm->m_binding_context->realm = realm->_realm;
     }
 
+    realm->_hasExpiringObjects = !readOnly && !dynamic && RLMSchemaHasExpiringObjects(realm->_schema);
+    if (realm->_hasExpiringObjects) {
+        RLMScheduleExpiredObjectPurge(configuration, nil, false);
+    }
+    if (!deferredIndexes.empty()) {
+        RLMScheduleDeferredIndexBuild(configuration, std::move(deferredIndexes));
+    }
+    RLMWatchReadTransactions(realm, configuration);
+
+    RLMScheduleLaunchTasks();
     return RLMAutorelease(realm);
 }
 
++ (BOOL)performWithConfiguration:(RLMRealmConfiguration *)configuration
+                           error:(NSError **)error
+                           block:(NS_NOESCAPE void (^)(RLMRealm *))block {
+    @autoreleasepool {
+        // A Realm which is already open on this thread is in use by the
+        // caller, so leave its read transaction alone
+        bool alreadyOpen = (configuration.cache || configuration.dynamic)
+            && RLMGetThreadLocalCachedRealmForPath(configuration.config.path);
+        RLMRealm *realm = [self realmWithConfiguration:configuration error:error];
+        if (!realm) {
+            return NO;
+        }
+        @try {
+            block(realm);
+        }
+        @finally {
+            // This may be running because the block threw, so a failure to
+            // release the Realm is logged rather than replacing that exception
+            @try {
+                if (realm->_realm->is_in_transaction()) {
+                    [realm cancelWriteTransaction];
+                }
+                if (!alreadyOpen) {
+                    [realm invalidate];
+                }
+            }
+            @catch (NSException *e) {
+                NSLog(@"Failed to release the Realm at '%@' after the block: %@", realm.configuration.fileURL.path, e.reason);
+            }
+        }
+    }
+    return YES;
+}
+
 + (instancetype)uncachedSchemalessRealmWithConfiguration:(RLMRealmConfiguration *)configuration error:(NSError **)error {
     RLMRealm *realm = [[RLMRealm alloc] initPrivate];
     try {
@@ -462,6 +1409,11 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
 }
 
 + (void)resetRealmState {
+    {
+        // pending and running purges see that they've been superseded
+        std::lock_guard<std::mutex> lock(s_expiredObjectPurgeMutex);
+        s_expiredObjectPurges.clear();
+    }
     RLMClearRealmCache();
     realm::_impl::RealmCoordinator::clear_cache();
     [RLMRealmConfiguration resetRealmConfigurationState];
@@ -472,6 +1424,9 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
     if (_realm->config().read_only()) {
         @throw RLMException(@"Read-only Realms do not change and do not have change notifications");
     }
+    if (_pinnedVersion) {
+        @throw RLMException(@"Realms opened at a past version do not change and do not have change notifications");
+    }
     if (!_realm->can_deliver_notifications()) {
         @throw RLMException(@"Can only add notification blocks from within runloops.");
     }
@@ -496,6 +1451,70 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
     return token;
 }
 
+- (void)registerSuspendableToken:(RLMCancellationToken *)token {
+    if (!_suspendableTokens) {
+        _suspendableTokens = [NSHashTable hashTableWithOptions:NSPointerFunctionsWeakMemory];
+    }
+    [_suspendableTokens addObject:token];
+}
+
+- (void)suspendCollectionNotifications {
+    [self verifyThread];
+    if (_collectionNotificationsSuspended) {
+        return;
+    }
+    _collectionNotificationsSuspended = YES;
+    for (RLMCancellationToken *token in _suspendableTokens.allObjects) {
+        [token suspend];
+    }
+}
+
+- (void)resumeCollectionNotifications {
+    [self verifyThread];
+    if (!_collectionNotificationsSuspended) {
+        return;
+    }
+    _collectionNotificationsSuspended = NO;
+    for (RLMCancellationToken *token in _suspendableTokens.allObjects) {
+        [token resume];
+    }
+}
+
+- (BOOL)suspendsCollectionNotificationsInBackground {
+    return _lifecycleObservers != nil;
+}
+
+- (void)setSuspendsCollectionNotificationsInBackground:(BOOL)suspends {
+    [self verifyThread];
+    if (suspends == (_lifecycleObservers != nil)) {
+        return;
+    }
+    NSNotificationCenter *center = NSNotificationCenter.defaultCenter;
+    if (!suspends) {
+        for (id observer in _lifecycleObservers) {
+            [center removeObserver:observer];
+        }
+        _lifecycleObservers = nil;
+        [self resumeCollectionNotifications];
+        return;
+    }
+    if (!NSThread.isMainThread) {
+        @throw RLMException(@"Only Realms confined to the main thread can suspend their notifications while the app is in the background.");
+    }
+
+    __weak RLMRealm *weakSelf = self;
+    _lifecycleObservers = @[
+        [center addObserverForName:RLMApplicationDidEnterBackgroundNotification object:nil queue:nil
+                        usingBlock:^(NSNotification *) { [weakSelf suspendCollectionNotifications]; }],
+        [center addObserverForName:RLMApplicationWillEnterForegroundNotification object:nil queue:nil
+                        usingBlock:^(NSNotification *) { [weakSelf resumeCollectionNotifications]; }],
+    ];
+}
+
++ (void)setNotificationTimingBlock:(RLMNotificationTimingBlock)block {
+    RLMSetNotificationTimingBlock(block);
+}
+
 - (void)sendNotifications:(RLMNotification)notification {
     NSAssert(!_realm->config().read_only(), @"Read-only realms do not have notifications");
     if (_sendingNotifications) {
@@ -531,16 +1550,218 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
     configuration.config = _realm->config();
     configuration.dynamic = _dynamic;
     configuration.customSchema = _schema;
+    configuration.slowOperationHandler = _slowOperationHandler;
+    configuration.slowOperationThreshold = _slowOperationThreshold;
     return configuration;
 }
 
+static NSString *const RLMReportingSlowOperationKey = @"RLMReportingSlowOperation";
+
+static NSString *RLMRealmFileName(__unsafe_unretained RLMRealm *const realm) {
+    return @(realm->_realm->config().path.c_str()).lastPathComponent;
+}
+
 - (void)beginWriteTransaction {
+    if (_pinnedVersion) {
+        @throw RLMException(@"Cannot begin a write transaction in a Realm opened at a past version.");
+    }
+    ++_readGeneration;
+    RLMRecordReadTransaction(self, true);
+    RLMReleaseCachedResourcesIfNeeded(self);
+    RLMSignpost signpost(RLMSignpostName::BeginWrite, [&] { return RLMRealmFileName(self); });
+    auto start = std::chrono::steady_clock::now();
     try {
         _realm->begin_transaction();
     }
     catch (std::exception &ex) {
         @throw RLMException(ex);
     }
+    RLMRecordWriteLockAcquired(_realm->config().path, std::chrono::steady_clock::now() - start);
+    _writeTransactionStart = start;
+}
+
+- (void)beginBulkWriteTransaction {
+    [self beginWriteTransaction];
+    _bulkWrite = true;
+}
+
+// End a bulk write transaction, if one was in progress, sending its coarse
+// notifications to the observed objects if it was committed
+static void RLMEndBulkWrite(__unsafe_unretained RLMRealm *const realm, bool committed) {
+    if (!realm->_bulkWrite) {
+        return;
+    }
+    realm->_bulkWrite = false;
+    if (!committed) {
+        return;
+    }
+
+    std::vector<std::pair<RLMObservationInfo *, RLMObjectSchema *>> observed;
+    for (auto& info : realm->_info) {
+        for (RLMObservationInfo *observationInfo : info.second.observedObjects) {
+            if (observationInfo->rowHasObservers()) {
+                observed.emplace_back(observationInfo, info.second.rlmObjectSchema);
+            }
+        }
+    }
+    for (auto const& entry : observed) {
+        for (RLMProperty *prop in entry.second.properties) {
+            entry.first->willChange(prop.name);
+        }
+    }
+    for (auto it = observed.rbegin(); it != observed.rend(); ++it) {
+        for (RLMProperty *prop in it->second.properties.reverseObjectEnumerator) {
+            it->first->didChange(prop.name);
+        }
+    }
+}
+
+- (BOOL)beginWriteTransactionWithTimeout:(NSTimeInterval)timeout error:(NSError **)error {
+    // Beginning a write transaction while already in one throws, so let
+    // beginWriteTransaction do that rather than waiting for our own lock
+    auto& path = _realm->config().path;
+    if (!_realm->is_in_transaction() && !RLMWaitForWriteLock(path, timeout)) {
+        RLMRecordWriteLockTimeout();
+        NSString *holder = RLMWriteLockHolderDescription(path) ?: @"another process";
+        NSString *message = [NSString stringWithFormat:@"Timed out after %.3f seconds waiting for the write lock of '%s', which is held by %@.",
+                             timeout, path.c_str(), holder];
+        RLMSetErrorOrThrow([NSError errorWithDomain:RLMErrorDomain
+                                               code:RLMErrorWriteLockTimeout
+                                           userInfo:@{NSLocalizedDescriptionKey: message,
+                                                      NSFilePathErrorKey: @(path.c_str())}],
+                           error);
+        return NO;
+    }
+    [self beginWriteTransaction];
+    return YES;
+}
+
++ (NSDictionary<NSString *, id> *)writeLockStatistics {
+    return RLMWriteLockStatistics();
+}
+
++ (void)releaseCachedResourcesWithLevel:(RLMCacheReleaseLevel)level {
+    ++s_cacheReleaseGeneration;
+    for (RLMRealm *realm in RLMGetThreadLocalCachedRealms()) {
+        RLMReleaseCachedResources(realm);
+        // Advancing lets the file reclaim the space held for the versions
+        // which only this Realm was still reading. Realms which don't
+        // autorefresh are left where they are, as they may rely on it.
+        if (level == RLMCacheReleaseLevelCritical && realm.autorefresh
+            && !realm->_realm->config().read_only() && !realm.inWriteTransaction) {
+            [realm refresh];
+        }
+    }
+}
+
+// Record that this instance's write transaction has ended, if it has
+static void RLMRecordWriteTransactionEnded(__unsafe_unretained RLMRealm *const realm) {
+    if (!realm->_realm->is_in_transaction()) {
+        RLMRecordWriteLockReleased(realm->_realm->config().path);
+    }
+}
+
+// Schedule a purge for when the earliest object expires now that a write
+// transaction was committed, unless it was committed by the purge itself. The
+// purge runs immediately only if an object has already expired, so that writes
+// which don't leave any expired objects don't make the purge take the write lock.
+static void RLMScheduleExpiredObjectPurgeAfterWrite(__unsafe_unretained RLMRealm *const realm) {
+    if (realm->_hasExpiringObjects && !realm->_purgingExpiredObjects) {
+        if (NSDate *earliest = [realm earliestExpirationDate]) {
+            RLMScheduleExpiredObjectPurge(realm.configuration, earliest, true);
+        }
+    }
+}
+
+- (NSUInteger)purgeExpiredObjectsWithBatchSize:(NSUInteger)batchSize {
+    [self verifyThread];
+    if (_realm->is_in_transaction()) {
+        @throw RLMException(@"Cannot purge expired objects from within a write transaction.");
+    }
+    if (batchSize == 0) {
+        @throw RLMException(@"The batch size of a purge must be greater than zero.");
+    }
+
+    NSDate *now = [NSDate date];
+    NSUInteger purged = 0;
+    for (RLMObjectSchema *objectSchema in _schema.objectSchema) {
+        RLMProperty *expiration = objectSchema.expirationProperty;
+        if (!expiration) {
+            continue;
+        }
+
+        // the expiration date is indexed, so this is a binary search of a
+        // sorted view of the table rather than a scan
+        RLMResults *expired = RLMGetObjects(self, objectSchema.className,
+                                            [NSPredicate predicateWithFormat:@"%K <= %@", expiration.name, now]);
+        NSUInteger count;
+        do {
+            @autoreleasepool {
+                // Counting before beginning the write transaction avoids
+                // taking the write lock when nothing has expired
+                if (expired.count == 0) {
+                    break;
+                }
+                [self beginWriteTransaction];
+                count = std::min<NSUInteger>(expired.count, batchSize);
+                if (count == 0) {
+                    [self cancelWriteTransaction];
+                    break;
+                }
+                NSMutableArray *batch = [NSMutableArray arrayWithCapacity:count];
+                for (NSUInteger i = 0; i < count; ++i) {
+                    [batch addObject:[expired objectAtIndex:i]];
+                }
+                RLMDeleteObjectsFromRealm(self, batch);
+                [self commitWriteTransaction];
+                purged += count;
+            }
+        } while (count == batchSize);
+    }
+    return purged;
+}
+
+- (NSDate *)earliestExpirationDate {
+    NSDate *earliest = nil;
+    for (RLMObjectSchema *objectSchema in _schema.objectSchema) {
+        if (RLMProperty *expiration = objectSchema.expirationProperty) {
+            NSDate *date = [RLMGetObjects(self, objectSchema.className, nil) minOfProperty:expiration.name];
+            if (date && (!earliest || [date compare:earliest] == NSOrderedAscending)) {
+                earliest = date;
+            }
+        }
+    }
+    return earliest;
+}
+
+// Report a committed write transaction to the slow operation handler
+static void RLMReportWriteTransaction(__unsafe_unretained RLMRealm *const realm,
+                                      std::chrono::steady_clock::time_point commitStart) {
+    if (!RLMShouldTimeOperations(realm)) {
+        return;
+    }
+    RLMReportSlowOperation(realm, RLMSlowOperationWriteTransaction, realm->_writeTransactionStart, ^{
+        return @{@"commitTime": @(std::chrono::duration<double>(std::chrono::steady_clock::now() - commitStart).count())};
+    });
+}
+
+void RLMReportSlowOperation(__unsafe_unretained RLMRealm *const realm, RLMSlowOperation operation,
+                            std::chrono::steady_clock::time_point start,
+                            NSDictionary<NSString *, id> *(^details)(void)) {
+    NSTimeInterval duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    RLMSlowOperationBlock handler = realm->_slowOperationHandler;
+    if (!handler || duration <= realm->_slowOperationThreshold) {
+        return;
+    }
+    NSMutableDictionary *threadDictionary = NSThread.currentThread.threadDictionary;
+    if (threadDictionary[RLMReportingSlowOperationKey]) {
+        return;
+    }
+    threadDictionary[RLMReportingSlowOperationKey] = @YES;
+    NSMutableDictionary *info = [details() mutableCopy];
+    info[@"realmPath"] = @(realm->_realm->config().path.c_str());
+    handler(operation, info, duration);
+    [threadDictionary removeObjectForKey:RLMReportingSlowOperationKey];
 }
 
 - (void)commitWriteTransaction {
@@ -549,10 +1770,20 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
 
 - (BOOL)commitWriteTransaction:(NSError **)outError {
     try {
+        RLMSignpost signpost(RLMSignpostName::CommitWrite, [&] { return RLMRealmFileName(self); });
+        auto commitStart = std::chrono::steady_clock::now();
         _realm->commit_transaction();
+        RLMRecordWriteTransactionEnded(self);
+        RLMRecordCommitForWatchdog(self);
+        RLMRecordReadTransaction(self, true);
+        RLMReportWriteTransaction(self, commitStart);
+        RLMScheduleExpiredObjectPurgeAfterWrite(self);
+        RLMEndBulkWrite(self, true);
         return YES;
     }
     catch (...) {
+        RLMRecordWriteTransactionEnded(self);
+        RLMEndBulkWrite(self, false);
         RLMRealmTranslateException(outError);
         return NO;
     }
@@ -567,10 +1798,20 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
     }
 
     try {
+        RLMSignpost signpost(RLMSignpostName::CommitWrite, [&] { return RLMRealmFileName(self); });
+        auto commitStart = std::chrono::steady_clock::now();
         _realm->commit_transaction();
+        RLMRecordWriteTransactionEnded(self);
+        RLMRecordCommitForWatchdog(self);
+        RLMRecordReadTransaction(self, true);
+        RLMReportWriteTransaction(self, commitStart);
+        RLMScheduleExpiredObjectPurgeAfterWrite(self);
+        RLMEndBulkWrite(self, true);
         return YES;
     }
     catch (...) {
+        RLMRecordWriteTransactionEnded(self);
+        RLMEndBulkWrite(self, false);
         RLMRealmTranslateException(error);
         return NO;
     }
@@ -589,13 +1830,150 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
     return YES;
 }
 
+// Asynchronous write transactions are performed one at a time on a serial
+// queue, so that the threads waiting for the write lock don't pile up
+static dispatch_queue_t RLMAsyncWriteQueue() {
+    static dispatch_queue_t queue = dispatch_queue_create("io.realm.asyncWriteQueue", DISPATCH_QUEUE_SERIAL);
+    return queue;
+}
+
+namespace {
+struct RLMAsyncWrite {
+    void (^block)(RLMRealm *);
+    // schedules the completion block on the thread which began the write
+    void (^finished)(NSError *);
+};
+
+// Writes waiting for their grouping interval to elapse, by Realm file path
+std::mutex s_asyncWriteGroupMutex;
+std::unordered_map<std::string, std::vector<RLMAsyncWrite>> s_asyncWriteGroups;
+} // anonymous namespace
+
+// Perform the writes in a single transaction and report the result of each
+// write to it. A write which cancels the transaction only means to discard its
+// own changes, but the changes of the writes before it are rolled back with
+// them, so those writes are performed again in a new transaction. A write which
+// throws is reported the exception as an error, and as it would otherwise fail
+// the writes grouped with it, the rest are then performed one per transaction.
+static void RLMPerformWritesInRealm(RLMRealm *realm, std::vector<RLMAsyncWrite> writes) {
+    bool separately = false;
+    while (!writes.empty()) {
+        auto end = separately ? writes.begin() + 1 : writes.end();
+        NSError *failure = nil;
+        [realm beginWriteTransaction];
+        auto write = writes.begin();
+        for (; write != end; ++write) {
+            @try {
+                write->block(realm);
+            }
+            @catch (NSException *e) {
+                if (realm.inWriteTransaction) {
+                    [realm cancelWriteTransaction];
+                }
+                failure = [NSError errorWithDomain:RLMErrorDomain code:RLMErrorFail
+                                          userInfo:@{NSLocalizedDescriptionKey: e.reason ?: e.name}];
+                separately = true;
+                break;
+            }
+            if (!realm.inWriteTransaction) {
+                break;
+            }
+        }
+        if (write != end) {
+            write->finished(failure);
+            writes.erase(write);
+            continue;
+        }
+
+        NSError *error = nil;
+        [realm commitWriteTransaction:&error];
+        for (write = writes.begin(); write != end; ++write) {
+            write->finished(error);
+        }
+        writes.erase(writes.begin(), end);
+    }
+}
+
+static void RLMPerformAsyncWrites(RLMRealmConfiguration *configuration, std::vector<RLMAsyncWrite> const& writes) {
+    @autoreleasepool {
+        NSError *error = nil;
+        if (RLMRealm *realm = [RLMRealm realmWithConfiguration:configuration error:&error]) {
+            RLMPerformWritesInRealm(realm, writes);
+            return;
+        }
+        for (auto& write : writes) {
+            write.finished(error);
+        }
+    }
+}
+
+- (void)beginAsyncWriteTransaction:(void (^)(RLMRealm *))block completion:(void (^)(NSError *))completion {
+    if (!block) {
+        @throw RLMException(@"The write block should not be nil");
+    }
+    [self verifyThread];
+    if (_realm->config().read_only()) {
+        @throw RLMException(@"Can't perform transactions on read-only Realms.");
+    }
+    if (!_realm->can_deliver_notifications()) {
+        @throw RLMException(@"Can only begin asynchronous write transactions from within runloops.");
+    }
+
+    CFRunLoopRef runLoop = CFRunLoopGetCurrent();
+    CFRetain(runLoop);
+    RLMAsyncWrite write{block, ^(NSError *error) {
+        CFRunLoopPerformBlock(runLoop, kCFRunLoopCommonModes, ^{
+            @autoreleasepool {
+                if (self.autorefresh && !_realm->is_in_transaction()) {
+                    [self refresh];
+                }
+                if (completion) {
+                    completion(error);
+                }
+            }
+        });
+        CFRunLoopWakeUp(runLoop);
+        CFRelease(runLoop);
+    }};
+
+    RLMRealmConfiguration *configuration = self.configuration;
+    NSTimeInterval interval = configuration.asyncWriteGroupingInterval;
+    if (interval <= 0) {
+        dispatch_async(RLMAsyncWriteQueue(), ^{
+            RLMPerformAsyncWrites(configuration, {write});
+        });
+        return;
+    }
+
+    // The first write to a file starts a group, which takes every write begun
+    // before the interval elapses; writes begun after that start a new group
+    std::string path = _realm->config().path;
+    std::lock_guard<std::mutex> lock(s_asyncWriteGroupMutex);
+    auto& group = s_asyncWriteGroups[path];
+    group.push_back(write);
+    if (group.size() > 1) {
+        return;
+    }
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(interval * NSEC_PER_SEC)), RLMAsyncWriteQueue(), ^{
+        std::vector<RLMAsyncWrite> writes;
+        {
+            std::lock_guard<std::mutex> groupLock(s_asyncWriteGroupMutex);
+            writes.swap(s_asyncWriteGroups[path]);
+            s_asyncWriteGroups.erase(path);
+        }
+        RLMPerformAsyncWrites(configuration, writes);
+    });
+}
+
 - (void)cancelWriteTransaction {
+    RLMEndBulkWrite(self, false);
     try {
         _realm->cancel_transaction();
     }
     catch (std::exception &ex) {
         @throw RLMException(ex);
     }
+    RLMRecordWriteTransactionEnded(self);
 }
 
 - (void)invalidate {
@@ -605,6 +1983,9 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
     }
 
     [self detachAllEnumerators];
+    [self detachAllMappedValues];
+    ++_readGeneration;
+    RLMEndBulkWrite(self, false);
 
     for (auto& objectInfo : _info) {
         for (RLMObservationInfo *info : objectInfo.second.observedObjects) {
@@ -613,6 +1994,8 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
     }
 
     _realm->invalidate();
+    RLMRecordWriteTransactionEnded(self);
+    RLMRecordReadTransaction(self, false);
 
     for (auto& objectInfo : _info) {
         for (RLMObservationInfo *info : objectInfo.second.observedObjects) {
@@ -620,6 +2003,29 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
         }
         objectInfo.second.releaseTable();
     }
+
+    if (_pinnedVersion) {
+        try {
+            [self pinReadTransaction];
+        }
+        catch (std::exception const& ex) {
+            @throw RLMException(ex);
+        }
+    }
+}
+
+// Move the read transaction of a Realm opened with -realmAtVersion:error: to
+// its version. The Realm keeps using the same Group, so ending its transaction
+// and beginning one at the version underneath it is invisible to it.
+- (void)pinReadTransaction {
+    _realm->read_group();
+    auto& sharedGroup = _impl::RealmFriend::get_shared_group(*_realm);
+    sharedGroup.end_read();
+    sharedGroup.begin_read(_pinnedVersion->_versionID);
+    ++_readGeneration;
+    for (auto& objectInfo : _info) {
+        objectInfo.second.releaseTable();
+    }
 }
 
 - (nullable id)resolveThreadSafeReference:(RLMThreadSafeReference *)reference {
@@ -644,6 +2050,10 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
  the database with the temporary one. The name of the temporary file is formed by appending
  `.tmp_compaction_space` to the name of the database.
 
+ There is no incremental alternative: space freed by write transactions is
+ reused by later ones, but the file can only shrink by being rewritten, as
+ core's allocator has no way to move live data away from the end of the file.
+
  @return YES if the compaction succeeded.
  */
 - (BOOL)compact {
@@ -656,6 +2066,7 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
     }
 
     try {
+        RLMSignpost signpost(RLMSignpostName::Compact, [&] { return RLMRealmFileName(self); });
         return _realm->compact();
     }
     catch (std::exception const& ex) {
@@ -663,7 +2074,215 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
     }
 }
 
+- (NSDictionary *)statistics {
+    [self verifyThread];
+
+    NSMutableDictionary *objectCounts = [NSMutableDictionary new];
+    NSUInteger observedObjects = 0;
+    uint64_t version, activeVersions;
+    try {
+        _realm->read_group();
+        auto& sharedGroup = _impl::RealmFriend::get_shared_group(*_realm);
+        version = sharedGroup.get_version_of_current_transaction().version;
+        activeVersions = sharedGroup.get_number_of_versions();
+
+        for (auto& info : _info) {
+            if (auto table = info.second.table()) {
+                objectCounts[info.first] = @(table->size());
+            }
+            observedObjects += info.second.observedObjects.size();
+        }
+    }
+    catch (std::exception const& ex) {
+        @throw RLMException(ex);
+    }
+
+    NSNumber *fileSize = @0;
+    if (!_realm->config().in_memory) {
+        NSString *path = @(_realm->config().path.c_str());
+        fileSize = [NSFileManager.defaultManager attributesOfItemAtPath:path error:nil][NSFileSize] ?: @0;
+    }
+
+    return @{@"fileSize": fileSize,
+             @"version": @(version),
+             @"activeVersions": @(activeVersions),
+             @"objectCounts": objectCounts,
+             @"observedObjects": @(observedObjects),
+             @"notificationBlocks": @(_notificationHandlers.count)};
+}
+
+- (RLMRealmVersion *)currentVersion {
+    [self verifyThread];
+    if (_realm->config().sync_config) {
+        @throw RLMException(@"Cannot get a version token for a synchronized Realm.");
+    }
+    try {
+        _realm->read_group();
+        auto version = _impl::RealmFriend::get_shared_group(*_realm).get_version_of_current_transaction();
+        return [[RLMRealmVersion alloc] initWithConfig:_realm->config() version:version];
+    }
+    catch (std::exception const& ex) {
+        @throw RLMException(ex);
+    }
+}
+
+- (RLMRealm *)realmAtVersion:(RLMRealmVersion *)version error:(NSError **)error {
+    [self verifyThread];
+    if (version->_path != _realm->config().path) {
+        @throw RLMException(@"Version token for the Realm at '%s' cannot be used with the Realm at '%s'.",
+                            version->_path.c_str(), _realm->config().path.c_str());
+    }
+
+    // The Realm is never cached, as it must not be returned when the latest
+    // version is asked for
+    RLMRealmConfiguration *configuration = [self.configuration copy];
+    configuration.cache = false;
+    RLMRealm *realm = [RLMRealm realmWithConfiguration:configuration error:error];
+    if (!realm) {
+        return nil;
+    }
+    realm->_realm->set_auto_refresh(false);
+    realm->_pinnedVersion = version;
+
+    try {
+        [realm pinReadTransaction];
+
+        // The Realm reads with the column indexes of the current schema, so
+        // versions with any other layout can't be read by it
+        auto& group = realm->_realm->read_group();
+        bool schemaMatches = ObjectStore::get_schema_version(group) == realm->_realm->schema_version();
+        for (auto& objectSchema : realm->_realm->schema()) {
+            if (!schemaMatches) {
+                break;
+            }
+            auto table = ObjectStore::table_for_object_type(group, objectSchema.name);
+            if (!table) {
+                schemaMatches = false;
+                break;
+            }
+            for (auto& prop : objectSchema.persisted_properties) {
+                if (table->get_column_index(prop.name) != prop.table_column) {
+                    schemaMatches = false;
+                    break;
+                }
+            }
+        }
+        if (!schemaMatches) {
+            @throw RLMException(@"Version %llu of the Realm at '%s' has a different schema and cannot be opened.",
+                                version->_versionID.version, version->_path.c_str());
+        }
+    }
+    catch (std::exception const& ex) {
+        @throw RLMException(ex);
+    }
+    return realm;
+}
+
+// The primary keys of the objects in the given rows of a table
+static NSMutableOrderedSet *RLMPrimaryKeysInRows(Table const& table, realm::Property const& primaryKey,
+                                                 IndexSet const& rows) {
+    NSMutableOrderedSet *keys = [NSMutableOrderedSet orderedSetWithCapacity:rows.count()];
+    size_t column = table.get_column_index(primaryKey.name);
+    if (column == realm::npos) {
+        return keys;
+    }
+    for (auto row : rows.as_indexes()) {
+        if (row >= table.size() || table.is_null(column, row)) {
+            [keys addObject:NSNull.null];
+        }
+        else if (primaryKey.type == PropertyType::Int) {
+            [keys addObject:@(table.get_int(column, row))];
+        }
+        else {
+            [keys addObject:RLMStringDataToNSString(table.get_string(column, row))];
+        }
+    }
+    return keys;
+}
+
+- (NSDictionary *)changesSinceVersion:(RLMRealmVersion *)version {
+    [self verifyThread];
+    if (version->_path != _realm->config().path) {
+        @throw RLMException(@"Version token for the Realm at '%s' cannot be used with the Realm at '%s'.",
+                            version->_path.c_str(), _realm->config().path.c_str());
+    }
+
+    NSMutableDictionary *changes = [NSMutableDictionary new];
+    @synchronized (version) {
+        try {
+            auto& group = _realm->read_group();
+            auto target = _impl::RealmFriend::get_shared_group(*_realm).get_version_of_current_transaction();
+            if (target < version->_versionID) {
+                @throw RLMException(@"Cannot get the changes since version %llu from a Realm at the older version %llu.",
+                                    version->_versionID.version, target.version);
+            }
+            if (target == version->_versionID) {
+                return changes;
+            }
+
+            // Parse the transaction logs by advancing a second transaction from
+            // the token's version to this Realm's. The token's own transaction
+            // stays where it is, to read the keys of deleted objects from.
+            std::unique_ptr<Replication> history;
+            auto sharedGroup = [version openSharedGroup:history];
+            sharedGroup->begin_read(version->_versionID);
+            _impl::TransactionChangeInfo info;
+            info.track_all = true;
+            _impl::transaction::advance(*sharedGroup, info, target);
+
+            for (auto& objectSchema : _realm->schema()) {
+                auto primaryKey = objectSchema.primary_key_property();
+                auto table = ObjectStore::table_for_object_type(group, objectSchema.name);
+                if (!primaryKey || !table || table->get_index_in_group() >= info.tables.size()) {
+                    continue;
+                }
+                auto& builder = info.tables[table->get_index_in_group()];
+                if (builder.empty()) {
+                    continue;
+                }
+                auto tableChanges = std::move(builder).finalize();
+
+                // Rows moved by deleting the rows before them show up as both
+                // a deletion and an insertion, but aren't changes to the object
+                for (auto const& move : tableChanges.moves) {
+                    tableChanges.deletions.remove(move.from);
+                    tableChanges.insertions.remove(move.to);
+                }
+
+                NSMutableOrderedSet *deleted = [NSMutableOrderedSet orderedSet];
+                if (auto oldTable = ObjectStore::table_for_object_type(*version->_group, objectSchema.name)) {
+                    deleted = RLMPrimaryKeysInRows(*oldTable, *primaryKey, tableChanges.deletions);
+                }
+                NSMutableOrderedSet *inserted = RLMPrimaryKeysInRows(*table, *primaryKey, tableChanges.insertions);
+                NSMutableOrderedSet *modified = RLMPrimaryKeysInRows(*table, *primaryKey, tableChanges.modifications_new);
+                [modified minusOrderedSet:inserted];
+
+                // Objects which are deleted and created again with the same
+                // key are reported as modified
+                NSMutableOrderedSet *recreated = [inserted mutableCopy];
+                [recreated intersectOrderedSet:deleted];
+                [inserted minusOrderedSet:recreated];
+                [deleted minusOrderedSet:recreated];
+                [modified unionOrderedSet:recreated];
+
+                if (inserted.count || modified.count || deleted.count) {
+                    changes[@(objectSchema.name.c_str())] = [[RLMObjectChanges alloc] initWithInserted:inserted.array
+                                                                                              modified:modified.array
+                                                                                               deleted:deleted.array];
+                }
+            }
+        }
+        catch (std::exception const& ex) {
+            @throw RLMException(ex);
+        }
+    }
+    return changes;
+}
+
 - (void)dealloc {
+    for (id observer in _lifecycleObservers) {
+        [NSNotificationCenter.defaultCenter removeObserver:observer];
+    }
     if (_realm) {
         if (_realm->is_in_transaction()) {
             [self cancelWriteTransaction];
@@ -675,6 +2294,9 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
 }
 
 - (BOOL)refresh {
+    if (_pinnedVersion) {
+        return NO;
+    }
     return _realm->refresh();
 }
 
@@ -683,13 +2305,7 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
 }
 
 - (void)addObjects:(id<NSFastEnumeration>)array {
-    for (RLMObject *obj in array) {
-        if (![obj isKindOfClass:[RLMObject class]]) {
-            @throw RLMException(@"Cannot insert objects of type %@ with addObjects:. Only RLMObjects are supported.",
-                                NSStringFromClass(obj.class));
-        }
-        [self addObject:obj];
-    }
+    RLMAddObjectsToRealm(self, array, false);
 }
 
 - (void)addOrUpdateObject:(RLMObject *)object {
@@ -702,9 +2318,16 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
 }
 
 - (void)addOrUpdateObjectsFromArray:(id)array {
-    for (RLMObject *obj in array) {
-        [self addOrUpdateObject:obj];
-    }
+    RLMAddObjectsToRealm(self, array, true);
+}
+
+- (NSArray *)copyObjects:(id<NSFastEnumeration>)objects fromRealm:(RLMRealm *)realm options:(RLMCopyOptions)options {
+    return RLMCopyObjectsFromRealm(self, realm, objects, options & RLMCopyOptionsUpdateExisting);
+}
+
+- (BOOL)appendColumns:(NSDictionary<NSString *, RLMColumnBuffer *> *)columns toClass:(NSString *)className
+             rowCount:(NSUInteger)rowCount error:(NSError **)error {
+    return RLMAppendColumnsToRealm(self, className, columns, rowCount, error);
 }
 
 - (void)deleteObject:(RLMObject *)object {
@@ -719,11 +2342,7 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
         [array deleteObjectsFromRealm];
     }
     else if ([array conformsToProtocol:@protocol(NSFastEnumeration)]) {
-        for (id obj in array) {
-            if ([obj isKindOfClass:RLMObjectBase.class]) {
-                RLMDeleteObjectFromRealm(obj, self);
-            }
-        }
+        RLMDeleteObjectsFromRealm(self, array);
     }
     else {
         @throw RLMException(@"Invalid array type - container must be an RLMArray, RLMArray, or NSArray of RLMObjects");
@@ -754,17 +2373,69 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
     return RLMGetObjects(self, objectClassName, predicate);
 }
 
+- (RLMPreparedQuery *)prepareQuery:(NSString *)predicateFormat forClass:(NSString *)className {
+    [self verifyThread];
+    // validate the class name
+    _info[className];
+    return [[RLMPreparedQuery alloc] initWithRealm:self className:className predicateFormat:predicateFormat];
+}
+
 - (RLMObject *)objectWithClassName:(NSString *)className forPrimaryKey:(id)primaryKey {
     return RLMGetObject(self, className, primaryKey);
 }
 
+// Read the schema version of the file at `path` by mapping it as a standalone
+// group, which reads only its header and metadata table and doesn't set up the
+// shared group or a coordinator for the file. Returns false if it can't be read
+// this way, in which case the file should be opened normally to read it or to
+// report why it can't be.
+static bool RLMReadSchemaVersionFromFile(std::string const& path, NSData *key, uint64_t& version) {
+    // A Realm which is open in this process may be migrating the file, so
+    // read it through the shared group like the Realm does
+    if (RLMGetAnyCachedRealmForPath(path)) {
+        return false;
+    }
+
+    // A standalone group isn't registered as a reader, so a writer in another
+    // process (such as an app extension) could reuse the pages it's reading.
+    // Every session holds a shared lock on the lock file for as long as it's
+    // open, so the file is only read this way if an exclusive lock can be
+    // taken without waiting, which is held until it has been read and keeps
+    // any session from opening in the meantime.
+    int fd = open((path + ".lock").c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    int locked;
+    while ((locked = flock(fd, LOCK_EX | LOCK_NB)) != 0 && errno == EINTR);
+    if (locked != 0) {
+        close(fd);
+        return false;
+    }
+
+    bool read = false;
+    try {
+        Group group(path, static_cast<const char *>(key.bytes), Group::mode_ReadOnly);
+        version = ObjectStore::get_schema_version(group);
+        read = true;
+    }
+    catch (std::exception const&) {
+    }
+    flock(fd, LOCK_UN);
+    close(fd);
+    return read;
+}
+
 + (uint64_t)schemaVersionAtURL:(NSURL *)fileURL encryptionKey:(NSData *)key error:(NSError **)error {
     try {
         RLMRealmConfiguration *config = [[RLMRealmConfiguration alloc] init];
         config.fileURL = fileURL;
         config.encryptionKey = RLMRealmValidatedEncryptionKey(key);
 
-        uint64_t version = Realm::get_schema_version(config.config);
+        uint64_t version;
+        if (!RLMReadSchemaVersionFromFile(config.config.path, config.encryptionKey, version)) {
+            version = Realm::get_schema_version(config.config);
+        }
         if (version == realm::ObjectStore::NotVersioned) {
             RLMSetErrorOrThrow([NSError errorWithDomain:RLMErrorDomain code:RLMErrorFail userInfo:@{NSLocalizedDescriptionKey:@"Cannot open an uninitialized realm in read-only mode"}], error);
         }
@@ -800,7 +2471,50 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
 }
 
 - (RLMObject *)createObject:(NSString *)className withValue:(id)value {
-    return (RLMObject *)RLMCreateObjectInRealmWithValue(self, className, value, false);
+    return (RLMObject *)RLMCreateObjectInRealmWithValue(self, className, value, RLMCreationOptionsNone);
+}
+
+static BOOL RLMCreateObjects(RLMRealm *realm, NSString *className, id<NSFastEnumeration> values,
+                             RLMCreationOptions options, NSError **error) {
+    NSError *localError;
+    RLMCreateObjectsInRealmWithValues(realm, className, values, options, false, nullptr, nullptr, &localError);
+    if (localError) {
+        RLMSetErrorOrThrow(localError, error);
+        return NO;
+    }
+    return YES;
+}
+
+- (BOOL)createObjects:(NSString *)className withValues:(id<NSFastEnumeration>)values error:(NSError **)error {
+    return RLMCreateObjects(self, className, values, RLMCreationOptionsNone, error);
+}
+
+- (BOOL)createObjects:(NSString *)className withTrustedValues:(id<NSFastEnumeration>)values error:(NSError **)error {
+    return RLMCreateObjects(self, className, values, RLMCreationOptionsSkipValidation, error);
+}
+
+- (void)addPreparedObjects:(RLMPreparedObjects *)objects {
+    RLMAddPreparedObjects(self, objects);
+}
+
+- (void)createOrUpdateObjects:(NSString *)className
+                   withValues:(id<NSFastEnumeration>)values
+                insertedCount:(NSUInteger *)insertedCount
+                 updatedCount:(NSUInteger *)updatedCount {
+    RLMCreateObjectsInRealmWithValues(self, className, values, RLMCreationOptionsCreateOrUpdate, false,
+                                      insertedCount, updatedCount, nullptr);
+}
+
+- (BOOL)importJSONFromStream:(NSInputStream *)stream
+                   className:(NSString *)className
+                     options:(NSDictionary<RLMJSONImportOption, id> *)options
+                       error:(NSError **)error {
+    RLMCreationOptions creationOptions = RLMCreationOptionsNone;
+    if ([options[RLMJSONImportOptionUpdate] boolValue]) {
+        creationOptions |= RLMCreationOptionsCreateOrUpdate;
+    }
+    NSUInteger commitInterval = [options[RLMJSONImportOptionCommitInterval] unsignedIntegerValue];
+    return RLMImportJSONFromStream(self, className, stream, creationOptions, commitInterval, error);
 }
 
 - (BOOL)writeCopyToURL:(NSURL *)fileURL encryptionKey:(NSData *)key error:(NSError **)error {
@@ -823,6 +2537,113 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
     return NO;
 }
 
+namespace {
+// Writes to an NSOutputStream in large chunks, reporting the total number of
+// bytes written after each one
+class RLMOutputStreamBuffer : public std::streambuf {
+public:
+    RLMOutputStreamBuffer(NSOutputStream *stream, void (^progress)(NSUInteger))
+    : _stream(stream), _progress(progress), _buffer(1024 * 1024)
+    {
+        setp(_buffer.data(), _buffer.data() + _buffer.size());
+    }
+
+    bool failed() const { return _failed; }
+
+protected:
+    int_type overflow(int_type c) override {
+        if (!flush()) {
+            return traits_type::eof();
+        }
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(c);
+            pbump(1);
+        }
+        return traits_type::not_eof(c);
+    }
+
+    int sync() override {
+        return flush() ? 0 : -1;
+    }
+
+private:
+    NSOutputStream *_stream;
+    void (^_progress)(NSUInteger);
+    std::vector<char> _buffer;
+    NSUInteger _bytesWritten = 0;
+    bool _failed = false;
+
+    bool flush() {
+        if (_failed) {
+            return false;
+        }
+        auto data = reinterpret_cast<const uint8_t *>(pbase());
+        size_t size = pptr() - pbase();
+        if (size == 0) {
+            return true;
+        }
+        while (size) {
+            NSInteger written = [_stream write:data maxLength:size];
+            if (written <= 0) {
+                _failed = true;
+                return false;
+            }
+            data += written;
+            size -= written;
+            _bytesWritten += written;
+        }
+        setp(_buffer.data(), _buffer.data() + _buffer.size());
+        if (_progress) {
+            _progress(_bytesWritten);
+        }
+        return true;
+    }
+};
+} // anonymous namespace
+
+- (void)writeCopyToStream:(NSOutputStream *)stream
+            callbackQueue:(dispatch_queue_t)callbackQueue
+                 progress:(void (^)(NSUInteger))progress
+               completion:(void (^)(NSError *))completion {
+    [self verifyThread];
+    RLMRealmConfiguration *configuration = self.configuration;
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        NSError *error = nil;
+        @autoreleasepool {
+            bool openedStream = stream.streamStatus == NSStreamStatusNotOpen;
+            if (openedStream) {
+                [stream open];
+            }
+
+            RLMOutputStreamBuffer buffer(stream, progress ? ^(NSUInteger bytesWritten) {
+                dispatch_async(callbackQueue, ^{
+                    progress(bytesWritten);
+                });
+            } : nil);
+            if (RLMRealm *realm = [RLMRealm realmWithConfiguration:configuration error:&error]) {
+                try {
+                    std::ostream out(&buffer);
+                    realm->_realm->read_group().write(out);
+                    out.flush();
+                    if (buffer.failed() || !out) {
+                        error = stream.streamError ?: RLMMakeError(RLMErrorFail, std::runtime_error("Failed to write to the output stream"));
+                    }
+                }
+                catch (std::exception const& e) {
+                    error = stream.streamError ?: RLMMakeError(RLMErrorFail, e);
+                }
+            }
+
+            if (openedStream) {
+                [stream close];
+            }
+        }
+        dispatch_async(callbackQueue, ^{
+            completion(error);
+        });
+    });
+}
+
 - (void)registerEnumerator:(RLMFastEnumerator *)enumerator {
     if (!_collectionEnumerators) {
         _collectionEnumerators = [NSHashTable hashTableWithOptions:NSPointerFunctionsWeakMemory];
@@ -841,4 +2662,205 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
     _collectionEnumerators = nil;
 }
 
+- (void)registerMappedValue:(id)value {
+    if (!_mappedValues) {
+        _mappedValues = [NSHashTable hashTableWithOptions:NSPointerFunctionsWeakMemory];
+    }
+    [_mappedValues addObject:value];
+}
+
+- (void)detachAllMappedValues {
+    for (id value in _mappedValues) {
+        [value detach];
+    }
+    _mappedValues = nil;
+}
+
+@end
+
+@interface RLMWriteQueue ()
+- (instancetype)initWithConfiguration:(RLMRealmConfiguration *)configuration;
+@end
+
+@implementation RLMWriteQueue {
+    RLMRealmConfiguration *_configuration;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::vector<RLMAsyncWrite> _pending;
+    bool _running;
+}
+
+- (instancetype)initWithConfiguration:(RLMRealmConfiguration *)configuration {
+    if ((self = [super init])) {
+        _configuration = [configuration copy];
+        _maximumWritesPerTransaction = 1000;
+        _completionQueue = dispatch_get_main_queue();
+    }
+    return self;
+}
+
+- (void)enqueueWrite:(void (^)(RLMRealm *))block completion:(void (^)(NSError *))completion {
+    if (!block) {
+        @throw RLMException(@"The write block should not be nil");
+    }
+    dispatch_queue_t completionQueue = self.completionQueue;
+    RLMAsyncWrite write{block, ^(NSError *error) {
+        if (completion) {
+            dispatch_async(completionQueue, ^{
+                completion(error);
+            });
+        }
+    }};
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _pending.push_back(write);
+    _condition.notify_all();
+
+    // The thread is started by the first write and stops once the queue has
+    // drained, so that its Realm doesn't stay open between bursts of writes
+    if (!_running) {
+        _running = true;
+        NSThread *thread = [[NSThread alloc] initWithTarget:self selector:@selector(run) object:nil];
+        thread.name = [NSString stringWithFormat:@"io.realm.writeQueue %@", _configuration.pathOnDisk.lastPathComponent];
+        thread.qualityOfService = NSQualityOfServiceUtility;
+        [thread start];
+    }
+}
+
+- (void)waitUntilAllWritesAreFinished {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _condition.wait(lock, [&] { return _pending.empty() && !_running; });
+}
+
+- (void)run {
+    RLMRealm *realm;
+    while (true) {
+        std::vector<RLMAsyncWrite> writes;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (_pending.empty()) {
+                // Close the Realm before reporting that the queue has
+                // drained, so that the file can then be deleted or compacted,
+                // and check for writes enqueued in the meantime afterwards
+                if (realm) {
+                    lock.unlock();
+                    realm = nil;
+                    continue;
+                }
+                _running = false;
+                _condition.notify_all();
+                return;
+            }
+            NSUInteger maximum = std::max<NSUInteger>(self.maximumWritesPerTransaction, 1);
+            NSTimeInterval interval = _configuration.asyncWriteGroupingInterval;
+            if (interval > 0) {
+                _condition.wait_for(lock, std::chrono::duration<double>(interval),
+                                    [&] { return _pending.size() >= maximum; });
+            }
+            size_t count = std::min<size_t>(_pending.size(), maximum);
+            writes.assign(_pending.begin(), _pending.begin() + count);
+            _pending.erase(_pending.begin(), _pending.begin() + count);
+        }
+
+        @autoreleasepool {
+            NSError *error = nil;
+            if (!realm) {
+                realm = [RLMRealm realmWithConfiguration:_configuration error:&error];
+            }
+            if (realm) {
+                RLMPerformWritesInRealm(realm, writes);
+            }
+            else {
+                for (auto& write : writes) {
+                    write.finished(error);
+                }
+            }
+        }
+    }
+}
+
+@end
+
+RLMWriteQueue *RLMWriteQueueForConfiguration(RLMRealmConfiguration *configuration) {
+    static std::mutex s_writeQueueMutex;
+    static NSMutableDictionary<NSString *, RLMWriteQueue *> *s_writeQueues = [NSMutableDictionary new];
+
+    std::lock_guard<std::mutex> lock(s_writeQueueMutex);
+    NSString *path = configuration.pathOnDisk;
+    RLMWriteQueue *queue = s_writeQueues[path];
+    if (!queue) {
+        queue = [[RLMWriteQueue alloc] initWithConfiguration:configuration];
+        s_writeQueues[path] = queue;
+    }
+    return queue;
+}
+
+@implementation RLMPreparedQuery {
+    RLMRealm *_realm;
+    NSPredicate *_predicate;
+}
+
+static NSString *preparedQueryVariableName(NSUInteger index) {
+    return [NSString stringWithFormat:@"RLMArgument%lu", (unsigned long)index];
+}
+
+- (instancetype)initWithRealm:(RLMRealm *)realm className:(NSString *)className predicateFormat:(NSString *)format {
+    self = [super init];
+    if (self) {
+        _realm = realm;
+        _className = [className copy];
+
+        // NSPredicate variable names can't start with a digit, so rewrite the
+        // `$0` placeholders outside of string literals into valid variables
+        NSMutableString *rewritten = [NSMutableString stringWithCapacity:format.length];
+        NSUInteger length = format.length;
+        auto isDigitAt = [&](NSUInteger i) {
+            unichar c = [format characterAtIndex:i];
+            return c >= '0' && c <= '9';
+        };
+        unichar quote = 0;
+        for (NSUInteger i = 0; i < length; ++i) {
+            unichar c = [format characterAtIndex:i];
+            if (quote) {
+                if (c == '\\' && i + 1 < length) {
+                    [rewritten appendFormat:@"%C%C", c, [format characterAtIndex:++i]];
+                    continue;
+                }
+                if (c == quote) {
+                    quote = 0;
+                }
+            }
+            else if (c == '"' || c == '\'') {
+                quote = c;
+            }
+            else if (c == '$' && i + 1 < length && isDigitAt(i + 1)) {
+                NSUInteger index = 0;
+                while (i + 1 < length && isDigitAt(i + 1)) {
+                    index = index * 10 + ([format characterAtIndex:++i] - '0');
+                }
+                _argumentCount = std::max(_argumentCount, index + 1);
+                [rewritten appendFormat:@"$%@", preparedQueryVariableName(index)];
+                continue;
+            }
+            [rewritten appendFormat:@"%C", c];
+        }
+
+        _predicate = [NSPredicate predicateWithFormat:rewritten argumentArray:nil];
+    }
+    return self;
+}
+
+- (RLMResults *)resultsWithArguments:(NSArray *)arguments {
+    if (arguments.count != _argumentCount) {
+        @throw RLMException(@"Prepared query for '%@' requires %lu arguments, but %lu were given.",
+                            _className, (unsigned long)_argumentCount, (unsigned long)arguments.count);
+    }
+
+    NSMutableDictionary *variables = [NSMutableDictionary dictionaryWithCapacity:_argumentCount];
+    for (NSUInteger i = 0; i < _argumentCount; ++i) {
+        variables[preparedQueryVariableName(i)] = arguments[i];
+    }
+    return RLMGetObjects(_realm, _className, [_predicate predicateWithSubstitutionVariables:variables]);
+}
+
 @end
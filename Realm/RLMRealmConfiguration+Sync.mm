@@ -42,14 +42,15 @@
     }
 
     NSURL *realmURL = syncConfiguration.realmURL;
-    // Ensure sync manager is initialized, if it hasn't already been.
-    [RLMSyncManager sharedManager];
+    // Ensure sync manager is initialized and its file system configured, if it
+    // hasn't already been.
+    auto& syncManager = configured_sync_manager();
     NSAssert(user.identity, @"Cannot call this method on a user that doesn't have an identity.");
     if (syncConfiguration.customFileURL) {
         self.config.path = syncConfiguration.customFileURL.path.UTF8String;
     } else {
-        self.config.path = SyncManager::shared().path_for_realm([user.identity UTF8String],
-                                                                [realmURL.absoluteString UTF8String]);
+        self.config.path = syncManager.path_for_realm([user.identity UTF8String],
+                                                      [realmURL.absoluteString UTF8String]);
     }
     self.config.in_memory = false;
     self.config.sync_config = std::make_shared<realm::SyncConfig>([syncConfiguration rawConfiguration]);
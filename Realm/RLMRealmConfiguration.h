@@ -32,6 +32,55 @@ NS_ASSUME_NONNULL_BEGIN
  */
 typedef BOOL (^RLMShouldCompactOnLaunchBlock)(NSUInteger totalBytes, NSUInteger bytesUsed);
 
+/**
+ The kinds of operations reported to the `slowOperationHandler` of an
+ `RLMRealmConfiguration`.
+ */
+typedef NS_ENUM(NSInteger, RLMSlowOperation) {
+    /// Evaluating the query of an `RLMResults`, including sorting the results.
+    RLMSlowOperationQuery,
+    /// A write transaction, from beginning it until it was committed.
+    RLMSlowOperationWriteTransaction,
+    /// A stage of delivering change notifications.
+    RLMSlowOperationNotification,
+};
+
+/**
+ A block called when an operation on a Realm took longer than the
+ `slowOperationThreshold` of its configuration.
+
+ `details` always contains the `realmPath` of the Realm, and depending on the
+ kind of operation:
+
+ - `RLMSlowOperationQuery`: the `className` of the objects queried, the
+   `predicate` format of the conditions the results were filtered with, if
+   any, the `sortDescriptors` as an array of key paths prefixed with `+` or `-`
+   for their direction, and the `rowCount` of objects of the class the query
+   was evaluated against.
+ - `RLMSlowOperationWriteTransaction`: the `commitTime` in seconds, which is
+   the part of `duration` spent committing the transaction.
+ - `RLMSlowOperationNotification`: the `RLMNotificationStage` as the `stage`.
+
+ @param operation The kind of operation.
+ @param details   A description of the operation.
+ @param duration  The time the operation took, in seconds.
+ */
+typedef void (^RLMSlowOperationBlock)(RLMSlowOperation operation, NSDictionary<NSString *, id> *details, NSTimeInterval duration);
+
+/**
+ A block called when a Realm has kept reading the same version of its file for
+ longer than the `longReadTransactionThreshold` of its configuration while a
+ newer version has been committed.
+
+ `details` contains the `realmPath` of the Realm and the `threadName` of the
+ thread it was opened on. In debug builds it also contains the `backtrace` of
+ the call which opened the Realm, as an array of strings.
+
+ @param details A description of the Realm.
+ @param age     How long the Realm has been reading the version, in seconds.
+ */
+typedef void (^RLMLongReadTransactionBlock)(NSDictionary<NSString *, id> *details, NSTimeInterval age);
+
 /**
  An `RLMRealmConfiguration` instance describes the different options used to
  create an instance of a Realm.
@@ -70,9 +119,28 @@ typedef BOOL (^RLMShouldCompactOnLaunchBlock)(NSUInteger totalBytes, NSUInteger
 @property (nonatomic, copy, nullable) NSURL *fileURL;
 
 /// A string used to identify a particular in-memory Realm. Mutually exclusive with `fileURL`.
+///
+/// Commits to in-memory Realms are never synced to disk, which makes them
+/// much cheaper than commits to file-backed Realms, so they're a good fit for
+/// data such as caches which doesn't need to outlive the process. To keep a
+/// snapshot of an in-memory Realm, write a copy of it to a file with
+/// `-[RLMRealm writeCopyToURL:encryptionKey:error:]`, which can then be opened
+/// as a file-backed Realm.
 @property (nonatomic, copy, nullable) NSString *inMemoryIdentifier;
 
 /// A 64-byte key to use to encrypt the data, or `nil` if encryption is not enabled.
+///
+/// Encrypted Realms are decrypted a page at a time as the pages are first
+/// read, so reading many objects from an encrypted Realm which hasn't been
+/// read recently is noticeably slower than from an unencrypted one. Use
+/// `-[RLMResults prefetchOnQueue:completion:]` to do that work in the
+/// background before large scans.
+///
+/// Committing a write transaction encrypts each page it changed on the
+/// committing thread, so the commit of a large import takes time proportional
+/// to the number of pages written. Import from a background thread, and split
+/// very large imports into several write transactions so that other threads
+/// waiting to write aren't blocked for the whole import.
 @property (nonatomic, copy, nullable) NSData *encryptionKey;
 
 /// Whether to open the Realm in read-only mode.
@@ -86,12 +154,29 @@ typedef BOOL (^RLMShouldCompactOnLaunchBlock)(NSUInteger totalBytes, NSUInteger
 /// result in crashes.
 @property (nonatomic) BOOL readOnly;
 
+/// The URL of a read-only Realm file, such as one bundled with the app, to
+/// use as the initial contents of the Realm at `fileURL`.
+///
+/// When the Realm is opened and no file exists at `fileURL` yet, the seed file
+/// is cloned to that location first. On filesystems which support it (APFS)
+/// the clone shares the seed's data blocks copy-on-write, so opening is
+/// constant-time regardless of the size of the seed, and only pages which are
+/// subsequently modified consume additional disk space. On other filesystems
+/// the seed is copied. The seed file itself is never modified.
+///
+/// Ignored for in-memory and synchronized Realms.
+@property (nonatomic, copy, nullable) NSURL *seedFileURL;
+
 /// The current schema version.
 @property (nonatomic) uint64_t schemaVersion;
 
 /// The block which migrates the Realm to the current version.
 @property (nonatomic, copy, nullable) RLMMigrationBlock migrationBlock;
 
+/// A block which is called periodically while the migration block processes
+/// objects, so that the progress of long migrations can be displayed.
+@property (nonatomic, copy, nullable) RLMMigrationProgressBlock migrationProgressBlock;
+
 /**
  Whether to recreate the Realm file with the provided schema if a migration is required.
  This is the case when the stored schema differs from the provided schema or
@@ -113,9 +198,169 @@ typedef BOOL (^RLMShouldCompactOnLaunchBlock)(NSUInteger totalBytes, NSUInteger
  */
 @property (nonatomic, copy, nullable) RLMShouldCompactOnLaunchBlock shouldCompactOnLaunch;
 
+/**
+ Returns a block for `shouldCompactOnLaunch` which compacts the file when it is
+ at least the given size and the data in it takes up less than the given
+ fraction of it.
+
+     configuration.shouldCompactOnLaunch =
+         [RLMRealmConfiguration shouldCompactOnLaunchBlockWithMinimumFileSize:100 * 1024 * 1024
+                                                          maximumUsedFraction:0.5];
+
+ Compacting a large file can take some time, so open Realms using such a
+ configuration with `+[RLMRealm asyncOpenWithConfiguration:callbackQueue:callback:]`
+ to compact them on a background queue.
+
+ @param minimumFileSize     The size in bytes below which the file is never compacted.
+ @param maximumUsedFraction The fraction of the file, between 0 and 1, which must
+                            be in use for the file not to be compacted.
+
+ @return A block to assign to `shouldCompactOnLaunch`.
+ */
++ (RLMShouldCompactOnLaunchBlock)shouldCompactOnLaunchBlockWithMinimumFileSize:(NSUInteger)minimumFileSize
+                                                          maximumUsedFraction:(double)maximumUsedFraction;
+
+/**
+ How long asynchronous write transactions begun with
+ `-[RLMRealm beginAsyncWriteTransaction:completion:]` wait for further
+ asynchronous writes to the same file, in seconds.
+
+ If this is greater than zero, asynchronous writes begun within this interval
+ of each other are performed together in a single write transaction, so that
+ many small writes share one commit rather than each paying for their own. If
+ one of the writes in a group cancels the transaction, only its own changes are
+ discarded: the writes before it in the group are performed again in a new
+ transaction along with the remaining writes.
+
+ Defaults to `0`, which performs each asynchronous write in its own
+ transaction as soon as possible.
+ */
+@property (nonatomic) NSTimeInterval asyncWriteGroupingInterval;
+
+/**
+ The quality of service of the background thread which computes the changes
+ reported to collection notification blocks for the Realm file.
+
+ Each Realm file has a single such thread per process, which is started when
+ the file is first opened and takes its quality of service from the thread
+ which opened it, so this only has an effect when it is set on the
+ configuration which first opens the file in the process. Choosing
+ `NSQualityOfServiceUtility` or `NSQualityOfServiceBackground` keeps heavy
+ recalculation after large writes from competing with user-initiated work.
+
+ Defaults to `NSQualityOfServiceDefault`, which uses the quality of service of
+ the thread which opens the file.
+ */
+@property (nonatomic) NSQualityOfService notificationQualityOfService;
+
+/**
+ A block called whenever evaluating a query, a write transaction, or a stage of
+ delivering notifications on a Realm opened with this configuration takes
+ longer than `slowOperationThreshold`, for collecting performance telemetry
+ without instrumenting each call site.
+
+ The block is called synchronously on the thread which performed the
+ operation, after it has completed, and so should do as little work as
+ possible. Operations performed by the block itself are not reported.
+
+ The block is read when a Realm is first opened on a thread, so changing it
+ has no effect on Realms which are already open on that thread.
+
+ Defaults to `nil`, in which case no operations are timed.
+ */
+@property (nonatomic, copy, nullable) RLMSlowOperationBlock slowOperationHandler;
+
+/**
+ The duration in seconds above which operations are reported to
+ `slowOperationHandler`.
+
+ Defaults to `0.1`.
+ */
+@property (nonatomic) NSTimeInterval slowOperationThreshold;
+
+/**
+ A block called when a Realm opened with this configuration has been reading the
+ same version of the file for longer than `longReadTransactionThreshold` while a
+ newer version has been committed in this process.
+
+ Every version which is being read by a Realm is kept in the file, along with
+ all of the data changed since it, so a Realm which is never refreshed, such as
+ one left open on a background thread or in the middle of an enumeration, makes
+ the file grow with every write transaction.
+
+ The block is called on a background queue, at most once for each version a
+ Realm reads. The Realm must not be used from the block.
+
+ Defaults to `nil`, in which case the versions read aren't tracked.
+ */
+@property (nonatomic, copy, nullable) RLMLongReadTransactionBlock longReadTransactionHandler;
+
+/**
+ The time in seconds after which a Realm still reading an outdated version is
+ reported to `longReadTransactionHandler`.
+
+ Defaults to `60`.
+ */
+@property (nonatomic) NSTimeInterval longReadTransactionThreshold;
+
+/**
+ Whether Realms which are reported to `longReadTransactionHandler` should be
+ refreshed if they have `autorefresh` enabled and aren't in a write transaction.
+
+ The Realm is refreshed from the run loop of the thread it was opened on, so
+ this has no effect on Realms opened on threads without a run loop.
+
+ Defaults to `NO`.
+ */
+@property (nonatomic) BOOL advancesLongReadTransactions;
+
 /// The classes managed by the Realm.
 @property (nonatomic, copy, nullable) NSArray *objectClasses;
 
+/**
+ The write queue for the Realm file this configuration opens, which performs
+ write transactions on a dedicated background thread.
+
+ There is one queue per file, shared by every configuration which opens the
+ file, and it is created the first time it is requested. The queue's thread
+ opens the Realm with the configuration used to request the queue the first
+ time. Write queues cannot be used with read-only Realms.
+ */
+@property (nonatomic, readonly) RLMWriteQueue *writeQueue;
+
+/**
+ Returns a copy of the configuration which opens one shard of a dataset split
+ across several Realm files, so that each file can be compacted, backed up and
+ refreshed on its own.
+
+ Shard `n` of a configuration whose file is `data.realm` is stored in
+ `data.shard-n.realm` in the same directory, and shard `n` of an in-memory Realm
+ uses the configuration's identifier followed by `.shard-n`. Objects should be
+ stored in the shard returned by `+shardForKey:shardCount:` for their key, and
+ the shards queried together with
+ `+[RLMObject objectsInRealms:withPredicate:sortDescriptors:]`.
+
+ @param shard   The index of the shard.
+
+ @return A configuration which opens the given shard.
+ */
+- (instancetype)configurationForShard:(NSUInteger)shard;
+
+/**
+ Returns the index of the shard which objects with the given key belong in when
+ a dataset is split across the given number of shards.
+
+ The shard depends only on the key and the number of shards, so it is the same
+ in every process and on every device. Only `NSString` and integer `NSNumber`
+ keys are supported.
+
+ @param key         The key, such as the primary key of the object.
+ @param shardCount  The number of shards.
+
+ @return The index of a shard, less than `shardCount`.
+ */
++ (NSUInteger)shardForKey:(id)key shardCount:(NSUInteger)shardCount;
+
 @end
 
 NS_ASSUME_NONNULL_END
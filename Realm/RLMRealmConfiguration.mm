@@ -32,10 +32,19 @@ static NSString *const c_RLMRealmConfigurationProperties[] = {
     @"inMemoryIdentifier",
     @"encryptionKey",
     @"readOnly",
+    @"seedFileURL",
     @"schemaVersion",
     @"migrationBlock",
+    @"migrationProgressBlock",
     @"deleteRealmIfMigrationNeeded",
     @"shouldCompactOnLaunch",
+    @"asyncWriteGroupingInterval",
+    @"notificationQualityOfService",
+    @"slowOperationHandler",
+    @"slowOperationThreshold",
+    @"longReadTransactionHandler",
+    @"longReadTransactionThreshold",
+    @"advancesLongReadTransactions",
     @"dynamic",
     @"customSchema",
 };
@@ -96,6 +105,9 @@ NSString *RLMRealmPathForFile(NSString *fileName) {
         self.fileURL = defaultRealmURL;
         self.schemaVersion = 0;
         self.cache = YES;
+        self.slowOperationThreshold = 0.1;
+        self.longReadTransactionThreshold = 60;
+        self.notificationQualityOfService = NSQualityOfServiceDefault;
 
         // We have our own caching of RLMRealm instances, so the ObjectStore
         // cache is at best pointless, and may result in broken behavior when
@@ -114,8 +126,17 @@ NSString *RLMRealmPathForFile(NSString *fileName) {
     configuration->_cache = _cache;
     configuration->_dynamic = _dynamic;
     configuration->_migrationBlock = _migrationBlock;
+    configuration->_migrationProgressBlock = _migrationProgressBlock;
     configuration->_shouldCompactOnLaunch = _shouldCompactOnLaunch;
+    configuration->_asyncWriteGroupingInterval = _asyncWriteGroupingInterval;
+    configuration->_notificationQualityOfService = _notificationQualityOfService;
+    configuration->_slowOperationHandler = _slowOperationHandler;
+    configuration->_slowOperationThreshold = _slowOperationThreshold;
+    configuration->_longReadTransactionHandler = _longReadTransactionHandler;
+    configuration->_longReadTransactionThreshold = _longReadTransactionThreshold;
+    configuration->_advancesLongReadTransactions = _advancesLongReadTransactions;
     configuration->_customSchema = _customSchema;
+    configuration->_seedFileURL = _seedFileURL;
     return configuration;
 }
 
@@ -279,6 +300,74 @@ static void RLMNSStringToStdString(std::string &out, NSString *in) {
     return @(_config.path.c_str());
 }
 
+- (RLMWriteQueue *)writeQueue {
+    if (self.readOnly) {
+        @throw RLMException(@"Can't perform transactions on read-only Realms.");
+    }
+    return RLMWriteQueueForConfiguration(self);
+}
+
+- (instancetype)configurationForShard:(NSUInteger)shard {
+    if (_config.sync_config) {
+        @throw RLMException(@"Cannot shard a Realm which has a `syncConfiguration`.");
+    }
+    RLMRealmConfiguration *configuration = [self copy];
+    NSString *suffix = [NSString stringWithFormat:@"shard-%llu", (unsigned long long)shard];
+    if (_config.in_memory) {
+        configuration.inMemoryIdentifier = [self.inMemoryIdentifier stringByAppendingPathExtension:suffix];
+    }
+    else {
+        NSURL *fileURL = self.fileURL;
+        NSString *extension = fileURL.pathExtension;
+        fileURL = [fileURL.URLByDeletingPathExtension URLByAppendingPathExtension:suffix];
+        configuration.fileURL = extension.length ? [fileURL URLByAppendingPathExtension:extension] : fileURL;
+    }
+    return configuration;
+}
+
++ (NSUInteger)shardForKey:(id)key shardCount:(NSUInteger)shardCount {
+    if (shardCount == 0) {
+        @throw RLMException(@"Shard count must be greater than zero.");
+    }
+
+    // FNV-1a, as NSObject's -hash isn't guaranteed to be the same in every
+    // process, and a key's shard has to be
+    uint64_t hash = 14695981039346656037ULL;
+    auto add = [&](const void *bytes, size_t length) {
+        for (size_t i = 0; i < length; ++i) {
+            hash = (hash ^ static_cast<const uint8_t *>(bytes)[i]) * 1099511628211ULL;
+        }
+    };
+    NSNumber *number = RLMDynamicCast<NSNumber>(key);
+    if (NSString *string = RLMDynamicCast<NSString>(key)) {
+        auto str = RLMStringDataWithNSString(string);
+        add(str.data(), str.size());
+    }
+    else if (number && number.objCType[0] != *@encode(float) && number.objCType[0] != *@encode(double)) {
+        int64_t value = number.longLongValue;
+        uint8_t bytes[sizeof(value)];
+        for (size_t i = 0; i < sizeof(value); ++i) {
+            bytes[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+        add(bytes, sizeof(bytes));
+    }
+    else {
+        @throw RLMException(@"Invalid shard key '%@' of type '%@': only strings and integers are supported.",
+                            key, [key class]);
+    }
+    return static_cast<NSUInteger>(hash % shardCount);
+}
+
++ (RLMShouldCompactOnLaunchBlock)shouldCompactOnLaunchBlockWithMinimumFileSize:(NSUInteger)minimumFileSize
+                                                          maximumUsedFraction:(double)maximumUsedFraction {
+    if (!(maximumUsedFraction > 0 && maximumUsedFraction <= 1)) {
+        @throw RLMException(@"Maximum used fraction must be between 0 and 1, but was %f.", maximumUsedFraction);
+    }
+    return ^BOOL(NSUInteger totalBytes, NSUInteger usedBytes) {
+        return totalBytes >= minimumFileSize && (double)usedBytes / totalBytes < maximumUsedFraction;
+    };
+}
+
 - (void)setShouldCompactOnLaunch:(RLMShouldCompactOnLaunchBlock)shouldCompactOnLaunch {
     if (shouldCompactOnLaunch) {
         if (self.readOnly) {
@@ -17,6 +17,9 @@
 ////////////////////////////////////////////////////////////////////////////
 
 #import <Foundation/Foundation.h>
+#import <Realm/RLMRealm.h>
+
+#import <chrono>
 #import <memory>
 #import <string>
 
@@ -32,7 +35,53 @@ void RLMCacheRealm(std::string const& path, RLMRealm *realm);
 RLMRealm *RLMGetThreadLocalCachedRealmForPath(std::string const& path);
 // Get a Realm for the given path
 RLMRealm *RLMGetAnyCachedRealmForPath(std::string const& path);
+// Get all of the Realms in the weak cache which were opened on the current thread
+NSArray<RLMRealm *> *RLMGetThreadLocalCachedRealms();
 // Clear the weak cache of Realms
 void RLMClearRealmCache();
 
 std::unique_ptr<realm::BindingContext> RLMCreateBindingContext(RLMRealm *realm);
+
+void RLMSetNotificationTimingBlock(RLMNotificationTimingBlock block);
+
+// Times a stage of delivering notifications from construction until end() is
+// called or the object is destroyed, and reports it to the notification
+// timing block, the slow operation handler of the Realm's configuration, and
+// as an os_signpost interval. Does nothing if none of them are enabled when
+// it's constructed.
+class RLMNotificationInterval {
+public:
+    RLMNotificationInterval(RLMNotificationStage stage, RLMRealm *realm);
+    ~RLMNotificationInterval() { end(); }
+    void end();
+
+    RLMNotificationInterval(RLMNotificationInterval const&) = delete;
+    RLMNotificationInterval& operator=(RLMNotificationInterval const&) = delete;
+
+private:
+    RLMNotificationStage _stage;
+    __weak RLMRealm *_realm;
+    RLMNotificationTimingBlock _block;
+    std::chrono::steady_clock::time_point _start;
+    uint64_t _signpost = 0;
+    bool _active = false;
+};
+
+// Wait until nothing holds the write lock of the Realm at `path`, without
+// acquiring it, for up to `timeout` seconds. Returns false on timeout. The
+// lock can be taken by another writer between this returning and the caller
+// acquiring it, in which case acquiring it blocks without a timeout.
+bool RLMWaitForWriteLock(std::string const& path, NSTimeInterval timeout);
+
+// Record that the calling thread acquired the write lock of the Realm at
+// `path` after waiting `wait`, or that it released it
+void RLMRecordWriteLockAcquired(std::string const& path, std::chrono::steady_clock::duration wait);
+void RLMRecordWriteLockReleased(std::string const& path);
+void RLMRecordWriteLockTimeout();
+
+// A description of the thread in this process which holds the write lock of
+// the Realm at `path` and for how long it has held it, or nil if none does
+NSString *RLMWriteLockHolderDescription(std::string const& path);
+
+// Process-wide write lock statistics; see +[RLMRealm writeLockStatistics]
+NSDictionary<NSString *, id> *RLMWriteLockStatistics();
@@ -28,18 +28,80 @@
 
 #import "binding_context.hpp"
 
+#import <algorithm>
+#import <atomic>
+#import <fcntl.h>
 #import <map>
 #import <mutex>
+#import <pthread.h>
 #import <sys/event.h>
+#import <sys/file.h>
 #import <sys/stat.h>
 #import <sys/time.h>
+#import <thread>
 #import <unistd.h>
+#import <vector>
+
+#if __has_include(<os/signpost.h>)
+#import <os/signpost.h>
+#define REALM_HAVE_SIGNPOSTS 1
+#else
+#define REALM_HAVE_SIGNPOSTS 0
+#endif
 
 // Global realm state
 static std::mutex& s_realmCacheMutex = *new std::mutex();
 static std::map<std::string, NSMapTable *>& s_realmsPerPath = *new std::map<std::string, NSMapTable *>();
+// Incremented when the cache is cleared to invalidate the per-thread caches
+static std::atomic<uint64_t> s_realmCacheGeneration{0};
+
+namespace {
+// The Realms cached for the current thread, which can be looked up without
+// taking the global lock. Threads rarely have more than a few Realms open, so
+// this is a vector rather than a map.
+struct ThreadRealmCache {
+    uint64_t generation;
+    std::vector<std::pair<std::string, __weak RLMRealm *>> realms;
+};
+
+pthread_key_t threadRealmCacheKey() {
+    static pthread_key_t key;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        pthread_key_create(&key, [](void *cache) {
+            delete static_cast<ThreadRealmCache *>(cache);
+        });
+    });
+    return key;
+}
+
+ThreadRealmCache& threadRealmCache() {
+    auto key = threadRealmCacheKey();
+    auto cache = static_cast<ThreadRealmCache *>(pthread_getspecific(key));
+    if (!cache) {
+        cache = new ThreadRealmCache{s_realmCacheGeneration.load()};
+        pthread_setspecific(key, cache);
+    }
+    else if (cache->generation != s_realmCacheGeneration.load()) {
+        cache->realms.clear();
+        cache->generation = s_realmCacheGeneration.load();
+    }
+    return *cache;
+}
+
+void cacheRealmForThread(ThreadRealmCache& cache, std::string const& path, __unsafe_unretained RLMRealm *const realm) {
+    for (auto& entry : cache.realms) {
+        if (entry.first == path) {
+            entry.second = realm;
+            return;
+        }
+    }
+    cache.realms.emplace_back(path, realm);
+}
+} // anonymous namespace
 
 void RLMCacheRealm(std::string const& path, __unsafe_unretained RLMRealm *const realm) {
+    auto& cache = threadRealmCache();
     std::lock_guard<std::mutex> lock(s_realmCacheMutex);
     NSMapTable *realms = s_realmsPerPath[path];
     if (!realms) {
@@ -47,6 +109,7 @@ void RLMCacheRealm(std::string const& path, __unsafe_unretained RLMRealm *const
                                                                valueOptions:NSPointerFunctionsWeakMemory];
     }
     [realms setObject:realm forKey:(__bridge id)pthread_self()];
+    cacheRealmForThread(cache, path, realm);
 }
 
 RLMRealm *RLMGetAnyCachedRealmForPath(std::string const& path) {
@@ -55,13 +118,247 @@ RLMRealm *RLMGetAnyCachedRealmForPath(std::string const& path) {
 }
 
 RLMRealm *RLMGetThreadLocalCachedRealmForPath(std::string const& path) {
+    auto& cache = threadRealmCache();
+    for (auto const& entry : cache.realms) {
+        if (entry.first == path) {
+            if (RLMRealm *realm = entry.second) {
+                return realm;
+            }
+            break;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(s_realmCacheMutex);
+    RLMRealm *realm = [s_realmsPerPath[path] objectForKey:(__bridge id)pthread_self()];
+    if (realm) {
+        cacheRealmForThread(cache, path, realm);
+    }
+    return realm;
+}
+
+NSArray<RLMRealm *> *RLMGetThreadLocalCachedRealms() {
+    NSMutableArray *realms = [NSMutableArray new];
     std::lock_guard<std::mutex> lock(s_realmCacheMutex);
-    return [s_realmsPerPath[path] objectForKey:(__bridge id)pthread_self()];
+    for (auto const& entry : s_realmsPerPath) {
+        if (RLMRealm *realm = [entry.second objectForKey:(__bridge id)pthread_self()]) {
+            [realms addObject:realm];
+        }
+    }
+    return realms;
 }
 
 void RLMClearRealmCache() {
     std::lock_guard<std::mutex> lock(s_realmCacheMutex);
     s_realmsPerPath.clear();
+    ++s_realmCacheGeneration;
+}
+
+// Write lock state
+namespace {
+// Upper bounds in seconds of the buckets of the wait and hold histograms; the
+// last bucket has no upper bound
+constexpr double s_writeLockBuckets[] = {0.001, 0.01, 0.1, 1.0};
+constexpr size_t s_writeLockBucketCount = sizeof(s_writeLockBuckets) / sizeof(s_writeLockBuckets[0]) + 1;
+
+struct WriteLockDurations {
+    size_t histogram[s_writeLockBucketCount] = {};
+    size_t count = 0;
+    double total = 0;
+    double max = 0;
+
+    void add(double duration) {
+        auto bucket = std::upper_bound(std::begin(s_writeLockBuckets), std::end(s_writeLockBuckets), duration);
+        ++histogram[bucket - std::begin(s_writeLockBuckets)];
+        ++count;
+        total += duration;
+        max = std::max(max, duration);
+    }
+
+    NSDictionary *dictionary() const {
+        NSMutableArray *buckets = [NSMutableArray arrayWithCapacity:s_writeLockBucketCount];
+        for (size_t bucket : histogram) {
+            [buckets addObject:@(bucket)];
+        }
+        return @{@"count": @(count), @"totalTime": @(total), @"maxTime": @(max), @"histogram": buckets};
+    }
+};
+
+struct WriteLockHolder {
+    NSString *thread;
+    std::chrono::steady_clock::time_point acquired;
+};
+} // anonymous namespace
+
+static std::mutex& s_writeLockMutex = *new std::mutex();
+static WriteLockDurations s_writeLockWaits, s_writeLockHolds;
+static size_t s_writeLockTimeouts = 0;
+// Keyed by path and thread, as the thread releasing the lock may not have
+// recorded it yet when the next holder records acquiring it
+using WriteLockHolderKey = std::pair<std::string, pthread_t>;
+static std::map<WriteLockHolderKey, WriteLockHolder>& s_writeLockHolders = *new std::map<WriteLockHolderKey, WriteLockHolder>();
+
+bool RLMWaitForWriteLock(std::string const& path, NSTimeInterval timeout) {
+    // Core implements the write lock as an exclusive file lock on this file
+    // in the Realm's management directory, which can be polled without
+    // blocking from a separate file descriptor. The lock is released again
+    // immediately, as the write transaction has to acquire it through core,
+    // and flock() locks taken through different descriptors conflict even
+    // within a process, so holding it would deadlock. Core has no way to
+    // acquire it without blocking, which leaves a window for another writer.
+    std::string lockPath = path + ".management/access_control.write.mx";
+    int fd = open(lockPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        // The file is created along with the Realm's other lock files, so
+        // if it doesn't exist there's nothing to wait for
+        return true;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(timeout);
+    auto delay = std::chrono::microseconds(100);
+    bool acquired = true;
+    while (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno != EWOULDBLOCK) {
+            // Let the write transaction report whatever is wrong with the file
+            break;
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            acquired = false;
+            break;
+        }
+        std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(delay, deadline - now));
+        delay = std::min(delay * 2, std::chrono::microseconds(10000));
+    }
+    if (acquired) {
+        flock(fd, LOCK_UN);
+    }
+    close(fd);
+    return acquired;
+}
+
+void RLMRecordWriteLockAcquired(std::string const& path, std::chrono::steady_clock::duration wait) {
+    NSThread *thread = NSThread.currentThread;
+    NSString *name = thread.name.length ? thread.name : thread.isMainThread ? @"main" : [NSString stringWithFormat:@"%p", thread];
+    std::lock_guard<std::mutex> lock(s_writeLockMutex);
+    s_writeLockWaits.add(std::chrono::duration<double>(wait).count());
+    s_writeLockHolders[{path, pthread_self()}] = {name, std::chrono::steady_clock::now()};
+}
+
+void RLMRecordWriteLockReleased(std::string const& path) {
+    std::lock_guard<std::mutex> lock(s_writeLockMutex);
+    auto it = s_writeLockHolders.find({path, pthread_self()});
+    if (it != s_writeLockHolders.end()) {
+        s_writeLockHolds.add(std::chrono::duration<double>(std::chrono::steady_clock::now() - it->second.acquired).count());
+        s_writeLockHolders.erase(it);
+    }
+}
+
+void RLMRecordWriteLockTimeout() {
+    std::lock_guard<std::mutex> lock(s_writeLockMutex);
+    ++s_writeLockTimeouts;
+}
+
+NSString *RLMWriteLockHolderDescription(std::string const& path) {
+    std::lock_guard<std::mutex> lock(s_writeLockMutex);
+    auto it = s_writeLockHolders.lower_bound({path, pthread_t()});
+    if (it == s_writeLockHolders.end() || it->first.first != path) {
+        return nil;
+    }
+    double held = std::chrono::duration<double>(std::chrono::steady_clock::now() - it->second.acquired).count();
+    return [NSString stringWithFormat:@"thread '%@' in this process (for %.3f seconds)", it->second.thread, held];
+}
+
+NSDictionary<NSString *, id> *RLMWriteLockStatistics() {
+    std::lock_guard<std::mutex> lock(s_writeLockMutex);
+    NSMutableDictionary *holders = [NSMutableDictionary dictionaryWithCapacity:s_writeLockHolders.size()];
+    auto now = std::chrono::steady_clock::now();
+    for (auto const& holder : s_writeLockHolders) {
+        holders[@(holder.first.first.c_str())] = @{@"thread": holder.second.thread,
+                                            @"heldTime": @(std::chrono::duration<double>(now - holder.second.acquired).count())};
+    }
+    return @{@"waits": s_writeLockWaits.dictionary(),
+             @"holds": s_writeLockHolds.dictionary(),
+             @"timeouts": @(s_writeLockTimeouts),
+             @"holders": holders};
+}
+
+// Notification timing state
+static std::mutex& s_timingMutex = *new std::mutex();
+static RLMNotificationTimingBlock s_timingBlock;
+static std::atomic<bool> s_timingEnabled{false};
+
+void RLMSetNotificationTimingBlock(RLMNotificationTimingBlock block) {
+    std::lock_guard<std::mutex> lock(s_timingMutex);
+    s_timingBlock = block;
+    s_timingEnabled = block != nil;
+}
+
+#if REALM_HAVE_SIGNPOSTS
+API_AVAILABLE(macos(10.14), ios(12.0), tvos(12.0), watchos(5.0))
+static os_log_t notificationLog() {
+    static os_log_t log = os_log_create("io.realm", "Notifications");
+    return log;
+}
+
+// os_signpost requires the interval names to be string literals
+#define RLM_SIGNPOST_FOR_STAGE(fn, log, id, stage) do { \
+    switch (stage) { \
+        case RLMNotificationStageRefresh:         fn(log, id, "Refresh"); break; \
+        case RLMNotificationStageKVO:             fn(log, id, "KVO"); break; \
+        case RLMNotificationStageRealmBlocks:     fn(log, id, "Realm blocks"); break; \
+        case RLMNotificationStageCollectionBlock: fn(log, id, "Collection block"); break; \
+        case RLMNotificationStageObjectBlock:     fn(log, id, "Object block"); break; \
+    } \
+} while (0)
+#endif
+
+RLMNotificationInterval::RLMNotificationInterval(RLMNotificationStage stage, __unsafe_unretained RLMRealm *const realm)
+: _stage(stage), _realm(realm) {
+    if (s_timingEnabled) {
+        std::lock_guard<std::mutex> lock(s_timingMutex);
+        _block = s_timingBlock;
+    }
+#if REALM_HAVE_SIGNPOSTS
+    if (__builtin_available(macOS 10.14, iOS 12.0, tvOS 12.0, watchOS 5.0, *)) {
+        os_log_t log = notificationLog();
+        if (os_signpost_enabled(log)) {
+            _signpost = os_signpost_id_generate(log);
+            RLM_SIGNPOST_FOR_STAGE(os_signpost_interval_begin, log, _signpost, stage);
+        }
+    }
+#endif
+    _active = _block || _signpost || RLMShouldTimeOperations(realm);
+    if (_active) {
+        _start = std::chrono::steady_clock::now();
+    }
+}
+
+void RLMNotificationInterval::end() {
+    if (!_active) {
+        return;
+    }
+    _active = false;
+    auto duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+#if REALM_HAVE_SIGNPOSTS
+    if (_signpost) {
+        if (__builtin_available(macOS 10.14, iOS 12.0, tvOS 12.0, watchOS 5.0, *)) {
+            RLM_SIGNPOST_FOR_STAGE(os_signpost_interval_end, notificationLog(), _signpost, _stage);
+        }
+    }
+#endif
+    RLMRealm *realm = _realm;
+    if (_block) {
+        _block(_stage, realm ? @(realm->_realm->config().path.c_str()) : @"", duration);
+    }
+    if (RLMShouldTimeOperations(realm)) {
+        RLMNotificationStage stage = _stage;
+        RLMReportSlowOperation(realm, RLMSlowOperationNotification, _start, ^{
+            return @{@"stage": @(stage)};
+        });
+    }
 }
 
 namespace {
@@ -97,7 +394,12 @@ public:
     std::vector<ObserverState> get_observed_rows() override {
         @autoreleasepool {
             if (auto realm = _realm) {
+                _refresh.reset(new RLMNotificationInterval(RLMNotificationStageRefresh, realm));
                 [realm detachAllEnumerators];
+                [realm detachAllMappedValues];
+                ++realm->_readGeneration;
+                RLMRecordReadTransaction(realm, true);
+                RLMReleaseCachedResourcesIfNeeded(realm);
                 return RLMGetObservedRows(realm->_info);
             }
             return {};
@@ -106,6 +408,7 @@ public:
 
     void will_change(std::vector<ObserverState> const& observed, std::vector<void*> const& invalidated) override {
         @autoreleasepool {
+            RLMNotificationInterval interval(RLMNotificationStageKVO, _realm);
             RLMWillChange(observed, invalidated);
         }
     }
@@ -113,8 +416,18 @@ public:
     void did_change(std::vector<ObserverState> const& observed, std::vector<void*> const& invalidated, bool version_changed) override {
         try {
             @autoreleasepool {
-                RLMDidChange(observed, invalidated);
+                _refresh.reset();
+                {
+                    RLMNotificationInterval interval(RLMNotificationStageKVO, _realm);
+                    // Rows may have been moved by the changes, so the infos have
+                    // to be found by row again before any observers are added
+                    if (auto realm = _realm) {
+                        RLMInvalidateObservedRows(realm->_info);
+                    }
+                    RLMDidChange(observed, invalidated);
+                }
                 if (version_changed) {
+                    RLMNotificationInterval interval(RLMNotificationStageRealmBlocks, _realm);
                     [_realm sendNotifications:RLMRealmDidChangeNotification];
                 }
             }
@@ -134,6 +447,9 @@ public:
 private:
     // This is owned by the realm, so it needs to not retain the realm
     __weak RLMRealm *const _realm;
+    // The time spent advancing the read transaction, from before the observed
+    // rows are gathered until the changes have been applied
+    std::unique_ptr<RLMNotificationInterval> _refresh;
 };
 } // anonymous namespace
 
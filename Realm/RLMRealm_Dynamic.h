@@ -20,11 +20,101 @@
 
 #import <Realm/RLMObjectSchema.h>
 #import <Realm/RLMProperty.h>
-
-@class RLMResults;
+#import <Realm/RLMResults.h>
 
 NS_ASSUME_NONNULL_BEGIN
 
+/// A key in the options dictionary passed to `-[RLMRealm importJSONFromStream:className:options:error:]`.
+typedef NSString *RLMJSONImportOption RLM_EXTENSIBLE_STRING_ENUM;
+
+/// An `NSNumber` containing a `BOOL`. If `YES`, elements whose primary key matches an existing object update that
+/// object rather than causing an error. Defaults to `NO`.
+extern RLMJSONImportOption const RLMJSONImportOptionUpdate;
+
+/// An `NSNumber` containing the number of objects to import before committing the write transaction and beginning a
+/// new one. Ignored if the import is performed within an existing write transaction. Defaults to 0, which commits
+/// only once all of the objects have been imported.
+extern RLMJSONImportOption const RLMJSONImportOptionCommitInterval;
+
+/**
+ A batch of values for objects of a single type which have already been converted to the format Realm stores them in.
+
+ Converting values (reading them with key-value coding, checking their types, encoding strings as UTF-8 and so on)
+ makes up much of the cost of creating objects, but doesn't require access to a Realm. Creating an
+ `RLMPreparedObjects` performs all of that work, and can be done on any thread, so that the thread holding the write
+ transaction only has to store the already-converted values with `-[RLMRealm addPreparedObjects:]`. Spreading the
+ preparation of batches over several threads lets the rate of insertion scale beyond what a single writer can achieve.
+
+ Only object types without `RLMObject`, `RLMArray` or `id` properties can be prepared.
+ */
+@interface RLMPreparedObjects : NSObject
+
+/// The class name of the prepared objects.
+@property (nonatomic, readonly) NSString *className;
+
+/// The number of prepared objects.
+@property (nonatomic, readonly) NSUInteger count;
+
+/**
+ Converts the given values to objects of the type described by `objectSchema`.
+
+ Each value is interpreted in the same way as the `value` argument to `-[RLMRealm createObject:withValue:]`. An
+ exception is thrown if any of the values are invalid.
+
+ This method may be called on any thread. The object schema can be obtained from any Realm (e.g.
+ `realm.schema[className]`), and must match the schema of the Realm the objects are added to.
+
+ @param objectSchema The schema of the object type to prepare objects for.
+ @param values       An enumerable collection of values to create objects from.
+ */
+- (instancetype)initWithObjectSchema:(RLMObjectSchema *)objectSchema values:(id<NSFastEnumeration>)values;
+
+/// :nodoc:
+- (instancetype)init __attribute__((unavailable("Use initWithObjectSchema:values:")));
+
+/// :nodoc:
++ (instancetype)new __attribute__((unavailable("Use initWithObjectSchema:values:")));
+
+@end
+
+/**
+ A predicate which has been parsed ahead of time, and is then executed any number of times with different arguments.
+
+ The predicate format string refers to its arguments as `$0`, `$1` and so on rather than with format specifiers such
+ as `%@`, and the values for them are supplied each time the query is run. This avoids parsing the format string each
+ time when the same query is run repeatedly with different values, such as when updating search results as the user
+ types. The query itself is still built from the parsed predicate each time it is run, as the values it compares with
+ are part of the query, so running a prepared query costs about as much as filtering with an `NSPredicate`.
+
+ Prepared queries are created with `-[RLMRealm prepareQuery:forClass:]`, and are confined to the thread of the Realm
+ they were created with.
+ */
+@interface RLMPreparedQuery : NSObject
+
+/// The class name of the objects the query is run on.
+@property (nonatomic, readonly) NSString *className;
+
+/// The number of arguments which must be supplied when running the query.
+@property (nonatomic, readonly) NSUInteger argumentCount;
+
+/**
+ Runs the query with the given arguments.
+
+ @param arguments The values to use for `$0`, `$1` and so on in the predicate format string. Must contain exactly
+                  `argumentCount` values.
+
+ @return    An `RLMResults` containing the objects matching the predicate.
+ */
+- (RLMResults *)resultsWithArguments:(NSArray *)arguments;
+
+/// :nodoc:
+- (instancetype)init __attribute__((unavailable("Use -[RLMRealm prepareQuery:forClass:]")));
+
+/// :nodoc:
++ (instancetype)new __attribute__((unavailable("Use -[RLMRealm prepareQuery:forClass:]")));
+
+@end
+
 @interface RLMRealm (Dynamic)
 
 #pragma mark - Getting Objects from a Realm
@@ -76,6 +166,20 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (RLMResults *)objects:(NSString *)className withPredicate:(NSPredicate *)predicate;
 
+/**
+ Parses a predicate format string so that it can be run repeatedly with different arguments.
+
+ Arguments are referred to as `$0`, `$1` and so on in the format string, e.g. `@"age > $0 AND name BEGINSWITH $1"`.
+
+ @param predicateFormat A predicate format string without format specifiers.
+ @param className       The type of objects to query (name of the class).
+
+ @return    An `RLMPreparedQuery` which runs the query when given the values of its arguments.
+
+ @see       `RLMPreparedQuery`
+ */
+- (RLMPreparedQuery *)prepareQuery:(NSString *)predicateFormat forClass:(NSString *)className;
+
 /**
  Returns the object of the given type with the given primary key from the Realm.
 
@@ -113,6 +217,144 @@ NS_ASSUME_NONNULL_BEGIN
  */
 -(RLMObject *)createObject:(NSString *)className withValue:(id)value;
 
+/**
+ Creates an `RLMObject` of type `className` in the Realm for each value in the
+ given collection.
+
+ Each value is interpreted in the same way as the `value` argument to
+ `createObject:withValue:`. This is considerably faster than calling that method
+ in a loop as the schema information needed to populate the objects is resolved
+ only once for the batch, the rows are reserved in a single step where possible,
+ and no `RLMObject` instances are created for the new objects.
+
+ If any of the values is invalid, none of the objects are created, including
+ the objects created for the values of their links, and `error` is set.
+
+ @warning This method may only be called during a write transaction.
+
+ @param className The class name of the objects to create.
+ @param values    An enumerable collection of values to create objects from.
+ @param error     If an error occurs, upon return contains an `NSError` object
+                  that describes the problem. If you are not interested in
+                  possible errors, pass in `NULL`.
+
+ @return Whether the objects were created.
+ */
+- (BOOL)createObjects:(NSString *)className withValues:(id<NSFastEnumeration>)values error:(NSError **)error;
+
+/**
+ Creates an `RLMObject` of type `className` in the Realm for each value in the
+ given collection, without checking that the values are valid.
+
+ This behaves like `createObjects:withValues:error:`, but skips checking that each
+ value has the correct type for its property, which is a significant part of the
+ cost of creating objects. It should only be used for values from a trusted
+ source which are known to match the schema, such as a typed code generator.
+ Debug builds of Realm still check the values. Passing values of the wrong type
+ in release builds results in undefined behavior.
+
+ @warning This method may only be called during a write transaction.
+
+ @param className The class name of the objects to create.
+ @param values    An enumerable collection of values to create objects from.
+ @param error     If an error occurs, upon return contains an `NSError` object
+                  that describes the problem. If you are not interested in
+                  possible errors, pass in `NULL`.
+
+ @return Whether the objects were created.
+ */
+- (BOOL)createObjects:(NSString *)className withTrustedValues:(id<NSFastEnumeration>)values error:(NSError **)error;
+
+/**
+ Creates an object in the Realm for each of the given prepared objects.
+
+ As the values have already been converted, this does little more than store
+ them in the Realm. An exception is thrown if the objects have a primary key
+ which is already present in the Realm.
+
+ @warning This method may only be called during a write transaction.
+
+ @param objects The prepared objects to add.
+
+ @see `RLMPreparedObjects`
+ */
+- (void)addPreparedObjects:(RLMPreparedObjects *)objects;
+
+/**
+ Creates or updates an `RLMObject` of type `className` in the Realm for each
+ value in the given collection.
+
+ The class must have a primary key. Each value is interpreted in the same way as
+ the `value` argument to `createOrUpdateInRealm:withValue:`. The existing rows
+ for all of the primary keys in the batch are looked up in a single pass before
+ any objects are written, which makes this much faster than updating objects one
+ at a time for large batches.
+
+ @warning This method may only be called during a write transaction.
+
+ @param className     The class name of the objects to create or update.
+ @param values        An enumerable collection of values to create or update objects from.
+ @param insertedCount If non-NULL, upon return contains the number of objects which were created.
+ @param updatedCount  If non-NULL, upon return contains the number of existing objects which were updated.
+ */
+- (void)createOrUpdateObjects:(NSString *)className
+                   withValues:(id<NSFastEnumeration>)values
+                insertedCount:(nullable NSUInteger *)insertedCount
+                 updatedCount:(nullable NSUInteger *)updatedCount;
+
+/**
+ Creates an `RLMObject` of type `className` for each element of a JSON array read from a stream.
+
+ The stream must contain a JSON document whose top-level value is an array. Each element of the array is interpreted
+ in the same way as a dictionary passed to `createObject:withValue:`. The document is parsed incrementally, and only
+ one element of the array is held in memory at a time, so arbitrarily large documents can be imported with bounded
+ memory use.
+
+ If the Realm is not in a write transaction, this method begins one and commits it once all of the objects have been
+ imported, or every `RLMJSONImportOptionCommitInterval` objects if that option is given. If the import fails, the
+ uncommitted objects are discarded but any batches which were already committed are kept. If the Realm is already
+ in a write transaction, the objects are created within that transaction and it is left open.
+
+ If the stream has not been opened, it is opened and closed by this method.
+
+ @param stream    The stream to read the JSON document from.
+ @param className The class name of the objects to create.
+ @param options   A dictionary of `RLMJSONImportOption` keys and their values, or `nil`.
+ @param error     If an error occurs, upon return contains an `NSError` object
+                  that describes the problem. If you are not interested in
+                  possible errors, pass in `NULL`.
+
+ @return Whether all of the objects were imported successfully.
+ */
+- (BOOL)importJSONFromStream:(NSInputStream *)stream
+                   className:(NSString *)className
+                     options:(nullable NSDictionary<RLMJSONImportOption, id> *)options
+                       error:(NSError **)error;
+
+@end
+
+@interface RLMResults (Dynamic)
+
+/**
+ Reads the values of some of the properties of each object in the results, without creating an object for each of
+ them.
+
+ Each property is looked up by name once, and the values of the properties stored directly in the Realm file, such as
+ numbers, strings, dates and data, are read straight from the table rather than through an `RLMObject` and its
+ accessors, so this is much faster for reading whole tables in generic tools than reading the properties of each
+ object with `-objectForKeyedSubscript:`. The values of other properties, such as links and lists, are read through an
+ object for the row, as usual.
+
+ The results are enumerated as of when this method is called, and the block is invoked for each object in order with
+ its values, in the order of `propertyNames`, with `NSNull` in place of `nil`.
+
+ @param propertyNames   The names of the properties to read.
+ @param block           The block to invoke with the values of each object, its index in the results and a pointer
+                        to a flag which can be set to `YES` to stop the enumeration.
+ */
+- (void)enumerateValuesForProperties:(NSArray<NSString *> *)propertyNames
+                          usingBlock:(void (^)(NSArray *values, NSUInteger index, BOOL *stop))block;
+
 @end
 
 NS_ASSUME_NONNULL_END
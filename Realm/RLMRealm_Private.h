@@ -18,15 +18,30 @@
 
 #import <Realm/RLMRealm.h>
 
-@class RLMFastEnumerator;
+@class RLMCancellationToken, RLMFastEnumerator;
 
 NS_ASSUME_NONNULL_BEGIN
 
 // Disable syncing files to disk. Cannot be re-enabled. Use only for tests.
+// This applies to every Realm file in the process: the durability of commits
+// is chosen by core for each file, and the only other level it supports on
+// Apple platforms is that of in-memory Realms, which are never synced.
 FOUNDATION_EXTERN void RLMDisableSyncToDisk();
 
 FOUNDATION_EXTERN NSData * _Nullable RLMRealmValidatedEncryptionKey(NSData *key);
 
+// Get the write queue for the file the configuration opens, creating it if needed
+FOUNDATION_EXTERN RLMWriteQueue *RLMWriteQueueForConfiguration(RLMRealmConfiguration *configuration);
+
+// Wait for any indexes of properties listed in +deferredIndexedProperties which
+// are being built in the background to be built. Use only for tests.
+FOUNDATION_EXTERN void RLMWaitForDeferredIndexBuilds();
+
+// The number of times a Realm has been opened with the schema stored in the
+// file because its schema fingerprint matched, skipping the schema update.
+// Use only for tests.
+FOUNDATION_EXTERN uint64_t RLMSchemaFingerprintMatchCount();
+
 // Translate an in-flight exception resulting from opening a SharedGroup to
 // an NSError or NSException (if error is nil)
 void RLMRealmTranslateException(NSError **error);
@@ -43,6 +58,25 @@ void RLMRealmTranslateException(NSError **error);
 - (void)unregisterEnumerator:(RLMFastEnumerator *)enumerator;
 - (void)detachAllEnumerators;
 
+// Values which refer directly to data in the Realm file, and which must copy it
+// before the read transaction they were read in ends
+- (void)registerMappedValue:(id)value;
+- (void)detachAllMappedValues;
+
+// Collection notification tokens which stop their registrations while the
+// Realm's collection notifications are suspended
+@property (nonatomic, readonly) BOOL collectionNotificationsSuspended;
+- (void)registerSuspendableToken:(RLMCancellationToken *)token;
+
+// Delete the objects of the classes with an expiration property which have
+// expired, in write transactions which each delete at most `batchSize`
+// objects, and return the number of objects deleted. This is done in the
+// background automatically whenever the schema has expiring objects.
+- (NSUInteger)purgeExpiredObjectsWithBatchSize:(NSUInteger)batchSize;
+// The earliest expiration date of the objects which haven't been purged, or
+// nil if there are none
+- (nullable NSDate *)earliestExpirationDate;
+
 - (void)sendNotifications:(RLMNotification)notification;
 - (void)verifyThread;
 - (void)verifyNotificationsAreSupported;
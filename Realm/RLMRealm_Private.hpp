@@ -19,18 +19,67 @@
 #import "RLMRealm_Private.h"
 
 #import "RLMClassInfo.hpp"
+#import "RLMRealmConfiguration.h"
+
+#import <chrono>
+#import <memory>
+#import <string>
+#import <unordered_map>
 
 namespace realm {
     class Group;
     class Realm;
 }
+struct RLMReadTransactionRecord;
+struct RLMSharedResultsNotifier;
 
 @interface RLMRealm () {
     @public
     std::shared_ptr<realm::Realm> _realm;
     RLMSchemaInfo _info;
+    // Incremented whenever the data visible to this Realm may change (when the
+    // read transaction advances and when a write transaction begins), so that
+    // caches derived from the Realm's contents can tell if they are stale
+    uint64_t _readGeneration;
+    // The value of the process-wide cache release generation when this Realm
+    // last released its caches; see RLMReleaseCachedResourcesIfNeeded()
+    uint64_t _cacheReleaseGeneration;
+    // Set for the duration of a write transaction begun with
+    // -beginBulkWriteTransaction, in which setters don't send KVO notifications
+    bool _bulkWrite;
+    // The slow operation handler and threshold of the configuration which
+    // the Realm was opened with
+    RLMSlowOperationBlock _slowOperationHandler;
+    NSTimeInterval _slowOperationThreshold;
+    // The version this Realm is reading, as tracked by the long read
+    // transaction watchdog if its configuration has a handler for them
+    std::shared_ptr<RLMReadTransactionRecord> _readTransactionRecord;
+    // The notifiers shared by the RLMResults with notification blocks for
+    // each query, keyed by the query's identity; see RLMAddNotificationBlock()
+    std::unordered_map<std::string, std::weak_ptr<RLMSharedResultsNotifier>> _sharedResultsNotifiers;
 }
 
 // FIXME - group should not be exposed
 @property (nonatomic, readonly) realm::Group &group;
 @end
+
+// Whether operations on `realm` should be timed for its slow operation handler
+static inline bool RLMShouldTimeOperations(__unsafe_unretained RLMRealm *const realm) {
+    return realm && realm->_slowOperationHandler;
+}
+
+// Release the Realm's caches if +releaseCachedResourcesWithLevel: has been
+// called since it last did so. Realms can only be used on their own thread,
+// so Realms on other threads release their caches when they next advance.
+void RLMReleaseCachedResourcesIfNeeded(RLMRealm *realm);
+
+// Record for the long read transaction watchdog that the Realm has started
+// reading a new version of the file, or stopped reading if `reading` is false
+void RLMRecordReadTransaction(RLMRealm *realm, bool reading);
+
+// Call the slow operation handler of `realm` if the operation which began at
+// `start` took longer than its threshold, passing it the dictionary returned
+// by `details`, which is only called if so
+void RLMReportSlowOperation(RLMRealm *realm, RLMSlowOperation operation,
+                            std::chrono::steady_clock::time_point start,
+                            NSDictionary<NSString *, id> *(^details)(void));
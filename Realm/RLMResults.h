@@ -21,7 +21,139 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
-@class RLMObject, RLMRealm, RLMNotificationToken;
+@class RLMObject, RLMRealm, RLMResults, RLMNotificationToken, RLMSectionedResults, RLMCollectionIdentityChange;
+
+/**
+ The aggregate functions which can be computed for each group of objects by
+ `-[RLMResults groupedBy:aggregate:ofProperty:]`.
+ */
+typedef NS_ENUM(NSInteger, RLMAggregateFunction) {
+    /// The number of objects in the group, or the number of non-nil values if a property is given.
+    RLMAggregateFunctionCount,
+    /// The sum of the values of the property.
+    RLMAggregateFunctionSum,
+    /// The minimum value of the property.
+    RLMAggregateFunctionMin,
+    /// The maximum value of the property.
+    RLMAggregateFunctionMax,
+    /// The average value of the property.
+    RLMAggregateFunctionAverage,
+};
+
+/**
+ The measures of distance between vectors which
+ `-[RLMResults objectsNearestToVector:forProperty:limit:metric:]` can search by.
+ */
+typedef NS_ENUM(NSInteger, RLMVectorDistanceMetric) {
+    /// One minus the cosine of the angle between the vectors, which ranges from 0 for vectors pointing the same way
+    /// to 2 for vectors pointing in opposite directions. Vectors of length zero are at distance 1 from every vector.
+    RLMVectorDistanceMetricCosine,
+    /// The Euclidean (L2) distance between the vectors.
+    RLMVectorDistanceMetricEuclidean,
+};
+
+/**
+ A block called when evaluating the query of an `RLMResults` took longer than the threshold set with
+ `+[RLMResults setSlowQueryThreshold:handler:]`.
+
+ @param results     The results whose query was evaluated.
+ @param duration    The time the evaluation took, in seconds.
+ */
+typedef void (^RLMSlowQueryBlock)(RLMResults *results, NSTimeInterval duration);
+
+/**
+ The comparisons which an `RLMQueryCondition` can make between a property and a value.
+ */
+typedef NS_ENUM(NSInteger, RLMQueryOperator) {
+    /// The property is equal to the value.
+    RLMQueryOperatorEqual,
+    /// The property is not equal to the value.
+    RLMQueryOperatorNotEqual,
+    /// The property is less than the value.
+    RLMQueryOperatorLessThan,
+    /// The property is less than or equal to the value.
+    RLMQueryOperatorLessThanOrEqual,
+    /// The property is greater than the value.
+    RLMQueryOperatorGreaterThan,
+    /// The property is greater than or equal to the value.
+    RLMQueryOperatorGreaterThanOrEqual,
+    /// The string property begins with the value.
+    RLMQueryOperatorBeginsWith,
+    /// The string property ends with the value.
+    RLMQueryOperatorEndsWith,
+    /// The string property contains the value.
+    RLMQueryOperatorContains,
+};
+
+/**
+ `RLMQueryCondition` describes a condition on the properties of objects which results can be filtered by with
+ `-[RLMResults objectsMatchingCondition:]`, as an alternative to predicates.
+
+ A condition compares a property of the objects directly with a value, or combines other conditions. Filtering by a
+ condition builds the query from it directly, without parsing a predicate format or inspecting its expressions, so it
+ is cheaper than filtering by an equivalent predicate when many queries are made.
+
+ Only properties of the objects themselves can be compared, rather than key paths through their links. `int`, `bool`,
+ `float`, `double`, `NSDate` and `NSString` properties are supported; `bool` properties can only be compared with
+ `RLMQueryOperatorEqual` and `RLMQueryOperatorNotEqual`, and only string properties with the `BeginsWith`, `EndsWith`
+ and `Contains` operators.
+
+ Conditions are immutable and can be shared between threads.
+ */
+@interface RLMQueryCondition : NSObject
+
+/**
+ Returns a condition comparing a property with a value.
+
+ @param propertyName    The name of the property.
+ @param queryOperator   How the property is compared with the value.
+ @param value           The value, which must be valid for the property. `nil` matches optional properties which are
+                        `nil`, and can only be used with `RLMQueryOperatorEqual` and `RLMQueryOperatorNotEqual`.
+ */
++ (instancetype)conditionWithProperty:(NSString *)propertyName
+                             operator:(RLMQueryOperator)queryOperator
+                                value:(nullable id)value;
+
+/**
+ Returns a condition comparing a string property with a string, ignoring case.
+
+ @param propertyName    The name of the string property.
+ @param queryOperator   How the property is compared with the value.
+ @param value           The string to compare the property with.
+ */
++ (instancetype)conditionWithProperty:(NSString *)propertyName
+                             operator:(RLMQueryOperator)queryOperator
+                  caseInsensitiveValue:(NSString *)value;
+
+/**
+ Returns a condition comparing a string property with a string, ignoring both case and diacritics.
+
+ This matches the same objects as the equivalent `[cd]` predicate, and uses the folded copy of properties listed in
+ `+[RLMObject foldedIndexedProperties]` in the same way.
+
+ @param propertyName    The name of the string property.
+ @param queryOperator   How the property is compared with the value.
+ @param value           The string to compare the property with.
+ */
++ (instancetype)conditionWithProperty:(NSString *)propertyName
+                             operator:(RLMQueryOperator)queryOperator
+     caseAndDiacriticInsensitiveValue:(NSString *)value;
+
+/// Returns a condition which is met if all of the given conditions are met.
++ (instancetype)conditionMatchingAll:(NSArray<RLMQueryCondition *> *)conditions;
+
+/// Returns a condition which is met if any of the given conditions are met.
++ (instancetype)conditionMatchingAny:(NSArray<RLMQueryCondition *> *)conditions;
+
+/// Returns a condition which is met if the given condition is not met.
++ (instancetype)conditionNegating:(RLMQueryCondition *)condition;
+
+/// :nodoc:
+- (instancetype)init __attribute__((unavailable("Use the class methods to create conditions.")));
+/// :nodoc:
++ (instancetype)new __attribute__((unavailable("Use the class methods to create conditions.")));
+
+@end
 
 /**
  `RLMResults` is an auto-updating container type in Realm returned from object
@@ -57,6 +189,14 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property (nonatomic, readonly, assign) NSUInteger count;
 
+/**
+ Indicates if the results collection contains any objects.
+
+ This stops evaluating the query at the first matching object, and so is cheaper than checking `count` or
+ `firstObject` when only the existence of a match matters.
+ */
+@property (nonatomic, readonly) BOOL exists;
+
 /**
  The class name (i.e. type) of the `RLMObject`s contained in the results collection.
  */
@@ -86,6 +226,39 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (RLMObjectType)objectAtIndex:(NSUInteger)index;
 
+/**
+ Returns the objects at the given indexes.
+
+ This is equivalent to calling `objectAtIndex:` for each index, but checks the
+ results collection's thread and brings it up to date only once, which makes
+ reading a batch of objects, such as the rows passed to
+ `-tableView:prefetchRowsAtIndexPaths:`, faster.
+
+ @param indexes The indexes of the objects to return.
+
+ @return An array of the objects at the given indexes, in order of their index.
+ */
+- (NSArray<RLMObjectType> *)objectsAtIndexes:(NSIndexSet *)indexes;
+
+/**
+ Returns an object which fast-enumerates the objects in the results collection, resolving
+ the to-one relationships along the given key paths for each batch of objects
+ at once.
+
+ Reading `post.author.name` for every post in a loop otherwise looks up the
+ link and creates an accessor for the author of each post separately. Included
+ key paths are instead resolved for every object in a batch before the batch
+ is enumerated, one relationship at a time, and objects which link to the same
+ object share a single accessor for it, so reading the relationship in the
+ loop body is only a check that the link hasn't changed.
+
+ @param keyPaths    Key paths made up of to-one relationships, such as
+                    `@"author"` or `@"author.team"`.
+
+ @return An object to use in a `for...in` loop.
+ */
+- (id<NSFastEnumeration>)objectsIncludingKeyPaths:(NSArray<NSString *> *)keyPaths;
+
 /**
  Returns the first object in the results collection.
 
@@ -104,6 +277,95 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (nullable RLMObjectType)lastObject;
 
+/**
+ Enumerates the objects in the results collection using a single object which is
+ updated to refer to each object in turn.
+
+ This avoids allocating an object for every object enumerated, which can be
+ significantly faster when enumerating a large number of objects. However, the
+ object passed to the block is only valid for the duration of that call to the
+ block: it must not be stored or otherwise escape from the block, as it will
+ refer to a different object after the block returns.
+
+ @param block   The block to call for each object. Set `*stop` to `YES` to stop
+                enumerating.
+ */
+- (void)enumerateObjectsReusingAccessor:(void (^)(RLMObjectType object, NSUInteger index, BOOL *stop))block;
+
+/**
+ Returns a page of objects from the results collection which immediately follow
+ the given object.
+
+ To read the results one page at a time, pass `nil` for the first page and then
+ the last object of the previous page for each following page. Because pages are
+ found from the object rather than from an index, this continues from the
+ correct place even if the Realm has been refreshed since the previous page was
+ read.
+
+ For unsorted results containing every object of a type, only the objects in the
+ requested page are read, and which objects follow the given object depends on
+ the order in which they are stored. For all other results, the position of the
+ given object in the results collection is used.
+
+ @param object  The object after which the page should start, or `nil` to start
+                from the beginning of the results collection. The object must
+                be in the results collection.
+ @param limit   The maximum number of objects to return.
+
+ @return An array containing up to `limit` objects.
+ */
+- (NSArray<RLMObjectType> *)pageStartingAfter:(nullable RLMObjectType)object limit:(NSUInteger)limit;
+
+/**
+ Enumerates the objects in the results collection, splitting them into ranges
+ which are processed concurrently on background threads.
+
+ Each range is processed with its own copy of the Realm on its own thread, with
+ the results collection handed over to that thread using an
+ `RLMThreadSafeReference`, so the objects passed to the block must only be used
+ on the thread they were passed to the block on, and the block must be safe to
+ call concurrently. This method does not return until every object has been
+ processed.
+
+ If `NSEnumerationConcurrent` is not included in `options`, the objects are
+ instead enumerated serially on the calling thread. Objects are enumerated in
+ reverse order within each range if `NSEnumerationReverse` is included.
+
+ Setting `*stop` to `YES` stops the enumeration on all threads, but objects
+ which are already being processed on other threads are not interrupted.
+
+ Every thread reads the same version of the Realm as the calling thread, so
+ changes committed while the enumeration runs are not seen by it. For
+ synchronized and read-only Realms, which can't be opened at a past version, an
+ exception is thrown instead if the Realm changes before every thread has begun
+ reading. An exception is also thrown if the Realm can't be opened on one of
+ the threads.
+
+ @warning This method cannot be called during a write transaction.
+
+ @param options The enumeration options.
+ @param block   The block to call for each object.
+ */
+- (void)concurrentEnumerateWithOptions:(NSEnumerationOptions)options
+                            usingBlock:(void (^)(RLMObjectType object, NSUInteger index, BOOL *stop))block;
+
+#pragma mark - Modifying Objects
+
+/**
+ Adds an amount to the value of an integer property of every object in the
+ results collection.
+
+ This adds to each stored value directly, like
+ `-[RLMObject incrementProperty:by:]`, and is recorded as an addition when the
+ Realm is synchronized. Objects whose value is `nil` are left unchanged.
+
+ @warning This method may only be called during a write transaction.
+
+ @param propertyName    The name of a non-primary-key `int` property.
+ @param amount          The amount to add, which may be negative.
+ */
+- (void)incrementProperty:(NSString *)propertyName by:(NSInteger)amount;
+
 #pragma mark - Querying Results
 
 /**
@@ -157,6 +419,50 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (RLMResults<RLMObjectType> *)objectsWithPredicate:(NSPredicate *)predicate;
 
+/**
+ Returns all the objects in the results collection which meet the given condition.
+
+ @param condition   The condition with which to filter the objects.
+
+ @return            An `RLMResults` of objects that meet the condition.
+ */
+- (RLMResults<RLMObjectType> *)objectsMatchingCondition:(RLMQueryCondition *)condition NS_SWIFT_NAME(objects(matching:));
+
+/**
+ Returns all the objects in the results collection matching the given search text.
+
+ An object matches if each word of the search text is the start of a word in at least one of the given string
+ properties, ignoring case and diacritics. For example, searching for `@"jo sm"` in `firstName` and `lastName` matches
+ an object with the first name "John" and the last name "Smith". All of the properties are checked in a single pass
+ over the objects, and properties listed in `+[RLMObject foldedIndexedProperties]` are searched using their folded
+ copies.
+
+ @param text            The text to search for. If it contains no words, all of the objects match.
+ @param propertyNames   The names of the string properties to search.
+
+ @return                An `RLMResults` of objects that match the search text.
+ */
+- (RLMResults<RLMObjectType> *)objectsMatchingText:(NSString *)text inProperties:(NSArray<NSString *> *)propertyNames;
+
+/**
+ Returns all the objects in the results collection whose location is within a distance of the given location.
+
+ The locations of the objects are given by the latitude and longitude properties of a geo index (see
+ `+[RLMObject geoIndexes]`), and distances are measured along the surface of the Earth. Only the objects in the cells
+ of the geo index which overlap the bounding box of the circle are measured.
+
+ @param distance    The maximum distance, in meters.
+ @param latitude    The latitude of the center of the circle, in degrees.
+ @param longitude   The longitude of the center of the circle, in degrees.
+ @param geoIndex    The name of the key property of the geo index.
+
+ @return            An `RLMResults` of the objects within the distance of the location.
+ */
+- (RLMResults<RLMObjectType> *)objectsWithinDistance:(double)distance
+                                          ofLatitude:(double)latitude
+                                           longitude:(double)longitude
+                                            geoIndex:(NSString *)geoIndex;
+
 /**
  Returns a sorted `RLMResults` from an existing results collection.
 
@@ -187,6 +493,128 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (RLMResults<RLMObjectType> *)sortedResultsUsingDescriptors:(NSArray<RLMSortDescriptor *> *)properties;
 
+/**
+ Returns an `RLMResults` containing only the first objects in the results collection.
+
+ The first `limit` objects are selected without sorting the rest of the objects, so limiting sorted results to a small
+ number of objects is much faster than sorting all of them. Objects which compare equal to the last of the selected
+ objects under the sort order are also included. Unsorted results of all objects of a class or filtered from them are
+ limited to the objects which come first in the order in which they are stored in the Realm. Results derived from a
+ list or linking objects must be sorted before they can be limited.
+
+ The limit is applied by selecting the last object to include when the results are created. As the results update,
+ they contain the objects which sort at or before that object's values, so their count may change. If there are no
+ more than `limit` objects when the results are created, the last of them is selected, so objects which sort after
+ all of them are not added to the results later. If there are no objects at all, the results stay empty.
+
+ @param limit   The number of objects to include.
+
+ @return        An `RLMResults` of the first objects in the collection.
+ */
+- (RLMResults<RLMObjectType> *)resultsLimitedTo:(NSUInteger)limit;
+
+/**
+ Returns an `RLMResults` containing only the first object in the results collection for each distinct combination of
+ values of the given key paths.
+
+ Objects are compared by the values of the key paths, in the order of the results collection. The objects are
+ deduplicated by the query engine, without reading the values into Objective-C objects, and the returned results
+ update and support notifications in the same way as other results.
+
+ @warning Collections may only be made distinct by properties of boolean, date, double, float, integer, and string
+          types. Key paths may follow to-one relationships.
+
+ @param keyPaths    The key paths whose values identify distinct objects.
+
+ @return            An `RLMResults` of the distinct objects in the collection.
+ */
+- (RLMResults<RLMObjectType> *)distinctResultsUsingKeyPaths:(NSArray<NSString *> *)keyPaths;
+
+/**
+ Evaluates the query of the results collection and stores the objects it matches in the Realm file under the given
+ name, so that `-materializedResultsNamed:` can return them without evaluating the query again.
+
+ The objects are stored in a write transaction of their own, and are used until the next write transaction other than
+ one materializing results is committed to the Realm file, from any thread or process. Storing a different query under
+ a name replaces the objects stored for the previous one.
+
+ @warning This method may only be called outside of a write transaction, on results of all objects of a class or
+          filtered from them, and not on results of a synchronized or read-only Realm.
+
+ @param name    The name the matching objects are stored under.
+ @param error   If storing the objects fails, upon return contains an `NSError` object that describes the problem. If
+                you are not interested in possible errors, pass in `NULL`.
+
+ @return        Whether the objects were stored.
+ */
+- (BOOL)materializeWithName:(NSString *)name error:(NSError **)error;
+
+/**
+ Returns an `RLMResults` containing the same objects as the results collection, which uses the objects stored under the
+ given name by `-materializeWithName:error:` rather than evaluating its query.
+
+ The stored objects are used if they were stored for an equivalent query, including from other threads and before the
+ Realm was reopened, and no write transaction has been committed since. Otherwise, and in a write transaction, the
+ results collection itself is returned. The returned results update in the same way as other results, evaluating the
+ query once the data has changed.
+
+ This method never writes to the Realm.
+
+ @warning This method may only be called on results of all objects of a class or filtered from them, and not on
+          results of a synchronized Realm.
+
+ @param name    The name the matching objects are stored under.
+
+ @return        An `RLMResults` of the objects matching the query.
+ */
+- (RLMResults<RLMObjectType> *)materializedResultsNamed:(NSString *)name;
+
+#pragma mark - Inspecting Queries
+
+/**
+ Returns a description of how the query of the results is evaluated.
+
+ The returned dictionary contains the following keys:
+
+ - `objectClassName`: the type of objects in the results.
+ - `tableRows`: the number of objects of that type, which is the number of objects a query without indexed conditions
+   has to look at.
+ - `query`: the tree of conditions the results were filtered with, or `NSNull` for unfiltered results. Each node is a
+   dictionary with a `type` of `and`, `or`, `not`, `comparison`, `textSearch`, `geoDistance`, `limit`, `true` or
+   `false`, the
+   `children` of compound nodes, and for comparisons the `predicate`, the `keyPath` and whether the property is
+   `indexed`. Conditions have a `strategy` describing how they are evaluated: `index`, `foldedIndex` or
+   `compoundIndex` for search index lookups, `sortedRange` for range comparisons on indexed integer and date
+   properties, `geoIndex` for the range lookups of the cells of a geo index overlapping a bounding box or circle,
+   `inSet` for hash lookups of `IN` comparisons, `semiJoin` when the condition is evaluated on the
+   objects in a list and its matches are mapped back to the objects whose lists contain them, with the node for that
+   condition in `targets`, `linkTraversal` or `toManyLinkTraversal` when each object's relationships are followed,
+   `scan` or `foldedScan` when each object's value is compared, `listAggregate` when aggregates of a list
+   computed for all of the objects at once are compared, and `columnComparison`, `collectionOperator`, `subquery`,
+   `sortCutoff` or `constant` for the other kinds of conditions.
+   Each node has an estimate of the number of objects it looks at in `estimatedRowsScanned`.
+ - `sortDescriptors`: the key paths and directions the results are sorted by, as an array of dictionaries with
+   `keyPath` and `ascending` keys.
+ - `estimatedRowsScanned`: the estimated number of objects looked at to evaluate the query.
+ - `matchedRows`: the number of objects matching the query, found by evaluating it.
+ - `evaluationTime`: the time it took to evaluate the query, in seconds.
+
+ The query is evaluated each time this method is called, so it should only be used while diagnosing slow queries.
+ */
+- (NSDictionary<NSString *, id> *)explain;
+
+/**
+ Sets a block to be called whenever evaluating the query of any `RLMResults` takes longer than `threshold` seconds.
+
+ Queries are timed when the results are first accessed and when they are re-evaluated after the Realm changes, by
+ reading the number of objects, an object, or the index of an object. The block is called synchronously on the thread
+ the query was evaluated on. Pass `nil` to stop timing queries, which is the default.
+
+ @param threshold   The evaluation time, in seconds, above which the block is called.
+ @param handler     The block to be called for slow queries.
+ */
++ (void)setSlowQueryThreshold:(NSTimeInterval)threshold handler:(nullable RLMSlowQueryBlock)handler;
+
 #pragma mark - Notifications
 
 /**
@@ -251,6 +679,166 @@ NS_ASSUME_NONNULL_BEGIN
                                                          RLMCollectionChange *__nullable change,
                                                          NSError *__nullable error))block __attribute__((warn_unused_result));
 
+/**
+ Registers a block to be called each time the results collection changes, but
+ only reports modifications to objects which changed the values at the given
+ key paths.
+
+ This works like `-addNotificationBlock:`, except that an object is only
+ reported as modified if the value at at least one of `keyPaths` changed, and
+ the block is not called at all if the only changes were to other properties
+ of the objects in the collection or to objects they link to. Insertions and
+ deletions are always reported.
+
+ Each key path is either the name of a property of the objects in the
+ collection or a path through to-one links such as `@"owner.name"`. The values
+ at the key paths are read when the initial notification is delivered and for
+ the objects reported as inserted or modified after that. For collections of
+ more than 1000 objects the values aren't read up front, so the first
+ modification of each object is always reported.
+
+ @warning This method cannot be called during a write transaction, or when the
+          containing Realm is read-only.
+
+ @param block    The block to be called whenever a change occurs.
+ @param keyPaths The key paths of the properties whose changes should be reported.
+ @return A token which must be held for as long as you want updates to be delivered.
+ */
+- (RLMNotificationToken *)addNotificationBlock:(void (^)(RLMResults<RLMObjectType> *__nullable results,
+                                                         RLMCollectionChange *__nullable change,
+                                                         NSError *__nullable error))block
+                                      keyPaths:(NSArray<NSString *> *)keyPaths __attribute__((warn_unused_result));
+
+/**
+ Registers a block to be called each time the results collection changes, but no more
+ often than once per `minimumInterval` seconds.
+
+ This works like `-addNotificationBlock:keyPaths:`, except that changes which
+ are committed within `minimumInterval` seconds of the last time the block was
+ called are not reported right away. They are merged together, and the block
+ is called once with the combined changes when the interval has passed. The
+ combined `RLMCollectionChange` describes the changes since the previous call,
+ so it can be applied to a `UITableView` in the same way as a single change,
+ while the table view is reloaded at a bounded rate.
+
+ Pass `nil` for `keyPaths` to report modifications to any property.
+
+ @warning This method cannot be called during a write transaction, or when the
+          containing Realm is read-only.
+
+ @param block           The block to be called whenever a change occurs.
+ @param keyPaths        The key paths of the properties whose changes should be
+                        reported, or `nil` for all properties.
+ @param minimumInterval The minimum time in seconds between calls to the block.
+ @return A token which must be held for as long as you want updates to be delivered.
+ */
+- (RLMNotificationToken *)addNotificationBlock:(void (^)(RLMResults<RLMObjectType> *__nullable results,
+                                                         RLMCollectionChange *__nullable change,
+                                                         NSError *__nullable error))block
+                                      keyPaths:(nullable NSArray<NSString *> *)keyPaths
+                               minimumInterval:(NSTimeInterval)minimumInterval __attribute__((warn_unused_result));
+
+/**
+ Registers a block to be called on the given dispatch queue each time the
+ results collection changes.
+
+ This works like `-addNotificationBlock:`, except that the block is called
+ asynchronously on `queue` rather than on the current thread, and the current
+ thread does not need to run a run loop. The notifications for all queues are
+ computed on a single background thread managed by Realm.
+
+ The `RLMResults` passed to the block belongs to a Realm opened for the thread
+ which the queue is running the block on, and must not be used after the
+ block returns. Use an `RLMThreadSafeReference` to pass it to other threads.
+
+ The token returned by this method cannot be passed to
+ `-[RLMRealm commitWriteTransactionWithoutNotifying:error:]`.
+
+ @warning This method cannot be called during a write transaction, or when the
+          containing Realm is read-only.
+
+ @param block The block to be called whenever a change occurs.
+ @param queue The serial queue to call the block on.
+ @return A token which must be held for as long as you want updates to be delivered.
+ */
+- (RLMNotificationToken *)addNotificationBlock:(void (^)(RLMResults<RLMObjectType> *__nullable results,
+                                                         RLMCollectionChange *__nullable change,
+                                                         NSError *__nullable error))block
+                                         queue:(dispatch_queue_t)queue __attribute__((warn_unused_result));
+
+/**
+ Evaluates the results on a background thread, and calls the block on the
+ current thread once they are ready.
+
+ The query is run and sorted by the same background machinery which computes
+ change notifications, so the calling thread is not blocked. Once the block is
+ called, reading the results (including their `count`) does not need to
+ evaluate the query again.
+
+ The block is called at most once, and the Realm holds a reference to it until
+ then, so the returned token does not need to be retained. Call `-stop` on the
+ token to cancel the evaluation.
+
+ @warning This method cannot be called during a write transaction, or when the
+          containing Realm is read-only.
+
+ @param completion The block to be called with the evaluated results, or with an
+                   error if they could not be evaluated.
+ @return A token which can be used to cancel the evaluation.
+ */
+- (RLMNotificationToken *)evaluateAsyncWithCompletion:(void (^)(RLMResults<RLMObjectType> *__nullable results,
+                                                                NSError *__nullable error))completion;
+
+/**
+ Registers a block to be called each time the results collection changes, with the changes described by the primary
+ keys of the objects rather than by their indices.
+
+ This is meant for data sources which identify items by stable identifiers, such as diffable data sources. The
+ primary keys of the objects in the results are read once, when the block is first called, and are afterwards kept
+ up to date from the changes computed for each notification, reading only the keys of the inserted objects, so the
+ work done for each notification is proportional to the size of the change rather than to the size of the results.
+
+ The first time the block is called, every object is reported as inserted. Objects which moved are reported as both
+ deleted and inserted. Notifications are otherwise delivered like those of `-addNotificationBlock:`.
+
+ @warning This method cannot be called during a write transaction, when the containing Realm is read-only, or when
+          the objects have no primary key.
+
+ @param block The block to be called with the identifiers and their changes whenever a change occurs.
+ @return A token which must be held for as long as you want updates to be delivered.
+ */
+- (RLMNotificationToken *)addIdentityNotificationBlock:(void (^)(RLMCollectionIdentityChange *__nullable change,
+                                                                 NSError *__nullable error))block __attribute__((warn_unused_result));
+
+#pragma mark - Sectioning Results
+
+/**
+ Returns an `RLMSectionedResults` which groups the objects in the results collection into sections by the value of
+ the given key path.
+
+ Each section is a run of consecutive objects with equal keys, so the results should normally be sorted by the key
+ path first. Objects for which the key path is `nil` are grouped under `NSNull`.
+
+ @param keyPath The key path whose value is the key of the section an object belongs to.
+
+ @return The sectioned results.
+ */
+- (RLMSectionedResults<RLMObjectType> *)sectionedResultsUsingKeyPath:(NSString *)keyPath;
+
+/**
+ Returns an `RLMSectionedResults` which groups the objects in the results collection into sections by the key which
+ the given block returns for each of them.
+
+ Each section is a run of consecutive objects with equal keys, as compared with `-isEqual:`. The block is called for
+ each object when the sections are first computed, and afterwards only for objects which have been inserted or
+ modified, so it should only depend on the object's own properties.
+
+ @param block   A block returning the key of the section an object belongs to. `nil` is treated as `NSNull`.
+
+ @return The sectioned results.
+ */
+- (RLMSectionedResults<RLMObjectType> *)sectionedResultsUsingBlock:(id<NSCopying> __nullable (^)(RLMObjectType object))block;
+
 #pragma mark - Aggregating Property Values
 
 /**
@@ -310,6 +898,183 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (nullable NSNumber *)averageOfProperty:(NSString *)property;
 
+/**
+ Returns the count, minimum, maximum, sum, average and variance of the values of a given property over the objects
+ represented by the results collection, all computed in a single pass over the objects.
+
+     RLMPropertyStatistics *stats = [results statisticsForProperty:@"age"];
+
+ @warning You cannot use this method on `RLMObject`, `RLMArray`, and `NSData` properties.
+
+ @param property The property whose statistics should be calculated. Only properties of types `int`, `float`, and
+                 `double` are supported.
+
+ @return The statistics of the given property.
+ */
+- (RLMPropertyStatistics *)statisticsForProperty:(NSString *)property;
+
+/**
+ Returns the objects in the results collection whose vectors in a vector property are nearest to the given vector,
+ nearest first.
+
+ The vectors are read directly from the Realm file and compared with the given vector in a single pass over the
+ objects, keeping only the nearest `limit` objects, so neither the vectors nor the objects which aren't returned are
+ copied. Objects whose vector is `nil` are skipped, as are objects whose distance from the given vector is `NaN`
+ because one of the vectors has a `NaN` component.
+
+     RLMResults<Photo *> *photos = [Photo allObjects];
+     NSArray<Photo *> *similar = [photos objectsNearestToVector:photo.embedding forProperty:@"embedding"
+                                                          limit:10 metric:RLMVectorDistanceMetricCosine];
+
+ @param vector      The vector to search for, holding as many floats as the property's vectors.
+ @param property    The name of a property listed in `+[RLMObject vectorProperties]`.
+ @param limit       The maximum number of objects to return.
+ @param metric      How the distance between vectors is measured.
+
+ @return The nearest objects, in order of increasing distance. Objects at the same distance are in the order of the
+         results collection.
+ */
+- (NSArray<RLMObjectType> *)objectsNearestToVector:(NSData *)vector
+                                       forProperty:(NSString *)property
+                                             limit:(NSUInteger)limit
+                                            metric:(RLMVectorDistanceMetric)metric;
+
+/**
+ Groups the objects represented by the results collection by the value of a property, and computes an aggregate of
+ another property for each group.
+
+     // The total amount for each category
+     NSDictionary *totals = [results groupedBy:@"category" aggregate:RLMAggregateFunctionSum ofProperty:@"amount"];
+
+ Objects are grouped by the value of an `int`, `bool` or string property, or by the primary key of the object linked
+ to by an object property. Objects with a `nil` group value are grouped under `NSNull`. The values are read directly
+ from the Realm in a single pass, without creating an object for each of the results.
+
+ @param groupProperty   The property whose values identify the groups.
+ @param function        The aggregate to compute for each group.
+ @param property        The property to aggregate. Only properties of types `int`, `float`, and `double` are
+                        supported. May be `nil` when counting objects.
+
+ @return A dictionary mapping each group value to the aggregate for the group. Groups where the aggregated property
+         has no values map to `NSNull`, except when counting or summing.
+ */
+- (NSDictionary<id, id> *)groupedBy:(NSString *)groupProperty
+                          aggregate:(RLMAggregateFunction)function
+                         ofProperty:(nullable NSString *)property;
+
+/**
+ Copies the values of the given property for the objects represented by the
+ results collection into a buffer, without creating an object or `NSNumber` for
+ each value.
+
+     double *values = malloc(results.count * sizeof(double));
+     NSUInteger count = [results copyValuesOfProperty:@"score" intoBuffer:values count:results.count];
+
+ The type of the buffer's elements depends on the type of the property: it must be
+ an array of `int64_t` for `int` properties, `float` for `float` properties, and
+ `double` for `double` properties. `nil` values of optional properties are copied
+ as `0` for `int` properties and as `NaN` for `float` and `double` properties.
+
+ @param property    The property whose values should be copied. Only properties of
+                    types `int`, `float`, and `double` are supported.
+ @param buffer      The buffer to copy the values into, which must have room for at
+                    least `count` values.
+ @param count       The maximum number of values to copy.
+
+ @return    The number of values copied, which is the smaller of `count` and the
+            number of objects in the results collection.
+ */
+- (NSUInteger)copyValuesOfProperty:(NSString *)property intoBuffer:(void *)buffer count:(NSUInteger)count;
+
+/**
+ Returns unmanaged copies of the objects represented by the results collection,
+ along with copies of all of the objects they link to.
+
+ The copies are a snapshot of the objects' current values which can be read
+ from any thread, and are unaffected by later changes to the Realm. Each object
+ is copied once, even if it is reachable from more than one of the objects in
+ the results collection. See `-[RLMObject detachedCopy]` for details.
+
+ @return An array containing unmanaged copies of the objects, in the order of
+         the results collection.
+ */
+- (NSArray<RLMObjectType> *)detachedCopy;
+
+/**
+ Reads the objects represented by the results collection on the given queue,
+ so that the parts of the Realm file they are stored in are in memory before
+ the objects are used.
+
+ Reading many objects from a Realm file which isn't in the operating system's
+ cache, such as on the first launch after a reboot, mostly waits for the file
+ to be read one page at a time. Prefetching the results on a background queue
+ before displaying or enumerating them moves that wait off the calling thread.
+ The query of the results is evaluated on the queue, and every property of
+ each matching object is read.
+
+ @warning This method cannot be called during a write transaction.
+
+ @param queue      The queue to read the objects on.
+ @param completion A block called on `queue` once the objects have been read.
+ */
+- (void)prefetchOnQueue:(dispatch_queue_t)queue completion:(nullable void (^)(void))completion;
+
+/**
+ Writes the given properties of the objects represented by the results
+ collection to a stream as CSV.
+
+ The values are read directly from the Realm file without creating an object
+ for each row, and are written to the stream in blocks as they are formatted,
+ so memory use doesn't depend on the number of objects. The first row contains
+ the property names, and each following row the values for one object:
+
+ - `nil` values are written as empty fields.
+ - Booleans are written as `true` or `false`.
+ - Dates are written in UTC in the RFC 3339 format, with millisecond precision.
+ - `NSData` values are base64 encoded.
+ - Fields containing commas, quotes or line breaks are quoted.
+
+ The stream is opened if it isn't already open, and is not closed.
+
+ @param stream     The stream to write to.
+ @param properties The names of the properties to write, in order. Object,
+                   array and linking objects properties cannot be written. If
+                   `nil`, every property which can be written is.
+ @param error      If writing to the stream fails, upon return contains an
+                   `NSError` object that describes the problem. If you are not
+                   interested in possible errors, pass in `NULL`.
+
+ @return Whether all of the objects were written.
+ */
+- (BOOL)writeCSVToStream:(NSOutputStream *)stream
+              properties:(nullable NSArray<NSString *> *)properties
+                   error:(NSError **)error;
+
+/**
+ Writes the given properties of the objects represented by the results
+ collection to a stream as CSV on the given queue.
+
+ The export reads the version of the Realm which the results collection
+ currently represents, even if the Realm is modified or advances before or
+ while it runs. That version is kept in the file until the export finishes.
+ See `-writeCSVToStream:properties:error:` for details of the format.
+
+ @warning This method cannot be called during a write transaction, or on
+          results from a read-only or synchronized Realm.
+
+ @param stream     The stream to write to. It must not be used by anything
+                   else until the completion block is called.
+ @param properties The names of the properties to write, or `nil` to write
+                   every property which can be written.
+ @param queue      The queue to perform the export on.
+ @param completion A block called on `queue` once the export has finished,
+                   with the error that stopped it, if any.
+ */
+- (void)writeCSVToStream:(NSOutputStream *)stream
+              properties:(nullable NSArray<NSString *> *)properties
+                   queue:(dispatch_queue_t)queue
+              completion:(nullable void (^)(NSError *_Nullable error))completion;
+
 /// :nodoc:
 - (RLMObjectType)objectAtIndexedSubscript:(NSUInteger)index;
 
@@ -329,6 +1094,145 @@ NS_ASSUME_NONNULL_BEGIN
 
 @end
 
+/**
+ An `RLMSectionedResultsChange` object describes the changes to an `RLMSectionedResults` reported by its
+ notifications, in terms of sections and of index paths within them.
+
+ The index paths of deleted and modified objects are in the previous sections, and the index paths of inserted
+ objects are in the new ones, so the changes can be passed directly to `UITableView`'s batch update methods:
+
+     [tv beginUpdates];
+     [tv deleteSections:changes.sectionDeletions withRowAnimation:UITableViewRowAnimationAutomatic];
+     [tv insertSections:changes.sectionInsertions withRowAnimation:UITableViewRowAnimationAutomatic];
+     [tv deleteRowsAtIndexPaths:changes.deletions withRowAnimation:UITableViewRowAnimationAutomatic];
+     [tv insertRowsAtIndexPaths:changes.insertions withRowAnimation:UITableViewRowAnimationAutomatic];
+     [tv reloadRowsAtIndexPaths:changes.modifications withRowAnimation:UITableViewRowAnimationAutomatic];
+     [tv endUpdates];
+
+ Objects in deleted or inserted sections are not reported individually. An object whose section key changed is
+ reported as a deletion from its old section and an insertion into its new one.
+ */
+/**
+ An `RLMCollectionIdentityChange` object describes the objects in an `RLMResults` and how they changed by their
+ primary keys, as reported by the blocks added with `-[RLMResults addIdentityNotificationBlock:]`.
+ */
+@interface RLMCollectionIdentityChange : NSObject
+
+/// The primary keys of all of the objects in the results, in order.
+@property (nonatomic, readonly) NSArray *identifiers;
+
+/// The primary keys of the objects which were removed from the results.
+@property (nonatomic, readonly) NSArray *deletedIdentifiers;
+
+/// The primary keys of the objects which were added to the results.
+@property (nonatomic, readonly) NSArray *insertedIdentifiers;
+
+/// The primary keys of the objects which were modified without being removed or added.
+@property (nonatomic, readonly) NSArray *modifiedIdentifiers;
+
+/// :nodoc:
+- (instancetype)init __attribute__((unavailable("RLMCollectionIdentityChange cannot be created directly")));
+
+/// :nodoc:
++ (instancetype)new __attribute__((unavailable("RLMCollectionIdentityChange cannot be created directly")));
+
+@end
+
+@interface RLMSectionedResultsChange : NSObject
+
+/// The indices of the sections in the previous version which have been removed.
+@property (nonatomic, readonly) NSIndexSet *sectionDeletions;
+
+/// The indices of the sections in the new version which were newly inserted.
+@property (nonatomic, readonly) NSIndexSet *sectionInsertions;
+
+/// The index paths in the previous sections of the objects which were removed.
+@property (nonatomic, readonly) NSArray<NSIndexPath *> *deletions;
+
+/// The index paths in the new sections of the objects which were inserted.
+@property (nonatomic, readonly) NSArray<NSIndexPath *> *insertions;
+
+/// The index paths in the previous sections of the objects which were modified.
+@property (nonatomic, readonly) NSArray<NSIndexPath *> *modifications;
+
+/// Returns the index paths of the deletions in the given previous section.
+- (NSArray<NSIndexPath *> *)deletionsInSection:(NSUInteger)section;
+
+/// Returns the index paths of the insertions in the given new section.
+- (NSArray<NSIndexPath *> *)insertionsInSection:(NSUInteger)section;
+
+/// Returns the index paths of the modifications in the given previous section.
+- (NSArray<NSIndexPath *> *)modificationsInSection:(NSUInteger)section;
+
+/// :nodoc:
+- (instancetype)init __attribute__((unavailable("RLMSectionedResultsChange cannot be created directly")));
+
+/// :nodoc:
++ (instancetype)new __attribute__((unavailable("RLMSectionedResultsChange cannot be created directly")));
+
+@end
+
+/**
+ `RLMSectionedResults` groups the objects in an `RLMResults` into sections, such as messages grouped by day, for
+ display in a sectioned table view.
+
+ `RLMSectionedResults` are obtained with `-[RLMResults sectionedResultsUsingKeyPath:]` or
+ `-[RLMResults sectionedResultsUsingBlock:]`. The sections are computed when the sectioned results are created, and
+ are then kept up to date by the notification blocks added with `-addNotificationBlock:`. Each notification updates
+ the sections from the changes to the results rather than computing them again, so only the keys of the inserted and
+ modified objects are read. Without a notification block the sections are computed again when they're next read after
+ the Realm has been refreshed, and each time they're read during a write transaction.
+ */
+@interface RLMSectionedResults<RLMObjectType: RLMObject *> : NSObject
+
+/// The results collection whose objects are sectioned.
+@property (nonatomic, readonly) RLMResults<RLMObjectType> *results;
+
+/// The number of sections.
+@property (nonatomic, readonly) NSUInteger numberOfSections;
+
+/// The key of each section, in order.
+@property (nonatomic, readonly) NSArray<id<NSCopying>> *sectionKeys;
+
+/**
+ Returns the number of objects in a section.
+
+ @param section The index of the section.
+ */
+- (NSUInteger)numberOfObjectsInSection:(NSUInteger)section;
+
+/**
+ Returns the object at an index path.
+
+ @param indexPath   An index path made up of the index of a section and the index of an object within it.
+ */
+- (RLMObjectType)objectAtIndexPath:(NSIndexPath *)indexPath;
+
+/**
+ Registers a block to be called each time the sectioned results change.
+
+ The block is called asynchronously with the initial sections and a `nil` change, and then after each write
+ transaction which changes the results, after the sections have been updated, with an `RLMSectionedResultsChange`
+ describing how they changed. Notifications are delivered like those of `-[RLMResults addNotificationBlock:]`.
+
+ You must retain the returned token for as long as you want updates to continue to be sent to the block. To stop
+ receiving updates, call `-stop` on the token.
+
+ @param block The block to be called whenever a change occurs.
+ @return A token which must be held for as long as you want updates to be delivered.
+ */
+- (RLMNotificationToken *)addNotificationBlock:(void (^)(RLMSectionedResults<RLMObjectType> *__nullable sectionedResults,
+                                                         RLMSectionedResultsChange *__nullable change,
+                                                         NSError *__nullable error))block __attribute__((warn_unused_result));
+
+/// :nodoc:
+- (instancetype)init __attribute__((unavailable("RLMSectionedResults cannot be created directly")));
+
+/// :nodoc:
++ (instancetype)new __attribute__((unavailable("RLMSectionedResults cannot be created directly")));
+
+@end
+
 /**
  `RLMLinkingObjects` is an auto-updating container type. It represents a collection of objects that link to its
  parent object.
@@ -18,6 +18,7 @@
 
 #import "RLMResults_Private.h"
 
+#import "RLMAccessor.h"
 #import "RLMArray_Private.hpp"
 #import "RLMCollection_Private.hpp"
 #import "RLMObjectSchema_Private.hpp"
@@ -26,17 +27,32 @@
 #import "RLMObservation.hpp"
 #import "RLMProperty_Private.h"
 #import "RLMQueryUtil.hpp"
+#import "RLMRealmConfiguration.h"
 #import "RLMRealm_Private.hpp"
 #import "RLMSchema_Private.h"
 #import "RLMThreadSafeReference_Private.hpp"
 #import "RLMUtil.hpp"
 
 #import "results.hpp"
+#import "shared_realm.hpp"
 
 #import <objc/runtime.h>
 #import <objc/message.h>
+#import <realm/group_shared.hpp>
+#import <realm/history.hpp>
+#import <realm/link_view.hpp>
 #import <realm/table_view.hpp>
 
+#import <algorithm>
+#import <atomic>
+#import <chrono>
+#import <cstdarg>
+#import <cstdio>
+#import <ctime>
+#import <mutex>
+#import <unordered_map>
+#import <unordered_set>
+
 using namespace realm;
 
 #pragma clang diagnostic push
@@ -45,6 +61,115 @@ using namespace realm;
 @end
 #pragma clang diagnostic pop
 
+@interface RLMResultsHandoverMetadata : NSObject
+@property (nonatomic) NSArray<RLMSortDescriptor *> *sortDescriptors;
+@property (nonatomic) NSArray *filters;
+@property (nonatomic) BOOL derivedFromTable;
+@property (nonatomic) NSString *queryIdentity;
+@end
+
+@implementation RLMResultsHandoverMetadata
+@end
+
+@class RLMSectionedResultsNotificationToken;
+
+@interface RLMCollectionIdentityChange ()
+- (instancetype)initWithIdentifiers:(NSArray *)identifiers deleted:(NSArray *)deleted
+                           inserted:(NSArray *)inserted modified:(NSArray *)modified;
+@end
+
+@interface RLMSectionedResults ()
+- (instancetype)initWithResults:(RLMResults *)results keyBlock:(id<NSCopying> (^)(id))keyBlock;
+- (void)removeToken:(RLMSectionedResultsNotificationToken *)token;
+@end
+
+@implementation RLMQueryCondition
+
+- (instancetype)initWithKind:(RLMQueryConditionKind)kind {
+    if ((self = [super init])) {
+        _kind = kind;
+    }
+    return self;
+}
+
++ (instancetype)conditionWithProperty:(NSString *)propertyName operator:(RLMQueryOperator)queryOperator value:(id)value {
+    RLMQueryCondition *condition = [[self alloc] initWithKind:RLMQueryConditionKindComparison];
+    condition->_propertyName = [propertyName copy];
+    condition->_queryOperator = queryOperator;
+    condition->_value = [value conformsToProtocol:@protocol(NSCopying)] ? [value copy] : value;
+    return condition;
+}
+
++ (instancetype)conditionWithProperty:(NSString *)propertyName operator:(RLMQueryOperator)queryOperator
+                 caseInsensitiveValue:(NSString *)value {
+    RLMQueryCondition *condition = [self conditionWithProperty:propertyName operator:queryOperator value:value];
+    condition->_caseInsensitive = YES;
+    return condition;
+}
+
++ (instancetype)conditionWithProperty:(NSString *)propertyName operator:(RLMQueryOperator)queryOperator
+     caseAndDiacriticInsensitiveValue:(NSString *)value {
+    RLMQueryCondition *condition = [self conditionWithProperty:propertyName operator:queryOperator
+                                          caseInsensitiveValue:value];
+    condition->_diacriticInsensitive = YES;
+    return condition;
+}
+
++ (instancetype)conditionMatchingAll:(NSArray<RLMQueryCondition *> *)conditions {
+    if (!conditions) {
+        @throw RLMException(@"The conditions to combine must not be nil.");
+    }
+    RLMQueryCondition *condition = [[self alloc] initWithKind:RLMQueryConditionKindAll];
+    condition->_conditions = [conditions copy];
+    return condition;
+}
+
++ (instancetype)conditionMatchingAny:(NSArray<RLMQueryCondition *> *)conditions {
+    if (!conditions) {
+        @throw RLMException(@"The conditions to combine must not be nil.");
+    }
+    RLMQueryCondition *condition = [[self alloc] initWithKind:RLMQueryConditionKindAny];
+    condition->_conditions = [conditions copy];
+    return condition;
+}
+
++ (instancetype)conditionNegating:(RLMQueryCondition *)negated {
+    if (!negated) {
+        @throw RLMException(@"The condition to negate must not be nil.");
+    }
+    RLMQueryCondition *condition = [[self alloc] initWithKind:RLMQueryConditionKindNot];
+    condition->_conditions = @[negated];
+    return condition;
+}
+
+// Described in the predicate format, which also identifies the query in
+// keys such as those of materialized results
+- (NSString *)description {
+    switch (_kind) {
+        case RLMQueryConditionKindComparison: {
+            static NSString *const operators[] = {@"==", @"!=", @"<", @"<=", @">", @">=",
+                                                  @"BEGINSWITH", @"ENDSWITH", @"CONTAINS"};
+            NSString *op = _queryOperator >= 0 && _queryOperator <= RLMQueryOperatorContains
+                         ? operators[_queryOperator] : [NSString stringWithFormat:@"<operator %ld>", (long)_queryOperator];
+            return [NSString stringWithFormat:@"%@ %@%@ %@", _propertyName, op, _diacriticInsensitive ? @"[cd]" : _caseInsensitive ? @"[c]" : @"",
+                    [NSExpression expressionForConstantValue:_value]];
+        }
+        case RLMQueryConditionKindAll:
+        case RLMQueryConditionKindAny: {
+            if (_conditions.count == 0) {
+                return _kind == RLMQueryConditionKindAll ? @"TRUEPREDICATE" : @"FALSEPREDICATE";
+            }
+            NSString *separator = _kind == RLMQueryConditionKindAll ? @" AND " : @" OR ";
+            return [NSString stringWithFormat:@"(%@)", [[_conditions valueForKey:@"description"]
+                                                        componentsJoinedByString:separator]];
+        }
+        case RLMQueryConditionKindNot:
+            return [NSString stringWithFormat:@"NOT (%@)", _conditions.firstObject];
+    }
+}
+
+@end
+
 @interface RLMResults () <RLMThreadConfined_Private>
 @end
 
@@ -55,6 +180,13 @@ using namespace realm;
     realm::Results _results;
     RLMRealm *_realm;
     RLMClassInfo *_info;
+    // Set once a notification block has been added, after which the table
+    // view is kept up to date by the notifier rather than counting the query
+    bool _observed;
+    // The count of the query, valid while the Realm's _readGeneration is
+    // _queryCountGeneration - 1 outside of a write transaction
+    size_t _queryCount;
+    uint64_t _queryCountGeneration;
 }
 
 - (instancetype)initPrivate {
@@ -112,6 +244,98 @@ static auto translateErrors(Function&& f, NSString *aggregateMethod=nil) {
     }
 }
 
+static std::atomic<bool> s_timeQueries{false};
+static std::mutex s_slowQueryMutex;
+static NSTimeInterval s_slowQueryThreshold;
+static RLMSlowQueryBlock s_slowQueryHandler;
+// Set in the thread dictionary while the handler is running so that it can
+// use the results it is passed without being reported again
+static NSString *const RLMReportingSlowQueryKey = @"RLMReportingSlowQuery";
+
++ (void)setSlowQueryThreshold:(NSTimeInterval)threshold handler:(RLMSlowQueryBlock)handler {
+    std::lock_guard<std::mutex> lock(s_slowQueryMutex);
+    s_slowQueryThreshold = threshold;
+    s_slowQueryHandler = handler;
+    s_timeQueries = handler != nil;
+}
+
+static void reportQueryTime(__unsafe_unretained RLMResults *const results,
+                            std::chrono::steady_clock::time_point start) {
+    NSTimeInterval duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    RLMSlowQueryBlock handler;
+    {
+        std::lock_guard<std::mutex> lock(s_slowQueryMutex);
+        if (duration <= s_slowQueryThreshold) {
+            return;
+        }
+        handler = s_slowQueryHandler;
+    }
+    NSMutableDictionary *threadDictionary = NSThread.currentThread.threadDictionary;
+    if (handler && !threadDictionary[RLMReportingSlowQueryKey]) {
+        threadDictionary[RLMReportingSlowQueryKey] = @YES;
+        handler(results, duration);
+        [threadDictionary removeObjectForKey:RLMReportingSlowQueryKey];
+    }
+}
+
+// The details of a slow query for the slow operation handler of the
+// configuration; see RLMSlowOperationBlock
+static NSDictionary *slowQueryDetails(__unsafe_unretained RLMResults *const results) {
+    NSMutableDictionary *details = [NSMutableDictionary dictionary];
+    details[@"className"] = results.objectClassName;
+    if (results.filters.count) {
+        NSMutableArray *conditions = [NSMutableArray arrayWithCapacity:results.filters.count];
+        for (id filter in results.filters) {
+            [conditions addObject:[filter isKindOfClass:[NSPredicate class]] ? [filter predicateFormat] : [filter description]];
+        }
+        details[@"predicate"] = [conditions componentsJoinedByString:@" AND "];
+    }
+    if (results.sortDescriptors.count) {
+        NSMutableArray *sortDescriptors = [NSMutableArray arrayWithCapacity:results.sortDescriptors.count];
+        for (RLMSortDescriptor *descriptor in results.sortDescriptors) {
+            [sortDescriptors addObject:[(descriptor.ascending ? @"+" : @"-") stringByAppendingString:descriptor.keyPath]];
+        }
+        details[@"sortDescriptors"] = sortDescriptors;
+    }
+    if (results->_info) {
+        if (auto table = results->_info->table()) {
+            details[@"rowCount"] = @(table->size());
+        }
+    }
+    return details;
+}
+
+// Call `f`, which may evaluate the query of `results`, and report it to the
+// slow query handler and the configuration's slow operation handler if it
+// took too long
+template<typename Function>
+static auto timeQuery(__unsafe_unretained RLMResults *const results, Function&& f) {
+    RLMSignpost signpost(RLMSignpostName::EvaluateResults, [&] {
+        return results->_info ? results->_info->rlmObjectSchema.className : @"(detached)";
+    });
+    if (signpost.active() && results->_info) {
+        if (auto table = results->_info->table()) {
+            signpost.setRowCount(table->size());
+        }
+    }
+    bool timeForRealm = RLMShouldTimeOperations(results->_realm);
+    bool timeForHandler = s_timeQueries.load(std::memory_order_relaxed);
+    if (!timeForRealm && !timeForHandler) {
+        return f();
+    }
+    auto start = std::chrono::steady_clock::now();
+    auto result = f();
+    if (timeForHandler) {
+        reportQueryTime(results, start);
+    }
+    if (timeForRealm) {
+        RLMReportSlowOperation(results->_realm, RLMSlowOperationQuery, start, ^{
+            return slowQueryDetails(results);
+        });
+    }
+    return result;
+}
+
 + (instancetype)resultsWithObjectInfo:(RLMClassInfo&)info
                               results:(realm::Results)results {
     RLMResults *ar = [[self alloc] initPrivate];
@@ -134,8 +358,54 @@ static inline void RLMResultsValidateInWriteTransaction(__unsafe_unretained RLMR
     return translateErrors([&] { return !_results.is_valid(); });
 }
 
+// Results backed by a query which haven't been made distinct or observed can
+// be counted and searched by the query directly, without building the table
+// view Results would otherwise materialize. The sort order doesn't change
+// which rows match. Observed results have a notifier which runs the query in
+// the background, and once it has delivered a table view they're no longer
+// backed by a query.
+static bool RLMResultsCanUseQuery(realm::Results& results, bool observed) {
+    return !observed && results.get_mode() == Results::Mode::Query && !results.get_distinct();
+}
+
 - (NSUInteger)count {
-    return translateErrors([&] { return _results.size(); });
+    return timeQuery(self, [&] {
+        return translateErrors([&] {
+            if (RLMResultsCanUseQuery(_results, _observed)) {
+                // The count can only change when the Realm advances to a new
+                // version or within a write transaction
+                bool cacheable = !_realm->_realm->is_in_transaction();
+                if (cacheable && _queryCountGeneration == _realm->_readGeneration + 1) {
+                    return _queryCount;
+                }
+                Query query = _results.get_query();
+                query.sync_view_if_needed();
+                size_t count = query.count();
+                if (cacheable) {
+                    _queryCount = count;
+                    _queryCountGeneration = _realm->_readGeneration + 1;
+                }
+                return count;
+            }
+            return _results.size();
+        });
+    });
+}
+
+- (BOOL)exists {
+    return timeQuery(self, [&] {
+        return translateErrors([&] {
+            if (RLMResultsCanUseQuery(_results, _observed)) {
+                if (!_realm->_realm->is_in_transaction() && _queryCountGeneration == _realm->_readGeneration + 1) {
+                    return _queryCount != 0;
+                }
+                Query query = _results.get_query();
+                query.sync_view_if_needed();
+                return query.find() != realm::not_found;
+            }
+            return _results.size() != 0;
+        });
+    });
 }
 
 - (NSString *)objectClassName {
@@ -185,7 +455,7 @@ static inline void RLMResultsValidateInWriteTransaction(__unsafe_unretained RLMR
     }
 
     Query query = translateErrors([&] { return _results.get_query(); });
-    query.and_query(RLMPredicateToQuery(predicate, _info->rlmObjectSchema, _realm.schema, _realm.group));
+    query.and_query(RLMPredicateToQuery(predicate, *_info));
     query.sync_view_if_needed();
 
 #if REALM_VER_MAJOR >= 2
@@ -222,28 +492,225 @@ static inline void RLMResultsValidateInWriteTransaction(__unsafe_unretained RLMR
 }
 
 - (id)objectAtIndex:(NSUInteger)index {
-    return translateErrors([&] {
-        return RLMCreateObjectAccessor(_realm, *_info, _results.get(index));
+    auto row = timeQuery(self, [&] {
+        return translateErrors([&] { return _results.get(index); });
     });
+    return RLMCreateObjectAccessor(_realm, *_info, row);
 }
 
 - (id)firstObject {
-    auto row = translateErrors([&] { return _results.first(); });
+    auto row = timeQuery(self, [&] {
+        return translateErrors([&] { return _results.first(); });
+    });
     return row ? RLMCreateObjectAccessor(_realm, *_info, *row) : nil;
 }
 
 - (id)lastObject {
-    auto row = translateErrors([&] { return _results.last(); });
+    auto row = timeQuery(self, [&] {
+        return translateErrors([&] { return _results.last(); });
+    });
     return row ? RLMCreateObjectAccessor(_realm, *_info, *row) : nil;
 }
 
+- (NSArray *)objectsAtIndexes:(NSIndexSet *)indexes {
+    // Checking the count verifies the thread and brings the results up to
+    // date once, so each row can then be read without repeating either
+    size_t count = timeQuery(self, [&] {
+        return translateErrors([&] { return _results.size(); });
+    });
+    if (indexes.lastIndex != NSNotFound && indexes.lastIndex >= count) {
+        @throw RLMException(@"Index %llu is out of bounds (must be less than %llu).",
+                            (unsigned long long)indexes.lastIndex, (unsigned long long)count);
+    }
+
+    NSMutableArray *objects = [NSMutableArray arrayWithCapacity:indexes.count];
+    translateErrors([&] {
+        bool isTable = _results.get_mode() == Results::Mode::Table;
+        for (NSUInteger index = indexes.firstIndex; index != NSNotFound; index = [indexes indexGreaterThanIndex:index]) {
+            [objects addObject:isTable ? RLMCreateObjectAccessor(_realm, *_info, index)
+                                       : RLMCreateObjectAccessor(_realm, *_info, _results.get(index))];
+        }
+    });
+    return objects;
+}
+
+- (id<NSFastEnumeration>)objectsIncludingKeyPaths:(NSArray<NSString *> *)keyPaths {
+    return [[RLMIncludingKeyPathsEnumerable alloc] initWithCollection:self keyPaths:keyPaths];
+}
+
+- (id<NSFastEnumeration>)objectsReusingAccessor {
+    return [[RLMReusingAccessorEnumerable alloc] initWithCollection:self];
+}
+
+- (void)enumerateObjectsReusingAccessor:(void (^)(id, NSUInteger, BOOL *))block {
+    NSUInteger index = 0;
+    BOOL stop = NO;
+    for (id object in self.objectsReusingAccessor) {
+        block(object, index++, &stop);
+        if (stop) {
+            break;
+        }
+    }
+}
+
+- (NSArray *)pageStartingAfter:(RLMObject *)object limit:(NSUInteger)limit {
+    if (_results.get_mode() == Results::Mode::Empty || limit == 0) {
+        return @[];
+    }
+    if (object && !object->_realm && !object.invalidated) {
+        @throw RLMException(@"Cannot start a page after an unmanaged object.");
+    }
+
+    NSMutableArray *page = [NSMutableArray array];
+    translateErrors([&] {
+        size_t start = 0, end;
+        if (_results.get_mode() == Results::Mode::Table) {
+            // Rows are stored in the same order as they appear in the results,
+            // so the page can be read directly from the table without
+            // evaluating the rest of the results
+            _realm->_realm->verify_thread();
+            if (object) {
+                if (!object->_row.is_attached()) {
+                    @throw RLMException(@"Object has been invalidated");
+                }
+                if (object->_row.get_table() != _info->table()) {
+                    @throw RLMException(@"Object type '%@' does not match RLMResults type '%@'.",
+                                        object->_objectSchema.className, self.objectClassName);
+                }
+                start = object->_row.get_index() + 1;
+            }
+            end = _info->table()->size();
+        }
+        else {
+            if (object) {
+                size_t index = _results.index_of(object->_row);
+                if (index == realm::not_found) {
+                    @throw RLMException(@"Object is not in the RLMResults.");
+                }
+                start = index + 1;
+            }
+            end = _results.size();
+        }
+        if (start < end) {
+            end = start + std::min<size_t>(limit, end - start);
+        }
+        for (size_t i = start; i < end; ++i) {
+            [page addObject:_results.get_mode() == Results::Mode::Table
+                            ? RLMCreateObjectAccessor(_realm, *_info, i)
+                            : RLMCreateObjectAccessor(_realm, *_info, _results.get(i))];
+        }
+    });
+    return page;
+}
+
+- (void)concurrentEnumerateWithOptions:(NSEnumerationOptions)options
+                            usingBlock:(void (^)(id, NSUInteger, BOOL *))block {
+    bool reverse = options & NSEnumerationReverse;
+    NSUInteger count = self.count;
+    if (!(options & NSEnumerationConcurrent)) {
+        BOOL stop = NO;
+        for (NSUInteger i = 0; i < count && !stop; ++i) {
+            @autoreleasepool {
+                NSUInteger index = reverse ? count - i - 1 : i;
+                block([self objectAtIndex:index], index, &stop);
+            }
+        }
+        return;
+    }
+
+    if (_realm.inWriteTransaction) {
+        @throw RLMException(@"Cannot enumerate results concurrently during a write transaction.");
+    }
+    if (count == 0) {
+        return;
+    }
+
+    // Each thread needs its own reference to resolve, as they can only be
+    // resolved once
+    NSUInteger workerCount = std::min<NSUInteger>(NSProcessInfo.processInfo.activeProcessorCount, count);
+    NSMutableArray<RLMThreadSafeReference *> *references = [NSMutableArray arrayWithCapacity:workerCount];
+    for (NSUInteger i = 0; i < workerCount; ++i) {
+        [references addObject:[RLMThreadSafeReference referenceWithThreadConfined:self]];
+    }
+    RLMRealmConfiguration *configuration = _realm.configuration;
+
+    // The ranges are computed from the count at the caller's version, so every
+    // worker reads that version by opening the Realm at it. Versions can't be
+    // pinned for synchronized or read-only Realms, so for those the version
+    // each worker resolves the results at is only checked.
+    auto readVersion = [](RLMRealm *realm) {
+        return translateErrors([&] {
+            realm->_realm->read_group();
+            return _impl::RealmFriend::get_shared_group(*realm->_realm).get_version_of_current_transaction();
+        });
+    };
+    SharedGroup::VersionID version = readVersion(_realm);
+    RLMRealmVersion *pinnedVersion = _realm.pinnedVersion;
+    if (!pinnedVersion && !_realm->_realm->config().sync_config && !_realm->_realm->config().read_only()) {
+        pinnedVersion = [_realm currentVersion];
+    }
+
+    // dispatch_apply() doesn't return until every worker is done, so these can
+    // live on the stack
+    std::atomic<bool> stopped{false};
+    std::atomic<bool> *stoppedPtr = &stopped;
+    __block NSException *exception;
+    NSObject *exceptionLock = [NSObject new];
+
+    dispatch_apply(workerCount, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t worker) {
+        @autoreleasepool {
+            @try {
+                NSError *error;
+                RLMRealm *realm = [RLMRealm realmWithConfiguration:configuration error:&error];
+                if (realm && pinnedVersion) {
+                    realm = [realm realmAtVersion:pinnedVersion error:&error];
+                }
+                if (!realm) {
+                    @throw RLMException(@"Could not open the Realm to enumerate results on a background thread: %@",
+                                        error.localizedDescription);
+                }
+                RLMResults *results = [realm resolveThreadSafeReference:references[worker]];
+                if (readVersion(realm) != version) {
+                    @throw RLMException(@"Cannot enumerate results concurrently while the Realm is being modified.");
+                }
+                NSUInteger begin = count * worker / workerCount;
+                NSUInteger end = std::min(count * (worker + 1) / workerCount, results.count);
+                for (NSUInteger i = begin; i < end && !stoppedPtr->load(); ++i) {
+                    @autoreleasepool {
+                        NSUInteger index = reverse ? end - (i - begin) - 1 : i;
+                        BOOL stop = NO;
+                        block([results objectAtIndex:index], index, &stop);
+                        if (stop) {
+                            stoppedPtr->store(true);
+                        }
+                    }
+                }
+            }
+            @catch (NSException *e) {
+                @synchronized (exceptionLock) {
+                    if (!exception) {
+                        exception = e;
+                    }
+                }
+                stoppedPtr->store(true);
+            }
+        }
+    });
+
+    if (exception) {
+        @throw exception;
+    }
+}
+
 - (NSUInteger)indexOfObject:(RLMObject *)object {
     if (!object || (!object->_realm && !object.invalidated)) {
         return NSNotFound;
     }
 
-    return translateErrors([&] {
-        return RLMConvertNotFound(_results.index_of(object->_row));
+    return timeQuery(self, [&] {
+        return translateErrors([&] {
+            return RLMConvertNotFound(_results.index_of(object->_row));
+        });
     });
 }
 
@@ -278,11 +745,23 @@ static inline void RLMResultsValidateInWriteTransaction(__unsafe_unretained RLMR
     });
 }
 
+- (void)enumerateValuesForProperties:(NSArray<NSString *> *)propertyNames
+                          usingBlock:(void (^)(NSArray *, NSUInteger, BOOL *))block {
+    translateErrors([&] {
+        RLMCollectionEnumerateValues(self, propertyNames, block);
+    });
+}
+
 - (void)setValue:(id)value forKey:(NSString *)key {
     translateErrors([&] { RLMResultsValidateInWriteTransaction(self); });
     RLMCollectionSetValueForKey(self, key, value);
 }
 
+- (void)incrementProperty:(NSString *)propertyName by:(NSInteger)amount {
+    translateErrors([&] { RLMResultsValidateInWriteTransaction(self); });
+    RLMCollectionIncrementProperty(self, propertyName, amount);
+}
+
 - (NSNumber *)_aggregateForKeyPath:(NSString *)keyPath method:(util::Optional<Mixed> (Results::*)(size_t))method
                         methodName:(NSString *)methodName returnNilForEmpty:(BOOL)returnNilForEmpty {
     assertKeyPathIsNotNested(keyPath);
@@ -316,25 +795,58 @@ static inline void RLMResultsValidateInWriteTransaction(__unsafe_unretained RLMR
     return [NSSet setWithArray:[self _unionOfObjectsForKeyPath:keyPath]].allObjects;
 }
 
-- (NSArray *)_unionOfArraysForKeyPath:(NSString *)keyPath {
+- (NSArray *)unionOfArraysForKeyPath:(NSString *)keyPath distinct:(bool)distinct {
     assertKeyPathIsNotNested(keyPath);
     if ([keyPath isEqualToString:@"self"]) {
-        @throw RLMException(@"self is not a valid key-path for a KVC array collection operator as 'unionOfArrays'.");
+        @throw RLMException(@"self is not a valid key-path for a KVC array collection operator as '%@'.",
+                            distinct ? @"distinctUnionOfArrays" : @"unionOfArrays");
+    }
+
+    RLMProperty *prop = _results.get_mode() == Results::Mode::Empty ? nil : _info->rlmObjectSchema[keyPath];
+    if (prop.type != RLMPropertyTypeArray) {
+        return translateErrors([&] {
+            NSArray *nestedResults = RLMCollectionValueForKey(self, keyPath);
+            NSMutableArray *flatArray = [NSMutableArray arrayWithCapacity:nestedResults.count];
+            for (id<RLMFastEnumerable> array in nestedResults) {
+                NSArray *nsArray = RLMCollectionValueForKey(array, @"self");
+                [flatArray addObjectsFromArray:nsArray];
+            }
+            return distinct ? [NSSet setWithArray:flatArray].allObjects : flatArray;
+        });
     }
 
+    // Read the target rows directly from the link lists rather than creating
+    // an RLMArray for each object, and for the distinct union only create an
+    // accessor for the first occurrence of each target row
+    size_t column = _info->tableColumn(prop);
+    RLMClassInfo& targetInfo = _info->linkTargetType(prop.index);
     return translateErrors([&] {
-        NSArray *nestedResults = RLMCollectionValueForKey(self, keyPath);
-        NSMutableArray *flatArray = [NSMutableArray arrayWithCapacity:nestedResults.count];
-        for (id<RLMFastEnumerable> array in nestedResults) {
-            NSArray *nsArray = RLMCollectionValueForKey(array, @"self");
-            [flatArray addObjectsFromArray:nsArray];
+        auto tv = _results.get_tableview();
+        Table& table = *_info->table();
+        NSMutableArray *flatArray = [NSMutableArray array];
+        std::unordered_set<size_t> seen;
+        for (size_t i = 0, size = tv.size(); i < size; ++i) {
+            if (!tv.is_row_attached(i)) {
+                continue;
+            }
+            auto linkView = table.get_linklist(column, tv.get_source_ndx(i));
+            for (size_t j = 0, count = linkView->size(); j < count; ++j) {
+                size_t target = linkView->get(j).get_index();
+                if (!distinct || seen.insert(target).second) {
+                    [flatArray addObject:RLMCreateObjectAccessor(_realm, targetInfo, target)];
+                }
+            }
         }
         return flatArray;
     });
 }
 
-- (NSArray *)_distinctUnionOfArraysForKeyPath:(__unused NSString *)keyPath {
-    return [NSSet setWithArray:[self _unionOfArraysForKeyPath:keyPath]].allObjects;
+- (NSArray *)_unionOfArraysForKeyPath:(NSString *)keyPath {
+    return [self unionOfArraysForKeyPath:keyPath distinct:false];
+}
+
+- (NSArray *)_distinctUnionOfArraysForKeyPath:(NSString *)keyPath {
+    return [self unionOfArraysForKeyPath:keyPath distinct:true];
 }
 
 - (RLMResults *)objectsWhere:(NSString *)predicateFormat, ... {
@@ -354,8 +866,184 @@ static inline void RLMResultsValidateInWriteTransaction(__unsafe_unretained RLMR
         if (_results.get_mode() == Results::Mode::Empty) {
             return self;
         }
-        auto query = RLMPredicateToQuery(predicate, _info->rlmObjectSchema, _realm.schema, _realm.group);
-        return [RLMResults resultsWithObjectInfo:*_info results:_results.filter(std::move(query))];
+        auto query = RLMPredicateToQuery(predicate, *_info);
+        return [self resultsWithQuery:std::move(query) filter:predicate];
+    });
+}
+
+- (RLMResults *)objectsMatchingCondition:(RLMQueryCondition *)condition {
+    return translateErrors([&] {
+        if (_results.get_mode() == Results::Mode::Empty) {
+            return self;
+        }
+        auto query = RLMConditionToQuery(*_info, condition);
+        return [self resultsWithQuery:std::move(query)
+                               filter:@{@"type": @"condition", @"condition": condition.description,
+                                        @"strategy": @"scan"}];
+    });
+}
+
+- (RLMResults *)objectsMatchingText:(NSString *)text inProperties:(NSArray<NSString *> *)propertyNames {
+    return translateErrors([&] {
+        if (_results.get_mode() == Results::Mode::Empty) {
+            return self;
+        }
+        auto query = RLMTextSearchQuery(*_info, text, propertyNames);
+        return [self resultsWithQuery:std::move(query)
+                               filter:@{@"type": @"textSearch", @"text": text,
+                                        @"properties": [propertyNames copy], @"strategy": @"scan"}];
+    });
+}
+
+- (RLMResults *)objectsWithinDistance:(double)distance ofLatitude:(double)latitude longitude:(double)longitude
+                             geoIndex:(NSString *)geoIndex {
+    return translateErrors([&] {
+        if (_results.get_mode() == Results::Mode::Empty) {
+            return self;
+        }
+        auto query = RLMGeoRadiusQuery(*_info, geoIndex, latitude, longitude, distance);
+        return [self resultsWithQuery:std::move(query)
+                               filter:@{@"type": @"geoDistance", @"geoIndex": geoIndex, @"latitude": @(latitude),
+                                        @"longitude": @(longitude), @"distance": @(distance), @"strategy": @"geoIndex"}];
+    });
+}
+
+// Filtering results preserves their sort order, so the results it produces
+// are sorted by the same descriptors. `filter` is the predicate or the
+// description of the condition the query adds, used by -explain.
+- (RLMResults *)resultsWithQuery:(realm::Query)query filter:(id)filter {
+    RLMResults *results = [RLMResults resultsWithObjectInfo:*_info results:_results.filter(std::move(query))];
+    results.sortDescriptors = _sortDescriptors;
+    results.filters = _filters ? [_filters arrayByAddingObject:filter] : @[filter];
+    results.derivedFromTable = _derivedFromTable;
+    if (_queryIdentity && [filter isKindOfClass:[NSPredicate class]]) {
+        if (NSString *identity = RLMPredicateIdentity(filter)) {
+            results.queryIdentity = [NSString stringWithFormat:@"%@\nfilter:%@", _queryIdentity, identity];
+        }
+    }
+    return results;
+}
+
+- (RLMResults *)distinctResultsUsingKeyPaths:(NSArray<NSString *> *)keyPaths {
+    if (keyPaths.count == 0) {
+        return self;
+    }
+    return translateErrors([&] {
+        if (_results.get_mode() == Results::Mode::Empty) {
+            return self;
+        }
+        auto distinct = RLMDistinctDescriptorFromKeyPaths(*_info, keyPaths);
+        RLMResults *results = [RLMResults resultsWithObjectInfo:*_info results:_results.distinct(std::move(distinct))];
+        results.sortDescriptors = _sortDescriptors;
+        results.filters = _filters;
+        results.derivedFromTable = _derivedFromTable;
+        return results;
+    });
+}
+
+// The key identifies the query of the results, so that rows stored for a
+// different query under the same name aren't used. The sort order and
+// distinct key paths are applied to the stored rows rather than stored.
+static NSString *RLMMaterializedQueryKey(RLMResults *results, uint64_t schemaVersion) {
+    NSMutableArray *components = [NSMutableArray arrayWithObjects:results.objectClassName, @(schemaVersion), nil];
+    for (id filter in results.filters) {
+        [components addObject:[filter isKindOfClass:[NSPredicate class]] ? [filter predicateFormat] : [filter description]];
+    }
+    return [components componentsJoinedByString:@"\n"];
+}
+
+static void RLMVerifyCanMaterialize(__unsafe_unretained RLMResults *const results) {
+    if (!results.derivedFromTable) {
+        @throw RLMException(@"Only results of all objects of a class or filtered from them can be materialized.");
+    }
+    if (results.realm->_realm->config().sync_config) {
+        @throw RLMException(@"Results of synchronized Realms cannot be materialized.");
+    }
+}
+
+- (BOOL)materializeWithName:(NSString *)name error:(NSError **)error {
+    if (_realm.inWriteTransaction) {
+        @throw RLMException(@"Cannot materialize results in a write transaction.");
+    }
+    if (_realm.configuration.readOnly) {
+        @throw RLMException(@"Cannot materialize results in a read-only Realm.");
+    }
+    RLMVerifyCanMaterialize(self);
+    if (_results.get_mode() == Results::Mode::Empty) {
+        return YES;
+    }
+
+    auto& realm = _realm->_realm;
+    try {
+        NSString *key = RLMMaterializedQueryKey(self, realm->schema_version());
+        // Committed directly rather than with -commitWriteTransaction, as
+        // nothing else can be written in the transaction. Each commit produces
+        // the version after the one it began at.
+        realm->begin_transaction();
+        try {
+            auto version = _impl::RealmFriend::get_shared_group(*realm).get_version_of_current_transaction().version;
+            RLMStoreMaterializedQuery(*_info, _results.get_query(), name, key, version + 1);
+            realm->commit_transaction();
+        }
+        catch (...) {
+            realm->cancel_transaction();
+            throw;
+        }
+        return YES;
+    }
+    catch (...) {
+        RLMRealmTranslateException(error);
+        return NO;
+    }
+}
+
+- (RLMResults *)materializedResultsNamed:(NSString *)name {
+    RLMVerifyCanMaterialize(self);
+    // Changes made in the current write transaction aren't reflected by the
+    // stored rows until they're committed
+    if (_realm.inWriteTransaction) {
+        return self;
+    }
+    return translateErrors([&] {
+        if (_results.get_mode() == Results::Mode::Empty) {
+            return self;
+        }
+        auto& realm = _realm->_realm;
+        realm->read_group();
+        NSString *key = RLMMaterializedQueryKey(self, realm->schema_version());
+        auto version = _impl::RealmFriend::get_shared_group(*realm).get_version_of_current_transaction().version;
+        Query query;
+        if (!RLMStoredMaterializedQuery(*_info, _results.get_query(), name, key, version, query)) {
+            return self;
+        }
+
+        Results results(realm, std::move(query));
+        if (const auto& sort = _results.get_sort()) {
+            results = results.sort(SortDescriptor(sort));
+        }
+        if (const auto& distinct = _results.get_distinct()) {
+            results = results.distinct(DistinctDescriptor(distinct));
+        }
+        RLMResults *materialized = [RLMResults resultsWithObjectInfo:*_info results:std::move(results)];
+        materialized.sortDescriptors = _sortDescriptors;
+        materialized.filters = _filters;
+        materialized.derivedFromTable = YES;
+        return materialized;
+    });
+}
+
+- (RLMResults *)resultsLimitedTo:(NSUInteger)limit {
+    return translateErrors([&] {
+        if (_results.get_mode() == Results::Mode::Empty) {
+            return self;
+        }
+        // Without a sort order the objects are limited by their order in the
+        // table, which is only the order of the results if they come from it
+        if (!_sortDescriptors.count && !_derivedFromTable) {
+            @throw RLMException(@"Results derived from a list or linking objects must be sorted before they can be limited.");
+        }
+        return [self resultsWithQuery:RLMLimitedQuery(*_info, _results.get_query(), _sortDescriptors, limit)
+                               filter:@{@"type": @"limit", @"limit": @(limit), @"strategy": @"sortCutoff"}];
     });
 }
 
@@ -376,7 +1064,19 @@ static inline void RLMResultsValidateInWriteTransaction(__unsafe_unretained RLMR
             return self;
         }
 
-        return [RLMResults resultsWithObjectInfo:*_info results:_results.sort(RLMSortDescriptorFromDescriptors(*_info, properties))];
+        RLMResults *results = [RLMResults resultsWithObjectInfo:*_info
+                                                        results:_results.sort(RLMSortDescriptorFromDescriptors(*_info, properties))];
+        results.sortDescriptors = properties;
+        results.filters = _filters;
+        results.derivedFromTable = _derivedFromTable;
+        if (_queryIdentity) {
+            NSMutableString *identity = [NSMutableString stringWithFormat:@"%@\nsort:", _queryIdentity];
+            for (RLMSortDescriptor *descriptor in properties) {
+                [identity appendFormat:@"%@%@,", descriptor.ascending ? @"+" : @"-", descriptor.keyPath];
+            }
+            results.queryIdentity = identity;
+        }
+        return results;
     });
 }
 
@@ -413,70 +1113,1355 @@ static inline void RLMResultsValidateInWriteTransaction(__unsafe_unretained RLMR
     return [self aggregate:property method:&Results::average methodName:@"averageOfProperty" returnNilForEmpty:YES];
 }
 
-- (void)deleteObjectsFromRealm {
-    return translateErrors([&] {
-        if (_results.get_mode() == Results::Mode::Table) {
-            RLMResultsValidateInWriteTransaction(self);
-            RLMClearTable(*_info);
-        }
-        else {
-            RLMTrackDeletions(_realm, [&] { _results.clear(); });
+- (util::Optional<Mixed>)unboxedAggregate:(RLMAggregateFunction)function ofProperty:(NSString *)property {
+    util::Optional<Mixed> (Results::*method)(size_t);
+    NSString *methodName;
+    switch (function) {
+        case RLMAggregateFunctionMin:     method = &Results::min;     methodName = @"minOfProperty"; break;
+        case RLMAggregateFunctionMax:     method = &Results::max;     methodName = @"maxOfProperty"; break;
+        case RLMAggregateFunctionSum:     method = &Results::sum;     methodName = @"sumOfProperty"; break;
+        case RLMAggregateFunctionAverage: method = &Results::average; methodName = @"averageOfProperty"; break;
+        case RLMAggregateFunctionCount:
+            @throw RLMException(@"Counting is not supported by the unboxed aggregate methods.");
+    }
+    if (_results.get_mode() == Results::Mode::Empty) {
+        if (function == RLMAggregateFunctionSum) {
+            return Mixed(int64_t(0));
         }
-    });
+        return util::none;
+    }
+    size_t column = _info->tableColumn(property);
+    return translateErrors([&] { return (_results.*method)(column); }, methodName);
 }
 
-- (NSString *)description {
-    return RLMDescriptionWithMaxDepth(@"RLMResults", self, RLMDescriptionMaxDepth);
+template<typename T>
+static BOOL RLMMixedToNumber(util::Optional<Mixed> const& value, T *out) {
+    if (!value) {
+        return NO;
+    }
+    switch (value->get_type()) {
+        case type_Int:    *out = static_cast<T>(value->get_int());    return YES;
+        case type_Float:  *out = static_cast<T>(value->get_float());  return YES;
+        case type_Double: *out = static_cast<T>(value->get_double()); return YES;
+        default:
+            @throw RLMException(@"Aggregate value of type '%@' is not a number.",
+                                RLMTypeToString(static_cast<RLMPropertyType>(value->get_type())));
+    }
 }
 
-- (NSUInteger)indexInSource:(NSUInteger)index {
-    return translateErrors([&] { return _results.get(index).get_index(); });
+- (BOOL)aggregate:(RLMAggregateFunction)function ofProperty:(NSString *)property intValue:(int64_t *)value {
+    return RLMMixedToNumber([self unboxedAggregate:function ofProperty:property], value);
 }
 
-- (realm::TableView)tableView {
-    return translateErrors([&] { return _results.get_tableview(); });
+- (BOOL)aggregate:(RLMAggregateFunction)function ofProperty:(NSString *)property doubleValue:(double *)value {
+    return RLMMixedToNumber([self unboxedAggregate:function ofProperty:property], value);
 }
 
-// The compiler complains about the method's argument type not matching due to
-// it not having the generic type attached, but it doesn't seem to be possible
-// to actually include the generic type
-// http://www.openradar.me/radar?id=6135653276319744
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Wmismatched-parameter-types"
-- (RLMNotificationToken *)addNotificationBlock:(void (^)(RLMResults *, RLMCollectionChange *, NSError *))block {
-    [_realm verifyNotificationsAreSupported];
-    return RLMAddNotificationBlock(self, _results, block, true);
+- (RLMPropertyStatistics *)statisticsForProperty:(NSString *)property {
+    if (_results.get_mode() == Results::Mode::Empty) {
+        return RLMStatisticsAccumulator(RLMPropertyTypeInt).statistics();
+    }
+    auto tv = translateErrors([&] { return _results.get_tableview(); });
+    return RLMStatisticsForProperty(tv, *_info, property);
 }
-#pragma clang diagnostic pop
 
-- (BOOL)isAttached
-{
-    return !!_realm;
+- (NSArray *)objectsNearestToVector:(NSData *)vector
+                        forProperty:(NSString *)property
+                              limit:(NSUInteger)limit
+                             metric:(RLMVectorDistanceMetric)metric {
+    if (_results.get_mode() == Results::Mode::Empty) {
+        return @[];
+    }
+    auto tv = translateErrors([&] { return _results.get_tableview(); });
+    return RLMObjectsNearestToVector(tv, *_info, vector, property, limit, metric);
 }
 
-#pragma mark - Thread Confined Protocol Conformance
-
-- (std::unique_ptr<realm::ThreadSafeReferenceBase>)makeThreadSafeReference {
-    return std::make_unique<realm::ThreadSafeReference<Results>>(_realm->_realm->obtain_thread_safe_reference(_results));
+static id RLMGroupAggregateValue(RLMStatisticsAccumulator const& accumulator, RLMAggregateFunction function) {
+    RLMPropertyStatistics *statistics = accumulator.statistics();
+    id value;
+    switch (function) {
+        case RLMAggregateFunctionCount:   value = @(statistics.count); break;
+        case RLMAggregateFunctionSum:     value = statistics.sum; break;
+        case RLMAggregateFunctionMin:     value = statistics.minimum; break;
+        case RLMAggregateFunctionMax:     value = statistics.maximum; break;
+        case RLMAggregateFunctionAverage: value = statistics.average; break;
+    }
+    return value ?: NSNull.null;
 }
 
-- (id)objectiveCMetadata {
-    return nil;
+template<typename Map, typename BoxKey>
+static void RLMAddGroupAggregates(NSMutableDictionary *groups, Map const& accumulators,
+                                  RLMAggregateFunction function, BoxKey&& boxKey) {
+    for (auto& group : accumulators) {
+        groups[boxKey(group.first)] = RLMGroupAggregateValue(group.second, function);
+    }
 }
 
-+ (instancetype)objectWithThreadSafeReference:(std::unique_ptr<realm::ThreadSafeReferenceBase>)reference
-                                     metadata:(__unused id)metadata
-                                        realm:(RLMRealm *)realm {
-    REALM_ASSERT_DEBUG(dynamic_cast<realm::ThreadSafeReference<Results> *>(reference.get()));
-    auto results_reference = static_cast<realm::ThreadSafeReference<Results> *>(reference.get());
+- (NSDictionary *)groupedBy:(NSString *)groupProperty
+                  aggregate:(RLMAggregateFunction)function
+                 ofProperty:(NSString *)property {
+    if (_results.get_mode() == Results::Mode::Empty) {
+        return @{};
+    }
+
+    RLMProperty *groupProp = _info->rlmObjectSchema[groupProperty];
+    if (!groupProp) {
+        @throw RLMException(@"Invalid property name '%@' for class '%@'.", groupProperty, self.objectClassName);
+    }
+    RLMClassInfo *targetInfo = nullptr;
+    RLMProperty *primaryKey = nil;
+    switch (groupProp.type) {
+        case RLMPropertyTypeInt:
+        case RLMPropertyTypeBool:
+        case RLMPropertyTypeString:
+            break;
+        case RLMPropertyTypeObject:
+            targetInfo = &_info->linkTargetType(groupProp.index);
+            primaryKey = targetInfo->rlmObjectSchema.primaryKeyProperty;
+            if (!primaryKey) {
+                @throw RLMException(@"Cannot group by '%@': grouping by an object property requires '%@' to have a primary key.",
+                                    groupProperty, groupProp.objectClassName);
+            }
+            break;
+        default:
+            @throw RLMException(@"Grouping is not supported for %@ property '%@'.",
+                                RLMTypeToString(groupProp.type), groupProperty);
+    }
+
+    RLMProperty *valueProp = nil;
+    if (property) {
+        valueProp = _info->rlmObjectSchema[property];
+        if (!valueProp) {
+            @throw RLMException(@"Invalid property name '%@' for class '%@'.", property, self.objectClassName);
+        }
+        if (valueProp.type != RLMPropertyTypeInt && valueProp.type != RLMPropertyTypeFloat
+            && valueProp.type != RLMPropertyTypeDouble) {
+            @throw RLMException(@"Grouped aggregates are not supported for %@ property '%@'.",
+                                RLMTypeToString(valueProp.type), property);
+        }
+    }
+    else if (function != RLMAggregateFunctionCount) {
+        @throw RLMException(@"A property to aggregate is required for grouped aggregates other than count.");
+    }
+
+    size_t groupColumn = _info->tableColumn(groupProp);
+    size_t valueColumn = valueProp ? _info->tableColumn(valueProp) : realm::npos;
+    RLMPropertyType valueType = valueProp ? valueProp.type : RLMPropertyTypeInt;
+
+    return translateErrors([&] {
+        auto tv = _results.get_tableview();
+        Table& table = *_info->table();
+
+        // Objects with a null group value are accumulated separately rather
+        // than needing a sentinel key
+        RLMStatisticsAccumulator nullGroup(valueType);
+        bool hasNullGroup = false;
+        std::unordered_map<int64_t, RLMStatisticsAccumulator> intGroups;
+        std::unordered_map<std::string, RLMStatisticsAccumulator> stringGroups;
+
+        auto accumulate = [&](RLMStatisticsAccumulator& accumulator, size_t row) {
+            if (!valueProp) {
+                accumulator.add(int64_t(0));
+            }
+            else if (!table.is_null(valueColumn, row)) {
+                switch (valueType) {
+                    case RLMPropertyTypeInt:   accumulator.add(table.get_int(valueColumn, row)); break;
+                    case RLMPropertyTypeFloat: accumulator.add(double(table.get_float(valueColumn, row))); break;
+                    default:                   accumulator.add(table.get_double(valueColumn, row)); break;
+                }
+            }
+        };
+        auto addToGroup = [&](auto& groups, auto&& key, size_t row) {
+            accumulate(groups.emplace(std::move(key), valueType).first->second, row);
+        };
+
+        for (size_t i = 0, size = tv.size(); i < size; ++i) {
+            if (!tv.is_row_attached(i)) {
+                continue;
+            }
+            size_t row = tv.get_source_ndx(i);
+            bool isNull = groupProp.type == RLMPropertyTypeObject ? table.is_null_link(groupColumn, row)
+                                                                  : table.is_null(groupColumn, row);
+            if (isNull) {
+                hasNullGroup = true;
+                accumulate(nullGroup, row);
+                continue;
+            }
+            switch (groupProp.type) {
+                case RLMPropertyTypeInt:
+                    addToGroup(intGroups, table.get_int(groupColumn, row), row);
+                    break;
+                case RLMPropertyTypeBool:
+                    addToGroup(intGroups, int64_t(table.get_bool(groupColumn, row)), row);
+                    break;
+                case RLMPropertyTypeObject:
+                    // Group by the target row, and look up the primary keys
+                    // once per group afterwards
+                    addToGroup(intGroups, int64_t(table.get_link(groupColumn, row)), row);
+                    break;
+                default: {
+                    StringData value = table.get_string(groupColumn, row);
+                    addToGroup(stringGroups, std::string(value.data(), value.size()), row);
+                    break;
+                }
+            }
+        }
+
+        NSMutableDictionary *groups = [NSMutableDictionary dictionaryWithCapacity:intGroups.size() + stringGroups.size() + hasNullGroup];
+        switch (groupProp.type) {
+            case RLMPropertyTypeInt:
+                RLMAddGroupAggregates(groups, intGroups, function, [](int64_t key) { return @(key); });
+                break;
+            case RLMPropertyTypeBool:
+                RLMAddGroupAggregates(groups, intGroups, function, [](int64_t key) { return @(key != 0); });
+                break;
+            case RLMPropertyTypeObject: {
+                Table& target = *targetInfo->table();
+                size_t primaryKeyColumn = targetInfo->tableColumn(primaryKey);
+                RLMAddGroupAggregates(groups, intGroups, function, [&](int64_t key) -> id {
+                    if (target.is_null(primaryKeyColumn, key)) {
+                        return NSNull.null;
+                    }
+                    if (primaryKey.type == RLMPropertyTypeString) {
+                        return RLMStringDataToNSString(target.get_string(primaryKeyColumn, key));
+                    }
+                    return @(target.get_int(primaryKeyColumn, key));
+                });
+                break;
+            }
+            default:
+                RLMAddGroupAggregates(groups, stringGroups, function, [](std::string const& key) {
+                    return RLMStringDataToNSString(key);
+                });
+                break;
+        }
+        if (hasNullGroup) {
+            groups[NSNull.null] = RLMGroupAggregateValue(nullGroup, function);
+        }
+        return (NSDictionary *)groups;
+    });
+}
+
+template<typename T, typename Getter>
+static void copyColumnValues(realm::TableView const& tv, size_t column, T *buffer, size_t count,
+                             T nullValue, Getter getter) {
+    for (size_t i = 0; i < count; ++i) {
+        if (!tv.is_row_attached(i) || tv.is_null(column, i)) {
+            buffer[i] = nullValue;
+        }
+        else {
+            buffer[i] = getter(i);
+        }
+    }
+}
+
+- (NSUInteger)copyValuesOfProperty:(NSString *)property intoBuffer:(void *)buffer count:(NSUInteger)count {
+    if (_results.get_mode() == Results::Mode::Empty) {
+        return 0;
+    }
+    RLMProperty *prop = _info->rlmObjectSchema[property];
+    if (!prop) {
+        @throw RLMException(@"Invalid property name '%@' for class '%@'.", property, self.objectClassName);
+    }
+    if (prop.type != RLMPropertyTypeInt && prop.type != RLMPropertyTypeFloat && prop.type != RLMPropertyTypeDouble) {
+        @throw RLMException(@"copyValuesOfProperty: is not supported for %@ property '%@'.",
+                            RLMTypeToString(prop.type), property);
+    }
+
+    size_t column = _info->tableColumn(prop);
+    return translateErrors([&] {
+        auto tv = _results.get_tableview();
+        size_t size = std::min<size_t>(count, tv.size());
+        switch (prop.type) {
+            case RLMPropertyTypeInt:
+                copyColumnValues(tv, column, static_cast<int64_t *>(buffer), size, int64_t(0),
+                                 [&](size_t i) { return tv.get_int(column, i); });
+                break;
+            case RLMPropertyTypeFloat:
+                copyColumnValues(tv, column, static_cast<float *>(buffer), size, std::numeric_limits<float>::quiet_NaN(),
+                                 [&](size_t i) { return tv.get_float(column, i); });
+                break;
+            case RLMPropertyTypeDouble:
+                copyColumnValues(tv, column, static_cast<double *>(buffer), size, std::numeric_limits<double>::quiet_NaN(),
+                                 [&](size_t i) { return tv.get_double(column, i); });
+                break;
+            default:
+                REALM_UNREACHABLE();
+        }
+        return (NSUInteger)size;
+    });
+}
+
+template<typename T, typename Getter>
+static NSData *projectedColumnValues(realm::TableView const& tv, size_t column, T nullValue, Getter getter) {
+    NSMutableData *data = [NSMutableData dataWithLength:tv.size() * sizeof(T)];
+    copyColumnValues(tv, column, static_cast<T *>(data.mutableBytes), tv.size(), nullValue, getter);
+    return data;
+}
+
+- (id)projectedValuesOfProperty:(NSString *)property {
+    RLMProperty *prop = _info->rlmObjectSchema[property];
+    if (!prop) {
+        @throw RLMException(@"Invalid property name '%@' for class '%@'.", property, self.objectClassName);
+    }
+    switch (prop.type) {
+        case RLMPropertyTypeObject:
+        case RLMPropertyTypeArray:
+        case RLMPropertyTypeLinkingObjects:
+        case RLMPropertyTypeAny:
+            @throw RLMException(@"Cannot project %@ property '%@'.", RLMTypeToString(prop.type), property);
+        default:
+            break;
+    }
+
+    size_t column = _info->tableColumn(prop);
+    return translateErrors([&]() -> id {
+        auto tv = _results.get_tableview();
+        if (!prop.optional) {
+            switch (prop.type) {
+                case RLMPropertyTypeInt:
+                    return projectedColumnValues(tv, column, int64_t(0),
+                                                 [&](size_t i) { return tv.get_int(column, i); });
+                case RLMPropertyTypeBool:
+                    return projectedColumnValues(tv, column, false,
+                                                 [&](size_t i) { return tv.get_bool(column, i); });
+                case RLMPropertyTypeFloat:
+                    return projectedColumnValues(tv, column, 0.0f,
+                                                 [&](size_t i) { return tv.get_float(column, i); });
+                case RLMPropertyTypeDouble:
+                    return projectedColumnValues(tv, column, 0.0,
+                                                 [&](size_t i) { return tv.get_double(column, i); });
+                case RLMPropertyTypeDate:
+                    return projectedColumnValues(tv, column, 0.0, [&](size_t i) {
+                        auto ts = tv.get_timestamp(column, i);
+                        return ts.get_seconds() - NSTimeIntervalSince1970 + ts.get_nanoseconds() / 1'000'000'000.0;
+                    });
+                default:
+                    break;
+            }
+        }
+
+        NSMutableArray *values = [NSMutableArray arrayWithCapacity:tv.size()];
+        for (size_t i = 0, size = tv.size(); i < size; ++i) {
+            id value = nil;
+            if (tv.is_row_attached(i) && !tv.is_null(column, i)) {
+                switch (prop.type) {
+                    case RLMPropertyTypeInt:    value = @(tv.get_int(column, i)); break;
+                    case RLMPropertyTypeBool:   value = @(tv.get_bool(column, i)); break;
+                    case RLMPropertyTypeFloat:  value = @(tv.get_float(column, i)); break;
+                    case RLMPropertyTypeDouble: value = @(tv.get_double(column, i)); break;
+                    case RLMPropertyTypeDate:   value = RLMTimestampToNSDate(tv.get_timestamp(column, i)); break;
+                    case RLMPropertyTypeString: value = RLMStringDataToNSString(tv.get_string(column, i)); break;
+                    case RLMPropertyTypeData:   value = RLMBinaryDataToNSData(tv.get_binary(column, i)); break;
+                    default: REALM_UNREACHABLE();
+                }
+            }
+            [values addObject:value ?: NSNull.null];
+        }
+        return values;
+    });
+}
+
+// Read every value of the objects in the results, touching one byte in each
+// page of long strings and binary data, which pages in the data a later read
+// of the objects will need
+static void RLMTouchResults(__unsafe_unretained RLMResults *const results) {
+    static volatile uint64_t s_sink;
+    uint64_t sink = 0;
+    auto touch = [&](const char *data, size_t size) {
+        for (size_t i = 0; i < size; i += 4096) {
+            sink += data[i];
+        }
+    };
+
+    auto tv = results->_results.get_tableview();
+    auto& table = *results->_info->table();
+    for (size_t col = 0, columns = table.get_column_count(); col < columns; ++col) {
+        auto type = table.get_column_type(col);
+        for (size_t i = 0, size = tv.size(); i < size; ++i) {
+            size_t row = tv.get_source_ndx(i);
+            switch (type) {
+                case type_Int:       sink += static_cast<uint64_t>(table.get_int(col, row)); break;
+                case type_Bool:      sink += table.get_bool(col, row); break;
+                case type_Float:     sink += table.get_float(col, row) != 0; break;
+                case type_Double:    sink += table.get_double(col, row) != 0; break;
+                case type_Timestamp: sink += table.get_timestamp(col, row).is_null(); break;
+                case type_Link:      sink += table.get_link(col, row); break;
+                case type_LinkList:  sink += table.get_link_count(col, row); break;
+                case type_String: {
+                    auto value = table.get_string(col, row);
+                    touch(value.data(), value.size());
+                    break;
+                }
+                case type_Binary: {
+                    auto value = table.get_binary(col, row);
+                    touch(value.data(), value.size());
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+    }
+    s_sink = sink;
+}
+
+namespace {
+// Builds CSV in a fixed-size buffer which is written to the stream whenever it
+// fills up, so memory use doesn't depend on the number of rows exported
+class CSVWriter {
+public:
+    CSVWriter(NSOutputStream *stream) : m_stream(stream) {
+        m_buffer.reserve(s_bufferSize);
+    }
+
+    void separator() {
+        m_buffer += ',';
+    }
+
+    // Rows end with CRLF as specified by RFC 4180
+    bool endRow() {
+        m_buffer += "\r\n";
+        return m_buffer.size() < s_bufferSize || flush();
+    }
+
+    void string(StringData str) {
+        if (!str.data()) {
+            return;
+        }
+        const char *begin = str.data(), *end = begin + str.size();
+        auto needsQuoting = [](char c) { return c == ',' || c == '"' || c == '\r' || c == '\n'; };
+        if (std::find_if(begin, end, needsQuoting) == end) {
+            m_buffer.append(begin, end);
+            return;
+        }
+        m_buffer += '"';
+        for (const char *c = begin; c != end; ++c) {
+            if (*c == '"') {
+                m_buffer += '"';
+            }
+            m_buffer += *c;
+        }
+        m_buffer += '"';
+    }
+
+    void format(const char *fmt, ...) __attribute__((format(printf, 2, 3))) {
+        char str[64];
+        va_list args;
+        va_start(args, fmt);
+        int length = vsnprintf(str, sizeof(str), fmt, args);
+        va_end(args);
+        m_buffer.append(str, std::min<size_t>(length, sizeof(str) - 1));
+    }
+
+    // Dates are written in UTC in the RFC 3339 format
+    void timestamp(Timestamp ts) {
+        int64_t seconds = ts.get_seconds();
+        int32_t nanoseconds = ts.get_nanoseconds();
+        if (nanoseconds < 0) {
+            seconds -= 1;
+            nanoseconds += 1'000'000'000;
+        }
+        time_t time = static_cast<time_t>(seconds);
+        struct tm tm;
+        gmtime_r(&time, &tm);
+        format("%04d-%02d-%02dT%02d:%02d:%02d.%03dZ", tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
+               tm.tm_hour, tm.tm_min, tm.tm_sec, nanoseconds / 1'000'000);
+    }
+
+    bool flush() {
+        auto data = reinterpret_cast<const uint8_t *>(m_buffer.data());
+        size_t remaining = m_buffer.size();
+        while (remaining > 0) {
+            NSInteger written = [m_stream write:data maxLength:remaining];
+            if (written <= 0) {
+                return false;
+            }
+            data += written;
+            remaining -= written;
+        }
+        m_buffer.clear();
+        return true;
+    }
+
+    NSError *error() const {
+        return m_stream.streamError ?: [NSError errorWithDomain:RLMErrorDomain code:RLMErrorFail
+                                                       userInfo:@{NSLocalizedDescriptionKey: @"Unable to write to the output stream."}];
+    }
+
+private:
+    static const size_t s_bufferSize = 64 * 1024;
+    NSOutputStream *m_stream;
+    std::string m_buffer;
+};
+} // anonymous namespace
+
+// The properties to export and their columns, throwing for invalid names
+static std::vector<std::pair<RLMProperty *, size_t>> RLMColumnsForExport(RLMClassInfo& info, NSArray<NSString *> *names) {
+    std::vector<std::pair<RLMProperty *, size_t>> columns;
+    RLMObjectSchema *objectSchema = info.rlmObjectSchema;
+    if (!names) {
+        for (RLMProperty *prop in objectSchema.properties) {
+            // Derived properties hold values of the model, while folded
+            // copies and index keys are only there for the indexes
+            if (prop.isFolded || (prop.isComputed && !prop.derivedInputNames) || prop.type == RLMPropertyTypeObject
+                || prop.type == RLMPropertyTypeArray || prop.type == RLMPropertyTypeAny) {
+                continue;
+            }
+            columns.emplace_back(prop, info.tableColumn(prop));
+        }
+        return columns;
+    }
+
+    for (NSString *name in names) {
+        RLMProperty *prop = objectSchema[name];
+        if (!prop) {
+            @throw RLMException(@"Invalid property name '%@' for class '%@'.", name, objectSchema.className);
+        }
+        switch (prop.type) {
+            case RLMPropertyTypeObject:
+            case RLMPropertyTypeArray:
+            case RLMPropertyTypeLinkingObjects:
+            case RLMPropertyTypeAny:
+                @throw RLMException(@"Cannot export %@ property '%@'.", RLMTypeToString(prop.type), name);
+            default:
+                columns.emplace_back(prop, info.tableColumn(prop));
+        }
+    }
+    return columns;
+}
+
+// Write the header and then the rows of `tv`, if any. Returns false if
+// writing to the stream failed.
+static bool RLMWriteCSV(NSOutputStream *stream, std::vector<std::pair<RLMProperty *, size_t>> const& columns,
+                        TableView const* tv, NSError **error) {
+    if (stream.streamStatus == NSStreamStatusNotOpen) {
+        [stream open];
+    }
+
+    CSVWriter writer(stream);
+    auto writeRows = [&] {
+        for (size_t i = 0; i < columns.size(); ++i) {
+            if (i > 0) {
+                writer.separator();
+            }
+            writer.string(RLMStringDataWithNSString(columns[i].first.name));
+        }
+        if (!writer.endRow()) {
+            return false;
+        }
+
+        for (size_t i = 0, size = tv ? tv->size() : 0; i < size; ++i) {
+            if (!tv->is_row_attached(i)) {
+                continue;
+            }
+            bool first = true;
+            for (auto const& column : columns) {
+                if (!first) {
+                    writer.separator();
+                }
+                first = false;
+
+                RLMPropertyType type = column.first.type;
+                size_t col = column.second;
+                if (type != RLMPropertyTypeString && type != RLMPropertyTypeData && tv->is_null(col, i)) {
+                    continue;
+                }
+                switch (type) {
+                    case RLMPropertyTypeInt:
+                        writer.format("%lld", static_cast<long long>(tv->get_int(col, i)));
+                        break;
+                    case RLMPropertyTypeBool:
+                        writer.format("%s", tv->get_bool(col, i) ? "true" : "false");
+                        break;
+                    case RLMPropertyTypeFloat:
+                        writer.format("%.9g", tv->get_float(col, i));
+                        break;
+                    case RLMPropertyTypeDouble:
+                        writer.format("%.17g", tv->get_double(col, i));
+                        break;
+                    case RLMPropertyTypeDate:
+                        writer.timestamp(tv->get_timestamp(col, i));
+                        break;
+                    case RLMPropertyTypeString:
+                        writer.string(tv->get_string(col, i));
+                        break;
+                    case RLMPropertyTypeData: {
+                        // Binary data is base64 encoded
+                        BinaryData binary = tv->get_binary(col, i);
+                        if (binary.data()) {
+                            NSData *data = [[NSData alloc] initWithBytesNoCopy:const_cast<char *>(binary.data())
+                                                                        length:binary.size() freeWhenDone:NO];
+                            writer.string(RLMStringDataWithNSString([data base64EncodedStringWithOptions:0]));
+                        }
+                        break;
+                    }
+                    default:
+                        REALM_UNREACHABLE();
+                }
+            }
+            if (!writer.endRow()) {
+                return false;
+            }
+        }
+        return writer.flush();
+    };
+
+    if (!translateErrors(writeRows)) {
+        RLMSetErrorOrThrow(writer.error(), error);
+        return false;
+    }
+    return true;
+}
+
+- (BOOL)writeCSVToStream:(NSOutputStream *)stream properties:(NSArray<NSString *> *)properties
+                   error:(NSError **)error {
+    auto columns = RLMColumnsForExport(*_info, properties);
+    if (_results.get_mode() == Results::Mode::Empty) {
+        return RLMWriteCSV(stream, columns, nullptr, error);
+    }
+    auto tv = translateErrors([&] { return _results.get_tableview(); });
+    return RLMWriteCSV(stream, columns, &tv, error);
+}
+
+- (void)writeCSVToStream:(NSOutputStream *)stream properties:(NSArray<NSString *> *)properties
+                   queue:(dispatch_queue_t)queue completion:(void (^)(NSError *))completion {
+    if (_realm.inWriteTransaction) {
+        @throw RLMException(@"Cannot export results on a background queue during a write transaction.");
+    }
+    if (_realm.configuration.readOnly) {
+        @throw RLMException(@"Cannot export results from a read-only Realm on a background queue.");
+    }
+    if (_realm->_realm->config().sync_config) {
+        @throw RLMException(@"Cannot export results from a synchronized Realm on a background queue.");
+    }
+    auto columns = RLMColumnsForExport(*_info, properties);
+
+    // The rows are handed over to a transaction of the export's own, which
+    // begins reading the current version before this returns so that the
+    // version stays pinned even if the Realm advances before the export runs.
+    // The transaction is then only used on the queue.
+    struct ExportState {
+        decltype(make_in_realm_history("")) history;
+        std::unique_ptr<SharedGroup> sharedGroup;
+        std::unique_ptr<TableView> tv;
+    };
+    auto state = std::make_shared<ExportState>();
+    if (_results.get_mode() != Results::Mode::Empty) {
+        translateErrors([&] {
+            auto& config = _realm->_realm->config();
+            auto& sharedGroup = _impl::RealmFriend::get_shared_group(*_realm->_realm);
+            auto tv = _results.get_tableview();
+            auto version = sharedGroup.get_version_of_current_transaction();
+            auto handover = sharedGroup.export_for_handover(tv, ConstSourcePayload::Copy);
+
+            SharedGroupOptions options;
+            options.durability = config.in_memory ? SharedGroupOptions::Durability::MemOnly
+                                                  : SharedGroupOptions::Durability::Full;
+            options.encryption_key = config.encryption_key.empty() ? nullptr : config.encryption_key.data();
+            state->history = make_in_realm_history(config.path);
+            state->sharedGroup = std::make_unique<SharedGroup>(*state->history, options);
+            state->sharedGroup->begin_read(version);
+            state->tv = state->sharedGroup->import_from_handover(std::move(handover));
+        });
+    }
+
+    dispatch_async(queue, ^{
+        NSError *error;
+        @autoreleasepool {
+            @try {
+                RLMWriteCSV(stream, columns, state->tv.get(), &error);
+            }
+            @catch (NSException *e) {
+                error = RLMMakeError(e);
+            }
+            // End the export's read transaction on the queue rather than
+            // wherever the last reference to the state happens to be released
+            state->tv.reset();
+            state->sharedGroup.reset();
+        }
+        if (completion) {
+            completion(error);
+        }
+    });
+}
+
+- (void)prefetchOnQueue:(dispatch_queue_t)queue completion:(void (^)(void))completion {
+    if (_results.get_mode() == Results::Mode::Empty) {
+        if (completion) {
+            dispatch_async(queue, completion);
+        }
+        return;
+    }
+
+    // The results are handed over to the queue and resolved in a Realm opened
+    // there, as the queue may run the block on any thread
+    RLMRealmConfiguration *configuration = _realm.configuration;
+    RLMThreadSafeReference *reference = [RLMThreadSafeReference referenceWithThreadConfined:self];
+    dispatch_async(queue, ^{
+        @autoreleasepool {
+            RLMRealm *realm = [RLMRealm realmWithConfiguration:configuration error:nil];
+            [[realm resolveThreadSafeReference:reference] touchObjects];
+        }
+        if (completion) {
+            completion();
+        }
+    });
+}
+
+- (NSArray *)detachedCopy {
+    if (_results.get_mode() == Results::Mode::Empty) {
+        return @[];
+    }
+    return RLMDetachedCopies(self);
+}
+
+- (void)touchObjects {
+    if (_results.get_mode() != Results::Mode::Empty) {
+        translateErrors([&] { RLMTouchResults(self); });
+    }
+}
+
+- (void)deleteObjectsFromRealm {
+    return translateErrors([&] {
+        if (_results.get_mode() == Results::Mode::Table) {
+            RLMResultsValidateInWriteTransaction(self);
+            RLMClearTable(*_info);
+        }
+        else {
+            RLMTrackDeletions(_realm, [&] { _results.clear(); });
+        }
+    });
+}
+
+- (NSString *)description {
+    return RLMDescriptionWithMaxDepth(@"RLMResults", self, RLMDescriptionMaxDepth);
+}
+
+- (NSDictionary<NSString *, id> *)explain {
+    return translateErrors([&] {
+        size_t tableRows = _info && _info->table() ? _info->table()->size() : 0;
+        NSMutableDictionary *explanation = [NSMutableDictionary new];
+        explanation[@"objectClassName"] = self.objectClassName;
+        explanation[@"tableRows"] = @(tableRows);
+
+        NSMutableArray *sortDescriptors = [NSMutableArray arrayWithCapacity:_sortDescriptors.count];
+        for (RLMSortDescriptor *descriptor in _sortDescriptors) {
+            [sortDescriptors addObject:@{@"keyPath": descriptor.keyPath, @"ascending": @(descriptor.ascending)}];
+        }
+        explanation[@"sortDescriptors"] = sortDescriptors;
+
+        if (_results.get_mode() == Results::Mode::Empty) {
+            explanation[@"query"] = NSNull.null;
+            explanation[@"estimatedRowsScanned"] = @0;
+            explanation[@"matchedRows"] = @0;
+            explanation[@"evaluationTime"] = @0;
+            return explanation;
+        }
+
+        NSMutableArray *nodes = [NSMutableArray arrayWithCapacity:_filters.count];
+        size_t estimate = tableRows;
+        for (id filter in _filters) {
+            NSDictionary *node;
+            if ([filter isKindOfClass:[NSPredicate class]]) {
+                node = RLMExplainPredicate(filter, *_info);
+            }
+            else {
+                NSMutableDictionary *description = [filter mutableCopy];
+                description[@"estimatedRowsScanned"] = @(tableRows);
+                node = description;
+            }
+            // Each filter is ANDed with the previous ones
+            estimate = std::min<size_t>(estimate, [node[@"estimatedRowsScanned"] unsignedLongLongValue]);
+            [nodes addObject:node];
+        }
+        if (nodes.count == 0) {
+            explanation[@"query"] = NSNull.null;
+        }
+        else if (nodes.count == 1) {
+            explanation[@"query"] = nodes.firstObject;
+        }
+        else {
+            explanation[@"query"] = @{@"type": @"and", @"children": nodes, @"estimatedRowsScanned": @(estimate)};
+        }
+        explanation[@"estimatedRowsScanned"] = @(estimate);
+
+        Query query = _results.get_query();
+        auto start = std::chrono::steady_clock::now();
+        size_t matched = query.count();
+        explanation[@"matchedRows"] = @(matched);
+        explanation[@"evaluationTime"] = @(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        return explanation;
+    });
+}
+
+- (NSUInteger)indexInSource:(NSUInteger)index {
+    return translateErrors([&] { return _results.get(index).get_index(); });
+}
+
+- (realm::TableView)tableView {
+    return timeQuery(self, [&] {
+        return translateErrors([&] { return _results.get_tableview(); });
+    });
+}
+
+// The compiler complains about the method's argument type not matching due to
+// it not having the generic type attached, but it doesn't seem to be possible
+// to actually include the generic type
+// http://www.openradar.me/radar?id=6135653276319744
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wmismatched-parameter-types"
+- (RLMNotificationToken *)addNotificationBlock:(void (^)(RLMResults *, RLMCollectionChange *, NSError *))block {
+    [_realm verifyNotificationsAreSupported];
+    _observed = true;
+    return RLMAddNotificationBlock(self, _results, block, true);
+}
+
+- (RLMNotificationToken *)addNotificationBlock:(void (^)(RLMResults *, RLMCollectionChange *, NSError *))block
+                                      keyPaths:(NSArray<NSString *> *)keyPaths {
+    [_realm verifyNotificationsAreSupported];
+    _observed = true;
+    return RLMAddNotificationBlock(self, _results, block, true, keyPaths);
+}
+
+- (RLMNotificationToken *)addNotificationBlock:(void (^)(RLMResults *, RLMCollectionChange *, NSError *))block
+                                      keyPaths:(NSArray<NSString *> *)keyPaths
+                               minimumInterval:(NSTimeInterval)minimumInterval {
+    [_realm verifyNotificationsAreSupported];
+    _observed = true;
+    return RLMAddNotificationBlock(self, _results, block, true, keyPaths, minimumInterval);
+}
+
+- (RLMNotificationToken *)addNotificationBlock:(void (^)(RLMResults *, RLMCollectionChange *, NSError *))block
+                                         queue:(dispatch_queue_t)queue {
+    [_realm verifyNotificationsAreSupported];
+    return RLMAddNotificationBlockOnQueue(self, block, queue);
+}
+
+- (RLMNotificationToken *)evaluateAsyncWithCompletion:(void (^)(RLMResults *, NSError *))completion {
+    [_realm verifyNotificationsAreSupported];
+    _observed = true;
+
+    // The block keeps the token alive until the first notification, which is
+    // delivered once the background worker has run the query
+    __block RLMNotificationToken *token = RLMAddNotificationBlock(self, _results, ^(RLMResults *results, RLMCollectionChange *, NSError *error) {
+        if (!token) {
+            return;
+        }
+        [token stop];
+        token = nil;
+        completion(results, error);
+    }, false);
+    return token;
+}
+#pragma clang diagnostic pop
+
+- (RLMNotificationToken *)addIdentityNotificationBlock:(void (^)(RLMCollectionIdentityChange *, NSError *))block {
+    RLMProperty *primary = _info->rlmObjectSchema.primaryKeyProperty;
+    if (!primary) {
+        @throw RLMException(@"Identity notifications require '%@' to have a primary key.", self.objectClassName);
+    }
+
+    // The snapshot of the primary keys, which is kept in the order of the
+    // results by applying the changes reported for each version to it
+    NSMutableArray *identifiers = [NSMutableArray new];
+    return [self addNotificationBlock:^(RLMResults *results, RLMCollectionChange *change, NSError *error) {
+        if (error) {
+            block(nil, error);
+            return;
+        }
+
+        Table& table = *results->_info->table();
+        size_t col = results->_info->tableColumn(primary);
+        auto identifierAtIndex = [&](NSUInteger index) -> id {
+            size_t row = [results indexInSource:index];
+            if (table.is_null(col, row)) {
+                return NSNull.null;
+            }
+            if (primary.type == RLMPropertyTypeString) {
+                return RLMStringDataToNSString(table.get_string(col, row));
+            }
+            return @(table.get_int(col, row));
+        };
+
+        if (!change) {
+            [identifiers removeAllObjects];
+            for (NSUInteger i = 0, count = results.count; i < count; ++i) {
+                [identifiers addObject:identifierAtIndex(i)];
+            }
+            NSArray *all = [identifiers copy];
+            block([[RLMCollectionIdentityChange alloc] initWithIdentifiers:all deleted:@[] inserted:all modified:@[]], nil);
+            return;
+        }
+
+        NSIndexSet *deletions = change.deletionIndexes;
+        NSArray *deleted = [identifiers objectsAtIndexes:deletions];
+        [identifiers removeObjectsAtIndexes:deletions];
+
+        NSIndexSet *insertions = change.insertionIndexes;
+        NSMutableArray *inserted = [NSMutableArray arrayWithCapacity:insertions.count];
+        [insertions enumerateIndexesUsingBlock:^(NSUInteger index, BOOL *) {
+            [inserted addObject:identifierAtIndex(index)];
+        }];
+        [identifiers insertObjects:inserted atIndexes:insertions];
+
+        NSMutableArray *modified = [NSMutableArray new];
+        for (auto index : change.changeSet.modifications_new.as_indexes()) {
+            [modified addObject:identifiers[index]];
+        }
+        block([[RLMCollectionIdentityChange alloc] initWithIdentifiers:[identifiers copy] deleted:deleted
+                                                              inserted:inserted modified:modified], nil);
+    }];
+}
+
+- (RLMSectionedResults *)sectionedResultsUsingKeyPath:(NSString *)keyPath {
+    keyPath = [keyPath copy];
+    return [self sectionedResultsUsingBlock:^(id object) {
+        return [object valueForKeyPath:keyPath];
+    }];
+}
+
+- (RLMSectionedResults *)sectionedResultsUsingBlock:(id<NSCopying> (^)(id))block {
+    return [[RLMSectionedResults alloc] initWithResults:self keyBlock:block];
+}
+
+- (BOOL)isAttached
+{
+    return !!_realm;
+}
+
+#pragma mark - Thread Confined Protocol Conformance
+
+- (std::unique_ptr<realm::ThreadSafeReferenceBase>)makeThreadSafeReference {
+    return std::make_unique<realm::ThreadSafeReference<Results>>(_realm->_realm->obtain_thread_safe_reference(_results));
+}
+
+- (id)objectiveCMetadata {
+    RLMResultsHandoverMetadata *metadata = [[RLMResultsHandoverMetadata alloc] init];
+    metadata.sortDescriptors = _sortDescriptors;
+    metadata.filters = _filters;
+    metadata.derivedFromTable = _derivedFromTable;
+    metadata.queryIdentity = _queryIdentity;
+    return metadata;
+}
+
++ (instancetype)objectWithThreadSafeReference:(std::unique_ptr<realm::ThreadSafeReferenceBase>)reference
+                                     metadata:(RLMResultsHandoverMetadata *)metadata
+                                        realm:(RLMRealm *)realm {
+    REALM_ASSERT_DEBUG(dynamic_cast<realm::ThreadSafeReference<Results> *>(reference.get()));
+    auto results_reference = static_cast<realm::ThreadSafeReference<Results> *>(reference.get());
 
     Results results = realm->_realm->resolve_thread_safe_reference(std::move(*results_reference));
 
-    return [RLMResults resultsWithObjectInfo:realm->_info[RLMStringDataToNSString(results.get_object_type())]
-                                     results:std::move(results)];
+    RLMResults *resolved = [RLMResults resultsWithObjectInfo:realm->_info[RLMStringDataToNSString(results.get_object_type())]
+                                                     results:std::move(results)];
+    resolved.sortDescriptors = metadata.sortDescriptors;
+    resolved.filters = metadata.filters;
+    resolved.derivedFromTable = metadata.derivedFromTable;
+    resolved.queryIdentity = metadata.queryIdentity;
+    return resolved;
 }
 
 @end
 
 @implementation RLMLinkingObjects
 @end
+
+static NSIndexPath *RLMIndexPath(NSUInteger section, NSUInteger index) {
+    NSUInteger path[2] = {section, index};
+    return [NSIndexPath indexPathWithIndexes:path length:2];
+}
+
+static NSArray<NSIndexPath *> *RLMIndexPathsInSection(NSArray<NSIndexPath *> *indexPaths, NSUInteger section) {
+    NSMutableArray *ret = [NSMutableArray new];
+    for (NSIndexPath *indexPath in indexPaths) {
+        if ([indexPath indexAtPosition:0] == section) {
+            [ret addObject:indexPath];
+        }
+    }
+    return ret;
+}
+
+@implementation RLMCollectionIdentityChange
+
+- (instancetype)initWithIdentifiers:(NSArray *)identifiers deleted:(NSArray *)deleted
+                           inserted:(NSArray *)inserted modified:(NSArray *)modified {
+    self = [super init];
+    if (self) {
+        _identifiers = identifiers;
+        _deletedIdentifiers = deleted;
+        _insertedIdentifiers = inserted;
+        _modifiedIdentifiers = modified;
+    }
+    return self;
+}
+
+@end
+
+@implementation RLMSectionedResultsChange
+
+- (instancetype)initWithSectionDeletions:(NSIndexSet *)sectionDeletions
+                       sectionInsertions:(NSIndexSet *)sectionInsertions
+                               deletions:(NSArray<NSIndexPath *> *)deletions
+                              insertions:(NSArray<NSIndexPath *> *)insertions
+                           modifications:(NSArray<NSIndexPath *> *)modifications {
+    self = [super init];
+    if (self) {
+        _sectionDeletions = sectionDeletions;
+        _sectionInsertions = sectionInsertions;
+        _deletions = [deletions sortedArrayUsingSelector:@selector(compare:)];
+        _insertions = [insertions sortedArrayUsingSelector:@selector(compare:)];
+        _modifications = [modifications sortedArrayUsingSelector:@selector(compare:)];
+    }
+    return self;
+}
+
+- (NSArray<NSIndexPath *> *)deletionsInSection:(NSUInteger)section {
+    return RLMIndexPathsInSection(_deletions, section);
+}
+
+- (NSArray<NSIndexPath *> *)insertionsInSection:(NSUInteger)section {
+    return RLMIndexPathsInSection(_insertions, section);
+}
+
+- (NSArray<NSIndexPath *> *)modificationsInSection:(NSUInteger)section {
+    return RLMIndexPathsInSection(_modifications, section);
+}
+
+@end
+
+// A token for a notification block registered on an RLMSectionedResults. All
+// of the blocks registered on one share a single notification on its results,
+// as the sections must only be updated once for each change.
+@interface RLMSectionedResultsNotificationToken : RLMNotificationToken
+@end
+
+@implementation RLMSectionedResultsNotificationToken {
+@public
+    RLMSectionedResults *_sectionedResults;
+    void (^_block)(RLMSectionedResults *, RLMSectionedResultsChange *, NSError *);
+    bool _suppressNext;
+    // Set for tokens added after the initial notification, until their block
+    // is sent the initial sections
+    bool _needsInitial;
+}
+
+- (RLMRealm *)realm {
+    return _sectionedResults.results.realm;
+}
+
+- (void)suppressNextNotification {
+    _suppressNext = true;
+}
+
+- (void)stop {
+    RLMSectionedResults *sectionedResults = _sectionedResults;
+    _sectionedResults = nil;
+    _block = nil;
+    [sectionedResults removeToken:self];
+}
+
+- (void)dealloc {
+    [self stop];
+}
+
+@end
+
+@implementation RLMSectionedResults {
+    id<NSCopying> (^_keyBlock)(id);
+
+    // The section key of each object in the results, in order. Keys are only
+    // computed again for objects which are inserted or modified.
+    NSMutableArray *_keys;
+    // The index in the results of the first object of each section
+    std::vector<NSUInteger> _sectionStarts;
+    NSMutableArray *_sectionKeys;
+
+    // The Realm's _readGeneration when the sections were last computed or
+    // updated, for noticing that they're out of date while no notification
+    // block keeps them updated
+    uint64_t _sectionsGeneration;
+
+    RLMNotificationToken *_token;
+    // The tokens of the registered blocks, which are held weakly so that the
+    // blocks stop being called when their tokens are released
+    NSPointerArray *_tokens;
+    bool _receivedInitialNotification;
+}
+
+- (instancetype)initWithResults:(RLMResults *)results keyBlock:(id<NSCopying> (^)(id))keyBlock {
+    self = [super init];
+    if (self) {
+        _results = results;
+        _keyBlock = keyBlock;
+        _tokens = [NSPointerArray weakObjectsPointerArray];
+        [self computeSections];
+    }
+    return self;
+}
+
+- (id)keyForObject:(id)object {
+    return _keyBlock(object) ?: NSNull.null;
+}
+
+- (void)computeSections {
+    if (RLMRealm *realm = _results.realm) {
+        _sectionsGeneration = realm->_readGeneration;
+    }
+    _keys = [NSMutableArray arrayWithCapacity:_results.count];
+    for (id object in _results) {
+        [_keys addObject:[self keyForObject:object]];
+    }
+    [self computeSectionBoundaries];
+}
+
+- (void)computeSectionBoundaries {
+    _sectionStarts.clear();
+    _sectionKeys = [NSMutableArray new];
+    id previous;
+    NSUInteger index = 0;
+    for (id key in _keys) {
+        if (!previous || ![key isEqual:previous]) {
+            _sectionStarts.push_back(index);
+            [_sectionKeys addObject:key];
+        }
+        previous = key;
+        ++index;
+    }
+}
+
+// While a notification block is registered the sections are updated from the
+// changes it's sent, which arrive as the Realm advances. Otherwise nothing
+// updates them, so they're computed again once the Realm has advanced, and
+// each time in a write transaction, whose changes aren't reported until it's
+// committed.
+- (void)updateSectionsIfNeeded {
+    RLMRealm *realm = _results.realm;
+    if (_token || !realm) {
+        return;
+    }
+    if (realm.inWriteTransaction || realm->_readGeneration != _sectionsGeneration) {
+        [self computeSections];
+    }
+}
+
+- (NSUInteger)numberOfSections {
+    [self updateSectionsIfNeeded];
+    return _sectionKeys.count;
+}
+
+- (NSArray *)sectionKeys {
+    [self updateSectionsIfNeeded];
+    return [_sectionKeys copy];
+}
+
+- (NSUInteger)numberOfObjectsInSection:(NSUInteger)section {
+    [self updateSectionsIfNeeded];
+    if (section >= _sectionStarts.size()) {
+        @throw RLMException(@"Section %llu is out of bounds (must be less than %llu).",
+                            (unsigned long long)section, (unsigned long long)_sectionStarts.size());
+    }
+    NSUInteger end = section + 1 < _sectionStarts.size() ? _sectionStarts[section + 1] : _keys.count;
+    return end - _sectionStarts[section];
+}
+
+- (id)objectAtIndexPath:(NSIndexPath *)indexPath {
+    [self updateSectionsIfNeeded];
+    NSUInteger section = [indexPath indexAtPosition:0], index = [indexPath indexAtPosition:1];
+    NSUInteger count = [self numberOfObjectsInSection:section];
+    if (index >= count) {
+        @throw RLMException(@"Index %llu is out of bounds (must be less than %llu).",
+                            (unsigned long long)index, (unsigned long long)count);
+    }
+    return [_results objectAtIndex:_sectionStarts[section] + index];
+}
+
+// Update the keys and sections for a change to the results, and describe the
+// change in terms of the sections before and after it
+- (RLMSectionedResultsChange *)applyChange:(RLMCollectionChange *)change {
+    auto& changes = [change changeSet];
+    std::vector<NSUInteger> oldStarts = _sectionStarts;
+    NSArray *oldSectionKeys = _sectionKeys;
+
+    [_keys removeObjectsAtIndexes:change.deletionIndexes];
+    for (auto index : changes.insertions.as_indexes()) {
+        [_keys insertObject:[self keyForObject:[_results objectAtIndex:index]] atIndex:index];
+    }
+    REALM_ASSERT_DEBUG(_keys.count == _results.count);
+    NSMutableIndexSet *keyChanged = [NSMutableIndexSet new];
+    for (auto index : changes.modifications_new.as_indexes()) {
+        if (changes.insertions.contains(index)) {
+            continue;
+        }
+        id key = [self keyForObject:[_results objectAtIndex:index]];
+        if (![key isEqual:_keys[index]]) {
+            _keys[index] = key;
+            [keyChanged addIndex:index];
+        }
+    }
+    [self computeSectionBoundaries];
+
+    // Sections are matched by their keys, which needs each key to be the key of
+    // a single section. If the results aren't sorted by the key and it isn't,
+    // every section is replaced instead.
+    NSMutableDictionary *oldSections = [NSMutableDictionary new], *newSections = [NSMutableDictionary new];
+    for (NSUInteger i = 0; i < oldSectionKeys.count; ++i) {
+        oldSections[oldSectionKeys[i]] = @(i);
+    }
+    for (NSUInteger i = 0; i < _sectionKeys.count; ++i) {
+        newSections[_sectionKeys[i]] = @(i);
+    }
+    if (oldSections.count < oldSectionKeys.count || newSections.count < _sectionKeys.count) {
+        return [[RLMSectionedResultsChange alloc] initWithSectionDeletions:[NSIndexSet indexSetWithIndexesInRange:{0, oldSectionKeys.count}]
+                                                         sectionInsertions:[NSIndexSet indexSetWithIndexesInRange:{0, _sectionKeys.count}]
+                                                                 deletions:@[] insertions:@[] modifications:@[]];
+    }
+
+    NSMutableIndexSet *sectionDeletions = [NSMutableIndexSet new], *sectionInsertions = [NSMutableIndexSet new];
+    for (NSUInteger i = 0; i < oldSectionKeys.count; ++i) {
+        if (!newSections[oldSectionKeys[i]]) {
+            [sectionDeletions addIndex:i];
+        }
+    }
+    for (NSUInteger i = 0; i < _sectionKeys.count; ++i) {
+        if (!oldSections[_sectionKeys[i]]) {
+            [sectionInsertions addIndex:i];
+        }
+    }
+
+    // The index paths of objects in deleted or inserted sections are implied
+    // by the section changes, and so are nil
+    auto indexPath = [](std::vector<NSUInteger> const& starts, NSIndexSet *skipped, size_t index) -> NSIndexPath * {
+        NSUInteger section = std::upper_bound(starts.begin(), starts.end(), index) - starts.begin() - 1;
+        return [skipped containsIndex:section] ? nil : RLMIndexPath(section, index - starts[section]);
+    };
+    // The old index of an object which wasn't inserted
+    auto oldIndex = [&](size_t index) {
+        return changes.deletions.shift(changes.insertions.unshift(index));
+    };
+
+    NSMutableArray *deletions = [NSMutableArray new], *insertions = [NSMutableArray new], *modifications = [NSMutableArray new];
+    for (auto index : changes.deletions.as_indexes()) {
+        if (NSIndexPath *path = indexPath(oldStarts, sectionDeletions, index)) {
+            [deletions addObject:path];
+        }
+    }
+    for (auto index : changes.insertions.as_indexes()) {
+        if (NSIndexPath *path = indexPath(_sectionStarts, sectionInsertions, index)) {
+            [insertions addObject:path];
+        }
+    }
+    for (auto index : changes.modifications_new.as_indexes()) {
+        if (changes.insertions.contains(index)) {
+            continue;
+        }
+        NSIndexPath *oldPath = indexPath(oldStarts, sectionDeletions, oldIndex(index));
+        if (![keyChanged containsIndex:index]) {
+            if (oldPath) {
+                [modifications addObject:oldPath];
+            }
+            continue;
+        }
+        // An object which moved to another section is removed from its old
+        // section and inserted into its new one
+        if (oldPath) {
+            [deletions addObject:oldPath];
+        }
+        if (NSIndexPath *newPath = indexPath(_sectionStarts, sectionInsertions, index)) {
+            [insertions addObject:newPath];
+        }
+    }
+    return [[RLMSectionedResultsChange alloc] initWithSectionDeletions:sectionDeletions
+                                                     sectionInsertions:sectionInsertions
+                                                             deletions:deletions
+                                                            insertions:insertions
+                                                         modifications:modifications];
+}
+
+- (void)deliverChange:(RLMCollectionChange *)change error:(NSError *)error {
+    RLMSectionedResultsChange *sectionedChange;
+    if (!error) {
+        _sectionsGeneration = _results.realm->_readGeneration;
+        if (!change) {
+            // The initial notification may include changes made since the
+            // sections were computed, so they're computed again
+            [self computeSections];
+        }
+        else {
+            sectionedChange = [self applyChange:change];
+        }
+        _receivedInitialNotification = true;
+    }
+
+    for (RLMSectionedResultsNotificationToken *token in _tokens.allObjects) {
+        // A block which hasn't been sent the initial sections yet is sent them
+        // now rather than a change from sections it never saw. This happens
+        // when a change is delivered synchronously, such as by beginning a
+        // write transaction, before its initial notification runs.
+        if (token->_needsInitial && !error) {
+            token->_needsInitial = false;
+            token->_suppressNext = false;
+            if (auto block = token->_block) {
+                block(self, nil, nil);
+            }
+            continue;
+        }
+        token->_needsInitial = false;
+        if (token->_suppressNext) {
+            token->_suppressNext = false;
+            continue;
+        }
+        if (auto block = token->_block) {
+            error ? block(nil, nil, error) : block(self, sectionedChange, nil);
+        }
+    }
+}
+
+- (RLMNotificationToken *)addNotificationBlock:(void (^)(RLMSectionedResults *, RLMSectionedResultsChange *, NSError *))block {
+    RLMSectionedResultsNotificationToken *token = [RLMSectionedResultsNotificationToken new];
+    token->_sectionedResults = self;
+    token->_block = block;
+
+    if (!_token) {
+        __weak RLMSectionedResults *weakSelf = self;
+        _token = [_results addNotificationBlock:^(__unused RLMResults *results, RLMCollectionChange *change, NSError *error) {
+            [weakSelf deliverChange:change error:error];
+        }];
+        _receivedInitialNotification = false;
+    }
+    else if (_receivedInitialNotification) {
+        // The shared notification has already delivered the initial sections,
+        // so this block is sent them on its own, unless a change delivered
+        // before then already has
+        token->_needsInitial = true;
+        CFRunLoopRef runLoop = CFRunLoopGetCurrent();
+        CFRunLoopPerformBlock(runLoop, kCFRunLoopCommonModes, ^{
+            if (!token->_needsInitial) {
+                return;
+            }
+            token->_needsInitial = false;
+            if (auto block = token->_block) {
+                block(token->_sectionedResults, nil, nil);
+            }
+        });
+        CFRunLoopWakeUp(runLoop);
+    }
+    [_tokens addPointer:(__bridge void *)token];
+    return token;
+}
+
+- (void)removeToken:(RLMSectionedResultsNotificationToken *)token {
+    for (NSUInteger i = 0; i < _tokens.count; ++i) {
+        if ([_tokens pointerAtIndex:i] == (__bridge void *)token) {
+            [_tokens removePointerAtIndex:i];
+            break;
+        }
+    }
+    // The shared notification is only needed while some block is registered
+    if (!_tokens.allObjects.count) {
+        [_token stop];
+        _token = nil;
+    }
+}
+
+@end
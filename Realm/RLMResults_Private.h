@@ -27,6 +27,43 @@ NS_ASSUME_NONNULL_BEGIN
 
 + (instancetype)emptyDetachedResults;
 
+// Fast-enumerates the results using a single accessor object which is
+// rebound to each row in turn
+- (id<NSFastEnumeration>)objectsReusingAccessor;
+
+// Variants of the min, max, sum and average methods for Swift which return the
+// value unboxed. They return NO if there is no value, such as for the minimum
+// of no objects, and otherwise store the value converted to the requested type.
+- (BOOL)aggregate:(RLMAggregateFunction)function ofProperty:(NSString *)property intValue:(int64_t *)value;
+- (BOOL)aggregate:(RLMAggregateFunction)function ofProperty:(NSString *)property doubleValue:(double *)value;
+
+// Reads the values of the given property for all of the results directly from
+// the table, without creating an accessor for each object, for Swift's
+// projections. Values of non-optional int, bool, float, double and date
+// properties are returned unboxed as an NSData holding an array of int64_t,
+// bool, float, double, or seconds since the reference date respectively.
+// Values of other properties are returned in an NSArray, with NSNull for nil.
+- (id)projectedValuesOfProperty:(NSString *)property;
+
+@end
+
+typedef NS_ENUM(NSInteger, RLMQueryConditionKind) {
+    // Compares propertyName with value using queryOperator
+    RLMQueryConditionKindComparison,
+    // Combines the conditions
+    RLMQueryConditionKindAll,
+    RLMQueryConditionKindAny,
+    RLMQueryConditionKindNot,
+};
+
+@interface RLMQueryCondition ()
+@property (nonatomic, readonly) RLMQueryConditionKind kind;
+@property (nonatomic, readonly, nullable) NSString *propertyName;
+@property (nonatomic, readonly) RLMQueryOperator queryOperator;
+@property (nonatomic, readonly, nullable) id value;
+@property (nonatomic, readonly) BOOL caseInsensitive;
+@property (nonatomic, readonly) BOOL diacriticInsensitive;
+@property (nonatomic, readonly, nullable) NSArray<RLMQueryCondition *> *conditions;
 @end
 
 NS_ASSUME_NONNULL_END
@@ -72,6 +72,23 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (BOOL)isEqualToSchema:(RLMSchema *)schema;
 
+/**
+ Registers the complete list of `RLMObject` subclasses to include in the
+ default schema.
+
+ By default, the first time the default schema is needed every class in the
+ process is inspected to find the `RLMObject` subclasses, which can take a
+ noticeable amount of time in large apps. When the classes have been
+ registered with this method, only the given classes are inspected, and class
+ names which are not among them are not searched for.
+
+ This must be called before the default schema is first used, such as at the
+ start of `application:didFinishLaunchingWithOptions:`.
+
+ @param classes The `RLMObject` subclasses to include in the default schema.
+ */
++ (void)registerObjectClasses:(NSArray<Class> *)classes;
+
 @end
 
 NS_ASSUME_NONNULL_END
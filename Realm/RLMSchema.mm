@@ -46,6 +46,8 @@ const uint64_t RLMNotVersioned = realm::ObjectStore::NotVersioned;
 static RLMSchema *s_sharedSchema = [[RLMSchema alloc] init];
 static NSMutableDictionary *s_localNameToClass = [[NSMutableDictionary alloc] init];
 static NSMutableDictionary *s_privateObjectSubclasses = [[NSMutableDictionary alloc] init];
+// Set by +registerObjectClasses: to avoid scanning every class in the process
+static NSArray *s_registeredObjectClasses;
 
 static enum class SharedSchemaState {
     Uninitialized,
@@ -119,6 +121,14 @@ static void RLMRegisterClassLocalNames(Class *classes, NSUInteger count) {
     }
 }
 
+// Caller must @synchronize on s_localNameToClass
+static void RLMRegisterClassLocalNames(NSArray *classes) {
+    NSUInteger count = classes.count;
+    auto classArray = std::make_unique<__unsafe_unretained Class[]>(count);
+    [classes getObjects:classArray.get() range:NSMakeRange(0, count)];
+    RLMRegisterClassLocalNames(classArray.get(), count);
+}
+
 - (instancetype)init {
     self = [super init];
     if (self) {
@@ -162,15 +172,11 @@ static void RLMRegisterClassLocalNames(Class *classes, NSUInteger count) {
 }
 
 + (instancetype)schemaWithObjectClasses:(NSArray *)classes {
-    NSUInteger count = classes.count;
-    auto classArray = std::make_unique<__unsafe_unretained Class[]>(count);
-    [classes getObjects:classArray.get() range:NSMakeRange(0, count)];
-
     RLMSchema *schema = [[self alloc] init];
     @synchronized(s_localNameToClass) {
-        RLMRegisterClassLocalNames(classArray.get(), count);
+        RLMRegisterClassLocalNames(classes);
 
-        schema->_objectSchemaByName = [NSMutableDictionary dictionaryWithCapacity:count];
+        schema->_objectSchemaByName = [NSMutableDictionary dictionaryWithCapacity:classes.count];
         for (Class cls in classes) {
             if (!RLMIsObjectSubclass(cls)) {
                 @throw RLMException(@"Can't add non-Object type '%@' to a schema.", cls);
@@ -233,7 +239,10 @@ static void RLMRegisterClassLocalNames(Class *classes, NSUInteger count) {
         s_sharedSchemaState = SharedSchemaState::Initializing;
         try {
             // Make sure we've discovered all classes
-            {
+            if (NSArray *registered = s_registeredObjectClasses) {
+                RLMRegisterClassLocalNames(registered);
+            }
+            else {
                 unsigned int numClasses;
                 using malloc_ptr = std::unique_ptr<__unsafe_unretained Class[], decltype(&free)>;
                 malloc_ptr classes(objc_copyClassList(&numClasses), &free);
@@ -260,6 +269,20 @@ static void RLMRegisterClassLocalNames(Class *classes, NSUInteger count) {
     return s_sharedSchema;
 }
 
++ (void)registerObjectClasses:(NSArray<Class> *)classes {
+    @synchronized(s_localNameToClass) {
+        if (s_sharedSchemaState != SharedSchemaState::Uninitialized) {
+            @throw RLMException(@"Object classes must be registered before the default schema is first used.");
+        }
+        for (Class cls in classes) {
+            if (!RLMIsObjectSubclass(cls)) {
+                @throw RLMException(@"Can't add non-Object type '%@' to a schema.", cls);
+            }
+        }
+        s_registeredObjectClasses = [classes copy];
+    }
+}
+
 // schema based on tables in a realm
 + (instancetype)dynamicSchemaFromObjectStoreSchema:(Schema const&)objectStoreSchema {
     // cache descriptors for all subclasses of RLMObject
@@ -285,8 +308,11 @@ static void RLMRegisterClassLocalNames(Class *classes, NSUInteger count) {
     }
 
     // className might be the local name of a Swift class we haven't registered
-    // yet, so scan them all then recheck
-    {
+    // yet, so scan them all (or just the ones the app registered) then recheck
+    if (NSArray *registered = s_registeredObjectClasses) {
+        RLMRegisterClassLocalNames(registered);
+    }
+    else {
         unsigned int numClasses;
         std::unique_ptr<__unsafe_unretained Class[], decltype(&free)> classes(objc_copyClassList(&numClasses), &free);
         RLMRegisterClassLocalNames(classes.get(), numClasses);
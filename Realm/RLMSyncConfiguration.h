@@ -25,6 +25,21 @@ NS_ASSUME_NONNULL_BEGIN
 /**
  A configuration object representing configuration state for a Realm which is intended to sync with a Realm Object
  Server.
+
+ Every write transaction committed to a synchronized Realm produces a changeset which has to be uploaded. Apps which
+ perform many small writes can produce fewer, larger changesets by grouping the writes into fewer transactions, for
+ example with `asyncWriteGroupingInterval` on `RLMRealmConfiguration`.
+
+ A synchronized Realm file stores the history of changes used by the synchronization subsystem as well as the data
+ itself. This history is managed by the synchronization subsystem, and compacting the Realm does not remove it, so
+ the file of a Realm which has had many writes is larger than an unsynchronized Realm holding the same data. Writing
+ fewer, larger transactions also keeps this history smaller.
+
+ A synchronized Realm is always downloaded in full, including by
+ `+[RLMRealm asyncOpenWithConfiguration:callbackQueue:callback:]`. Data which
+ only some users or devices need should be stored in separate Realms on the
+ server, such as one Realm per user or per project, so that each device only
+ opens and downloads the Realms it needs.
  */
 @interface RLMSyncConfiguration : NSObject
 
@@ -56,6 +56,10 @@ NS_ASSUME_NONNULL_BEGIN
 /// pertains to a specific session, that session will also be passed into the block.
 typedef void(^RLMSyncErrorReportingBlock)(NSError *, RLMSyncSession * _Nullable);
 
+/// A block type representing a block which receives the log messages of the sync subsystem, along with the level each
+/// message was logged at.
+typedef void(^RLMSyncLogFunction)(RLMSyncLogLevel level, NSString *message);
+
 /**
  A singleton manager which serves as a central point for sync-related configuration.
  */
@@ -101,6 +105,49 @@ typedef void(^RLMSyncErrorReportingBlock)(NSError *, RLMSyncSession * _Nullable)
  */
 @property (nonatomic) RLMSyncLogLevel logLevel;
 
+/**
+ A block which receives the messages logged by the sync subsystem, in place of
+ the default logging.
+
+ Messages below the `logLevel` threshold are discarded before they are
+ formatted, so the level limits the cost of logging whether or not a block is
+ set. The block is called on the thread which logged the message, and should
+ return quickly.
+
+ If no block is set, messages are written to the unified logging system with
+ `os_log`, under the subsystem `io.realm.sync`, where it is available, and
+ with `NSLog` otherwise. `os_log` defers formatting the messages until they
+ are read, which makes verbose logging much cheaper than with `NSLog`.
+ */
+@property (nullable, nonatomic, copy) RLMSyncLogFunction logger;
+
+/**
+ The configuration of the `NSURLSession` used for requests to the authentication server, such as logging in and
+ refreshing the access tokens of sync sessions.
+
+ These requests use their own session rather than `+[NSURLSession sharedSession]`, so that they don't compete with the
+ app's own traffic for connections. The default configuration is a copy of
+ `+[NSURLSessionConfiguration defaultSessionConfiguration]` with HTTP pipelining enabled, as many token refreshes are
+ usually sent to the same server at once when sessions are opened. Set this to a configuration with different
+ timeouts, connection limits or protocol settings to tune the requests, or to `nil` to restore the default.
+
+ Requests which have already been started when this is set are completed using the previous configuration.
+ */
+@property (null_resettable, nonatomic, copy) NSURLSessionConfiguration *authSessionConfiguration;
+
+/**
+ Whether the active sync sessions are suspended while the app is in the background.
+
+ When `YES`, each active session is suspended with `-[RLMSyncSession suspend]` when the app enters the background on
+ iOS and tvOS, and the sessions which were suspended are resumed when it returns to the foreground, so that the app
+ doesn't keep its connections to the server open while it isn't being used. How each session stops is decided by the
+ stop policy of its configuration, so by default the changes which haven't been uploaded yet are uploaded first.
+ Setting this property back to `NO` resumes the sessions which were suspended.
+
+ The default value is `NO`.
+ */
+@property (nonatomic) BOOL suspendsSessionsInBackground;
+
 /// The sole instance of the singleton.
 + (instancetype)sharedManager NS_REFINED_FOR_SWIFT;
 
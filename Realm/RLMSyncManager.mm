@@ -22,12 +22,18 @@
 #import "RLMSyncConfiguration_Private.hpp"
 #import "RLMSyncSession_Private.hpp"
 #import "RLMSyncUser_Private.hpp"
+#import "RLMSyncUtil_Private.hpp"
 #import "RLMUtil.hpp"
 
 #import "sync/sync_config.hpp"
 #import "sync/sync_manager.hpp"
 #import "sync/sync_session.hpp"
 
+#import <mutex>
+#if __has_include(<os/log.h>)
+#import <os/log.h>
+#endif
+
 using namespace realm;
 using Level = realm::util::Logger::Level;
 
@@ -63,8 +69,46 @@ RLMSyncLogLevel logLevelForLevel(Level logLevel) {
     REALM_UNREACHABLE();    // Unrecognized log level.
 }
 
+std::mutex s_logFunctionMutex;
+RLMSyncLogFunction s_logFunction;
+
+#if __has_include(<os/log.h>)
+os_log_type_t logTypeForLevel(Level level) {
+    switch (level) {
+        case Level::off:
+        case Level::fatal:
+        case Level::error:  return OS_LOG_TYPE_ERROR;
+        case Level::warn:   return OS_LOG_TYPE_DEFAULT;
+        case Level::info:   return OS_LOG_TYPE_INFO;
+        case Level::detail:
+        case Level::debug:
+        case Level::trace:
+        case Level::all:    return OS_LOG_TYPE_DEBUG;
+    }
+    REALM_UNREACHABLE();    // Unrecognized log level.
+}
+#endif
+
 struct CocoaSyncLogger : public realm::util::RootLogger {
-    void do_log(Level, std::string message) override {
+    void do_log(Level level, std::string message) override {
+        RLMSyncLogFunction logFunction;
+        {
+            std::lock_guard<std::mutex> lock(s_logFunctionMutex);
+            logFunction = s_logFunction;
+        }
+        if (logFunction) {
+            logFunction(logLevelForLevel(level), RLMStringDataToNSString(message));
+            return;
+        }
+#if __has_include(<os/log.h>)
+        // os_log defers formatting until the message is read, so don't build an
+        // NSString for each message when it's available
+        if (&os_log_create) {
+            static os_log_t log = os_log_create("io.realm.sync", "sync");
+            os_log_with_type(log, logTypeForLevel(level), "%{public}s", message.c_str());
+            return;
+        }
+#endif
         NSLog(@"Sync: %@", RLMStringDataToNSString(message));
     }
 };
@@ -85,7 +129,19 @@ struct CocoaSyncLoggerFactory : public realm::SyncLoggerFactory {
 @property (nonatomic, nullable, strong) NSNumber *globalSSLValidationDisabled;
 @end
 
-@implementation RLMSyncManager
+@implementation RLMSyncManager {
+    NSURLSessionConfiguration *_authSessionConfiguration;
+    NSURLSession *_authSession;
+    // Configuring the file system opens the metadata Realm, which can involve
+    // reading the encryption key from the keychain, so it's done on a
+    // background queue and only waited for when something needs it
+    dispatch_group_t _fileSystemConfigured;
+    std::exception_ptr _fileSystemConfigurationError;
+    // The observers of the app's lifecycle notifications, and the sessions
+    // suspended when the app entered the background
+    NSArray *_lifecycleObservers;
+    NSArray<RLMSyncSession *> *_suspendedSessions;
+}
 
 @synthesize globalSSLValidationDisabled = _globalSSLValidationDisabled;
 
@@ -101,12 +157,24 @@ static dispatch_once_t s_onceToken;
 
 - (instancetype)initWithCustomRootDirectory:(NSURL *)rootDirectory {
     if (self = [super init]) {
-        // Initialize the sync engine.
+        // Initialize the sync engine. Every session is run by the single sync
+        // client owned by the object store's SyncManager, which also decides
+        // how sessions map onto connections to the server; the client exposes
+        // no setting for this, so there is nothing to configure from here.
         SyncManager::shared().set_logger_factory(s_syncLoggerFactory);
         bool should_encrypt = !getenv("REALM_DISABLE_METADATA_ENCRYPTION") && !RLMIsRunningInPlayground();
         auto mode = should_encrypt ? SyncManager::MetadataMode::Encryption : SyncManager::MetadataMode::NoEncryption;
         rootDirectory = rootDirectory ?: [NSURL fileURLWithPath:RLMDefaultDirectoryForBundleIdentifier(nil)];
-        SyncManager::shared().configure_file_system(rootDirectory.path.UTF8String, mode, none, true);
+        std::string rootPath = rootDirectory.path.UTF8String;
+        _fileSystemConfigured = dispatch_group_create();
+        dispatch_group_async(_fileSystemConfigured, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+            try {
+                SyncManager::shared().configure_file_system(rootPath, mode, none, true);
+            }
+            catch (...) {
+                _fileSystemConfigurationError = std::current_exception();
+            }
+        });
         return self;
     }
     return nil;
@@ -139,6 +207,45 @@ static dispatch_once_t s_onceToken;
     return [self.globalSSLValidationDisabled boolValue];
 }
 
+static NSURLSessionConfiguration *defaultAuthSessionConfiguration() {
+    NSURLSessionConfiguration *configuration = [NSURLSessionConfiguration defaultSessionConfiguration];
+    configuration.HTTPShouldUsePipelining = YES;
+    return configuration;
+}
+
+- (NSURLSessionConfiguration *)authSessionConfiguration {
+    @synchronized (self) {
+        if (!_authSessionConfiguration) {
+            _authSessionConfiguration = defaultAuthSessionConfiguration();
+        }
+        // NSURLSession copies its configuration, so hand out a copy too so that
+        // mutating the returned object can't appear to change the live session
+        return [_authSessionConfiguration copy];
+    }
+}
+
+- (void)setAuthSessionConfiguration:(NSURLSessionConfiguration *)authSessionConfiguration {
+    @synchronized (self) {
+        _authSessionConfiguration = [authSessionConfiguration copy];
+        // Let requests in flight finish on the old session; the next request
+        // creates a session from the new configuration
+        [_authSession finishTasksAndInvalidate];
+        _authSession = nil;
+    }
+}
+
+- (NSURLSession *)_authSession {
+    @synchronized (self) {
+        if (!_authSession) {
+            if (!_authSessionConfiguration) {
+                _authSessionConfiguration = defaultAuthSessionConfiguration();
+            }
+            _authSession = [NSURLSession sessionWithConfiguration:_authSessionConfiguration];
+        }
+        return _authSession;
+    }
+}
+
 #pragma mark - Passthrough properties
 
 - (RLMSyncLogLevel)logLevel {
@@ -149,8 +256,89 @@ static dispatch_once_t s_onceToken;
     realm::SyncManager::shared().set_log_level(levelForSyncLogLevel(logLevel));
 }
 
+- (RLMSyncLogFunction)logger {
+    std::lock_guard<std::mutex> lock(s_logFunctionMutex);
+    return s_logFunction;
+}
+
+- (void)setLogger:(RLMSyncLogFunction)logger {
+    std::lock_guard<std::mutex> lock(s_logFunctionMutex);
+    s_logFunction = logger;
+}
+
 #pragma mark - Private API
 
+- (BOOL)suspendsSessionsInBackground {
+    @synchronized (self) {
+        return _lifecycleObservers != nil;
+    }
+}
+
+- (void)setSuspendsSessionsInBackground:(BOOL)suspends {
+    NSNotificationCenter *center = NSNotificationCenter.defaultCenter;
+    @synchronized (self) {
+        if (suspends == (_lifecycleObservers != nil)) {
+            return;
+        }
+        if (!suspends) {
+            for (id observer in _lifecycleObservers) {
+                [center removeObserver:observer];
+            }
+            _lifecycleObservers = nil;
+        }
+        else {
+            __weak RLMSyncManager *weakSelf = self;
+            _lifecycleObservers = @[
+                [center addObserverForName:RLMApplicationDidEnterBackgroundNotification object:nil queue:nil
+                                usingBlock:^(NSNotification *) { [weakSelf _suspendActiveSessions]; }],
+                [center addObserverForName:RLMApplicationWillEnterForegroundNotification object:nil queue:nil
+                                usingBlock:^(NSNotification *) { [weakSelf _resumeSuspendedSessions]; }],
+            ];
+        }
+    }
+    if (!suspends) {
+        [self _resumeSuspendedSessions];
+    }
+}
+
+- (void)_suspendActiveSessions {
+    NSMutableArray<RLMSyncSession *> *suspended = [NSMutableArray array];
+    for (RLMSyncUser *user in [self _allUsers]) {
+        for (RLMSyncSession *session in user.allSessions) {
+            if (session.state == RLMSyncSessionStateActive) {
+                [session suspend];
+                [suspended addObject:session];
+            }
+        }
+    }
+    @synchronized (self) {
+        _suspendedSessions = [(_suspendedSessions ?: @[]) arrayByAddingObjectsFromArray:suspended];
+    }
+}
+
+- (void)_resumeSuspendedSessions {
+    NSArray<RLMSyncSession *> *suspended;
+    @synchronized (self) {
+        suspended = _suspendedSessions;
+        _suspendedSessions = nil;
+    }
+    for (RLMSyncSession *session in suspended) {
+        [session resume];
+    }
+}
+
+- (void)_waitForFileSystemConfiguration {
+    dispatch_group_wait(_fileSystemConfigured, DISPATCH_TIME_FOREVER);
+    if (_fileSystemConfigurationError) {
+        try {
+            std::rethrow_exception(_fileSystemConfigurationError);
+        }
+        catch (std::exception const& e) {
+            @throw RLMException(e);
+        }
+    }
+}
+
 - (void)_fireError:(NSError *)error {
     dispatch_async(dispatch_get_main_queue(), ^{
         if (self.errorHandler) {
@@ -178,7 +366,7 @@ static dispatch_once_t s_onceToken;
             mutableUserInfo[kRLMSyncPathOfRealmBackupCopyKey] = userInfo[@(realm::SyncError::c_recovery_file_path_key)];
             std::string original_path = [userInfo[@(realm::SyncError::c_original_file_path_key)] UTF8String];
             mutableUserInfo[kRLMSyncInitiateClientResetBlockKey] = ^{
-                SyncManager::shared().immediately_run_file_actions(original_path);
+                configured_sync_manager().immediately_run_file_actions(original_path);
             };
             error = [NSError errorWithDomain:RLMSyncErrorDomain
                                         code:RLMSyncErrorClientResetError
@@ -217,6 +405,7 @@ static dispatch_once_t s_onceToken;
 
 - (NSArray<RLMSyncUser *> *)_allUsers {
     NSMutableArray<RLMSyncUser *> *buffer = [NSMutableArray array];
+    [self _waitForFileSystemConfiguration];
     for (auto user : SyncManager::shared().all_logged_in_users()) {
         [buffer addObject:[[RLMSyncUser alloc] initWithSyncUser:std::move(user)]];
     }
@@ -224,6 +413,7 @@ static dispatch_once_t s_onceToken;
 }
 
 + (void)resetForTesting {
+    [[RLMSyncManager sharedManager] _waitForFileSystemConfiguration];
     SyncManager::shared().reset_for_testing();
 }
 
@@ -44,6 +44,14 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (nullable NSNumber *)globalSSLValidationDisabled;
 
+// Block until the sync file system and metadata Realm, which are configured
+// asynchronously when the manager is created, are ready to use
+- (void)_waitForFileSystemConfiguration;
+
+// The session created from `authSessionConfiguration`, which is used for all
+// requests sent by RLMNetworkClient
+- (NSURLSession *)_authSession;
+
 - (void)_fireError:(NSError *)error;
 
 - (void)_fireErrorWithCode:(int)errorCode
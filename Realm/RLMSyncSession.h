@@ -119,6 +119,22 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (nullable RLMSyncConfiguration *)configuration;
 
+/**
+ Stops synchronizing the session's Realm until `-resume` is called.
+
+ The session is stopped as it is when the last Realm using it is closed: depending on the stop policy of its
+ configuration, it either disconnects immediately, first finishes uploading the local changes which haven't been
+ uploaded yet, or keeps synchronizing. Local changes made while the session is suspended are uploaded when it resumes.
+ */
+- (void)suspend;
+
+/**
+ Resumes synchronizing a session stopped by `-suspend`.
+
+ This does nothing if the session isn't stopped, or if its user is no longer logged in.
+ */
+- (void)resume;
+
 /**
  Register a progress notification block.
 
@@ -154,6 +170,68 @@ NS_ASSUME_NONNULL_BEGIN
                                                                          block:(RLMProgressNotificationBlock)block
 NS_REFINED_FOR_SWIFT;
 
+/**
+ Register a block to be called with metrics about the session's network activity
+ whenever it uploads or downloads data.
+
+ The block is invoked on the same side queue as progress notification blocks,
+ with a dictionary containing the following keys:
+
+ - `uploadedBytes`, `downloadedBytes`: the number of bytes which have been
+   uploaded or downloaded.
+ - `uploadableBytes`, `downloadableBytes`: the total number of bytes which have
+   been transferred and are pending transfer in each direction.
+ - `uploadBacklog`, `downloadBacklog`: the number of bytes pending transfer in
+   each direction.
+ - `uploadRate`, `downloadRate`: the number of bytes per second transferred in
+   each direction between the two most recent updates, or `0` before there have
+   been two updates.
+
+ The metrics are computed from the progress information the session already
+ reports, so observing them costs no more than registering a progress
+ notification block for each direction.
+
+ The token returned by this method must be retained as long as notifications
+ are desired, and the `-stop` method should be called on it when notifications
+ are no longer needed and before the token is destroyed. If the session has
+ previously experienced a fatal error, no token is returned and the block will
+ never be called.
+
+ @param block The block to invoke when new metrics are available.
+
+ @return A token which must be held for as long as you want notifications to be delivered.
+ */
+- (nullable RLMProgressNotificationToken *)addMetricsNotificationBlock:(void (^)(NSDictionary<NSString *, NSNumber *> *metrics))block;
+
+/**
+ Register a block to be called when the number of bytes waiting to be uploaded
+ rises above a high-water mark, and again when it falls back to or below it.
+
+ Local writes made while offline or faster than they can be uploaded build up
+ as history which has to be uploaded later. Apps which write large amounts of
+ data can use this to pause producers while the backlog is above the mark, and
+ resume them once it has drained. The current size of the backlog is also
+ reported by `-addMetricsNotificationBlock:`.
+
+ The block is invoked on the same side queue as progress notification blocks,
+ with the current backlog and whether it is above the mark. It is only called
+ when the backlog crosses the mark, not for every change in its size.
+
+ The token returned by this method must be retained as long as notifications
+ are desired, and the `-stop` method should be called on it when notifications
+ are no longer needed and before the token is destroyed. If the session has
+ previously experienced a fatal error, no token is returned and the block will
+ never be called.
+
+ @param highWaterMark The backlog size in bytes above which the backlog is
+                      reported as exceeded.
+ @param block         The block to invoke when the backlog crosses the mark.
+
+ @return A token which must be held for as long as you want notifications to be delivered.
+ */
+- (nullable RLMProgressNotificationToken *)addUploadBacklogNotificationWithHighWaterMark:(NSUInteger)highWaterMark
+                                                                                   block:(void (^)(NSUInteger backlog, BOOL exceeded))block;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -20,12 +20,17 @@
 
 #import "RLMSyncConfiguration_Private.hpp"
 #import "RLMSyncUser_Private.hpp"
+#import "RLMUtil.hpp"
 #import "sync/sync_session.hpp"
 
+#import <atomic>
+#import <mutex>
+#import <vector>
+
 using namespace realm;
 
 @interface RLMProgressNotificationToken() {
-    uint64_t _token;
+    std::vector<uint64_t> _tokens;
     std::weak_ptr<SyncSession> _session;
 }
 @end
@@ -39,14 +44,16 @@ using namespace realm;
 
 - (void)stop {
     if (auto session = _session.lock()) {
-        session->unregister_progress_notifier(_token);
+        for (uint64_t token : _tokens) {
+            session->unregister_progress_notifier(token);
+        }
         _session.reset();
-        _token = 0;
+        _tokens.clear();
     }
 }
 
 - (void)dealloc {
-    if (_token != 0) {
+    if (!_tokens.empty()) {
         NSLog(@"RLMProgressNotificationToken released without unregistering a notification. "
               @"You must hold on to the RLMProgressNotificationToken and call "
               @"-[RLMProgressNotificationToken stop] when you no longer wish to receive "
@@ -59,8 +66,13 @@ using namespace realm;
     if (token == 0) {
         return nil;
     }
+    return [self initWithTokenValues:{token} session:std::move(session)];
+}
+
+- (nullable instancetype)initWithTokenValues:(std::vector<uint64_t>)tokens
+                                     session:(std::shared_ptr<SyncSession>)session {
     if (self = [super init]) {
-        _token = token;
+        _tokens = std::move(tokens);
         _session = session;
         return self;
     }
@@ -69,6 +81,18 @@ using namespace realm;
 
 @end
 
+namespace {
+// The most recent progress reported in each direction, from which the metrics
+// passed to a metrics notification block are computed
+struct RLMSyncMetricsState {
+    std::mutex mutex;
+    uint64_t transferred[2] = {0, 0};
+    uint64_t transferrable[2] = {0, 0};
+    double rate[2] = {0, 0};
+    CFAbsoluteTime sampleTime[2] = {0, 0};
+};
+}
+
 @interface RLMSyncSession ()
 @property (class, nonatomic, readonly) dispatch_queue_t notificationsQueue;
 @end
@@ -119,6 +143,20 @@ using namespace realm;
     return nil;
 }
 
+- (void)suspend {
+    if (auto session = _session.lock()) {
+        if (session->state() != SyncSession::PublicState::Error) {
+            session->close();
+        }
+    }
+}
+
+- (void)resume {
+    if (auto session = _session.lock()) {
+        session->revive_if_needed();
+    }
+}
+
 - (RLMSyncSessionState)state {
     if (auto session = _session.lock()) {
         if (session->state() == SyncSession::PublicState::Inactive) {
@@ -137,7 +175,11 @@ using namespace realm;
             return NO;
         }
         queue = queue ?: dispatch_get_main_queue();
+        auto signpost = std::make_shared<RLMSignpost>(RLMSignpostName::SyncUpload, [&] {
+            return @(session->path().c_str()).lastPathComponent;
+        });
         session->wait_for_upload_completion([=](std::error_code) { // FIXME: report error to user
+            signpost->end();
             dispatch_async(queue, callback);
         });
         return YES;
@@ -151,7 +193,11 @@ using namespace realm;
             return NO;
         }
         queue = queue ?: dispatch_get_main_queue();
+        auto signpost = std::make_shared<RLMSignpost>(RLMSignpostName::SyncDownload, [&] {
+            return @(session->path().c_str()).lastPathComponent;
+        });
         session->wait_for_download_completion([=](std::error_code) { // FIXME: report error to user
+            signpost->end();
             dispatch_async(queue, callback);
         });
         return YES;
@@ -181,4 +227,72 @@ using namespace realm;
     return nil;
 }
 
+- (RLMProgressNotificationToken *)addMetricsNotificationBlock:(void (^)(NSDictionary<NSString *, NSNumber *> *))block {
+    auto session = _session.lock();
+    if (!session || session->state() == SyncSession::PublicState::Error) {
+        return nil;
+    }
+
+    dispatch_queue_t queue = RLMSyncSession.notificationsQueue;
+    auto state = std::make_shared<RLMSyncMetricsState>();
+    auto notifier = [=](size_t direction) {
+        return [=](uint64_t transferred, uint64_t transferrable) {
+            NSDictionary *metrics;
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+                CFAbsoluteTime elapsed = now - state->sampleTime[direction];
+                if (state->sampleTime[direction] != 0 && elapsed > 0 && transferred >= state->transferred[direction]) {
+                    state->rate[direction] = (transferred - state->transferred[direction]) / elapsed;
+                }
+                state->transferred[direction] = transferred;
+                state->transferrable[direction] = transferrable;
+                state->sampleTime[direction] = now;
+
+                auto backlog = [&](size_t d) {
+                    return state->transferrable[d] > state->transferred[d]
+                         ? state->transferrable[d] - state->transferred[d] : 0;
+                };
+                metrics = @{@"uploadedBytes": @(state->transferred[0]),
+                            @"uploadableBytes": @(state->transferrable[0]),
+                            @"uploadBacklog": @(backlog(0)),
+                            @"uploadRate": @(state->rate[0]),
+                            @"downloadedBytes": @(state->transferred[1]),
+                            @"downloadableBytes": @(state->transferrable[1]),
+                            @"downloadBacklog": @(backlog(1)),
+                            @"downloadRate": @(state->rate[1])};
+            }
+            dispatch_async(queue, ^{
+                block(metrics);
+            });
+        };
+    };
+    std::vector<uint64_t> tokens;
+    tokens.push_back(session->register_progress_notifier(notifier(0), SyncSession::NotifierType::upload, true));
+    tokens.push_back(session->register_progress_notifier(notifier(1), SyncSession::NotifierType::download, true));
+    return [[RLMProgressNotificationToken alloc] initWithTokenValues:std::move(tokens) session:std::move(session)];
+}
+
+- (RLMProgressNotificationToken *)addUploadBacklogNotificationWithHighWaterMark:(NSUInteger)highWaterMark
+                                                                          block:(void (^)(NSUInteger, BOOL))block {
+    auto session = _session.lock();
+    if (!session || session->state() == SyncSession::PublicState::Error) {
+        return nil;
+    }
+
+    dispatch_queue_t queue = RLMSyncSession.notificationsQueue;
+    auto exceeded = std::make_shared<std::atomic<bool>>(false);
+    uint64_t token = session->register_progress_notifier([=](uint64_t transferred, uint64_t transferrable) {
+        uint64_t backlog = transferrable > transferred ? transferrable - transferred : 0;
+        bool isExceeded = backlog > highWaterMark;
+        if (exceeded->exchange(isExceeded) == isExceeded) {
+            return;
+        }
+        dispatch_async(queue, ^{
+            block((NSUInteger)backlog, isExceeded);
+        });
+    }, SyncSession::NotifierType::upload, true);
+    return [[RLMProgressNotificationToken alloc] initWithTokenValue:token session:std::move(session)];
+}
+
 @end
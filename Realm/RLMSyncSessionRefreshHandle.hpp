@@ -28,6 +28,27 @@ class SyncSession;
 
 @class RLMSyncUser;
 
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Fires the refreshes of all of a user's refresh handles from a single timer on a
+ background queue. When the timer fires, every handle whose refresh is due
+ within a short window is refreshed at once, so that the tokens of many Realms
+ opened at about the same time are refreshed in one burst of requests rather
+ than each waking the app up separately.
+ */
+@interface RLMSyncRefreshScheduler : NSObject
+
+// The serial queue refreshes are fired and their responses handled on
+@property (nonatomic, readonly) dispatch_queue_t queue;
+
+- (void)scheduleRefreshForHandle:(RLMSyncSessionRefreshHandle *)handle atDate:(NSDate *)fireDate;
+- (void)cancelRefreshForHandle:(RLMSyncSessionRefreshHandle *)handle;
+
+@end
+
+NS_ASSUME_NONNULL_END
+
 @interface RLMSyncSessionRefreshHandle ()
 
 NS_ASSUME_NONNULL_BEGIN
@@ -36,11 +36,105 @@ using namespace realm;
 
 @property (nonatomic, weak) RLMSyncUser *user;
 @property (nonatomic, strong) NSString *pathToRealm;
-@property (nonatomic) NSTimer *timer;
+@property (nonatomic, weak) RLMSyncRefreshScheduler *scheduler;
 
 @property (nonatomic) NSURL *realmURL;
 @property (nonatomic, copy) RLMSyncBasicErrorReportingBlock completionBlock;
 
+- (void)_timerFired:(NSTimer *)timer;
+
+@end
+
+@implementation RLMSyncRefreshScheduler {
+    dispatch_source_t _timer;
+    NSMapTable<RLMSyncSessionRefreshHandle *, NSDate *> *_fireDates;
+}
+
+// Refreshes due within this long of one which is firing are fired with it. This
+// is less than the buffer before token expiration which refreshes are scheduled
+// at, so refreshing early can't let a token expire.
+static const NSTimeInterval s_coalescingWindow = 5;
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _queue = dispatch_queue_create("io.realm.sync.refresh", DISPATCH_QUEUE_SERIAL);
+        _fireDates = [NSMapTable weakToStrongObjectsMapTable];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    if (_timer) {
+        dispatch_source_cancel(_timer);
+    }
+}
+
+- (void)scheduleRefreshForHandle:(RLMSyncSessionRefreshHandle *)handle atDate:(NSDate *)fireDate {
+    dispatch_async(_queue, ^{
+        [_fireDates setObject:fireDate forKey:handle];
+        [self updateTimer];
+    });
+}
+
+- (void)cancelRefreshForHandle:(RLMSyncSessionRefreshHandle *)handle {
+    dispatch_async(_queue, ^{
+        [_fireDates removeObjectForKey:handle];
+        [self updateTimer];
+    });
+}
+
+// Must be called on _queue
+- (void)updateTimer {
+    NSDate *earliest = nil;
+    for (NSDate *date in _fireDates.objectEnumerator) {
+        if (!earliest || [date compare:earliest] == NSOrderedAscending) {
+            earliest = date;
+        }
+    }
+    if (!earliest) {
+        if (_timer) {
+            dispatch_source_cancel(_timer);
+            _timer = nil;
+        }
+        return;
+    }
+
+    if (!_timer) {
+        _timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, _queue);
+        __weak RLMSyncRefreshScheduler *weakSelf = self;
+        dispatch_source_set_event_handler(_timer, ^{
+            [weakSelf fireDueRefreshes];
+        });
+        dispatch_resume(_timer);
+    }
+    // Let the system delay the timer by up to a tenth of the time until it's
+    // due so that it can be coalesced with other wakeups. Refreshes are
+    // scheduled well before the token expires, so this is capped at the
+    // coalescing window to leave the rest of that buffer for the request.
+    NSTimeInterval interval = MAX(earliest.timeIntervalSinceNow, 0);
+    NSTimeInterval leeway = MIN(interval / 10, s_coalescingWindow);
+    dispatch_source_set_timer(_timer, dispatch_walltime(NULL, (int64_t)(interval * NSEC_PER_SEC)),
+                              DISPATCH_TIME_FOREVER, (uint64_t)(leeway * NSEC_PER_SEC));
+}
+
+// Must be called on _queue
+- (void)fireDueRefreshes {
+    NSDate *cutoff = [NSDate dateWithTimeIntervalSinceNow:s_coalescingWindow];
+    NSMutableArray<RLMSyncSessionRefreshHandle *> *due = [NSMutableArray array];
+    for (RLMSyncSessionRefreshHandle *handle in _fireDates.keyEnumerator) {
+        if ([[_fireDates objectForKey:handle] compare:cutoff] != NSOrderedDescending) {
+            [due addObject:handle];
+        }
+    }
+    for (RLMSyncSessionRefreshHandle *handle in due) {
+        [_fireDates removeObjectForKey:handle];
+    }
+    [self updateTimer];
+    for (RLMSyncSessionRefreshHandle *handle in due) {
+        [handle _timerFired:nil];
+    }
+}
+
 @end
 
 @implementation RLMSyncSessionRefreshHandle
@@ -55,6 +149,7 @@ using namespace realm;
         self.user = user;
         self.completionBlock = completionBlock;
         self.realmURL = realmURL;
+        self.scheduler = user._refreshScheduler;
         // For the initial bind, we want to prolong the session's lifetime.
         _strongSession = std::move(session);
         _session = _strongSession;
@@ -65,13 +160,9 @@ using namespace realm;
     return nil;
 }
 
-- (void)dealloc {
-    [self.timer invalidate];
-}
-
 - (void)invalidate {
     _strongSession = nullptr;
-    [self.timer invalidate];
+    [self.scheduler cancelRefreshForHandle:self];
 }
 
 + (NSDate *)fireDateForTokenExpirationDate:(NSDate *)date nowDate:(NSDate *)nowDate {
@@ -82,30 +173,18 @@ using namespace realm;
 }
 
 - (void)scheduleRefreshTimer:(NSDate *)dateWhenTokenExpires {
-    // Schedule the timer on the main queue.
-    // It's very likely that this method will be run on a side thread, for example
-    // on the thread that runs `NSURLSession`'s completion blocks. We can't be
-    // guaranteed that there's an existing runloop on those threads, and we don't want
-    // to create and start a new one if one doesn't already exist.
-    dispatch_async(dispatch_get_main_queue(), ^{
-        [self.timer invalidate];
-        NSDate *fireDate = [RLMSyncSessionRefreshHandle fireDateForTokenExpirationDate:dateWhenTokenExpires
-                                                                               nowDate:[NSDate date]];
-        if (!fireDate) {
-            [self.user _unregisterRefreshHandleForURLPath:self.pathToRealm];
-            return;
-        }
-        self.timer = [[NSTimer alloc] initWithFireDate:fireDate
-                                              interval:0
-                                                target:self
-                                              selector:@selector(_timerFired:)
-                                              userInfo:nil
-                                               repeats:NO];
-        [[NSRunLoop currentRunLoop] addTimer:self.timer forMode:NSDefaultRunLoopMode];
-    });
+    NSDate *fireDate = [RLMSyncSessionRefreshHandle fireDateForTokenExpirationDate:dateWhenTokenExpires
+                                                                           nowDate:[NSDate date]];
+    if (!fireDate) {
+        [self.scheduler cancelRefreshForHandle:self];
+        [self.user _unregisterRefreshHandleForURLPath:self.pathToRealm];
+        return;
+    }
+    // The user's scheduler fires the refresh from a background queue, together
+    // with the refreshes of the user's other Realms which are due around then.
+    [self.scheduler scheduleRefreshForHandle:self atDate:fireDate];
 }
 
-/// Handler for network requests whose responses successfully parse into an auth response model.
 - (BOOL)_handleSuccessfulRequest:(RLMAuthResponseModel *)model strongUser:(RLMSyncUser *)user {
     // Success
     std::shared_ptr<SyncSession> session = _session.lock();
@@ -217,7 +296,7 @@ using namespace realm;
                                     code:RLMSyncErrorBadResponse
                                 userInfo:@{kRLMSyncErrorJSONKey: json}];
         [user _unregisterRefreshHandleForURLPath:self.pathToRealm];
-        [self.timer invalidate];
+        [self.scheduler cancelRefreshForHandle:self];
         if (self.completionBlock) {
             self.completionBlock(error);
         }
@@ -237,7 +316,7 @@ using namespace realm;
     RLMServerToken refreshToken = user._refreshToken;
     if (!refreshToken) {
         [user _unregisterRefreshHandleForURLPath:self.pathToRealm];
-        [self.timer invalidate];
+        [self.scheduler cancelRefreshForHandle:self];
         return;
     }
 
@@ -249,8 +328,17 @@ using namespace realm;
                            };
 
     __weak RLMSyncSessionRefreshHandle *weakSelf = self;
+    // Handle the response on the scheduler's queue rather than the URL
+    // session's, so that the handle's state is only touched from one queue
+    dispatch_queue_t queue = self.scheduler.queue;
     RLMSyncCompletionBlock handler = ^(NSError *error, NSDictionary *json) {
-        [weakSelf _onRefreshCompletionWithError:error json:json];
+        if (!queue) {
+            [weakSelf _onRefreshCompletionWithError:error json:json];
+            return;
+        }
+        dispatch_async(queue, ^{
+            [weakSelf _onRefreshCompletionWithError:error json:json];
+        });
     };
     [RLMNetworkClient postRequestToEndpoint:RLMServerEndpointAuth
                                      server:user.authenticationServer
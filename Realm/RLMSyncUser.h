@@ -18,7 +18,7 @@
 
 #import <Foundation/Foundation.h>
 
-@class RLMSyncUser, RLMSyncCredentials, RLMSyncSession, RLMRealm;
+@class RLMSyncUser, RLMSyncCredentials, RLMSyncPermissionChange, RLMSyncSession, RLMRealm;
 
 /**
  The state of the user object.
@@ -90,6 +90,12 @@ NS_ASSUME_NONNULL_BEGIN
  Create, log in, and asynchronously return a new user object, specifying a custom timeout for the network request.
  Credentials identifying the user must be passed in. The user becomes available in the completion block, at which point
  it is ready for use.
+
+ If a login with the same credentials and authentication server is already in progress, no new request is sent, and
+ the completion block is invoked with the result of the login in progress.
+
+ Users stay logged in across launches of the app. A returning user can be retrieved without any network request
+ from `+allUsers` or `+currentUser`, and Realms can be opened for them immediately.
  */
 + (void)logInWithCredentials:(RLMSyncCredentials *)credentials
                authServerURL:(NSURL *)authServerURL
@@ -152,6 +158,29 @@ NS_SWIFT_UNAVAILABLE("Use the full version of this API.");
  */
 - (RLMRealm *)managementRealmWithError:(NSError **)error NS_REFINED_FOR_SWIFT;
 
+/**
+ Submit a batch of permission changes to the user's Management Realm and be
+ notified once the object server has processed all of them.
+
+ All of the changes are written in a single write transaction and so are
+ uploaded together, rather than each change requiring its own transaction and
+ round trip to the server.
+
+ This method must be called from a thread with a run loop, such as the main
+ thread. The completion block is invoked on the same thread once every change
+ has been processed, with the changes which the server failed to perform. Refer
+ to their `statusCode` and `statusMessage` properties for details. If the
+ Management Realm couldn't be opened or written to, the block is invoked with
+ an error and no changes are submitted.
+
+ @param changes    The permission changes to apply.
+ @param completion A block invoked once all of the changes have been processed
+                   or an error occurs.
+ */
+- (void)applyPermissionChanges:(NSArray<RLMSyncPermissionChange *> *)changes
+                    completion:(void (^)(NSArray<RLMSyncPermissionChange *> *failedChanges,
+                                         NSError * _Nullable error))completion;
+
 /**
  Returns an instance of the Permission Realm owned by the user.
 
@@ -20,9 +20,12 @@
 
 #import "RLMAuthResponseModel.h"
 #import "RLMNetworkClient.h"
+#import "RLMResults.h"
 #import "RLMSyncManager_Private.h"
+#import "RLMSyncPermissionChange.h"
 #import "RLMSyncSession_Private.hpp"
 #import "RLMSyncSessionRefreshHandle.hpp"
+#import "RLMSyncUtil_Private.hpp"
 #import "RLMTokenModels.h"
 #import "RLMUtil.hpp"
 
@@ -30,6 +33,8 @@
 #import "sync/sync_session.hpp"
 #import "sync/sync_user.hpp"
 
+#import <mutex>
+
 using namespace realm;
 
 @interface RLMSyncUser () {
@@ -47,6 +52,8 @@ using namespace realm;
  */
 @property (nonatomic) NSMutableDictionary<NSString *, RLMSyncSessionRefreshHandle *> *refreshHandles;
 
+@property (nonatomic) RLMSyncRefreshScheduler *refreshScheduler;
+
 @end
 
 @implementation RLMSyncUser
@@ -73,6 +80,7 @@ using namespace realm;
     if (self = [super init]) {
         self.authenticationServer = authServer;
         self.refreshHandles = [NSMutableDictionary dictionary];
+        self.refreshScheduler = [[RLMSyncRefreshScheduler alloc] init];
         return self;
     }
     return nil;
@@ -130,7 +138,7 @@ using namespace realm;
     if (!_user) {
         return nil;
     }
-    auto path = SyncManager::shared().path_for_realm(_user->identity(), [url.absoluteString UTF8String]);
+    auto path = configured_sync_manager().path_for_realm(_user->identity(), [url.absoluteString UTF8String]);
     if (auto session = _user->session_for_on_disk_path(path)) {
         return [[RLMSyncSession alloc] initWithSyncSession:session];
     }
@@ -174,6 +182,47 @@ using namespace realm;
     return [RLMRealm realmWithConfiguration:[RLMRealmConfiguration managementConfigurationForUser:self] error:error];
 }
 
+- (void)applyPermissionChanges:(NSArray<RLMSyncPermissionChange *> *)changes
+                    completion:(void (^)(NSArray<RLMSyncPermissionChange *> *, NSError *))completion {
+    NSError *error = nil;
+    RLMRealm *realm = [self managementRealmWithError:&error];
+    if (!realm) {
+        completion(@[], error);
+        return;
+    }
+    NSArray<NSString *> *ids = [changes valueForKey:@"id"];
+    [realm transactionWithBlock:^{
+        [realm addObjects:changes];
+    } error:&error];
+    if (error) {
+        completion(@[], error);
+        return;
+    }
+
+    // Wait for the server to set the status of every change in the batch
+    RLMResults *submitted = [RLMSyncPermissionChange objectsInRealm:realm where:@"id IN %@", ids];
+    __block RLMNotificationToken *token = [submitted addNotificationBlock:^(RLMResults *results,
+                                                                            __unused RLMCollectionChange *change,
+                                                                            NSError *error) {
+        if (error) {
+            [token stop];
+            token = nil;
+            completion(@[], error);
+            return;
+        }
+        if ([results objectsWhere:@"statusCode = nil"].count > 0) {
+            return;
+        }
+        [token stop];
+        token = nil;
+        NSMutableArray *failed = [NSMutableArray array];
+        for (RLMSyncPermissionChange *change in [results objectsWhere:@"statusCode != 0"]) {
+            [failed addObject:change];
+        }
+        completion(failed, nil);
+    }];
+}
+
 - (RLMRealm *)permissionRealmWithError:(NSError **)error {
     return [RLMRealm realmWithConfiguration:[RLMRealmConfiguration permissionConfigurationForUser:self] error:error];
 }
@@ -232,10 +281,19 @@ using namespace realm;
                                                                       completionBlock:completion];
 }
 
+- (RLMSyncRefreshScheduler *)_refreshScheduler {
+    return self.refreshScheduler;
+}
+
 - (std::shared_ptr<SyncUser>)_syncUser {
     return _user;
 }
 
+// The completion blocks of the logins in flight, keyed by the server and
+// credentials they were sent with
+static std::mutex s_pendingLoginsMutex;
+static NSMutableDictionary<NSArray *, NSMutableArray<RLMUserCompletionBlock> *> *s_pendingLogins;
+
 + (void)_performLogInForUser:(RLMSyncUser *)user
                  credentials:(RLMSyncCredentials *)credentials
                authServerURL:(NSURL *)authServerURL
@@ -247,6 +305,32 @@ using namespace realm;
         return;
     }
 
+    // If a login with the same credentials is already in flight, wait for its
+    // result rather than sending another request
+    NSArray *loginKey = @[authServerURL, credentials.provider, credentials.token, credentials.userInfo ?: @{}];
+    {
+        std::lock_guard<std::mutex> lock(s_pendingLoginsMutex);
+        if (!s_pendingLogins) {
+            s_pendingLogins = [NSMutableDictionary dictionary];
+        }
+        if (NSMutableArray *waiting = s_pendingLogins[loginKey]) {
+            [waiting addObject:[completion copy]];
+            return;
+        }
+        s_pendingLogins[loginKey] = [NSMutableArray arrayWithObject:[completion copy]];
+    }
+    completion = ^(RLMSyncUser *user, NSError *error) {
+        NSArray<RLMUserCompletionBlock> *waiting;
+        {
+            std::lock_guard<std::mutex> lock(s_pendingLoginsMutex);
+            waiting = s_pendingLogins[loginKey];
+            [s_pendingLogins removeObjectForKey:loginKey];
+        }
+        for (RLMUserCompletionBlock block in waiting) {
+            block(user, error);
+        }
+    };
+
     // Prepare login network request
     NSMutableDictionary *json = [@{
                                    kRLMSyncProviderKey: credentials.provider,
@@ -274,9 +358,9 @@ using namespace realm;
                 return;
             } else {
                 std::string server_url = authServerURL.absoluteString.UTF8String;
-                auto sync_user = SyncManager::shared().get_user([model.refreshToken.tokenData.identity UTF8String],
-                                                                [model.refreshToken.token UTF8String],
-                                                                std::move(server_url));
+                auto sync_user = configured_sync_manager().get_user([model.refreshToken.tokenData.identity UTF8String],
+                                                                    [model.refreshToken.token UTF8String],
+                                                                    std::move(server_url));
                 if (!sync_user) {
                     completion(nil, [NSError errorWithDomain:RLMSyncErrorDomain
                                                         code:RLMSyncErrorClientSessionError
@@ -304,10 +388,10 @@ using namespace realm;
                                      completionBlock:(nonnull RLMUserCompletionBlock)completion {
     NSString *identity = credentials.userInfo[kRLMSyncIdentityKey];
     NSAssert(identity != nil, @"Improperly created direct access token credential.");
-    auto sync_user = SyncManager::shared().get_user([identity UTF8String],
-                                                    [credentials.token UTF8String],
-                                                    none,
-                                                    SyncUser::TokenType::Admin);
+    auto sync_user = configured_sync_manager().get_user([identity UTF8String],
+                                                        [credentials.token UTF8String],
+                                                        none,
+                                                        SyncUser::TokenType::Admin);
     if (!sync_user) {
         completion(nil, [NSError errorWithDomain:RLMSyncErrorDomain
                                             code:RLMSyncErrorClientSessionError
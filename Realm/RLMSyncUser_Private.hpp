@@ -24,7 +24,7 @@
 #include "sync/sync_config.hpp"
 #include "sync/impl/sync_metadata.hpp"
 
-@class RLMSyncConfiguration;
+@class RLMSyncConfiguration, RLMSyncRefreshScheduler;
 
 using namespace realm;
 
@@ -41,6 +41,8 @@ NS_ASSUME_NONNULL_BEGIN
 - (instancetype)initWithSyncUser:(std::shared_ptr<SyncUser>)user;
 - (std::shared_ptr<SyncUser>)_syncUser;
 - (nullable NSString *)_refreshToken;
+// Fires the token refreshes of all of this user's refresh handles
+- (RLMSyncRefreshScheduler *)_refreshScheduler;
 
 - (void)_unregisterRefreshHandleForURLPath:(NSString *)path;
 
@@ -19,6 +19,7 @@
 #import <Foundation/Foundation.h>
 
 #import "RLMSyncConfiguration_Private.hpp"
+#import "RLMSyncManager_Private.h"
 #import "RLMSyncUtil_Private.hpp"
 #import "RLMSyncUser_Private.hpp"
 #import "RLMRealmConfiguration+Sync.h"
@@ -100,6 +101,12 @@ RLMSyncStopPolicy translateStopPolicy(SyncSessionStopPolicy stop_policy)
     REALM_UNREACHABLE();
 }
 
+SyncManager& configured_sync_manager()
+{
+    [[RLMSyncManager sharedManager] _waitForFileSystemConfiguration];
+    return SyncManager::shared();
+}
+
 std::shared_ptr<SyncSession> sync_session_for_realm(RLMRealm *realm)
 {
     Realm::Config realmConfig = realm.configuration.config;
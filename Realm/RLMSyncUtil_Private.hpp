@@ -29,4 +29,9 @@ RLMSyncStopPolicy translateStopPolicy(SyncSessionStopPolicy stop_policy);
 
 std::shared_ptr<SyncSession> sync_session_for_realm(RLMRealm *realm);
 
+// Get the object store's sync manager once the shared RLMSyncManager has
+// finished configuring its file system. Anything which touches the sync
+// metadata or the paths of synced Realms should go through this.
+SyncManager& configured_sync_manager();
+
 }
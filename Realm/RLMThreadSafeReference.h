@@ -79,6 +79,21 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (instancetype)referenceWithThreadConfined:(Confined)threadConfined;
 
+/**
+ Create a single thread-safe reference to each of the thread-confined objects in an array.
+
+ All of the objects must be managed by the same Realm, and references to them are obtained at
+ the same version of it. This makes resolving the reference much faster than creating and
+ resolving a separate `RLMThreadSafeReference` for each object when there are many of them.
+
+ Resolving the returned reference with `-[RLMRealm resolveThreadSafeReference:]` returns an
+ `NSArray` of the resolved objects in the same order as `objects`, with `NSNull` in place of
+ any which were deleted before the reference was resolved.
+
+ @param objects The thread-confined objects to create a thread-safe reference to.
+ */
++ (RLMThreadSafeReference *)referenceWithThreadConfinedObjects:(NSArray<id<RLMThreadConfined>> *)objects;
+
 /**
  Indicates if the reference can no longer be resolved because an attempt to resolve it has already
  occurred. References can only be resolved once.
@@ -19,6 +19,8 @@
 #import "RLMThreadSafeReference_Private.hpp"
 #import "RLMUtil.hpp"
 
+#import <vector>
+
 template<typename Function>
 static auto translateErrors(Function&& f) {
     try {
@@ -29,17 +31,14 @@ static auto translateErrors(Function&& f) {
     }
 }
 
-@implementation RLMThreadSafeReference {
-    std::unique_ptr<realm::ThreadSafeReferenceBase> _reference;
-    id _metadata;
-    Class _type;
-}
-
-- (instancetype)initWithThreadConfined:(id<RLMThreadConfined>)threadConfined {
-    if (!(self = [super init])) {
-        return nil;
-    }
+// One of the objects in a reference created with referenceWithThreadConfinedObjects:
+struct RLMThreadSafeReferenceEntry {
+    std::unique_ptr<realm::ThreadSafeReferenceBase> reference;
+    id metadata;
+    Class type;
+};
 
+static void RLMValidateThreadConfined(id<RLMThreadConfined> threadConfined) {
     REALM_ASSERT_DEBUG([threadConfined conformsToProtocol:@protocol(RLMThreadConfined)]);
     if (![threadConfined conformsToProtocol:@protocol(RLMThreadConfined_Private)]) {
         @throw RLMException(@"Illegal custom conformance to `RLMThreadConfined` by `%@`", threadConfined.class);
@@ -49,7 +48,24 @@ static auto translateErrors(Function&& f) {
         @throw RLMException(@"Cannot construct reference to unmanaged object, "
                             "which can be passed across threads directly");
     }
+}
+
+@implementation RLMThreadSafeReference {
+    std::unique_ptr<realm::ThreadSafeReferenceBase> _reference;
+    id _metadata;
+    Class _type;
+
+    // Set instead of the above for references to an array of objects
+    std::vector<RLMThreadSafeReferenceEntry> _entries;
+    bool _isArray;
+}
+
+- (instancetype)initWithThreadConfined:(id<RLMThreadConfined>)threadConfined {
+    if (!(self = [super init])) {
+        return nil;
+    }
 
+    RLMValidateThreadConfined(threadConfined);
     translateErrors([&] {
         _reference = [(id<RLMThreadConfined_Private>)threadConfined makeThreadSafeReference];
         _metadata = ((id<RLMThreadConfined_Private>)threadConfined).objectiveCMetadata;
@@ -63,7 +79,38 @@ static auto translateErrors(Function&& f) {
     return [[self alloc] initWithThreadConfined:threadConfined];
 }
 
-- (id<RLMThreadConfined>)resolveReferenceInRealm:(RLMRealm *)realm {
+- (instancetype)initWithThreadConfinedObjects:(NSArray<id<RLMThreadConfined>> *)objects {
+    if (!(self = [super init])) {
+        return nil;
+    }
+    _isArray = true;
+    _entries.reserve(objects.count);
+
+    RLMRealm *realm = nil;
+    for (id<RLMThreadConfined> threadConfined in objects) {
+        RLMValidateThreadConfined(threadConfined);
+        if (!realm) {
+            realm = threadConfined.realm;
+        }
+        else if (threadConfined.realm != realm) {
+            @throw RLMException(@"Cannot construct a single reference to objects managed by different Realms");
+        }
+        auto confined = (id<RLMThreadConfined_Private>)threadConfined;
+        translateErrors([&] {
+            _entries.push_back({[confined makeThreadSafeReference], confined.objectiveCMetadata, confined.class});
+        });
+    }
+    return self;
+}
+
++ (RLMThreadSafeReference *)referenceWithThreadConfinedObjects:(NSArray<id<RLMThreadConfined>> *)objects {
+    return [[self alloc] initWithThreadConfinedObjects:objects];
+}
+
+- (id)resolveReferenceInRealm:(RLMRealm *)realm {
+    if (_isArray) {
+        return [self resolveArrayInRealm:realm];
+    }
     if (!_reference) {
         @throw RLMException(@"Can only resolve a thread safe reference once.");
     }
@@ -72,8 +119,26 @@ static auto translateErrors(Function&& f) {
     });
 }
 
+- (NSArray *)resolveArrayInRealm:(RLMRealm *)realm {
+    _isArray = false;
+
+    // All of the references were obtained at the same version, so if the
+    // target Realm isn't already past that version, resolving the first one
+    // brings it to that version and the rest are imported directly
+    auto entries = std::move(_entries);
+    NSMutableArray *objects = [NSMutableArray arrayWithCapacity:entries.size()];
+    translateErrors([&] {
+        for (auto& entry : entries) {
+            id object = [entry.type objectWithThreadSafeReference:std::move(entry.reference)
+                                                         metadata:entry.metadata realm:realm];
+            [objects addObject:object ?: NSNull.null];
+        }
+    });
+    return objects;
+}
+
 - (BOOL)isInvalidated {
-    return !_reference;
+    return !_reference && !_isArray;
 }
 
 @end
@@ -20,11 +20,14 @@
 #import <Realm/RLMOptionalBase.h>
 #import <objc/runtime.h>
 
+#import <memory>
+
 #import <realm/array.hpp>
 #import <realm/binary_data.hpp>
 #import <realm/string_data.hpp>
 #import <realm/timestamp.hpp>
 #import <realm/util/file.hpp>
+#import <realm/util/optional.hpp>
 
 namespace realm {
     class Mixed;
@@ -49,6 +52,12 @@ NSError *RLMMakeError(NSException *exception);
 
 void RLMSetErrorOrThrow(NSError *error, NSError **outError);
 
+// The names of the notifications UIKit posts when the app enters the background
+// and returns to the foreground, which are observed by name so that no UIKit
+// symbols are needed
+extern NSString *const RLMApplicationDidEnterBackgroundNotification;
+extern NSString *const RLMApplicationWillEnterForegroundNotification;
+
 // returns if the object can be inserted as the given type
 BOOL RLMIsObjectValidForProperty(id obj, RLMProperty *prop);
 // throw an exception if the object is not a valid value for the property
@@ -116,6 +125,91 @@ static inline realm::StringData RLMStringDataWithNSString(__unsafe_unretained NS
                                [string lengthOfBytesUsingEncoding:NSUTF8StringEncoding]);
 }
 
+// Converts an NSString to StringData without creating an autoreleased UTF-8
+// copy of it. ASCII strings are referenced in place, and other strings are
+// converted in a single pass into a buffer owned by this object, which is
+// inline for short strings. The StringData is only valid for as long as both
+// this object and the string are, so this is meant to be used either as a
+// temporary passed directly to a function taking StringData or as a local.
+// RLMStringDataWithNSString() is still needed when the StringData has to
+// outlive the current scope.
+class RLMStringDataBuffer {
+public:
+    explicit RLMStringDataBuffer(__unsafe_unretained NSString *const string) {
+        if (!string) {
+            return;
+        }
+        CFStringRef cfString = (__bridge CFStringRef)string;
+        CFIndex length = CFStringGetLength(cfString);
+        if (const char *ascii = CFStringGetCStringPtr(cfString, kCFStringEncodingASCII)) {
+            _data = realm::StringData(ascii, length);
+            return;
+        }
+
+        // Each UTF-16 code unit takes at most three bytes as UTF-8
+        CFIndex capacity = length * 3;
+        char *buffer = _inline;
+        if (capacity > CFIndex(sizeof(_inline))) {
+            _heap.reset(new char[capacity]);
+            buffer = _heap.get();
+        }
+        CFIndex used = 0;
+        CFStringGetBytes(cfString, CFRangeMake(0, length), kCFStringEncodingUTF8, 0, false,
+                         reinterpret_cast<UInt8 *>(buffer), capacity, &used);
+        _data = realm::StringData(buffer, used);
+    }
+
+    operator realm::StringData() const { return _data; }
+
+    RLMStringDataBuffer(RLMStringDataBuffer const&) = delete;
+    RLMStringDataBuffer& operator=(RLMStringDataBuffer const&) = delete;
+
+private:
+    realm::StringData _data;
+    std::unique_ptr<char[]> _heap;
+    char _inline[256];
+};
+
+// The case- and diacritic-folded form of a string, which is what the folded
+// copies of properties listed in +foldedIndexedProperties hold
+static inline NSString *RLMFoldedString(__unsafe_unretained NSString *const string) {
+    return [string stringByFoldingWithOptions:NSCaseInsensitiveSearch | NSDiacriticInsensitiveSearch locale:nil];
+}
+
+// The value held by the key property of a compound index (see
+// +[RLMObject compoundIndexes]) for an object with the given values of the
+// properties it combines, in the same order. nil and NSNull are both null.
+NSString *RLMCompoundIndexKey(NSArray<RLMProperty *> *components, NSArray *values);
+
+// The value held by a collation key (see +[RLMObject collationKeys]) for a
+// string, or nil for nil. The key is the case-, diacritic- and width-folded
+// form of the string in the given locale, with each run of digits prefixed by
+// its length so that the keys of "file2" and "file10" sort numerically.
+NSString *RLMCollationKey(NSString *string, NSLocale *locale);
+
+// Geo indexes (see +[RLMObject geoIndexes]) divide latitudes and longitudes
+// into 2^31 steps each, and key each location by its latitude and longitude
+// steps with their bits interleaved. Each prefix of the bits of a key is then a
+// cell of a quadtree, and the keys within a cell are a contiguous range.
+static const int RLMGeoIndexBits = 31;
+
+// The step containing a coordinate within [min, max]. Coordinates outside the
+// range are clamped to it.
+static inline uint32_t RLMGeoIndexStep(double value, double min, double max) {
+    double step = (value - min) / (max - min) * (1u << RLMGeoIndexBits);
+    const uint32_t maxStep = (1u << RLMGeoIndexBits) - 1;
+    return step <= 0 ? 0 : step >= maxStep ? maxStep : (uint32_t)step;
+}
+
+// The key of the steps containing a latitude and longitude, with the latitude
+// in the odd bits and the longitude in the even bits
+int64_t RLMGeoIndexKey(uint32_t latitudeStep, uint32_t longitudeStep);
+
+// The key a geo index holds for a location, or nothing if either coordinate is
+// null or not a number
+realm::util::Optional<int64_t> RLMGeoIndexKey(realm::util::Optional<double> latitude,
+                                              realm::util::Optional<double> longitude);
+
 // Binary conversion utilities
 static inline NSData *RLMBinaryDataToNSData(realm::BinaryData binaryData) {
     return binaryData ? [NSData dataWithBytes:binaryData.data() length:binaryData.size()] : nil;
@@ -175,3 +269,50 @@ void RLMSetTreatFakeObjectAsRLMObject(BOOL flag);
 // Given a bundle identifier, return the base directory on the disk within which Realm database and support files should
 // be stored.
 NSString *RLMDefaultDirectoryForBundleIdentifier(NSString *bundleIdentifier);
+
+// The binding's hot paths which are reported as os_signpost intervals
+enum class RLMSignpostName {
+    BeginWrite,
+    CommitWrite,
+    BuildQuery,
+    EvaluateResults,
+    CollectionNotification,
+    Migration,
+    Compact,
+    SyncUpload,
+    SyncDownload,
+};
+
+// Whether Instruments is currently recording Realm's signposts
+bool RLMSignpostsEnabled();
+
+// Marks the lifetime of the object (or until end() is called) as an
+// os_signpost interval in the "Performance" category of the io.realm
+// subsystem. `describe` produces the begin message, typically a class name,
+// and is only called if signposts are being recorded; the row count set with
+// setRowCount() is reported as the end message.
+class RLMSignpost {
+public:
+    template<typename Describe>
+    RLMSignpost(RLMSignpostName name, Describe&& describe) : _name(name) {
+        if (RLMSignpostsEnabled()) {
+            begin(describe());
+        }
+    }
+    ~RLMSignpost() { end(); }
+    void end();
+
+    bool active() const { return _id != 0; }
+    void setRowCount(size_t rows) { _rows = rows; _hasRows = true; }
+
+    RLMSignpost(RLMSignpost const&) = delete;
+    RLMSignpost& operator=(RLMSignpost const&) = delete;
+
+private:
+    void begin(NSString *description);
+
+    RLMSignpostName _name;
+    uint64_t _id = 0;
+    size_t _rows = 0;
+    bool _hasRows = false;
+};
@@ -32,9 +32,17 @@
 #import <realm/mixed.hpp>
 #import <realm/table_view.hpp>
 
+#include <cmath>
 #include <sys/sysctl.h>
 #include <sys/types.h>
 
+#if __has_include(<os/signpost.h>)
+#import <os/signpost.h>
+#define REALM_HAVE_SIGNPOSTS 1
+#else
+#define REALM_HAVE_SIGNPOSTS 0
+#endif
+
 #if !defined(REALM_COCOA_VERSION)
 #import "RLMVersion.h"
 #endif
@@ -133,7 +141,10 @@ BOOL RLMIsObjectValidForProperty(__unsafe_unretained id const obj,
             }
             return NO;
         case RLMPropertyTypeData:
-            return [obj isKindOfClass:[NSData class]];
+            if (NSData *data = RLMDynamicCast<NSData>(obj)) {
+                return !property.vectorDimension || data.length == property.vectorDimension * sizeof(float);
+            }
+            return NO;
         case RLMPropertyTypeAny:
             return NO;
         case RLMPropertyTypeLinkingObjects:
@@ -181,6 +192,12 @@ void RLMValidateValueForProperty(__unsafe_unretained id const obj,
         case RLMPropertyTypeDouble:
         case RLMPropertyTypeData:
             if (!RLMIsObjectValidForProperty(obj, prop)) {
+                if (prop.vectorDimension && [obj isKindOfClass:[NSData class]]) {
+                    @throw RLMException(@"Invalid value for vector property '%@': expected %llu floats (%llu bytes), but got %llu bytes.",
+                                        prop.name, (unsigned long long)prop.vectorDimension,
+                                        (unsigned long long)(prop.vectorDimension * sizeof(float)),
+                                        (unsigned long long)[obj length]);
+                }
                 @throw RLMException(@"Invalid value '%@' for property '%@'", obj, prop.name);
             }
             break;
@@ -301,6 +318,9 @@ void RLMSetErrorOrThrow(NSError *error, NSError **outError) {
     }
 }
 
+NSString *const RLMApplicationDidEnterBackgroundNotification = @"UIApplicationDidEnterBackgroundNotification";
+NSString *const RLMApplicationWillEnterForegroundNotification = @"UIApplicationWillEnterForegroundNotification";
+
 // Determines if class1 descends from class2
 static inline BOOL RLMIsSubclass(Class class1, Class class2) {
     class1 = class_getSuperclass(class1);
@@ -383,6 +403,97 @@ id RLMMixedToObjc(realm::Mixed const& mixed) {
     }
 }
 
+NSString *RLMCompoundIndexKey(NSArray<RLMProperty *> *components, NSArray *values) {
+    // Each value is written as '-' for null or '+' followed by the value, and
+    // the values are separated by '|', which is escaped within strings
+    NSMutableString *key = [NSMutableString new];
+    NSUInteger i = 0;
+    for (RLMProperty *component in components) {
+        if (i) {
+            [key appendString:@"|"];
+        }
+        id value = RLMCoerceToNil(values[i++]);
+        if (!value) {
+            [key appendString:@"-"];
+            continue;
+        }
+        [key appendString:@"+"];
+        switch (component.type) {
+            case RLMPropertyTypeInt:
+                [key appendFormat:@"%lld", [value longLongValue]];
+                break;
+            case RLMPropertyTypeBool:
+                [key appendString:[value boolValue] ? @"1" : @"0"];
+                break;
+            case RLMPropertyTypeDate: {
+                auto timestamp = RLMTimestampForNSDate(value);
+                [key appendFormat:@"%lld.%d", (long long)timestamp.get_seconds(), (int)timestamp.get_nanoseconds()];
+                break;
+            }
+            case RLMPropertyTypeString: {
+                NSString *escaped = [value stringByReplacingOccurrencesOfString:@"\\" withString:@"\\\\"];
+                [key appendString:[escaped stringByReplacingOccurrencesOfString:@"|" withString:@"\\|"]];
+                break;
+            }
+            default:
+                REALM_UNREACHABLE();
+        }
+    }
+    return key;
+}
+
+NSString *RLMCollationKey(NSString *string, NSLocale *locale) {
+    if (!string) {
+        return nil;
+    }
+    NSString *folded = [string stringByFoldingWithOptions:NSCaseInsensitiveSearch | NSDiacriticInsensitiveSearch | NSWidthInsensitiveSearch
+                                                   locale:locale];
+    NSUInteger length = folded.length;
+    NSMutableString *key = [NSMutableString stringWithCapacity:length + 4];
+    NSUInteger i = 0;
+    while (i < length) {
+        unichar c = [folded characterAtIndex:i];
+        if (c < '0' || c > '9') {
+            [key appendFormat:@"%C", c];
+            ++i;
+            continue;
+        }
+        // Leading zeros don't change the value, and the length of what's left
+        // orders numbers of different lengths; runs of more than 99 digits
+        // just compare by their first 99
+        while (i < length && [folded characterAtIndex:i] == '0') {
+            ++i;
+        }
+        NSUInteger digits = i;
+        while (i < length && [folded characterAtIndex:i] >= '0' && [folded characterAtIndex:i] <= '9') {
+            ++i;
+        }
+        NSString *number = i > digits ? [folded substringWithRange:NSMakeRange(digits, i - digits)] : @"0";
+        if (number.length > 99) {
+            number = [number substringToIndex:99];
+        }
+        [key appendFormat:@"%02lu%@", (unsigned long)number.length, number];
+    }
+    return key;
+}
+
+int64_t RLMGeoIndexKey(uint32_t latitudeStep, uint32_t longitudeStep) {
+    uint64_t key = 0;
+    for (int i = 0; i < RLMGeoIndexBits; ++i) {
+        key |= uint64_t(longitudeStep >> i & 1) << (2 * i);
+        key |= uint64_t(latitudeStep >> i & 1) << (2 * i + 1);
+    }
+    return key;
+}
+
+realm::util::Optional<int64_t> RLMGeoIndexKey(realm::util::Optional<double> latitude,
+                                              realm::util::Optional<double> longitude) {
+    if (!latitude || !longitude || std::isnan(*latitude) || std::isnan(*longitude)) {
+        return realm::util::none;
+    }
+    return RLMGeoIndexKey(RLMGeoIndexStep(*latitude, -90, 90), RLMGeoIndexStep(*longitude, -180, 180));
+}
+
 NSString *RLMDefaultDirectoryForBundleIdentifier(NSString *bundleIdentifier) {
 #if TARGET_OS_TV
     (void)bundleIdentifier;
@@ -416,3 +527,64 @@ NSString *RLMDefaultDirectoryForBundleIdentifier(NSString *bundleIdentifier) {
     return path;
 #endif
 }
+
+#if REALM_HAVE_SIGNPOSTS
+API_AVAILABLE(macos(10.14), ios(12.0), tvos(12.0), watchos(5.0))
+static os_log_t performanceLog() {
+    static os_log_t log = os_log_create("io.realm", "Performance");
+    return log;
+}
+
+// os_signpost requires the interval names to be string literals
+#define RLM_SIGNPOST_FOR_NAME(fn, log, id, name, ...) do { \
+    switch (name) { \
+        case RLMSignpostName::BeginWrite:             fn(log, id, "Begin write", ##__VA_ARGS__); break; \
+        case RLMSignpostName::CommitWrite:            fn(log, id, "Commit write", ##__VA_ARGS__); break; \
+        case RLMSignpostName::BuildQuery:             fn(log, id, "Build query", ##__VA_ARGS__); break; \
+        case RLMSignpostName::EvaluateResults:        fn(log, id, "Evaluate results", ##__VA_ARGS__); break; \
+        case RLMSignpostName::CollectionNotification: fn(log, id, "Collection notification", ##__VA_ARGS__); break; \
+        case RLMSignpostName::Migration:              fn(log, id, "Migration", ##__VA_ARGS__); break; \
+        case RLMSignpostName::Compact:                fn(log, id, "Compact", ##__VA_ARGS__); break; \
+        case RLMSignpostName::SyncUpload:             fn(log, id, "Sync upload", ##__VA_ARGS__); break; \
+        case RLMSignpostName::SyncDownload:           fn(log, id, "Sync download", ##__VA_ARGS__); break; \
+    } \
+} while (0)
+#endif
+
+bool RLMSignpostsEnabled() {
+#if REALM_HAVE_SIGNPOSTS
+    if (__builtin_available(macOS 10.14, iOS 12.0, tvOS 12.0, watchOS 5.0, *)) {
+        return os_signpost_enabled(performanceLog());
+    }
+#endif
+    return false;
+}
+
+void RLMSignpost::begin(__unsafe_unretained NSString *const description) {
+#if REALM_HAVE_SIGNPOSTS
+    if (__builtin_available(macOS 10.14, iOS 12.0, tvOS 12.0, watchOS 5.0, *)) {
+        os_log_t log = performanceLog();
+        _id = os_signpost_id_generate(log);
+        RLM_SIGNPOST_FOR_NAME(os_signpost_interval_begin, log, _id, _name, "%{public}@", description);
+    }
+#else
+    (void)description;
+#endif
+}
+
+void RLMSignpost::end() {
+    if (!_id) {
+        return;
+    }
+#if REALM_HAVE_SIGNPOSTS
+    if (__builtin_available(macOS 10.14, iOS 12.0, tvOS 12.0, watchOS 5.0, *)) {
+        if (_hasRows) {
+            RLM_SIGNPOST_FOR_NAME(os_signpost_interval_end, performanceLog(), _id, _name, "%zu rows", _rows);
+        }
+        else {
+            RLM_SIGNPOST_FOR_NAME(os_signpost_interval_end, performanceLog(), _id, _name);
+        }
+    }
+#endif
+    _id = 0;
+}
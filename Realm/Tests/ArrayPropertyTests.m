@@ -127,6 +127,45 @@
     XCTAssertEqualObjects([children[1] stringCol], @"b", @"Second child should be 'b'");
 }
 
+- (void)testReplaceObjectsInRange {
+    RLMRealm *realm = [self realmWithTestPath];
+    [realm beginWriteTransaction];
+    ArrayPropertyObject *obj = [ArrayPropertyObject createInRealm:realm
+                                                        withValue:@[@"arrayObject", @[@[@"a"], @[@"b"], @[@"c"]], @[]]];
+    StringObject *d = [StringObject createInRealm:realm withValue:@[@"d"]];
+    StringObject *e = [[StringObject alloc] initWithValue:@[@"e"]];
+
+    // fewer new objects than replaced
+    [obj.array replaceObjectsInRange:NSMakeRange(0, 2) withObjects:@[d]];
+    XCTAssertEqualObjects([obj.array valueForKey:@"stringCol"], (@[@"d", @"c"]));
+
+    // more new objects than replaced, including an unmanaged one
+    [obj.array replaceObjectsInRange:NSMakeRange(1, 1) withObjects:@[e, d, d]];
+    XCTAssertEqualObjects([obj.array valueForKey:@"stringCol"], (@[@"d", @"e", @"d", @"d"]));
+    XCTAssertNotNil(e.realm);
+
+    // empty range is an insertion
+    [obj.array replaceObjectsInRange:NSMakeRange(4, 0) withObjects:@[e]];
+    XCTAssertEqualObjects([obj.array valueForKey:@"stringCol"], (@[@"d", @"e", @"d", @"d", @"e"]));
+
+    // nothing is changed if any of the objects are invalid
+    RLMAssertThrowsWithReasonMatching([obj.array replaceObjectsInRange:NSMakeRange(0, 5)
+                                                           withObjects:@[d, [[IntObject alloc] init]]],
+                                      @"Cannot add object of type 'IntObject'");
+    XCTAssertEqual(obj.array.count, 5U);
+    RLMAssertThrowsWithReasonMatching([obj.array replaceObjectsInRange:NSMakeRange(4, 2) withObjects:@[]],
+                                      @"out of bounds");
+
+    [obj.array replaceObjectsInRange:NSMakeRange(0, 5) withObjects:@[]];
+    XCTAssertEqual(obj.array.count, 0U);
+    [realm commitWriteTransaction];
+
+    StringObject *unmanaged = [[StringObject alloc] initWithValue:@[@"x"]];
+    ArrayPropertyObject *unmanagedObj = [[ArrayPropertyObject alloc] initWithValue:@[@"", @[@[@"a"], @[@"b"]], @[]]];
+    [unmanagedObj.array replaceObjectsInRange:NSMakeRange(0, 1) withObjects:@[unmanaged, unmanaged]];
+    XCTAssertEqualObjects([unmanagedObj.array valueForKey:@"stringCol"], (@[@"x", @"x", @"b"]));
+}
+
 -(void)testInsertAtIndex {
     RLMRealm *realm = [self realmWithTestPath];
 
@@ -421,6 +460,74 @@
     [realm commitWriteTransaction];
 }
 
+- (void)testSortUsingDescriptors {
+    void (^test)(RLMArray *) = ^(RLMArray *array) {
+        NSArray *(^values)(void) = ^{
+            return [array valueForKey:@"stringCol"];
+        };
+
+        [array sortUsingDescriptors:@[[RLMSortDescriptor sortDescriptorWithKeyPath:@"stringCol" ascending:YES]]];
+        XCTAssertEqualObjects(values(), (@[@"a", @"b", @"b", @"c", @"d"]));
+
+        [array sortUsingDescriptors:@[[RLMSortDescriptor sortDescriptorWithKeyPath:@"stringCol" ascending:NO]]];
+        XCTAssertEqualObjects(values(), (@[@"d", @"c", @"b", @"b", @"a"]));
+
+        [array sortUsingDescriptors:@[]];
+        XCTAssertEqualObjects(values(), (@[@"d", @"c", @"b", @"b", @"a"]));
+    };
+
+    ArrayPropertyObject *array = [[ArrayPropertyObject alloc] initWithValue:@[@"foo", @[@[@"c"], @[@"a"], @[@"d"], @[@"b"], @[@"b"]], @[]]];
+    test(array.array);
+
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm beginWriteTransaction];
+    [realm addObject:array];
+    test(array.array);
+
+    // equal objects keep their relative order
+    StringObject *b1 = array.array[2], *b2 = array.array[3];
+    [array.array sortUsingDescriptors:@[[RLMSortDescriptor sortDescriptorWithKeyPath:@"stringCol" ascending:YES]]];
+    XCTAssertTrue([b1 isEqualToObject:array.array[1]]);
+    XCTAssertTrue([b2 isEqualToObject:array.array[2]]);
+    [realm commitWriteTransaction];
+
+    RLMAssertThrowsWithReasonMatching([array.array sortUsingDescriptors:@[[RLMSortDescriptor sortDescriptorWithKeyPath:@"stringCol" ascending:NO]]],
+                                      @"write transaction");
+}
+
+- (void)testSortUsingDescriptorsReportsMoves {
+    RLMRealm *realm = self.realmWithTestPath;
+    [realm beginWriteTransaction];
+    ArrayPropertyObject *array = [ArrayPropertyObject createInRealm:realm withValue:@[@"", @[@[@"b"], @[@"c"], @[@"d"], @[@"a"]], @[]]];
+    [realm commitWriteTransaction];
+
+    __block id expectation = [self expectationWithDescription:@""];
+    __block RLMCollectionChange *changes;
+    id token = [array.array addNotificationBlock:^(__unused RLMArray *array, RLMCollectionChange *change, NSError *error) {
+        XCTAssertNil(error);
+        changes = change;
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+
+    expectation = [self expectationWithDescription:@""];
+    [realm transactionWithBlock:^{
+        [array.array sortUsingDescriptors:@[[RLMSortDescriptor sortDescriptorWithKeyPath:@"stringCol" ascending:YES]]];
+    }];
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+
+    XCTAssertEqualObjects([array.array valueForKey:@"stringCol"], (@[@"a", @"b", @"c", @"d"]));
+    __block NSUInteger moveCount = 0;
+    [changes enumerateMovesUsingBlock:^(NSUInteger from, NSUInteger to, __unused BOOL *stop) {
+        XCTAssertEqual(3U, from);
+        XCTAssertEqual(0U, to);
+        ++moveCount;
+    }];
+    XCTAssertEqual(1U, moveCount);
+
+    [(RLMNotificationToken *)token stop];
+}
+
 - (void)testIndexOfObject
 {
     RLMRealm *realm = [RLMRealm defaultRealm];
@@ -467,6 +574,75 @@
     XCTAssertEqual((NSUInteger)NSNotFound, [employees indexOfObject:po3]);
 }
 
+- (void)testObjectsAtIndexes
+{
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    NSIndexSet *indexes = [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(1, 2)];
+
+    CompanyObject *company = [[CompanyObject alloc] init];
+    for (int i = 0; i < 4; ++i) {
+        [company.employees addObject:[[EmployeeObject alloc] initWithValue:@[[@(i) stringValue], @(i), @NO]]];
+    }
+    XCTAssertEqualObjects([[company.employees objectsAtIndexes:indexes] valueForKey:@"age"], (@[@1, @2]));
+
+    [realm beginWriteTransaction];
+    [realm addObject:company];
+    [realm commitWriteTransaction];
+
+    XCTAssertEqualObjects([[company.employees objectsAtIndexes:indexes] valueForKey:@"age"], (@[@1, @2]));
+    XCTAssertEqualObjects([company.employees objectsAtIndexes:[NSIndexSet indexSet]], @[]);
+    RLMAssertThrowsWithReasonMatching([company.employees objectsAtIndexes:[NSIndexSet indexSetWithIndex:4]], @"out of bounds");
+
+    [realm beginWriteTransaction];
+    [realm deleteObject:company];
+    [realm commitWriteTransaction];
+    XCTAssertNil([company.employees objectsAtIndexes:indexes]);
+}
+
+- (void)testIndexOfObjectInLargeArray
+{
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    const NSUInteger count = 2000;
+
+    [realm beginWriteTransaction];
+    ArrayPropertyObject *array = [ArrayPropertyObject createInRealm:realm withValue:@[@"name", @[], @[]]];
+    for (NSUInteger i = 0; i < count; ++i) {
+        [array.array addObject:[StringObject createInRealm:realm withValue:@[@(i).stringValue]]];
+    }
+    StringObject *notInArray = [StringObject createInRealm:realm withValue:@[@"not in array"]];
+    [realm commitWriteTransaction];
+
+    StringObject *first = array.array.firstObject;
+    StringObject *last = array.array.lastObject;
+    XCTAssertEqual(0U, [array.array indexOfObject:first]);
+    XCTAssertEqual(count - 1, [array.array indexOfObject:last]);
+    XCTAssertEqual((NSUInteger)NSNotFound, [array.array indexOfObject:notInArray]);
+    XCTAssertEqual((NSUInteger)NSNotFound, [array.array indexOfObject:[[StringObject alloc] initWithValue:@[@"0"]]]);
+
+    // mutations within a write transaction are seen immediately
+    [realm beginWriteTransaction];
+    [array.array removeObjectAtIndex:0];
+    [array.array addObject:notInArray];
+    XCTAssertEqual((NSUInteger)NSNotFound, [array.array indexOfObject:first]);
+    XCTAssertEqual(count - 1, [array.array indexOfObject:notInArray]);
+    [realm commitWriteTransaction];
+
+    XCTAssertEqual(count - 2, [array.array indexOfObject:last]);
+    XCTAssertEqual(count - 1, [array.array indexOfObject:notInArray]);
+
+    // as are changes made on other threads once the Realm is refreshed
+    [self dispatchAsyncAndWait:^{
+        RLMRealm *realm = [RLMRealm defaultRealm];
+        ArrayPropertyObject *array = [[ArrayPropertyObject allObjectsInRealm:realm] firstObject];
+        [realm transactionWithBlock:^{
+            [array.array moveObjectAtIndex:array.array.count - 1 toIndex:0];
+        }];
+    }];
+    [realm refresh];
+    XCTAssertEqual(0U, [array.array indexOfObject:notInArray]);
+    XCTAssertEqual(count - 1, [array.array indexOfObject:last]);
+}
+
 - (void)testIndexOfObjectWhere
 {
     RLMRealm *realm = [RLMRealm defaultRealm];
@@ -682,6 +858,25 @@
     RLMAssertThrowsWithReasonMatching([company.employees valueForKeyPath:@"@sum.dogs.@sum.age"], @"Nested key paths.*not supported");
 }
 
+- (void)testValueForKeyOfWrappedValues {
+    RLMRealm *realm = self.realmWithTestPath;
+    [realm beginWriteTransaction];
+    ArrayPropertyObject *obj = [ArrayPropertyObject createInRealm:realm withValue:@[@"n", @[@[@"b"], @[NSNull.null], @[@"a"]], @[@[@3], @[@1]]]];
+    [realm commitWriteTransaction];
+
+    XCTAssertEqualObjects([obj.array valueForKey:@"stringCol"], (@[@"b", NSNull.null, @"a"]));
+    XCTAssertEqualObjects([obj.intArray valueForKey:@"intCol"], (@[@3, @1]));
+    XCTAssertEqualObjects([[obj.intArray sortedResultsUsingKeyPath:@"intCol" ascending:YES] valueForKey:@"intCol"], (@[@1, @3]));
+
+    [realm beginWriteTransaction];
+    [obj.array removeObjectAtIndex:0];
+    [obj.intArray[0] setIntCol:5];
+    [realm commitWriteTransaction];
+
+    XCTAssertEqualObjects([obj.array valueForKey:@"stringCol"], (@[NSNull.null, @"a"]));
+    XCTAssertEqualObjects([obj.intArray valueForKey:@"intCol"], (@[@5, @1]));
+}
+
 - (void)testSetValueForKey {
     RLMRealm *realm = self.realmWithTestPath;
 
@@ -787,6 +982,22 @@
         XCTAssertEqualObjects(dateMaxInput, [array maxOfProperty:@"dateCol"]);
         RLMAssertThrowsWithReasonMatching([array maxOfProperty:@"foo"], @"foo.*AggregateObject");
         RLMAssertThrowsWithReasonMatching([array maxOfProperty:@"boolCol"], @"max.*bool");
+
+        // Statistics
+        RLMPropertyStatistics *stats = [array statisticsForProperty:@"intCol"];
+        XCTAssertEqual(10U, stats.count);
+        XCTAssertEqualObjects(@0, stats.minimum);
+        XCTAssertEqualObjects(@1, stats.maximum);
+        XCTAssertEqualObjects(@4, stats.sum);
+        XCTAssertEqualWithAccuracy(stats.average.doubleValue, 0.4, 0.001);
+        XCTAssertEqualWithAccuracy(stats.variance.doubleValue, 0.24, 0.001);
+        stats = [array statisticsForProperty:@"doubleCol"];
+        XCTAssertEqual(2.5, stats.maximum.doubleValue);
+        XCTAssertEqualWithAccuracy(stats.variance.doubleValue, 1.5, 0.001);
+        XCTAssertEqual(1.2f, [array statisticsForProperty:@"floatCol"].maximum.floatValue);
+        RLMAssertThrowsWithReasonMatching([array statisticsForProperty:@"foo"], @"foo.*AggregateObject");
+        RLMAssertThrowsWithReasonMatching([array statisticsForProperty:@"boolCol"], @"statistics.*bool");
+        RLMAssertThrowsWithReasonMatching([array statisticsForProperty:@"dateCol"], @"statistics.*date");
     };
 
     test();
@@ -1225,6 +1436,7 @@
     XCTAssertNoThrow([array replaceObjectAtIndex:0 withObject:io]);
     XCTAssertNoThrow([array moveObjectAtIndex:0 toIndex:1]);
     XCTAssertNoThrow([array exchangeObjectAtIndex:0 withObjectAtIndex:1]);
+    XCTAssertNoThrow([array replaceObjectsInRange:NSMakeRange(0, 1) withObjects:@[io, io]]);
 
     XCTAssertNoThrow([array indexOfObject:[IntObject allObjects].firstObject]);
     XCTAssertNoThrow([array indexOfObjectWhere:@"intCol = 0"]);
@@ -1262,6 +1474,7 @@
     RLMAssertThrowsWithReasonMatching([array replaceObjectAtIndex:0 withObject:io], @"invalidated");
     RLMAssertThrowsWithReasonMatching([array moveObjectAtIndex:0 toIndex:1], @"invalidated");
     RLMAssertThrowsWithReasonMatching([array exchangeObjectAtIndex:0 withObjectAtIndex:1], @"invalidated");
+    RLMAssertThrowsWithReasonMatching([array replaceObjectsInRange:NSMakeRange(0, 1) withObjects:@[io]], @"invalidated");
 
     RLMAssertThrowsWithReasonMatching([array indexOfObject:[IntObject allObjects].firstObject], @"invalidated");
     RLMAssertThrowsWithReasonMatching([array indexOfObjectWhere:@"intCol = 0"], @"invalidated");
@@ -57,6 +57,37 @@
     [token stop];
 }
 
+- (void)testEvaluateAsyncDeliversResultsOnce {
+    [self createObject:1];
+    [self createObject:2];
+
+    XCTestExpectation *expectation = [self expectationWithDescription:@""];
+    __block int calls = 0;
+    RLMResults *query = [IntObject objectsWhere:@"intCol > 1"];
+    [query evaluateAsyncWithCompletion:^(RLMResults *results, NSError *e) {
+        XCTAssertNil(e);
+        XCTAssertEqual(results, query);
+        XCTAssertEqual(results.count, 1U);
+        ++calls;
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+
+    // Later changes don't call the block again
+    [self waitForNotification:RLMRealmDidChangeNotification realm:RLMRealm.defaultRealm block:^{
+        [self createObject:3];
+    }];
+    XCTAssertEqual(calls, 1);
+
+    RLMNotificationToken *token = [query evaluateAsyncWithCompletion:^(RLMResults *, NSError *) {
+        XCTFail(@"cancelled evaluation should not call the block");
+    }];
+    [token stop];
+    [self waitForNotification:RLMRealmDidChangeNotification realm:RLMRealm.defaultRealm block:^{
+        [self createObject:4];
+    }];
+}
+
 - (void)testNewResultsAreDeliveredAfterLocalCommit {
     __block XCTestExpectation *expectation = [self expectationWithDescription:@""];
     __block NSUInteger expected = 0;
@@ -101,6 +101,31 @@ NSUInteger count = 1000;
     XCTAssertEqualObjects(@"B", [[StringObject allObjectsInRealm:realm].lastObject stringCol]);
 }
 
+- (void)testCompactOnLaunchPolicy {
+    RLMRealmConfiguration *configuration = [RLMRealmConfiguration defaultConfiguration];
+    configuration.fileURL = RLMTestRealmURL();
+
+    // The file is mostly unused, but isn't large enough to be compacted
+    configuration.shouldCompactOnLaunch =
+        [RLMRealmConfiguration shouldCompactOnLaunchBlockWithMinimumFileSize:expectedTotalBytesBefore + 1
+                                                         maximumUsedFraction:0.9];
+    @autoreleasepool {
+        [RLMRealm realmWithConfiguration:configuration error:nil];
+    }
+    XCTAssertEqual([self fileSize:configuration.fileURL], expectedTotalBytesBefore);
+
+    configuration.shouldCompactOnLaunch =
+        [RLMRealmConfiguration shouldCompactOnLaunchBlockWithMinimumFileSize:expectedTotalBytesBefore
+                                                         maximumUsedFraction:0.9];
+    RLMRealm *realm = [RLMRealm realmWithConfiguration:configuration error:nil];
+    XCTAssertLessThan([self fileSize:configuration.fileURL], expectedTotalBytesBefore);
+    XCTAssertEqual([[StringObject allObjectsInRealm:realm] count], count + 2);
+
+    RLMAssertThrowsWithReason([RLMRealmConfiguration shouldCompactOnLaunchBlockWithMinimumFileSize:0
+                                                                               maximumUsedFraction:1.5],
+                              @"between 0 and 1");
+}
+
 - (void)testNoBlockCompactOnLaunch {
     // Configure the Realm to compact on launch
     RLMRealmConfiguration *configuration = [RLMRealmConfiguration defaultConfiguration];
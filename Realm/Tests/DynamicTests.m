@@ -17,6 +17,8 @@
 ////////////////////////////////////////////////////////////////////////////
 
 #import "RLMTestCase.h"
+#import "RLMAccessor.h"
+#import "RLMObjectBase_Dynamic.h"
 #import "RLMRealm_Dynamic.h"
 #import "RLMRealm_Private.h"
 #import "RLMProperty_Private.h"
@@ -141,6 +143,59 @@
     RLMAssertThrowsWithReason(o1[@"invalid"] = nil, @"Invalid property name");
 }
 
+- (void)testDynamicPropertiesByIndex {
+    RLMRealm *realm = [self realmWithTestPath];
+    [realm beginWriteTransaction];
+    PrimaryStringObject *obj = [PrimaryStringObject createInRealm:realm withValue:@[@"a", @1]];
+
+    NSUInteger stringIndex = obj.objectSchema[@"stringCol"].index;
+    NSUInteger intIndex = obj.objectSchema[@"intCol"].index;
+    XCTAssertEqualObjects(RLMDynamicGetByIndex(obj, stringIndex, false), @"a");
+    XCTAssertEqualObjects(RLMDynamicGetByIndex(obj, intIndex, false), @1);
+
+    RLMDynamicValidatedSetByIndex(obj, intIndex, @5);
+    XCTAssertEqual(obj.intCol, 5);
+    RLMAssertThrowsWithReason(RLMDynamicValidatedSetByIndex(obj, intIndex, @"a"), @"Invalid property value");
+    RLMAssertThrowsWithReason(RLMDynamicValidatedSetByIndex(obj, stringIndex, @"b"), @"Primary key can't be changed");
+    RLMAssertThrowsWithReason(RLMDynamicGetByIndex(obj, 2, false), @"Invalid property index");
+    RLMAssertThrowsWithReason(RLMDynamicValidatedSetByIndex(obj, 2, @1), @"Invalid property index");
+    [realm cancelWriteTransaction];
+}
+
+- (void)testPropertyHandles {
+    RLMRealm *realm = [self realmWithTestPath];
+    [realm beginWriteTransaction];
+    PrimaryStringObject *obj = [PrimaryStringObject createInRealm:realm withValue:@[@"a", @1]];
+    [PrimaryStringObject createInRealm:realm withValue:@[@"b", @2]];
+
+    RLMObjectSchema *schema = realm.schema[PrimaryStringObject.className];
+    RLMPropertyHandle stringHandle = [schema handleForProperty:@"stringCol"];
+    RLMPropertyHandle intHandle = [schema handleForProperty:@"intCol"];
+    XCTAssertEqualObjects(RLMObjectBaseGetStringForHandle(obj, stringHandle), @"a");
+    XCTAssertEqual(RLMObjectBaseGetIntForHandle(obj, intHandle), 1);
+    XCTAssertFalse(RLMObjectBaseIsNullForHandle(obj, intHandle));
+
+    RLMObjectBaseSetIntForHandle(obj, intHandle, 5);
+    XCTAssertEqual(obj.intCol, 5);
+    XCTAssertEqualObjects(RLMObjectBaseValueForHandle(obj, intHandle), @5);
+    RLMAssertThrowsWithReason(RLMObjectBaseGetDoubleForHandle(obj, intHandle), @"not 'double'");
+    RLMAssertThrowsWithReason(RLMObjectBaseSetValueForHandle(obj, stringHandle, @"c"), @"Primary key can't be changed");
+    RLMAssertThrowsWithReason([schema handleForProperty:@"invalid"], @"Invalid property name");
+    [realm commitWriteTransaction];
+
+    NSMutableArray *rows = [NSMutableArray array];
+    [[PrimaryStringObject allObjectsInRealm:realm] enumerateValuesForProperties:@[@"intCol", @"stringCol"]
+                                                                     usingBlock:^(NSArray *values, NSUInteger index, BOOL *stop) {
+        [rows addObject:values];
+        XCTAssertEqual(index, rows.count - 1);
+        *stop = YES;
+    }];
+    XCTAssertEqualObjects(rows, (@[@[@5, @"a"]]));
+    RLMAssertThrowsWithReason([[PrimaryStringObject allObjectsInRealm:realm] enumerateValuesForProperties:@[@"invalid"]
+                                                                                               usingBlock:^(NSArray *, NSUInteger, BOOL *) {}],
+                              @"Invalid property name");
+}
+
 - (void)testDynamicTypes {
     NSDate *now = [NSDate dateWithTimeIntervalSince1970:100000];
     id obj1 = @[@YES, @1, @1.1f, @1.11, @"string", [NSData dataWithBytes:"a" length:1],
@@ -19,6 +19,10 @@
 #import "RLMMultiProcessTestCase.h"
 
 #import "RLMConstants.h"
+#import "RLMObjectSchema_Private.h"
+#import "RLMSchema_Private.h"
+
+#import <objc/runtime.h>
 
 @interface InterprocessTest : RLMMultiProcessTestCase
 @end
@@ -394,4 +398,272 @@
     }
 }
 
+#pragma mark - Contention benchmarks
+
+// These report their timings with NSLog rather than asserting on them, as the
+// numbers are only meaningful relative to earlier runs on the same machine.
+
+static void RLMLogBenchmark(NSString *name, double value, NSString *unit) {
+    NSLog(@"Benchmark %@: %.3f %@", name, value, unit);
+}
+
+- (void)testBenchmarkCrossProcessNotificationLatency {
+    const int stopValue = 500;
+
+    RLMRealm *realm = [self inMemoryRealmWithIdentifier:@"benchmark"];
+    [realm beginWriteTransaction];
+    IntObject *obj = [IntObject allObjectsInRealm:realm].firstObject;
+    if (!obj) {
+        obj = [IntObject createInRealm:realm withValue:@[@0]];
+        [realm commitWriteTransaction];
+    }
+    else {
+        [realm cancelWriteTransaction];
+    }
+
+    // Each hop is one process observing the other's commit and then acquiring
+    // the write lock the other just released, so this measures both
+    // notification delivery and write lock hand-off between processes.
+    RLMNotificationToken *token = [realm addNotificationBlock:^(__unused NSString *note, __unused RLMRealm *realm) {
+        if (obj.intCol % 2 == self.isParent && obj.intCol < stopValue) {
+            [realm transactionWithBlock:^{
+                obj.intCol++;
+            }];
+        }
+    }];
+
+    if (self.isParent) {
+        dispatch_queue_t queue = dispatch_queue_create("background", 0);
+        dispatch_async(queue, ^{ RLMRunChildAndWait(); });
+        while (obj.intCol == 0) {
+            [[NSRunLoop currentRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate distantFuture]];
+        }
+        CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+        int startValue = obj.intCol;
+        while (obj.intCol < stopValue) {
+            [[NSRunLoop currentRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate distantFuture]];
+        }
+        CFAbsoluteTime elapsed = CFAbsoluteTimeGetCurrent() - start;
+        dispatch_sync(queue, ^{});
+
+        RLMLogBenchmark(@"cross-process hop latency", elapsed * 1000 / (stopValue - startValue), @"ms");
+    }
+    else {
+        [realm transactionWithBlock:^{
+            obj.intCol++;
+        }];
+        while (obj.intCol < stopValue) {
+            [[NSRunLoop currentRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate distantFuture]];
+        }
+    }
+
+    [token stop];
+}
+
+- (void)testBenchmarkReaderThroughputUnderConcurrentWriter {
+    const NSTimeInterval duration = 1.0;
+    const int readers = 4;
+
+    RLMRealm *realm = RLMRealm.defaultRealm;
+    if (!self.isParent) {
+        // Commit small transactions as fast as possible until the parent
+        // flips the counter negative.
+        IntObject *obj = [IntObject allObjectsInRealm:realm].firstObject;
+        while (true) {
+            @autoreleasepool {
+                [realm beginWriteTransaction];
+                if (obj.intCol < 0) {
+                    [realm cancelWriteTransaction];
+                    break;
+                }
+                obj.intCol++;
+                [DoubleObject createInRealm:realm withValue:@[@(obj.intCol)]];
+                [realm commitWriteTransaction];
+            }
+        }
+        return;
+    }
+
+    NSUInteger (^measureReads)(void) = ^{
+        __block NSUInteger reads = 0;
+        NSObject *lock = [NSObject new];
+        dispatch_group_t group = dispatch_group_create();
+        for (int i = 0; i < readers; ++i) {
+            dispatch_group_async(group, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+                RLMRealm *realm = RLMRealm.defaultRealm;
+                CFAbsoluteTime end = CFAbsoluteTimeGetCurrent() + duration;
+                NSUInteger count = 0;
+                while (CFAbsoluteTimeGetCurrent() < end) {
+                    @autoreleasepool {
+                        [realm refresh];
+                        [[DoubleObject allObjectsInRealm:realm] sumOfProperty:@"doubleCol"];
+                        ++count;
+                    }
+                }
+                @synchronized (lock) {
+                    reads += count;
+                }
+            });
+        }
+        dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+        return reads;
+    };
+
+    [realm beginWriteTransaction];
+    IntObject *obj = [IntObject createInRealm:realm withValue:@[@0]];
+    for (int i = 0; i < 1000; ++i) {
+        [DoubleObject createInRealm:realm withValue:@[@(i)]];
+    }
+    [realm commitWriteTransaction];
+
+    NSUInteger idleReads = measureReads();
+
+    dispatch_queue_t queue = dispatch_queue_create("background", 0);
+    dispatch_async(queue, ^{ RLMRunChildAndWait(); });
+    while (obj.intCol == 0) {
+        [realm refresh];
+    }
+    NSUInteger contendedReads = measureReads();
+
+    [realm transactionWithBlock:^{
+        obj.intCol = -1;
+    }];
+    dispatch_sync(queue, ^{});
+
+    RLMLogBenchmark(@"reader throughput (idle)", idleReads / duration, @"reads/s");
+    RLMLogBenchmark(@"reader throughput (concurrent writer)", contendedReads / duration, @"reads/s");
+    XCTAssertGreaterThan(contendedReads, 0U);
+}
+
+- (void)testBenchmarkWriteLockHandOffBetweenThreads {
+    if (!self.isParent) {
+        return;
+    }
+
+    const int writesPerThread = 200;
+    RLMRealm *realm = RLMRealm.defaultRealm;
+    [realm beginWriteTransaction];
+    IntObject *obj = [IntObject createInRealm:realm withValue:@[@0]];
+    [realm commitWriteTransaction];
+
+    int expected = 0;
+    for (int threads = 1; threads <= 8; threads *= 2) {
+        dispatch_group_t group = dispatch_group_create();
+        CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+        for (int i = 0; i < threads; ++i) {
+            dispatch_group_async(group, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+                RLMRealm *realm = RLMRealm.defaultRealm;
+                IntObject *obj = [IntObject allObjectsInRealm:realm].firstObject;
+                for (int j = 0; j < writesPerThread; ++j) {
+                    @autoreleasepool {
+                        [realm transactionWithBlock:^{
+                            obj.intCol++;
+                        }];
+                    }
+                }
+            });
+        }
+        dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+        CFAbsoluteTime elapsed = CFAbsoluteTimeGetCurrent() - start;
+        expected += threads * writesPerThread;
+
+        RLMLogBenchmark([NSString stringWithFormat:@"write transaction latency (%d threads)", threads],
+                        elapsed * 1000 / (threads * writesPerThread), @"ms");
+    }
+
+    [realm refresh];
+    XCTAssertEqual(expected, obj.intCol);
+}
+
+// Register `count` RLMObject subclasses with ten properties each, so that the
+// cold start benchmark can scale the schema without hundreds of model classes
+// in the test target
+static NSArray<Class> *RLMCreateColdStartModelClasses(NSUInteger count) {
+    NSMutableArray<Class> *classes = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; ++i) {
+        NSString *className = [NSString stringWithFormat:@"ColdStartBenchmarkObject%lu", (unsigned long)i];
+        Class cls = objc_allocateClassPair(RLMObject.class, className.UTF8String, 0);
+        for (int j = 0; j < 10; ++j) {
+            bool isString = j % 2 == 0;
+            NSString *name = [NSString stringWithFormat:@"property%d", j];
+            NSString *ivarName = [@"_" stringByAppendingString:name];
+            if (isString) {
+                class_addIvar(cls, ivarName.UTF8String, sizeof(id), __builtin_ctz(sizeof(id)), "@");
+            }
+            else {
+                class_addIvar(cls, ivarName.UTF8String, sizeof(int), __builtin_ctz(sizeof(int)), "i");
+            }
+            objc_property_attribute_t attributes[] = {
+                {"T", isString ? "@\"NSString\"" : "i"},
+                {"V", ivarName.UTF8String},
+            };
+            class_addProperty(cls, name.UTF8String, attributes, 2);
+        }
+        objc_registerClassPair(cls);
+        [classes addObject:cls];
+    }
+    return classes;
+}
+
+- (void)testBenchmarkColdStart {
+    if (self.isParent) {
+        // The first launch creates the file and the second opens it with the
+        // schema already in place, which are the two cases apps hit
+        for (NSString *launch in @[@"create", @"existing"]) {
+            CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+            RLMRunChildAndWait();
+            RLMLogBenchmark([NSString stringWithFormat:@"cold start process (%@)", launch],
+                            (CFAbsoluteTimeGetCurrent() - start) * 1000, @"ms");
+        }
+        return;
+    }
+
+    const char *classCountString = getenv("REALM_BENCHMARK_CLASS_COUNT");
+    NSUInteger classCount = classCountString ? strtoul(classCountString, NULL, 10) : 100;
+    NSString *launch = [NSFileManager.defaultManager fileExistsAtPath:RLMDefaultRealmURL().path] ? @"existing" : @"create";
+
+    NSMutableDictionary<NSString *, NSNumber *> *phases = [NSMutableDictionary dictionary];
+    __block CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    void (^endPhase)(NSString *) = ^(NSString *phase) {
+        CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+        phases[phase] = @((now - start) * 1000);
+        RLMLogBenchmark([NSString stringWithFormat:@"cold start %@ (%@, %lu classes)", phase, launch, (unsigned long)classCount],
+                        (now - start) * 1000, @"ms");
+        start = now;
+    };
+
+    NSArray<Class> *classes = RLMCreateColdStartModelClasses(classCount);
+    endPhase(@"class registration");
+
+    // Enumerates every class in the process and reflects over the models
+    [RLMSchema sharedSchema];
+    endPhase(@"shared schema");
+
+    for (Class cls in classes) {
+        [RLMObjectSchema schemaForObjectClass:cls];
+    }
+    endPhase(@"reflection");
+
+    RLMRealmConfiguration *config = [RLMRealmConfiguration defaultConfiguration];
+    config.objectClasses = classes;
+    RLMRealm *realm = [RLMRealm realmWithConfiguration:config error:nil];
+    endPhase(@"open and schema diff");
+
+    for (RLMObjectSchema *objectSchema in realm.schema.objectSchema) {
+        (void)objectSchema.accessorClass;
+    }
+    endPhase(@"accessor classes");
+
+    const char *outputPath = getenv("REALM_COLD_START_BENCHMARK_OUTPUT");
+    if (outputPath) {
+        NSData *existing = [NSData dataWithContentsOfFile:@(outputPath)];
+        NSMutableDictionary *results = existing ? [[NSJSONSerialization JSONObjectWithData:existing options:NSJSONReadingMutableContainers error:nil] mutableCopy] : nil;
+        results = results ?: [NSMutableDictionary dictionary];
+        results[@"classes"] = @(classCount);
+        results[launch] = phases;
+        [[NSJSONSerialization dataWithJSONObject:results options:NSJSONWritingPrettyPrinted error:nil]
+         writeToFile:@(outputPath) atomically:YES];
+    }
+}
+
 @end
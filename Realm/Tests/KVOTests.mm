@@ -991,6 +991,27 @@ public:
     }
 }
 
+- (void)testArrayDiffsAfterObserverIsReadded {
+    KVOLinkObject2 *obj = [self createLinkObject];
+    id mutator = [obj mutableArrayValueForKey:@"array"];
+
+    {
+        KVORecorder r(self, obj, @"array");
+        [mutator addObject:obj.obj];
+        AssertIndexChange(NSKeyValueChangeInsertion, [NSIndexSet indexSetWithIndex:0]);
+    }
+
+    // not observed at all at this point
+    [mutator addObject:obj.obj];
+    [mutator removeObjectAtIndex:0];
+
+    {
+        KVORecorder r(self, obj, @"array");
+        [mutator insertObject:obj.obj atIndex:1];
+        AssertIndexChange(NSKeyValueChangeInsertion, [NSIndexSet indexSetWithIndex:1]);
+    }
+}
+
 - (void)testIgnoredProperty {
     KVOObject *obj = [self createObject];
     KVORecorder r(self, obj, @"ignored");
@@ -1158,6 +1179,29 @@ public:
     return [KVOLinkObject2 createInRealm:_realm withValue:@[@(++pk), @[@(++pk), [self createObject], @[]], @[]]];
 }
 
+- (void)testBulkWriteTransaction {
+    KVOObject *obj = [self createObject];
+    KVORecorder r(self, obj, @"boolCol");
+    [self.realm commitWriteTransaction];
+
+    [self.realm beginBulkWriteTransaction];
+    obj.boolCol = YES;
+    obj.int16Col = 5;
+    XCTAssertTrue(r.empty());
+    [self.realm commitWriteTransaction];
+    [self.realm beginWriteTransaction];
+
+    // A single notification with the new value once the write is committed
+    if (NSDictionary *note = AssertNotification(r)) {
+        XCTAssertEqualObjects(@YES, note[NSKeyValueChangeNewKey]);
+    }
+    XCTAssertTrue(r.empty());
+
+    // Later write transactions notify as usual
+    obj.boolCol = NO;
+    AssertChanged(r, @YES, @NO);
+}
+
 - (void)testDeleteObservedObject {
     KVOObject *obj = [self createObject];
     KVORecorder r1(self, obj, @"boolCol");
@@ -1238,6 +1282,29 @@ public:
     }
 }
 
+- (void)testObserveObjectsWhoseRowsWereMoved {
+    KVOObject *first = [self createObject];
+    KVOObject *second = [self createObject];
+    KVOObject *last = [self createObject];
+    KVORecorder r1(self, last, @"int32Col");
+    KVORecorder r2(self, second, @"int32Col");
+
+    // Deleting the first object moves the last one into its row
+    [self.realm deleteObject:first];
+    last.int32Col = 10;
+    AssertChanged(r1, @2, @10);
+
+    // and a new object is then created in the row the last one was in
+    KVOObject *created = [self createObject];
+    KVORecorder r3(self, created, @"int32Col");
+    created.int32Col = 5;
+    AssertChanged(r3, @2, @5);
+    last.int32Col = 11;
+    AssertChanged(r1, @10, @11);
+    second.int32Col = 7;
+    AssertChanged(r2, @2, @7);
+}
+
 - (void)testDirectlyDeleteLinkedToObject {
     KVOLinkObject2 *obj = [self createLinkObject];
     KVOLinkObject1 *linked = obj.obj;
@@ -1325,6 +1392,42 @@ public:
     AssertIndexChange(NSKeyValueChangeRemoval, ([NSIndexSet indexSetWithIndexesInRange:{0, 3}]));
 }
 
+- (void)testDeleteObjectsInArrayViaNSArray {
+    KVOLinkObject2 *obj = [self createLinkObject];
+    KVOLinkObject2 *obj2 = [self createLinkObject];
+    [obj.array addObject:obj.obj];
+    [obj.array addObject:obj.obj];
+    [obj.array addObject:obj2.obj];
+
+    KVORecorder r(self, obj, @"array");
+    KVORecorder r2(self, obj2, RLMInvalidatedKey);
+    [self.realm deleteObjects:@[obj2.obj, obj.obj, obj2, obj.obj]];
+    AssertIndexChange(NSKeyValueChangeRemoval, ([NSIndexSet indexSetWithIndexesInRange:{0, 3}]));
+    AssertChanged(r2, @NO, @YES);
+}
+
+- (void)testDeleteObjectsInArraysOfSeveralObservedObjects {
+    KVOLinkObject2 *obj = [self createLinkObject];
+    KVOLinkObject2 *obj2 = [self createLinkObject];
+    KVOLinkObject2 *obj3 = [self createLinkObject];
+    [obj.array addObjects:@[obj.obj, obj2.obj, obj.obj, obj3.obj]];
+    [obj2.array addObjects:@[obj3.obj, obj2.obj]];
+    [obj3.array addObject:obj3.obj];
+
+    KVORecorder r(self, obj, @"array");
+    KVORecorder r2(self, obj2, @"array");
+    KVORecorder r3(self, obj3, @"array");
+    [self.realm deleteObjects:[KVOLinkObject1 objectsInRealm:self.realm where:@"pk != %d", obj3.obj.pk]];
+
+    AssertIndexChange(NSKeyValueChangeRemoval, ([NSIndexSet indexSetWithIndexesInRange:{0, 3}]));
+    if (NSDictionary *note = AssertNotification(r2)) {
+        XCTAssertEqual([note[NSKeyValueChangeKindKey] intValue], NSKeyValueChangeRemoval);
+        XCTAssertEqualObjects(note[NSKeyValueChangeIndexesKey], [NSIndexSet indexSetWithIndex:1]);
+    }
+    XCTAssertTrue(r2.empty());
+    XCTAssertTrue(r3.empty());
+}
+
 - (void)testObserveInvalidArrayProperty {
     KVOObject *obj = [self createObject];
     RLMArray *array = obj.arrayCol;
@@ -1392,6 +1495,41 @@ public:
     AssertChanged(r, @NO, @YES);
 }
 
+- (void)testCreateOrUpdateModifiedOnlyNotifiesChangedProperties {
+    KVOObject *obj = [self createObject];
+    KVOObject *obj2 = [[KVOObject alloc] initWithValue:obj];
+
+    KVORecorder r(self, obj, @"boolCol");
+    KVORecorder r2(self, obj, @"stringCol");
+    KVORecorder r3(self, obj, @"objectCol");
+    KVORecorder r4(self, obj, @"arrayCol");
+    obj2.boolCol = true;
+    [KVOObject createOrUpdateModifiedInRealm:self.realm withValue:obj2];
+    AssertChanged(r, @NO, @YES);
+    XCTAssertTrue(r2.empty());
+    XCTAssertTrue(r3.empty());
+    XCTAssertTrue(r4.empty());
+}
+
+- (void)testSetValueForKeyOnResultsNotifiesObjectsInResults {
+    KVOObject *obj = [self createObject];
+    KVOObject *obj2 = [self createObject];
+    KVOObject *obj3 = [self createObject];
+
+    KVORecorder r(self, obj, @"int32Col");
+    KVORecorder r2(self, obj2, @"int32Col");
+    KVORecorder r3(self, obj3, @"stringCol");
+    [[KVOObject objectsInRealm:self.realm where:@"pk != %d", obj2.pk] setValue:@10 forKey:@"int32Col"];
+    AssertChanged(r, @2, @10);
+    XCTAssertTrue(r2.empty());
+    XCTAssertTrue(r3.empty());
+
+    [[KVOObject objectsInRealm:self.realm where:@"pk != %d", obj2.pk] setValue:@"a" forKey:@"stringCol"];
+    AssertChanged(r3, @"", @"a");
+    XCTAssertEqualObjects(obj.stringCol, @"a");
+    XCTAssertEqualObjects(obj2.stringCol, @"");
+}
+
 // The following tests aren't really multiple-accessor-specific, but they're
 // conceptually similar and don't make sense in the multiple realm instances case
 - (void)testCancelWriteTransactionWhileObservingNewObject {
@@ -1626,6 +1764,31 @@ public:
     return true;
 }
 
+- (void)testObserversChangedBetweenRefreshes {
+    KVOObject *obj0 = [self createObject];
+    KVOObject *obj1 = [self createObject];
+    KVOObject *obj2 = [self createObject];
+    KVORecorder r1(self, obj1, @"int32Col");
+    {
+        KVORecorder r2(self, obj2, @"int32Col");
+        obj2.int32Col = 10;
+        AssertChanged(r2, @2, @10);
+    }
+    // obj2 is no longer observed, so only obj1's change is reported
+    obj2.int32Col = 11;
+    obj1.int32Col = 12;
+    AssertChanged(r1, @2, @12);
+    XCTAssertTrue(r1.empty());
+
+    // Deleting obj0 moves obj2 into its row
+    [self.realm deleteObject:obj0];
+    KVORecorder r2(self, obj2, @"int32Col");
+    obj2.int32Col = 13;
+    AssertChanged(r2, @11, @13);
+    obj1.int32Col = 14;
+    AssertChanged(r1, @12, @14);
+}
+
 - (void)testIgnoredProperty {
     // ignored properties do not notify other accessors for the same row
 }
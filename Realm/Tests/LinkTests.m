@@ -189,6 +189,55 @@
     XCTAssertNil(weakObj1);
 }
 
+- (void)testLinkAccessorIsReusedUntilLinkChanges {
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm beginWriteTransaction];
+    OwnerObject *owner = [OwnerObject createInRealm:realm withValue:@[@"Tim", @[@"Harvie", @1]]];
+    DogObject *otherDog = [DogObject createInRealm:realm withValue:@[@"Fido", @2]];
+    [realm commitWriteTransaction];
+
+    DogObject *dog = owner.dog;
+    XCTAssertEqual(dog, owner.dog);
+    XCTAssertEqualObjects(@"Harvie", owner.dog.dogName);
+
+    [realm beginWriteTransaction];
+    owner.dog = otherDog;
+    [realm commitWriteTransaction];
+    XCTAssertNotEqual(dog, owner.dog);
+    XCTAssertEqualObjects(@"Fido", owner.dog.dogName);
+
+    // a change made on another thread is picked up when the Realm advances
+    [self dispatchAsyncAndWait:^{
+        RLMRealm *realm = [RLMRealm defaultRealm];
+        OwnerObject *owner = [[OwnerObject allObjectsInRealm:realm] firstObject];
+        [realm beginWriteTransaction];
+        owner.dog = [[DogObject objectsInRealm:realm where:@"dogName = 'Harvie'"] firstObject];
+        [realm commitWriteTransaction];
+    }];
+    [realm refresh];
+    XCTAssertEqualObjects(@"Harvie", owner.dog.dogName);
+
+    [realm beginWriteTransaction];
+    [realm deleteObject:owner.dog];
+    [realm commitWriteTransaction];
+    XCTAssertNil(owner.dog);
+}
+
+- (void)testCachedLinkAccessorsDoNotLeak {
+    CircleObject __weak *weakNext;
+    @autoreleasepool {
+        RLMRealm *realm = [RLMRealm defaultRealm];
+        [realm beginWriteTransaction];
+        CircleObject *obj = [CircleObject createInRealm:realm withValue:@[@"a", NSNull.null]];
+        obj.next = obj;
+        [realm commitWriteTransaction];
+
+        weakNext = obj.next.next.next;
+        XCTAssertNotNil(weakNext);
+    }
+    XCTAssertNil(weakNext);
+}
+
 - (void)testCircularLinks {
     RLMRealm *realm = [self realmWithTestPath];
 
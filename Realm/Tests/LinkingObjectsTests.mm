@@ -53,6 +53,38 @@
     XCTAssertEqualObjects(asArray(hannahsParents), (@[ ]));
 }
 
+- (void)testLinkingObjectsCount {
+    RLMRealm *realm = [self realmWithTestPath];
+    [realm beginWriteTransaction];
+
+    PersonObject *hannah = [PersonObject createInRealm:realm withValue:@[ @"Hannah", @0 ]];
+    PersonObject *mark   = [PersonObject createInRealm:realm withValue:@[ @"Mark",  @30, @[ hannah ]]];
+    XCTAssertEqual(1U, [hannah linkingObjectsCountForProperty:@"parents"]);
+    XCTAssertEqual(0U, [mark linkingObjectsCountForProperty:@"parents"]);
+
+    [PersonObject createInRealm:realm withValue:@[ @"Diane", @29, @[ hannah, hannah ]]];
+    XCTAssertEqual(hannah.parents.count, [hannah linkingObjectsCountForProperty:@"parents"]);
+    XCTAssertEqual(3U, [hannah linkingObjectsCountForProperty:@"parents"]);
+
+    XCTAssertEqual(1U, [PersonObject objectsInRealm:realm where:@"parents.@count > 1"].count);
+    XCTAssertEqual(2U, [PersonObject objectsInRealm:realm where:@"parents.@count == 0"].count);
+
+    [mark.children removeAllObjects];
+    XCTAssertEqual(2U, [hannah linkingObjectsCountForProperty:@"parents"]);
+    [realm commitWriteTransaction];
+
+    RLMAssertThrowsWithReasonMatching([hannah linkingObjectsCountForProperty:@"children"], @"not 'linking objects'");
+    RLMAssertThrowsWithReasonMatching([hannah linkingObjectsCountForProperty:@"invalid"], @"Invalid property name");
+
+    [realm beginWriteTransaction];
+    [realm deleteObject:hannah];
+    [realm commitWriteTransaction];
+    RLMAssertThrowsWithReasonMatching([hannah linkingObjectsCountForProperty:@"parents"], @"invalidated");
+
+    PersonObject *don = [[PersonObject alloc] initWithValue:@[ @"Don", @60, @[] ]];
+    XCTAssertEqual(0U, [don linkingObjectsCountForProperty:@"parents"]);
+}
+
 - (void)testLinkingObjectsOnUnmanagedObject {
     PersonObject *don = [[PersonObject alloc] initWithValue:@[ @"Don", @60, @[] ]];
 
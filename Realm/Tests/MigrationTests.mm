@@ -314,6 +314,32 @@ RLM_ARRAY_TYPE(MigrationObject);
     XCTAssertEqual(1U, [RLMRealm schemaVersionAtURL:config.fileURL encryptionKey:nil error:nil]);
 }
 
+- (void)testGetSchemaVersionDoesNotOpenRealm {
+    RLMRealmConfiguration *config = [RLMRealmConfiguration defaultConfiguration];
+    config.encryptionKey = RLMGenerateKey();
+    config.schemaVersion = 3;
+    @autoreleasepool { [RLMRealm realmWithConfiguration:config error:nil]; }
+
+    // The lock file is left behind and is only locked, while opening the
+    // Realm would create the other files it uses
+    NSString *notePath = [config.fileURL.path stringByAppendingString:@".note"];
+    [NSFileManager.defaultManager removeItemAtPath:notePath error:nil];
+    XCTAssertEqual(3U, [RLMRealm schemaVersionAtURL:config.fileURL encryptionKey:config.encryptionKey error:nil]);
+    XCTAssertFalse([NSFileManager.defaultManager fileExistsAtPath:notePath]);
+
+    // Without a lock file it can't be checked that no other process is
+    // writing to the file, so it's opened normally
+    NSString *lockPath = [config.fileURL.path stringByAppendingString:@".lock"];
+    [NSFileManager.defaultManager removeItemAtPath:lockPath error:nil];
+    XCTAssertEqual(3U, [RLMRealm schemaVersionAtURL:config.fileURL encryptionKey:config.encryptionKey error:nil]);
+    XCTAssertTrue([NSFileManager.defaultManager fileExistsAtPath:lockPath]);
+
+    // the wrong key is reported by opening the file normally
+    NSError *error;
+    XCTAssertEqual(RLMNotVersioned, [RLMRealm schemaVersionAtURL:config.fileURL encryptionKey:RLMGenerateKey() error:&error]);
+    XCTAssertNotNil(error);
+}
+
 - (void)testSchemaVersionCannotGoDown {
     RLMRealmConfiguration *config = [RLMRealmConfiguration defaultConfiguration];
     config.schemaVersion = 10;
@@ -634,6 +660,44 @@ RLM_ARRAY_TYPE(MigrationObject);
     @autoreleasepool { XCTAssertTrue([RLMRealm performMigrationForConfiguration:config error:nil]); }
 }
 
+- (void)testReopeningWithUnchangedSchemaUsesStoredSchema {
+    RLMRealmConfiguration *config = self.config;
+    config.customSchema = [self schemaWithObjects:@[[RLMObjectSchema schemaForObjectClass:MigrationObject.class]]];
+    config.schemaVersion = 1;
+    @autoreleasepool {
+        RLMRealm *realm = [RLMRealm realmWithConfiguration:config error:nil];
+        [realm transactionWithBlock:^{
+            [MigrationObject createInRealm:realm withValue:@[@1, @"1"]];
+        }];
+    }
+
+    config.migrationBlock = ^(__unused RLMMigration *migration, __unused uint64_t oldSchemaVersion) {
+        XCTFail(@"Migration block should not have been called");
+    };
+    uint64_t matches = RLMSchemaFingerprintMatchCount();
+    for (int i = 0; i < 3; ++i) @autoreleasepool {
+        RLMRealm *realm = [RLMRealm realmWithConfiguration:config error:nil];
+        RLMAssertRealmSchemaMatchesTable(self, realm);
+        XCTAssertEqual(1U, [MigrationObject allObjectsInRealm:realm].count);
+        XCTAssertEqualObjects(@"1", [[MigrationObject allObjectsInRealm:realm].firstObject stringCol]);
+    }
+    // each reopening used the stored schema rather than updating it
+    XCTAssertEqual(matches + 3, RLMSchemaFingerprintMatchCount());
+    // the fingerprint is kept next to the file rather than in it
+    XCTAssertTrue([NSFileManager.defaultManager fileExistsAtPath:[config.fileURL.path stringByAppendingString:@".schema"]]);
+    @autoreleasepool {
+        RLMRealm *realm = [RLMRealm realmWithConfiguration:config error:nil];
+        XCTAssertFalse(realm.group.has_table("schema_fingerprint"));
+    }
+
+    // a different schema at the same version still requires a migration
+    RLMObjectSchema *objectSchema = [RLMObjectSchema schemaForObjectClass:MigrationObject.class];
+    objectSchema.properties = @[objectSchema.properties[0]];
+    config.customSchema = [self schemaWithObjects:@[objectSchema]];
+    RLMAssertThrowsWithCodeMatching([RLMRealm realmWithConfiguration:config error:nil], RLMErrorSchemaMismatch);
+    XCTAssertEqual(matches + 3, RLMSchemaFingerprintMatchCount());
+}
+
 - (void)testMigrationBlockCalledWhenSchemaVersionHasChanged {
     RLMRealmConfiguration *config = [RLMRealmConfiguration new];
     config.schemaVersion = 1;
@@ -662,20 +726,21 @@ RLM_ARRAY_TYPE(MigrationObject);
     XCTAssertNil(RLMGetAnyCachedRealmForPath(c.pathOnDisk.UTF8String));
     XCTestExpectation *ex = [self expectationWithDescription:@"async-migration"];
     __block bool migrationCalled = false;
+    __block bool migrationCalledOnMainThread = false;
     c.schemaVersion = 2;
     c.migrationBlock = ^(__unused RLMMigration *migration, __unused uint64_t oldSchemaVersion) {
         migrationCalled = true;
+        migrationCalledOnMainThread = [NSThread isMainThread];
     };
     [RLMRealm asyncOpenWithConfiguration:c
                            callbackQueue:dispatch_get_main_queue()
                                  callback:^(RLMRealm * _Nullable realm, NSError * _Nullable error) {
         XCTAssertTrue(migrationCalled);
+        XCTAssertFalse(migrationCalledOnMainThread);
         XCTAssertNil(error);
         XCTAssertNotNil(realm);
         [ex fulfill];
     }];
-    XCTAssertFalse(migrationCalled);
-    XCTAssertNil(RLMGetAnyCachedRealmForPath(c.pathOnDisk.UTF8String));
     [self waitForExpectationsWithTimeout:1 handler:nil];
     XCTAssertTrue(migrationCalled);
     XCTAssertNil(RLMGetAnyCachedRealmForPath(c.pathOnDisk.UTF8String));
@@ -1068,6 +1133,170 @@ RLM_ARRAY_TYPE(MigrationObject);
     }];
 }
 
+- (void)testDeleteObjectsOutOfOrder {
+    [self createTestRealmWithClasses:@[IntObject.class] block:^(RLMRealm *realm) {
+        for (int i = 0; i < 100; ++i) {
+            [IntObject createInRealm:realm withValue:@[@(i)]];
+        }
+    }];
+
+    RLMRealm *realm = [self migrateTestRealmWithBlock:^(RLMMigration *migration, uint64_t) {
+        NSMutableArray *toDelete = [NSMutableArray new];
+        [migration enumerateObjects:IntObject.className block:^(__unused RLMObject *oldObject, RLMObject *newObject) {
+            if ([newObject[@"intCol"] intValue] % 3 == 0) {
+                [toDelete addObject:newObject];
+            }
+        }];
+
+        // delete in the opposite order from enumeration
+        for (RLMObject *object in toDelete.reverseObjectEnumerator) {
+            [migration deleteObject:object];
+        }
+
+        __block NSInteger count = 0;
+        [migration enumerateObjects:IntObject.className block:^(RLMObject *oldObject, RLMObject *newObject) {
+            XCTAssertNotEqual([oldObject[@"intCol"] intValue] % 3, 0);
+            XCTAssertEqualObjects(oldObject[@"intCol"], newObject[@"intCol"]);
+            count++;
+        }];
+        XCTAssertEqual(count, 66);
+    }];
+
+    RLMResults *remaining = [IntObject allObjectsInRealm:realm];
+    XCTAssertEqual(remaining.count, 66U);
+    for (IntObject *object in remaining) {
+        XCTAssertNotEqual(object.intCol % 3, 0);
+    }
+}
+
+- (void)testCopyAndTransformPropertyValues {
+    RLMObjectSchema *stringSchema = [RLMObjectSchema schemaForObjectClass:StringObject.class];
+    RLMObjectSchema *intSchema = [RLMObjectSchema schemaForObjectClass:IntObject.class];
+    NSArray *stringProperties = stringSchema.properties, *intProperties = intSchema.properties;
+    stringSchema.properties = @[[stringProperties[0] copyWithNewName:@"oldStringCol"]];
+    intSchema.properties = @[[intProperties[0] copyWithNewName:@"oldIntCol"]];
+
+    [self createTestRealmWithSchema:@[stringSchema, intSchema] block:^(RLMRealm *realm) {
+        for (int i = 0; i < 5; ++i) {
+            [realm createObject:StringObject.className withValue:@[@(i).stringValue]];
+            [realm createObject:IntObject.className withValue:@[@(i)]];
+        }
+    }];
+
+    RLMRealm *realm = [self migrateTestRealmWithBlock:^(RLMMigration *migration, uint64_t) {
+        [migration enumerateObjects:StringObject.className block:^(RLMObject *oldObject, RLMObject *newObject) {
+            if ([oldObject[@"oldStringCol"] isEqualToString:@"2"]) {
+                [migration deleteObject:newObject];
+            }
+        }];
+        [migration copyValuesFromOldProperty:@"oldStringCol" toProperty:@"stringCol" inClass:StringObject.className];
+        [migration transformProperty:@"intCol" inClass:IntObject.className fromOldProperty:@"oldIntCol"
+                          usingBlock:^(NSNumber *value) { return @(value.intValue * 2); }];
+
+        RLMAssertThrowsWithReasonMatching([migration copyValuesFromOldProperty:@"stringCol" toProperty:@"stringCol"
+                                                                       inClass:StringObject.className],
+                                          @"Invalid property name 'stringCol' for class 'StringObject' in the old schema");
+        RLMAssertThrowsWithReasonMatching([migration copyValuesFromOldProperty:@"oldStringCol" toProperty:@"intCol"
+                                                                       inClass:StringObject.className],
+                                          @"Invalid property name 'intCol'");
+        XCTAssertThrows([migration copyValuesFromOldProperty:@"oldIntCol" toProperty:@"intCol" inClass:@"NoSuchClass"]);
+    }];
+
+    XCTAssertEqualObjects([[StringObject allObjectsInRealm:realm] valueForKey:@"stringCol"], (@[@"0", @"1", @"4", @"3"]));
+    XCTAssertEqualObjects([[IntObject allObjectsInRealm:realm] valueForKey:@"intCol"], (@[@0, @2, @4, @6, @8]));
+    stringSchema.properties = stringProperties;
+    intSchema.properties = intProperties;
+}
+
+- (void)testCopyValuesIntoVectorPropertyValidatesDimension {
+    // VectorObject's embedding holds 3 floats, but the old property was plain data
+    RLMObjectSchema *vectorSchema = [[RLMSchema.sharedSchema schemaForClassName:@"VectorObject"] copy];
+    RLMProperty *oldEmbedding = [vectorSchema[@"embedding"] copyWithNewName:@"oldEmbedding"];
+    oldEmbedding.vectorDimension = 0;
+    vectorSchema.properties = @[vectorSchema[@"name"], oldEmbedding];
+
+    float valid[] = {1, 2, 3};
+    [self createTestRealmWithSchema:@[vectorSchema] block:^(RLMRealm *realm) {
+        [realm createObject:@"VectorObject" withValue:@[@"valid", [NSData dataWithBytes:valid length:sizeof(valid)]]];
+        [realm createObject:@"VectorObject" withValue:@[@"short", [NSData dataWithBytes:"ab" length:2]]];
+    }];
+
+    RLMRealm *realm = [self migrateTestRealmWithBlock:^(RLMMigration *migration, uint64_t) {
+        RLMAssertThrowsWithReasonMatching([migration copyValuesFromOldProperty:@"oldEmbedding" toProperty:@"embedding"
+                                                                       inClass:@"VectorObject"],
+                                          @"Invalid property value .* for property 'embedding'");
+        [migration enumerateObjects:@"VectorObject" block:^(RLMObject *oldObject, RLMObject *newObject) {
+            if ([oldObject[@"name"] isEqualToString:@"short"]) {
+                [migration deleteObject:newObject];
+            }
+        }];
+        [migration copyValuesFromOldProperty:@"oldEmbedding" toProperty:@"embedding" inClass:@"VectorObject"];
+    }];
+
+    RLMResults *objects = [realm allObjects:@"VectorObject"];
+    XCTAssertEqual(1U, objects.count);
+    XCTAssertEqualObjects([NSData dataWithBytes:valid length:sizeof(valid)], objects.firstObject[@"embedding"]);
+}
+
+- (void)testCopyValuesIntoPrimaryKeyChecksUniqueness {
+    RLMObjectSchema *objectSchema = [RLMObjectSchema schemaForObjectClass:MigrationPrimaryKeyObject.class];
+    objectSchema.primaryKeyProperty = nil;
+    objectSchema.properties = @[[objectSchema.properties[0] copyWithNewName:@"oldIntCol"]];
+    [self createTestRealmWithSchema:@[objectSchema] block:^(RLMRealm *realm) {
+        [realm createObject:MigrationPrimaryKeyObject.className withValue:@[@1]];
+        [realm createObject:MigrationPrimaryKeyObject.className withValue:@[@1]];
+        [realm createObject:MigrationPrimaryKeyObject.className withValue:@[@2]];
+    }];
+
+    RLMRealm *realm = [self migrateTestRealmWithBlock:^(RLMMigration *migration, uint64_t) {
+        RLMAssertThrowsWithReason([migration copyValuesFromOldProperty:@"oldIntCol" toProperty:@"intCol"
+                                                               inClass:MigrationPrimaryKeyObject.className],
+                                  @"Primary key property 'MigrationPrimaryKeyObject.intCol' cannot be set to the duplicate value '1'.");
+        RLMAssertThrowsWithReason([migration transformProperty:@"intCol" inClass:MigrationPrimaryKeyObject.className
+                                               fromOldProperty:@"oldIntCol" usingBlock:^(NSNumber *) { return @0; }],
+                                  @"duplicate value '0'");
+
+        __block bool seenOne = false;
+        [migration enumerateObjects:MigrationPrimaryKeyObject.className block:^(RLMObject *oldObject, RLMObject *newObject) {
+            if ([oldObject[@"oldIntCol"] isEqual:@1]) {
+                if (seenOne) {
+                    [migration deleteObject:newObject];
+                }
+                seenOne = true;
+            }
+        }];
+        [migration copyValuesFromOldProperty:@"oldIntCol" toProperty:@"intCol" inClass:MigrationPrimaryKeyObject.className];
+    }];
+
+    XCTAssertEqualObjects([[MigrationPrimaryKeyObject allObjectsInRealm:realm] valueForKey:@"intCol"], (@[@1, @2]));
+}
+
+- (void)testMigrationProgressBlock {
+    [self createTestRealmWithClasses:@[IntObject.class] block:^(RLMRealm *realm) {
+        for (int i = 0; i < 2500; ++i) {
+            [IntObject createInRealm:realm withValue:@[@(i)]];
+        }
+    }];
+
+    NSMutableArray *reported = [NSMutableArray new];
+    RLMRealmConfiguration *config = self.config;
+    config.schemaVersion = 1;
+    config.migrationProgressBlock = ^(NSString *className, NSUInteger processed, NSUInteger total) {
+        XCTAssertEqualObjects(className, IntObject.className);
+        [reported addObject:@[@(processed), @(total)]];
+    };
+    config.migrationBlock = ^(RLMMigration *migration, uint64_t) {
+        [migration enumerateObjects:IntObject.className block:^(__unused RLMObject *oldObject, __unused RLMObject *newObject) {}];
+        XCTAssertEqualObjects(reported, (@[@[@1000, @2500], @[@2000, @2500], @[@2500, @2500]]));
+
+        [reported removeAllObjects];
+        [migration copyValuesFromOldProperty:@"intCol" toProperty:@"intCol" inClass:IntObject.className];
+        XCTAssertEqualObjects(reported, (@[@[@1000, @2500], @[@2000, @2500], @[@2500, @2500]]));
+    };
+    XCTAssertTrue([RLMRealm performMigrationForConfiguration:config error:nil]);
+    XCTAssertEqual(reported.count, 3U);
+}
+
 - (void)testEnumerateObjectsAfterDeleteInsertObjects {
     [self createTestRealmWithClasses:@[StringObject.class, IntObject.class, BoolObject.class] block:^(RLMRealm *realm) {
         [StringObject createInRealm:realm withValue:@[@"1"]];
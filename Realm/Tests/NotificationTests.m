@@ -20,6 +20,11 @@
 
 #import "RLMRealmConfiguration_Private.h"
 
+static NSIndexPath *indexPath(NSUInteger section, NSUInteger index) {
+    NSUInteger path[2] = {section, index};
+    return [NSIndexPath indexPathWithIndexes:path length:2];
+}
+
 @interface NotificationTests : RLMTestCase
 @property (nonatomic, strong) RLMNotificationToken *token;
 @property (nonatomic) bool called;
@@ -79,6 +84,30 @@
     }];
 }
 
+- (void)testSuspendCollectionNotifications {
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm suspendCollectionNotifications];
+    [self expectNoNotification:^(RLMRealm *realm) {
+        [IntObject createInRealm:realm withValue:@[@3]];
+    }];
+    [self expectNoNotification:^(RLMRealm *realm) {
+        [IntObject createInRealm:realm withValue:@[@2]];
+    }];
+    [realm resumeCollectionNotifications];
+    CFRunLoopRun();
+    XCTAssertTrue(_called);
+
+    realm.suspendsCollectionNotificationsInBackground = YES;
+    [NSNotificationCenter.defaultCenter postNotificationName:@"UIApplicationDidEnterBackgroundNotification" object:nil];
+    [self expectNoNotification:^(RLMRealm *realm) {
+        [IntObject createInRealm:realm withValue:@[@1]];
+    }];
+    [NSNotificationCenter.defaultCenter postNotificationName:@"UIApplicationWillEnterForegroundNotification" object:nil];
+    CFRunLoopRun();
+    XCTAssertTrue(_called);
+    realm.suspendsCollectionNotificationsInBackground = NO;
+}
+
 - (void)testInsertObjectNotMatchingQuery {
     [self expectNoNotification:^(RLMRealm *realm) {
         [IntObject createInRealm:realm withValue:@[@10]];
@@ -194,6 +223,607 @@
     [realm cancelWriteTransaction];
     [otherRealm cancelWriteTransaction];
 }
+
+- (void)testNotificationBlockWithKeyPaths {
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm transactionWithBlock:^{
+        [EmployeeObject createInRealm:realm withValue:@{@"name": @"A", @"age": @20, @"hired": @NO}];
+        [EmployeeObject createInRealm:realm withValue:@{@"name": @"B", @"age": @30, @"hired": @NO}];
+    }];
+
+    __block int calls = 0;
+    __block RLMCollectionChange *changes;
+    RLMResults *employees = [EmployeeObject allObjectsInRealm:realm];
+    RLMNotificationToken *token = [employees addNotificationBlock:^(RLMResults *results, RLMCollectionChange *c, NSError *error) {
+        XCTAssertNotNil(results);
+        XCTAssertNil(error);
+        changes = c;
+        ++calls;
+        CFRunLoopStop(CFRunLoopGetCurrent());
+    } keyPaths:@[@"age"]];
+    CFRunLoopRun();
+    XCTAssertEqual(calls, 1);
+
+    // Changing only properties which aren't observed doesn't call the block
+    [self waitForNotification:RLMRealmDidChangeNotification realm:realm block:^{
+        RLMRealm *realm = [RLMRealm defaultRealm];
+        [realm transactionWithBlock:^{
+            [[EmployeeObject allObjectsInRealm:realm][0] setName:@"C"];
+            [[EmployeeObject allObjectsInRealm:realm][1] setHired:YES];
+        }];
+    }];
+    XCTAssertEqual(calls, 1);
+
+    // Setting an observed property to the value it already had isn't reported
+    [self waitForNotification:RLMRealmDidChangeNotification realm:realm block:^{
+        RLMRealm *realm = [RLMRealm defaultRealm];
+        [realm transactionWithBlock:^{
+            [[EmployeeObject allObjectsInRealm:realm][0] setName:@"D"];
+            [[EmployeeObject allObjectsInRealm:realm][0] setAge:20];
+            [[EmployeeObject allObjectsInRealm:realm][1] setAge:31];
+        }];
+    }];
+    XCTAssertEqual(calls, 2);
+    XCTAssertEqualObjects(changes.modifications, @[@1]);
+
+    [self waitForNotification:RLMRealmDidChangeNotification realm:realm block:^{
+        RLMRealm *realm = [RLMRealm defaultRealm];
+        [realm transactionWithBlock:^{
+            [EmployeeObject createInRealm:realm withValue:@{@"name": @"E", @"age": @40, @"hired": @NO}];
+        }];
+    }];
+    XCTAssertEqual(calls, 3);
+    XCTAssertEqualObjects(changes.insertions, @[@2]);
+    XCTAssertEqualObjects(changes.modifications, @[]);
+    [token stop];
+
+    void (^block)(RLMResults *, RLMCollectionChange *, NSError *) = ^(__unused RLMResults *results,
+                                                                     __unused RLMCollectionChange *change,
+                                                                     __unused NSError *error) {};
+    RLMAssertThrowsWithReasonMatching([employees addNotificationBlock:block keyPaths:@[@"salary"]],
+                                      @"property 'salary' not found in object of type 'EmployeeObject'");
+    RLMAssertThrowsWithReasonMatching([employees addNotificationBlock:block keyPaths:@[@"name.length"]],
+                                      @"property 'EmployeeObject.name' is not a link to a single object");
+}
+
+- (void)testNotificationBlockWithLinkKeyPath {
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm transactionWithBlock:^{
+        [PrimaryEmployeeObject createInRealm:realm withValue:@{@"name": @"X", @"age": @20, @"hired": @NO}];
+        PrimaryEmployeeObject *a = [PrimaryEmployeeObject createInRealm:realm withValue:@{@"name": @"A", @"age": @20, @"hired": @NO}];
+        PrimaryEmployeeObject *b = [PrimaryEmployeeObject createInRealm:realm withValue:@{@"name": @"B", @"age": @30, @"hired": @NO}];
+        [PrimaryCompanyObject createInRealm:realm withValue:@{@"name": @"1", @"employees": @[], @"intern": a}];
+        [PrimaryCompanyObject createInRealm:realm withValue:@{@"name": @"2", @"employees": @[], @"intern": b}];
+    }];
+
+    __block int calls = 0;
+    __block RLMCollectionChange *changes;
+    RLMNotificationToken *token = [[PrimaryCompanyObject allObjectsInRealm:realm] addNotificationBlock:^(RLMResults *results, RLMCollectionChange *c, NSError *error) {
+        XCTAssertNotNil(results);
+        XCTAssertNil(error);
+        changes = c;
+        ++calls;
+        CFRunLoopStop(CFRunLoopGetCurrent());
+    } keyPaths:@[@"intern"]];
+    CFRunLoopRun();
+    XCTAssertEqual(calls, 1);
+
+    // Deleting another employee moves the row of an intern, which doesn't
+    // change which object is linked to
+    [self waitForNotification:RLMRealmDidChangeNotification realm:realm block:^{
+        RLMRealm *realm = [RLMRealm defaultRealm];
+        [realm transactionWithBlock:^{
+            [realm deleteObject:[PrimaryEmployeeObject objectInRealm:realm forPrimaryKey:@"X"]];
+        }];
+    }];
+    XCTAssertEqual(calls, 1);
+
+    [self waitForNotification:RLMRealmDidChangeNotification realm:realm block:^{
+        RLMRealm *realm = [RLMRealm defaultRealm];
+        [realm transactionWithBlock:^{
+            [PrimaryCompanyObject objectInRealm:realm forPrimaryKey:@"1"].intern =
+                [PrimaryEmployeeObject objectInRealm:realm forPrimaryKey:@"B"];
+        }];
+    }];
+    XCTAssertEqual(calls, 2);
+    XCTAssertEqualObjects(changes.modifications, @[@0]);
+    [token stop];
+}
+
+- (void)testNotificationBlockWithKeyPathsOnLargeCollection {
+    // Enough objects for the values to be read only once each is modified
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm transactionWithBlock:^{
+        for (int i = 0; i < 1500; ++i) {
+            [EmployeeObject createInRealm:realm withValue:@{@"name": @"A", @"age": @(i), @"hired": @NO}];
+        }
+    }];
+
+    __block int calls = 0;
+    __block RLMCollectionChange *changes;
+    RLMNotificationToken *token = [[EmployeeObject allObjectsInRealm:realm] addNotificationBlock:^(RLMResults *results, RLMCollectionChange *c, NSError *error) {
+        XCTAssertNotNil(results);
+        XCTAssertNil(error);
+        changes = c;
+        ++calls;
+        CFRunLoopStop(CFRunLoopGetCurrent());
+    } keyPaths:@[@"age"]];
+    CFRunLoopRun();
+    XCTAssertEqual(calls, 1);
+
+    // The values of the objects weren't known before, so their first
+    // modifications are reported
+    [self waitForNotification:RLMRealmDidChangeNotification realm:realm block:^{
+        RLMRealm *realm = [RLMRealm defaultRealm];
+        [realm transactionWithBlock:^{
+            [[EmployeeObject allObjectsInRealm:realm][10] setName:@"B"];
+            [[EmployeeObject allObjectsInRealm:realm][1200] setHired:YES];
+        }];
+    }];
+    XCTAssertEqual(calls, 2);
+    XCTAssertEqualObjects(changes.modifications, (@[@10, @1200]));
+
+    [self waitForNotification:RLMRealmDidChangeNotification realm:realm block:^{
+        RLMRealm *realm = [RLMRealm defaultRealm];
+        [realm transactionWithBlock:^{
+            [[EmployeeObject allObjectsInRealm:realm][10] setName:@"C"];
+            [[EmployeeObject allObjectsInRealm:realm][1200] setHired:NO];
+        }];
+    }];
+    // Neither the old nor the new indexes of the unrelated modifications are
+    // left in the change, which would otherwise not be empty
+    XCTAssertEqual(calls, 2);
+
+    [self waitForNotification:RLMRealmDidChangeNotification realm:realm block:^{
+        RLMRealm *realm = [RLMRealm defaultRealm];
+        [realm transactionWithBlock:^{
+            [[EmployeeObject allObjectsInRealm:realm][10] setName:@"D"];
+            [[EmployeeObject allObjectsInRealm:realm][1200] setAge:0];
+        }];
+    }];
+    XCTAssertEqual(calls, 3);
+    XCTAssertEqualObjects(changes.modifications, @[@1200]);
+    [token stop];
+}
+
+- (void)testNotificationBlockWithMinimumInterval {
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    __block int calls = 0;
+    __block RLMCollectionChange *changes;
+    RLMNotificationToken *token = [[EmployeeObject allObjectsInRealm:realm] addNotificationBlock:^(RLMResults *results, RLMCollectionChange *c, NSError *error) {
+        XCTAssertNotNil(results);
+        XCTAssertNil(error);
+        changes = c;
+        ++calls;
+        CFRunLoopStop(CFRunLoopGetCurrent());
+    } keyPaths:nil minimumInterval:1];
+    CFRunLoopRun();
+    XCTAssertEqual(calls, 1);
+
+    // Both transactions are committed within the interval after the initial
+    // notification, so they're reported together
+    for (NSString *name in @[@"A", @"B"]) {
+        [self waitForNotification:RLMRealmDidChangeNotification realm:realm block:^{
+            RLMRealm *realm = [RLMRealm defaultRealm];
+            [realm transactionWithBlock:^{
+                [EmployeeObject createInRealm:realm withValue:@{@"name": name, @"age": @20, @"hired": @NO}];
+            }];
+        }];
+    }
+    XCTAssertEqual(calls, 1);
+
+    CFRunLoopRun();
+    XCTAssertEqual(calls, 2);
+    XCTAssertEqualObjects(changes.insertions, (@[@0, @1]));
+    XCTAssertEqualObjects(changes.deletions, @[]);
+    XCTAssertEqualObjects(changes.modifications, @[]);
+    [token stop];
+}
+
+- (void)testNotificationBlockOnQueue {
+    dispatch_queue_t queue = dispatch_queue_create("notification queue", DISPATCH_QUEUE_SERIAL);
+    __block XCTestExpectation *expectation = [self expectationWithDescription:@"initial notification"];
+    __block NSUInteger count = NSNotFound;
+    __block RLMCollectionChange *changes;
+    __block __weak RLMRealm *deliveredRealm;
+    RLMNotificationToken *token = [[EmployeeObject allObjects] addNotificationBlock:^(RLMResults *results, RLMCollectionChange *c, NSError *error) {
+        XCTAssertNotNil(results);
+        XCTAssertNil(error);
+        XCTAssertFalse(NSThread.isMainThread);
+        // The results are at the version the changes describe
+        deliveredRealm = results.realm;
+        if (c) {
+            XCTAssertEqual(results.count, count + c.insertions.count - c.deletions.count);
+        }
+        count = results.count;
+        changes = c;
+        [expectation fulfill];
+    } queue:queue];
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+    XCTAssertEqual(count, 0U);
+    XCTAssertNil(changes);
+
+    expectation = [self expectationWithDescription:@"insertion"];
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm transactionWithBlock:^{
+        [EmployeeObject createInRealm:realm withValue:@{@"name": @"A", @"age": @20, @"hired": @NO}];
+    }];
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+    XCTAssertEqual(count, 1U);
+    XCTAssertEqualObjects(changes.insertions, @[@0]);
+    // The delivery's Realm isn't kept once the block has returned
+    dispatch_sync(queue, ^{});
+    XCTAssertNil(deliveredRealm);
+
+    // Commits which skip the token don't notify the block
+    XCTAssertEqual(token.realm, realm);
+    expectation = nil;
+    [realm beginWriteTransaction];
+    [EmployeeObject createInRealm:realm withValue:@{@"name": @"B", @"age": @30, @"hired": @NO}];
+    [realm commitWriteTransactionWithoutNotifying:@[token] error:nil];
+    [NSRunLoop.currentRunLoop runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.5]];
+    dispatch_sync(queue, ^{});
+    XCTAssertEqual(count, 1U);
+    // The writer accounts for the changes it skipped notifying about
+    count = 2;
+
+    expectation = [self expectationWithDescription:@"insertion after skipped commit"];
+    [realm transactionWithBlock:^{
+        [EmployeeObject createInRealm:realm withValue:@{@"name": @"C", @"age": @40, @"hired": @NO}];
+    }];
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+    XCTAssertEqual(count, 3U);
+    XCTAssertEqualObjects(changes.insertions, @[@2]);
+    [token stop];
+}
+
+- (void)testNotificationTimingBlock {
+    NSMutableSet *stages = [NSMutableSet new];
+    [RLMRealm setNotificationTimingBlock:^(RLMNotificationStage stage, NSString *path, NSTimeInterval duration) {
+        XCTAssertNotNil(path);
+        XCTAssertGreaterThanOrEqual(duration, 0);
+        @synchronized (stages) {
+            [stages addObject:@(stage)];
+        }
+    }];
+    [self expectNotification:^(RLMRealm *realm) {
+        [IntObject createInRealm:realm withValue:@[@3]];
+    }];
+    [RLMRealm setNotificationTimingBlock:nil];
+
+    @synchronized (stages) {
+        XCTAssertTrue([stages containsObject:@(RLMNotificationStageRefresh)]);
+        XCTAssertTrue([stages containsObject:@(RLMNotificationStageRealmBlocks)]);
+        XCTAssertTrue([stages containsObject:@(RLMNotificationStageCollectionBlock)]);
+        XCTAssertFalse([stages containsObject:@(RLMNotificationStageObjectBlock)]);
+        [stages removeAllObjects];
+    }
+    [self expectNotification:^(RLMRealm *realm) {
+        [IntObject createInRealm:realm withValue:@[@4]];
+    }];
+    XCTAssertEqual(stages.count, 0U);
+}
+
+- (void)testSectionedResults {
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm transactionWithBlock:^{
+        for (NSArray *values in @[@[@"A", @20], @[@"B", @20], @[@"C", @30]]) {
+            [EmployeeObject createInRealm:realm withValue:@{@"name": values[0], @"age": values[1], @"hired": @NO}];
+        }
+    }];
+
+    RLMResults *results = [[EmployeeObject allObjectsInRealm:realm] sortedResultsUsingKeyPath:@"age" ascending:YES];
+    RLMSectionedResults *sections = [results sectionedResultsUsingKeyPath:@"age"];
+    XCTAssertEqualObjects(sections.sectionKeys, (@[@20, @30]));
+    XCTAssertEqual([sections numberOfObjectsInSection:0], 2U);
+    XCTAssertEqualObjects([sections objectAtIndexPath:indexPath(1, 0)][@"name"], @"C");
+    RLMAssertThrowsWithReasonMatching([sections numberOfObjectsInSection:2], @"out of bounds");
+    RLMAssertThrowsWithReasonMatching([sections objectAtIndexPath:indexPath(1, 1)], @"out of bounds");
+
+    __block RLMSectionedResultsChange *changes;
+    __block int calls = 0;
+    RLMNotificationToken *token = [sections addNotificationBlock:^(RLMSectionedResults *s, RLMSectionedResultsChange *c, NSError *error) {
+        XCTAssertEqual(s, sections);
+        XCTAssertNil(error);
+        changes = c;
+        ++calls;
+        CFRunLoopStop(CFRunLoopGetCurrent());
+    }];
+    CFRunLoopRun();
+    XCTAssertEqual(calls, 1);
+    XCTAssertNil(changes);
+
+    // B moves to a new section, and D is inserted into an existing one
+    [self waitForNotification:RLMRealmDidChangeNotification realm:realm block:^{
+        RLMRealm *realm = [RLMRealm defaultRealm];
+        [realm transactionWithBlock:^{
+            [[EmployeeObject objectsInRealm:realm where:@"name = 'B'"] setValue:@40 forKey:@"age"];
+            [EmployeeObject createInRealm:realm withValue:@{@"name": @"D", @"age": @30, @"hired": @NO}];
+        }];
+    }];
+    XCTAssertEqual(calls, 2);
+    XCTAssertEqualObjects(sections.sectionKeys, (@[@20, @30, @40]));
+    XCTAssertEqual([sections numberOfObjectsInSection:1], 2U);
+    XCTAssertEqualObjects(changes.sectionInsertions, [NSIndexSet indexSetWithIndex:2]);
+    XCTAssertEqualObjects(changes.sectionDeletions, [NSIndexSet indexSet]);
+    XCTAssertEqualObjects(changes.deletions, @[indexPath(0, 1)]);
+    XCTAssertEqual([changes insertionsInSection:1].count, 1U);
+    XCTAssertEqual(changes.insertions.count, 1U);
+
+    // Modifying an object without changing its key reloads it in place
+    [self waitForNotification:RLMRealmDidChangeNotification realm:realm block:^{
+        RLMRealm *realm = [RLMRealm defaultRealm];
+        [realm transactionWithBlock:^{
+            [[EmployeeObject objectsInRealm:realm where:@"name = 'A'"] setValue:@YES forKey:@"hired"];
+        }];
+    }];
+    XCTAssertEqual(calls, 3);
+    XCTAssertEqualObjects(changes.modifications, @[indexPath(0, 0)]);
+    XCTAssertEqualObjects(changes.deletions, @[]);
+    XCTAssertEqualObjects(changes.insertions, @[]);
+
+    // Removing the only object in a section removes the section
+    [self waitForNotification:RLMRealmDidChangeNotification realm:realm block:^{
+        RLMRealm *realm = [RLMRealm defaultRealm];
+        [realm transactionWithBlock:^{
+            [realm deleteObjects:[EmployeeObject objectsInRealm:realm where:@"name = 'A'"]];
+        }];
+    }];
+    XCTAssertEqual(calls, 4);
+    XCTAssertEqualObjects(sections.sectionKeys, (@[@30, @40]));
+    XCTAssertEqualObjects(changes.sectionDeletions, [NSIndexSet indexSetWithIndex:0]);
+    XCTAssertEqualObjects(changes.deletions, @[]);
+    [token stop];
+
+    // Without a notification block the sections are computed again once the
+    // Realm has changed
+    [realm transactionWithBlock:^{
+        [EmployeeObject createInRealm:realm withValue:@{@"name": @"E", @"age": @50, @"hired": @NO}];
+        XCTAssertEqualObjects(sections.sectionKeys, (@[@30, @40, @50]));
+        [realm deleteObjects:[EmployeeObject objectsInRealm:realm where:@"age = 40"]];
+        XCTAssertEqualObjects(sections.sectionKeys, (@[@30, @50]));
+    }];
+    XCTAssertEqualObjects(sections.sectionKeys, (@[@30, @50]));
+    [self dispatchAsyncAndWait:^{
+        RLMRealm *realm = [RLMRealm defaultRealm];
+        [realm transactionWithBlock:^{
+            [EmployeeObject createInRealm:realm withValue:@{@"name": @"F", @"age": @10, @"hired": @NO}];
+        }];
+    }];
+    [realm refresh];
+    XCTAssertEqualObjects(sections.sectionKeys, (@[@10, @30, @50]));
+    XCTAssertEqualObjects([sections objectAtIndexPath:indexPath(0, 0)][@"name"], @"F");
+}
+
+- (void)testSectionedResultsLateBlockIsSentInitialSectionsBeforeChanges {
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm transactionWithBlock:^{
+        [EmployeeObject createInRealm:realm withValue:@{@"name": @"A", @"age": @20, @"hired": @NO}];
+    }];
+    RLMResults *results = [[EmployeeObject allObjectsInRealm:realm] sortedResultsUsingKeyPath:@"age" ascending:YES];
+    RLMSectionedResults *sections = [results sectionedResultsUsingKeyPath:@"age"];
+    RLMNotificationToken *first = [sections addNotificationBlock:^(__unused RLMSectionedResults *s,
+                                                                   __unused RLMSectionedResultsChange *c,
+                                                                   NSError *error) {
+        XCTAssertNil(error);
+        CFRunLoopStop(CFRunLoopGetCurrent());
+    }];
+    CFRunLoopRun();
+
+    // The initial sections have already been delivered, so the second block
+    // is sent them on the next run loop iteration, but beginning a write
+    // transaction delivers the other thread's change before then
+    [self dispatchAsyncAndWait:^{
+        RLMRealm *realm = [RLMRealm defaultRealm];
+        [realm transactionWithBlock:^{
+            [EmployeeObject createInRealm:realm withValue:@{@"name": @"B", @"age": @30, @"hired": @NO}];
+        }];
+    }];
+    NSMutableArray *changes = [NSMutableArray new];
+    RLMNotificationToken *second = [sections addNotificationBlock:^(__unused RLMSectionedResults *s,
+                                                                    RLMSectionedResultsChange *c, NSError *error) {
+        XCTAssertNil(error);
+        [changes addObject:c ?: NSNull.null];
+    }];
+    [realm beginWriteTransaction];
+    [realm cancelWriteTransaction];
+    [NSRunLoop.currentRunLoop runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.1]];
+    XCTAssertEqualObjects(changes, @[NSNull.null]);
+    XCTAssertEqualObjects(sections.sectionKeys, (@[@20, @30]));
+    [first stop];
+    [second stop];
+}
+
+- (void)testIdentityNotifications {
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm transactionWithBlock:^{
+        [PrimaryStringObject createInRealm:realm withValue:@[@"a", @1]];
+        [PrimaryStringObject createInRealm:realm withValue:@[@"b", @2]];
+    }];
+    RLMAssertThrowsWithReasonMatching([[IntObject allObjectsInRealm:realm] addIdentityNotificationBlock:^(RLMCollectionIdentityChange *, NSError *) {}],
+                                      @"primary key");
+
+    __block RLMCollectionIdentityChange *changes;
+    RLMResults *results = [[PrimaryStringObject allObjectsInRealm:realm] sortedResultsUsingKeyPath:@"intCol" ascending:YES];
+    RLMNotificationToken *token = [results addIdentityNotificationBlock:^(RLMCollectionIdentityChange *c, NSError *error) {
+        XCTAssertNil(error);
+        changes = c;
+        CFRunLoopStop(CFRunLoopGetCurrent());
+    }];
+    CFRunLoopRun();
+    XCTAssertEqualObjects(changes.identifiers, (@[@"a", @"b"]));
+    XCTAssertEqualObjects(changes.insertedIdentifiers, (@[@"a", @"b"]));
+
+    [self waitForNotification:RLMRealmDidChangeNotification realm:realm block:^{
+        RLMRealm *realm = [RLMRealm defaultRealm];
+        [realm transactionWithBlock:^{
+            [realm deleteObject:[PrimaryStringObject objectInRealm:realm forPrimaryKey:@"a"]];
+            [PrimaryStringObject createInRealm:realm withValue:@[@"c", @0]];
+            [PrimaryStringObject objectInRealm:realm forPrimaryKey:@"b"].intCol = 3;
+        }];
+    }];
+    XCTAssertEqualObjects(changes.identifiers, (@[@"c", @"b"]));
+    XCTAssertEqualObjects(changes.deletedIdentifiers, @[@"a"]);
+    XCTAssertEqualObjects(changes.insertedIdentifiers, @[@"c"]);
+    XCTAssertEqualObjects(changes.modifiedIdentifiers, @[@"b"]);
+    [token stop];
+}
+
+- (void)testArrayView {
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    __block ArrayPropertyObject *array;
+    [realm transactionWithBlock:^{
+        array = [ArrayPropertyObject createInRealm:realm withValue:@[@"", @[], @[@[@3], @[@1], @[@8], @[@2]]]];
+    }];
+    RLMAssertThrowsWithReasonMatching([array.intArray viewWithPredicate:[NSPredicate predicateWithFormat:@"missing > 0"] sortDescriptors:nil],
+                                      @"missing");
+
+    RLMArrayView *view = [array.intArray viewWithPredicate:[NSPredicate predicateWithFormat:@"intCol < 5"]
+                                           sortDescriptors:@[[RLMSortDescriptor sortDescriptorWithKeyPath:@"intCol" ascending:YES]]];
+    XCTAssertEqual(view.count, 3U);
+    XCTAssertEqual([view[0] intCol], 1);
+    XCTAssertEqual([view[2] intCol], 3);
+
+    __block RLMCollectionChange *changes;
+    RLMNotificationToken *token = [view addNotificationBlock:^(RLMArrayView *v, RLMCollectionChange *c, NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertEqual(v, view);
+        changes = c;
+        CFRunLoopStop(CFRunLoopGetCurrent());
+    }];
+    CFRunLoopRun();
+    XCTAssertNil(changes);
+
+    // The object with 8 now matches and sorts first, 1 moves after 2 and 3
+    // stops matching
+    [self waitForNotification:RLMRealmDidChangeNotification realm:realm block:^{
+        RLMRealm *realm = [RLMRealm defaultRealm];
+        [realm transactionWithBlock:^{
+            RLMArray *intArray = [[ArrayPropertyObject allObjectsInRealm:realm].firstObject intArray];
+            [intArray[0] setIntCol:6];
+            [intArray[1] setIntCol:4];
+            [intArray[2] setIntCol:0];
+            [intArray addObject:[IntObject createInRealm:realm withValue:@[@2]]];
+        }];
+    }];
+    XCTAssertEqual(view.count, 4U);
+    XCTAssertEqual([view[0] intCol], 0);
+    XCTAssertEqual([view[1] intCol], 2);
+    XCTAssertEqual([view[2] intCol], 2);
+    XCTAssertEqual([view[3] intCol], 4);
+    XCTAssertEqualObjects(changes.deletions, (@[@0, @2]));
+    XCTAssertEqualObjects(changes.insertions, (@[@0, @2, @3]));
+    [token stop];
+}
+
+- (void)testIdenticalQueriesShareNotifier {
+    // These and the results observed by setUp are all the same query, so they
+    // share a notifier, but each block is still called with its own results
+    RLMResults *first = self.query;
+    RLMResults *second = self.query;
+    __block int calls = 0;
+    __block RLMCollectionChange *firstChange, *secondChange;
+    RLMNotificationToken *firstToken = [first addNotificationBlock:^(RLMResults *results, RLMCollectionChange *change, NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertEqual(results, first);
+        firstChange = change;
+        if (++calls == 2) {
+            CFRunLoopStop(CFRunLoopGetCurrent());
+        }
+    }];
+    RLMNotificationToken *secondToken = [second addNotificationBlock:^(RLMResults *results, RLMCollectionChange *change, NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertEqual(results, second);
+        secondChange = change;
+        if (++calls == 2) {
+            CFRunLoopStop(CFRunLoopGetCurrent());
+        }
+    }];
+    CFRunLoopRun();
+    XCTAssertNil(firstChange);
+    XCTAssertNil(secondChange);
+    XCTAssertEqual(first.count, 4U);
+    XCTAssertEqual(second.count, 4U);
+
+    [self expectNotification:^(RLMRealm *realm) {
+        [IntObject createInRealm:realm withValue:@[@3]];
+    }];
+    XCTAssertEqual(first.count, 5U);
+    XCTAssertEqual(second.count, 5U);
+    XCTAssertEqual(firstChange.insertions.count, 1U);
+    XCTAssertEqualObjects(firstChange.insertions, secondChange.insertions);
+
+    // Stopping one token leaves the others registered
+    [firstToken stop];
+    firstChange = secondChange = nil;
+    [self expectNotification:^(RLMRealm *realm) {
+        [IntObject createInRealm:realm withValue:@[@2]];
+    }];
+    XCTAssertNil(firstChange);
+    XCTAssertEqual(secondChange.insertions.count, 1U);
+    XCTAssertEqual(second.count, 6U);
+    [secondToken stop];
+}
+
+- (void)testLateSubscriberIsNotifiedOfInitialResultsBeforeChanges {
+    // The shared notifier has already delivered its initial notification to
+    // the block added by setUp, so the new block's is deferred to the run loop
+    [self dispatchAsyncAndWait:^{
+        [RLMRealm.defaultRealm transactionWithBlock:^{
+            [IntObject createInDefaultRealmWithValue:@[@3]];
+        }];
+    }];
+    RLMResults *results = self.query;
+    NSMutableArray *changes = [NSMutableArray new];
+    RLMNotificationToken *token = [results addNotificationBlock:^(__unused RLMResults *results,
+                                                                  RLMCollectionChange *change, NSError *error) {
+        XCTAssertNil(error);
+        [changes addObject:change ?: NSNull.null];
+    }];
+
+    // Beginning a write transaction delivers the other thread's change before
+    // the run loop runs, and the new block is given its initial results instead
+    RLMRealm *realm = RLMRealm.defaultRealm;
+    [realm beginWriteTransaction];
+    [realm cancelWriteTransaction];
+    [NSRunLoop.currentRunLoop runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.1]];
+    XCTAssertEqualObjects(changes, @[NSNull.null]);
+    XCTAssertEqual(results.count, 5U);
+    [token stop];
+}
+
+- (void)testQueriesWithDifferentConstantsDontShareNotifier {
+    // Both constants are formatted as 0.1 in the predicate format, but only
+    // the float one matches a double holding a float's value
+    [RLMRealm.defaultRealm transactionWithBlock:^{
+        [DoubleObject createInDefaultRealmWithValue:@[@((double)0.1f)]];
+    }];
+    RLMResults *floats = [DoubleObject objectsWhere:@"doubleCol <= %@", @0.1f];
+    RLMResults *doubles = [DoubleObject objectsWhere:@"doubleCol <= %@", @0.1];
+    __block int calls = 0;
+    void (^block)(RLMResults *, RLMCollectionChange *, NSError *) = ^(__unused RLMResults *results,
+                                                                       __unused RLMCollectionChange *change,
+                                                                       NSError *error) {
+        XCTAssertNil(error);
+        if (++calls == 2) {
+            CFRunLoopStop(CFRunLoopGetCurrent());
+        }
+    };
+    RLMNotificationToken *floatToken = [floats addNotificationBlock:block];
+    RLMNotificationToken *doubleToken = [doubles addNotificationBlock:block];
+    CFRunLoopRun();
+    XCTAssertEqual(floats.count, 1U);
+    XCTAssertEqual(doubles.count, 0U);
+
+    [self expectNotification:^(RLMRealm *realm) {
+        [IntObject createInRealm:realm withValue:@[@3]];
+        [DoubleObject createInRealm:realm withValue:@[@((double)0.1f)]];
+    }];
+    XCTAssertEqual(floats.count, 2U);
+    XCTAssertEqual(doubles.count, 0U);
+    [floatToken stop];
+    [doubleToken stop];
+}
 @end
 
 @interface SortedNotificationTests : NotificationTests
@@ -277,6 +907,14 @@ static RLMCollectionChange *getChange(RLMTestCase<ChangesetTestCase> *self, void
     return changes;
 }
 
+static NSIndexSet *toIndexSet(NSArray<NSNumber *> *indexes) {
+    NSMutableIndexSet *set = [NSMutableIndexSet new];
+    for (NSNumber *index in indexes) {
+        [set addIndex:index.unsignedIntegerValue];
+    }
+    return set;
+}
+
 static void ExpectChange(id self, NSArray *deletions, NSArray *insertions, NSArray *modifications, void (^block)(RLMRealm *)) {
     RLMCollectionChange *changes = getChange(self, block);
     XCTAssertNotNil(changes);
@@ -298,6 +936,17 @@ static void ExpectChange(id self, NSArray *deletions, NSArray *insertions, NSArr
     XCTAssertEqualObjects(deletions, [deletionPaths valueForKey:@"row"]);
     XCTAssertEqualObjects(insertions, [insertionPaths valueForKey:@"row"]);
     XCTAssertEqualObjects(modifications, [modificationPaths valueForKey:@"row"]);
+
+    XCTAssertEqualObjects(toIndexSet(deletions), changes.deletionIndexes);
+    XCTAssertEqualObjects(toIndexSet(insertions), changes.insertionIndexes);
+    XCTAssertEqualObjects(toIndexSet(modifications), changes.modificationIndexes);
+
+    NSMutableIndexSet *ranges = [NSMutableIndexSet new];
+    [changes enumerateInsertionRangesUsingBlock:^(NSRange range, __unused BOOL *stop) {
+        XCTAssertFalse([ranges intersectsIndexesInRange:range]);
+        [ranges addIndexesInRange:range];
+    }];
+    XCTAssertEqualObjects(toIndexSet(insertions), ranges);
 }
 
 #define ExpectNoChange(self, block) XCTAssertNil(getChange((self), (block)))
@@ -18,6 +18,10 @@
 
 #import "RLMTestCase.h"
 
+#import "RLMObjectSchema_Private.h"
+#import "RLMProperty_Private.h"
+#import "RLMRealm_Dynamic.h"
+
 #pragma mark - Test Objects
 
 @interface DogExtraObject : RLMObject
@@ -50,6 +54,32 @@
 }
 @end
 
+@interface GeneratedDefaultObject : RLMObject
+@property NSString *uuid;
+@property int intCol;
+@end
+@implementation GeneratedDefaultObject
++ (NSString *)primaryKey {
+    return @"uuid";
+}
++ (NSDictionary *)defaultPropertyValues {
+    return @{@"uuid": NSUUID.UUID.UUIDString};
+}
+@end
+
+static int s_changingDefaultValue = 0;
+@interface ChangingDefaultObject : RLMObject
+@property int intCol;
+@end
+@implementation ChangingDefaultObject
++ (NSDictionary *)defaultPropertyValues {
+    return @{@"intCol": @(s_changingDefaultValue)};
+}
++ (BOOL)hasStaticDefaultPropertyValues {
+    return YES;
+}
+@end
+
 @interface AllLinks : RLMObject
 @property StringObject *string;
 @property PrimaryStringObject *primaryString;
@@ -594,6 +624,40 @@
     [realm cancelWriteTransaction];
 }
 
+- (void)testCreateResolvesDefaultValuesForEachObject {
+    auto realm = [RLMRealm defaultRealm];
+    [realm beginWriteTransaction];
+
+    auto first = [GeneratedDefaultObject createInRealm:realm withValue:@{@"intCol": @1}];
+    auto second = [GeneratedDefaultObject createInRealm:realm withValue:@{@"intCol": @2}];
+    XCTAssertNotEqualObjects(first.uuid, second.uuid);
+
+    [realm createObjects:GeneratedDefaultObject.className withValues:@[@{@"intCol": @3}, @{@"intCol": @4}] error:nil];
+    XCTAssertEqual([GeneratedDefaultObject allObjectsInRealm:realm].count, 4U);
+    XCTAssertEqual([[NSSet setWithArray:[[GeneratedDefaultObject allObjectsInRealm:realm] valueForKey:@"uuid"]] count], 4U);
+
+    [realm cancelWriteTransaction];
+}
+
+- (void)testCreateCachesStaticDefaultValuesUntilInvalidated {
+    auto realm = [RLMRealm defaultRealm];
+    [realm beginWriteTransaction];
+
+    s_changingDefaultValue = 1;
+    [RLMObject invalidateCachedDefaultPropertyValues];
+    XCTAssertEqual([ChangingDefaultObject createInRealm:realm withValue:@{}].intCol, 1);
+
+    s_changingDefaultValue = 2;
+    XCTAssertEqual([ChangingDefaultObject createInRealm:realm withValue:@{}].intCol, 1);
+    [realm createObjects:ChangingDefaultObject.className withValues:@[@{}] error:nil];
+    XCTAssertEqual([ChangingDefaultObject objectsInRealm:realm where:@"intCol == 1"].count, 3U);
+
+    [RLMObject invalidateCachedDefaultPropertyValues];
+    XCTAssertEqual([ChangingDefaultObject createInRealm:realm withValue:@{}].intCol, 2);
+
+    [realm cancelWriteTransaction];
+}
+
 - (void)testCreateOnManagedObjectInSameRealmShallowCopies {
     auto realm = [RLMRealm defaultRealm];
     [realm beginWriteTransaction];
@@ -902,6 +966,344 @@
     [realm2 cancelWriteTransaction];
 }
 
+#pragma mark - Batch Create
+
+- (void)testCreateObjectsWithArrays {
+    auto realm = RLMRealm.defaultRealm;
+    [realm beginWriteTransaction];
+    [realm createObjects:@"DogObject" withValues:@[@[@"a", @1], @[@"b", @2], @[@"c", @3]] error:nil];
+    [realm commitWriteTransaction];
+
+    auto dogs = [[DogObject allObjectsInRealm:realm] sortedResultsUsingKeyPath:@"age" ascending:YES];
+    XCTAssertEqual(3U, dogs.count);
+    XCTAssertEqualObjects(@"a", [dogs[0] dogName]);
+    XCTAssertEqualObjects(@"c", [dogs[2] dogName]);
+    XCTAssertEqual(3, [dogs[2] age]);
+}
+
+- (void)testCreateObjectsWithDictionariesUsesDefaultValues {
+    auto realm = RLMRealm.defaultRealm;
+    [realm beginWriteTransaction];
+    [realm createObjects:@"PrimaryKeyWithDefault" withValues:@[@{@"stringCol": @"a"},
+                                                                @{@"stringCol": @"b", @"intCol": @5}] error:nil];
+    [realm commitWriteTransaction];
+
+    XCTAssertEqual(10, [PrimaryKeyWithDefault objectInRealm:realm forPrimaryKey:@"a"].intCol);
+    XCTAssertEqual(5, [PrimaryKeyWithDefault objectInRealm:realm forPrimaryKey:@"b"].intCol);
+}
+
+- (void)testCreateObjectsWithLinks {
+    auto realm = RLMRealm.defaultRealm;
+    [realm beginWriteTransaction];
+    [realm createObjects:@"CompanyObject" withValues:@[@[@"one", @[@[@"a", @1, @YES]]],
+                                                       @{@"name": @"two", @"employees": @[@[@"b", @2, @NO],
+                                                                                          @[@"c", @3, @NO]]}] error:nil];
+    [realm commitWriteTransaction];
+
+    XCTAssertEqual(2U, [CompanyObject allObjectsInRealm:realm].count);
+    XCTAssertEqual(3U, [EmployeeObject allObjectsInRealm:realm].count);
+    CompanyObject *two = [CompanyObject objectsInRealm:realm where:@"name = 'two'"].firstObject;
+    XCTAssertEqual(2U, two.employees.count);
+}
+
+- (void)testCreateObjectsValidatesInput {
+    auto realm = RLMRealm.defaultRealm;
+    [realm beginWriteTransaction];
+    RLMAssertThrowsWithReasonMatching(([realm createObjects:@"DogObject" withValues:@[@[@"a", @"age"]] error:nil]),
+                                      @"Invalid value 'age' for property 'age'");
+    RLMAssertThrowsWithReasonMatching(([realm createObjects:@"PrimaryStringObject"
+                                                 withValues:@[@[@"a", @1], @[@"a", @2]] error:nil]),
+                                      @"existing primary key value 'a'");
+
+    // The rows reserved for a batch which fails are removed again
+    NSError *error;
+    XCTAssertFalse([realm createObjects:@"DogObject" withValues:@[@[@"a", @1], @[@"b", @"age"]] error:&error]);
+    XCTAssertNotNil(error);
+    XCTAssertEqual(0U, [DogObject allObjectsInRealm:realm].count);
+    error = nil;
+    XCTAssertFalse([realm createObjects:@"PrimaryStringObject" withValues:@[@[@"a", @1], @[@"b", @2], @[@"a", @3]]
+                                  error:&error]);
+    XCTAssertNotNil(error);
+    XCTAssertEqual(0U, [PrimaryStringObject allObjectsInRealm:realm].count);
+    error = nil;
+    XCTAssertFalse([realm createObjects:@"CompanyObject" withValues:@[@[@"one", @[@[@"a", @1, @YES]]],
+                                                                      @[@"two", @[@[@"b", @"age", @NO]]]]
+                                  error:&error]);
+    XCTAssertNotNil(error);
+    XCTAssertEqual(0U, [CompanyObject allObjectsInRealm:realm].count);
+    XCTAssertEqual(0U, [EmployeeObject allObjectsInRealm:realm].count);
+    [realm cancelWriteTransaction];
+
+    RLMAssertThrowsWithReasonMatching(([realm createObjects:@"DogObject" withValues:@[@[@"a", @1]] error:nil]),
+                                      @"call beginWriteTransaction");
+}
+
+- (void)testCreateObjectsWithTrustedValues {
+    auto realm = RLMRealm.defaultRealm;
+    [realm beginWriteTransaction];
+    [realm createObjects:@"CompanyObject"
+       withTrustedValues:@[@[@"a", @[@[@"b", @1, @YES]]], @{@"name": @"c", @"employees": @[]}] error:nil];
+    RLMResults *companies = [CompanyObject allObjectsInRealm:realm];
+    XCTAssertEqual(2U, companies.count);
+    XCTAssertEqualObjects([companies[0] name], @"a");
+    XCTAssertEqualObjects([[companies[0] employees][0] name], @"b");
+    XCTAssertEqual([[companies[0] employees][0] age], 1);
+    XCTAssertEqualObjects([companies[1] name], @"c");
+    [realm cancelWriteTransaction];
+}
+
+- (void)testCreateOrUpdateObjectsReportsInsertedAndUpdated {
+    auto realm = RLMRealm.defaultRealm;
+    [realm beginWriteTransaction];
+    [PrimaryStringObject createInRealm:realm withValue:@[@"a", @1]];
+
+    NSUInteger inserted = 0, updated = 0;
+    [realm createOrUpdateObjects:@"PrimaryStringObject"
+                      withValues:@[@[@"a", @2], @[@"b", @3], @{@"stringCol": @"c", @"intCol": @4}, @[@"b", @5]]
+                   insertedCount:&inserted updatedCount:&updated];
+    [realm commitWriteTransaction];
+
+    XCTAssertEqual(2U, inserted);
+    XCTAssertEqual(2U, updated);
+    XCTAssertEqual(3U, [PrimaryStringObject allObjectsInRealm:realm].count);
+    XCTAssertEqual(2, [PrimaryStringObject objectInRealm:realm forPrimaryKey:@"a"].intCol);
+    XCTAssertEqual(5, [PrimaryStringObject objectInRealm:realm forPrimaryKey:@"b"].intCol);
+    XCTAssertEqual(4, [PrimaryStringObject objectInRealm:realm forPrimaryKey:@"c"].intCol);
+}
+
+- (void)testCreateOrUpdateObjectsDoesNotModifyKeysNotPresent {
+    auto realm = RLMRealm.defaultRealm;
+    [realm beginWriteTransaction];
+    for (int i = 0; i < 20; ++i) {
+        [PrimaryIntObject createInRealm:realm withValue:@[@(i)]];
+    }
+    [PrimaryKeyWithDefault createInRealm:realm withValue:@[@"a", @5]];
+    [realm createOrUpdateObjects:@"PrimaryKeyWithDefault" withValues:@[@{@"stringCol": @"a"}]
+                   insertedCount:nil updatedCount:nil];
+    XCTAssertEqual(5, [PrimaryKeyWithDefault objectInRealm:realm forPrimaryKey:@"a"].intCol);
+
+    NSUInteger inserted = 0;
+    [realm createOrUpdateObjects:@"PrimaryIntObject" withValues:@[@[@3], @[@30]]
+                   insertedCount:&inserted updatedCount:nil];
+    XCTAssertEqual(1U, inserted);
+    XCTAssertEqual(21U, [PrimaryIntObject allObjectsInRealm:realm].count);
+    [realm cancelWriteTransaction];
+}
+
+- (void)testCreateOrUpdateObjectsWithoutPKThrows {
+    auto realm = RLMRealm.defaultRealm;
+    [realm beginWriteTransaction];
+    RLMAssertThrowsWithReason(([realm createOrUpdateObjects:@"DogObject" withValues:@[@[@"a", @1]]
+                                              insertedCount:nil updatedCount:nil]),
+                              @"'DogObject' does not have a primary key and can not be updated");
+    [realm cancelWriteTransaction];
+}
+
+#pragma mark - Prepared Objects
+
+- (void)testAddPreparedObjectsFromBackgroundThreads {
+    auto realm = RLMRealm.defaultRealm;
+    RLMObjectSchema *objectSchema = realm.schema[@"DogObject"];
+    NSMutableArray *batches = [NSMutableArray array];
+    for (int i = 0; i < 4; ++i) {
+        [batches addObject:NSNull.null];
+    }
+    dispatch_apply(4, dispatch_get_global_queue(0, 0), ^(size_t i) {
+        NSMutableArray *values = [NSMutableArray array];
+        for (int j = 0; j < 10; ++j) {
+            [values addObject:@{@"dogName": [NSString stringWithFormat:@"%zu-%d", i, j], @"age": @(j)}];
+        }
+        RLMPreparedObjects *batch = [[RLMPreparedObjects alloc] initWithObjectSchema:objectSchema values:values];
+        @synchronized (batches) {
+            batches[i] = batch;
+        }
+    });
+
+    [realm beginWriteTransaction];
+    for (RLMPreparedObjects *batch in batches) {
+        XCTAssertEqual(10U, batch.count);
+        [realm addPreparedObjects:batch];
+    }
+    [realm commitWriteTransaction];
+
+    RLMResults *dogs = [DogObject allObjectsInRealm:realm];
+    XCTAssertEqual(40U, dogs.count);
+    XCTAssertEqual(9, [[dogs objectsWhere:@"dogName = '3-9'"].firstObject age]);
+}
+
+- (void)testAddPreparedObjectsWithAllTypes {
+    auto realm = RLMRealm.defaultRealm;
+    NSDate *date = [NSDate dateWithTimeIntervalSince1970:1234.5];
+    NSData *data = [@"data" dataUsingEncoding:NSUTF8StringEncoding];
+    auto batch = [[RLMPreparedObjects alloc] initWithObjectSchema:realm.schema[@"AllOptionalTypes"]
+                                                           values:@[@[@1, @2.5f, @3.5, @YES, @"", data, date],
+                                                                    @{}]];
+    [realm beginWriteTransaction];
+    [realm addPreparedObjects:batch];
+    [realm commitWriteTransaction];
+
+    RLMResults *objects = [AllOptionalTypes allObjectsInRealm:realm];
+    AllOptionalTypes *obj = objects[0];
+    XCTAssertEqualObjects(obj.intObj, @1);
+    XCTAssertEqualObjects(obj.floatObj, @2.5f);
+    XCTAssertEqualObjects(obj.doubleObj, @3.5);
+    XCTAssertEqualObjects(obj.boolObj, @YES);
+    XCTAssertEqualObjects(obj.string, @"");
+    XCTAssertEqualObjects(obj.data, data);
+    XCTAssertEqualObjects(obj.date, date);
+
+    obj = objects[1];
+    XCTAssertNil(obj.intObj);
+    XCTAssertNil(obj.floatObj);
+    XCTAssertNil(obj.doubleObj);
+    XCTAssertNil(obj.boolObj);
+    XCTAssertNil(obj.string);
+    XCTAssertNil(obj.data);
+    XCTAssertNil(obj.date);
+}
+
+- (void)testAddPreparedObjectsResolvesDefaultValuesForEachObject {
+    auto realm = RLMRealm.defaultRealm;
+    auto batch = [[RLMPreparedObjects alloc] initWithObjectSchema:realm.schema[@"GeneratedDefaultObject"]
+                                                           values:@[@{@"intCol": @1}, @{@"intCol": @2}]];
+    [realm beginWriteTransaction];
+    [realm addPreparedObjects:batch];
+    [realm commitWriteTransaction];
+
+    RLMResults *objects = [GeneratedDefaultObject allObjectsInRealm:realm];
+    XCTAssertEqual(2U, objects.count);
+    XCTAssertNotEqualObjects([objects[0] uuid], [objects[1] uuid]);
+}
+
+- (void)testAddPreparedObjectsWithPrimaryKeys {
+    auto realm = RLMRealm.defaultRealm;
+    RLMObjectSchema *objectSchema = realm.schema[@"PrimaryStringObject"];
+    [realm beginWriteTransaction];
+    [realm addPreparedObjects:[[RLMPreparedObjects alloc] initWithObjectSchema:objectSchema
+                                                                        values:@[@[@"a", @1], @[@"b", @2]]]];
+    XCTAssertEqual(2, [PrimaryStringObject objectInRealm:realm forPrimaryKey:@"b"].intCol);
+
+    RLMAssertThrowsWithReasonMatching([realm addPreparedObjects:[[RLMPreparedObjects alloc]
+                                                                 initWithObjectSchema:objectSchema
+                                                                 values:@[@[@"c", @3], @[@"a", @4]]]],
+                                      @"existing primary key value 'a'");
+    // Nothing is added when any of the keys are duplicates
+    XCTAssertNil([PrimaryStringObject objectInRealm:realm forPrimaryKey:@"c"]);
+    RLMAssertThrowsWithReasonMatching([realm addPreparedObjects:[[RLMPreparedObjects alloc]
+                                                                 initWithObjectSchema:objectSchema
+                                                                 values:@[@[@"d", @5], @[@"e", @6], @[@"d", @7]]]],
+                                      @"existing primary key value 'd'");
+    XCTAssertEqual(2U, [PrimaryStringObject allObjectsInRealm:realm].count);
+    [realm cancelWriteTransaction];
+}
+
+- (void)testPreparedObjectsValidatesInput {
+    auto realm = RLMRealm.defaultRealm;
+    RLMAssertThrowsWithReasonMatching([[RLMPreparedObjects alloc] initWithObjectSchema:realm.schema[@"CompanyObject"]
+                                                                                values:@[]],
+                                      @"'employees' of 'CompanyObject' is a link");
+    RLMProperty *anyProperty = [[RLMProperty alloc] initWithName:@"any" type:RLMPropertyTypeAny objectClassName:nil
+                                          linkOriginPropertyName:nil indexed:NO optional:NO];
+    RLMObjectSchema *anySchema = [[RLMObjectSchema alloc] initWithClassName:@"AnyObject" objectClass:RLMObject.class
+                                                                 properties:@[anyProperty]];
+    RLMAssertThrowsWithReasonMatching([[RLMPreparedObjects alloc] initWithObjectSchema:anySchema values:@[]],
+                                      @"'any' of 'AnyObject' is of type 'any'");
+    RLMAssertThrowsWithReasonMatching([[RLMPreparedObjects alloc] initWithObjectSchema:realm.schema[@"DogObject"]
+                                                                                values:@[@[@"a", @"b"]]],
+                                      @"Invalid value 'b' for property 'age'");
+    RLMAssertThrowsWithReasonMatching([[RLMPreparedObjects alloc] initWithObjectSchema:realm.schema[@"DogObject"]
+                                                                                values:@[@{@"dogName": @"a"}]],
+                                      @"Property 'age' of object of type 'DogObject' cannot be nil.");
+
+    auto batch = [[RLMPreparedObjects alloc] initWithObjectSchema:realm.schema[@"DogObject"] values:@[@[@"a", @1]]];
+    RLMAssertThrowsWithReasonMatching([realm addPreparedObjects:batch], @"call beginWriteTransaction");
+}
+
+#pragma mark - JSON Import
+
+static NSInputStream *jsonStream(NSString *json) {
+    return [NSInputStream inputStreamWithData:[json dataUsingEncoding:NSUTF8StringEncoding]];
+}
+
+- (void)testImportJSONFromStream {
+    auto realm = RLMRealm.defaultRealm;
+    NSError *error;
+    NSString *json = @"[{\"name\": \"Caf\\u00e9 \\ud83d\\ude00\", \"employees\": "
+                     @"[{\"name\": \"a\", \"age\": 30, \"hired\": true}, {\"name\": \"b\", \"age\": -2, \"hired\": false}]},"
+                     @" {\"name\": \"empty\", \"employees\": []}]";
+    XCTAssertTrue([realm importJSONFromStream:jsonStream(json) className:@"CompanyObject" options:nil error:&error]);
+    XCTAssertNil(error);
+    XCTAssertFalse(realm.inWriteTransaction);
+
+    RLMResults *companies = [CompanyObject allObjectsInRealm:realm];
+    XCTAssertEqual(2U, companies.count);
+    CompanyObject *company = companies[0];
+    XCTAssertEqualObjects(company.name, @"Caf\u00e9 \U0001F600");
+    XCTAssertEqual(2U, company.employees.count);
+    XCTAssertEqualObjects(company.employees[1].name, @"b");
+    XCTAssertEqual(-2, company.employees[1].age);
+    XCTAssertTrue(company.employees[0].hired);
+    XCTAssertEqual(0U, [companies[1] employees].count);
+}
+
+- (void)testImportJSONFromStreamWithinWriteTransaction {
+    auto realm = RLMRealm.defaultRealm;
+    [realm beginWriteTransaction];
+    XCTAssertTrue([realm importJSONFromStream:jsonStream(@"[{\"dogName\": \"a\", \"age\": 1}]")
+                                    className:@"DogObject" options:@{RLMJSONImportOptionCommitInterval: @1}
+                                        error:nil]);
+    XCTAssertTrue(realm.inWriteTransaction);
+    XCTAssertEqual(1U, [DogObject allObjectsInRealm:realm].count);
+    [realm cancelWriteTransaction];
+    XCTAssertEqual(0U, [DogObject allObjectsInRealm:realm].count);
+}
+
+- (void)testImportJSONFromStreamCommitsEveryInterval {
+    auto realm = RLMRealm.defaultRealm;
+    NSError *error;
+    // The third object is missing a required property, so only the first
+    // batch of two is committed
+    NSString *json = @"[{\"dogName\": \"a\", \"age\": 1}, {\"dogName\": \"b\", \"age\": 2}, {\"dogName\": \"c\"}]";
+    XCTAssertFalse([realm importJSONFromStream:jsonStream(json) className:@"DogObject"
+                                       options:@{RLMJSONImportOptionCommitInterval: @2} error:&error]);
+    XCTAssertNotNil(error);
+    XCTAssertFalse(realm.inWriteTransaction);
+    XCTAssertEqual(2U, [DogObject allObjectsInRealm:realm].count);
+}
+
+- (void)testImportJSONFromStreamWithUpdate {
+    auto realm = RLMRealm.defaultRealm;
+    [realm transactionWithBlock:^{
+        [PrimaryStringObject createInRealm:realm withValue:@[@"a", @1]];
+    }];
+
+    NSString *json = @"[{\"stringCol\": \"a\", \"intCol\": 10}, {\"stringCol\": \"b\", \"intCol\": 20}]";
+    XCTAssertFalse([realm importJSONFromStream:jsonStream(json) className:@"PrimaryStringObject" options:nil error:nil]);
+    XCTAssertEqual(1, [PrimaryStringObject objectInRealm:realm forPrimaryKey:@"a"].intCol);
+
+    XCTAssertTrue([realm importJSONFromStream:jsonStream(json) className:@"PrimaryStringObject"
+                                      options:@{RLMJSONImportOptionUpdate: @YES} error:nil]);
+    XCTAssertEqual(10, [PrimaryStringObject objectInRealm:realm forPrimaryKey:@"a"].intCol);
+    XCTAssertEqual(20, [PrimaryStringObject objectInRealm:realm forPrimaryKey:@"b"].intCol);
+
+    RLMAssertThrowsWithReason([realm importJSONFromStream:jsonStream(@"[]") className:@"DogObject"
+                                                  options:@{RLMJSONImportOptionUpdate: @YES} error:nil],
+                              @"'DogObject' does not have a primary key and can not be updated");
+}
+
+- (void)testImportJSONFromStreamReportsInvalidJSON {
+    auto realm = RLMRealm.defaultRealm;
+    for (NSString *json in @[@"", @"{}", @"[{\"dogName\": \"a\", \"age\": 1}", @"[{\"dogName\": \"a\" \"age\": 1}]",
+                             @"[{\"dogName\": \"a\\q\", \"age\": 1}]", @"[{\"dogName\": \"a\", \"age\": 1}] x",
+                             @"[{\"dogName\": \"\\ud83d\", \"age\": 1}]"]) {
+        NSError *error;
+        XCTAssertFalse([realm importJSONFromStream:jsonStream(json) className:@"DogObject" options:nil error:&error]);
+        XCTAssertEqual(error.code, RLMErrorFail);
+        XCTAssertTrue([error.localizedDescription hasPrefix:@"Invalid JSON at offset "]);
+    }
+    XCTAssertEqual(0U, [DogObject allObjectsInRealm:realm].count);
+}
+
 #pragma mark - Add
 
 - (void)testAddInvalidated {
@@ -916,6 +1318,34 @@
     [realm cancelWriteTransaction];
 }
 
+- (void)testAddObjectsOfMixedTypes {
+    auto realm = [RLMRealm defaultRealm];
+    [realm beginWriteTransaction];
+
+    auto dog1 = [[DogObject alloc] initWithValue:@[@"a", @1]];
+    auto dog2 = [[DogObject alloc] initWithValue:@[@"b", @2]];
+    auto optional = [[AllOptionalTypes alloc] initWithValue:@[@1, NSNull.null, @3.0, @YES, @"str"]];
+    auto managedDog = [DogObject createInRealm:realm withValue:@[@"c", @3]];
+    [realm addObjects:@[dog1, optional, managedDog, dog2]];
+
+    XCTAssertEqual(dog1.realm, realm);
+    XCTAssertEqual(dog2.realm, realm);
+    XCTAssertEqual(optional.realm, realm);
+    XCTAssertEqual(3U, [DogObject allObjectsInRealm:realm].count);
+    XCTAssertEqualObjects(dog2.dogName, @"b");
+    XCTAssertEqual(2, dog2.age);
+    XCTAssertEqualObjects(optional.intObj, @1);
+    XCTAssertNil(optional.floatObj);
+    XCTAssertEqualObjects(optional.string, @"str");
+
+    RLMAssertThrowsWithReasonMatching(([realm addObjects:@[[[DogObject alloc] initWithValue:@[@"d", @4]], @"string"]]),
+                                      @"Cannot insert objects of type .* with addObjects:");
+    RLMAssertThrowsWithReason(([realm addOrUpdateObjectsFromArray:@[[[DogObject alloc] initWithValue:@[@"d", @4]]]]),
+                              @"'DogObject' does not have a primary key and can not be updated");
+
+    [realm cancelWriteTransaction];
+}
+
 - (void)testAddDuplicatePrimaryKey {
     auto realm = [RLMRealm defaultRealm];
     [realm beginWriteTransaction];
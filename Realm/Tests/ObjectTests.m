@@ -197,6 +197,98 @@ RLM_ARRAY_TYPE(CycleObject)
 @implementation SubclassDateObject
 @end
 
+// More properties than there are specialized accessor getters
+@interface WideObject : RLMObject
+@property int int0;
+@property int int1;
+@property int int2;
+@property int int3;
+@property int int4;
+@property int int5;
+@property int int6;
+@property int int7;
+@property int int8;
+@property int int9;
+@property int int10;
+@property int int11;
+@property int int12;
+@property int int13;
+@property int int14;
+@property int int15;
+@property NSString *string16;
+@property NSNumber<RLMDouble> *optDouble17;
+@property NSDate *date18;
+@end
+
+@implementation WideObject
+@end
+
+@interface InternedStringObject : RLMObject
+@property NSString *status;
+@property NSString *name;
+@end
+
+@implementation InternedStringObject
++ (NSArray *)internedStringProperties {
+    return @[@"status"];
+}
+@end
+
+@interface InvalidInternedStringObject : RLMObject
+@property int status;
+@end
+
+@implementation InvalidInternedStringObject
++ (NSArray *)internedStringProperties {
+    return @[@"status"];
+}
+
++ (BOOL)shouldIncludeInDefaultSchema {
+    return NO;
+}
+@end
+
+@interface DerivedNameObject : RLMObject
+@property NSString *first;
+@property NSString *last;
+@property NSString *searchName;
+@property NSInteger length;
+@end
+
+@implementation DerivedNameObject
++ (NSDictionary *)derivedProperties {
+    return @{@"searchName": @[@"first", @"last"], @"length": @[@"first", @"last"]};
+}
+
++ (NSArray *)indexedProperties {
+    return @[@"searchName"];
+}
+
+- (id)valueForDerivedProperty:(NSString *)propertyName {
+    NSString *name = [NSString stringWithFormat:@"%@ %@", self.first ?: @"", self.last ?: @""];
+    if ([propertyName isEqualToString:@"length"]) {
+        return @(name.length);
+    }
+    return name.lowercaseString;
+}
+@end
+
+@interface VectorObject : RLMObject
+@property NSString *name;
+@property NSData *embedding;
+@end
+
+@implementation VectorObject
++ (NSDictionary *)vectorProperties {
+    return @{@"embedding": @3};
+}
+@end
+
+static NSData *RLMTestVector(float x, float y, float z) {
+    float values[] = {x, y, z};
+    return [NSData dataWithBytes:values length:sizeof(values)];
+}
+
 #pragma mark - Tests
 
 @interface ObjectTests : RLMTestCase
@@ -323,6 +415,243 @@ RLM_ARRAY_TYPE(CycleObject)
     XCTAssertEqual(row1.cBoolCol, true);
 }
 
+- (void)testPropertiesPastSpecializedGetters {
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    NSDate *date = [NSDate dateWithTimeIntervalSince1970:1000];
+    NSMutableArray *values = [NSMutableArray array];
+    for (int i = 0; i < 16; ++i) {
+        [values addObject:@(i * 10)];
+    }
+    [values addObjectsFromArray:@[@"wide", @1.5, date]];
+
+    [realm beginWriteTransaction];
+    WideObject *obj = [WideObject createInRealm:realm withValue:values];
+    [realm commitWriteTransaction];
+
+    for (int i = 0; i < 16; ++i) {
+        NSString *name = [NSString stringWithFormat:@"int%d", i];
+        XCTAssertEqualObjects([obj valueForKey:name], @(i * 10));
+    }
+    XCTAssertEqual(obj.int0, 0);
+    XCTAssertEqual(obj.int15, 150);
+    XCTAssertEqualObjects(obj.string16, @"wide");
+    XCTAssertEqualObjects(obj.optDouble17, @1.5);
+    XCTAssertEqualObjects(obj.date18, date);
+
+    [realm transactionWithBlock:^{
+        obj.int15 = 7;
+        obj.optDouble17 = nil;
+    }];
+    XCTAssertEqual(obj.int15, 7);
+    XCTAssertNil(obj.optDouble17);
+}
+
+- (void)testCopyValuesForProperties {
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    NSDate *date = [NSDate dateWithTimeIntervalSince1970:1000];
+    NSArray *values = @[@YES, @5, @1.5f, @2.5, @"a", [@"b" dataUsingEncoding:NSUTF8StringEncoding],
+                        date, @NO, @100, NSNull.null];
+    AllTypesObject *unmanaged = [[AllTypesObject alloc] initWithValue:values];
+    NSArray *keys = @[@"boolCol", @"intCol", @"floatCol", @"doubleCol", @"stringCol", @"binaryCol",
+                      @"dateCol", @"cBoolCol", @"longCol", @"objectCol"];
+
+    NSMutableDictionary *unmanagedValues = [NSMutableDictionary dictionary];
+    [unmanaged copyValuesForProperties:keys into:unmanagedValues];
+    XCTAssertEqualObjects(unmanagedValues, [unmanaged dictionaryWithValuesForKeys:keys]);
+
+    [realm beginWriteTransaction];
+    AllTypesObject *obj = [AllTypesObject createInRealm:realm withValue:values];
+    [realm commitWriteTransaction];
+
+    NSMutableDictionary *managedValues = [NSMutableDictionary dictionary];
+    [obj copyValuesForProperties:keys into:managedValues];
+    XCTAssertEqualObjects(managedValues, unmanagedValues);
+    XCTAssertEqualObjects(managedValues, [obj dictionaryWithValuesForKeys:keys]);
+    XCTAssertEqualObjects(managedValues[@"objectCol"], NSNull.null);
+    XCTAssertEqualObjects(managedValues[@"dateCol"], date);
+
+    RLMAssertThrowsWithReason([obj copyValuesForProperties:@[@"intCol", @"invalid"] into:managedValues],
+                              @"Invalid property name 'invalid'");
+    XCTAssertEqualObjects([obj dictionaryWithValuesForKeys:@[@"invalidated"]], @{@"invalidated": @NO});
+
+    [realm beginWriteTransaction];
+    [realm deleteObject:obj];
+    [realm commitWriteTransaction];
+    RLMAssertThrowsWithReason([obj copyValuesForProperties:keys into:managedValues], @"invalidated");
+}
+
+- (void)testIncrementProperty {
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    IntObject *unmanaged = [[IntObject alloc] initWithValue:@[@5]];
+    [unmanaged incrementProperty:@"intCol" by:2];
+    XCTAssertEqual(unmanaged.intCol, 7);
+
+    [realm beginWriteTransaction];
+    IntObject *obj = [IntObject createInRealm:realm withValue:@[@1]];
+    AllOptionalTypes *optional = [AllOptionalTypes createInRealm:realm withValue:@{}];
+    PrimaryIntObject *primary = [PrimaryIntObject createInRealm:realm withValue:@[@1]];
+    [obj incrementProperty:@"intCol" by:41];
+    XCTAssertEqual(obj.intCol, 42);
+    [obj incrementProperty:@"intCol" by:-50];
+    XCTAssertEqual(obj.intCol, -8);
+
+    RLMAssertThrowsWithReasonMatching([optional incrementProperty:@"intObj" by:1], @"because it is nil");
+    RLMAssertThrowsWithReasonMatching([optional incrementProperty:@"string" by:1], @"can't be incremented");
+    RLMAssertThrowsWithReasonMatching([obj incrementProperty:@"invalid" by:1], @"Invalid property name");
+    RLMAssertThrowsWithReasonMatching([primary incrementProperty:@"intCol" by:1], @"Primary key");
+    [realm commitWriteTransaction];
+
+    RLMAssertThrowsWithReasonMatching([obj incrementProperty:@"intCol" by:1], @"write transaction");
+    XCTAssertEqual(obj.intCol, -8);
+}
+
+- (void)testDerivedProperties {
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm beginWriteTransaction];
+    DerivedNameObject *obj = [DerivedNameObject createInRealm:realm withValue:@{@"first": @"Ada", @"last": @"Lovelace"}];
+    XCTAssertEqualObjects(obj.searchName, @"ada lovelace");
+    XCTAssertEqual(obj.length, 12);
+
+    obj.last = @"King";
+    XCTAssertEqualObjects(obj.searchName, @"ada king");
+    XCTAssertEqual(obj.length, 8);
+    RLMAssertThrowsWithReasonMatching(obj.searchName = @"x", @"is derived from other properties");
+    RLMAssertThrowsWithReasonMatching(obj[@"length"] = @1, @"is derived from other properties");
+    [realm commitWriteTransaction];
+
+    XCTAssertEqual(1U, [DerivedNameObject objectsWhere:@"searchName = 'ada king'"].count);
+    XCTAssertEqual(0U, [DerivedNameObject objectsWhere:@"searchName = 'ada lovelace'"].count);
+
+    // Unlike index keys, derived values are exported by default
+    NSOutputStream *stream = [NSOutputStream outputStreamToMemory];
+    XCTAssertTrue([[DerivedNameObject allObjectsInRealm:realm] writeCSVToStream:stream properties:nil error:nil]);
+    NSString *csv = [[NSString alloc] initWithData:[stream propertyForKey:NSStreamDataWrittenToMemoryStreamKey]
+                                          encoding:NSUTF8StringEncoding];
+    XCTAssertEqualObjects(csv, @"first,last,searchName,length\r\nAda,King,ada king,8\r\n");
+}
+
+- (void)testDerivedPropertiesRecomputedInMigration {
+    RLMRealmConfiguration *config = [RLMRealmConfiguration defaultConfiguration];
+    config.objectClasses = @[DerivedNameObject.class];
+    @autoreleasepool {
+        RLMRealm *realm = [RLMRealm realmWithConfiguration:config error:nil];
+        [realm transactionWithBlock:^{
+            [DerivedNameObject createInRealm:realm withValue:@{@"first": @"Ada", @"last": @"Lovelace"}];
+        }];
+    }
+
+    config.schemaVersion = 1;
+    config.migrationBlock = ^(RLMMigration *migration, __unused uint64_t oldSchemaVersion) {
+        [migration enumerateObjects:DerivedNameObject.className block:^(__unused RLMObject *oldObject, RLMObject *newObject) {
+            newObject[@"last"] = @"King";
+        }];
+    };
+    RLMRealm *realm = [RLMRealm realmWithConfiguration:config error:nil];
+    DerivedNameObject *obj = [DerivedNameObject allObjectsInRealm:realm].firstObject;
+    XCTAssertEqualObjects(obj.searchName, @"ada king");
+    XCTAssertEqual(obj.length, 8);
+}
+
+- (void)testVectorProperties {
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm beginWriteTransaction];
+    VectorObject *x = [VectorObject createInRealm:realm withValue:@[@"x", RLMTestVector(1, 0, 0)]];
+    [VectorObject createInRealm:realm withValue:@[@"y", RLMTestVector(0, 2, 0)]];
+    [VectorObject createInRealm:realm withValue:@[@"xy", RLMTestVector(3, 3, 0)]];
+    [VectorObject createInRealm:realm withValue:@[@"none", NSNull.null]];
+    [VectorObject createInRealm:realm withValue:@[@"nan", RLMTestVector(NAN, 0, 0)]];
+    RLMAssertThrowsWithReasonMatching([VectorObject createInRealm:realm withValue:@[@"short", [NSData dataWithBytes:"ab" length:2]]],
+                                      @"expected 3 floats");
+    RLMAssertThrowsWithReasonMatching(x.embedding = [NSData data], @"expected 3 floats");
+    [realm commitWriteTransaction];
+
+    RLMResults *objects = [VectorObject allObjectsInRealm:realm];
+    NSArray *nearest = [objects objectsNearestToVector:RLMTestVector(1, 0.5f, 0) forProperty:@"embedding"
+                                                 limit:2 metric:RLMVectorDistanceMetricCosine];
+    XCTAssertEqualObjects([nearest valueForKey:@"name"], (@[@"xy", @"x"]));
+    nearest = [objects objectsNearestToVector:RLMTestVector(1, 0.5f, 0) forProperty:@"embedding"
+                                        limit:10 metric:RLMVectorDistanceMetricEuclidean];
+    XCTAssertEqualObjects([nearest valueForKey:@"name"], (@[@"x", @"y", @"xy"]));
+    XCTAssertEqual([objects objectsNearestToVector:RLMTestVector(1, 0, 0) forProperty:@"embedding"
+                                              limit:0 metric:RLMVectorDistanceMetricCosine].count, 0U);
+    XCTAssertEqual([objects objectsNearestToVector:RLMTestVector(NAN, 0, 0) forProperty:@"embedding"
+                                              limit:10 metric:RLMVectorDistanceMetricEuclidean].count, 0U);
+
+    RLMAssertThrowsWithReasonMatching([objects objectsNearestToVector:[NSData data] forProperty:@"embedding"
+                                                                limit:1 metric:RLMVectorDistanceMetricCosine],
+                                      @"must hold 3 floats");
+    RLMAssertThrowsWithReasonMatching([objects objectsNearestToVector:RLMTestVector(1, 0, 0) forProperty:@"name"
+                                                                limit:1 metric:RLMVectorDistanceMetricCosine],
+                                      @"vectorProperties");
+}
+
+- (void)testDetachedCopy {
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm beginWriteTransaction];
+    CircleObject *first = [CircleObject createInRealm:realm withValue:@[@"a", @[@"b", @[@"c", NSNull.null]]]];
+    first.next.next.next = first;
+    CircleArrayObject *array = [CircleArrayObject createInRealm:realm withValue:@[@[first, first.next, first]]];
+    [realm commitWriteTransaction];
+
+    CircleObject *copy = [first detachedCopy];
+    XCTAssertNil(copy.realm);
+    XCTAssertEqualObjects(copy.data, @"a");
+    XCTAssertEqualObjects(copy.next.data, @"b");
+    XCTAssertEqualObjects(copy.next.next.data, @"c");
+    XCTAssertEqual(copy.next.next.next, copy);
+
+    CircleArrayObject *arrayCopy = [array detachedCopy];
+    XCTAssertEqual(arrayCopy.circles.count, 3U);
+    XCTAssertEqual(arrayCopy.circles[0], arrayCopy.circles[2]);
+    XCTAssertEqual(arrayCopy.circles[0].next, arrayCopy.circles[1]);
+    XCTAssertEqualObjects(arrayCopy.circles[1].data, @"b");
+
+    NSArray *copies = [[[CircleObject allObjectsInRealm:realm] sortedResultsUsingKeyPath:@"data" ascending:YES] detachedCopy];
+    XCTAssertEqual(copies.count, 3U);
+    XCTAssertEqual([copies[0] next], copies[1]);
+    XCTAssertEqual([copies[2] next], copies[0]);
+
+    [realm beginWriteTransaction];
+    first.data = @"changed";
+    [realm commitWriteTransaction];
+    XCTAssertEqualObjects(copy.data, @"a");
+
+    [self dispatchAsyncAndWait:^{
+        XCTAssertEqualObjects(copy.next.next.data, @"c");
+    }];
+
+    RLMAssertThrowsWithReason([copy detachedCopy], @"managed by a Realm");
+    [realm beginWriteTransaction];
+    [realm deleteObject:first];
+    [realm commitWriteTransaction];
+    RLMAssertThrowsWithReason([first detachedCopy], @"invalidated");
+    XCTAssertEqualObjects(copy.data, @"a");
+}
+
+- (void)testInternedStringProperties {
+    XCTAssertTrue(InternedStringObject.sharedSchema[@"status"].internsStrings);
+    XCTAssertFalse(InternedStringObject.sharedSchema[@"name"].internsStrings);
+    RLMAssertThrowsWithReason([RLMObjectSchema schemaForObjectClass:InvalidInternedStringObject.class],
+                              @"not a 'string' property");
+
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm beginWriteTransaction];
+    InternedStringObject *first = [InternedStringObject createInRealm:realm withValue:@[@"active", @"a"]];
+    InternedStringObject *second = [InternedStringObject createInRealm:realm withValue:@[@"active", @"a"]];
+    InternedStringObject *third = [InternedStringObject createInRealm:realm withValue:@[NSNull.null, @"b"]];
+    [realm commitWriteTransaction];
+
+    XCTAssertEqualObjects(first.status, @"active");
+    XCTAssertEqual(first.status, second.status);
+    XCTAssertNil(third.status);
+
+    [realm beginWriteTransaction];
+    second.status = @"inactive";
+    [realm commitWriteTransaction];
+    XCTAssertEqualObjects(second.status, @"inactive");
+    XCTAssertEqualObjects(first.status, @"active");
+}
+
 - (void)testObjectSubclass {
     // test className methods
     XCTAssertEqualObjects(@"StringObject", [StringObject className]);
@@ -603,6 +932,42 @@ static void addProperty(Class cls, const char *name, const char *type, size_t si
     [realm commitWriteTransaction];
 }
 
+- (void)testWithBinaryProperty {
+    NSData *data = [@"binary data" dataUsingEncoding:NSUTF8StringEncoding];
+    BinaryObject *unmanaged = [[BinaryObject alloc] initWithValue:@[data]];
+    __block NSData *read;
+    [unmanaged withBinaryProperty:@"binaryCol" block:^(const void *bytes, NSUInteger length) {
+        read = [NSData dataWithBytes:bytes length:length];
+    }];
+    XCTAssertEqualObjects(read, data);
+
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm beginWriteTransaction];
+    BinaryObject *obj = [BinaryObject createInRealm:realm withValue:@[data]];
+    BinaryObject *nullObj = [BinaryObject createInRealm:realm withValue:@[NSNull.null]];
+    [realm commitWriteTransaction];
+
+    read = nil;
+    [obj withBinaryProperty:@"binaryCol" block:^(const void *bytes, NSUInteger length) {
+        read = [NSData dataWithBytes:bytes length:length];
+    }];
+    XCTAssertEqualObjects(read, data);
+
+    __block BOOL called = NO;
+    [nullObj withBinaryProperty:@"binaryCol" block:^(const void *bytes, NSUInteger length) {
+        XCTAssertTrue(bytes == NULL);
+        XCTAssertEqual(length, 0U);
+        called = YES;
+    }];
+    XCTAssertTrue(called);
+
+    RLMAssertThrowsWithReason([obj withBinaryProperty:@"invalid" block:^(__unused const void *bytes, __unused NSUInteger length) {}],
+                              @"Invalid property name 'invalid' for class 'BinaryObject'.");
+    IntObject *intObj = [[IntObject alloc] init];
+    RLMAssertThrowsWithReason([intObj withBinaryProperty:@"intCol" block:^(__unused const void *bytes, __unused NSUInteger length) {}],
+                              @"Property 'intCol' of 'IntObject' is of type 'int', not 'data'.");
+}
+
 #pragma mark - Default Property Values
 
 - (NSDictionary *)defaultValuesDictionary {
@@ -1012,6 +1377,26 @@ static void addProperty(Class cls, const char *name, const char *type, size_t si
     XCTAssertThrows([obj setObject:@0 forKeyedSubscript:@""]);
 }
 
+- (void)testUnmanagedObjectsOnlyUseAccessorClassWhenNeeded {
+    IntObject *obj = [[IntObject alloc] initWithValue:@[@5]];
+    XCTAssertEqual(object_getClass(obj), IntObject.class);
+    XCTAssertEqual(obj.intCol, 5);
+
+    ArrayPropertyObject *array = [[ArrayPropertyObject alloc] init];
+    XCTAssertNotEqual(object_getClass(array), ArrayPropertyObject.class);
+    XCTAssertTrue([array isKindOfClass:ArrayPropertyObject.class]);
+    XCTAssertNotNil(array.intArray);
+
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm transactionWithBlock:^{
+        [realm addObject:obj];
+        [realm addObject:array];
+    }];
+    XCTAssertFalse(obj.invalidated);
+    XCTAssertEqual([IntObject allObjectsInRealm:realm].count, 1U);
+    XCTAssertEqual([[IntObject allObjectsInRealm:realm].firstObject intCol], 5);
+}
+
 - (void)testEquality {
     IntObject *obj = [[IntObject alloc] init];
     IntObject *otherObj = [[IntObject alloc] init];
@@ -1304,6 +1689,71 @@ static void addProperty(Class cls, const char *name, const char *type, size_t si
                               @"Realm must not be nil");
 }
 
+- (void)testObjectForKeyAfterRowsMove {
+    RLMRealm *realm = RLMRealm.defaultRealm;
+    [realm beginWriteTransaction];
+    PrimaryStringObject *a = [PrimaryStringObject createInRealm:realm withValue:@[@"a", @1]];
+    [PrimaryStringObject createInRealm:realm withValue:@[@"b", @2]];
+    [PrimaryStringObject createInRealm:realm withValue:@[@"c", @3]];
+    [realm commitWriteTransaction];
+
+    XCTAssertEqual(1, [PrimaryStringObject objectForPrimaryKey:@"a"].intCol);
+    XCTAssertEqual(3, [PrimaryStringObject objectForPrimaryKey:@"c"].intCol);
+    XCTAssertNil([PrimaryStringObject objectForPrimaryKey:@"d"]);
+
+    // deleting the first row moves the last one into its place
+    [realm beginWriteTransaction];
+    [realm deleteObject:a];
+    XCTAssertNil([PrimaryStringObject objectForPrimaryKey:@"a"]);
+    XCTAssertEqual(3, [PrimaryStringObject objectForPrimaryKey:@"c"].intCol);
+    [PrimaryStringObject createInRealm:realm withValue:@[@"d", @4]];
+    [realm commitWriteTransaction];
+
+    XCTAssertNil([PrimaryStringObject objectForPrimaryKey:@"a"]);
+    XCTAssertEqual(3, [PrimaryStringObject objectForPrimaryKey:@"c"].intCol);
+    XCTAssertEqual(4, [PrimaryStringObject objectForPrimaryKey:@"d"].intCol);
+
+    // changes made on another thread are seen after refreshing
+    [self dispatchAsyncAndWait:^{
+        RLMRealm *realm = RLMRealm.defaultRealm;
+        [realm beginWriteTransaction];
+        [realm deleteObject:[PrimaryStringObject objectInRealm:realm forPrimaryKey:@"b"]];
+        [PrimaryStringObject createInRealm:realm withValue:@[@"a", @5]];
+        [realm commitWriteTransaction];
+    }];
+    [realm refresh];
+
+    XCTAssertEqual(5, [PrimaryStringObject objectForPrimaryKey:@"a"].intCol);
+    XCTAssertNil([PrimaryStringObject objectForPrimaryKey:@"b"]);
+    XCTAssertEqual(3, [PrimaryStringObject objectForPrimaryKey:@"c"].intCol);
+    XCTAssertEqual(4, [PrimaryStringObject objectForPrimaryKey:@"d"].intCol);
+}
+
+- (void)testObjectsForKeys {
+    [RLMRealm.defaultRealm beginWriteTransaction];
+    PrimaryStringObject *a = [PrimaryStringObject createInDefaultRealmWithValue:@[@"a", @0]];
+    PrimaryStringObject *b = [PrimaryStringObject createInDefaultRealmWithValue:@[@"b", @1]];
+    PrimaryNullableIntObject *nonNullIntObj = [PrimaryNullableIntObject createInDefaultRealmWithValue:@[@0]];
+    PrimaryNullableIntObject *nullIntObj = [PrimaryNullableIntObject createInDefaultRealmWithValue:@[NSNull.null]];
+    [RLMRealm.defaultRealm commitWriteTransaction];
+
+    // objects are returned in key order, skipping missing keys
+    XCTAssertEqualObjects((@[b, a]), [PrimaryStringObject objectsForPrimaryKeys:@[@"b", @"missing", @"a"]]);
+    XCTAssertEqualObjects((@[a, a]), [PrimaryStringObject objectsForPrimaryKeys:@[@"a", @"a"]]);
+    XCTAssertEqualObjects(@[], [PrimaryStringObject objectsForPrimaryKeys:@[]]);
+    XCTAssertEqualObjects((@[nullIntObj, nonNullIntObj]),
+                          [PrimaryNullableIntObject objectsForPrimaryKeys:@[NSNull.null, @0, @1]]);
+
+    RLMAssertThrowsWithReason([StringObject objectsForPrimaryKeys:@[@""]],
+                              @"does not have a primary key");
+    RLMAssertThrowsWithReasonMatching([PrimaryStringObject objectsForPrimaryKeys:(@[@"a", @0])],
+                                      @"Invalid value '0' of type '.*Number.*' for string");
+    RLMAssertThrowsWithReason([PrimaryStringObject objectsForPrimaryKeys:@[NSNull.null]],
+                              @"Invalid null value for non-nullable primary key.");
+    RLMAssertThrowsWithReason([PrimaryIntObject objectsInRealm:self.nonLiteralNil forPrimaryKeys:@[@0]],
+                              @"Realm must not be nil");
+}
+
 - (void)testClassExtension {
     RLMRealm *realm = [RLMRealm defaultRealm];
 
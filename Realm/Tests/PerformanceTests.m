@@ -21,8 +21,160 @@
 #import "RLMRealm_Dynamic.h"
 #import "RLMRealm_Private.h"
 
+#import <mach/mach.h>
+#import <malloc/malloc.h>
+#import <sys/resource.h>
+
 #if !DEBUG && TARGET_OS_IPHONE && !TARGET_IPHONE_SIMULATOR
 
+#pragma mark - Benchmark models
+
+// Models for the macrobenchmarks, shaped like the models of a typical app
+// rather than the single-column objects used by the microbenchmarks
+
+@interface BenchmarkCompany : RLMObject
+@property NSString *name;
+@property NSString *country;
+@end
+
+@implementation BenchmarkCompany
+@end
+
+@interface BenchmarkTag : RLMObject
+@property NSString *name;
+@end
+
+@implementation BenchmarkTag
+@end
+
+RLM_ARRAY_TYPE(BenchmarkTag)
+
+@interface BenchmarkEmployee : RLMObject
+@property NSString *employeeId;
+@property NSString *firstName;
+@property NSString *lastName;
+@property NSString *email;
+@property NSString *department;
+@property NSString *title;
+@property NSString *phone;
+@property NSString *city;
+@property NSString *notes;
+@property int age;
+@property int level;
+@property NSInteger employeeNumber;
+@property double salary;
+@property double rating;
+@property float score;
+@property BOOL active;
+@property BOOL remote;
+@property NSDate *hiredAt;
+@property NSDate *updatedAt;
+@property NSData *avatar;
+@property NSNumber<RLMInt> *managerNumber;
+@property BenchmarkCompany *company;
+@property RLMArray<BenchmarkTag *><BenchmarkTag> *tags;
+@end
+
+@implementation BenchmarkEmployee
++ (NSString *)primaryKey {
+    return @"employeeId";
+}
+
++ (NSArray *)indexedProperties {
+    return @[@"email", @"department", @"lastName"];
+}
+@end
+
+// The number of employees in the macrobenchmarks' Realms. Defaults to 10,000
+// and can be set with REALM_BENCHMARK_ROWS to run at other scales.
+static NSUInteger benchmarkRowCount() {
+    const char *rows = getenv("REALM_BENCHMARK_ROWS");
+    return rows ? (NSUInteger)strtoull(rows, NULL, 10) : 10000;
+}
+
+static NSString *const s_benchmarkDepartments[] = {@"Engineering", @"Sales", @"Support", @"Marketing",
+                                                   @"Finance", @"Legal", @"Operations", @"Research"};
+static const NSUInteger s_benchmarkDepartmentCount = sizeof(s_benchmarkDepartments) / sizeof(s_benchmarkDepartments[0]);
+
+static NSDictionary *benchmarkEmployeeValue(NSUInteger i, NSArray *companies, NSArray *tags, int level) {
+    return @{@"employeeId": @(i).stringValue,
+             @"firstName": [NSString stringWithFormat:@"First %lu", (unsigned long)(i % 500)],
+             @"lastName": [NSString stringWithFormat:@"Last %lu", (unsigned long)(i * 7919 % 10000)],
+             @"email": [NSString stringWithFormat:@"employee%lu@example.com", (unsigned long)i],
+             @"department": s_benchmarkDepartments[i % s_benchmarkDepartmentCount],
+             @"title": i % 10 == 0 ? @"Manager" : @"Individual Contributor",
+             @"phone": [NSString stringWithFormat:@"+1 555 %07lu", (unsigned long)i],
+             @"city": i % 3 == 0 ? @"Copenhagen" : @"San Francisco",
+             @"notes": @"Lorem ipsum dolor sit amet, consectetur adipiscing elit.",
+             @"age": @(20 + i % 45),
+             @"level": @(level),
+             @"employeeNumber": @(i),
+             @"salary": @(50000.0 + (i * 37 % 100000)),
+             @"rating": @((i % 50) / 10.0),
+             @"score": @((float)(i % 100)),
+             @"active": @(i % 4 != 0),
+             @"remote": @(i % 5 == 0),
+             @"hiredAt": [NSDate dateWithTimeIntervalSince1970:(double)i * 3600],
+             @"updatedAt": [NSDate dateWithTimeIntervalSince1970:(double)i * 60],
+             @"avatar": [NSData dataWithBytes:&i length:sizeof(i)],
+             @"managerNumber": i % 10 == 0 ? (id)NSNull.null : @(i - i % 10),
+             @"company": companies[i % companies.count],
+             @"tags": @[tags[i % tags.count], tags[(i + 7) % tags.count], tags[(i + 13) % tags.count]]};
+}
+
+// Duration of each measured iteration of the macrobenchmarks, keyed by test
+// name, which are written out as JSON if REALM_BENCHMARK_OUTPUT is set
+static NSMutableDictionary<NSString *, NSMutableArray<NSNumber *> *> *s_benchmarkResults;
+// Growth in the physical footprint and in the number of live heap allocations
+// over each measured iteration, keyed by test name
+static NSMutableDictionary<NSString *, NSDictionary *> *s_benchmarkMemory;
+
+static uint64_t benchmarkPhysicalFootprint() {
+    task_vm_info_data_t info;
+    mach_msg_type_number_t count = TASK_VM_INFO_COUNT;
+    if (task_info(mach_task_self(), TASK_VM_INFO, (task_info_t)&info, &count) != KERN_SUCCESS) {
+        return 0;
+    }
+    return info.phys_footprint;
+}
+
+static size_t benchmarkLiveAllocations() {
+    malloc_statistics_t stats;
+    malloc_zone_statistics(NULL, &stats);
+    return stats.blocks_in_use;
+}
+
+// Results of an earlier run, as written to REALM_BENCHMARK_OUTPUT, to compare
+// this run against if REALM_BENCHMARK_BASELINE is set to their path. A
+// benchmark fails if its mean is more than REALM_BENCHMARK_TOLERANCE (default
+// 0.25, i.e. 25%) slower than the baseline's, ignoring differences of under
+// 100µs which are within the noise of the quickest benchmarks.
+static NSDictionary<NSString *, NSDictionary *> *benchmarkBaseline() {
+    static NSDictionary *baseline;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        const char *path = getenv("REALM_BENCHMARK_BASELINE");
+        NSData *data = path ? [NSData dataWithContentsOfFile:@(path)] : nil;
+        if (data) {
+            baseline = [NSJSONSerialization JSONObjectWithData:data options:0 error:nil][@"results"];
+        }
+    });
+    return baseline;
+}
+
+static double benchmarkTolerance() {
+    const char *tolerance = getenv("REALM_BENCHMARK_TOLERANCE");
+    return tolerance ? strtod(tolerance, NULL) : 0.25;
+}
+
+static const double s_benchmarkMinimumRegression = 0.0001;
+
+static long long benchmarkPeakResidentSize() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss; // in bytes on Darwin
+}
+
 @interface PerformanceTests : RLMTestCase
 @property (nonatomic) dispatch_queue_t queue;
 @property (nonatomic) dispatch_semaphore_t sema;
@@ -41,6 +193,22 @@ static RLMRealm *s_smallRealm, *s_mediumRealm, *s_largeRealm;
 }
 
 + (void)tearDown {
+    const char *outputPath = getenv("REALM_BENCHMARK_OUTPUT");
+    if (outputPath) {
+        NSMutableDictionary *results = [NSMutableDictionary dictionary];
+        [s_benchmarkResults enumerateKeysAndObjectsUsingBlock:^(NSString *name, NSArray<NSNumber *> *samples, __unused BOOL *stop) {
+            results[name] = @{@"mean": [samples valueForKeyPath:@"@avg.self"],
+                              @"min": [samples valueForKeyPath:@"@min.self"],
+                              @"max": [samples valueForKeyPath:@"@max.self"],
+                              @"samples": samples};
+        }];
+        NSData *json = [NSJSONSerialization dataWithJSONObject:@{@"rows": @(benchmarkRowCount()),
+                                                                 @"peakResidentSize": @(benchmarkPeakResidentSize()),
+                                                                 @"results": results,
+                                                                 @"memory": s_benchmarkMemory ?: @{}}
+                                                       options:NSJSONWritingPrettyPrinted error:nil];
+        [json writeToFile:@(outputPath) atomically:YES];
+    }
     s_smallRealm = s_mediumRealm = s_largeRealm = nil;
     [RLMRealm resetRealmState];
     [super tearDown];
@@ -699,6 +867,378 @@ static RLMRealm *s_smallRealm, *s_mediumRealm, *s_largeRealm;
     }];
 }
 
+#pragma mark - Macrobenchmarks
+
+// Measure `block`, running `setUp` before each iteration without measuring it,
+// and record the durations for the JSON output
+- (void)benchmarkWithSetUp:(void (^)(void))setUp block:(void (^)(void))block {
+    NSString *name = NSStringFromSelector(self.invocation.selector);
+    NSMutableArray<NSNumber *> *samples = [NSMutableArray array];
+    NSMutableArray<NSNumber *> *footprintGrowth = [NSMutableArray array];
+    NSMutableArray<NSNumber *> *allocationGrowth = [NSMutableArray array];
+    [self measureMetrics:self.class.defaultPerformanceMetrics automaticallyStartMeasuring:NO forBlock:^{
+        if (setUp) {
+            setUp();
+        }
+        uint64_t footprint = benchmarkPhysicalFootprint();
+        size_t allocations = benchmarkLiveAllocations();
+        [self startMeasuring];
+        CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+        block();
+        [samples addObject:@(CFAbsoluteTimeGetCurrent() - start)];
+        [self stopMeasuring];
+        [footprintGrowth addObject:@((int64_t)benchmarkPhysicalFootprint() - (int64_t)footprint)];
+        [allocationGrowth addObject:@((int64_t)benchmarkLiveAllocations() - (int64_t)allocations)];
+    }];
+    [self recordBenchmark:name samples:samples];
+    s_benchmarkMemory[name] = @{@"footprintGrowth": footprintGrowth, @"liveAllocationGrowth": allocationGrowth};
+}
+
+// Record the durations for the JSON output, and check them against the
+// baseline if there is one
+- (void)recordBenchmark:(NSString *)name samples:(NSArray<NSNumber *> *)samples {
+    if (!s_benchmarkResults) {
+        s_benchmarkResults = [NSMutableDictionary dictionary];
+        s_benchmarkMemory = [NSMutableDictionary dictionary];
+    }
+    s_benchmarkResults[name] = [samples mutableCopy];
+
+    NSNumber *baseline = benchmarkBaseline()[name][@"mean"];
+    if (!baseline) {
+        return;
+    }
+    double mean = [[samples valueForKeyPath:@"@avg.self"] doubleValue];
+    double limit = baseline.doubleValue * (1 + benchmarkTolerance());
+    XCTAssertFalse(mean > limit && mean - baseline.doubleValue > s_benchmarkMinimumRegression,
+                   @"%@ regressed: mean of %.6fs is more than %.0f%% slower than the baseline of %.6fs",
+                   name, mean, benchmarkTolerance() * 100, baseline.doubleValue);
+}
+
+- (void)populateBenchmarkRealm:(RLMRealm *)realm rows:(NSUInteger)rows {
+    [realm beginWriteTransaction];
+    NSMutableArray *companies = [NSMutableArray array];
+    for (int i = 0; i < 10; ++i) {
+        [companies addObject:[BenchmarkCompany createInRealm:realm withValue:@[[NSString stringWithFormat:@"Company %d", i], @"DK"]]];
+    }
+    NSMutableArray *tags = [NSMutableArray array];
+    for (int i = 0; i < 20; ++i) {
+        [tags addObject:[BenchmarkTag createInRealm:realm withValue:@[[NSString stringWithFormat:@"tag%d", i]]]];
+    }
+    for (NSUInteger i = 0; i < rows; ++i) {
+        [BenchmarkEmployee createInRealm:realm withValue:benchmarkEmployeeValue(i, companies, tags, 0)];
+    }
+    [realm commitWriteTransaction];
+}
+
+- (RLMRealm *)benchmarkRealm {
+    RLMRealm *realm = self.realmWithTestPath;
+    if ([BenchmarkEmployee allObjectsInRealm:realm].count == 0) {
+        [self populateBenchmarkRealm:realm rows:benchmarkRowCount()];
+    }
+    return realm;
+}
+
+- (void)testBenchmarkIngest {
+    __block RLMRealm *realm;
+    [self benchmarkWithSetUp:^{
+        realm = nil;
+        [self tearDown];
+        realm = self.realmWithTestPath;
+    } block:^{
+        [self populateBenchmarkRealm:realm rows:benchmarkRowCount()];
+    }];
+    realm = nil;
+    [self tearDown];
+}
+
+- (void)testBenchmarkUpsert {
+    RLMRealm *realm = self.benchmarkRealm;
+    NSArray *companies = [self arrayFromResults:[BenchmarkCompany allObjectsInRealm:realm]];
+    NSArray *tags = [self arrayFromResults:[BenchmarkTag allObjectsInRealm:realm]];
+    NSUInteger rows = benchmarkRowCount();
+    __block int level = 0;
+    [self benchmarkWithSetUp:nil block:^{
+        ++level;
+        [realm beginWriteTransaction];
+        // Update every other existing employee and add a tenth as many new ones
+        for (NSUInteger i = 0; i < rows + rows / 10; i += 2) {
+            [BenchmarkEmployee createOrUpdateInRealm:realm withValue:benchmarkEmployeeValue(i, companies, tags, level)];
+        }
+        [realm commitWriteTransaction];
+    }];
+    [self tearDown];
+}
+
+- (void)testBenchmarkFilteredSortedQuery {
+    RLMRealm *realm = self.benchmarkRealm;
+    [self benchmarkWithSetUp:nil block:^{
+        for (NSUInteger d = 0; d < s_benchmarkDepartmentCount; ++d) {
+            NSString *department = s_benchmarkDepartments[d];
+            RLMResults *results = [[BenchmarkEmployee objectsInRealm:realm
+                                                               where:@"active = YES AND department = %@ AND salary > 75000 AND ANY tags.name = 'tag3'",
+                                    department]
+                                   sortedResultsUsingKeyPath:@"lastName" ascending:YES];
+            NSUInteger count = MIN(results.count, 50U);
+            for (NSUInteger i = 0; i < count; ++i) {
+                BenchmarkEmployee *employee = results[i];
+                (void)employee.firstName;
+                (void)employee.lastName;
+                (void)employee.company.name;
+            }
+        }
+    }];
+    [self tearDown];
+}
+
+- (void)testBenchmarkScrollRandomAccess {
+    RLMRealm *realm = self.benchmarkRealm;
+    RLMResults *results = [[BenchmarkEmployee allObjectsInRealm:realm] sortedResultsUsingKeyPath:@"lastName" ascending:YES];
+    NSUInteger count = results.count;
+    [self benchmarkWithSetUp:nil block:^{
+        // Simulate a table view jumping around the list and displaying a
+        // screenful of cells at each position
+        srand(1);
+        for (int jump = 0; jump < 100; ++jump) {
+            NSUInteger position = (NSUInteger)rand() % count;
+            for (NSUInteger i = position; i < MIN(position + 20, count); ++i) {
+                BenchmarkEmployee *employee = results[i];
+                (void)employee.firstName;
+                (void)employee.lastName;
+                (void)employee.title;
+                (void)employee.avatar;
+                (void)employee.company.name;
+                (void)employee.tags.count;
+            }
+        }
+    }];
+    [self tearDown];
+}
+
+- (void)testBenchmarkNotificationFanOut {
+    RLMRealm *realm = self.benchmarkRealm;
+    const int observerCount = 20;
+    __block int remaining = observerCount;
+    NSMutableArray *tokens = [NSMutableArray array];
+    for (int i = 0; i < observerCount; ++i) {
+        RLMResults *results = [BenchmarkEmployee objectsInRealm:realm where:@"department = %@ AND age > %d",
+                               s_benchmarkDepartments[i % s_benchmarkDepartmentCount], 20 + i];
+        [tokens addObject:[results addNotificationBlock:^(__unused RLMResults *results, __unused RLMCollectionChange *change, __unused NSError *error) {
+            if (--remaining == 0) {
+                CFRunLoopStop(CFRunLoopGetCurrent());
+            }
+        }]];
+    }
+    // Wait for the initial notifications so that they aren't merged with the
+    // first measured ones
+    remaining = observerCount;
+    CFRunLoopRun();
+    RLMResults *all = [BenchmarkEmployee allObjectsInRealm:realm];
+    __block int level = 0;
+    [self benchmarkWithSetUp:nil block:^{
+        remaining = observerCount;
+        [realm beginWriteTransaction];
+        ++level;
+        for (NSUInteger i = 0; i < all.count; i += 97) {
+            BenchmarkEmployee *employee = all[i];
+            employee.age = 20 + (employee.age + level) % 45;
+        }
+        [realm commitWriteTransaction];
+        CFRunLoopRun();
+    }];
+    [tokens makeObjectsPerformSelector:@selector(stop)];
+    [self tearDown];
+}
+
+- (void)testBenchmarkMigration {
+    @autoreleasepool {
+        [self benchmarkRealm];
+    }
+    __block uint64_t schemaVersion = 0;
+    [self benchmarkWithSetUp:nil block:^{
+        RLMRealmConfiguration *config = [RLMRealmConfiguration defaultConfiguration];
+        config.fileURL = RLMTestRealmURL();
+        config.schemaVersion = ++schemaVersion;
+        config.migrationBlock = ^(RLMMigration *migration, __unused uint64_t oldSchemaVersion) {
+            [migration enumerateObjects:BenchmarkEmployee.className block:^(__unused RLMObject *oldObject, RLMObject *newObject) {
+                newObject[@"level"] = @([newObject[@"level"] intValue] + 1);
+                newObject[@"notes"] = [newObject[@"notes"] uppercaseString];
+            }];
+        };
+        @autoreleasepool {
+            [RLMRealm realmWithConfiguration:config error:nil];
+        }
+    }];
+    [self tearDown];
+}
+
+- (void)testBenchmarkObservationInfoMemory {
+    RLMRealm *realm = self.benchmarkRealm;
+    RLMResults *all = [BenchmarkEmployee allObjectsInRealm:realm];
+    NSUInteger count = MIN(all.count, 1000U);
+    NSObject *observer = [NSObject new];
+    [self benchmarkWithSetUp:nil block:^{
+        // Each observed accessor gets an RLMObservationInfo, so this measures
+        // how much observing a screenful of objects at a time costs
+        NSMutableArray *observed = [NSMutableArray arrayWithCapacity:count];
+        for (NSUInteger i = 0; i < count; ++i) {
+            BenchmarkEmployee *employee = all[i];
+            [employee addObserver:observer forKeyPath:@"age" options:0 context:nil];
+            [observed addObject:employee];
+        }
+        for (BenchmarkEmployee *employee in observed) {
+            [employee removeObserver:observer forKeyPath:@"age"];
+        }
+    }];
+    [self tearDown];
+}
+
+- (void)testBenchmarkPinnedVersionFileGrowth {
+    RLMRealm *realm = self.benchmarkRealm;
+    NSString *path = realm.configuration.fileURL.path;
+    unsigned long long initialSize = [NSFileManager.defaultManager attributesOfItemAtPath:path error:nil].fileSize;
+
+    // Pin the current version on a background thread while the main thread
+    // keeps writing, which prevents the file from reusing the freed space
+    dispatch_semaphore_t pinned = dispatch_semaphore_create(0);
+    dispatch_semaphore_t done = dispatch_semaphore_create(0);
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        @autoreleasepool {
+            RLMRealm *pinnedRealm = self.realmWithTestPath;
+            (void)[BenchmarkEmployee allObjectsInRealm:pinnedRealm].count;
+            dispatch_semaphore_signal(pinned);
+            dispatch_semaphore_wait(done, DISPATCH_TIME_FOREVER);
+        }
+    });
+    dispatch_semaphore_wait(pinned, DISPATCH_TIME_FOREVER);
+
+    RLMResults *all = [BenchmarkEmployee allObjectsInRealm:realm];
+    __block int level = 0;
+    [self benchmarkWithSetUp:nil block:^{
+        for (int i = 0; i < 10; ++i) {
+            [realm beginWriteTransaction];
+            ++level;
+            for (NSUInteger j = 0; j < all.count; j += 10) {
+                BenchmarkEmployee *employee = all[j];
+                employee.level = level;
+                employee.notes = [NSString stringWithFormat:@"Revision %d", level];
+            }
+            [realm commitWriteTransaction];
+        }
+    }];
+    dispatch_semaphore_signal(done);
+
+    unsigned long long finalSize = [NSFileManager.defaultManager attributesOfItemAtPath:path error:nil].fileSize;
+    NSLog(@"Pinned version file growth: %llu bytes", finalSize - initialSize);
+    [self tearDown];
+}
+
+// The predicates of the query benchmark matrix for a Realm populated with
+// `rows` employees, keyed by a name identifying the query path they exercise.
+// Together they cover each kind of comparison in RLMQueryUtil.mm: numeric,
+// boolean, date and string columns, indexed and not, with the [c] and [d]
+// options, through links and lists, and SUBQUERY, collection operators and IN
+// of several sizes.
+static NSDictionary<NSString *, NSPredicate *> *benchmarkQueryMatrix(NSUInteger rows) {
+    NSDate *middle = [NSDate dateWithTimeIntervalSince1970:(double)rows * 1800];
+    NSMutableDictionary *predicates = [@{
+        @"int.equal": [NSPredicate predicateWithFormat:@"age == 30"],
+        @"int.range": [NSPredicate predicateWithFormat:@"age BETWEEN {25, 35}"],
+        @"int.notEqual": [NSPredicate predicateWithFormat:@"level != 1"],
+        @"int.optionalNil": [NSPredicate predicateWithFormat:@"managerNumber == nil"],
+        @"int.columnComparison": [NSPredicate predicateWithFormat:@"age < level"],
+        @"double.greater": [NSPredicate predicateWithFormat:@"salary > 75000"],
+        @"float.less": [NSPredicate predicateWithFormat:@"score < 50"],
+        @"bool.equal": [NSPredicate predicateWithFormat:@"active == YES"],
+        @"date.greater": [NSPredicate predicateWithFormat:@"hiredAt > %@", middle],
+        @"date.range": [NSPredicate predicateWithFormat:@"hiredAt BETWEEN %@",
+                        @[[NSDate dateWithTimeIntervalSince1970:0], middle]],
+        @"string.equal": [NSPredicate predicateWithFormat:@"firstName == 'First 42'"],
+        @"string.equal.indexed": [NSPredicate predicateWithFormat:@"lastName == 'Last 42'"],
+        @"string.equal.c": [NSPredicate predicateWithFormat:@"firstName ==[c] 'first 42'"],
+        @"string.equal.c.indexed": [NSPredicate predicateWithFormat:@"lastName ==[c] 'last 42'"],
+        @"string.equal.d": [NSPredicate predicateWithFormat:@"firstName ==[d] 'Fírst 42'"],
+        @"string.equal.cd": [NSPredicate predicateWithFormat:@"firstName ==[cd] 'fírst 42'"],
+        @"string.notEqual.indexed": [NSPredicate predicateWithFormat:@"department != 'Sales'"],
+        @"string.beginsWith": [NSPredicate predicateWithFormat:@"email BEGINSWITH 'employee1'"],
+        @"string.beginsWith.c": [NSPredicate predicateWithFormat:@"email BEGINSWITH[c] 'EMPLOYEE1'"],
+        @"string.endsWith": [NSPredicate predicateWithFormat:@"phone ENDSWITH '7'"],
+        @"string.contains": [NSPredicate predicateWithFormat:@"notes CONTAINS 'dolor'"],
+        @"string.contains.cd": [NSPredicate predicateWithFormat:@"notes CONTAINS[cd] 'DÓLOR'"],
+        @"string.like": [NSPredicate predicateWithFormat:@"email LIKE 'employee?2*'"],
+        @"link.string": [NSPredicate predicateWithFormat:@"company.name == 'Company 3'"],
+        @"link.string.c": [NSPredicate predicateWithFormat:@"company.name ==[c] 'company 3'"],
+        @"list.any.string": [NSPredicate predicateWithFormat:@"ANY tags.name == 'tag3'"],
+        @"list.any.beginsWith.c": [NSPredicate predicateWithFormat:@"ANY tags.name BEGINSWITH[c] 'TAG1'"],
+        @"list.subquery": [NSPredicate predicateWithFormat:@"SUBQUERY(tags, $tag, $tag.name BEGINSWITH 'tag1').@count > 1"],
+        @"list.count": [NSPredicate predicateWithFormat:@"tags.@count == 3"],
+        @"compound.and": [NSPredicate predicateWithFormat:@"active == YES AND department == 'Sales' AND salary > 75000"],
+        @"compound.or": [NSPredicate predicateWithFormat:@"age == 30 OR city == 'Copenhagen' OR remote == YES"],
+        @"compound.not": [NSPredicate predicateWithFormat:@"NOT (department == 'Sales' OR age > 40)"],
+    } mutableCopy];
+
+    for (NSUInteger size = 1; size <= 1000; size *= 10) {
+        NSMutableArray *numbers = [NSMutableArray arrayWithCapacity:size];
+        NSMutableArray *emails = [NSMutableArray arrayWithCapacity:size];
+        for (NSUInteger i = 0; i < size; ++i) {
+            NSUInteger value = i * 7 % MAX(rows, 1U);
+            [numbers addObject:@(value)];
+            [emails addObject:[NSString stringWithFormat:@"employee%lu@example.com", (unsigned long)value]];
+        }
+        predicates[[NSString stringWithFormat:@"in.int.%lu", (unsigned long)size]] =
+            [NSPredicate predicateWithFormat:@"employeeNumber IN %@", numbers];
+        predicates[[NSString stringWithFormat:@"in.string.indexed.%lu", (unsigned long)size]] =
+            [NSPredicate predicateWithFormat:@"email IN %@", emails];
+    }
+    return predicates;
+}
+
+// Measure building and then evaluating each query of the matrix at 1%, 10%
+// and 100% of the benchmark row count, recording the two separately as
+// queryMatrix.<rows>.<query>.build and .evaluate
+- (void)testBenchmarkQueryMatrix {
+    const int iterations = 5;
+    NSUInteger rowCount = benchmarkRowCount();
+    NSUInteger sizes[] = {MAX(rowCount / 100, 1U), MAX(rowCount / 10, 1U), rowCount};
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+        @autoreleasepool {
+            NSUInteger rows = sizes[s];
+            RLMRealmConfiguration *config = [RLMRealmConfiguration new];
+            config.inMemoryIdentifier = [NSString stringWithFormat:@"queryMatrix%lu", (unsigned long)rows];
+            RLMRealm *realm = [RLMRealm realmWithConfiguration:config error:nil];
+            [self populateBenchmarkRealm:realm rows:rows];
+
+            [benchmarkQueryMatrix(rows) enumerateKeysAndObjectsUsingBlock:^(NSString *query, NSPredicate *predicate, __unused BOOL *stop) {
+                NSMutableArray<NSNumber *> *build = [NSMutableArray arrayWithCapacity:iterations];
+                NSMutableArray<NSNumber *> *evaluate = [NSMutableArray arrayWithCapacity:iterations];
+                for (int i = 0; i < iterations; ++i) {
+                    @autoreleasepool {
+                        CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+                        RLMResults *results = [BenchmarkEmployee objectsInRealm:realm withPredicate:predicate];
+                        CFAbsoluteTime built = CFAbsoluteTimeGetCurrent();
+                        NSUInteger count = results.count;
+                        CFAbsoluteTime evaluated = CFAbsoluteTimeGetCurrent();
+                        XCTAssertLessThanOrEqual(count, rows);
+                        [build addObject:@(built - start)];
+                        [evaluate addObject:@(evaluated - built)];
+                    }
+                }
+                NSString *name = [NSString stringWithFormat:@"queryMatrix.%lu.%@", (unsigned long)rows, query];
+                [self recordBenchmark:[name stringByAppendingString:@".build"] samples:build];
+                [self recordBenchmark:[name stringByAppendingString:@".evaluate"] samples:evaluate];
+            }];
+        }
+    }
+    [self tearDown];
+}
+
+- (NSArray *)arrayFromResults:(RLMResults *)results {
+    NSMutableArray *array = [NSMutableArray arrayWithCapacity:results.count];
+    for (id obj in results) {
+        [array addObject:obj];
+    }
+    return array;
+}
+
 - (void)observeObject:(RLMObject *)object keyPath:(NSString *)keyPath until:(int (^)(id))block {
     self.sema = dispatch_semaphore_create(0);
     self.queue = dispatch_queue_create("bg", 0);
@@ -99,6 +99,49 @@
     }
 }
 
+- (void)testSchemaCacheRepresentationRoundTrip {
+    RLMObjectSchema *objectSchema = [RLMObjectSchema schemaForObjectClass:[AllTypesObject class]];
+    for (RLMProperty *property in objectSchema.properties) {
+        RLMProperty *copy = [[RLMProperty alloc] initWithSchemaCacheRepresentation:property.schemaCacheRepresentation
+                                                                        objectClass:[AllTypesObject class]];
+        XCTAssertEqualObjects(copy, property);
+        XCTAssertEqualObjects(copy.getterName, property.getterName);
+        XCTAssertEqualObjects(copy.setterName, property.setterName);
+        XCTAssertEqual(copy.getterSel, property.getterSel);
+        XCTAssertEqual(copy.setterSel, property.setterSel);
+        XCTAssertEqual(copy.swiftIvar, property.swiftIvar);
+    }
+
+    XCTAssertNil([[RLMProperty alloc] initWithSchemaCacheRepresentation:@{} objectClass:[AllTypesObject class]]);
+    XCTAssertNil([[RLMProperty alloc] initWithSchemaCacheRepresentation:@{@"name": @"notAnIvar", @"swiftIvarOffset": @8}
+                                                            objectClass:[AllTypesObject class]]);
+}
+
+- (void)testSchemaFromCachedPropertiesKeepsClassMetadata {
+    // The second schema for each class is built from the properties cached
+    // for the first, so the metadata set from the class methods must match
+    for (NSString *className in @[@"FoldedStringObject", @"TimelineObject", @"GeoIndexedObject",
+                                  @"CollatedObject", @"VectorObject", @"PrimaryStringObject"]) {
+        Class cls = NSClassFromString(className);
+        RLMObjectSchema *introspected = [RLMObjectSchema schemaForObjectClass:cls];
+        RLMObjectSchema *cached = [RLMObjectSchema schemaForObjectClass:cls];
+        XCTAssertTrue([cached isEqualToObjectSchema:introspected]);
+        for (RLMProperty *property in introspected.properties) {
+            RLMProperty *copy = cached[property.name];
+            XCTAssertEqualObjects(copy, property);
+            XCTAssertEqualObjects(copy.foldedPropertyName, property.foldedPropertyName);
+            XCTAssertEqual(copy.isFolded, property.isFolded);
+            XCTAssertEqualObjects(copy.compoundIndexComponents, property.compoundIndexComponents);
+            XCTAssertEqualObjects(copy.compoundIndexKeyNames, property.compoundIndexKeyNames);
+            XCTAssertEqualObjects(copy.geoIndexCoordinateNames, property.geoIndexCoordinateNames);
+            XCTAssertEqualObjects(copy.geoIndexKeyNames, property.geoIndexKeyNames);
+            XCTAssertEqualObjects(copy.collationKeyName, property.collationKeyName);
+            XCTAssertEqualObjects(copy.collationSourceName, property.collationSourceName);
+            XCTAssertEqual(copy.vectorDimension, property.vectorDimension);
+        }
+    }
+}
+
 - (void)testTwoPropertiesAreEqual {
     const char *name = "intCol";
     objc_property_t objcProperty1 = class_getProperty(AllTypesObject.class, name);
@@ -22,6 +22,7 @@
 #import "RLMRealmConfiguration_Private.h"
 #import "RLMRealm_Dynamic.h"
 #import "RLMSchema_Private.h"
+#import "RLMThreadSafeReference.h"
 
 #pragma mark - Test Objects
 
@@ -107,6 +108,66 @@
 @implementation NullQueryObject
 @end
 
+@interface FoldedStringObject : RLMObject
+@property NSString *name;
+@property NSString *foldedName;
+@end
+
+@implementation FoldedStringObject
++ (NSDictionary *)foldedIndexedProperties {
+    return @{@"name": @"foldedName"};
+}
+@end
+
+@interface TimelineObject : RLMObject
+@property int accountId;
+@property BOOL deleted;
+@property NSString *title;
+@property NSDate *timestamp;
+@property NSString *accountKey;
+@end
+
+@implementation TimelineObject
++ (NSDictionary *)compoundIndexes {
+    return @{@"accountKey": @[@"accountId", @"deleted"]};
+}
+@end
+
+@interface IndexedRangeObject : RLMObject
+@property int intCol;
+@property NSNumber<RLMInt> *optIntCol;
+@property NSDate *dateCol;
+@end
+
+@implementation IndexedRangeObject
++ (NSArray *)indexedProperties {
+    return @[@"intCol", @"optIntCol", @"dateCol"];
+}
+@end
+
+@interface GeoIndexedObject : RLMObject
+@property double lat;
+@property double lng;
+@property NSNumber<RLMInt> *cell;
+@end
+
+@implementation GeoIndexedObject
++ (NSDictionary *)geoIndexes {
+    return @{@"cell": @[@"lat", @"lng"]};
+}
+@end
+
+@interface CollatedObject : RLMObject
+@property NSString *name;
+@property NSString *nameKey;
+@end
+
+@implementation CollatedObject
++ (NSDictionary *)collationKeys {
+    return @{@"nameKey": @"name"};
+}
+@end
+
 #pragma mark - Tests
 
 #define RLMAssertCount(cls, expectedCount, ...) \
@@ -144,6 +205,39 @@
 #pragma clang diagnostic pop
 }
 
+- (void)testPreparedQuery
+{
+    RLMRealm *realm = [self realm];
+
+    [realm beginWriteTransaction];
+    [PersonObject createInRealm:realm withValue:@[@"Fiel", @27]];
+    [PersonObject createInRealm:realm withValue:@[@"Ari", @33]];
+    [PersonObject createInRealm:realm withValue:@[@"Tim", @29]];
+    [PersonObject createInRealm:realm withValue:@[@"Al$0", @40]];
+    [realm commitWriteTransaction];
+
+    RLMPreparedQuery *query = [realm prepareQuery:@"age > $0 AND name BEGINSWITH $1" forClass:@"PersonObject"];
+    XCTAssertEqualObjects(query.className, @"PersonObject");
+    XCTAssertEqual(query.argumentCount, 2U);
+    XCTAssertEqual([query resultsWithArguments:@[@30, @"A"]].count, 2U);
+    XCTAssertEqual([query resultsWithArguments:@[@35, @"A"]].count, 1U);
+    XCTAssertEqual([query resultsWithArguments:@[@20, @"T"]].count, 1U);
+    XCTAssertEqualObjects([[query resultsWithArguments:@[@20, @"F"]].firstObject name], @"Fiel");
+
+    // arguments can be referred to more than once and in any order
+    query = [realm prepareQuery:@"name == $1 OR (age >= $0 AND age <= $0)" forClass:@"PersonObject"];
+    XCTAssertEqual(query.argumentCount, 2U);
+    XCTAssertEqual([query resultsWithArguments:@[@29, @"Ari"]].count, 2U);
+
+    // placeholders in string literals are not arguments
+    query = [realm prepareQuery:@"name == 'Al$0'" forClass:@"PersonObject"];
+    XCTAssertEqual(query.argumentCount, 0U);
+    XCTAssertEqual([query resultsWithArguments:@[]].count, 1U);
+
+    RLMAssertThrowsWithReasonMatching([query resultsWithArguments:@[@1]], @"requires 0 arguments, but 1 were given");
+    XCTAssertThrows([realm prepareQuery:@"age > $0" forClass:@"NonRealmPersonObject"]);
+}
+
 - (void)testPredicateValidUse
 {
     RLMRealm *realm = [RLMRealm defaultRealm];
@@ -415,6 +509,35 @@
     XCTAssertEqualObjects([results[0] name], @"Tim", @"Tim should be first results");
 }
 
+- (void)testRepeatedQueryWithDifferentArguments
+{
+    RLMRealm *realm = [self realm];
+
+    [realm beginWriteTransaction];
+    [PersonObject createInRealm:realm withValue:@[@"Fiel", @27]];
+    [PersonObject createInRealm:realm withValue:@[@"Ari", @33]];
+    [PersonObject createInRealm:realm withValue:@[@"Tim", @29]];
+    [realm commitWriteTransaction];
+
+    for (int i = 0; i < 3; ++i) {
+        RLMAssertCount(PersonObject, 3U, @"age > %@", @20);
+        RLMAssertCount(PersonObject, 2U, @"age > %@", @28);
+        RLMAssertCount(PersonObject, 1U, @"age > %@", @30);
+        RLMAssertCount(PersonObject, 1U, @"name == %@", @"Ari");
+        RLMAssertCount(PersonObject, 0U, @"name == %@", @"ari");
+        RLMAssertCount(PersonObject, 1U, @"name ==[c] %@", @"ari");
+        RLMAssertCount(PersonObject, 2U, @"name IN %@", @[@"Ari", @"Tim"]);
+    }
+
+    [realm beginWriteTransaction];
+    [PersonObject createInRealm:realm withValue:@[@"Joe", @40]];
+    [realm commitWriteTransaction];
+    RLMAssertCount(PersonObject, 2U, @"age > %@", @30);
+
+    [realm invalidate];
+    RLMAssertCount(PersonObject, 2U, @"age > %@", @30);
+}
+
 -(void)testQueryBetween
 {
     RLMRealm *realm = [self realm];
@@ -644,6 +767,205 @@
     XCTAssertTrue(checkOrder(@[@"age", @"dogName"], @[@NO, @NO], @[b2, a2, b1, a1]));
 }
 
+- (void)testLimitSortedResults {
+    RLMRealm *realm = [self realm];
+    [realm beginWriteTransaction];
+    DogObject *a1 = [DogObject createInDefaultRealmWithValue:@[@"a", @1]];
+    DogObject *b3 = [DogObject createInDefaultRealmWithValue:@[@"b", @3]];
+    DogObject *a2 = [DogObject createInDefaultRealmWithValue:@[@"a", @2]];
+    DogObject *c1 = [DogObject createInDefaultRealmWithValue:@[@"c", @1]];
+    [realm commitWriteTransaction];
+
+    RLMResults *byAge = [DogObject.allObjects sortedResultsUsingKeyPath:@"age" ascending:NO];
+    RLMResults *limited = [byAge resultsLimitedTo:2];
+    XCTAssertEqual(2U, limited.count);
+    XCTAssertTrue([b3 isEqualToObject:limited[0]]);
+    XCTAssertTrue([a2 isEqualToObject:limited[1]]);
+
+    // Objects which tie with the last one are included
+    limited = [[DogObject.allObjects sortedResultsUsingKeyPath:@"age" ascending:YES] resultsLimitedTo:1];
+    XCTAssertEqual(2U, limited.count);
+    NSArray *sort = @[[RLMSortDescriptor sortDescriptorWithKeyPath:@"age" ascending:YES],
+                      [RLMSortDescriptor sortDescriptorWithKeyPath:@"dogName" ascending:NO]];
+    limited = [[DogObject.allObjects sortedResultsUsingDescriptors:sort] resultsLimitedTo:1];
+    XCTAssertEqual(1U, limited.count);
+    XCTAssertTrue([c1 isEqualToObject:limited[0]]);
+
+    // Filtering keeps the sort order, so the filtered results can be limited
+    limited = [[[DogObject.allObjects sortedResultsUsingKeyPath:@"dogName" ascending:NO] objectsWhere:@"age < 3"] resultsLimitedTo:1];
+    XCTAssertEqual(1U, limited.count);
+    XCTAssertTrue([c1 isEqualToObject:limited[0]]);
+
+    limited = [DogObject.allObjects resultsLimitedTo:3];
+    XCTAssertEqual(3U, limited.count);
+    XCTAssertTrue([a1 isEqualToObject:limited[0]]);
+    XCTAssertTrue([a2 isEqualToObject:limited[2]]);
+    XCTAssertEqual(0U, [byAge resultsLimitedTo:0].count);
+    XCTAssertEqual(4U, [byAge resultsLimitedTo:10].count);
+
+    // Lists aren't in table order, so they have to be sorted to be limited
+    [realm beginWriteTransaction];
+    DogArrayObject *array = [DogArrayObject createInDefaultRealmWithValue:@[@[c1, b3, a1]]];
+    [realm commitWriteTransaction];
+    RLMAssertThrowsWithReasonMatching([[array.dogs objectsWhere:@"age > 0"] resultsLimitedTo:1],
+                                      @"must be sorted before they can be limited");
+    limited = [[array.dogs sortedResultsUsingKeyPath:@"age" ascending:NO] resultsLimitedTo:1];
+    XCTAssertEqual(1U, limited.count);
+    XCTAssertTrue([b3 isEqualToObject:limited[0]]);
+
+    // The results contain the objects which sort before the cutoff as they update
+    limited = [byAge resultsLimitedTo:2];
+    [realm beginWriteTransaction];
+    [DogObject createInDefaultRealmWithValue:@[@"d", @5]];
+    b3.age = 0;
+    [realm commitWriteTransaction];
+    XCTAssertEqual(2U, limited.count);
+    XCTAssertEqualObjects(@"d", [limited[0] dogName]);
+    XCTAssertTrue([a2 isEqualToObject:limited[1]]);
+
+    // With no more than `limit` objects the last of them is the cutoff, so
+    // objects which sort after all of them aren't added
+    limited = [byAge resultsLimitedTo:10];
+    XCTAssertEqual(5U, limited.count);
+    [realm beginWriteTransaction];
+    [DogObject createInDefaultRealmWithValue:@[@"e", @6]];
+    [DogObject createInDefaultRealmWithValue:@[@"f", @-1]];
+    [realm commitWriteTransaction];
+    XCTAssertEqual(6U, limited.count);
+    XCTAssertEqualObjects(@"e", [limited[0] dogName]);
+    RLMResults *none = [[[DogObject objectsWhere:@"age > 100"] sortedResultsUsingKeyPath:@"age" ascending:NO] resultsLimitedTo:10];
+    [realm beginWriteTransaction];
+    [DogObject createInDefaultRealmWithValue:@[@"g", @101]];
+    [realm commitWriteTransaction];
+    XCTAssertEqual(0U, none.count);
+
+    // Results handed over to another thread compare sort keys there
+    limited = [byAge resultsLimitedTo:2];
+    RLMThreadSafeReference *reference = [RLMThreadSafeReference referenceWithThreadConfined:limited];
+    [self dispatchAsyncAndWait:^{
+        RLMRealm *realm = [self realm];
+        RLMResults *limited = [realm resolveThreadSafeReference:reference];
+        XCTAssertEqual(2U, limited.count);
+        [realm transactionWithBlock:^{
+            [DogObject createInRealm:realm withValue:@[@"h", @102]];
+        }];
+        XCTAssertEqual(3U, limited.count);
+        XCTAssertEqualObjects(@"h", [limited[0] dogName]);
+    }];
+}
+
+- (void)testDistinctResults {
+    RLMRealm *realm = [self realm];
+    [realm beginWriteTransaction];
+    DogObject *a1 = [DogObject createInDefaultRealmWithValue:@[@"a", @1]];
+    DogObject *b1 = [DogObject createInDefaultRealmWithValue:@[@"b", @1]];
+    [DogObject createInDefaultRealmWithValue:@[@"a", @1]];
+    DogObject *a2 = [DogObject createInDefaultRealmWithValue:@[@"a", @2]];
+    [realm commitWriteTransaction];
+
+    RLMResults *distinct = [DogObject.allObjects distinctResultsUsingKeyPaths:@[@"dogName"]];
+    XCTAssertEqual(2U, distinct.count);
+    XCTAssertTrue([a1 isEqualToObject:distinct[0]]);
+    XCTAssertTrue([b1 isEqualToObject:distinct[1]]);
+    XCTAssertEqual(3U, [DogObject.allObjects distinctResultsUsingKeyPaths:@[@"dogName", @"age"]].count);
+    XCTAssertEqual(4U, [DogObject.allObjects distinctResultsUsingKeyPaths:@[]].count);
+
+    RLMResults *sorted = [[DogObject.allObjects sortedResultsUsingKeyPath:@"age" ascending:NO]
+                          distinctResultsUsingKeyPaths:@[@"dogName"]];
+    XCTAssertEqual(2U, sorted.count);
+    XCTAssertTrue([a2 isEqualToObject:sorted[0]]);
+    XCTAssertEqual(1U, [[sorted objectsWhere:@"age = 2"] count]);
+
+    [realm beginWriteTransaction];
+    [DogObject createInDefaultRealmWithValue:@[@"c", @1]];
+    [realm commitWriteTransaction];
+    XCTAssertEqual(3U, distinct.count);
+
+    RLMAssertThrowsWithReasonMatching([DogObject.allObjects distinctResultsUsingKeyPaths:@[@"@count"]],
+                                      @"Cannot distinct on '@count'");
+    RLMAssertThrowsWithReasonMatching([CompanyObject.allObjects distinctResultsUsingKeyPaths:@[@"employees.name"]],
+                                      @"to-many relationship");
+}
+
+- (void)testExplain {
+    RLMRealm *realm = [self realm];
+    [realm beginWriteTransaction];
+    IndexedStringObject *a = [IndexedStringObject createInDefaultRealmWithValue:@[@"a"]];
+    [IndexedStringObject createInDefaultRealmWithValue:@[@"b"]];
+    [IndexedStringObject createInDefaultRealmWithValue:@[@"c"]];
+    [LinkIndexedStringObject createInDefaultRealmWithValue:@[a]];
+    [StringObject createInDefaultRealmWithValue:@[@"a"]];
+    [realm commitWriteTransaction];
+
+    NSDictionary *explanation = [[IndexedStringObject objectsWhere:@"stringCol = 'a'"] explain];
+    XCTAssertEqualObjects(@"IndexedStringObject", explanation[@"objectClassName"]);
+    XCTAssertEqualObjects(@3, explanation[@"tableRows"]);
+    XCTAssertEqualObjects(@1, explanation[@"estimatedRowsScanned"]);
+    XCTAssertEqualObjects(@1, explanation[@"matchedRows"]);
+    XCTAssertEqualObjects(@"comparison", explanation[@"query"][@"type"]);
+    XCTAssertEqualObjects(@"stringCol", explanation[@"query"][@"keyPath"]);
+    XCTAssertEqualObjects(@"index", explanation[@"query"][@"strategy"]);
+    XCTAssertEqualObjects(@YES, explanation[@"query"][@"indexed"]);
+
+    explanation = [[[IndexedStringObject objectsWhere:@"stringCol = 'a' OR stringCol BEGINSWITH 'b'"]
+                    sortedResultsUsingKeyPath:@"stringCol" ascending:NO] explain];
+    XCTAssertEqualObjects(@"or", explanation[@"query"][@"type"]);
+    XCTAssertEqualObjects(@"index", explanation[@"query"][@"children"][0][@"strategy"]);
+    XCTAssertEqualObjects(@"scan", explanation[@"query"][@"children"][1][@"strategy"]);
+    XCTAssertEqualObjects(@3, explanation[@"estimatedRowsScanned"]);
+    XCTAssertEqualObjects(@2, explanation[@"matchedRows"]);
+    XCTAssertEqualObjects((@[@{@"keyPath": @"stringCol", @"ascending": @NO}]), explanation[@"sortDescriptors"]);
+
+    explanation = [[[IndexedStringObject objectsWhere:@"stringCol != 'b'"] objectsWhere:@"stringCol = 'c'"] explain];
+    XCTAssertEqualObjects(@"and", explanation[@"query"][@"type"]);
+    XCTAssertEqual(2U, [explanation[@"query"][@"children"] count]);
+    XCTAssertEqualObjects(@1, explanation[@"estimatedRowsScanned"]);
+
+    explanation = [[LinkIndexedStringObject objectsWhere:@"objectCol.stringCol = 'a'"] explain];
+    XCTAssertEqualObjects(@"linkTraversal", explanation[@"query"][@"strategy"]);
+    explanation = [[StringObject objectsWhere:@"stringCol IN {'a', 'b'}"] explain];
+    XCTAssertEqualObjects(@"inSet", explanation[@"query"][@"strategy"]);
+    explanation = [[StringObject objectsMatchingText:@"a" inProperties:@[@"stringCol"]] explain];
+    XCTAssertEqualObjects(@"textSearch", explanation[@"query"][@"type"]);
+    XCTAssertEqualObjects(@1, explanation[@"matchedRows"]);
+    XCTAssertEqualObjects(NSNull.null, [StringObject.allObjects explain][@"query"]);
+}
+
+- (void)testSlowQueryHandler {
+    RLMRealm *realm = [self realm];
+    [realm beginWriteTransaction];
+    [StringObject createInDefaultRealmWithValue:@[@"a"]];
+    [realm commitWriteTransaction];
+
+    // The handler is global, so it's removed even if the test fails part way
+    // through so that it can't affect later tests
+    __block NSUInteger calls = 0;
+    @try {
+        [RLMResults setSlowQueryThreshold:-1 handler:^(RLMResults *results, NSTimeInterval duration) {
+            XCTAssertEqualObjects(@"StringObject", results.objectClassName);
+            XCTAssertEqual(1U, results.count);
+            XCTAssertGreaterThanOrEqual(duration, 0);
+            ++calls;
+        }];
+        RLMResults *results = [StringObject objectsWhere:@"stringCol = 'a'"];
+        XCTAssertEqual(1U, results.count);
+        XCTAssertEqual(1U, calls);
+        XCTAssertNotNil(results.firstObject);
+        XCTAssertEqual(2U, calls);
+
+        [RLMResults setSlowQueryThreshold:60 handler:^(__unused RLMResults *results, __unused NSTimeInterval duration) {
+            ++calls;
+        }];
+        XCTAssertEqual(1U, results.count);
+        [RLMResults setSlowQueryThreshold:-1 handler:nil];
+        XCTAssertEqual(1U, results.count);
+        XCTAssertEqual(2U, calls);
+    }
+    @finally {
+        [RLMResults setSlowQueryThreshold:-1 handler:nil];
+    }
+}
+
 - (void)testSortByKeyPath {
     RLMRealm *realm = [self realm];
 
@@ -681,6 +1003,14 @@
                          [RLMSortDescriptor sortDescriptorWithKeyPath:@"name" ascending:YES]
     ]];
     XCTAssertEqualObjects(asArray(r4), (@[ hannah, diane_sr, don, diane, mark ]));
+
+    // Sorting by a key path again after the links change uses the new targets
+    [realm beginWriteTransaction];
+    mark.dog = ziggy;
+    hannah.dog = freyja;
+    [realm commitWriteTransaction];
+    RLMResults *r5 = [OwnerObject.allObjects sortedResultsUsingKeyPath:@"dog.age" ascending:YES];
+    XCTAssertEqualObjects(asArray(r5), (@[ hannah, diane, mark, don, diane_sr ]));
 }
 
 - (void)testSortByUnspportedKeyPath {
@@ -695,6 +1025,10 @@
     // Collection operator
     RLMAssertThrowsWithReasonMatching([DogArrayObject.allObjects sortedResultsUsingKeyPath:@"dogs.@count" ascending:YES],
                                       @"collection operators is not supported");
+
+    // Invalid key paths aren't remembered as valid after failing once
+    RLMAssertThrowsWithReasonMatching([DogObject.allObjects sortedResultsUsingKeyPath:@"owners.name" ascending:YES],
+                                      @"to-many relationship is not supported");
 }
 
 - (void)testSortedLinkViewWithDeletion {
@@ -982,6 +1316,12 @@
     RLMAssertCount(StringObject, 1U, @"stringCol CONTAINS[c] 'c'");
     RLMAssertCount(StringObject, 1U, @"stringCol CONTAINS[c] 'C'");
 
+    RLMAssertCount(StringObject, 1U, @"stringCol CONTAINS[d] 'bc'");
+    RLMAssertCount(StringObject, 0U, @"stringCol CONTAINS[d] 'BC'");
+    RLMAssertCount(StringObject, 1U, @"stringCol CONTAINS[cd] 'BC'");
+    RLMAssertCount(StringObject, 0U, @"stringCol CONTAINS[cd] 'ABCD'");
+    RLMAssertCount(StringObject, 0U, @"stringCol CONTAINS[cd] 'BD'");
+
     RLMAssertCount(StringObject, 1U, @"stringCol CONTAINS 'u'");
     RLMAssertCount(StringObject, 1U, @"stringCol CONTAINS[c] 'U'");
     RLMAssertCount(StringObject, 3U, @"stringCol CONTAINS[d] 'u'");
@@ -1709,6 +2049,482 @@
     [self testClass:[AllTypesObject class] withNormalCount:1U notCount:0U where:@"objectCol.stringCol IN[c] %@", @[@"ABC"]];
 }
 
+- (void)testINPredicateWithManyValues
+{
+    RLMRealm *realm = [self realm];
+
+    [realm beginWriteTransaction];
+    for (int i = 0; i < 10; ++i) {
+        [IntObject createInRealm:realm withValue:@[@(i)]];
+        [StringObject createInRealm:realm withValue:@[[NSString stringWithFormat:@"%d", i]]];
+        [IndexedStringObject createInRealm:realm withValue:@[[NSString stringWithFormat:@"%d", i]]];
+    }
+    [AllOptionalTypes createInRealm:realm withValue:@[@1]];
+    [AllOptionalTypes createInRealm:realm withValue:@[NSNull.null]];
+    [StringObject createInRealm:realm withValue:@[NSNull.null]];
+    [realm commitWriteTransaction];
+
+    NSMutableArray *ints = [NSMutableArray new];
+    NSMutableArray *strings = [NSMutableArray new];
+    for (int i = 0; i < 1000; i += 2) {
+        [ints addObject:@(i)];
+        [strings addObject:[NSString stringWithFormat:@"%d", i]];
+    }
+
+    RLMAssertCount(IntObject, 5U, @"intCol IN %@", ints);
+    RLMAssertCount(IntObject, 5U, @"NOT intCol IN %@", ints);
+    RLMAssertCount(IntObject, 0U, @"intCol IN %@", @[]);
+    RLMAssertCount(StringObject, 5U, @"stringCol IN %@", strings);
+    RLMAssertCount(IndexedStringObject, 5U, @"stringCol IN %@", strings);
+    RLMAssertCount(StringObject, 1U, @"stringCol IN %@", @[@"0", @"0", @"10"]);
+
+    RLMAssertCount(AllOptionalTypes, 1U, @"intObj IN %@", @[@1, @2]);
+    RLMAssertCount(AllOptionalTypes, 1U, @"intObj IN %@", @[NSNull.null]);
+    RLMAssertCount(AllOptionalTypes, 2U, @"intObj IN %@", @[@1, NSNull.null]);
+    RLMAssertCount(StringObject, 1U, @"stringCol IN %@", @[NSNull.null]);
+    RLMAssertCount(StringObject, 6U, @"stringCol IN %@", [strings arrayByAddingObject:NSNull.null]);
+
+    RLMAssertThrowsWithReasonMatching([IntObject objectsInRealm:realm where:@"intCol IN %@", @[@1, @"a"]],
+                                      @"Expected object of type int in IN clause");
+}
+
+- (void)testFoldedIndexedProperty
+{
+    RLMRealm *realm = [self realm];
+    XCTAssertTrue(FoldedStringObject.sharedSchema[@"foldedName"].indexed);
+
+    [realm beginWriteTransaction];
+    FoldedStringObject *obj = [FoldedStringObject createInRealm:realm withValue:@[@"Émile"]];
+    [FoldedStringObject createInRealm:realm withValue:@{@"name": @"emile", @"foldedName": @"ignored"}];
+    [realm addObject:[[FoldedStringObject alloc] initWithValue:@[@"Zoë", @"ignored"]]];
+    [realm createObjects:@"FoldedStringObject" withValues:@[@[@"ÉMILIE"], @{@"name": NSNull.null}] error:nil];
+    [realm commitWriteTransaction];
+
+    XCTAssertEqualObjects(obj.foldedName, @"emile");
+    XCTAssertEqualObjects([[FoldedStringObject objectsWhere:@"name = 'Zoë'"].firstObject foldedName], @"zoe");
+    XCTAssertEqualObjects([[FoldedStringObject objectsWhere:@"name = 'ÉMILIE'"].firstObject foldedName], @"emilie");
+    XCTAssertNil([[FoldedStringObject objectsWhere:@"name = nil"].firstObject foldedName]);
+
+    RLMAssertCount(FoldedStringObject, 2U, @"name ==[cd] 'EMILE'");
+    RLMAssertCount(FoldedStringObject, 3U, @"name !=[cd] 'emile'");
+    RLMAssertCount(FoldedStringObject, 3U, @"name BEGINSWITH[cd] 'Émi'");
+    RLMAssertCount(FoldedStringObject, 1U, @"name ENDSWITH[cd] 'IE'");
+    RLMAssertCount(FoldedStringObject, 1U, @"name CONTAINS[cd] 'oe'");
+    RLMAssertCount(FoldedStringObject, 1U, @"name ==[c] 'emile'");
+    RLMResults *all = [FoldedStringObject allObjects];
+    XCTAssertEqual(2U, [all objectsMatchingCondition:[RLMQueryCondition conditionWithProperty:@"name"
+                                                                                     operator:RLMQueryOperatorEqual
+                                                             caseAndDiacriticInsensitiveValue:@"EMILE"]].count);
+    XCTAssertEqual(1U, [all objectsMatchingCondition:[RLMQueryCondition conditionWithProperty:@"name"
+                                                                                     operator:RLMQueryOperatorContains
+                                                             caseAndDiacriticInsensitiveValue:@"oe"]].count);
+
+    [realm beginWriteTransaction];
+    obj.name = @"Zoé";
+    RLMAssertThrowsWithReasonMatching(obj.foldedName = @"x", @"can't be set directly");
+    RLMAssertThrowsWithReasonMatching(obj[@"foldedName"] = @"x", @"can't be set directly");
+    [realm commitWriteTransaction];
+
+    XCTAssertEqualObjects(obj.foldedName, @"zoe");
+    RLMAssertCount(FoldedStringObject, 2U, @"name ==[cd] 'zoe'");
+    RLMAssertCount(FoldedStringObject, 1U, @"name ==[cd] 'EMILE'");
+}
+
+- (void)testCompoundIndex
+{
+    RLMRealm *realm = [self realm];
+    XCTAssertTrue(TimelineObject.sharedSchema[@"accountKey"].indexed);
+
+    NSDate *date = [NSDate dateWithTimeIntervalSince1970:0];
+    [realm beginWriteTransaction];
+    TimelineObject *obj = [TimelineObject createInRealm:realm withValue:@[@1, @NO, @"a|b", date]];
+    [TimelineObject createInRealm:realm withValue:@{@"accountId": @1, @"deleted": @YES, @"title": @"c",
+                                                    @"timestamp": date, @"accountKey": @"ignored"}];
+    TimelineObject *added = [[TimelineObject alloc] initWithValue:@[@2, @NO, @"d", date]];
+    [realm addObject:added];
+    [realm createObjects:@"TimelineObject" withValues:@[@[@1, @NO, @"e", [date dateByAddingTimeInterval:1]],
+                                                        @[@11, @NO, @"f", date]] error:nil];
+    [realm commitWriteTransaction];
+
+    XCTAssertEqualObjects(obj.accountKey, @"+1|+0");
+    XCTAssertEqualObjects(added.accountKey, @"+2|+0");
+    RLMAssertCount(TimelineObject, 2U, @"accountId == 1 AND deleted == NO");
+    RLMAssertCount(TimelineObject, 1U, @"deleted == YES AND accountId == 1");
+    RLMAssertCount(TimelineObject, 1U, @"accountId == 1 AND deleted == NO AND title == 'e'");
+    RLMAssertCount(TimelineObject, 0U, @"accountId == 1 AND deleted == NO AND accountId == 2");
+    RLMAssertCount(TimelineObject, 1U, @"accountId == 11 AND deleted == NO");
+    RLMAssertCount(TimelineObject, 3U, @"accountId == 1 OR deleted == NO");
+
+    RLMResults *timeline = [[TimelineObject objectsWhere:@"accountId == 1 AND deleted == NO"]
+                            sortedResultsUsingKeyPath:@"timestamp" ascending:NO];
+    XCTAssertEqualObjects(@"e", [timeline.firstObject title]);
+    NSDictionary *explanation = [timeline explain];
+    XCTAssertEqualObjects(@"accountKey", explanation[@"query"][@"children"][0][@"keyPath"]);
+    XCTAssertEqualObjects(@"compoundIndex", explanation[@"query"][@"children"][0][@"strategy"]);
+
+    [realm beginWriteTransaction];
+    obj.deleted = YES;
+    RLMAssertThrowsWithReasonMatching(obj.accountKey = @"x", @"can't be set directly");
+    RLMAssertThrowsWithReasonMatching(obj[@"accountKey"] = @"x", @"can't be set directly");
+    [realm commitWriteTransaction];
+
+    XCTAssertEqualObjects(obj.accountKey, @"+1|+1");
+    XCTAssertEqual(1U, timeline.count);
+    RLMAssertCount(TimelineObject, 2U, @"accountId == 1 AND deleted == YES");
+}
+
+- (void)testSortedRangeOnIndexedProperties
+{
+    RLMRealm *realm = [self realm];
+    NSDate *date = [NSDate dateWithTimeIntervalSince1970:100];
+    [realm beginWriteTransaction];
+    for (int i = 9; i >= 0; --i) {
+        [IndexedRangeObject createInRealm:realm withValue:@[@(i), i % 3 ? @(i) : NSNull.null,
+                                                            [date dateByAddingTimeInterval:i]]];
+    }
+    [realm commitWriteTransaction];
+
+    RLMAssertCount(IndexedRangeObject, 4U, @"intCol > 5");
+    RLMAssertCount(IndexedRangeObject, 5U, @"intCol >= 5");
+    RLMAssertCount(IndexedRangeObject, 5U, @"intCol < 5");
+    RLMAssertCount(IndexedRangeObject, 6U, @"intCol <= 5");
+    RLMAssertCount(IndexedRangeObject, 6U, @"5 >= intCol");
+    RLMAssertCount(IndexedRangeObject, 0U, @"intCol > 9");
+    RLMAssertCount(IndexedRangeObject, 3U, @"intCol BETWEEN {2, 4}");
+    RLMAssertCount(IndexedRangeObject, 1U, @"intCol > 2 AND intCol < 4");
+    RLMAssertCount(IndexedRangeObject, 3U, @"optIntCol < 5");
+    RLMAssertCount(IndexedRangeObject, 4U, @"optIntCol > 3");
+    RLMAssertCount(IndexedRangeObject, 2U, @"dateCol >= %@", [date dateByAddingTimeInterval:8]);
+    RLMAssertCount(IndexedRangeObject, 2U, @"dateCol < %@", [date dateByAddingTimeInterval:2]);
+
+    RLMResults *results = [IndexedRangeObject objectsWhere:@"intCol >= 8"];
+    XCTAssertEqualObjects(@"sortedRange", [results explain][@"query"][@"strategy"]);
+    XCTAssertEqual(2U, results.count);
+    XCTAssertEqual(9, [results.firstObject intCol]);
+
+    [realm beginWriteTransaction];
+    [IndexedRangeObject createInRealm:realm withValue:@[@20, @20, date]];
+    [results.firstObject setIntCol:1];
+    [realm commitWriteTransaction];
+    XCTAssertEqual(2U, results.count);
+    RLMAssertCount(IndexedRangeObject, 2U, @"intCol BETWEEN {1, 1}");
+
+    // Results handed over to another thread sort their own view there
+    RLMThreadSafeReference *reference = [RLMThreadSafeReference referenceWithThreadConfined:results];
+    [self dispatchAsyncAndWait:^{
+        RLMRealm *realm = [self realm];
+        RLMResults *results = [realm resolveThreadSafeReference:reference];
+        XCTAssertEqual(2U, results.count);
+        [realm transactionWithBlock:^{
+            [IndexedRangeObject createInRealm:realm withValue:@[@30, @30, date]];
+        }];
+        XCTAssertEqual(3U, results.count);
+    }];
+    [realm refresh];
+    XCTAssertEqual(3U, results.count);
+}
+
+- (void)testGeoIndexQueries
+{
+    RLMRealm *realm = [self realm];
+    [realm beginWriteTransaction];
+    // A point every 10 degrees, from 80S to 80N and from 170W to 180E
+    for (int lat = -80; lat <= 80; lat += 10) {
+        for (int lng = -170; lng <= 180; lng += 10) {
+            [GeoIndexedObject createInRealm:realm withValue:@[@(lat), @(lng)]];
+        }
+    }
+    [realm commitWriteTransaction];
+
+    RLMAssertCount(GeoIndexedObject, 12U, @"lat BETWEEN {-5, 25} AND lng BETWEEN {95, 135}");
+    RLMAssertCount(GeoIndexedObject, 12U, @"lat >= -5 AND lat < 25 AND 95 <= lng AND lng <= 135");
+    RLMAssertCount(GeoIndexedObject, 1U, @"lat == 0 AND lng > 170");
+    RLMAssertCount(GeoIndexedObject, 36U, @"lat BETWEEN {79.5, 90} AND lng >= -180");
+    RLMAssertCount(GeoIndexedObject, 0U, @"lat BETWEEN {1, 9} AND lng BETWEEN {1, 9}");
+    RLMAssertCount(GeoIndexedObject, 0U, @"lat > 10 AND lat < 0 AND lng == 0");
+    RLMAssertCount(GeoIndexedObject, 20U, @"lat BETWEEN {-5, 25} AND lng BETWEEN {95, 135} OR lng == 0 AND lat > 0");
+
+    RLMResults *box = [GeoIndexedObject objectsWhere:@"lat BETWEEN {-5, 25} AND lng BETWEEN {95, 135}"];
+    XCTAssertTrue([[[box explain] description] containsString:@"geoIndex"]);
+
+    // 10 degrees of latitude are about 1112 km
+    RLMResults *all = [GeoIndexedObject allObjects];
+    XCTAssertEqual(5U, [all objectsWithinDistance:1200000 ofLatitude:0 longitude:0 geoIndex:@"cell"].count);
+    XCTAssertEqual(1U, [all objectsWithinDistance:1000000 ofLatitude:0 longitude:0 geoIndex:@"cell"].count);
+    XCTAssertEqual(5U, [all objectsWithinDistance:1200000 ofLatitude:0 longitude:180 geoIndex:@"cell"].count);
+    XCTAssertEqual(36U, [all objectsWithinDistance:1200000 ofLatitude:90 longitude:0 geoIndex:@"cell"].count);
+    XCTAssertEqual(1U, [[all objectsWhere:@"lat >= 0"] objectsWithinDistance:1200000 ofLatitude:-10 longitude:0
+                                                                    geoIndex:@"cell"].count);
+
+    // The key is updated when the location changes
+    RLMResults *near = [all objectsWithinDistance:100000 ofLatitude:45 longitude:45 geoIndex:@"cell"];
+    XCTAssertEqual(0U, near.count);
+    GeoIndexedObject *obj = [GeoIndexedObject objectsWhere:@"lat == 0 AND lng == 0"].firstObject;
+    [realm beginWriteTransaction];
+    obj.lat = 45.1;
+    obj.lng = 44.9;
+    [realm commitWriteTransaction];
+    XCTAssertEqual(1U, near.count);
+    RLMAssertCount(GeoIndexedObject, 1U, @"lat BETWEEN {45, 46} AND lng BETWEEN {44, 45}");
+
+    // Results handed over to another thread measure the distances there
+    RLMThreadSafeReference *reference = [RLMThreadSafeReference referenceWithThreadConfined:near];
+    [self dispatchAsyncAndWait:^{
+        RLMRealm *realm = [self realm];
+        RLMResults *near = [realm resolveThreadSafeReference:reference];
+        XCTAssertEqual(1U, near.count);
+        [realm transactionWithBlock:^{
+            [GeoIndexedObject createInRealm:realm withValue:@[@44.9, @45.1]];
+        }];
+        XCTAssertEqual(2U, near.count);
+    }];
+    [realm refresh];
+    XCTAssertEqual(2U, near.count);
+
+    [realm beginWriteTransaction];
+    RLMAssertThrowsWithReasonMatching(obj.cell = @1, @"geo index");
+    RLMAssertThrowsWithReasonMatching(obj[@"cell"] = @1, @"geo index");
+    [realm cancelWriteTransaction];
+    RLMAssertThrowsWithReasonMatching([all objectsWithinDistance:1 ofLatitude:0 longitude:0 geoIndex:@"lat"],
+                                      @"not the key of a geo index");
+    RLMAssertThrowsWithReasonMatching([all objectsWithinDistance:1 ofLatitude:91 longitude:0 geoIndex:@"cell"],
+                                      @"latitude must be within");
+}
+
+- (void)testSortingByCollationKey
+{
+    RLMRealm *realm = [self realm];
+    [realm beginWriteTransaction];
+    for (NSString *name in @[@"item10", @"Élan", @"item2", @"banana", @"Apple", @"elephant", @"item1"]) {
+        [CollatedObject createInRealm:realm withValue:@[name]];
+    }
+    [realm commitWriteTransaction];
+
+    NSArray *expected = @[@"Apple", @"banana", @"Élan", @"elephant", @"item1", @"item2", @"item10"];
+    RLMResults *sorted = [[CollatedObject allObjects] sortedResultsUsingKeyPath:@"name" ascending:YES];
+    XCTAssertEqualObjects([sorted valueForKey:@"name"], expected);
+    XCTAssertEqualObjects([[[CollatedObject allObjects] sortedResultsUsingKeyPath:@"name" ascending:NO] valueForKey:@"name"],
+                          expected.reverseObjectEnumerator.allObjects);
+
+    // Sorted results stay live, and the key follows the name
+    CollatedObject *obj = [CollatedObject objectsWhere:@"name = 'Apple'"].firstObject;
+    [realm beginWriteTransaction];
+    obj.name = @"item3";
+    [realm commitWriteTransaction];
+    XCTAssertEqualObjects(sorted.lastObject[@"name"], @"item10");
+    XCTAssertEqualObjects(sorted[5][@"name"], @"item3");
+
+    [realm beginWriteTransaction];
+    obj.name = nil;
+    [realm commitWriteTransaction];
+    XCTAssertNil(obj.nameKey);
+    RLMAssertThrowsWithReasonMatching(obj.nameKey = @"a", @"collation key");
+}
+
+- (void)testSemiJoinOnLists
+{
+    RLMRealm *realm = [self realm];
+    [realm beginWriteTransaction];
+    StringObject *a = [StringObject createInRealm:realm withValue:@[@"a"]];
+    StringObject *b = [StringObject createInRealm:realm withValue:@[@"b"]];
+    [StringObject createInRealm:realm withValue:@[@"c"]];
+    [ArrayPropertyObject createInRealm:realm withValue:@[@"ab", @[a, b, a], @[]]];
+    [ArrayPropertyObject createInRealm:realm withValue:@[@"b", @[b], @[]]];
+    ArrayPropertyObject *empty = [ArrayPropertyObject createInRealm:realm withValue:@[@"empty", @[], @[]]];
+    [realm commitWriteTransaction];
+
+    RLMAssertCount(ArrayPropertyObject, 1U, @"ANY array.stringCol == 'a'");
+    RLMAssertCount(ArrayPropertyObject, 2U, @"ANY array.stringCol == 'b'");
+    RLMAssertCount(ArrayPropertyObject, 0U, @"ANY array.stringCol == 'c'");
+    RLMAssertCount(ArrayPropertyObject, 2U, @"ANY array.stringCol IN {'a', 'b'}");
+    RLMAssertCount(ArrayPropertyObject, 1U, @"'a' IN array.stringCol");
+    RLMAssertCount(ArrayPropertyObject, 1U, @"ANY array.stringCol != 'b'");
+    RLMAssertCount(ArrayPropertyObject, 1U, @"ANY array.stringCol == 'b' AND name == 'b'");
+    RLMAssertCount(ArrayPropertyObject, 2U, @"NOT (ANY array.stringCol == 'a')");
+    RLMAssertCount(ArrayPropertyObject, 2U, @"SUBQUERY(array, $s, $s.stringCol == 'b').@count > 0");
+    RLMAssertCount(ArrayPropertyObject, 1U, @"SUBQUERY(array, $s, $s.stringCol == 'b').@count == 0");
+    RLMAssertCount(ArrayPropertyObject, 1U, @"SUBQUERY(array, $s, $s.stringCol == 'a').@count == 2");
+
+    RLMResults *results = [ArrayPropertyObject objectsWhere:@"ANY array.stringCol == 'a'"];
+    NSDictionary *explanation = [results explain];
+    XCTAssertEqualObjects(@"semiJoin", explanation[@"query"][@"strategy"]);
+    XCTAssertEqualObjects(@"stringCol", explanation[@"query"][@"targets"][@"keyPath"]);
+    XCTAssertEqual(1U, results.count);
+
+    // Changing a list without changing its targets updates the results
+    [realm beginWriteTransaction];
+    [empty.array addObject:a];
+    [realm commitWriteTransaction];
+    XCTAssertEqual(2U, results.count);
+
+    [realm beginWriteTransaction];
+    a.stringCol = @"c";
+    [realm commitWriteTransaction];
+    XCTAssertEqual(0U, results.count);
+    RLMAssertCount(ArrayPropertyObject, 2U, @"ANY array.stringCol == 'c'");
+
+    // Results handed over to another thread follow the backlinks there
+    RLMResults *withC = [ArrayPropertyObject objectsWhere:@"ANY array.stringCol == 'c'"];
+    RLMThreadSafeReference *reference = [RLMThreadSafeReference referenceWithThreadConfined:withC];
+    [self dispatchAsyncAndWait:^{
+        RLMRealm *realm = [self realm];
+        RLMResults *withC = [realm resolveThreadSafeReference:reference];
+        XCTAssertEqual(2U, withC.count);
+        [realm transactionWithBlock:^{
+            StringObject *c = [StringObject objectsInRealm:realm where:@"stringCol == 'c'"].firstObject;
+            [ArrayPropertyObject createInRealm:realm withValue:@[@"c", @[c], @[]]];
+        }];
+        XCTAssertEqual(3U, withC.count);
+    }];
+    [realm refresh];
+    XCTAssertEqual(3U, withC.count);
+}
+
+- (void)testSemiJoinWithConstantOnLeft
+{
+    RLMRealm *realm = [self realm];
+    [realm beginWriteTransaction];
+    IntObject *one = [IntObject createInRealm:realm withValue:@[@1]];
+    IntObject *two = [IntObject createInRealm:realm withValue:@[@2]];
+    IntObject *five = [IntObject createInRealm:realm withValue:@[@5]];
+    IntObject *six = [IntObject createInRealm:realm withValue:@[@6]];
+    [ArrayPropertyObject createInRealm:realm withValue:@[@"1", @[], @[one]]];
+    [ArrayPropertyObject createInRealm:realm withValue:@[@"2, 5", @[], @[two, five]]];
+    [ArrayPropertyObject createInRealm:realm withValue:@[@"6", @[], @[six]]];
+    [ArrayPropertyObject createInRealm:realm withValue:@[@"empty", @[], @[]]];
+    [realm commitWriteTransaction];
+
+    RLMAssertCount(ArrayPropertyObject, 2U, @"2 < ANY intArray.intCol");
+    RLMAssertCount(ArrayPropertyObject, 2U, @"ANY intArray.intCol > 2");
+    RLMAssertCount(ArrayPropertyObject, 3U, @"1 <= ANY intArray.intCol");
+    RLMAssertCount(ArrayPropertyObject, 3U, @"ANY intArray.intCol >= 1");
+    RLMAssertCount(ArrayPropertyObject, 2U, @"6 > ANY intArray.intCol");
+    RLMAssertCount(ArrayPropertyObject, 2U, @"ANY intArray.intCol < 6");
+    RLMAssertCount(ArrayPropertyObject, 1U, @"1 >= ANY intArray.intCol");
+    RLMAssertCount(ArrayPropertyObject, 1U, @"ANY intArray.intCol <= 1");
+    RLMAssertCount(ArrayPropertyObject, 1U, @"5 == ANY intArray.intCol");
+    RLMAssertCount(ArrayPropertyObject, 2U, @"1 != ANY intArray.intCol");
+
+    NSDictionary *explanation = [[ArrayPropertyObject objectsWhere:@"2 < ANY intArray.intCol"] explain];
+    XCTAssertEqualObjects(@"semiJoin", explanation[@"query"][@"strategy"]);
+    XCTAssertEqualObjects(@"intCol", explanation[@"query"][@"targets"][@"keyPath"]);
+}
+
+- (void)testTextSearch
+{
+    RLMRealm *realm = [self realm];
+    [realm beginWriteTransaction];
+    [QueryObject createInRealm:realm withValue:@[@NO, @NO, @0, @0, @0, @0, @0, @0, @"John", @"Smith"]];
+    [QueryObject createInRealm:realm withValue:@[@NO, @NO, @0, @0, @0, @0, @0, @0, @"Jöhanna", @"Smithers-Jones"]];
+    [QueryObject createInRealm:realm withValue:@[@NO, @NO, @0, @0, @0, @0, @0, @0, @"Anna", @"Mojo"]];
+    [FoldedStringObject createInRealm:realm withValue:@[@"Émile Zola"]];
+    [realm commitWriteTransaction];
+
+    RLMResults *all = [QueryObject allObjects];
+    NSArray *properties = @[@"string1", @"string2"];
+    XCTAssertEqual(2U, [all objectsMatchingText:@"jo" inProperties:properties].count);
+    XCTAssertEqual(1U, [all objectsMatchingText:@"mo" inProperties:properties].count);
+    XCTAssertEqual(2U, [all objectsMatchingText:@"jo sm" inProperties:properties].count);
+    XCTAssertEqual(1U, [all objectsMatchingText:@"JONES, johan" inProperties:properties].count);
+    XCTAssertEqual(0U, [all objectsMatchingText:@"ohn" inProperties:properties].count);
+    XCTAssertEqual(1U, [all objectsMatchingText:@"jo" inProperties:@[@"string2"]].count);
+    XCTAssertEqual(3U, [all objectsMatchingText:@" - " inProperties:properties].count);
+    XCTAssertEqual(1U, [[all objectsWhere:@"string1 BEGINSWITH 'J'"] objectsMatchingText:@"smithers" inProperties:properties].count);
+    XCTAssertEqual(1U, [[FoldedStringObject allObjects] objectsMatchingText:@"zol EMI" inProperties:@[@"name"]].count);
+
+    // Results handed over to another thread read the strings there
+    RLMResults *matches = [all objectsMatchingText:@"jo" inProperties:properties];
+    RLMThreadSafeReference *reference = [RLMThreadSafeReference referenceWithThreadConfined:matches];
+    [self dispatchAsyncAndWait:^{
+        RLMRealm *realm = [self realm];
+        RLMResults *matches = [realm resolveThreadSafeReference:reference];
+        XCTAssertEqual(2U, matches.count);
+        [realm transactionWithBlock:^{
+            [QueryObject createInRealm:realm withValue:@[@NO, @NO, @0, @0, @0, @0, @0, @0, @"Joe", @"Bloggs"]];
+        }];
+        XCTAssertEqual(3U, matches.count);
+    }];
+    [realm refresh];
+    XCTAssertEqual(3U, matches.count);
+
+    RLMAssertThrowsWithReasonMatching([all objectsMatchingText:@"a" inProperties:@[]], @"at least one property");
+    RLMAssertThrowsWithReasonMatching([all objectsMatchingText:@"a" inProperties:@[@"int1"]], @"requires 'string' properties");
+    RLMAssertThrowsWithReasonMatching([all objectsMatchingText:@"a" inProperties:@[@"missing"]], @"not found");
+}
+
+- (void)testQueryCondition
+{
+    RLMRealm *realm = [self realm];
+    [realm beginWriteTransaction];
+    [QueryObject createInRealm:realm withValue:@[@YES, @NO, @1, @2, @1.5f, @0, @2.5, @0, @"John", @"Smith"]];
+    [QueryObject createInRealm:realm withValue:@[@NO, @NO, @2, @2, @2.5f, @0, @3.5, @0, @"Jöhanna", @"Jones"]];
+    [QueryObject createInRealm:realm withValue:@[@NO, @YES, @3, @2, @3.5f, @0, @4.5, @0, @"Anna", @"Mojo"]];
+    [AllOptionalTypes createInRealm:realm withValue:@{}];
+    [AllOptionalTypes createInRealm:realm withValue:@[@1, @1.0f, @1.0, @YES, @"a", [NSData data], [NSDate dateWithTimeIntervalSince1970:1]]];
+    [realm commitWriteTransaction];
+
+    RLMResults *all = [QueryObject allObjects];
+    RLMQueryCondition *(^condition)(NSString *, RLMQueryOperator, id) = ^(NSString *property, RLMQueryOperator op, id value) {
+        return [RLMQueryCondition conditionWithProperty:property operator:op value:value];
+    };
+    XCTAssertEqual(1U, [all objectsMatchingCondition:condition(@"int1", RLMQueryOperatorEqual, @2)].count);
+    XCTAssertEqual(2U, [all objectsMatchingCondition:condition(@"int1", RLMQueryOperatorNotEqual, @2)].count);
+    XCTAssertEqual(2U, [all objectsMatchingCondition:condition(@"int1", RLMQueryOperatorGreaterThanOrEqual, @2)].count);
+    XCTAssertEqual(1U, [all objectsMatchingCondition:condition(@"float1", RLMQueryOperatorLessThan, @2)].count);
+    XCTAssertEqual(2U, [all objectsMatchingCondition:condition(@"double1", RLMQueryOperatorLessThanOrEqual, @3.5)].count);
+    XCTAssertEqual(1U, [all objectsMatchingCondition:condition(@"bool1", RLMQueryOperatorEqual, @YES)].count);
+    XCTAssertEqual(2U, [all objectsMatchingCondition:condition(@"bool1", RLMQueryOperatorNotEqual, @YES)].count);
+    XCTAssertEqual(2U, [all objectsMatchingCondition:condition(@"string1", RLMQueryOperatorBeginsWith, @"J")].count);
+    XCTAssertEqual(2U, [all objectsMatchingCondition:condition(@"string1", RLMQueryOperatorEndsWith, @"na")].count);
+    XCTAssertEqual(1U, [all objectsMatchingCondition:condition(@"string2", RLMQueryOperatorContains, @"oj")].count);
+    XCTAssertEqual(0U, [all objectsMatchingCondition:condition(@"string1", RLMQueryOperatorEqual, @"john")].count);
+    XCTAssertEqual(1U, [all objectsMatchingCondition:[RLMQueryCondition conditionWithProperty:@"string1"
+                                                                                     operator:RLMQueryOperatorEqual
+                                                                         caseInsensitiveValue:@"john"]].count);
+    XCTAssertEqual(1U, [all objectsMatchingCondition:[RLMQueryCondition conditionWithProperty:@"string1"
+                                                                                     operator:RLMQueryOperatorBeginsWith
+                                                                         caseInsensitiveValue:@"joh"]].count);
+    XCTAssertEqual(2U, [all objectsMatchingCondition:[RLMQueryCondition conditionWithProperty:@"string1"
+                                                                                     operator:RLMQueryOperatorBeginsWith
+                                                             caseAndDiacriticInsensitiveValue:@"joh"]].count);
+
+    RLMQueryCondition *js = condition(@"string1", RLMQueryOperatorBeginsWith, @"J");
+    RLMQueryCondition *big = condition(@"int1", RLMQueryOperatorGreaterThan, @1);
+    XCTAssertEqual(1U, [all objectsMatchingCondition:[RLMQueryCondition conditionMatchingAll:@[js, big]]].count);
+    XCTAssertEqual(3U, [all objectsMatchingCondition:[RLMQueryCondition conditionMatchingAny:@[js, big]]].count);
+    XCTAssertEqual(1U, [all objectsMatchingCondition:[RLMQueryCondition conditionNegating:js]].count);
+    XCTAssertEqual(3U, [all objectsMatchingCondition:[RLMQueryCondition conditionMatchingAll:@[]]].count);
+    XCTAssertEqual(0U, [all objectsMatchingCondition:[RLMQueryCondition conditionMatchingAny:@[]]].count);
+    XCTAssertEqual(1U, [[all objectsWhere:@"bool2 = NO"] objectsMatchingCondition:big].count);
+    XCTAssertEqualObjects(@"(string1 BEGINSWITH \"J\" AND int1 > 1)",
+                          [RLMQueryCondition conditionMatchingAll:@[js, big]].description);
+
+    RLMResults *optionals = [AllOptionalTypes allObjects];
+    XCTAssertEqual(1U, [optionals objectsMatchingCondition:condition(@"intObj", RLMQueryOperatorEqual, nil)].count);
+    XCTAssertEqual(1U, [optionals objectsMatchingCondition:condition(@"string", RLMQueryOperatorNotEqual, NSNull.null)].count);
+    XCTAssertEqual(1U, [optionals objectsMatchingCondition:condition(@"date", RLMQueryOperatorGreaterThan,
+                                                                     [NSDate dateWithTimeIntervalSince1970:0])].count);
+
+    RLMAssertThrowsWithReasonMatching([all objectsMatchingCondition:condition(@"missing", RLMQueryOperatorEqual, @1)],
+                                      @"not found");
+    RLMAssertThrowsWithReasonMatching([all objectsMatchingCondition:condition(@"int1", RLMQueryOperatorEqual, @"a")],
+                                      @"Cannot compare property 'int1'");
+    RLMAssertThrowsWithReasonMatching([all objectsMatchingCondition:condition(@"int1", RLMQueryOperatorEqual, nil)],
+                                      @"Only optional properties");
+    RLMAssertThrowsWithReasonMatching([all objectsMatchingCondition:condition(@"string1", RLMQueryOperatorLessThan, @"a")],
+                                      @"Only equality and string operators");
+    RLMAssertThrowsWithReasonMatching([all objectsMatchingCondition:condition(@"bool1", RLMQueryOperatorLessThan, @YES)],
+                                      @"Only 'Equal' and 'Not Equal'");
+    RLMAssertThrowsWithReasonMatching([optionals objectsMatchingCondition:condition(@"data", RLMQueryOperatorEqual, [NSData data])],
+                                      @"cannot be compared by a query condition");
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wnonnull"
+    RLMAssertThrowsWithReasonMatching([RLMQueryCondition conditionNegating:nil], @"must not be nil");
+    RLMAssertThrowsWithReasonMatching([RLMQueryCondition conditionMatchingAll:nil], @"must not be nil");
+    RLMAssertThrowsWithReasonMatching([RLMQueryCondition conditionMatchingAny:nil], @"must not be nil");
+#pragma clang diagnostic pop
+}
+
 - (void)testArrayIn
 {
     RLMRealm *realm = [self realm];
@@ -2415,6 +3231,59 @@
     RLMAssertThrowsWithReasonMatching(([IntegerArrayPropertyObject objectsWhere:@"array.@sum.intCol == 1.23"]), @"@sum.*type int cannot be compared");
 }
 
+- (void)testListAggregatesTrackChanges {
+    RLMRealm *realm = [self realm];
+    [realm beginWriteTransaction];
+    IntObject *five = [IntObject createInRealm:realm withValue:@[@5]];
+    IntObject *ten = [IntObject createInRealm:realm withValue:@[@10]];
+    IntegerArrayPropertyObject *both = [IntegerArrayPropertyObject createInRealm:realm withValue:@[@1, @[five, ten, five]]];
+    [IntegerArrayPropertyObject createInRealm:realm withValue:@[@2, @[ten]]];
+    IntegerArrayPropertyObject *empty = [IntegerArrayPropertyObject createInRealm:realm withValue:@[@3, @[]]];
+    [realm commitWriteTransaction];
+
+    // Objects which are in a list more than once count each time
+    RLMAssertCount(IntegerArrayPropertyObject, 1U, @"array.@sum.intCol == 20");
+    RLMAssertCount(IntegerArrayPropertyObject, 2U, @"array.@sum.intCol >= 10");
+    RLMAssertCount(IntegerArrayPropertyObject, 2U, @"10 <= array.@sum.intCol");
+    RLMAssertCount(IntegerArrayPropertyObject, 1U, @"array.@avg.intCol < 7");
+    RLMAssertCount(IntegerArrayPropertyObject, 2U, @"array.@max.intCol == 10");
+    RLMAssertCount(IntegerArrayPropertyObject, 2U, @"array.@min.intCol != 5");
+    RLMAssertCount(IntegerArrayPropertyObject, 1U, @"array.@sum.intCol == 0");
+
+    RLMResults *results = [IntegerArrayPropertyObject objectsWhere:@"array.@sum.intCol > 15"];
+    XCTAssertEqualObjects(@"listAggregate", [results explain][@"query"][@"strategy"]);
+    XCTAssertEqual(1U, results.count);
+
+    [realm beginWriteTransaction];
+    [empty.array addObject:ten];
+    [empty.array addObject:ten];
+    [realm commitWriteTransaction];
+    XCTAssertEqual(2U, results.count);
+
+    [realm beginWriteTransaction];
+    ten.intCol = 1;
+    [both.array removeLastObject];
+    [realm commitWriteTransaction];
+    XCTAssertEqual(0U, results.count);
+    RLMAssertCount(IntegerArrayPropertyObject, 1U, @"array.@sum.intCol == 6");
+
+    // Results handed over to another thread compute the aggregates there
+    RLMResults *small = [IntegerArrayPropertyObject objectsWhere:@"array.@sum.intCol < 5"];
+    RLMThreadSafeReference *reference = [RLMThreadSafeReference referenceWithThreadConfined:small];
+    [self dispatchAsyncAndWait:^{
+        RLMRealm *realm = [self realm];
+        RLMResults *small = [realm resolveThreadSafeReference:reference];
+        XCTAssertEqual(2U, small.count);
+        [realm transactionWithBlock:^{
+            IntObject *one = [IntObject objectsInRealm:realm where:@"intCol == 1"].firstObject;
+            [IntegerArrayPropertyObject createInRealm:realm withValue:@[@4, @[one]]];
+        }];
+        XCTAssertEqual(3U, small.count);
+    }];
+    [realm refresh];
+    XCTAssertEqual(3U, small.count);
+}
+
 struct NullTestData {
     __unsafe_unretained NSString *propertyName;
     __unsafe_unretained NSString *nonMatchingStr;
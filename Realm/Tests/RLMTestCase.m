@@ -122,6 +122,7 @@ static BOOL encryptTests() {
     deleteOrThrow(fileURL);
     deleteOrThrow([fileURL URLByAppendingPathExtension:@"lock"]);
     deleteOrThrow([fileURL URLByAppendingPathExtension:@"note"]);
+    deleteOrThrow([fileURL URLByAppendingPathExtension:@"schema"]);
 }
 
 - (void)invokeTest {
@@ -100,6 +100,7 @@
     XCTAssertFalse(defaultConfiguration.readOnly);
     XCTAssertEqual(defaultConfiguration.schemaVersion, 0U);
     XCTAssertNil(defaultConfiguration.migrationBlock);
+    XCTAssertEqual(defaultConfiguration.notificationQualityOfService, NSQualityOfServiceDefault);
 
     // private properties
     XCTAssertFalse(defaultConfiguration.dynamic);
@@ -125,6 +126,20 @@
     XCTAssertNotEqualObjects(config.fileURL, RLMRealmConfiguration.defaultConfiguration.fileURL);
 }
 
+- (void)testNotificationQualityOfService {
+    RLMRealmConfiguration *config = [RLMRealmConfiguration defaultConfiguration];
+    config.inMemoryIdentifier = @"testNotificationQualityOfService";
+    config.notificationQualityOfService = NSQualityOfServiceUtility;
+    XCTAssertEqual([config copy].notificationQualityOfService, NSQualityOfServiceUtility);
+
+    // The opening thread's QoS is only changed while the file is opened
+    qos_class_t qos = qos_class_self();
+    @autoreleasepool {
+        XCTAssertNotNil([RLMRealm realmWithConfiguration:config error:nil]);
+    }
+    XCTAssertEqual(qos, qos_class_self());
+}
+
 - (void)testDefaultRealmUsesDefaultConfiguration {
     RLMRealmConfiguration *config = [RLMRealmConfiguration defaultConfiguration];
     @autoreleasepool { XCTAssertEqualObjects(RLMRealm.defaultRealm.configuration.fileURL, config.fileURL); }
@@ -188,4 +203,74 @@
     XCTAssertTrue(migrationCalled);
 }
 
+#pragma mark - Shards
+
+- (void)testConfigurationForShard {
+    RLMRealmConfiguration *configuration = [[RLMRealmConfiguration alloc] init];
+    configuration.fileURL = [NSURL fileURLWithPath:@"/tmp/data.realm"];
+    configuration.schemaVersion = 3;
+    RLMRealmConfiguration *shard = [configuration configurationForShard:2];
+    XCTAssertEqualObjects(shard.fileURL.path, @"/tmp/data.shard-2.realm");
+    XCTAssertEqual(shard.schemaVersion, 3U);
+    XCTAssertEqualObjects(configuration.fileURL.path, @"/tmp/data.realm");
+
+    configuration.fileURL = [NSURL fileURLWithPath:@"/tmp/data"];
+    XCTAssertEqualObjects([configuration configurationForShard:0].fileURL.path, @"/tmp/data.shard-0");
+
+    configuration.inMemoryIdentifier = @"data";
+    shard = [configuration configurationForShard:1];
+    XCTAssertNil(shard.fileURL);
+    XCTAssertEqualObjects(shard.inMemoryIdentifier, @"data.shard-1");
+}
+
+- (void)testShardForKey {
+    XCTAssertEqual([RLMRealmConfiguration shardForKey:@"a" shardCount:1], 0U);
+    for (NSUInteger i = 0; i < 100; ++i) {
+        NSUInteger shard = [RLMRealmConfiguration shardForKey:@(i) shardCount:7];
+        XCTAssertLessThan(shard, 7U);
+        XCTAssertEqual(shard, [RLMRealmConfiguration shardForKey:@(i) shardCount:7]);
+    }
+    // The shard of a key must never change, as objects are stored by it
+    XCTAssertEqual([RLMRealmConfiguration shardForKey:@"" shardCount:1000], 14695981039346656037ULL % 1000);
+    XCTAssertNotEqual([RLMRealmConfiguration shardForKey:@"a" shardCount:1000],
+                      [RLMRealmConfiguration shardForKey:@"b" shardCount:1000]);
+
+    RLMAssertThrowsWithReasonMatching([RLMRealmConfiguration shardForKey:@1.5 shardCount:2],
+                                      @"Invalid shard key '1.5'");
+    RLMAssertThrowsWithReasonMatching([RLMRealmConfiguration shardForKey:NSDate.date shardCount:2],
+                                      @"only strings and integers are supported");
+    RLMAssertThrowsWithReason([RLMRealmConfiguration shardForKey:@"a" shardCount:0],
+                              @"Shard count must be greater than zero.");
+}
+
+- (void)testObjectsInShards {
+    RLMRealmConfiguration *configuration = [[RLMRealmConfiguration alloc] init];
+    configuration.inMemoryIdentifier = @"sharded";
+    NSMutableArray *realms = [NSMutableArray array];
+    for (NSUInteger i = 0; i < 3; ++i) {
+        [realms addObject:[RLMRealm realmWithConfiguration:[configuration configurationForShard:i] error:nil]];
+    }
+    for (int value = 0; value < 30; ++value) {
+        RLMRealm *realm = realms[[RLMRealmConfiguration shardForKey:@(value) shardCount:realms.count]];
+        [realm transactionWithBlock:^{
+            [IntObject createInRealm:realm withValue:@[@(value % 10 == 0 ? 100 : value)]];
+        }];
+    }
+
+    NSArray *objects = [IntObject objectsInRealms:realms
+                                    withPredicate:[NSPredicate predicateWithFormat:@"intCol > 4"]
+                                  sortDescriptors:@[[RLMSortDescriptor sortDescriptorWithKeyPath:@"intCol" ascending:NO]]];
+    NSMutableArray *expected = [NSMutableArray arrayWithObjects:@100, @100, @100, nil];
+    for (int value = 29; value > 4; --value) {
+        if (value % 10 != 0) {
+            [expected addObject:@(value)];
+        }
+    }
+    XCTAssertEqualObjects([objects valueForKey:@"intCol"], expected);
+
+    objects = [IntObject objectsInRealms:realms withPredicate:nil sortDescriptors:@[]];
+    XCTAssertEqual(objects.count, 30U);
+    XCTAssertEqual([IntObject objectsInRealms:@[] withPredicate:nil sortDescriptors:@[]].count, 0U);
+}
+
 @end
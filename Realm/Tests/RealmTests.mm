@@ -19,8 +19,10 @@
 #import "RLMTestCase.h"
 
 #import "RLMObjectSchema_Private.hpp"
+#import "RLMProperty_Private.h"
 #import "RLMRealmConfiguration_Private.hpp"
 #import "RLMRealm_Dynamic.h"
+#import "RLMRealm_Private.h"
 #import "RLMSchema_Private.h"
 #import "RLMRealmUtil.hpp"
 
@@ -45,6 +47,82 @@
 @property (nonatomic, readwrite, copy) NSArray *objectSchema;
 @end
 
+@interface ExpiringObject : RLMObject
+@property NSString *name;
+@property NSDate *expiresAt;
+@end
+
+@implementation ExpiringObject
++ (BOOL)shouldIncludeInDefaultSchema {
+    return NO;
+}
++ (NSString *)expirationProperty {
+    return @"expiresAt";
+}
+@end
+
+@interface InvalidExpiringObject : RLMObject
+@property NSString *expiresAt;
+@end
+
+@implementation InvalidExpiringObject
++ (BOOL)shouldIncludeInDefaultSchema {
+    return NO;
+}
++ (NSString *)expirationProperty {
+    return @"expiresAt";
+}
+@end
+
+@interface DeferredIndexObject : RLMObject
+@property int intCol;
+@end
+
+@implementation DeferredIndexObject
++ (BOOL)shouldIncludeInDefaultSchema {
+    return NO;
+}
++ (NSArray *)deferredIndexedProperties {
+    return @[@"intCol"];
+}
+@end
+
+@interface InvalidDeferredIndexObject : RLMObject
+@property double doubleCol;
+@end
+
+@implementation InvalidDeferredIndexObject
++ (BOOL)shouldIncludeInDefaultSchema {
+    return NO;
+}
++ (NSArray *)deferredIndexedProperties {
+    return @[@"doubleCol"];
+}
+@end
+
+@interface GeneratedDefaultsObject : RLMObject
+@property int intCol;
+@property NSString *uuid;
+@property IntObject *link;
+@end
+
+@implementation GeneratedDefaultsObject
++ (NSDictionary *)defaultPropertyValues {
+    return @{@"uuid": NSUUID.UUID.UUIDString, @"link": @[@7]};
+}
+@end
+
+@interface InvalidLinkDefaultObject : RLMObject
+@property int intCol;
+@property IntObject *link;
+@end
+
+@implementation InvalidLinkDefaultObject
++ (NSDictionary *)defaultPropertyValues {
+    return @{@"link": @[@"not an int"]};
+}
+@end
+
 @interface RealmTests : RLMTestCase
 @end
 
@@ -364,14 +442,73 @@
         [ex fulfill];
     }];
     XCTAssertFalse(fileExists());
+    assertNoCachedRealm();
     flock(fd, LOCK_UN);
     close(fd);
-    assertNoCachedRealm();
     [self waitForExpectationsWithTimeout:1 handler:nil];
     XCTAssertTrue(fileExists());
     assertNoCachedRealm();
 }
 
+- (void)testPrewarm {
+    RLMRealmConfiguration *c = [RLMRealmConfiguration defaultConfiguration];
+
+    // Unsuccessful open
+    c.readOnly = true;
+    XCTestExpectation *ex = [self expectationWithDescription:@"prewarm"];
+    [RLMRealm prewarmWithConfiguration:c queries:^NSArray<RLMResults *> *(RLMRealm *) {
+        XCTFail(@"queries should not be called if the Realm can't be opened");
+        return @[];
+    } completion:^(RLMRealm *realm, NSArray<RLMResults *> *results, NSError *error) {
+        XCTAssertEqual(error.code, RLMErrorFileNotFound);
+        XCTAssertNil(realm);
+        XCTAssertNil(results);
+        [ex fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:1 handler:nil];
+
+    c.readOnly = false;
+    @autoreleasepool {
+        RLMRealm *realm = [RLMRealm realmWithConfiguration:c error:nil];
+        [realm transactionWithBlock:^{
+            for (int i = 0; i < 10; ++i) {
+                [IntObject createInRealm:realm withValue:@[@(i)]];
+                [StringObject createInRealm:realm withValue:@[@(i).stringValue]];
+            }
+        }];
+    }
+
+    ex = [self expectationWithDescription:@"prewarm"];
+    [RLMRealm prewarmWithConfiguration:c queries:^NSArray<RLMResults *> *(RLMRealm *realm) {
+        XCTAssertFalse([NSThread isMainThread]);
+        return @[[[IntObject objectsInRealm:realm where:@"intCol >= 5"] sortedResultsUsingKeyPath:@"intCol" ascending:NO],
+                 [StringObject allObjectsInRealm:realm]];
+    } completion:^(RLMRealm *realm, NSArray<RLMResults *> *results, NSError *error) {
+        XCTAssertTrue([NSThread isMainThread]);
+        XCTAssertNil(error);
+        XCTAssertNotNil(realm);
+        XCTAssertEqual(results.count, 2U);
+        XCTAssertEqual(results[0].realm, realm);
+        XCTAssertEqualObjects([results[0] valueForKey:@"intCol"], (@[@9, @8, @7, @6, @5]));
+        XCTAssertEqual(results[1].count, 10U);
+        [ex fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+
+    // Invalid results are reported to the completion block
+    ex = [self expectationWithDescription:@"prewarm"];
+    [RLMRealm prewarmWithConfiguration:c queries:^NSArray<RLMResults *> *(RLMRealm *) {
+        return (NSArray *)@[@"not results"];
+    } completion:^(RLMRealm *realm, NSArray<RLMResults *> *results, NSError *error) {
+        XCTAssertNil(realm);
+        XCTAssertNil(results);
+        XCTAssertNotNil(error);
+        XCTAssertTrue([error.localizedDescription containsString:@"must be RLMResults"]);
+        [ex fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+}
+
 #pragma mark - Adding and Removing Objects
 
 - (void)testRealmAddAndRemoveObjects {
@@ -741,6 +878,42 @@
     XCTAssertEqual(1U, CompanyObject.allObjects.count);
 }
 
+- (void)testDeleteObjectsOfSeveralClassesFromArray {
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm beginWriteTransaction];
+    NSMutableArray *objects = [NSMutableArray array];
+    for (int i = 0; i < 10; ++i) {
+        [IntObject createInRealm:realm withValue:@[@(i)]];
+        [StringObject createInRealm:realm withValue:@[[@(i) stringValue]]];
+    }
+    RLMResults *ints = [IntObject objectsInRealm:realm where:@"intCol >= 5"];
+    RLMResults *strings = [StringObject objectsInRealm:realm where:@"stringCol < '3'"];
+    for (NSUInteger i = 0; i < ints.count; ++i) {
+        [objects addObject:ints[i]];
+        [objects addObject:strings[i % strings.count]];
+    }
+    [objects addObject:@"not an object"];
+
+    // Unmanaged objects can't be deleted, and leave all of the objects as-is
+    IntObject *unmanaged = [[IntObject alloc] initWithValue:@[@1]];
+    RLMAssertThrowsWithReason([realm deleteObjects:[objects arrayByAddingObject:unmanaged]],
+                              @"Can only delete an object from the Realm it belongs to.");
+    XCTAssertEqual([IntObject allObjectsInRealm:realm].count, 10U);
+    XCTAssertEqual([objects.firstObject realm], realm);
+
+    [realm deleteObjects:objects];
+    [realm commitWriteTransaction];
+
+    for (RLMObject *object in objects) {
+        if ([object isKindOfClass:[RLMObject class]] && object.realm) {
+            XCTFail(@"%@ still belongs to a Realm", object);
+        }
+    }
+    XCTAssertEqualObjects([[IntObject allObjectsInRealm:realm] valueForKey:@"intCol"], (@[@0, @1, @2, @3, @4]));
+    XCTAssertEqualObjects([[[StringObject allObjectsInRealm:realm] sortedResultsUsingKeyPath:@"stringCol" ascending:YES]
+                           valueForKey:@"stringCol"], (@[@"3", @"4", @"5", @"6", @"7", @"8", @"9"]));
+}
+
 - (void)testDeleteAllObjects {
     RLMRealm *realm = [RLMRealm defaultRealm];
 
@@ -791,6 +964,291 @@
     XCTAssertEqualObjects([objects.firstObject stringCol], @"b", @"Expecting column to be 'b'");
 }
 
+- (void)testAsyncWriteTransaction {
+    RLMRealm *realm = [self realmWithTestPath];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"async write"];
+    __block NSThread *writeThread;
+    [realm beginAsyncWriteTransaction:^(RLMRealm *backgroundRealm) {
+        writeThread = NSThread.currentThread;
+        XCTAssertTrue(backgroundRealm.inWriteTransaction);
+        [StringObject createInRealm:backgroundRealm withValue:@[@"b"]];
+    } completion:^(NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertTrue(NSThread.isMainThread);
+        XCTAssertEqual([StringObject allObjectsInRealm:realm].count, 1U);
+        [expectation fulfill];
+    }];
+    XCTAssertEqual([StringObject allObjectsInRealm:realm].count, 0U);
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+    XCTAssertNotEqual(writeThread, NSThread.currentThread);
+
+    expectation = [self expectationWithDescription:@"cancelled async write"];
+    [realm beginAsyncWriteTransaction:^(RLMRealm *backgroundRealm) {
+        [StringObject createInRealm:backgroundRealm withValue:@[@"c"]];
+        [backgroundRealm cancelWriteTransaction];
+    } completion:^(NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertEqual([StringObject allObjectsInRealm:realm].count, 1U);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+
+    [self dispatchAsyncAndWait:^{
+        RLMRealm *realm = [self realmWithTestPath];
+        RLMAssertThrowsWithReason([realm beginAsyncWriteTransaction:^(RLMRealm *) {} completion:nil],
+                                  @"within runloops");
+    }];
+}
+
+- (void)testGroupedAsyncWriteTransactions {
+    RLMRealmConfiguration *configuration = [RLMRealmConfiguration defaultConfiguration];
+    configuration.asyncWriteGroupingInterval = 0.1;
+    RLMRealm *realm = [RLMRealm realmWithConfiguration:configuration error:nil];
+
+    __block RLMRealm *groupRealm;
+    __block int completed = 0;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"grouped async writes"];
+    for (int i = 0; i < 3; ++i) {
+        [realm beginAsyncWriteTransaction:^(RLMRealm *backgroundRealm) {
+            // all of the writes are performed in the same transaction
+            XCTAssertEqual([IntObject allObjectsInRealm:backgroundRealm].count, (NSUInteger)i);
+            if (i == 0) {
+                groupRealm = backgroundRealm;
+            }
+            XCTAssertEqual(groupRealm, backgroundRealm);
+            [IntObject createInRealm:backgroundRealm withValue:@[@(i)]];
+        } completion:^(NSError *error) {
+            XCTAssertNil(error);
+            XCTAssertEqual([IntObject allObjectsInRealm:realm].count, 3U);
+            if (++completed == 3) {
+                [expectation fulfill];
+            }
+        }];
+    }
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+}
+
+- (void)testGroupedAsyncWriteCancelledOnlyDiscardsItsOwnChanges {
+    RLMRealmConfiguration *configuration = [RLMRealmConfiguration defaultConfiguration];
+    configuration.asyncWriteGroupingInterval = 0.1;
+    RLMRealm *realm = [RLMRealm realmWithConfiguration:configuration error:nil];
+
+    __block int completed = 0;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"grouped async writes"];
+    for (int i = 0; i < 3; ++i) {
+        [realm beginAsyncWriteTransaction:^(RLMRealm *backgroundRealm) {
+            [IntObject createInRealm:backgroundRealm withValue:@[@(i)]];
+            if (i == 1) {
+                [backgroundRealm cancelWriteTransaction];
+            }
+        } completion:^(NSError *error) {
+            XCTAssertNil(error);
+            if (++completed == 3) {
+                [expectation fulfill];
+            }
+        }];
+    }
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+    [realm refresh];
+    XCTAssertEqualObjects([[[IntObject allObjectsInRealm:realm] sortedResultsUsingKeyPath:@"intCol" ascending:YES]
+                           valueForKey:@"intCol"], (@[@0, @2]));
+}
+
+- (void)testPerformWithConfiguration {
+    RLMRealmConfiguration *configuration = [RLMRealmConfiguration defaultConfiguration];
+    __block __weak RLMRealm *weakRealm;
+    __block IntObject *obj;
+    XCTAssertTrue([RLMRealm performWithConfiguration:configuration error:nil block:^(RLMRealm *realm) {
+        weakRealm = realm;
+        [realm transactionWithBlock:^{
+            obj = [IntObject createInRealm:realm withValue:@[@1]];
+        }];
+    }]);
+    // The object keeps the Realm alive, but it no longer has a read transaction
+    XCTAssertTrue(obj.invalidated);
+    obj = nil;
+    XCTAssertNil(weakRealm);
+
+    // An open write transaction is cancelled
+    XCTAssertTrue([RLMRealm performWithConfiguration:configuration error:nil block:^(RLMRealm *realm) {
+        [realm beginWriteTransaction];
+        [IntObject createInRealm:realm withValue:@[@2]];
+    }]);
+
+    // An exception thrown by the block propagates once the write is cancelled
+    RLMAssertThrowsWithReasonMatching([RLMRealm performWithConfiguration:configuration error:nil block:^(RLMRealm *realm) {
+        [realm beginWriteTransaction];
+        [IntObject createInRealm:realm withValue:@[@3]];
+        @throw [NSException exceptionWithName:@"TestException" reason:@"block failed" userInfo:nil];
+    }], @"block failed");
+
+    // A Realm which was already open is not invalidated
+    RLMRealm *realm = [RLMRealm realmWithConfiguration:configuration error:nil];
+    RLMResults *objects = [IntObject allObjectsInRealm:realm];
+    XCTAssertTrue([RLMRealm performWithConfiguration:configuration error:nil block:^(RLMRealm *inner) {
+        XCTAssertEqual(realm, inner);
+    }]);
+    XCTAssertEqual(1U, objects.count);
+
+    configuration.fileURL = [NSURL fileURLWithPath:@"/tmp/RLMTestDirMayNotExist/foo"];
+    NSError *error;
+    __block bool called = false;
+    XCTAssertFalse([RLMRealm performWithConfiguration:configuration error:&error block:^(RLMRealm *) {
+        called = true;
+    }]);
+    XCTAssertNotNil(error);
+    XCTAssertFalse(called);
+}
+
+- (void)testReleaseCachedResources {
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm transactionWithBlock:^{
+        [IntObject createInRealm:realm withValue:@[@1]];
+        [IntObject createInRealm:realm withValue:@[@2]];
+    }];
+    XCTAssertEqual(1U, [IntObject objectsInRealm:realm where:@"intCol > 1"].count);
+
+    // Queries rebuild their caches after they're released
+    [RLMRealm releaseCachedResourcesWithLevel:RLMCacheReleaseLevelModerate];
+    XCTAssertEqual(1U, [IntObject objectsInRealm:realm where:@"intCol > 1"].count);
+
+    // An idle Realm which autorefreshes is advanced to the latest version
+    [self dispatchAsyncAndWait:^{
+        RLMRealm *realm = [RLMRealm defaultRealm];
+        [realm transactionWithBlock:^{
+            [IntObject createInRealm:realm withValue:@[@3]];
+        }];
+    }];
+    [RLMRealm releaseCachedResourcesWithLevel:RLMCacheReleaseLevelCritical];
+    XCTAssertEqual(3U, [IntObject allObjectsInRealm:realm].count);
+}
+
+- (void)testLongReadTransactionHandler {
+    RLMRealmConfiguration *configuration = [RLMRealmConfiguration defaultConfiguration];
+    configuration.fileURL = RLMTestRealmURL();
+    RLMRealmConfiguration *watchedConfiguration = [configuration copy];
+    XCTAssertEqual(60, watchedConfiguration.longReadTransactionThreshold);
+    XCTAssertFalse(watchedConfiguration.advancesLongReadTransactions);
+
+    XCTestExpectation *expectation = [self expectationWithDescription:@"long read transaction reported"];
+    watchedConfiguration.longReadTransactionThreshold = 0.05;
+    watchedConfiguration.longReadTransactionHandler = ^(NSDictionary *details, NSTimeInterval age) {
+        XCTAssertEqualObjects(details[@"realmPath"], RLMTestRealmURL().path);
+        XCTAssertEqualObjects(details[@"threadName"], @"main");
+        XCTAssertGreaterThan(age, 0.05);
+        [expectation fulfill];
+    };
+
+    RLMRealm *realm = [RLMRealm realmWithConfiguration:watchedConfiguration error:nil];
+    realm.autorefresh = NO;
+    XCTAssertEqual(0U, [IntObject allObjectsInRealm:realm].count);
+
+    // reading the latest version isn't reported no matter how long it's read
+    [NSThread sleepForTimeInterval:0.2];
+
+    [self dispatchAsyncAndWait:^{
+        RLMRealm *otherRealm = [RLMRealm realmWithConfiguration:configuration error:nil];
+        [otherRealm transactionWithBlock:^{
+            [IntObject createInRealm:otherRealm withValue:@[@1]];
+        }];
+    }];
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+    XCTAssertEqual(0U, [IntObject allObjectsInRealm:realm].count);
+}
+
+- (void)testWriteQueue {
+    // The queues live for the rest of the process, so use an in-memory Realm
+    // which no other test or run uses
+    RLMRealmConfiguration *configuration = [RLMRealmConfiguration defaultConfiguration];
+    configuration.inMemoryIdentifier = NSUUID.UUID.UUIDString;
+    RLMRealm *realm = [RLMRealm realmWithConfiguration:configuration error:nil];
+
+    RLMWriteQueue *queue = configuration.writeQueue;
+    XCTAssertEqual(queue, [configuration copy].writeQueue);
+    queue.maximumWritesPerTransaction = 2;
+
+    __block NSThread *writeThread;
+    __block __weak RLMRealm *weakQueueRealm;
+    __block int completed = 0;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"queued writes"];
+    for (int i = 0; i < 5; ++i) {
+        [queue enqueueWrite:^(RLMRealm *queueRealm) {
+            XCTAssertTrue(queueRealm.inWriteTransaction);
+            weakQueueRealm = queueRealm;
+            if (!writeThread) {
+                writeThread = NSThread.currentThread;
+            }
+            XCTAssertEqual(writeThread, NSThread.currentThread);
+            [IntObject createInRealm:queueRealm withValue:@[@(i)]];
+        } completion:^(NSError *error) {
+            XCTAssertNil(error);
+            XCTAssertTrue(NSThread.isMainThread);
+            if (++completed == 5) {
+                [expectation fulfill];
+            }
+        }];
+    }
+    [queue waitUntilAllWritesAreFinished];
+    [realm refresh];
+    XCTAssertEqual([IntObject allObjectsInRealm:realm].count, 5U);
+    XCTAssertNotEqual(writeThread, NSThread.currentThread);
+    // The queue closes its Realm once it has drained
+    XCTAssertNil(weakQueueRealm);
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+
+    expectation = [self expectationWithDescription:@"failed write"];
+    [queue enqueueWrite:^(RLMRealm *queueRealm) {
+        [IntObject createInRealm:queueRealm withValue:@[@"not an int"]];
+    } completion:^(NSError *error) {
+        XCTAssertNotNil(error);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+    [realm refresh];
+    XCTAssertEqual([IntObject allObjectsInRealm:realm].count, 5U);
+
+    configuration.readOnly = YES;
+    RLMAssertThrowsWithReason(configuration.writeQueue, @"read-only");
+}
+
+- (void)testWriteQueueRetriesOtherWritesAfterFailure {
+    RLMRealmConfiguration *configuration = [RLMRealmConfiguration defaultConfiguration];
+    configuration.inMemoryIdentifier = NSUUID.UUID.UUIDString;
+    configuration.asyncWriteGroupingInterval = 0.1;
+    RLMRealm *realm = [RLMRealm realmWithConfiguration:configuration error:nil];
+    RLMWriteQueue *queue = configuration.writeQueue;
+
+    // The writes are grouped into one transaction, which the second fails
+    NSMutableArray *errors = [NSMutableArray new];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"queued writes"];
+    for (int i = 0; i < 4; ++i) {
+        [queue enqueueWrite:^(RLMRealm *queueRealm) {
+            [IntObject createInRealm:queueRealm withValue:@[i == 1 ? @"not an int" : @(i)]];
+            if (i == 2) {
+                [queueRealm cancelWriteTransaction];
+            }
+        } completion:^(NSError *error) {
+            [errors addObject:@[@(i), error ?: NSNull.null]];
+            if (errors.count == 4) {
+                [expectation fulfill];
+            }
+        }];
+    }
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+
+    for (NSArray *result in errors) {
+        if ([result[0] intValue] == 1) {
+            XCTAssertNotEqual(result[1], NSNull.null);
+        }
+        else {
+            XCTAssertEqual(result[1], NSNull.null);
+        }
+    }
+    [realm refresh];
+    XCTAssertEqualObjects([[[IntObject allObjectsInRealm:realm] sortedResultsUsingKeyPath:@"intCol" ascending:YES]
+                           valueForKey:@"intCol"], (@[@0, @3]));
+}
+
 - (void)testInWriteTransaction {
     RLMRealm *realm = [self realmWithTestPath];
     XCTAssertFalse(realm.inWriteTransaction);
@@ -1028,6 +1486,90 @@
     [self waitForExpectationsWithTimeout:2.0 handler:nil];
 }
 
+- (void)testBeginWriteTransactionWithTimeout {
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    NSDictionary *initialStatistics = [RLMRealm writeLockStatistics];
+
+    NSError *error;
+    XCTAssertTrue([realm beginWriteTransactionWithTimeout:1.0 error:&error]);
+    XCTAssertNil(error);
+    XCTAssertTrue(realm.inWriteTransaction);
+    XCTAssertEqual(1U, [[RLMRealm writeLockStatistics][@"holders"] count]);
+    [realm cancelWriteTransaction];
+    XCTAssertEqual(0U, [[RLMRealm writeLockStatistics][@"holders"] count]);
+
+    // Hold the write lock on a background thread until the main thread has
+    // timed out waiting for it
+    dispatch_semaphore_t locked = dispatch_semaphore_create(0);
+    dispatch_semaphore_t timedOut = dispatch_semaphore_create(0);
+    [self dispatchAsync:^{
+        RLMRealm *realm = [RLMRealm defaultRealm];
+        [realm beginWriteTransaction];
+        dispatch_semaphore_signal(locked);
+        dispatch_semaphore_wait(timedOut, DISPATCH_TIME_FOREVER);
+        [realm commitWriteTransaction];
+    }];
+    dispatch_semaphore_wait(locked, DISPATCH_TIME_FOREVER);
+
+    XCTAssertFalse([realm beginWriteTransactionWithTimeout:0.1 error:&error]);
+    XCTAssertFalse(realm.inWriteTransaction);
+    XCTAssertEqual(RLMErrorWriteLockTimeout, error.code);
+    XCTAssertTrue([error.localizedDescription containsString:@"in this process"]);
+    dispatch_semaphore_signal(timedOut);
+
+    error = nil;
+    XCTAssertTrue([realm beginWriteTransactionWithTimeout:5.0 error:&error]);
+    XCTAssertNil(error);
+    [realm commitWriteTransaction];
+    [self dispatchAsyncAndWait:^{}];
+
+    NSDictionary *statistics = [RLMRealm writeLockStatistics];
+    XCTAssertEqual([initialStatistics[@"timeouts"] unsignedIntegerValue] + 1,
+                   [statistics[@"timeouts"] unsignedIntegerValue]);
+    XCTAssertEqual([initialStatistics[@"waits"][@"count"] unsignedIntegerValue] + 3,
+                   [statistics[@"waits"][@"count"] unsignedIntegerValue]);
+    XCTAssertEqual([initialStatistics[@"holds"][@"count"] unsignedIntegerValue] + 3,
+                   [statistics[@"holds"][@"count"] unsignedIntegerValue]);
+    XCTAssertEqual(5U, [statistics[@"waits"][@"histogram"] count]);
+}
+
+- (void)testSlowOperationHandler {
+    NSMutableArray<NSNumber *> *operations = [NSMutableArray array];
+    NSMutableArray<NSDictionary *> *details = [NSMutableArray array];
+    RLMRealmConfiguration *config = [RLMRealmConfiguration defaultConfiguration];
+    config.fileURL = RLMTestRealmURL();
+    XCTAssertEqual(0.1, config.slowOperationThreshold);
+    config.slowOperationThreshold = 0;
+    config.slowOperationHandler = ^(RLMSlowOperation operation, NSDictionary *info, NSTimeInterval duration) {
+        XCTAssertGreaterThan(duration, 0);
+        [operations addObject:@(operation)];
+        [details addObject:info];
+        // Operations performed by the handler aren't reported
+        (void)[StringObject allObjectsInRealm:[RLMRealm realmWithConfiguration:config error:nil]].count;
+    };
+
+    RLMRealm *realm = [RLMRealm realmWithConfiguration:config error:nil];
+    XCTAssertNotNil(realm.configuration.slowOperationHandler);
+    [realm transactionWithBlock:^{
+        [StringObject createInRealm:realm withValue:@[@"a"]];
+        [StringObject createInRealm:realm withValue:@[@"b"]];
+    }];
+    XCTAssertEqualObjects(operations, @[@(RLMSlowOperationWriteTransaction)]);
+    XCTAssertEqualObjects(details[0][@"realmPath"], RLMTestRealmURL().path);
+    XCTAssertNotNil(details[0][@"commitTime"]);
+
+    [operations removeAllObjects];
+    [details removeAllObjects];
+    RLMResults *results = [[StringObject objectsInRealm:realm where:@"stringCol = 'a'"]
+                           sortedResultsUsingKeyPath:@"stringCol" ascending:NO];
+    XCTAssertEqual(1U, results.count);
+    XCTAssertEqualObjects(operations, @[@(RLMSlowOperationQuery)]);
+    XCTAssertEqualObjects(details[0][@"className"], @"StringObject");
+    XCTAssertEqualObjects(details[0][@"predicate"], @"stringCol == \"a\"");
+    XCTAssertEqualObjects(details[0][@"sortDescriptors"], @[@"-stringCol"]);
+    XCTAssertEqualObjects(details[0][@"rowCount"], @2);
+}
+
 - (void)testReadOnlyRealmIsImmutable
 {
     @autoreleasepool { [self realmWithTestPath]; }
@@ -1408,6 +1950,115 @@
     XCTAssertThrows([RLMRealm.defaultRealm cancelWriteTransaction]);
 }
 
+#pragma mark - Expiring Objects
+
+- (RLMRealmConfiguration *)expiringObjectConfiguration {
+    RLMRealmConfiguration *config = [RLMRealmConfiguration defaultConfiguration];
+    config.fileURL = RLMTestRealmURL();
+    config.objectClasses = @[ExpiringObject.class];
+    return config;
+}
+
+- (void)testExpirationPropertyIsIndexed {
+    RLMObjectSchema *objectSchema = [RLMObjectSchema schemaForObjectClass:ExpiringObject.class];
+    XCTAssertEqualObjects(objectSchema.expirationProperty.name, @"expiresAt");
+    XCTAssertTrue(objectSchema.expirationProperty.indexed);
+    XCTAssertNil([RLMObjectSchema schemaForObjectClass:IntObject.class].expirationProperty);
+
+    RLMAssertThrowsWithReasonMatching([RLMObjectSchema schemaForObjectClass:InvalidExpiringObject.class],
+                                      @"cannot hold the expiration date of 'InvalidExpiringObject'");
+}
+
+- (void)testExpiredObjectsArePurgedInTheBackground {
+    RLMRealm *realm = [RLMRealm realmWithConfiguration:self.expiringObjectConfiguration error:nil];
+    NSDate *future = [NSDate dateWithTimeIntervalSinceNow:3600];
+
+    XCTestExpectation *expectation = [self expectationWithDescription:@"expired objects purged"];
+    RLMNotificationToken *token = [[ExpiringObject allObjectsInRealm:realm] addNotificationBlock:^(RLMResults *results, RLMCollectionChange *change, NSError *) {
+        if (change && results.count == 2) {
+            [expectation fulfill];
+        }
+    }];
+
+    [realm transactionWithBlock:^{
+        for (int i = 0; i < 600; ++i) {
+            [ExpiringObject createInRealm:realm withValue:@[@"expired", [NSDate dateWithTimeIntervalSinceNow:-i - 1]]];
+        }
+        [ExpiringObject createInRealm:realm withValue:@[@"future", future]];
+        [ExpiringObject createInRealm:realm withValue:@[@"never", NSNull.null]];
+    }];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    [token stop];
+
+    XCTAssertEqualObjects([[[ExpiringObject allObjectsInRealm:realm] sortedResultsUsingKeyPath:@"name" ascending:YES] valueForKey:@"name"],
+                          (@[@"future", @"never"]));
+    XCTAssertEqualWithAccuracy(realm.earliestExpirationDate.timeIntervalSince1970, future.timeIntervalSince1970, 0.001);
+}
+
+- (void)testPurgeExpiredObjects {
+    RLMRealm *realm = [RLMRealm realmWithConfiguration:self.expiringObjectConfiguration error:nil];
+    XCTAssertNil(realm.earliestExpirationDate);
+
+    [realm beginWriteTransaction];
+    for (int i = 0; i < 25; ++i) {
+        [ExpiringObject createInRealm:realm withValue:@[@"expired", [NSDate dateWithTimeIntervalSinceNow:-i - 1]]];
+    }
+    [ExpiringObject createInRealm:realm withValue:@[@"future", [NSDate dateWithTimeIntervalSinceNow:3600]]];
+    XCTAssertThrows([realm purgeExpiredObjectsWithBatchSize:10]);
+    [realm commitWriteTransaction];
+
+    // a purge may already have started in the background, so only the end
+    // result is deterministic
+    XCTAssertThrows([realm purgeExpiredObjectsWithBatchSize:0]);
+    XCTAssertLessThanOrEqual([realm purgeExpiredObjectsWithBatchSize:10], 25U);
+    XCTAssertEqualObjects([[ExpiringObject allObjectsInRealm:realm] valueForKey:@"name"], @[@"future"]);
+    XCTAssertEqual(0U, [realm purgeExpiredObjectsWithBatchSize:10]);
+}
+
+#pragma mark - Deferred Indexes
+
+- (void)testDeferredIndexIsBuiltInTheBackground {
+    RLMObjectSchema *objectSchema = [RLMObjectSchema schemaForObjectClass:DeferredIndexObject.class];
+    XCTAssertTrue(objectSchema[@"intCol"].indexed);
+
+    // create the table without the index
+    @autoreleasepool {
+        RLMObjectSchema *unindexed = [objectSchema copy];
+        unindexed.objectClass = RLMObject.class;
+        unindexed[@"intCol"].indexed = NO;
+        unindexed[@"intCol"].deferredIndex = NO;
+
+        RLMSchema *schema = [[RLMSchema alloc] init];
+        schema.objectSchema = @[unindexed];
+        RLMRealm *realm = [self realmWithTestPathAndSchema:schema];
+        [realm transactionWithBlock:^{
+            for (int i = 0; i < 10; ++i) {
+                [realm createObject:DeferredIndexObject.className withValue:@[@(i)]];
+            }
+        }];
+    }
+
+    RLMRealmConfiguration *config = [RLMRealmConfiguration defaultConfiguration];
+    config.fileURL = RLMTestRealmURL();
+    config.objectClasses = @[DeferredIndexObject.class];
+    @autoreleasepool {
+        RLMRealm *realm = [RLMRealm realmWithConfiguration:config error:nil];
+        XCTAssertEqual(1U, [DeferredIndexObject objectsInRealm:realm where:@"intCol = 3"].count);
+    }
+    RLMWaitForDeferredIndexBuilds();
+
+    config.objectClasses = nil;
+    config.dynamic = YES;
+    RLMRealm *realm = [RLMRealm realmWithConfiguration:config error:nil];
+    XCTAssertTrue(realm.schema[DeferredIndexObject.className][@"intCol"].indexed);
+    XCTAssertEqual(1U, [[realm allObjects:DeferredIndexObject.className] objectsWhere:@"intCol = 3"].count);
+}
+
+- (void)testDeferredIndexedPropertiesAreValidated {
+    RLMAssertThrowsWithReasonMatching([RLMObjectSchema schemaForObjectClass:InvalidDeferredIndexObject.class],
+                                      @"'InvalidDeferredIndexObject.doubleCol' of type 'double' cannot be indexed");
+}
+
 #pragma mark - Threads
 
 - (void)testCrossThreadAccess
@@ -1421,6 +2072,23 @@
     }];
 }
 
+- (void)testRealmInstancesAreCachedPerThread {
+    __weak RLMRealm *weakRealm;
+    @autoreleasepool {
+        RLMRealm *realm = [self realmWithTestPath];
+        weakRealm = realm;
+        XCTAssertEqual(realm, [self realmWithTestPath]);
+        [self dispatchAsyncAndWait:^{
+            RLMRealm *otherRealm = [self realmWithTestPath];
+            XCTAssertNotEqual(realm, otherRealm);
+            XCTAssertEqual(otherRealm, [self realmWithTestPath]);
+        }];
+        XCTAssertEqual(realm, [self realmWithTestPath]);
+    }
+    XCTAssertNil(weakRealm);
+    XCTAssertNil(RLMGetThreadLocalCachedRealmForPath(RLMTestRealmURL().path.UTF8String));
+}
+
 - (void)testHoldRealmAfterSourceThreadIsDestroyed {
     RLMRealm *realm;
 
@@ -1594,6 +2262,214 @@
     XCTAssertEqual(1U, [IntObject allObjectsInRealm:copy].count);
 }
 
+- (void)testSeedFileURL
+{
+    NSURL *seedURL = [RLMTestRealmURL().URLByDeletingLastPathComponent URLByAppendingPathComponent:@"seed.realm"];
+    @autoreleasepool {
+        RLMRealm *realm = [RLMRealm defaultRealm];
+        [realm transactionWithBlock:^{
+            [IntObject createInRealm:realm withValue:@[@1]];
+        }];
+        XCTAssertTrue([realm writeCopyToURL:seedURL encryptionKey:nil error:nil]);
+    }
+    NSData *seedContents = [NSData dataWithContentsOfURL:seedURL];
+
+    RLMRealmConfiguration *configuration = [RLMRealmConfiguration defaultConfiguration];
+    configuration.fileURL = RLMTestRealmURL();
+    configuration.seedFileURL = seedURL;
+    @autoreleasepool {
+        RLMRealm *realm = [RLMRealm realmWithConfiguration:configuration error:nil];
+        XCTAssertEqual(1U, [IntObject allObjectsInRealm:realm].count);
+        [realm transactionWithBlock:^{
+            [IntObject createInRealm:realm withValue:@[@2]];
+        }];
+    }
+
+    // Reopening uses the existing file rather than cloning the seed again
+    @autoreleasepool {
+        RLMRealm *realm = [RLMRealm realmWithConfiguration:configuration error:nil];
+        XCTAssertEqual(2U, [IntObject allObjectsInRealm:realm].count);
+    }
+    XCTAssertEqualObjects(seedContents, [NSData dataWithContentsOfURL:seedURL]);
+
+    configuration.fileURL = [seedURL URLByAppendingPathExtension:@"missing"];
+    configuration.seedFileURL = [seedURL URLByDeletingPathExtension];
+    NSError *error;
+    XCTAssertNil([RLMRealm realmWithConfiguration:configuration error:&error]);
+    XCTAssertEqual(error.code, RLMErrorFileAccess);
+
+    [self deleteRealmFileAtURL:seedURL];
+}
+
+- (void)testCopyObjectsFromRealm
+{
+    RLMRealmConfiguration *configuration = [RLMRealmConfiguration defaultConfiguration];
+    configuration.inMemoryIdentifier = @"testCopyObjectsFromRealm";
+    RLMRealm *source = [RLMRealm realmWithConfiguration:configuration error:nil];
+    RLMRealm *realm = [RLMRealm defaultRealm];
+
+    __block PrimaryCompanyObject *company;
+    __block CircleObject *circle;
+    [source transactionWithBlock:^{
+        PrimaryEmployeeObject *alice = [PrimaryEmployeeObject createInRealm:source withValue:@[@"Alice", @30, @YES]];
+        PrimaryEmployeeObject *bob = [PrimaryEmployeeObject createInRealm:source withValue:@[@"Bob", @40, @NO]];
+        company = [PrimaryCompanyObject createInRealm:source withValue:@[@"Realm", @[alice, bob, alice], bob, @[bob]]];
+        circle = [CircleObject createInRealm:source withValue:@[@"a", @[@"b", NSNull.null]]];
+        circle.next.next = circle;
+    }];
+
+    [realm beginWriteTransaction];
+    [PrimaryEmployeeObject createInRealm:realm withValue:@[@"Bob", @50, @YES]];
+    NSArray *copies = [realm copyObjects:@[company, circle] fromRealm:source options:RLMCopyOptionsNone];
+    XCTAssertEqual(2U, copies.count);
+
+    PrimaryCompanyObject *companyCopy = copies[0];
+    XCTAssertEqualObjects(realm, companyCopy.realm);
+    XCTAssertEqualObjects(@"Realm", companyCopy.name);
+    XCTAssertEqualObjects((@[@"Alice", @"Bob", @"Alice"]), [companyCopy.employees valueForKey:@"name"]);
+    // Linked objects are copied once, and existing objects are left unchanged
+    XCTAssertEqual(2U, [PrimaryEmployeeObject allObjectsInRealm:realm].count);
+    XCTAssertEqual(50, companyCopy.intern.age);
+    XCTAssertTrue([companyCopy.intern isEqualToObject:companyCopy.wrappedIntern.wrapped]);
+    XCTAssertTrue([companyCopy.intern isEqualToObject:companyCopy.employees[1]]);
+
+    CircleObject *circleCopy = copies[1];
+    XCTAssertEqualObjects(@"b", circleCopy.next.data);
+    XCTAssertTrue([circleCopy isEqualToObject:circleCopy.next.next]);
+    XCTAssertEqual(2U, [CircleObject allObjectsInRealm:realm].count);
+
+    [realm copyObjects:@[company] fromRealm:source options:RLMCopyOptionsUpdateExisting];
+    XCTAssertEqual(1U, [PrimaryCompanyObject allObjectsInRealm:realm].count);
+    XCTAssertEqual(40, companyCopy.intern.age);
+    XCTAssertFalse(companyCopy.intern.hired);
+
+    RLMAssertThrowsWithReasonMatching([realm copyObjects:@[companyCopy] fromRealm:source options:RLMCopyOptionsNone],
+                                      @"must be managed by the source Realm");
+    RLMAssertThrowsWithReasonMatching([realm copyObjects:@[companyCopy] fromRealm:realm options:RLMCopyOptionsNone],
+                                      @"Realm file they are stored in");
+    [realm cancelWriteTransaction];
+
+    RLMAssertThrowsWithReasonMatching([realm copyObjects:@[company] fromRealm:source options:RLMCopyOptionsNone],
+                                      @"write transaction");
+}
+
+- (void)testAppendColumns
+{
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    int64_t ints[] = {10, 20, 30};
+    int32_t offsets[] = {0, 1, 3, 6};
+    uint8_t validity[] = {0b101};
+    int64_t dates[] = {1500, -1500, 0};
+    uint8_t bools[] = {0b110};
+    NSData *(^data)(const void *, size_t) = ^(const void *bytes, size_t length) {
+        return [NSData dataWithBytes:bytes length:length];
+    };
+    RLMColumnBuffer *strings = [RLMColumnBuffer bufferWithValues:[@"abbccc" dataUsingEncoding:NSUTF8StringEncoding]
+                                                         offsets:data(offsets, sizeof(offsets)) validity:nil];
+    RLMColumnBuffer *intBuffer = [RLMColumnBuffer bufferWithValues:data(ints, sizeof(ints)) offsets:nil validity:nil];
+
+    [realm beginWriteTransaction];
+    XCTAssertTrue([realm appendColumns:@{@"stringCol": strings, @"intCol": intBuffer}
+                               toClass:@"PrimaryStringObject" rowCount:3 error:nil]);
+    XCTAssertEqualObjects((@[@"a", @"bb", @"ccc"]), [[PrimaryStringObject allObjects] valueForKey:@"stringCol"]);
+    XCTAssertEqualObjects((@[@10, @20, @30]), [[PrimaryStringObject allObjects] valueForKey:@"intCol"]);
+    XCTAssertEqual(20, [PrimaryStringObject objectForPrimaryKey:@"bb"].intCol);
+
+    XCTAssertTrue([realm appendColumns:@{@"string": [RLMColumnBuffer bufferWithValues:strings.values
+                                                                              offsets:strings.offsets
+                                                                             validity:data(validity, 1)],
+                                         @"date": [RLMColumnBuffer bufferWithValues:data(dates, sizeof(dates))
+                                                                            offsets:nil validity:data(validity, 1)],
+                                         @"boolObj": [RLMColumnBuffer bufferWithValues:data(bools, 1)
+                                                                               offsets:nil validity:nil]}
+                               toClass:@"AllOptionalTypes" rowCount:3 error:nil]);
+    RLMResults *optionals = [AllOptionalTypes allObjects];
+    XCTAssertEqualObjects((@[@"a", NSNull.null, @"ccc"]), [optionals valueForKey:@"string"]);
+    XCTAssertEqualObjects((@[@NO, @YES, @YES]), [optionals valueForKey:@"boolObj"]);
+    XCTAssertEqualObjects([NSDate dateWithTimeIntervalSince1970:1.5], [optionals[0] date]);
+    XCTAssertNil([optionals[1] date]);
+    XCTAssertNil([optionals[0] intObj]);
+
+    // A nil primary key is appended as a null key
+    XCTAssertTrue([realm appendColumns:@{@"stringCol": [RLMColumnBuffer bufferWithValues:strings.values
+                                                                                 offsets:strings.offsets
+                                                                                validity:data(validity, 1)],
+                                         @"intCol": intBuffer}
+                               toClass:@"PrimaryNullableStringObject" rowCount:3 error:nil]);
+    XCTAssertEqualObjects((@[@"a", NSNull.null, @"ccc"]), [[PrimaryNullableStringObject allObjects] valueForKey:@"stringCol"]);
+    XCTAssertEqual(20, [PrimaryNullableStringObject objectForPrimaryKey:nil].intCol);
+
+    // Invalid buffers are reported without appending anything
+    NSError *error;
+    XCTAssertFalse([realm appendColumns:@{@"intObj": intBuffer}
+                                toClass:@"AllOptionalTypes" rowCount:4 error:&error]);
+    XCTAssertEqualObjects(@"The values for property 'intObj' are too short for 4 objects.", error.localizedDescription);
+    XCTAssertFalse([realm appendColumns:@{@"stringCol": [RLMColumnBuffer bufferWithValues:strings.values
+                                                                                  offsets:strings.offsets
+                                                                                 validity:data(validity, 1)]}
+                                toClass:@"PrimaryStringObject" rowCount:3 error:&error]);
+    XCTAssertEqualObjects(@"Property 'stringCol' cannot be nil, but the value for object 1 is nil.",
+                          error.localizedDescription);
+    const char invalidUTF8[] = {'a', '\xC0', '\xAF', 'b'};
+    int32_t invalidOffsets[] = {0, 1, 3, 4};
+    XCTAssertFalse([realm appendColumns:@{@"string": [RLMColumnBuffer bufferWithValues:data(invalidUTF8, sizeof(invalidUTF8))
+                                                                               offsets:data(invalidOffsets, sizeof(invalidOffsets))
+                                                                              validity:nil]}
+                                toClass:@"AllOptionalTypes" rowCount:3 error:&error]);
+    XCTAssertEqualObjects(@"The value for object 1 of property 'string' is not valid UTF-8.", error.localizedDescription);
+    float vectors[] = {1, 2, 3, 4, 5, 6, 7, 8};
+    int32_t vectorOffsets[] = {0, 12, 12, 32};
+    uint8_t vectorValidity[] = {0b111};
+    XCTAssertFalse([realm appendColumns:@{@"embedding": [RLMColumnBuffer bufferWithValues:data(vectors, sizeof(vectors))
+                                                                                  offsets:data(vectorOffsets, sizeof(vectorOffsets))
+                                                                                 validity:data(vectorValidity, 1)]}
+                                toClass:@"VectorObject" rowCount:3 error:&error]);
+    XCTAssertEqualObjects(@"The value for object 1 of vector property 'embedding' must be 3 floats (12 bytes), but is 0 bytes.",
+                          error.localizedDescription);
+    XCTAssertEqual(0U, [realm allObjects:@"VectorObject"].count);
+    XCTAssertEqual(3U, optionals.count);
+    XCTAssertEqual(3U, [PrimaryStringObject allObjects].count);
+
+    RLMAssertThrowsWithReason([realm appendColumns:@{@"stringCol": strings, @"intCol": intBuffer}
+                                           toClass:@"PrimaryStringObject" rowCount:3 error:nil],
+                              @"Can't create object with existing primary key value 'a'.");
+    RLMAssertThrowsWithReason([realm appendColumns:@{@"intCol": strings} toClass:@"PrimaryStringObject"
+                                          rowCount:3 error:nil],
+                              @"Primary key property 'stringCol' must be given a column.");
+    RLMAssertThrowsWithReason([realm appendColumns:@{@"employees": strings} toClass:@"CompanyObject"
+                                          rowCount:3 error:nil],
+                              @"Cannot append array property 'employees'.");
+    [realm cancelWriteTransaction];
+
+    RLMAssertThrowsWithReasonMatching([realm appendColumns:@{} toClass:@"IntObject" rowCount:0 error:nil],
+                                      @"write transaction");
+}
+
+- (void)testAppendColumnsResolvesDefaultValuesForEachRow
+{
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    int64_t ints[] = {1, 2, 3};
+    RLMColumnBuffer *intBuffer = [RLMColumnBuffer bufferWithValues:[NSData dataWithBytes:ints length:sizeof(ints)]
+                                                           offsets:nil validity:nil];
+
+    [realm beginWriteTransaction];
+    XCTAssertTrue([realm appendColumns:@{@"intCol": intBuffer} toClass:@"GeneratedDefaultsObject"
+                              rowCount:3 error:nil]);
+    RLMResults *objects = [GeneratedDefaultsObject allObjectsInRealm:realm];
+    XCTAssertEqual(3U, [[NSSet setWithArray:[objects valueForKey:@"uuid"]] count]);
+    XCTAssertEqual(3U, [IntObject objectsInRealm:realm where:@"intCol == 7"].count);
+
+    // A failure while populating the rows removes the ones already appended,
+    // along with the objects created for their defaults
+    NSError *error;
+    XCTAssertFalse([realm appendColumns:@{@"intCol": intBuffer} toClass:@"InvalidLinkDefaultObject"
+                               rowCount:3 error:&error]);
+    XCTAssertNotNil(error);
+    XCTAssertEqual(0U, [InvalidLinkDefaultObject allObjectsInRealm:realm].count);
+    XCTAssertEqual(3U, [IntObject allObjectsInRealm:realm].count);
+    [realm cancelWriteTransaction];
+}
+
 - (void)testCannotOverwriteWithWriteCopy
 {
     RLMRealm *realm = [self realmWithTestPath];
@@ -1685,6 +2561,232 @@
     }];
 }
 
+- (void)testStatistics
+{
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm transactionWithBlock:^{
+        [IntObject createInRealm:realm withValue:@[@0]];
+        [IntObject createInRealm:realm withValue:@[@1]];
+    }];
+
+    NSDictionary *statistics = [realm statistics];
+    XCTAssertGreaterThan([statistics[@"fileSize"] unsignedLongLongValue], 0U);
+    XCTAssertEqualObjects(statistics[@"objectCounts"][@"IntObject"], @2);
+    XCTAssertEqualObjects(statistics[@"objectCounts"][@"StringObject"], @0);
+    XCTAssertEqualObjects(statistics[@"notificationBlocks"], @0);
+    XCTAssertEqualObjects(statistics[@"observedObjects"], @0);
+    uint64_t activeVersions = [statistics[@"activeVersions"] unsignedLongLongValue];
+
+    // An unresolved thread-safe reference keeps the version it was made at alive
+    RLMThreadSafeReference *reference = [RLMThreadSafeReference referenceWithThreadConfined:[IntObject allObjectsInRealm:realm]];
+    [realm transactionWithBlock:^{
+        [IntObject createInRealm:realm withValue:@[@2]];
+    }];
+    statistics = [realm statistics];
+    XCTAssertGreaterThan([statistics[@"activeVersions"] unsignedLongLongValue], activeVersions);
+    XCTAssertEqualObjects(statistics[@"objectCounts"][@"IntObject"], @3);
+    (void)reference;
+}
+
+- (void)testChangesSinceVersion
+{
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm transactionWithBlock:^{
+        [PrimaryStringObject createInRealm:realm withValue:@[@"a", @1]];
+        [PrimaryStringObject createInRealm:realm withValue:@[@"b", @2]];
+        [PrimaryStringObject createInRealm:realm withValue:@[@"c", @3]];
+        [IntObject createInRealm:realm withValue:@[@0]];
+    }];
+
+    RLMRealmVersion *version = [realm currentVersion];
+    XCTAssertEqual([realm changesSinceVersion:version].count, 0U);
+
+    [self dispatchAsyncAndWait:^{
+        RLMRealm *realm = [RLMRealm defaultRealm];
+        [realm transactionWithBlock:^{
+            // deleting "a" moves "c" into its row, which isn't a change to "c"
+            [realm deleteObject:[PrimaryStringObject objectInRealm:realm forPrimaryKey:@"a"]];
+            [PrimaryStringObject objectInRealm:realm forPrimaryKey:@"b"].intCol = 5;
+            [PrimaryStringObject createInRealm:realm withValue:@[@"d", @4]];
+            [IntObject createInRealm:realm withValue:@[@1]];
+        }];
+    }];
+    [realm refresh];
+
+    NSDictionary<NSString *, RLMObjectChanges *> *changes = [realm changesSinceVersion:version];
+    XCTAssertEqualObjects(changes.allKeys, @[@"PrimaryStringObject"]);
+    XCTAssertEqualObjects(changes[@"PrimaryStringObject"].insertedPrimaryKeys, @[@"d"]);
+    XCTAssertEqualObjects(changes[@"PrimaryStringObject"].modifiedPrimaryKeys, @[@"b"]);
+    XCTAssertEqualObjects(changes[@"PrimaryStringObject"].deletedPrimaryKeys, @[@"a"]);
+    XCTAssertGreaterThan([realm currentVersion].version, version.version);
+
+    // the token stays at its version, so the changes can be read again
+    [realm transactionWithBlock:^{
+        [realm deleteObject:[PrimaryStringObject objectInRealm:realm forPrimaryKey:@"d"]];
+    }];
+    changes = [realm changesSinceVersion:version];
+    XCTAssertEqualObjects(changes[@"PrimaryStringObject"].insertedPrimaryKeys, @[]);
+    XCTAssertEqualObjects(changes[@"PrimaryStringObject"].deletedPrimaryKeys, @[@"a"]);
+
+    RLMRealm *otherRealm = [self realmWithTestPath];
+    RLMAssertThrowsWithReasonMatching([otherRealm changesSinceVersion:version], @"cannot be used with the Realm at");
+}
+
+- (void)testRealmAtVersion
+{
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm transactionWithBlock:^{
+        [IntObject createInRealm:realm withValue:@[@1]];
+        [IntObject createInRealm:realm withValue:@[@2]];
+    }];
+    RLMRealmVersion *version = [realm currentVersion];
+    XCTAssertNil(realm.pinnedVersion);
+
+    [realm transactionWithBlock:^{
+        [realm deleteObjects:[IntObject objectsInRealm:realm where:@"intCol = 1"]];
+        [IntObject createInRealm:realm withValue:@[@3]];
+    }];
+
+    NSError *error;
+    RLMRealm *past = [realm realmAtVersion:version error:&error];
+    XCTAssertNil(error);
+    XCTAssertNotEqual(past, realm);
+    XCTAssertEqual(past.pinnedVersion, version);
+    XCTAssertEqualObjects([[IntObject allObjectsInRealm:past] valueForKey:@"intCol"], (@[@1, @2]));
+    XCTAssertEqualObjects([[[IntObject allObjectsInRealm:realm] sortedResultsUsingKeyPath:@"intCol" ascending:YES]
+                           valueForKey:@"intCol"], (@[@2, @3]));
+    XCTAssertEqual([IntObject objectsInRealm:past where:@"intCol > 1"].count, 1U);
+
+    // The past Realm stays at its version
+    [self dispatchAsyncAndWait:^{
+        RLMRealm *realm = [RLMRealm defaultRealm];
+        [realm transactionWithBlock:^{
+            [realm deleteAllObjects];
+        }];
+    }];
+    XCTAssertFalse([past refresh]);
+    [past invalidate];
+    XCTAssertEqual([IntObject allObjectsInRealm:past].count, 2U);
+    RLMAssertThrowsWithReasonMatching([past beginWriteTransaction], @"past version");
+    RLMAssertThrowsWithReasonMatching(past.autorefresh = YES, @"past version");
+    RLMAssertThrowsWithReasonMatching([past addNotificationBlock:^(NSString *, RLMRealm *) {}], @"past version");
+    [realm refresh];
+    XCTAssertEqual([IntObject allObjectsInRealm:realm].count, 0U);
+
+    RLMRealm *otherRealm = [self realmWithTestPath];
+    RLMAssertThrowsWithReasonMatching([otherRealm realmAtVersion:version error:nil], @"cannot be used with the Realm at");
+}
+
+- (void)testWriteCopyToStream
+{
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm transactionWithBlock:^{
+        for (int i = 0; i < 1000; ++i) {
+            [IntObject createInRealm:realm withValue:@[@(i)]];
+        }
+    }];
+
+    NSOutputStream *stream = [NSOutputStream outputStreamToFileAtPath:RLMTestRealmURL().path append:NO];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"write copy"];
+    __block NSUInteger bytesReported = 0;
+    [realm writeCopyToStream:stream callbackQueue:dispatch_get_main_queue() progress:^(NSUInteger bytesWritten) {
+        XCTAssertGreaterThan(bytesWritten, bytesReported);
+        bytesReported = bytesWritten;
+    } completion:^(NSError *error) {
+        XCTAssertNil(error);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+
+    XCTAssertEqual(stream.streamStatus, NSStreamStatusClosed);
+    NSDictionary *attributes = [NSFileManager.defaultManager attributesOfItemAtPath:RLMTestRealmURL().path error:nil];
+    XCTAssertEqual(bytesReported, [attributes[NSFileSize] unsignedLongLongValue]);
+    RLMRealm *copy = [self realmWithTestPath];
+    XCTAssertEqual(1000U, [IntObject allObjectsInRealm:copy].count);
+}
+
+#pragma mark - Reading Without Copying
+
+- (void)testReadStringsWithoutCopying {
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    NSString *longString = [@"" stringByPaddingToLength:100 withString:@"abc" startingAtIndex:0];
+    NSString *nonASCII = [@"" stringByPaddingToLength:100 withString:@"é" startingAtIndex:0];
+    [realm beginWriteTransaction];
+    StringObject *obj = [StringObject createInRealm:realm withValue:@[longString]];
+    StringObject *nonASCIIObj = [StringObject createInRealm:realm withValue:@[nonASCII]];
+    StringObject *shortObj = [StringObject createInRealm:realm withValue:@[@"short"]];
+    [realm commitWriteTransaction];
+
+    Class mappedStringClass = NSClassFromString(@"RLMMappedString");
+    XCTAssertFalse([obj.stringCol isKindOfClass:mappedStringClass]);
+
+    realm.readsStringsWithoutCopying = YES;
+    NSString *mapped = obj.stringCol;
+    XCTAssertTrue([mapped isKindOfClass:mappedStringClass]);
+    XCTAssertEqualObjects(mapped, longString);
+    XCTAssertEqualObjects([mapped substringWithRange:NSMakeRange(3, 4)], @"abca");
+    XCTAssertFalse([nonASCIIObj.stringCol isKindOfClass:mappedStringClass]);
+    XCTAssertEqualObjects(nonASCIIObj.stringCol, nonASCII);
+    XCTAssertFalse([shortObj.stringCol isKindOfClass:mappedStringClass]);
+
+    // Copying the string makes an ordinary string which can outlive the
+    // read transaction and be passed to other threads
+    NSString *copy = [mapped copy];
+    XCTAssertFalse([copy isKindOfClass:mappedStringClass]);
+    XCTAssertEqualObjects(copy, longString);
+
+    // Beginning a write transaction copies the string before the data it
+    // refers to can be modified
+    [realm beginWriteTransaction];
+    XCTAssertFalse([obj.stringCol isKindOfClass:mappedStringClass]);
+    obj.stringCol = longString.uppercaseString;
+    [realm commitWriteTransaction];
+    XCTAssertEqualObjects(mapped, longString);
+
+    // As does invalidating the Realm
+    mapped = obj.stringCol;
+    XCTAssertTrue([mapped isKindOfClass:mappedStringClass]);
+    [realm invalidate];
+    XCTAssertEqualObjects(mapped, longString.uppercaseString);
+}
+
+- (void)testReusesObjectAccessors {
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm transactionWithBlock:^{
+        [IntObject createInRealm:realm withValue:@[@1]];
+        [IntObject createInRealm:realm withValue:@[@2]];
+        [IntObject createInRealm:realm withValue:@[@3]];
+    }];
+    RLMResults *objects = [IntObject allObjectsInRealm:realm];
+    IntObject *first = objects[0];
+    XCTAssertNotEqual(objects[0], first);
+
+    realm.reusesObjectAccessors = YES;
+    first = objects[0];
+    XCTAssertEqual(objects[0], first);
+    XCTAssertEqual(objects.firstObject, first);
+    NSUInteger index = 0;
+    for (IntObject *obj in objects) {
+        XCTAssertEqual(obj, objects[index++]);
+    }
+
+    // Deleting the first object moves the last one into its row
+    [realm beginWriteTransaction];
+    IntObject *last = objects[2];
+    [realm deleteObject:first];
+    XCTAssertTrue(first.invalidated);
+    XCTAssertEqual(objects.count, 2U);
+    XCTAssertEqual([objects[0] intCol], 3);
+    [realm commitWriteTransaction];
+
+    IntObject *reused = objects[0];
+    XCTAssertEqual(objects[0], reused);
+    XCTAssertEqual(reused.intCol, 3);
+    XCTAssertFalse(last.invalidated);
+    [realm refresh];
+    XCTAssertEqual([objects[0] intCol], 3);
+}
+
 #pragma mark - Assorted tests
 
 - (void)testCoreDebug {
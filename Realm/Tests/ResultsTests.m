@@ -18,9 +18,20 @@
 
 #import "RLMTestCase.h"
 
+#import "RLMObject_Private.h"
+
 #import <mach/mach.h>
 #import <objc/runtime.h>
 
+@interface GroupedAmountObject : RLMObject
+@property NSString *category;
+@property PrimaryStringObject *account;
+@property NSNumber<RLMDouble> *amount;
+@end
+
+@implementation GroupedAmountObject
+@end
+
 @interface ResultsTests : RLMTestCase
 @end
 
@@ -72,6 +83,120 @@
     XCTAssertNil(objects[0], @"Object should have been released");
 }
 
+- (void)testEnumerateObjectsReusingAccessor {
+    RLMRealm *realm = self.realmWithTestPath;
+
+    [[IntObject allObjectsInRealm:realm] enumerateObjectsReusingAccessor:^(__unused id obj, __unused NSUInteger idx, __unused BOOL *stop) {
+        XCTFail(@"Should be empty");
+    }];
+
+    [realm beginWriteTransaction];
+    for (int i = 0; i < 40; ++i) {
+        [IntObject createInRealm:realm withValue:@[@(i)]];
+    }
+    [realm commitWriteTransaction];
+
+    RLMResults *results = [IntObject objectsInRealm:realm where:@"intCol >= 10"];
+    __block IntObject *first;
+    __block NSUInteger count = 0;
+    [results enumerateObjectsReusingAccessor:^(IntObject *obj, NSUInteger idx, __unused BOOL *stop) {
+        if (!first) {
+            first = obj;
+        }
+        XCTAssertEqual(obj, first);
+        XCTAssertEqual(idx, count);
+        XCTAssertEqual(obj.intCol, (int)idx + 10);
+        ++count;
+    }];
+    XCTAssertEqual(count, 30U);
+
+    count = 0;
+    [results enumerateObjectsReusingAccessor:^(__unused IntObject *obj, NSUInteger idx, BOOL *stop) {
+        ++count;
+        *stop = idx == 4;
+    }];
+    XCTAssertEqual(count, 5U);
+
+    // Deleting the enumerated objects in a write transaction works as with
+    // normal enumeration
+    [realm beginWriteTransaction];
+    count = 0;
+    [results enumerateObjectsReusingAccessor:^(IntObject *obj, __unused NSUInteger idx, __unused BOOL *stop) {
+        [realm deleteObject:obj];
+        ++count;
+    }];
+    XCTAssertEqual(count, 30U);
+    XCTAssertEqual(results.count, 0U);
+    [realm commitWriteTransaction];
+}
+
+#if DEBUG
+- (void)testManagedAccessorCount {
+    RLMRealm *realm = self.realmWithTestPath;
+    [realm beginWriteTransaction];
+    for (int i = 0; i < 20; ++i) {
+        [IntObject createInRealm:realm withValue:@[@(i)]];
+    }
+    [realm commitWriteTransaction];
+
+    RLMResults *results = [IntObject allObjectsInRealm:realm];
+    uint64_t start = RLMDebugManagedAccessorCount();
+    for (NSUInteger i = 0; i < results.count; ++i) {
+        (void)[results[i] intCol];
+    }
+    XCTAssertEqual(RLMDebugManagedAccessorCount() - start, 20U);
+
+    start = RLMDebugManagedAccessorCount();
+    [results enumerateObjectsReusingAccessor:^(IntObject *obj, __unused NSUInteger idx, __unused BOOL *stop) {
+        (void)obj.intCol;
+    }];
+    XCTAssertEqual(RLMDebugManagedAccessorCount() - start, 1U);
+}
+#endif
+
+- (void)testObjectsIncludingKeyPaths {
+    RLMRealm *realm = self.realmWithTestPath;
+    [realm beginWriteTransaction];
+    DogObject *fido = [DogObject createInRealm:realm withValue:@[@"Fido", @3]];
+    DogObject *rex = [DogObject createInRealm:realm withValue:@[@"Rex", @5]];
+    for (int i = 0; i < 20; ++i) {
+        [OwnerObject createInRealm:realm withValue:@[[NSString stringWithFormat:@"%d", i], i % 2 ? fido : rex]];
+    }
+    [OwnerObject createInRealm:realm withValue:@[@"nobody"]];
+    [realm commitWriteTransaction];
+
+    RLMResults *results = [OwnerObject allObjectsInRealm:realm];
+#if DEBUG
+    uint64_t start = RLMDebugManagedAccessorCount();
+#endif
+    NSUInteger count = 0, withDogs = 0;
+    for (OwnerObject *owner in [results objectsIncludingKeyPaths:@[@"dog"]]) {
+        if (owner.dog) {
+            XCTAssertEqualObjects(owner.dog.dogName, owner.name.intValue % 2 ? @"Fido" : @"Rex");
+            XCTAssertEqual(owner.dog, owner.dog);
+            ++withDogs;
+        }
+        ++count;
+    }
+    XCTAssertEqual(count, 21U);
+    XCTAssertEqual(withDogs, 20U);
+#if DEBUG
+    // One accessor for each owner, and one for each dog in each batch
+    XCTAssertLessThanOrEqual(RLMDebugManagedAccessorCount() - start, 21U + 4U);
+#endif
+
+    // Links changed in a write transaction are read through the new link
+    [realm beginWriteTransaction];
+    for (OwnerObject *owner in [results objectsIncludingKeyPaths:@[@"dog"]]) {
+        owner.dog = fido;
+        XCTAssertEqualObjects(owner.dog.dogName, @"Fido");
+    }
+    [realm commitWriteTransaction];
+
+    RLMAssertThrowsWithReasonMatching([results objectsIncludingKeyPaths:@[@"name"]], @"not a to-one relationship");
+    RLMAssertThrowsWithReasonMatching([results objectsIncludingKeyPaths:@[@"dog.dogName"]], @"not a to-one relationship");
+}
+
 - (void)testFirst {
     XCTAssertNil(IntObject.allObjects.firstObject);
     XCTAssertNil([IntObject objectsWhere:@"intCol > 5"].firstObject);
@@ -102,6 +227,223 @@
     XCTAssertEqual(20, [[IntObject objectsWhere:@"intCol > 10"].lastObject intCol]);
 }
 
+- (void)testExists {
+    XCTAssertFalse(IntObject.allObjects.exists);
+    XCTAssertFalse([IntObject objectsWhere:@"intCol > 5"].exists);
+
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm beginWriteTransaction];
+    [IntObject createInDefaultRealmWithValue:@[@20]];
+    [IntObject createInDefaultRealmWithValue:@[@10]];
+    [IntObject createInDefaultRealmWithValue:@[@10]];
+    [realm commitWriteTransaction];
+
+    XCTAssertTrue(IntObject.allObjects.exists);
+    RLMResults *results = [IntObject objectsWhere:@"intCol > 5"];
+    XCTAssertTrue(results.exists);
+    XCTAssertEqual(3U, results.count);
+    XCTAssertFalse([IntObject objectsWhere:@"intCol > 20"].exists);
+    XCTAssertTrue([[IntObject objectsWhere:@"intCol < 20"] sortedResultsUsingKeyPath:@"intCol" ascending:NO].exists);
+    XCTAssertEqual(2U, [[IntObject objectsWhere:@"intCol < 20"] sortedResultsUsingKeyPath:@"intCol" ascending:NO].count);
+    XCTAssertEqual(2U, [results distinctResultsUsingKeyPaths:@[@"intCol"]].count);
+
+    [realm beginWriteTransaction];
+    [IntObject createInDefaultRealmWithValue:@[@30]];
+    XCTAssertEqual(4U, results.count);
+    [IntObject createInDefaultRealmWithValue:@[@40]];
+    XCTAssertEqual(5U, results.count);
+    [realm commitWriteTransaction];
+    XCTAssertEqual(5U, results.count);
+    XCTAssertTrue([IntObject objectsWhere:@"intCol > 20"].exists);
+
+    // Changes made by other threads are counted once the Realm advances
+    [self dispatchAsyncAndWait:^{
+        RLMRealm *realm = [RLMRealm defaultRealm];
+        [realm transactionWithBlock:^{
+            [IntObject createInRealm:realm withValue:@[@50]];
+        }];
+    }];
+    XCTAssertEqual(5U, results.count);
+    [realm refresh];
+    XCTAssertEqual(6U, results.count);
+}
+
+- (void)testMaterializedResults {
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm beginWriteTransaction];
+    for (int i = 0; i < 10; ++i) {
+        [IntObject createInDefaultRealmWithValue:@[@(i)]];
+    }
+    [realm commitWriteTransaction];
+
+    RLMResults *source = [[IntObject objectsWhere:@"intCol > 5"] sortedResultsUsingKeyPath:@"intCol" ascending:NO];
+    // Nothing is stored until the results are explicitly materialized
+    XCTAssertEqual(source, [source materializedResultsNamed:@"large"]);
+    NSError *error;
+    XCTAssertTrue([source materializeWithName:@"large" error:&error]);
+    XCTAssertNil(error);
+    RLMResults *results = [source materializedResultsNamed:@"large"];
+    XCTAssertNotEqual(source, results);
+    XCTAssertEqual(4U, results.count);
+    XCTAssertEqualObjects((@[@9, @8, @7, @6]), [results valueForKey:@"intCol"]);
+
+    // The stored objects are used by later calls for the same query
+    RLMResults *stored = [[IntObject objectsWhere:@"intCol > 5"] materializedResultsNamed:@"large"];
+    XCTAssertEqual(4U, stored.count);
+    XCTAssertEqual(1U, [stored objectsWhere:@"intCol < 7"].count);
+
+    // and the results update once the data changes
+    [realm beginWriteTransaction];
+    [IntObject createInDefaultRealmWithValue:@[@20]];
+    [realm deleteObjects:[IntObject objectsWhere:@"intCol = 9"]];
+    [realm commitWriteTransaction];
+    XCTAssertEqualObjects((@[@20, @8, @7, @6]), [results valueForKey:@"intCol"]);
+    XCTAssertEqual(4U, stored.count);
+    RLMResults *outdated = [IntObject objectsWhere:@"intCol > 5"];
+    XCTAssertEqual(outdated, [outdated materializedResultsNamed:@"large"]);
+    XCTAssertTrue([outdated materializeWithName:@"large" error:nil]);
+    XCTAssertEqual(4U, [outdated materializedResultsNamed:@"large"].count);
+
+    // Storing a different query replaces the stored objects
+    RLMResults *small = [IntObject objectsWhere:@"intCol < 2"];
+    XCTAssertTrue([small materializeWithName:@"large" error:nil]);
+    XCTAssertNotEqual(small, [small materializedResultsNamed:@"large"]);
+    XCTAssertEqual(2U, [small materializedResultsNamed:@"large"].count);
+    XCTAssertEqual(outdated, [outdated materializedResultsNamed:@"large"]);
+    XCTAssertTrue([IntObject.allObjects materializeWithName:@"all" error:nil]);
+    XCTAssertEqual(10U, [IntObject.allObjects materializedResultsNamed:@"all"].count);
+    // Materializing other results doesn't invalidate the stored objects
+    XCTAssertNotEqual(small, [small materializedResultsNamed:@"large"]);
+
+    // Results handed over to another thread update there once the data changes
+    RLMResults *all = [IntObject.allObjects materializedResultsNamed:@"all"];
+    RLMThreadSafeReference *reference = [RLMThreadSafeReference referenceWithThreadConfined:all];
+    [self dispatchAsyncAndWait:^{
+        RLMRealm *realm = [RLMRealm defaultRealm];
+        RLMResults *all = [realm resolveThreadSafeReference:reference];
+        XCTAssertEqual(10U, all.count);
+        [realm transactionWithBlock:^{
+            [IntObject createInRealm:realm withValue:@[@30]];
+        }];
+        XCTAssertEqual(11U, all.count);
+    }];
+    [realm refresh];
+    XCTAssertEqual(11U, all.count);
+    XCTAssertEqual(small, [small materializedResultsNamed:@"large"]);
+
+    [realm beginWriteTransaction];
+    ArrayPropertyObject *array = [ArrayPropertyObject createInDefaultRealmWithValue:@[@"name", @[], @[]]];
+    RLMAssertThrowsWithReasonMatching([source materializeWithName:@"large" error:nil], @"write transaction");
+    XCTAssertEqual(small, [small materializedResultsNamed:@"large"]);
+    [realm commitWriteTransaction];
+    RLMAssertThrowsWithReasonMatching([[array.intArray objectsWhere:@"intCol > 5"] materializeWithName:@"list" error:nil],
+                                      @"all objects of a class");
+    RLMAssertThrowsWithReasonMatching([[array.intArray objectsWhere:@"intCol > 5"] materializedResultsNamed:@"list"],
+                                      @"all objects of a class");
+}
+
+- (void)testPageStartingAfter {
+    XCTAssertEqualObjects([IntObject.allObjects pageStartingAfter:nil limit:5], @[]);
+
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm beginWriteTransaction];
+    for (int i = 0; i < 10; ++i) {
+        [IntObject createInDefaultRealmWithValue:@[@(i)]];
+    }
+    [realm commitWriteTransaction];
+
+    for (RLMResults *results in @[IntObject.allObjects,
+                                  [IntObject objectsWhere:@"intCol >= 0"],
+                                  [IntObject.allObjects sortedResultsUsingKeyPath:@"intCol" ascending:YES]]) {
+        NSArray *page = [results pageStartingAfter:nil limit:4];
+        XCTAssertEqualObjects([page valueForKey:@"intCol"], (@[@0, @1, @2, @3]));
+        page = [results pageStartingAfter:page.lastObject limit:4];
+        XCTAssertEqualObjects([page valueForKey:@"intCol"], (@[@4, @5, @6, @7]));
+        page = [results pageStartingAfter:page.lastObject limit:4];
+        XCTAssertEqualObjects([page valueForKey:@"intCol"], (@[@8, @9]));
+        XCTAssertEqualObjects([results pageStartingAfter:page.lastObject limit:4], @[]);
+        XCTAssertEqualObjects([results pageStartingAfter:page.lastObject limit:0], @[]);
+    }
+
+    // Adding objects after reading a page continues from the same object
+    RLMResults *sorted = [IntObject.allObjects sortedResultsUsingKeyPath:@"intCol" ascending:NO];
+    NSArray *page = [sorted pageStartingAfter:nil limit:2];
+    [realm beginWriteTransaction];
+    [IntObject createInDefaultRealmWithValue:@[@20]];
+    [realm commitWriteTransaction];
+    page = [sorted pageStartingAfter:page.lastObject limit:2];
+    XCTAssertEqualObjects([page valueForKey:@"intCol"], (@[@7, @6]));
+
+    RLMAssertThrowsWithReason([[IntObject objectsWhere:@"intCol > 5"] pageStartingAfter:sorted.lastObject limit:2],
+                              @"Object is not in the RLMResults.");
+    RLMAssertThrowsWithReason([IntObject.allObjects pageStartingAfter:[[IntObject alloc] init] limit:2],
+                              @"Cannot start a page after an unmanaged object.");
+    [realm beginWriteTransaction];
+    StringObject *stringObject = [StringObject createInDefaultRealmWithValue:@[@"a"]];
+    [realm commitWriteTransaction];
+    RLMAssertThrowsWithReason([IntObject.allObjects pageStartingAfter:(id)stringObject limit:2],
+                              @"Object type 'StringObject' does not match RLMResults type 'IntObject'.");
+}
+
+- (void)testConcurrentEnumerate {
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm beginWriteTransaction];
+    for (int i = 0; i < 100; ++i) {
+        [IntObject createInDefaultRealmWithValue:@[@(i)]];
+    }
+    RLMAssertThrowsWithReason([IntObject.allObjects concurrentEnumerateWithOptions:NSEnumerationConcurrent
+                                                                         usingBlock:^(__unused id obj, __unused NSUInteger idx, __unused BOOL *stop) {}],
+                              @"Cannot enumerate results concurrently during a write transaction.");
+    [realm commitWriteTransaction];
+
+    RLMResults *results = [IntObject.allObjects sortedResultsUsingKeyPath:@"intCol" ascending:NO];
+    for (NSNumber *options in @[@(NSEnumerationConcurrent), @(NSEnumerationConcurrent | NSEnumerationReverse), @0]) {
+        NSMutableIndexSet *seen = [NSMutableIndexSet indexSet];
+        [results concurrentEnumerateWithOptions:options.unsignedIntegerValue
+                                     usingBlock:^(IntObject *obj, NSUInteger idx, __unused BOOL *stop) {
+            XCTAssertEqual(obj.intCol, 99 - (int)idx);
+            @synchronized (seen) {
+                XCTAssertFalse([seen containsIndex:idx]);
+                [seen addIndex:idx];
+            }
+        }];
+        XCTAssertEqual(seen.count, 100U);
+    }
+
+    // Every thread reads the version the enumeration started at, even if
+    // objects are added while it runs
+    NSMutableIndexSet *seen = [NSMutableIndexSet indexSet];
+    [results concurrentEnumerateWithOptions:NSEnumerationConcurrent
+                                 usingBlock:^(IntObject *obj, NSUInteger idx, __unused BOOL *stop) {
+        XCTAssertEqual(obj.intCol, 99 - (int)idx);
+        if (idx == 50) {
+            [RLMRealm.defaultRealm transactionWithBlock:^{
+                [IntObject createInDefaultRealmWithValue:@[@1000]];
+            }];
+        }
+        @synchronized (seen) {
+            XCTAssertFalse([seen containsIndex:idx]);
+            [seen addIndex:idx];
+        }
+    }];
+    XCTAssertEqual(seen.count, 100U);
+    [realm refresh];
+    XCTAssertEqual(results.count, 101U);
+
+    // Stopping with the serial version stops immediately
+    __block NSUInteger calls = 0;
+    [results concurrentEnumerateWithOptions:0 usingBlock:^(__unused id obj, __unused NSUInteger idx, BOOL *stop) {
+        ++calls;
+        *stop = YES;
+    }];
+    XCTAssertEqual(calls, 1U);
+
+    XCTAssertThrows([results concurrentEnumerateWithOptions:NSEnumerationConcurrent
+                                                 usingBlock:^(__unused id obj, __unused NSUInteger idx, __unused BOOL *stop) {
+        @throw [NSException exceptionWithName:@"test" reason:@"test" userInfo:nil];
+    }]);
+}
+
 - (void)testSubscript {
     RLMAssertThrowsWithReasonMatching([IntObject allObjects][0], @"0.*less than 0");
     RLMAssertThrowsWithReasonMatching([IntObject objectsWhere:@"intCol > 5"][0], @"0.*less than 0");
@@ -206,6 +548,27 @@
                                       @"write transaction");
 }
 
+- (void)testIncrementProperty
+{
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm beginWriteTransaction];
+    for (int i = 0; i < 4; ++i) {
+        [AllOptionalTypes createInRealm:realm withValue:@{@"intObj": i == 3 ? NSNull.null : @(i)}];
+    }
+    [[AllOptionalTypes objectsInRealm:realm where:@"intObj >= 1"] incrementProperty:@"intObj" by:10];
+    XCTAssertEqualObjects([[AllOptionalTypes allObjectsInRealm:realm] valueForKey:@"intObj"],
+                          (@[@0, @11, @12, NSNull.null]));
+    [[AllOptionalTypes allObjectsInRealm:realm] incrementProperty:@"intObj" by:-1];
+    XCTAssertEqualObjects([[AllOptionalTypes allObjectsInRealm:realm] valueForKey:@"intObj"],
+                          (@[@-1, @10, @11, NSNull.null]));
+    RLMAssertThrowsWithReasonMatching([[AllOptionalTypes allObjectsInRealm:realm] incrementProperty:@"doubleObj" by:1],
+                                      @"can't be incremented");
+    [realm commitWriteTransaction];
+
+    RLMAssertThrowsWithReasonMatching([[AllOptionalTypes allObjectsInRealm:realm] incrementProperty:@"intObj" by:1],
+                                      @"write transaction");
+}
+
 - (void)testObjectAggregate
 {
     RLMRealm *realm = [RLMRealm defaultRealm];
@@ -350,6 +713,246 @@
     RLMAssertThrowsWithReasonMatching([allArray maxOfProperty:@"boolCol"], @"max.*bool");
 }
 
+- (void)testGroupedAggregates
+{
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm beginWriteTransaction];
+    PrimaryStringObject *a = [PrimaryStringObject createInRealm:realm withValue:@[@"a", @0]];
+    PrimaryStringObject *b = [PrimaryStringObject createInRealm:realm withValue:@[@"b", @0]];
+    [GroupedAmountObject createInRealm:realm withValue:@[@"food", a, @10.0]];
+    [GroupedAmountObject createInRealm:realm withValue:@[@"food", b, @2.5]];
+    [GroupedAmountObject createInRealm:realm withValue:@[@"rent", a, @100.0]];
+    [GroupedAmountObject createInRealm:realm withValue:@[@"rent", NSNull.null, NSNull.null]];
+    [GroupedAmountObject createInRealm:realm withValue:@[NSNull.null, b, @1.0]];
+    [AggregateObject createInRealm:realm withValue:@[@1, @1.0f, @1.0, @YES, NSDate.date]];
+    [AggregateObject createInRealm:realm withValue:@[@2, @1.0f, @1.0, @NO, NSDate.date]];
+    [AggregateObject createInRealm:realm withValue:@[@3, @1.0f, @1.0, @YES, NSDate.date]];
+    [realm commitWriteTransaction];
+
+    RLMResults *all = [GroupedAmountObject allObjects];
+    NSDictionary *expected = @{@"food": @12.5, @"rent": @100.0, NSNull.null: @1.0};
+    XCTAssertEqualObjects(expected, [all groupedBy:@"category" aggregate:RLMAggregateFunctionSum ofProperty:@"amount"]);
+    expected = @{@"food": @2, @"rent": @2, NSNull.null: @1};
+    XCTAssertEqualObjects(expected, [all groupedBy:@"category" aggregate:RLMAggregateFunctionCount ofProperty:nil]);
+    expected = @{@"food": @2, @"rent": @1, NSNull.null: @1};
+    XCTAssertEqualObjects(expected, [all groupedBy:@"category" aggregate:RLMAggregateFunctionCount ofProperty:@"amount"]);
+    expected = @{@"a": @100.0, @"b": @2.5, NSNull.null: NSNull.null};
+    XCTAssertEqualObjects(expected, [all groupedBy:@"account" aggregate:RLMAggregateFunctionMax ofProperty:@"amount"]);
+    expected = @{@"a": @55.0};
+    XCTAssertEqualObjects(expected, [[all objectsWhere:@"account.stringCol = 'a'"] groupedBy:@"account"
+                                                                                 aggregate:RLMAggregateFunctionAverage
+                                                                                ofProperty:@"amount"]);
+
+    RLMResults *aggregates = [AggregateObject allObjects];
+    expected = @{@YES: @1, @NO: @2};
+    XCTAssertEqualObjects(expected, [aggregates groupedBy:@"boolCol" aggregate:RLMAggregateFunctionMin ofProperty:@"intCol"]);
+    expected = @{@1: @1.0, @2: @1.0, @3: @1.0};
+    XCTAssertEqualObjects(expected, [aggregates groupedBy:@"intCol" aggregate:RLMAggregateFunctionSum ofProperty:@"floatCol"]);
+
+    RLMAssertThrowsWithReasonMatching([aggregates groupedBy:@"floatCol" aggregate:RLMAggregateFunctionSum ofProperty:@"intCol"],
+                                      @"not supported for float");
+    RLMAssertThrowsWithReasonMatching([aggregates groupedBy:@"boolCol" aggregate:RLMAggregateFunctionSum ofProperty:@"dateCol"],
+                                      @"not supported for date");
+    RLMAssertThrowsWithReasonMatching([aggregates groupedBy:@"boolCol" aggregate:RLMAggregateFunctionSum ofProperty:nil],
+                                      @"property to aggregate is required");
+    RLMAssertThrowsWithReasonMatching([[OwnerObject allObjects] groupedBy:@"dog" aggregate:RLMAggregateFunctionCount ofProperty:nil],
+                                      @"requires 'DogObject' to have a primary key");
+}
+
+- (void)testStatisticsForProperty
+{
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    RLMResults *noArray = [AggregateObject objectsWhere:@"boolCol == NO"];
+    RLMResults *allArray = [AggregateObject allObjects];
+
+    RLMPropertyStatistics *stats = [allArray statisticsForProperty:@"intCol"];
+    XCTAssertEqual(0U, stats.count);
+    XCTAssertEqualObjects(@0, stats.sum);
+    XCTAssertNil(stats.minimum);
+    XCTAssertNil(stats.maximum);
+    XCTAssertNil(stats.average);
+    XCTAssertNil(stats.variance);
+
+    [realm beginWriteTransaction];
+    [AggregateObject createInRealm:realm withValue:@[@0, @1.2f, @0.0, @YES, NSDate.date]];
+    [AggregateObject createInRealm:realm withValue:@[@1, @0.0f, @2.5, @NO, NSDate.date]];
+    [AggregateObject createInRealm:realm withValue:@[@3, @0.5f, @1.5, @NO, NSDate.date]];
+    [AggregateObject createInRealm:realm withValue:@[@4, @1.2f, @0.0, @YES, NSDate.date]];
+    [realm commitWriteTransaction];
+
+    stats = [allArray statisticsForProperty:@"intCol"];
+    XCTAssertEqual(4U, stats.count);
+    XCTAssertEqualObjects(@0, stats.minimum);
+    XCTAssertEqualObjects(@4, stats.maximum);
+    XCTAssertEqualObjects(@8, stats.sum);
+    XCTAssertEqualObjects([allArray averageOfProperty:@"intCol"], stats.average);
+    XCTAssertEqualWithAccuracy(stats.variance.doubleValue, 2.5, 0.001);
+
+    stats = [noArray statisticsForProperty:@"floatCol"];
+    XCTAssertEqual(2U, stats.count);
+    XCTAssertEqual(0.0f, stats.minimum.floatValue);
+    XCTAssertEqual(0.5f, stats.maximum.floatValue);
+    XCTAssertEqualWithAccuracy(stats.sum.doubleValue, 0.5, 0.001);
+    XCTAssertEqualWithAccuracy(stats.variance.doubleValue, 0.0625, 0.001);
+
+    stats = [noArray statisticsForProperty:@"doubleCol"];
+    XCTAssertEqualObjects(@1.5, stats.minimum);
+    XCTAssertEqualObjects(@4.0, stats.sum);
+    XCTAssertEqualObjects(@2.0, stats.average);
+
+    RLMAssertThrowsWithReasonMatching([allArray statisticsForProperty:@"foo"], @"foo.*AggregateObject");
+    RLMAssertThrowsWithReasonMatching([allArray statisticsForProperty:@"boolCol"], @"statistics.*bool");
+    RLMAssertThrowsWithReasonMatching([allArray statisticsForProperty:@"dateCol"], @"statistics.*date");
+}
+
+- (void)testCopyValuesOfProperty {
+    RLMRealm *realm = [RLMRealm defaultRealm];
+
+    [realm beginWriteTransaction];
+    for (int i = 0; i < 5; ++i) {
+        [AggregateObject createInRealm:realm withValue:@[@(i), @(i * 1.5f), @(i * 2.5), @NO, NSDate.date]];
+    }
+    [AllOptionalTypes createInRealm:realm withValue:@[@1, @1.5f, @2.5]];
+    [AllOptionalTypes createInRealm:realm withValue:@[NSNull.null, NSNull.null, NSNull.null]];
+    [realm commitWriteTransaction];
+
+    RLMResults *results = [[AggregateObject objectsWhere:@"intCol > 0"] sortedResultsUsingKeyPath:@"intCol" ascending:NO];
+    int64_t ints[5] = {0};
+    XCTAssertEqual([results copyValuesOfProperty:@"intCol" intoBuffer:ints count:5], 4U);
+    XCTAssertEqual(ints[0], 4);
+    XCTAssertEqual(ints[3], 1);
+    XCTAssertEqual(ints[4], 0);
+
+    float floats[2];
+    XCTAssertEqual([results copyValuesOfProperty:@"floatCol" intoBuffer:floats count:2], 2U);
+    XCTAssertEqual(floats[0], 6.0f);
+    XCTAssertEqual(floats[1], 4.5f);
+
+    double doubles[4];
+    XCTAssertEqual([results copyValuesOfProperty:@"doubleCol" intoBuffer:doubles count:4], 4U);
+    XCTAssertEqual(doubles[0], 10.0);
+    XCTAssertEqual(doubles[3], 2.5);
+
+    RLMResults *optional = [AllOptionalTypes allObjects];
+    XCTAssertEqual([optional copyValuesOfProperty:@"intObj" intoBuffer:ints count:2], 2U);
+    XCTAssertEqual(ints[0], 1);
+    XCTAssertEqual(ints[1], 0);
+    XCTAssertEqual([optional copyValuesOfProperty:@"doubleObj" intoBuffer:doubles count:2], 2U);
+    XCTAssertEqual(doubles[0], 2.5);
+    XCTAssertTrue(isnan(doubles[1]));
+
+    XCTAssertEqual([[AggregateObject objectsWhere:@"intCol > 10"] copyValuesOfProperty:@"intCol" intoBuffer:ints count:5], 0U);
+
+    RLMAssertThrowsWithReason([results copyValuesOfProperty:@"foo" intoBuffer:ints count:5],
+                              @"Invalid property name 'foo' for class 'AggregateObject'.");
+    RLMAssertThrowsWithReason([results copyValuesOfProperty:@"dateCol" intoBuffer:ints count:5],
+                              @"copyValuesOfProperty: is not supported for date property 'dateCol'.");
+}
+
+- (void)testPrefetch {
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm beginWriteTransaction];
+    for (int i = 0; i < 5; ++i) {
+        [AggregateObject createInRealm:realm withValue:@[@(i), @(i * 1.5f), @(i * 2.5), @NO, NSDate.date]];
+    }
+    [AllOptionalTypes createInRealm:realm withValue:@[NSNull.null, NSNull.null, NSNull.null]];
+    [realm commitWriteTransaction];
+
+    dispatch_queue_t queue = dispatch_queue_create("prefetch", DISPATCH_QUEUE_SERIAL);
+    XCTestExpectation *expectation = [self expectationWithDescription:@"prefetch"];
+    [[AggregateObject objectsWhere:@"intCol > 1"] prefetchOnQueue:queue completion:^{
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+
+    expectation = [self expectationWithDescription:@"prefetch nulls"];
+    [[AllOptionalTypes allObjects] prefetchOnQueue:queue completion:^{
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+
+    [realm beginWriteTransaction];
+    XCTAssertThrows([[AggregateObject allObjects] prefetchOnQueue:queue completion:nil]);
+    [realm cancelWriteTransaction];
+}
+
+- (NSString *)csvForResults:(RLMResults *)results properties:(NSArray *)properties {
+    NSOutputStream *stream = [NSOutputStream outputStreamToMemory];
+    NSError *error;
+    XCTAssertTrue([results writeCSVToStream:stream properties:properties error:&error]);
+    XCTAssertNil(error);
+    return [[NSString alloc] initWithData:[stream propertyForKey:NSStreamDataWrittenToMemoryStreamKey]
+                                 encoding:NSUTF8StringEncoding];
+}
+
+- (void)testWriteCSVToStream {
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm beginWriteTransaction];
+    [EmployeeObject createInRealm:realm withValue:@[@"Joe", @40, @YES]];
+    [EmployeeObject createInRealm:realm withValue:@[@"Smith, \"Jr\"", @30, @NO]];
+    [AllOptionalTypes createInRealm:realm withValue:@[@1, @1.5f, @2.5, @YES, @"a", [@"b" dataUsingEncoding:NSUTF8StringEncoding],
+                                                      [NSDate dateWithTimeIntervalSince1970:1.5]]];
+    [AllOptionalTypes createInRealm:realm withValue:@{}];
+    [realm commitWriteTransaction];
+
+    RLMResults *employees = [[EmployeeObject allObjects] sortedResultsUsingKeyPath:@"age" ascending:YES];
+    XCTAssertEqualObjects([self csvForResults:employees properties:@[@"name", @"age", @"hired"]],
+                          @"name,age,hired\r\n\"Smith, \"\"Jr\"\"\",30,false\r\nJoe,40,true\r\n");
+    XCTAssertEqualObjects([self csvForResults:[EmployeeObject objectsWhere:@"age > 100"] properties:@[@"age"]],
+                          @"age\r\n");
+
+    XCTAssertEqualObjects([self csvForResults:[AllOptionalTypes allObjects] properties:nil],
+                          @"intObj,floatObj,doubleObj,boolObj,string,data,date\r\n"
+                          @"1,1.5,2.5,true,a,Yg==,1970-01-01T00:00:01.500Z\r\n"
+                          @",,,,,,\r\n");
+
+    RLMAssertThrowsWithReason([employees writeCSVToStream:[NSOutputStream outputStreamToMemory] properties:@[@"foo"] error:nil],
+                              @"Invalid property name 'foo' for class 'EmployeeObject'.");
+    RLMAssertThrowsWithReason([[CompanyObject allObjects] writeCSVToStream:[NSOutputStream outputStreamToMemory]
+                                                                properties:@[@"employees"] error:nil],
+                              @"Cannot export array property 'employees'.");
+
+    NSOutputStream *stream = [NSOutputStream outputStreamToMemory];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"export"];
+    [employees writeCSVToStream:stream properties:@[@"name"] queue:dispatch_queue_create("export", DISPATCH_QUEUE_SERIAL)
+                     completion:^(NSError *error) {
+        XCTAssertNil(error);
+        [expectation fulfill];
+    }];
+    // Changes made after starting the export aren't included in it
+    [realm transactionWithBlock:^{
+        [EmployeeObject createInRealm:realm withValue:@[@"Jill", @25, @YES]];
+    }];
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+    NSString *csv = [[NSString alloc] initWithData:[stream propertyForKey:NSStreamDataWrittenToMemoryStreamKey]
+                                          encoding:NSUTF8StringEncoding];
+    XCTAssertEqualObjects(csv, @"name\r\n\"Smith, \"\"Jr\"\"\"\r\nJoe\r\n");
+
+    // The version is pinned when the export is started, so it can still be
+    // read once the Realm has moved on from it before the export runs
+    dispatch_queue_t queue = dispatch_queue_create("export", DISPATCH_QUEUE_SERIAL);
+    dispatch_suspend(queue);
+    RLMResults *hired = [EmployeeObject objectsWhere:@"hired = YES"];
+    stream = [NSOutputStream outputStreamToMemory];
+    expectation = [self expectationWithDescription:@"pinned export"];
+    [hired writeCSVToStream:stream properties:@[@"name"] queue:queue completion:^(NSError *error) {
+        XCTAssertNil(error);
+        [expectation fulfill];
+    }];
+    for (int i = 0; i < 3; ++i) {
+        [realm transactionWithBlock:^{
+            [EmployeeObject createInRealm:realm withValue:@[@"Jack", @30, @YES]];
+        }];
+    }
+    [realm invalidate];
+    dispatch_resume(queue);
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+    csv = [[NSString alloc] initWithData:[stream propertyForKey:NSStreamDataWrittenToMemoryStreamKey]
+                                encoding:NSUTF8StringEncoding];
+    XCTAssertEqual([csv componentsSeparatedByString:@"Jack"].count, 1U);
+    XCTAssertNotEqual([csv rangeOfString:@"Jill"].location, NSNotFound);
+}
+
 - (void)testValueForCollectionOperationKeyPath
 {
     RLMRealm *realm = [RLMRealm defaultRealm];
@@ -392,6 +995,18 @@
     RLMAssertThrowsWithReasonMatching([allCompanies valueForKeyPath:@"@sum"], @"Missing key path for KVC collection operator sum in key path '@sum'");
     RLMAssertThrowsWithReasonMatching([allCompanies valueForKeyPath:@"@sum."], @"Missing key path for KVC collection operator sum in key path '@sum.'");
     RLMAssertThrowsWithReasonMatching([allCompanies valueForKeyPath:@"@sum.employees.@sum.age"], @"Nested key paths.*not supported");
+
+    // array collection operators on the results themselves
+    XCTAssertEqualObjects([[allCompanies valueForKeyPath:@"@unionOfArrays.employees"] valueForKey:@"name"],
+                          (@[@"Joe", @"John", @"Jill", @"A", @"B", @"C", @"A"]));
+    [realm beginWriteTransaction];
+    [CompanyObject createInRealm:realm withValue:@{@"name": @"Repeats", @"employees": @[c1e1, c1e1, c2e1]}];
+    [realm commitWriteTransaction];
+    XCTAssertEqual(10U, [[allCompanies valueForKeyPath:@"@unionOfArrays.employees"] count]);
+    NSArray *distinct = [allCompanies valueForKeyPath:@"@distinctUnionOfArrays.employees"];
+    XCTAssertEqualObjects([distinct valueForKey:@"name"], (@[@"Joe", @"John", @"Jill", @"A", @"B", @"C", @"A"]));
+    XCTAssertTrue([distinct[0] isEqualToObject:c1e1]);
+    RLMAssertThrowsWithReasonMatching([allCompanies valueForKeyPath:@"@distinctUnionOfArrays.self"], @"distinctUnionOfArrays");
 }
 
 - (void)testArrayDescription
@@ -419,6 +1034,32 @@
     XCTAssertTrue([description rangeOfString:@"912 objects skipped"].location != NSNotFound);
 }
 
+- (void)testObjectsAtIndexes
+{
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm beginWriteTransaction];
+    for (int i = 0; i < 10; ++i) {
+        [IntObject createInRealm:realm withValue:@[@(i)]];
+    }
+    [realm commitWriteTransaction];
+
+    NSMutableIndexSet *indexes = [NSMutableIndexSet indexSetWithIndexesInRange:NSMakeRange(1, 3)];
+    [indexes addIndex:8];
+
+    RLMResults *all = [IntObject allObjects];
+    XCTAssertEqualObjects([[all objectsAtIndexes:indexes] valueForKey:@"intCol"], (@[@1, @2, @3, @8]));
+    XCTAssertEqualObjects([all objectsAtIndexes:[NSIndexSet indexSet]], @[]);
+    RLMAssertThrowsWithReasonMatching([all objectsAtIndexes:[NSIndexSet indexSetWithIndex:10]], @"out of bounds");
+
+    RLMResults *sorted = [[IntObject objectsWhere:@"intCol > 0"] sortedResultsUsingKeyPath:@"intCol" ascending:NO];
+    XCTAssertEqualObjects([[sorted objectsAtIndexes:indexes] valueForKey:@"intCol"], (@[@8, @7, @6, @1]));
+    RLMAssertThrowsWithReasonMatching([sorted objectsAtIndexes:[NSIndexSet indexSetWithIndex:9]], @"out of bounds");
+
+    [self dispatchAsyncAndWait:^{
+        XCTAssertThrows([sorted objectsAtIndexes:indexes]);
+    }];
+}
+
 - (void)testIndexOfObject
 {
     RLMRealm *realm = [RLMRealm defaultRealm];
@@ -819,6 +1460,7 @@ static vm_size_t get_resident_size() {
     XCTAssertNoThrow([results isInvalidated]);
     XCTAssertNoThrow([results objectAtIndex:0]);
     XCTAssertNoThrow([results firstObject]);
+    XCTAssertNoThrow([results exists]);
     XCTAssertNoThrow([results lastObject]);
     XCTAssertNoThrow([results indexOfObject:[IntObject allObjects].firstObject]);
     XCTAssertNoThrow([results indexOfObjectWhere:@"intCol = 0"]);
@@ -831,6 +1473,8 @@ static vm_size_t get_resident_size() {
     XCTAssertNoThrow([results maxOfProperty:@"intCol"]);
     XCTAssertNoThrow([results sumOfProperty:@"intCol"]);
     XCTAssertNoThrow([results averageOfProperty:@"intCol"]);
+    int64_t value;
+    XCTAssertNoThrow([results copyValuesOfProperty:@"intCol" intoBuffer:&value count:1]);
     XCTAssertNoThrow(results[0]);
     XCTAssertNoThrow([results valueForKey:@"intCol"]);
 
@@ -838,6 +1482,7 @@ static vm_size_t get_resident_size() {
         XCTAssertThrows([results isInvalidated]);
         XCTAssertThrows([results objectAtIndex:0]);
         XCTAssertThrows([results firstObject]);
+        XCTAssertThrows([results exists]);
         XCTAssertThrows([results lastObject]);
         XCTAssertThrows([results indexOfObject:[IntObject allObjects].firstObject]);
         XCTAssertThrows([results indexOfObjectWhere:@"intCol = 0"]);
@@ -850,6 +1495,8 @@ static vm_size_t get_resident_size() {
         XCTAssertThrows([results maxOfProperty:@"intCol"]);
         XCTAssertThrows([results sumOfProperty:@"intCol"]);
         XCTAssertThrows([results averageOfProperty:@"intCol"]);
+        int64_t threadValue;
+        XCTAssertThrows([results copyValuesOfProperty:@"intCol" intoBuffer:&threadValue count:1]);
         XCTAssertThrows(results[0]);
         XCTAssertThrows([results valueForKey:@"intCol"]);
     }];
@@ -865,6 +1512,7 @@ static vm_size_t get_resident_size() {
     XCTAssertFalse(results.isInvalidated);
     XCTAssertNoThrow([results objectAtIndex:0]);
     XCTAssertNoThrow([results firstObject]);
+    XCTAssertNoThrow([results exists]);
     XCTAssertNoThrow([results lastObject]);
     XCTAssertNoThrow([results indexOfObject:[IntObject allObjects].firstObject]);
     XCTAssertNoThrow([results indexOfObjectWhere:@"intCol = 0"]);
@@ -886,6 +1534,7 @@ static vm_size_t get_resident_size() {
     XCTAssertTrue(results.isInvalidated);
     XCTAssertThrows([results objectAtIndex:0]);
     XCTAssertThrows([results firstObject]);
+    XCTAssertThrows([results exists]);
     XCTAssertThrows([results lastObject]);
     XCTAssertThrows([results indexOfObject:[IntObject allObjects].firstObject]);
     XCTAssertThrows([results indexOfObjectWhere:@"intCol = 0"]);
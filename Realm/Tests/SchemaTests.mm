@@ -282,6 +282,47 @@ RLM_ARRAY_TYPE(NotARealClass)
     XCTAssertNil([RLMSchema.sharedSchema schemaForClassName:@"RLMDynamicObject"]);
 }
 
+- (void)testClassIDsAreSharedBetweenSchemas {
+    RLMObjectSchema *intSchema;
+    @autoreleasepool {
+        RLMRealm *realm = [self realmWithTestPath];
+        intSchema = realm.schema[@"IntObject"];
+        RLMObjectSchema *stringSchema = realm.schema[@"StringObject"];
+        XCTAssertNotEqual(0U, intSchema.classID);
+        XCTAssertNotEqual(intSchema.classID, stringSchema.classID);
+        XCTAssertEqual(stringSchema.classID, realm.schema[@"LinkStringObject"][@"objectCol"].objectClassID);
+    }
+
+    RLMRealm *dynamicRealm = [self realmWithTestPathAndSchema:nil];
+    XCTAssertNotEqual(intSchema, dynamicRealm.schema[@"IntObject"]);
+    XCTAssertEqual(intSchema.classID, dynamicRealm.schema[@"IntObject"].classID);
+    XCTAssertEqual(&dynamicRealm->_info[intSchema], &dynamicRealm->_info[@"IntObject"]);
+}
+
+- (void)testManagedAccessorClassIsCreatedOnFirstUse {
+    RLMRealmConfiguration *config = [RLMRealmConfiguration defaultConfiguration];
+    config.objectClasses = @[IntObject.class, StringObject.class];
+    RLMRealm *realm = [RLMRealm realmWithConfiguration:config error:nil];
+    RLMObjectSchema *objectSchema = realm.schema[@"IntObject"];
+
+    Class classes[8];
+    Class *accessorClasses = classes;
+    dispatch_apply(8, dispatch_get_global_queue(0, 0), ^(size_t i) {
+        accessorClasses[i] = objectSchema.accessorClass;
+    });
+    for (size_t i = 1; i < 8; ++i) {
+        XCTAssertEqual(accessorClasses[0], accessorClasses[i]);
+    }
+    XCTAssertNotEqual(IntObject.class, accessorClasses[0]);
+    XCTAssertTrue([NSStringFromClass(accessorClasses[0]) hasPrefix:@"RLM:Managed "]);
+
+    [realm beginWriteTransaction];
+    IntObject *obj = [IntObject createInRealm:realm withValue:@[@5]];
+    [realm commitWriteTransaction];
+    XCTAssertEqual(accessorClasses[0], obj.class);
+    XCTAssertEqual(5, obj.intCol);
+}
+
 - (void)testInheritanceInitialization
 {
     Class testClasses[] = {
@@ -719,6 +760,25 @@ RLM_ARRAY_TYPE(NotARealClass)
     }
 }
 
+- (void)testRegisteredObjectClassesDefaultSchema {
+    if (self.isParent) {
+        RLMRunChildAndWait();
+        return;
+    }
+
+    XCTAssertThrows([RLMSchema registerObjectClasses:@[NSObject.class]]);
+    [RLMSchema registerObjectClasses:@[IntObject.class, StringObject.class]];
+
+    RLMSchema *schema = [RLMSchema sharedSchema];
+    XCTAssertEqual(2U, schema.objectSchema.count);
+    XCTAssertNoThrow(schema[@"IntObject"]);
+    XCTAssertNoThrow(schema[@"StringObject"]);
+
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    XCTAssertEqual(2U, realm.schema.objectSchema.count);
+    XCTAssertThrows([RLMSchema registerObjectClasses:@[IntObject.class]]);
+}
+
 - (void)testPartialSharedSchemaInitInheritance {
     if (self.isParent) {
         RLMRunChildAndWait();
@@ -143,6 +143,41 @@
     XCTAssertEqual(42, intObject.intCol);
 }
 
+- (void)testPassThreadSafeReferenceToArrayOfObjects {
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    __block NSArray *objects;
+    [realm transactionWithBlock:^{
+        objects = @[[IntObject createInRealm:realm withValue:@[@1]],
+                    [StringObject createInRealm:realm withValue:@[@"a"]],
+                    [IntObject createInRealm:realm withValue:@[@3]]];
+    }];
+
+    RLMThreadSafeReference *ref = [RLMThreadSafeReference referenceWithThreadConfinedObjects:objects];
+    RLMThreadSafeReference *emptyRef = [RLMThreadSafeReference referenceWithThreadConfinedObjects:@[]];
+    [realm transactionWithBlock:^{
+        [realm deleteObject:objects[2]];
+    }];
+    [self dispatchAsyncAndWait:^{
+        RLMRealm *realm = [RLMRealm defaultRealm];
+        NSArray *resolved = [self assertResolve:realm reference:ref];
+        XCTAssertEqual(resolved.count, 3U);
+        XCTAssertEqualObjects(resolved[0][@"intCol"], @1);
+        XCTAssertEqualObjects(resolved[1][@"stringCol"], @"a");
+        XCTAssertEqualObjects(resolved[2], NSNull.null);
+        XCTAssertEqualObjects([self assertResolve:realm reference:emptyRef], @[]);
+    }];
+
+    RLMAssertThrowsWithReasonMatching([RLMThreadSafeReference referenceWithThreadConfinedObjects:@[[IntObject new]]],
+                                      @"Cannot construct reference to unmanaged object");
+    IntObject *otherRealmObject = [[IntObject alloc] init];
+    RLMRealm *otherRealm = [self realmWithTestPath];
+    [otherRealm transactionWithBlock:^{
+        [otherRealm addObject:otherRealmObject];
+    }];
+    RLMAssertThrowsWithReasonMatching(([RLMThreadSafeReference referenceWithThreadConfinedObjects:@[objects[0], otherRealmObject]]),
+                                      @"managed by different Realms");
+}
+
 - (void)testPassThreadSafeReferenceToArray {
     RLMRealm *realm = [RLMRealm defaultRealm];
     DogArrayObject *object = [[DogArrayObject alloc] init];
@@ -229,6 +264,37 @@
     XCTAssertEqualObjects(@"B", results[1].stringCol);
 }
 
+- (void)testPassThreadSafeReferenceToResultsWithINQuery {
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm transactionWithBlock:^{
+        [StringObject createInDefaultRealmWithValue:@[@"A"]];
+        [StringObject createInDefaultRealmWithValue:@[@"B"]];
+    }];
+    RLMResults<StringObject *> *results = [StringObject objectsWhere:@"stringCol IN %@", @[@"A", @"C", @"E"]];
+    XCTAssertEqual(1ul, results.count);
+    RLMThreadSafeReference *resultsRef = [RLMThreadSafeReference referenceWithThreadConfined:results];
+    [realm transactionWithBlock:^{
+        [StringObject createInDefaultRealmWithValue:@[@"C"]];
+        [StringObject createInDefaultRealmWithValue:@[@"D"]];
+    }];
+    XCTAssertEqual(2ul, results.count);
+    [self dispatchAsyncAndWait:^{
+        RLMRealm *realm = [RLMRealm defaultRealm];
+        RLMResults<StringObject *> *results = [self assertResolve:realm reference:resultsRef];
+        XCTAssertEqual(2ul, results.count);
+        [realm transactionWithBlock:^{
+            [StringObject createInDefaultRealmWithValue:@[@"E"]];
+            [realm deleteObject:[StringObject objectsWhere:@"stringCol = 'A'"].firstObject];
+        }];
+        XCTAssertEqual(2ul, results.count);
+        XCTAssertEqualObjects((@[@"C", @"E"]), [[results sortedResultsUsingKeyPath:@"stringCol" ascending:YES] valueForKey:@"stringCol"]);
+    }];
+    XCTAssertEqual(2ul, results.count);
+    [realm refresh];
+    XCTAssertEqual(2ul, results.count);
+    XCTAssertEqualObjects((@[@"C", @"E"]), [[results sortedResultsUsingKeyPath:@"stringCol" ascending:YES] valueForKey:@"stringCol"]);
+}
+
 - (void)testPassThreadSafeReferenceToLinkingObjects {
     RLMRealm *realm = [RLMRealm defaultRealm];
     DogObject *dogA = [[DogObject alloc] initWithValue:@{@"dogName": @"Cookie", @"age": @10}];
@@ -55,3 +55,40 @@ public typealias PropertyType = RLMPropertyType
  - see: `addNotificationBlock(_:)`
  */
 public typealias NotificationToken = RLMNotificationToken
+
+/**
+ The aggregate functions which can be computed for each group of objects in a `Results`.
+
+ - see: `Results.grouped(by:aggregate:ofProperty:)`
+ */
+public typealias AggregateFunction = RLMAggregateFunction
+
+/**
+ The kinds of operations reported to a `Realm.Configuration`'s `slowOperationHandler`.
+
+ - see: `Realm.Configuration.slowOperationHandler`
+ */
+public typealias SlowOperation = RLMSlowOperation
+
+/**
+ The values of a single property for a batch of objects appended with `Realm.appendColumns(_:to:rowCount:)`, laid out
+ in the same way as an Apache Arrow array.
+ */
+public typealias ColumnBuffer = RLMColumnBuffer
+
+/**
+ How much `Realm.releaseCachedResources(level:)` releases.
+ */
+public typealias CacheReleaseLevel = RLMCacheReleaseLevel
+
+/**
+ A condition on the properties of objects which a `Results` can be filtered by without parsing a predicate.
+
+ - see: `Results.filter(_:)`
+ */
+public typealias QueryCondition = RLMQueryCondition
+
+/**
+ The comparisons which a `QueryCondition` can make between a property and a value.
+ */
+public typealias QueryOperator = RLMQueryOperator
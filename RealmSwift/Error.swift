@@ -69,6 +69,9 @@ extension Realm {
         /// Error thrown by Realm if there is a schema version mismatch, so that a migration is required.
         public static let schemaMismatch: Code = .schemaMismatch
 
+        /// Error thrown by Realm if the write lock could not be acquired within the given timeout.
+        public static let writeLockTimeout: Code = .writeLockTimeout
+
         /// :nodoc:
         public var code: Code {
             return (_nsError as! RLMError).code
@@ -375,6 +375,54 @@ public final class LinkingObjects<T: Object>: LinkingObjectsBase {
             block(RealmCollectionChange.fromObjc(value: self, change: change, error: error))
         }
     }
+
+    /**
+     Registers a block to be called each time the collection changes, but only reports modifications to objects which
+     changed the values at the given key paths.
+
+     This works like `addNotificationBlock(_:)`, except that an object is only reported as modified if the value at at
+     least one of `keyPaths` changed, and the block is not called at all if the only changes were to other properties
+     of the objects or to objects they link to. Insertions and deletions are always reported.
+
+     Each key path is either the name of a property of the objects in the collection or a path through to-one links such
+     as `"owner.name"`.
+
+     - warning: This method cannot be called during a write transaction, or when the containing Realm is read-only.
+
+     - parameter keyPaths: The key paths of the properties whose changes should be reported.
+     - parameter block:    The block to be called whenever a change occurs.
+     - returns: A token which must be held for as long as you want updates to be delivered.
+     */
+    public func addNotificationBlock(keyPaths: [String],
+                                     _ block: @escaping (RealmCollectionChange<LinkingObjects>) -> Void) -> NotificationToken {
+        return rlmResults.addNotificationBlock({ _, change, error in
+            block(RealmCollectionChange.fromObjc(value: self, change: change, error: error))
+        }, keyPaths: keyPaths)
+    }
+
+    /**
+     Registers a block to be called each time the collection changes, but no more often than once per
+     `minimumInterval` seconds.
+
+     Changes which are committed within `minimumInterval` seconds of the last time the block was called are merged
+     together, and the block is called once with the combined changes when the interval has passed. The combined
+     changes describe everything since the previous call, so they can be applied to a table view in the same way as
+     the changes from a single write transaction.
+
+     - warning: This method cannot be called during a write transaction, or when the containing Realm is read-only.
+
+     - parameter keyPaths:        The key paths of the properties whose changes should be reported, or `nil` for all
+                                  properties.
+     - parameter minimumInterval: The minimum time between calls to the block.
+     - parameter block:           The block to be called whenever a change occurs.
+     - returns: A token which must be held for as long as you want updates to be delivered.
+     */
+    public func addNotificationBlock(keyPaths: [String]? = nil, minimumInterval: TimeInterval,
+                                     _ block: @escaping (RealmCollectionChange<LinkingObjects>) -> Void) -> NotificationToken {
+        return rlmResults.addNotificationBlock({ _, change, error in
+            block(RealmCollectionChange.fromObjc(value: self, change: change, error: error))
+        }, keyPaths: keyPaths, minimumInterval: minimumInterval)
+    }
 }
 
 extension LinkingObjects : RealmCollection {
@@ -89,6 +89,15 @@ public final class List<T: Object>: ListBase {
         return notFoundToNil(index: _rlmArray.index(of: object.unsafeCastToRLMObject()))
     }
 
+    /**
+     Returns whether the given object is present in the list.
+
+     - parameter object: An object to find.
+     */
+    public func contains(_ object: T) -> Bool {
+        return index(of: object) != nil
+    }
+
     /**
      Returns the index of the first object in the list matching the predicate, or `nil` if no objects match.
 
@@ -133,6 +142,19 @@ public final class List<T: Object>: ListBase {
     /// Returns the last object in the list, or `nil` if the list is empty.
     public var last: T? { return unsafeBitCast(_rlmArray.lastObject(), to: Optional<T>.self) }
 
+    /**
+     Returns the objects at the given indexes.
+
+     This is equivalent to reading each index with the subscript, but checks the thread and the validity of the list
+     only once, which makes reading a batch of objects, such as the rows passed to
+     `tableView(_:prefetchRowsAt:)`, faster.
+
+     - parameter indexes: The indexes of the objects to return.
+     */
+    public func objects(at indexes: IndexSet) -> [T] {
+        return _rlmArray.objects(at: indexes).map { unsafeBitCast($0 as AnyObject, to: T.self) }
+    }
+
     // MARK: KVC
 
     /**
@@ -282,6 +304,18 @@ public final class List<T: Object>: ListBase {
         return _rlmArray.average(ofProperty: property).map(dynamicBridgeCast)
     }
 
+    /**
+     Returns the count, minimum, maximum, sum, average and variance of the values of a given property over all the
+     objects in the list, computed in a single pass.
+
+     - warning: Only a property whose type conforms to the `AddableType` protocol can be specified.
+
+     - parameter property: The name of a property whose statistics should be calculated.
+     */
+    public func statistics<U: AddableType>(ofProperty property: String) -> PropertyStatistics<U> {
+        return PropertyStatistics(_rlmArray.statistics(forProperty: property))
+    }
+
     // MARK: Mutation
 
     /**
@@ -304,9 +338,7 @@ public final class List<T: Object>: ListBase {
      - warning: This method may only be called during a write transaction.
     */
     public func append<S: Sequence>(objectsIn objects: S) where S.Iterator.Element == T {
-        for obj in objects {
-            _rlmArray.add(obj.unsafeCastToRLMObject())
-        }
+        _rlmArray.addObjects(objects.map { $0.unsafeCastToRLMObject() } as NSArray)
     }
 
     /**
@@ -403,6 +435,32 @@ public final class List<T: Object>: ListBase {
         _rlmArray.exchangeObject(at: UInt(index1), withObjectAt: UInt(index2))
     }
 
+    /**
+     Sorts the objects in the list in place based on the values of the given key path.
+
+     Objects which compare equal keep their existing relative order, and collection notifications report the new order
+     as moves rather than deletions and insertions.
+
+     - warning: This method may only be called during a write transaction.
+
+     - parameter keyPath:   The key path to sort by.
+     - parameter ascending: The direction to sort in.
+     */
+    public func sort(byKeyPath keyPath: String, ascending: Bool = true) {
+        sort(by: [SortDescriptor(keyPath: keyPath, ascending: ascending)])
+    }
+
+    /**
+     Sorts the objects in the list in place using the given sort descriptors.
+
+     - warning: This method may only be called during a write transaction.
+
+     - see: `sort(byKeyPath:ascending:)`
+     */
+    public func sort<S: Sequence>(by sortDescriptors: S) where S.Iterator.Element == SortDescriptor {
+        _rlmArray.sort(using: sortDescriptors.map { $0.rlmSortDescriptorValue })
+    }
+
     // MARK: Notifications
 
     /**
@@ -465,6 +523,77 @@ public final class List<T: Object>: ListBase {
             block(RealmCollectionChange.fromObjc(value: self, change: change, error: error))
         }
     }
+
+    /**
+     Registers a block to be called each time the list changes, but only reports modifications to objects which
+     changed the values at the given key paths.
+
+     This works like `addNotificationBlock(_:)`, except that an object is only reported as modified if the value at at
+     least one of `keyPaths` changed, and the block is not called at all if the only changes were to other properties
+     of the objects or to objects they link to. Insertions and deletions are always reported.
+
+     Each key path is either the name of a property of the objects in the list or a path through to-one links such
+     as `"owner.name"`.
+
+     - warning: This method cannot be called during a write transaction, or when the containing Realm is read-only.
+
+     - parameter keyPaths: The key paths of the properties whose changes should be reported.
+     - parameter block:    The block to be called whenever a change occurs.
+     - returns: A token which must be held for as long as you want updates to be delivered.
+     */
+    public func addNotificationBlock(keyPaths: [String],
+                                     _ block: @escaping (RealmCollectionChange<List>) -> Void) -> NotificationToken {
+        return _rlmArray.addNotificationBlock({ _, change, error in
+            block(RealmCollectionChange.fromObjc(value: self, change: change, error: error))
+        }, keyPaths: keyPaths)
+    }
+
+    /**
+     Registers a block to be called each time the list changes, but no more often than once per
+     `minimumInterval` seconds.
+
+     Changes which are committed within `minimumInterval` seconds of the last time the block was called are merged
+     together, and the block is called once with the combined changes when the interval has passed. The combined
+     changes describe everything since the previous call, so they can be applied to a table view in the same way as
+     the changes from a single write transaction.
+
+     - warning: This method cannot be called during a write transaction, or when the containing Realm is read-only.
+
+     - parameter keyPaths:        The key paths of the properties whose changes should be reported, or `nil` for all
+                                  properties.
+     - parameter minimumInterval: The minimum time between calls to the block.
+     - parameter block:           The block to be called whenever a change occurs.
+     - returns: A token which must be held for as long as you want updates to be delivered.
+     */
+    public func addNotificationBlock(keyPaths: [String]? = nil, minimumInterval: TimeInterval,
+                                     _ block: @escaping (RealmCollectionChange<List>) -> Void) -> NotificationToken {
+        return _rlmArray.addNotificationBlock({ _, change, error in
+            block(RealmCollectionChange.fromObjc(value: self, change: change, error: error))
+        }, keyPaths: keyPaths, minimumInterval: minimumInterval)
+    }
+
+    /**
+     Registers a block to be called on the given dispatch queue each time the list changes.
+
+     This works like `addNotificationBlock(_:)`, except that the block is called asynchronously on `queue` rather than
+     on the current thread, and the current thread does not need to run a run loop. The notifications for all queues
+     are computed on a single background thread managed by Realm.
+
+     The `List` passed to the block belongs to a Realm opened for the thread which the queue is running the block on,
+     and must not be used after the block returns.
+
+     - warning: This method cannot be called during a write transaction, or when the containing Realm is read-only.
+
+     - parameter queue: The serial queue to call the block on.
+     - parameter block: The block to be called whenever a change occurs.
+     - returns: A token which must be held for as long as you want updates to be delivered.
+     */
+    public func addNotificationBlock(on queue: DispatchQueue,
+                                     _ block: @escaping (RealmCollectionChange<List>) -> Void) -> NotificationToken {
+        return _rlmArray.addNotificationBlock({ collection, change, error in
+            block(RealmCollectionChange.fromObjc(value: collection.map { List(rlmArray: $0) } ?? self, change: change, error: error))
+        }, queue: queue)
+    }
 }
 
 extension List: RealmCollection, RangeReplaceableCollection {
@@ -475,6 +604,16 @@ extension List: RealmCollection, RangeReplaceableCollection {
         return RLMIterator(collection: _rlmArray)
     }
 
+    /**
+     Returns a `RLMIterator` that yields successive elements in the `List`, resolving the to-one relationships along
+     the given key paths for each batch of elements at once so that reading them in the loop body is cheap.
+
+     - parameter keyPaths: Key paths made up of to-one relationships, such as `"author"` or `"author.team"`.
+     */
+    public func makeIterator(includingKeyPaths keyPaths: [String]) -> RLMIterator<T> {
+        return RLMIterator(collection: _rlmArray.objects(includingKeyPaths: keyPaths))
+    }
+
     // MARK: RangeReplaceableCollection Support
 
 #if swift(>=3.1)
@@ -497,12 +636,9 @@ extension List: RealmCollection, RangeReplaceableCollection {
     */
     public func replaceSubrange<C: Collection>(_ subrange: Range<Int>, with newElements: C)
         where C.Iterator.Element == T {
-        for _ in subrange.lowerBound..<subrange.upperBound {
-            remove(objectAtIndex: subrange.lowerBound)
-        }
-        for x in newElements.reversed() {
-            insert(x, at: subrange.lowerBound)
-        }
+        throwForNegativeIndex(subrange.lowerBound)
+        _rlmArray.replaceObjects(in: NSRange(location: subrange.lowerBound, length: subrange.count),
+                                 withObjects: newElements.map { $0.unsafeCastToRLMObject() } as NSArray)
     }
 
     /// The position of the first element in a non-empty collection.
@@ -169,6 +169,35 @@ public final class Migration {
         rlmMigration.renameProperty(forClass: typeName, oldName: oldName, newName: newName)
     }
 
+    /**
+     Sets a property of every object of the given type to a value computed from a property of the old version of the
+     object, without creating a `MigrationObject` for each one.
+
+     - parameter propertyName:    The name of the property to set in the new schema.
+     - parameter typeName:        The name of the class to update. This class must be present in both the old and new
+                                  Realm schemas.
+     - parameter oldPropertyName: The name of the property in the old schema whose value is passed to the block.
+     - parameter block:           The block which computes the new value of the property from the old value.
+     */
+    public func transformProperty(_ propertyName: String, onType typeName: String, from oldPropertyName: String,
+                                  _ block: (Any?) -> Any?) {
+        rlmMigration.transformProperty(propertyName, inClass: typeName, fromOldProperty: oldPropertyName, using: block)
+    }
+
+    /**
+     Copies the value of a property in the old version of every object of the given type to a property in the new
+     version. Values are copied directly between the underlying columns when both properties are of the same type,
+     unless the new property is the primary key, whose values are checked for uniqueness as they're copied.
+
+     - parameter oldPropertyName: The name of the property in the old schema to copy the values from.
+     - parameter propertyName:    The name of the property in the new schema to copy the values to.
+     - parameter typeName:        The name of the class to update. This class must be present in both the old and new
+                                  Realm schemas.
+     */
+    public func copyValues(from oldPropertyName: String, to propertyName: String, onType typeName: String) {
+        rlmMigration.copyValues(fromOldProperty: oldPropertyName, toProperty: propertyName, inClass: typeName)
+    }
+
     internal init(_ rlmMigration: RLMMigration) {
         self.rlmMigration = rlmMigration
     }
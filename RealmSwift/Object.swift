@@ -174,6 +174,153 @@ open class Object: RLMObjectBase, ThreadConfined {
      */
     open class func indexedProperties() -> [String] { return [] }
 
+    /**
+     Override this method to return the names of properties which should be indexed, but whose indexes should be
+     built in the background rather than when the Realm is opened.
+
+     The indexes of properties listed here which are missing from an existing Realm file are built on a background
+     queue after it has been opened. Queries on the property work while the index is being built, and use it once it
+     has been. If building an index in the background fails, it's built when the Realm is next opened in the same
+     process instead, and opening the Realm throws an error if it fails again.
+
+     Only string, integer, boolean, `Date`, and `NSDate` properties are supported.
+
+     - returns: An array of property names.
+     */
+    @objc open class func deferredIndexedProperties() -> [String] { return [] }
+
+    /**
+     Override this method to return a dictionary mapping the names of string properties to the names of properties
+     which should hold a case- and diacritic-folded copy of their values.
+
+     The folded properties must be optional string properties. They are indexed, and are updated automatically
+     whenever the property they are a copy of is set; they cannot be set directly. Queries which compare a property
+     with a folded copy using `==[cd]`, `!=[cd]`, `BEGINSWITH[cd]`, `ENDSWITH[cd]` or `CONTAINS[cd]` are performed on
+     the folded copy, which lets equality comparisons use its index.
+
+     - returns: A dictionary mapping property names to the names of the properties holding their folded copies.
+     */
+    @objc open class func foldedIndexedProperties() -> [String: String] { return [:] }
+
+    /**
+     Override this method to return the names of string properties which have only a few distinct values, such as a
+     status or a country code.
+
+     Reading one of these properties returns the same `String` storage for each distinct value, rather than creating
+     a new string for every object read.
+
+     - returns: An array of property names.
+     */
+    @objc open class func internedStringProperties() -> [String] { return [] }
+
+    /**
+     Override this method to return a dictionary mapping the names of string properties to the names of the
+     properties whose combined values they should hold, forming a compound index over those properties.
+
+     The key properties must be optional string properties. They are indexed, and are updated automatically whenever
+     any of the properties they combine is set; they cannot be set directly. Queries which compare each of the
+     properties of a compound index for equality with a value in a single `AND` group are performed as a single
+     comparison with the key property, which finds the matching objects with one index lookup.
+
+     Only non-primary-key string, integer, boolean, `Date`, and `NSDate` properties can be part of a compound index,
+     and each compound index must combine at least two properties.
+
+     - returns: A dictionary mapping property names to the names of the properties they combine.
+     */
+    @objc open class func compoundIndexes() -> [String: [String]] { return [:] }
+
+    /**
+     Override this method to return a dictionary mapping the names of integer properties to the names of a latitude
+     and a longitude property, in that order, forming a geo index over the locations they describe.
+
+     The key properties must be optional integer properties. They are indexed, and are updated automatically whenever
+     the latitude or longitude is set; they cannot be set directly. Queries which bound both the latitude and the
+     longitude of a geo index in a single `AND` group only compare the coordinates of the objects in the cells of the
+     index which overlap the bounding box. The index is also used by `Results.filter(withinDistance:ofLatitude:longitude:geoIndex:)`.
+
+     The latitude and longitude must be non-primary-key `Double` properties, in degrees.
+
+     - returns: A dictionary mapping property names to the names of the latitude and longitude properties they index.
+     */
+    @objc open class func geoIndexes() -> [String: [String]] { return [:] }
+
+    /**
+     Override this method to specify the names of string properties which hold the collation keys of other string
+     properties.
+
+     The key properties must be optional `String` properties. They are updated automatically whenever the property
+     they're the key of is set, and cannot be set directly. Each key is the folded form of the string in the locale
+     returned by `collationLocaleIdentifier()`, with numbers ordered by their value, and sorting by a property which
+     has a collation key sorts by the key, so names are ordered much like `localizedStandardCompare(_:)` would order
+     them while `Results` stay live.
+
+     - returns: A dictionary mapping property names to the names of the properties they hold the collation keys of.
+     */
+    @objc open class func collationKeys() -> [String: String] { return [:] }
+
+    /**
+     Override this method to specify the identifier of the locale the keys listed in `collationKeys()` are folded in.
+
+     - returns: The identifier of a locale, or `nil` to fold the keys without any locale.
+     */
+    @objc open class func collationLocaleIdentifier() -> String? { return nil }
+
+    /**
+     Override this method to specify the names of derived properties, whose values are computed by
+     `value(forDerivedProperty:)` from the properties they're mapped to.
+
+     Derived values are persisted whenever an object is created or one of the properties it's computed from is set, so
+     they can be indexed, queried and sorted on like any other property. They cannot be set directly, and are not
+     recomputed when the properties of linked objects change.
+
+     - returns: A dictionary mapping property names to the names of the properties they're computed from.
+     */
+    @objc open class func derivedProperties() -> [String: [String]] { return [:] }
+
+    /**
+     Override this method to specify the names of `Data` properties which hold vectors of 32-bit floats, such as
+     embeddings, and the number of floats in each vector.
+
+     The property can only be set to `nil`, if it's optional, or to data holding exactly that many floats in the host's
+     byte order.
+
+     - returns: A dictionary mapping property names to the number of floats in their vectors.
+     */
+    @objc open class func vectorProperties() -> [String: Int] { return [:] }
+
+    /**
+     Override this method to specify the name of a `Date` property holding the date at which each object expires.
+
+     Expired objects are deleted in the background in small write transactions, which are reported to notification
+     blocks like any other change, from when the Realm file is first opened and while it remains open. Objects whose
+     expiration date is `nil` never expire, and objects which have expired but not yet been purged can still be read.
+
+     The property is indexed automatically, and must be a non-primary-key `Date` property.
+
+     - returns: The name of the property holding the expiration date.
+     */
+    @objc open class func expirationProperty() -> String? { return nil }
+
+    /**
+     Override this method to return `true` if the initial values of this type's properties are always the same.
+
+     By default the initial values are computed separately for each object created, so that values generated for each
+     object, such as a new unique identifier or the current date, aren't shared between objects. Initial values
+     declared static are instead computed once per Realm instance and reused for every object created in that Realm.
+     If they change, call `invalidateCachedDefaultPropertyValues()` after they do.
+
+     - returns: Whether the initial property values of this type can be cached.
+     */
+    @objc open class func hasStaticDefaultPropertyValues() -> Bool { return false }
+
+    /**
+     Discards the cached initial property values of all Realm object types which declare them static, so that they
+     are recomputed the next time they are needed.
+     */
+    public class func invalidateCachedDefaultPropertyValues() {
+        RLMObject.invalidateCachedDefaultPropertyValues()
+    }
+
     // MARK: Key-Value Coding & Subscripting
 
     /// Returns or sets the value of the property with the given name.
@@ -267,6 +414,100 @@ open class Object: RLMObjectBase, ThreadConfined {
                                    to: List<DynamicObject>.self)
     }
 
+    // MARK: Binary Data
+
+    /**
+     Calls the given closure with a buffer pointer to the contents of a binary data property.
+
+     For managed objects the buffer refers directly to the data in the Realm file, so no copy of the data is made.
+     The buffer is only valid for the duration of the closure, and the Realm must not be written to or refreshed
+     from within it. The buffer is empty if the property is `nil`.
+
+     - parameter propertyName: The name of a `Data` property of the object.
+     - parameter body:         The closure to call with the property's contents.
+
+     - returns: The value returned by `body`.
+     */
+    public func withUnsafeBytes<Result>(ofProperty propertyName: String,
+                                        _ body: (UnsafeRawBufferPointer) -> Result) -> Result {
+        var result: Result?
+        RLMDynamicWithBinaryProperty(self, propertyName) { bytes, length in
+            result = body(UnsafeRawBufferPointer(start: bytes, count: Int(length)))
+        }
+        return result!
+    }
+
+    /**
+     Returns the number of objects linking to the object through a `LinkingObjects` property.
+
+     This is equivalent to reading the `count` of the property, but reads the number of links directly rather than
+     creating a `LinkingObjects`. Comparing the property's `@count` in a query, such as `"parents.@count > 1"`, is
+     also evaluated from the number of links.
+
+     - parameter propertyName: The name of a `LinkingObjects` property of the object.
+
+     - returns: The number of objects linking to the object, or 0 if it is unmanaged.
+     */
+    public func linkingObjectsCount(forProperty propertyName: String) -> Int {
+        return Int(RLMDynamicLinkingObjectsCount(self, propertyName))
+    }
+
+    // MARK: Incrementing Properties
+
+    /**
+     Adds an amount to the value of an integer property.
+
+     The amount is added to the stored value directly rather than by reading the value and writing the sum, and when
+     the Realm is synchronized, the change is recorded as an addition so that increments made concurrently on
+     different devices are all kept.
+
+     - warning: For managed objects, this method may only be called during a write transaction.
+
+     - parameter propertyName: The name of a non-primary-key integer property whose value is not `nil`.
+     - parameter amount:       The amount to add, which may be negative.
+     */
+    public func increment(_ propertyName: String, by amount: Int = 1) {
+        RLMDynamicIncrement(self, propertyName, Int64(amount))
+    }
+
+    // MARK: Derived Properties
+
+    /**
+     Override this method to compute the values of the properties listed in `derivedProperties()`.
+
+     This is called within the write transaction which sets the properties the derived property is computed from, after
+     they have been set, and should only read the object's own properties.
+
+     - parameter propertyName: The name of the derived property to compute.
+
+     - returns: The value of the property, or `nil` for an optional property.
+     */
+    @objc(valueForDerivedProperty:) open func value(forDerivedProperty propertyName: String) -> Any? {
+        throwRealmException("'\(objectSchema.className)' must override value(forDerivedProperty:) to compute the derived property '\(propertyName)'.")
+        return nil
+    }
+
+    // MARK: Detached Copies
+
+    /**
+     Returns an unmanaged copy of the object, along with copies of all of the objects it links to, directly or
+     indirectly.
+
+     The copy is a snapshot of the object's current values which is not confined to the thread the object was read
+     on, and is unaffected by later changes to the Realm. Each reachable object is copied once, so cycles of links are
+     preserved among the copies. `LinkingObjects` properties of the copies are empty.
+
+     Detached copies are intended to be read, not modified; if they are modified, they must not be read from other
+     threads at the same time.
+
+     - warning: This method can only be called on a managed object which isn't a `DynamicObject`.
+
+     - returns: An unmanaged copy of the object.
+     */
+    public func detachedCopy() -> Self {
+        return forceCastToInferred(RLMDetachedCopy(self))
+    }
+
     // MARK: Equatable
 
     /**
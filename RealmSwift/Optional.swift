@@ -39,6 +39,9 @@ public final class RealmOptional<T: RealmOptionalType>: RLMOptionalBase {
     /// The value the optional represents.
     public var value: T? {
         get {
+            if let value: T? = unboxedValue() {
+                return value
+            }
             return underlyingValue.map(dynamicBridgeCast)
         }
         set {
@@ -55,4 +58,36 @@ public final class RealmOptional<T: RealmOptionalType>: RLMOptionalBase {
         super.init()
         self.value = value
     }
+
+    /// Reads the value without boxing it in an `NSNumber`. Returns `nil` for
+    /// types which have to go through `underlyingValue` instead.
+    private func unboxedValue() -> T?? {
+        switch T.self {
+        case is Double.Type:
+            var value = 0.0
+            return unboxed(getDoubleValue(&value), value)
+        case is Float.Type:
+            var value: Float = 0
+            return unboxed(getFloatValue(&value), value)
+        case is Bool.Type:
+            var value: ObjCBool = false
+            return unboxed(getBoolValue(&value), value.boolValue)
+        default:
+            break
+        }
+
+        var value: Int64 = 0
+        switch T.self {
+        case is Int.Type:   return unboxed(getIntValue(&value), Int(value))
+        case is Int8.Type:  return unboxed(getIntValue(&value), Int8(truncatingBitPattern: value))
+        case is Int16.Type: return unboxed(getIntValue(&value), Int16(truncatingBitPattern: value))
+        case is Int32.Type: return unboxed(getIntValue(&value), Int32(truncatingBitPattern: value))
+        case is Int64.Type: return unboxed(getIntValue(&value), value)
+        default:            return nil
+        }
+    }
+
+    private func unboxed<V>(_ hasValue: Bool, _ value: V) -> T?? {
+        return .some(hasValue ? unsafeBitCast(value, to: T.self) : nil)
+    }
 }
@@ -19,6 +19,7 @@
 import Foundation
 import Realm
 import Realm.Private
+import Realm.Dynamic
 
 /**
  A `Realm` instance (also referred to as "a Realm") represents a Realm database.
@@ -80,6 +81,39 @@ public final class Realm {
         self.init(rlmRealm)
     }
 
+    /**
+     Opens a Realm with the given configuration, passes it to the block, and then releases it before returning.
+
+     Unlike a Realm obtained from `Realm(configuration:)`, which stays alive until the enclosing autorelease pool
+     drains, the Realm is released when the block returns, and unless it was already open on this thread it is
+     invalidated so that its read transaction doesn't keep old versions of the file alive. This makes it suitable for
+     loops which open a Realm for each iteration. Objects and collections obtained inside the block should not be used
+     after it returns. A write transaction left open by the block is cancelled.
+
+     - parameter configuration: A configuration value to use when opening the Realm.
+     - parameter block:         The block to call with the Realm.
+
+     - returns: The value returned by the block.
+
+     - throws: An `NSError` if the Realm could not be opened, or the error thrown by the block.
+     */
+    public static func perform<T>(with configuration: Configuration = .defaultConfiguration,
+                                  _ block: (Realm) throws -> T) throws -> T {
+        var result: T?
+        var blockError: Swift.Error?
+        try RLMRealm.perform(with: configuration.rlmConfiguration) { rlmRealm in
+            do {
+                result = try block(Realm(rlmRealm))
+            } catch {
+                blockError = error
+            }
+        }
+        if let error = blockError {
+            throw error
+        }
+        return result!
+    }
+
     /**
      Obtains a `Realm` instance persisted at a specified file URL.
 
@@ -124,6 +158,33 @@ public final class Realm {
         }
     }
 
+    /**
+     Asynchronously open a Realm and deliver it to a block on the given queue as soon as part of its remote content
+     is available.
+
+     This behaves like `asyncOpen(configuration:callbackQueue:callback:)`, except that a synchronized Realm is
+     delivered once at least `initialDownloadSize` bytes of its content have been downloaded, or once all remote
+     content has been downloaded if that comes first. The rest of the content continues to download in the
+     background, and the usual notifications are sent as it is integrated.
+
+     - parameter configuration:       A configuration object to use when opening the Realm.
+     - parameter initialDownloadSize: The number of downloaded bytes after which the Realm is delivered. Passing 0
+                                      waits for all remote content. Ignored for Realms which aren't synchronized.
+     - parameter callbackQueue:       The dispatch queue on which the callback should be run.
+     - parameter callback:            A callback block. If the Realm was successfully opened, it will be passed in
+                                      as an argument. Otherwise, a `Swift.Error` describing what went wrong will be
+                                      passed to the block instead.
+     */
+    public static func asyncOpen(configuration: Realm.Configuration = .defaultConfiguration,
+                                 initialDownloadSize: Int,
+                                 callbackQueue: DispatchQueue = .main,
+                                 callback: @escaping (Realm?, Swift.Error?) -> Void) {
+        RLMRealm.asyncOpen(with: configuration.rlmConfiguration, initialDownloadSize: UInt(initialDownloadSize),
+                           callbackQueue: callbackQueue) { rlmRealm, error in
+            callback(rlmRealm.flatMap(Realm.init), error)
+        }
+    }
+
     // MARK: Transactions
 
     /**
@@ -160,6 +221,27 @@ public final class Realm {
         if isInWriteTransaction { try commitWrite() }
     }
 
+    /**
+     Performs actions contained within the given block inside a write transaction on a background thread, without
+     blocking the calling thread.
+
+     The block is called on a background queue once the write lock for the Realm file has been acquired, with a
+     `Realm` for this Realm's configuration which is already in a write transaction. Objects managed by this Realm
+     can't be used within the block; pass them in with a `ThreadSafeReference` or look them up again by primary key.
+     The transaction is committed after the block returns unless the block cancels it.
+
+     Once the transaction has been committed, this Realm is refreshed if `autorefresh` is enabled, and then
+     `completion` is called on the current thread with an error if the transaction could not be completed.
+
+     - warning: This method can only be called from a thread with a runloop, such as the main thread.
+
+     - parameter block:      The block containing actions to perform.
+     - parameter completion: A block called on the current thread once the transaction has completed.
+     */
+    public func writeAsync(_ block: @escaping (Realm) -> Void, completion: ((Swift.Error?) -> Void)? = nil) {
+        rlmRealm.beginAsyncWriteTransaction({ block(Realm($0)) }, completion: completion)
+    }
+
     /**
      Begins a write transaction on the Realm.
 
@@ -184,6 +266,36 @@ public final class Realm {
         rlmRealm.beginWriteTransaction()
     }
 
+    /**
+     Begins a write transaction on the Realm in which changes to objects are not reported to their key-value
+     observers as they are made.
+
+     Instead, when the transaction is committed, every observed object managed by this Realm is sent a single
+     notification for each of its properties, without meaningful old values. This skips the per-setter observation
+     bookkeeping for large imports whose results only need to appear as a whole. Deleting an observed object still
+     notifies its observers immediately. Other Realm instances and notification blocks see the changes as usual.
+     */
+    public func beginBulkWrite() {
+        rlmRealm.beginBulkWriteTransaction()
+    }
+
+    /**
+     Begins a write transaction on the Realm, waiting at most `timeout` seconds for other write transactions
+     to release the write lock.
+
+     Unlike `beginWrite()`, which waits for as long as another thread or process holds the write lock, this
+     throws a `Realm.Error.writeLockTimeout` error if the lock could not be acquired in time.
+
+     - warning: The timeout only applies to waiting for the write transactions which are in progress while this
+                method waits. A write transaction begun elsewhere in the instant between the lock being released and
+                this method acquiring it makes this method wait until that transaction ends, however long it takes.
+
+     - parameter timeout: The maximum number of seconds to wait for the write lock.
+     */
+    public func beginWrite(timeout: TimeInterval) throws {
+        try rlmRealm.beginWriteTransaction(withTimeout: timeout)
+    }
+
     /**
      Commits all write operations in the current write transaction, and ends
      the transaction.
@@ -298,9 +410,51 @@ public final class Realm {
      - parameter update: If `true`, objects that are already in the Realm will be updated instead of added anew.
      */
     public func add<S: Sequence>(_ objects: S, update: Bool = false) where S.Iterator.Element: Object {
-        for obj in objects {
-            add(obj, update: update)
-        }
+        RLMAddObjectsToRealm(rlmRealm, objects.map { $0 } as NSArray, update)
+    }
+
+    /**
+     Copies objects managed by another Realm into this Realm, along with all of the objects they link to, and returns
+     the copies in the same order.
+
+     The stored values are copied directly, and each object is copied at most once. Objects with a primary key are
+     matched with the objects already in this Realm by their primary key; if `update` is `false` the existing objects
+     are left unchanged and linked to, and otherwise they're updated with the values of the copied objects.
+
+     - warning: This method may only be called during a write transaction.
+
+     - parameter objects: A sequence of objects managed by `realm`.
+     - parameter realm:   The Realm which manages the objects, which must not be for the same file as this Realm.
+     - parameter update:  Whether to update existing objects with the same primary key.
+     */
+    @discardableResult
+    public func copy<S: Sequence>(_ objects: S, from realm: Realm, update: Bool = false) -> [S.Iterator.Element]
+        where S.Iterator.Element: Object {
+        let options: RLMCopyOptions = update ? .updateExisting : []
+        return rlmRealm.copyObjects(objects.map { $0 } as NSArray, from: realm.rlmRealm, options: options)
+            .map { unsafeBitCast($0, to: S.Iterator.Element.self) }
+    }
+
+    /**
+     Appends a batch of objects of the given type, given as the values for each of their properties in column-oriented
+     buffers laid out like Apache Arrow arrays.
+
+     The values are written directly to the Realm's columns rather than creating the objects one at a time. Properties
+     without a column are set to their default value, or to `nil` for optional properties. The primary key, if the type
+     has one, must be given a column.
+
+     - warning: This method may only be called during a write transaction.
+
+     - see: `ColumnBuffer` for the layout of the buffers.
+
+     - parameter columns:  The buffers of each property's values, keyed by property name.
+     - parameter type:     The type of the objects to append.
+     - parameter rowCount: The number of objects to append.
+
+     - throws: An `NSError` if the buffers are not valid for `rowCount` objects, in which case no objects are appended.
+     */
+    public func appendColumns<T: Object>(_ columns: [String: ColumnBuffer], to type: T.Type, rowCount: Int) throws {
+        try rlmRealm.appendColumns(columns, toClass: (type as Object.Type).className(), rowCount: UInt(rowCount))
     }
 
     /**
@@ -324,16 +478,59 @@ public final class Realm {
      - parameter value:  The value used to populate the object.
      - parameter update: If `true`, the Realm will try to find an existing copy of the object (with the same primary
                          key), and update it. Otherwise, the object will be added.
+     - parameter onlyChanged: If `true`, only the properties of an existing object whose value differs from the
+                              supplied value are written, so that unchanged properties do not produce notifications
+                              or grow the transaction log. Has no effect unless `update` is `true`.
 
      - returns: The newly created object.
      */
     @discardableResult
-    public func create<T: Object>(_ type: T.Type, value: Any = [:], update: Bool = false) -> T {
+    public func create<T: Object>(_ type: T.Type, value: Any = [:], update: Bool = false,
+                                  onlyChanged: Bool = false) -> T {
         let typeName = (type as Object.Type).className()
         if update && schema[typeName]?.primaryKeyProperty == nil {
             throwRealmException("'\(typeName)' does not have a primary key and can not be updated")
         }
-        return unsafeDowncast(RLMCreateObjectInRealmWithValue(rlmRealm, typeName, value, update), to: T.self)
+        return unsafeDowncast(RLMCreateObjectInRealmWithValue(rlmRealm, typeName, value,
+                                                              creationOptions(update: update, onlyChanged: onlyChanged)),
+                              to: T.self)
+    }
+
+    /**
+     Creates or updates a Realm object for each value in a sequence, adding them to the Realm.
+
+     Each value is interpreted in the same way as the `value` argument to `create(_:value:update:)`. This is
+     considerably faster than calling `create(_:value:update:)` in a loop, as the schema information needed to
+     populate the objects is resolved once for the whole batch, the existing objects for all of the primary keys are
+     looked up in a single pass, and no accessor objects are created for the new objects.
+
+     Only pass `true` to `update` if the object has a primary key.
+
+     - warning: This method may only be called during a write transaction.
+
+     - parameter type:   The type of the objects to create.
+     - parameter values: A sequence of values used to populate the objects.
+     - parameter update: If `true`, objects with a primary key matching an existing object will update that object.
+     - parameter validate: If `false`, the values are assumed to be of the correct type for their properties and are
+                           only checked in debug builds. Only pass `false` for values from a trusted source.
+
+     - returns: The number of objects which were inserted and the number of existing objects which were updated.
+     */
+    @discardableResult
+    public func create<T: Object, S: Sequence>(_ type: T.Type, values: S, update: Bool = false,
+                                               validate: Bool = true) -> (inserted: Int, updated: Int) {
+        let typeName = (type as Object.Type).className()
+        if update && schema[typeName]?.primaryKeyProperty == nil {
+            throwRealmException("'\(typeName)' does not have a primary key and can not be updated")
+        }
+        var options: RLMCreationOptions = update ? .createOrUpdate : []
+        if !validate {
+            options.insert(.skipValidation)
+        }
+        var inserted: UInt = 0, updated: UInt = 0
+        RLMCreateObjectsInRealmWithValues(rlmRealm, typeName, values.map { $0 as Any } as NSArray,
+                                          options, false, &inserted, &updated, nil)
+        return (Int(inserted), Int(updated))
     }
 
     /**
@@ -361,20 +558,31 @@ public final class Realm {
      - parameter className:  The class name of the object to create.
      - parameter value:      The value used to populate the object.
      - parameter update:     If true will try to update existing objects with the same primary key.
+     - parameter onlyChanged: If true, only the changed properties of an existing object are written.
 
      - returns: The created object.
 
      :nodoc:
      */
     @discardableResult
-    public func dynamicCreate(_ typeName: String, value: Any = [:], update: Bool = false) -> DynamicObject {
+    public func dynamicCreate(_ typeName: String, value: Any = [:], update: Bool = false,
+                              onlyChanged: Bool = false) -> DynamicObject {
         if update && schema[typeName]?.primaryKeyProperty == nil {
             throwRealmException("'\(typeName)' does not have a primary key and can not be updated")
         }
-        return noWarnUnsafeBitCast(RLMCreateObjectInRealmWithValue(rlmRealm, typeName, value, update),
+        return noWarnUnsafeBitCast(RLMCreateObjectInRealmWithValue(rlmRealm, typeName, value,
+                                                                   creationOptions(update: update,
+                                                                                   onlyChanged: onlyChanged)),
                                    to: DynamicObject.self)
     }
 
+    private func creationOptions(update: Bool, onlyChanged: Bool) -> RLMCreationOptions {
+        guard update else {
+            return []
+        }
+        return onlyChanged ? [.createOrUpdate, .updateChangedOnly] : .createOrUpdate
+    }
+
     // MARK: Deleting objects
 
     /**
@@ -473,6 +681,20 @@ public final class Realm {
         return Results<DynamicObject>(RLMGetObjects(rlmRealm, typeName, nil))
     }
 
+    /**
+     Parses a predicate format string so that it can be run repeatedly with different arguments.
+
+     Arguments are referred to as `$0`, `$1` and so on in the format string, e.g. `"age > $0 AND name BEGINSWITH $1"`.
+
+     - parameter predicateFormat: A predicate format string without format specifiers.
+     - parameter type:            The type of the objects to query.
+
+     - returns: A `PreparedQuery` which runs the query when given the values of its arguments.
+     */
+    public func prepareQuery<T: Object>(_ predicateFormat: String, for type: T.Type) -> PreparedQuery<T> {
+        return PreparedQuery<T>(rlmRealm.prepareQuery(predicateFormat, forClass: (type as Object.Type).className()))
+    }
+
     /**
      Retrieves the single instance of a given object type with the given primary key from the Realm.
 
@@ -491,6 +713,47 @@ public final class Realm {
                              to: Optional<T>.self)
     }
 
+    /**
+     Returns all objects of the given type matching the given predicate from each of the given Realms, such as the
+     shards of a dataset split across several files with `Realm.Configuration.configuration(forShard:)`.
+
+     The objects from each Realm are sorted and then merged, so the array is in the same order as if all of the
+     objects were in one Realm. Objects which sort the same are ordered by the Realm they are in. Unlike `Results`, the
+     array is not updated when the Realms change.
+
+     - parameter type:            The type of the objects to be returned.
+     - parameter realms:          The Realms to query, which must all be on the current thread.
+     - parameter predicate:       The predicate with which to filter the objects.
+     - parameter sortDescriptors: The sort descriptors to order the objects by.
+
+     - returns: An array of the objects of type `type` in all the given Realms that match the predicate.
+     */
+    public static func objects<T: Object>(ofType type: T.Type, in realms: [Realm], filter predicate: NSPredicate? = nil,
+                                          sortedBy sortDescriptors: [SortDescriptor] = []) -> [T] {
+        return RLMGetObjectsInRealms(realms.map { $0.rlmRealm }, (type as Object.Type).className(), predicate,
+                                     sortDescriptors.map { $0.rlmSortDescriptorValue })
+            .map { unsafeBitCast($0 as AnyObject, to: T.self) }
+    }
+
+    /**
+     Retrieves the instances of a given object type with the given primary keys from the Realm.
+
+     Returns the objects in the order of the keys, skipping keys which no object has. This is equivalent to calling
+     `object(ofType:forPrimaryKey:)` for each key, but validates the type and the Realm only once.
+
+     This method requires that `primaryKey()` be overridden on the given object class.
+
+     - parameter type: The type of the objects to be returned.
+     - parameter keys: The primary keys of the desired objects.
+
+     - returns: An array of the objects of type `type` with the given primary keys.
+     */
+    public func objects<T: Object, K>(ofType type: T.Type, forPrimaryKeys keys: [K]) -> [T] {
+        let bridged = NSArray(array: keys.map { dynamicBridgeCast(fromSwift: $0) as Any })
+        return RLMGetObjectsForPrimaryKeys(rlmRealm, (type as Object.Type).className(), bridged)
+            .map { unsafeBitCast($0 as AnyObject, to: T.self) }
+    }
+
     /**
      This method is useful only in specialized circumstances, for example, when building
      components that integrate with Realm. If you are simply building an app on Realm, it is
@@ -553,6 +816,43 @@ public final class Realm {
         }
     }
 
+    // MARK: Suspending Collection Notifications
+
+    /**
+     Suspends the change notifications of the collections in this Realm until `resumeCollectionNotifications()` is
+     called.
+
+     While suspended, the changes of the `Results` and `List` notification blocks added on this Realm are not computed
+     in the background. When notifications are resumed, each block is called with `.initial`, as it is when it's first
+     added, rather than with the changes made in each intermediate version. Notifications of objects and of the Realm
+     itself are not suspended.
+     */
+    public func suspendCollectionNotifications() {
+        rlmRealm.suspendCollectionNotifications()
+    }
+
+    /// Resumes the collection notifications suspended by `suspendCollectionNotifications()`.
+    public func resumeCollectionNotifications() {
+        rlmRealm.resumeCollectionNotifications()
+    }
+
+    /**
+     Whether the collection notifications of this Realm are suspended while the app is in the background.
+
+     When `true`, the notifications are suspended when the app enters the background, and resumed when it returns to
+     the foreground. This may only be set to `true` on Realms confined to the main thread.
+
+     Defaults to `false`.
+     */
+    public var suspendsCollectionNotificationsInBackground: Bool {
+        get {
+            return rlmRealm.suspendsCollectionNotificationsInBackground
+        }
+        set {
+            rlmRealm.suspendsCollectionNotificationsInBackground = newValue
+        }
+    }
+
     // MARK: Autorefresh and Refresh
 
     /**
@@ -623,6 +923,43 @@ public final class Realm {
         rlmRealm.invalidate()
     }
 
+    // MARK: Statistics
+
+    /**
+     Returns statistics about the Realm file and the resources this instance is using, for diagnosing unexpected
+     growth of the file or of memory usage.
+
+     See `-[RLMRealm statistics]` for the keys of the returned dictionary.
+     */
+    public func statistics() -> [String: Any] {
+        return rlmRealm.statistics()
+    }
+
+    /**
+     Returns statistics about the write transactions performed by this process, for diagnosing contention for
+     the write lock.
+
+     See `+[RLMRealm writeLockStatistics]` for the keys of the returned dictionary.
+     */
+    public static func writeLockStatistics() -> [String: Any] {
+        return RLMRealm.writeLockStatistics()
+    }
+
+    /**
+     Releases memory which Realm holds only to speed up later operations.
+
+     This is called automatically when the system reports memory pressure. The calling thread's Realms release their
+     caches immediately, and Realms on other threads release theirs the next time they refresh or begin a write
+     transaction.
+
+     - see: `CacheReleaseLevel` for what each level releases.
+
+     - parameter level: How much to release.
+     */
+    public static func releaseCachedResources(level: CacheReleaseLevel = .moderate) {
+        RLMRealm.releaseCachedResources(with: level)
+    }
+
     // MARK: Writing a Copy
 
     /**
@@ -642,6 +979,26 @@ public final class Realm {
         try rlmRealm.writeCopy(to: fileURL, encryptionKey: encryptionKey)
     }
 
+    /**
+     Writes a compacted copy of the Realm to the given output stream on a background queue, such as to upload a
+     backup without first writing it to a file.
+
+     The copy is of the latest version of the Realm at the time the background queue reads it, and is never
+     encrypted, even if the Realm is. The stream is opened if it isn't open already, and is then closed once the copy
+     has been written.
+
+     - parameter stream:        The output stream to write the copy to.
+     - parameter callbackQueue: The queue to call `progress` and `completion` on.
+     - parameter progress:      A block called periodically with the number of bytes written so far.
+     - parameter completion:    A block called once the copy has been written, with an error if it could not be.
+     */
+    public func writeCopy(to stream: OutputStream, callbackQueue: DispatchQueue = .main,
+                          progress: ((Int) -> Void)? = nil, completion: @escaping (Swift.Error?) -> Void) {
+        rlmRealm.writeCopy(to: stream, callbackQueue: callbackQueue,
+                           progress: progress.map { progress in { progress(Int($0)) } },
+                           completion: completion)
+    }
+
     // MARK: Internal
 
     internal var rlmRealm: RLMRealm
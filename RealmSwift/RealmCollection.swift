@@ -23,21 +23,53 @@ import Realm
  An iterator for a `RealmCollection` instance.
  */
 public final class RLMIterator<T: Object>: IteratorProtocol {
-    private var i: UInt = 0
-    private let generatorBase: NSFastEnumerationIterator
-
-    init(collection: RLMCollection) {
-        generatorBase = NSFastEnumerationIterator(collection)
+    // Fast enumeration is driven directly rather than through
+    // NSFastEnumerationIterator so that each element is already known to be a
+    // `T` and doesn't need a dynamic cast from `Any`
+    private let collection: NSFastEnumeration
+    private var state = NSFastEnumerationState()
+    private var buffer = [Unmanaged<AnyObject>?](repeating: nil, count: 16)
+    private var index = 0
+    private var count = -1
+    private var mutations: UInt = 0
+
+    init(collection: NSFastEnumeration) {
+        self.collection = collection
     }
 
     /// Advance to the next element and return it, or `nil` if no next element exists.
     public func next() -> T? {
-        let accessor = unsafeBitCast(generatorBase.next() as! Object?, to: Optional<T>.self)
-        if let accessor = accessor {
-            RLMInitializeSwiftAccessorGenerics(accessor)
+        if index == count || count == -1 {
+            if count == 0 {
+                return nil
+            }
+            refresh()
+            if count == 0 {
+                return nil
+            }
+        }
+        if let mutationsPtr = state.mutationsPtr, mutationsPtr.pointee != mutations {
+            objc_enumerationMutation(collection)
         }
+
+        let accessor = unsafeBitCast(state.itemsPtr![index], to: T.self)
+        index += 1
+        RLMInitializeSwiftAccessorGenerics(accessor)
         return accessor
     }
+
+    private func refresh() {
+        let isFirst = count == -1
+        index = 0
+        count = buffer.withUnsafeMutableBufferPointer {
+            collection.countByEnumerating(with: &state,
+                                          objects: AutoreleasingUnsafeMutablePointer($0.baseAddress!),
+                                          count: $0.count)
+        }
+        if isFirst, let mutationsPtr = state.mutationsPtr {
+            mutations = mutationsPtr.pointee
+        }
+    }
 }
 
 /**
@@ -162,12 +162,29 @@ extension Realm {
          */
         public var readOnly: Bool = false
 
+        /**
+         The URL of a read-only Realm file, such as one bundled with the app, to use as the initial contents of the
+         Realm at `fileURL`.
+
+         When the Realm is opened and no file exists at `fileURL` yet, the seed file is cloned to that location first.
+         On APFS the clone shares the seed's data blocks copy-on-write, so only pages which are later modified consume
+         additional disk space. The seed file itself is never modified. Ignored for in-memory and synchronized Realms.
+         */
+        public var seedFileURL: URL?
+
         /// The current schema version.
         public var schemaVersion: UInt64 = 0
 
         /// The block which migrates the Realm to the current version.
         public var migrationBlock: MigrationBlock?
 
+        /**
+         A block which is called periodically while the migration block processes objects. It is passed the name of
+         the class being processed, the number of objects processed so far by the current operation, and the total
+         number of objects that operation will process.
+         */
+        public var migrationProgressBlock: ((String, Int, Int) -> Void)?
+
         /**
          Whether to recreate the Realm file with the provided schema if a migration is required. This is the case when
          the stored schema differs from the provided schema or the stored schema version differs from the version on
@@ -189,6 +206,121 @@ extension Realm {
          */
         public var shouldCompactOnLaunch: ((Int, Int) -> Bool)?
 
+        /**
+         Returns a block for `shouldCompactOnLaunch` which compacts the file when it is at least the given size and the
+         data in it takes up less than the given fraction of it.
+
+         Compacting a large file can take some time, so open Realms using such a configuration with
+         `Realm.asyncOpen(configuration:callbackQueue:callback:)` to compact them on a background queue.
+
+         - parameter minimumFileSize:     The size in bytes below which the file is never compacted.
+         - parameter maximumUsedFraction: The fraction of the file, between 0 and 1, which must be in use for the file
+                                          not to be compacted.
+         */
+        public static func compactOnLaunch(minimumFileSize: Int, maximumUsedFraction: Double) -> (Int, Int) -> Bool {
+            let block = RLMRealmConfiguration.shouldCompactOnLaunchBlock(withMinimumFileSize: UInt(minimumFileSize),
+                                                                         maximumUsedFraction: maximumUsedFraction)
+            return { totalBytes, usedBytes in block(UInt(totalBytes), UInt(usedBytes)) }
+        }
+
+        /**
+         Adds a block to the write queue for the Realm file this configuration opens, to be called inside a write
+         transaction on the queue's dedicated background thread.
+
+         See `RLMWriteQueue` for how the blocks are grouped into transactions.
+
+         - parameter block:      The block containing actions to perform.
+         - parameter completion: A block called on the main queue once the transaction the block was performed in
+                                 has been committed, with an error if it could not be.
+         */
+        public func enqueueWrite(_ block: @escaping (Realm) -> Void, completion: ((Swift.Error?) -> Void)? = nil) {
+            rlmConfiguration.writeQueue.enqueueWrite({ block(Realm($0)) }, completion: completion)
+        }
+
+        /**
+         Returns a copy of the configuration which opens one shard of a dataset split across several Realm files, so
+         that each file can be compacted, backed up and refreshed on its own.
+
+         Shard `n` of a configuration whose file is `data.realm` is stored in `data.shard-n.realm` in the same
+         directory. Objects should be stored in the shard returned by `shard(forKey:shardCount:)` for their key, and
+         the shards queried together with `Realm.objects(ofType:in:filter:sortedBy:)`.
+
+         - parameter shard: The index of the shard.
+         */
+        public func configuration(forShard shard: Int) -> Configuration {
+            let shardConfiguration = rlmConfiguration.configuration(forShard: UInt(shard))
+            var configuration = self
+            if let identifier = shardConfiguration.inMemoryIdentifier {
+                configuration.inMemoryIdentifier = identifier
+            } else {
+                configuration.fileURL = shardConfiguration.fileURL
+            }
+            return configuration
+        }
+
+        /**
+         Returns the index of the shard which objects with the given key belong in when a dataset is split across the
+         given number of shards.
+
+         The shard depends only on the key and the number of shards, so it is the same in every process and on every
+         device. Only `String` and integer keys are supported.
+
+         - parameter key:        The key, such as the primary key of the object.
+         - parameter shardCount: The number of shards.
+         */
+        public static func shard(forKey key: Any, shardCount: Int) -> Int {
+            return Int(RLMRealmConfiguration.shard(forKey: dynamicBridgeCast(fromSwift: key), shardCount: UInt(shardCount)))
+        }
+
+        /**
+         How long asynchronous writes begun with `Realm.writeAsync(_:completion:)` wait for further asynchronous
+         writes to the same file, in seconds.
+
+         If this is greater than zero, asynchronous writes begun within this interval of each other are performed
+         together in a single write transaction, so that many small writes share one commit. If one of the writes in
+         a group cancels the transaction, the changes made by the writes before it in the group are lost.
+         */
+        public var asyncWriteGroupingInterval: TimeInterval = 0
+
+        /**
+         The quality of service of the background thread which computes the changes reported to collection
+         notification blocks for the Realm file.
+
+         The thread is started when the file is first opened in the process and takes its quality of service from the
+         thread which opened it, so this only has an effect on the configuration which first opens the file.
+         `.default` uses the quality of service of the thread which opens the file.
+         */
+        public var notificationQualityOfService: QualityOfService = .default
+
+        /**
+         A block called whenever evaluating a query, a write transaction, or a stage of delivering notifications on a
+         Realm opened with this configuration takes longer than `slowOperationThreshold`.
+
+         The block is called synchronously on the thread which performed the operation, with a description of the
+         operation and how long it took in seconds. See `RLMSlowOperationBlock` for the keys of the description.
+         */
+        public var slowOperationHandler: ((SlowOperation, [String: Any], TimeInterval) -> Void)?
+
+        /// The duration in seconds above which operations are reported to `slowOperationHandler`.
+        public var slowOperationThreshold: TimeInterval = 0.1
+
+        /**
+         A block called when a Realm opened with this configuration has been reading the same version of the file for
+         longer than `longReadTransactionThreshold` while a newer version has been committed in this process.
+
+         The block is called on a background queue with a description of the Realm and how long it has been reading
+         the version in seconds. See `RLMLongReadTransactionBlock` for the keys of the description.
+         */
+        public var longReadTransactionHandler: (([String: Any], TimeInterval) -> Void)?
+
+        /// The time in seconds after which a Realm still reading an outdated version is reported to
+        /// `longReadTransactionHandler`.
+        public var longReadTransactionThreshold: TimeInterval = 60
+
+        /// Whether Realms which are reported to `longReadTransactionHandler` should be refreshed from their thread's
+        /// run loop if they have `autorefresh` enabled and aren't in a write transaction.
+        public var advancesLongReadTransactions: Bool = false
+
         /// The classes managed by the Realm.
         public var objectTypes: [Object.Type]? {
             set {
@@ -222,8 +354,17 @@ extension Realm {
             configuration.readOnly = self.readOnly
             configuration.schemaVersion = self.schemaVersion
             configuration.migrationBlock = self.migrationBlock.map { accessorMigrationBlock($0) }
+            configuration.migrationProgressBlock = self.migrationProgressBlock
             configuration.deleteRealmIfMigrationNeeded = self.deleteRealmIfMigrationNeeded
             configuration.shouldCompactOnLaunch = self.shouldCompactOnLaunch.map(ObjectiveCSupport.convert)
+            configuration.asyncWriteGroupingInterval = self.asyncWriteGroupingInterval
+            configuration.notificationQualityOfService = self.notificationQualityOfService
+            configuration.seedFileURL = self.seedFileURL
+            configuration.slowOperationHandler = self.slowOperationHandler
+            configuration.slowOperationThreshold = self.slowOperationThreshold
+            configuration.longReadTransactionHandler = self.longReadTransactionHandler
+            configuration.longReadTransactionThreshold = self.longReadTransactionThreshold
+            configuration.advancesLongReadTransactions = self.advancesLongReadTransactions
             configuration.customSchema = self.customSchema
             configuration.disableFormatUpgrade = self.disableFormatUpgrade
             return configuration
@@ -246,8 +387,17 @@ extension Realm {
                     rlmMigration(migration.rlmMigration, schemaVersion)
                 }
             }
+            configuration.migrationProgressBlock = rlmConfiguration.migrationProgressBlock
             configuration.deleteRealmIfMigrationNeeded = rlmConfiguration.deleteRealmIfMigrationNeeded
             configuration.shouldCompactOnLaunch = rlmConfiguration.shouldCompactOnLaunch.map(ObjectiveCSupport.convert)
+            configuration.asyncWriteGroupingInterval = rlmConfiguration.asyncWriteGroupingInterval
+            configuration.notificationQualityOfService = rlmConfiguration.notificationQualityOfService
+            configuration.seedFileURL = rlmConfiguration.seedFileURL
+            configuration.slowOperationHandler = rlmConfiguration.slowOperationHandler
+            configuration.slowOperationThreshold = rlmConfiguration.slowOperationThreshold
+            configuration.longReadTransactionHandler = rlmConfiguration.longReadTransactionHandler
+            configuration.longReadTransactionThreshold = rlmConfiguration.longReadTransactionThreshold
+            configuration.advancesLongReadTransactions = rlmConfiguration.advancesLongReadTransactions
             configuration.customSchema = rlmConfiguration.customSchema
             configuration.disableFormatUpgrade = rlmConfiguration.disableFormatUpgrade
             return configuration
@@ -18,6 +18,8 @@
 
 import Foundation
 import Realm
+import Realm.Dynamic
+import Realm.Private
 
 // MARK: MinMaxType
 
@@ -55,6 +57,204 @@ extension Int16: AddableType {}
 extension Int32: AddableType {}
 extension Int64: AddableType {}
 
+/**
+ The count, minimum, maximum, sum, average and variance of the values of a property in a collection, all computed in a
+ single pass over the collection. Objects whose value for the property is `nil` are not included.
+
+ - see: `statistics(ofProperty:)`
+ */
+public struct PropertyStatistics<U: AddableType> {
+    /// The number of objects with a value for the property.
+    public let count: Int
+
+    /// The minimum value of the property, or `nil` if there are no values.
+    public let min: U?
+
+    /// The maximum value of the property, or `nil` if there are no values.
+    public let max: U?
+
+    /// The sum of the values of the property, which is zero if there are no values.
+    public let sum: U
+
+    /// The average value of the property, or `nil` if there are no values.
+    public let average: Double?
+
+    /// The population variance of the values of the property, or `nil` if there are no values.
+    public let variance: Double?
+
+    internal init(_ statistics: RLMPropertyStatistics) {
+        count = Int(statistics.count)
+        min = statistics.minimum.map(dynamicBridgeCast)
+        max = statistics.maximum.map(dynamicBridgeCast)
+        sum = dynamicBridgeCast(fromObjectiveC: statistics.sum)
+        average = statistics.average?.doubleValue
+        variance = statistics.variance?.doubleValue
+    }
+}
+
+/**
+ Computes an aggregate of a property without boxing the value in an `NSNumber`
+ when `U` is one of the primitive numeric types. Returns `nil` for other types,
+ which must go through the boxed aggregate methods instead.
+ */
+internal func unboxedAggregate<U>(_ results: RLMResults<RLMObject>, _ function: RLMAggregateFunction,
+                                  _ property: String) -> U?? {
+    if U.self == Double.self || U.self == Float.self {
+        var value = 0.0
+        let hasValue = results.aggregate(function, ofProperty: property, doubleValue: &value)
+        return U.self == Double.self ? unboxed(hasValue, value) : unboxed(hasValue, Float(value))
+    }
+
+    var value: Int64 = 0
+    func aggregate() -> Bool {
+        return results.aggregate(function, ofProperty: property, intValue: &value)
+    }
+    switch U.self {
+    case is Int.Type:   return unboxed(aggregate(), Int(value))
+    case is Int8.Type:  return unboxed(aggregate(), Int8(truncatingBitPattern: value))
+    case is Int16.Type: return unboxed(aggregate(), Int16(truncatingBitPattern: value))
+    case is Int32.Type: return unboxed(aggregate(), Int32(truncatingBitPattern: value))
+    case is Int64.Type: return unboxed(aggregate(), value)
+    default:            return nil
+    }
+}
+
+private func unboxed<U, V>(_ hasValue: Bool, _ value: V) -> U?? {
+    return .some(hasValue ? unsafeBitCast(value, to: U.self) : nil)
+}
+
+// MARK: Projections
+
+/**
+ A value type which can be created from some of the properties of a Realm object, read without creating the object.
+
+ Conforming types list the properties they need in `projectedProperties` and read them from the row passed to
+ `init(row:)`:
+
+ ```swift
+ struct PersonSummary: RealmProjection {
+     static let projectedProperties = ["name", "age"]
+
+     let name: String
+     let age: Int
+
+     init(row: ProjectedRow) {
+         name = row.value("name")
+         age = row.value("age")
+     }
+ }
+
+ let summaries = realm.objects(Person.self).project(into: PersonSummary.self)
+ ```
+
+ - see: `Results.project(into:)`
+ */
+public protocol RealmProjection {
+    /// The names of the properties which `init(row:)` reads.
+    static var projectedProperties: [String] { get }
+
+    /// Creates a value from the values of the projected properties of one object.
+    init(row: ProjectedRow)
+}
+
+/**
+ The values of the projected properties of one object in a collection being projected.
+
+ - see: `Results.project(_:_:)`
+ */
+public struct ProjectedRow {
+    fileprivate let columns: ProjectedColumns
+
+    /// The index of the object in the collection being projected.
+    public let index: Int
+
+    /**
+     Returns the value of the given property for this object.
+
+     `U` must be the Swift type of the property, or its `Optional` for optional properties.
+
+     - parameter property: The name of the property, which must be one of the projected properties.
+     */
+    public func value<U>(_ property: String) -> U {
+        guard let column = columns.columns[property] else {
+            throwRealmException("Property '\(property)' is not one of the projected properties.")
+            fatalError()
+        }
+        return column.value(at: index)
+    }
+}
+
+private final class ProjectedColumns {
+    let columns: [String: ProjectedColumn]
+    // Keeps the unboxed values the columns point into alive
+    private let buffers: [NSData]
+
+    init(_ results: RLMResults<RLMObject>, properties: [String]) {
+        let objectSchema = results.realm.schema[results.objectClassName]
+        var columns = [String: ProjectedColumn]()
+        var buffers = [NSData]()
+        for property in properties {
+            let values = results.projectedValues(ofProperty: property)
+            guard let data = values as? NSData, let prop = objectSchema[property] else {
+                columns[property] = .boxed(values as! NSArray)
+                continue
+            }
+            buffers.append(data)
+            switch prop.type {
+            case .int:    columns[property] = .int(data.bytes.assumingMemoryBound(to: Int64.self))
+            case .bool:   columns[property] = .bool(data.bytes.assumingMemoryBound(to: Bool.self))
+            case .float:  columns[property] = .float(data.bytes.assumingMemoryBound(to: Float.self))
+            case .double: columns[property] = .double(data.bytes.assumingMemoryBound(to: Double.self))
+            case .date:   columns[property] = .date(data.bytes.assumingMemoryBound(to: TimeInterval.self))
+            default:      fatalError("Unexpected unboxed values for \(RLMTypeToString(prop.type)) property")
+            }
+        }
+        self.columns = columns
+        self.buffers = buffers
+    }
+}
+
+/**
+ The values of one projected property. Non-optional numeric, `Bool` and `Date` properties are read straight from the
+ unboxed values when `U` is the property's own type, and all other values go through the usual bridging.
+ */
+private enum ProjectedColumn {
+    case int(UnsafePointer<Int64>)
+    case bool(UnsafePointer<Bool>)
+    case float(UnsafePointer<Float>)
+    case double(UnsafePointer<Double>)
+    case date(UnsafePointer<TimeInterval>)
+    case boxed(NSArray)
+
+    func value<U>(at index: Int) -> U {
+        switch self {
+        case .int(let values):
+            let value = values[index]
+            if U.self == Int.self || U.self == Int?.self {
+                return Int(value) as! U
+            }
+            return unboxed(value) { NSNumber(value: $0) }
+        case .bool(let values):
+            return unboxed(values[index]) { NSNumber(value: $0) }
+        case .float(let values):
+            return unboxed(values[index]) { NSNumber(value: $0) }
+        case .double(let values):
+            return unboxed(values[index]) { NSNumber(value: $0) }
+        case .date(let values):
+            return unboxed(Date(timeIntervalSinceReferenceDate: values[index])) { $0 as NSDate }
+        case .boxed(let values):
+            return dynamicBridgeCast(fromObjectiveC: values[index])
+        }
+    }
+
+    private func unboxed<V, U>(_ value: V, _ box: (V) -> Any) -> U {
+        if U.self == V.self || U.self == V?.self {
+            return value as! U
+        }
+        return dynamicBridgeCast(fromObjectiveC: box(value))
+    }
+}
+
 /**
  `Results` is an auto-updating container type in Realm returned from object queries.
 
@@ -113,6 +313,9 @@ public final class Results<T: Object>: NSObject, NSFastEnumeration {
     /// The number of objects in the results.
     public var count: Int { return Int(rlmResults.count) }
 
+    /// Indicates if the results contain any objects, without counting all of them.
+    public var exists: Bool { return rlmResults.exists }
+
     // MARK: Initializers
 
     internal init(_ rlmResults: RLMResults<RLMObject>) {
@@ -165,6 +368,36 @@ public final class Results<T: Object>: NSObject, NSFastEnumeration {
     /// Returns the last object in the results, or `nil` if the results are empty.
     public var last: T? { return unsafeBitCast(rlmResults.lastObject(), to: Optional<T>.self) }
 
+    /**
+     Returns the objects at the given indexes.
+
+     This is equivalent to reading each index with the subscript, but checks the thread and the validity of the results
+     only once, which makes reading a batch of objects, such as the rows passed to
+     `tableView(_:prefetchRowsAt:)`, faster.
+
+     - parameter indexes: The indexes of the objects to return.
+     */
+    public func objects(at indexes: IndexSet) -> [T] {
+        return rlmResults.objects(at: indexes).map { unsafeBitCast($0 as AnyObject, to: T.self) }
+    }
+
+    /**
+     Returns up to `limit` objects from the results which immediately follow the given object.
+
+     Pass `nil` to read the first page of the results, and then the last object of the previous page to read each
+     following page. Because each page is found from an object rather than an index, this continues from the correct
+     place even if the Realm has been refreshed since the previous page was read.
+
+     - parameter object: The object after which the page should start, or `nil` to start from the beginning.
+     - parameter limit:  The maximum number of objects to return.
+     */
+    public func page(after object: T?, limit: Int) -> [T] {
+        throwForNegativeIndex(limit, parameterName: "limit")
+        return rlmResults.pageStarting(after: object?.unsafeCastToRLMObject(), limit: UInt(limit)).map {
+            unsafeBitCast($0, to: T.self)
+        }
+    }
+
     // MARK: KVC
 
     /**
@@ -198,6 +431,19 @@ public final class Results<T: Object>: NSObject, NSFastEnumeration {
         return rlmResults.setValue(value, forKeyPath: key)
     }
 
+    /**
+     Adds an amount to the value of an integer property of each of the objects represented by the results. Objects
+     whose value is `nil` are left unchanged.
+
+     - warning: This method may only be called during a write transaction.
+
+     - parameter propertyName: The name of a non-primary-key integer property.
+     - parameter amount:       The amount to add, which may be negative.
+     */
+    public func increment(_ propertyName: String, by amount: Int = 1) {
+        rlmResults.incrementProperty(propertyName, by: amount)
+    }
+
     // MARK: Filtering
 
     /**
@@ -218,6 +464,60 @@ public final class Results<T: Object>: NSObject, NSFastEnumeration {
         return Results<T>(rlmResults.objects(with: predicate))
     }
 
+    /**
+     Returns a `Results` containing all objects in the collection which meet the given condition.
+
+     Filtering by a condition builds the query from it directly rather than parsing a predicate.
+
+     - parameter condition: The condition with which to filter the objects.
+     */
+    public func filter(_ condition: QueryCondition) -> Results<T> {
+        return Results<T>(rlmResults.objects(matching: condition))
+    }
+
+    /**
+     Returns a `Results` containing all objects in the collection where each word of `text` is the start of a word in
+     at least one of the given string properties, ignoring case and diacritics.
+
+     - parameter text:       The text to search for.
+     - parameter properties: The names of the string properties to search.
+     */
+    public func filter(matchingText text: String, in properties: [String]) -> Results<T> {
+        return Results<T>(rlmResults.objectsMatchingText(text, inProperties: properties))
+    }
+
+    /**
+     Returns a `Results` containing all objects whose location is within a distance of the given location.
+
+     The locations of the objects are given by the latitude and longitude properties of a geo index (see
+     `Object.geoIndexes()`), and distances are measured along the surface of the Earth. Only the objects in the cells
+     of the geo index which overlap the bounding box of the circle are measured.
+
+     - parameter distance:  The maximum distance, in meters.
+     - parameter latitude:  The latitude of the center of the circle, in degrees.
+     - parameter longitude: The longitude of the center of the circle, in degrees.
+     - parameter geoIndex:  The name of the key property of the geo index.
+     */
+    public func filter(withinDistance distance: Double, ofLatitude latitude: Double, longitude: Double,
+                       geoIndex: String) -> Results<T> {
+        return Results<T>(rlmResults.objects(withinDistance: distance, ofLatitude: latitude, longitude: longitude,
+                                             geoIndex: geoIndex))
+    }
+
+    /**
+     Returns a `Results` containing only the first objects in the collection, selected without sorting the rest.
+
+     Objects which compare equal to the last of the selected objects under the sort order are also included, and the
+     `Results` contains the objects which sort at or before it as it updates.
+
+     - warning: Results derived from a `List` or `LinkingObjects` must be sorted before they can be limited.
+
+     - parameter limit: The number of objects to include.
+     */
+    public func limited(to limit: Int) -> Results<T> {
+        return Results<T>(rlmResults.resultsLimited(to: UInt(limit)))
+    }
+
     // MARK: Sorting
 
     /**
@@ -269,6 +569,81 @@ public final class Results<T: Object>: NSObject, NSFastEnumeration {
         return Results<T>(rlmResults.sortedResults(using: sortDescriptors.map { $0.rlmSortDescriptorValue }))
     }
 
+    /**
+     Returns a `Results` containing only the first object for each distinct combination of values of the given key
+     paths. The objects are deduplicated by the query engine, and the `Results` updates like any other.
+
+     - warning: Collections may only be made distinct by properties of boolean, `Date`, `NSDate`, single and
+                double-precision floating point, integer, and string types.
+
+     - parameter keyPaths: The key paths whose values identify distinct objects.
+     */
+    public func distinct<S: Sequence>(by keyPaths: S) -> Results<T> where S.Iterator.Element == String {
+        return Results<T>(rlmResults.distinctResults(usingKeyPaths: Array(keyPaths)))
+    }
+
+    /**
+     Evaluates the query and stores the objects it matches in the Realm file under the given name, in a write
+     transaction of its own, so that `materialized(named:)` can return them until the next write transaction is
+     committed.
+
+     - warning: This method may only be called outside of a write transaction, on results of all objects of a type or
+                filtered from them, and not on results of a synchronized or read-only Realm.
+
+     - parameter name: The name the matching objects are stored under.
+
+     - throws: An `NSError` if the objects could not be stored.
+     */
+    public func materialize(named name: String) throws {
+        try rlmResults.materialize(withName: name)
+    }
+
+    /**
+     Returns a `Results` containing the same objects, which uses the objects stored under the given name by
+     `materialize(named:)` rather than evaluating the query, if they are still up to date. This never writes to the
+     Realm.
+
+     - warning: This method may only be called on results of all objects of a type or filtered from them, and not on
+                results of a synchronized Realm.
+
+     - parameter name: The name the matching objects are stored under.
+     */
+    public func materialized(named name: String) -> Results<T> {
+        return Results<T>(rlmResults.materializedResults(named: name))
+    }
+
+    // MARK: Inspecting Queries
+
+    /**
+     Returns a description of how the query of the `Results` is evaluated: the tree of conditions it was filtered with,
+     whether each condition uses a search index or looks at every object, the estimated number of objects looked at,
+     and the number of matching objects and the time taken when evaluating the query.
+
+     See `-[RLMResults explain]` for the keys of the returned dictionary. The query is evaluated each time this is
+     called.
+     */
+    public func explain() -> [String: Any] {
+        return rlmResults.explain()
+    }
+
+    /**
+     Sets a block to be called whenever evaluating the query of a `Results` of any object type takes longer than
+     `threshold` seconds. The block is passed the name of the object type and the time the evaluation took, and is
+     called synchronously on the thread the query was evaluated on.
+
+     Pass `nil` to stop timing queries, which is the default.
+     */
+    public static func setSlowQueryThreshold(_ threshold: TimeInterval,
+                                             handler: ((_ objectClassName: String, _ duration: TimeInterval) -> Void)?) {
+        guard let handler = handler else {
+            RLMResults<RLMObject>.setSlowQueryThreshold(threshold, handler: nil)
+            return
+        }
+        RLMResults<RLMObject>.setSlowQueryThreshold(threshold) { results, duration in
+            handler(results.objectClassName, duration)
+        }
+    }
+
     // MARK: Aggregate Operations
 
     /**
@@ -279,6 +654,9 @@ public final class Results<T: Object>: NSObject, NSFastEnumeration {
      - parameter property: The name of a property whose minimum value is desired.
      */
     public func min<U: MinMaxType>(ofProperty property: String) -> U? {
+        if let value: U? = unboxedAggregate(rlmResults, .min, property) {
+            return value
+        }
         return rlmResults.min(ofProperty: property).map(dynamicBridgeCast)
     }
 
@@ -290,6 +668,9 @@ public final class Results<T: Object>: NSObject, NSFastEnumeration {
      - parameter property: The name of a property whose minimum value is desired.
      */
     public func max<U: MinMaxType>(ofProperty property: String) -> U? {
+        if let value: U? = unboxedAggregate(rlmResults, .max, property) {
+            return value
+        }
         return rlmResults.max(ofProperty: property).map(dynamicBridgeCast)
     }
 
@@ -301,6 +682,9 @@ public final class Results<T: Object>: NSObject, NSFastEnumeration {
      - parameter property: The name of a property whose values should be summed.
      */
     public func sum<U: AddableType>(ofProperty property: String) -> U {
+        if let value: U? = unboxedAggregate(rlmResults, .sum, property), let sum = value {
+            return sum
+        }
         return dynamicBridgeCast(fromObjectiveC: rlmResults.sum(ofProperty: property))
     }
 
@@ -312,9 +696,194 @@ public final class Results<T: Object>: NSObject, NSFastEnumeration {
      - parameter property: The name of a property whose average value should be calculated.
      */
     public func average<U: AddableType>(ofProperty property: String) -> U? {
+        if let value: U? = unboxedAggregate(rlmResults, .average, property) {
+            return value
+        }
         return rlmResults.average(ofProperty: property).map(dynamicBridgeCast)
     }
 
+    /**
+     Returns the count, minimum, maximum, sum, average and variance of the values of a given property over all the
+     results, computed in a single pass.
+
+     - warning: Only a property whose type conforms to the `AddableType` protocol can be specified.
+
+     - parameter property: The name of a property whose statistics should be calculated.
+     */
+    public func statistics<U: AddableType>(ofProperty property: String) -> PropertyStatistics<U> {
+        return PropertyStatistics(rlmResults.statistics(forProperty: property))
+    }
+
+    /**
+     Groups the results by the value of a property, and computes an aggregate of another property for each group.
+
+     Objects are grouped by the value of an `Int`, `Bool` or `String` property, or by the primary key of the object
+     linked to by an object property. Objects with a `nil` group value are grouped under `NSNull`, and groups where
+     the aggregated property has no values map to `NSNull` except when counting or summing.
+
+     - parameter groupProperty: The name of the property whose values identify the groups.
+     - parameter function:      The aggregate to compute for each group.
+     - parameter property:      The name of the property to aggregate, which may be `nil` when counting objects.
+     */
+    public func grouped(by groupProperty: String, aggregate function: AggregateFunction,
+                        ofProperty property: String? = nil) -> [AnyHashable: Any] {
+        return rlmResults.grouped(by: groupProperty, aggregate: function, ofProperty: property)
+    }
+
+    // MARK: Column Values
+
+    /**
+     Calls the given closure with a buffer containing the values of the given property for all the results, without
+     creating an object or boxing each value.
+
+     The buffer's element type must correspond to the type of the property: `Int64` for integer properties, `Float`
+     for `Float` properties and `Double` for `Double` properties. `nil` values of optional properties are `0` for
+     integer properties and `NaN` for floating-point properties.
+
+     - warning: The buffer is only valid for the duration of the closure and must not escape from it.
+
+     - parameter property: The name of the property whose values should be read.
+     - parameter type:     The buffer's element type.
+     - parameter body:     The closure to call with the buffer.
+
+     - returns: The value returned by `body`.
+     */
+    public func withUnsafeBufferPointer<U, Result>(of property: String, as type: U.Type,
+                                                   _ body: (UnsafeBufferPointer<U>) throws -> Result) rethrows -> Result {
+        if let prop = rlmResults.realm.schema[rlmResults.objectClassName][property],
+            prop.type != columnPropertyType(type) {
+            throwRealmException("Cannot read values of \(RLMTypeToString(prop.type)) property '\(property)' " +
+                                "into a buffer of \(type).")
+        }
+        let count = Int(rlmResults.count)
+        let buffer = UnsafeMutablePointer<U>.allocate(capacity: count)
+        defer { buffer.deallocate(capacity: count) }
+        let copied = rlmResults.copyValues(ofProperty: property, intoBuffer: buffer, count: UInt(count))
+        return try body(UnsafeBufferPointer(start: buffer, count: Int(copied)))
+    }
+
+    private func columnPropertyType<U>(_ type: U.Type) -> RLMPropertyType? {
+        if type == Int64.self {
+            return .int
+        }
+        if type == Float.self {
+            return .float
+        }
+        if type == Double.self {
+            return .double
+        }
+        return nil
+    }
+
+    // MARK: Detached Copies
+
+    /**
+     Returns unmanaged copies of the objects in the results, along with copies of all of the objects they link to.
+
+     The copies can be read from any thread and are unaffected by later changes to the Realm. Each object is copied
+     once, even if it is reachable from more than one of the results. See `Object.detachedCopy()` for details.
+
+     - returns: An array of unmanaged copies of the objects, in the order of the results.
+     */
+    public func detachedCopy() -> [T] {
+        return RLMDetachedCopies(rlmResults).map { $0 as! T }
+    }
+
+    // MARK: Projections
+
+    /**
+     Returns a value created by the given closure from the values of the given properties of each object in the
+     results, in the order of the results.
+
+     The values of each property are read for all of the results at once, without creating an `Object` for each
+     result, so this is much faster than reading the properties through the objects when copying them into value
+     types.
+
+     ```swift
+     let names: [String] = people.project(["name"]) { $0.value("name") }
+     ```
+
+     - parameter properties: The names of the properties to read. Only properties with primitive types can be projected.
+     - parameter transform:  The closure to call with the values of the properties of each object.
+
+     - returns: An array of the values returned by `transform`.
+     */
+    public func project<U>(_ properties: [String], _ transform: (ProjectedRow) throws -> U) rethrows -> [U] {
+        let count = Int(rlmResults.count)
+        if count == 0 {
+            return []
+        }
+        let columns = ProjectedColumns(rlmResults, properties: properties)
+        var values = [U]()
+        values.reserveCapacity(count)
+        for index in 0..<count {
+            values.append(try transform(ProjectedRow(columns: columns, index: index)))
+        }
+        return values
+    }
+
+    /**
+     Returns a value of the given type created from the projected properties of each object in the results, in the
+     order of the results.
+
+     - parameter type: The type of the values to create.
+
+     - returns: An array with a value of type `type` for each object in the results.
+     */
+    public func project<U: RealmProjection>(into type: U.Type) -> [U] {
+        return project(U.projectedProperties) { U(row: $0) }
+    }
+
+    // MARK: Prefetching
+
+    /**
+     Reads the objects in the results on the given queue, so that the parts of the Realm file they are stored in are
+     in memory before the objects are used.
+
+     See `-[RLMResults prefetchOnQueue:completion:]` for details.
+
+     - warning: This method cannot be called during a write transaction.
+
+     - parameter queue:      The queue to read the objects on.
+     - parameter completion: A block called on `queue` once the objects have been read.
+     */
+    public func prefetch(on queue: DispatchQueue, completion: (() -> Void)? = nil) {
+        rlmResults.prefetch(on: queue, completion: completion)
+    }
+
+    // MARK: Exporting
+
+    /**
+     Writes the given properties of the objects in the results to a stream as CSV, reading the values directly from
+     the Realm file without creating an object for each row.
+
+     See `-[RLMResults writeCSVToStream:properties:error:]` for details of the format.
+
+     - parameter stream:     The stream to write to. It is opened if it isn't already open, and is not closed.
+     - parameter properties: The names of the properties to write, or `nil` to write every property which can be.
+
+     - throws: An `NSError` if writing to the stream fails.
+     */
+    public func writeCSV(to stream: OutputStream, properties: [String]? = nil) throws {
+        try rlmResults.writeCSV(to: stream, properties: properties)
+    }
+
+    /**
+     Writes the given properties of the objects in the results to a stream as CSV on the given queue, reading the
+     version of the Realm which the results currently represent.
+
+     - warning: This method cannot be called during a write transaction.
+
+     - parameter stream:     The stream to write to, which must not be used by anything else until `completion` is called.
+     - parameter properties: The names of the properties to write, or `nil` to write every property which can be.
+     - parameter queue:      The queue to perform the export on.
+     - parameter completion: A block called on `queue` once the export has finished, with the error that stopped it.
+     */
+    public func writeCSV(to stream: OutputStream, properties: [String]? = nil, queue: DispatchQueue,
+                         completion: ((Swift.Error?) -> Void)? = nil) {
+        rlmResults.writeCSV(to: stream, properties: properties, queue: queue, completion: completion)
+    }
+
     // MARK: Notifications
 
     /**
@@ -377,6 +946,96 @@ public final class Results<T: Object>: NSObject, NSFastEnumeration {
             block(RealmCollectionChange.fromObjc(value: self, change: change, error: error))
         }
     }
+
+    /**
+     Registers a block to be called each time the results collection changes, but only reports modifications to objects which
+     changed the values at the given key paths.
+
+     This works like `addNotificationBlock(_:)`, except that an object is only reported as modified if the value at at
+     least one of `keyPaths` changed, and the block is not called at all if the only changes were to other properties
+     of the objects or to objects they link to. Insertions and deletions are always reported.
+
+     Each key path is either the name of a property of the objects in the results collection or a path through to-one links such
+     as `"owner.name"`.
+
+     - warning: This method cannot be called during a write transaction, or when the containing Realm is read-only.
+
+     - parameter keyPaths: The key paths of the properties whose changes should be reported.
+     - parameter block:    The block to be called whenever a change occurs.
+     - returns: A token which must be held for as long as you want updates to be delivered.
+     */
+    public func addNotificationBlock(keyPaths: [String],
+                                     _ block: @escaping (RealmCollectionChange<Results>) -> Void) -> NotificationToken {
+        return rlmResults.addNotificationBlock({ _, change, error in
+            block(RealmCollectionChange.fromObjc(value: self, change: change, error: error))
+        }, keyPaths: keyPaths)
+    }
+
+    /**
+     Registers a block to be called each time the results collection changes, but no more often than once per
+     `minimumInterval` seconds.
+
+     Changes which are committed within `minimumInterval` seconds of the last time the block was called are merged
+     together, and the block is called once with the combined changes when the interval has passed. The combined
+     changes describe everything since the previous call, so they can be applied to a table view in the same way as
+     the changes from a single write transaction.
+
+     - warning: This method cannot be called during a write transaction, or when the containing Realm is read-only.
+
+     - parameter keyPaths:        The key paths of the properties whose changes should be reported, or `nil` for all
+                                  properties.
+     - parameter minimumInterval: The minimum time between calls to the block.
+     - parameter block:           The block to be called whenever a change occurs.
+     - returns: A token which must be held for as long as you want updates to be delivered.
+     */
+    public func addNotificationBlock(keyPaths: [String]? = nil, minimumInterval: TimeInterval,
+                                     _ block: @escaping (RealmCollectionChange<Results>) -> Void) -> NotificationToken {
+        return rlmResults.addNotificationBlock({ _, change, error in
+            block(RealmCollectionChange.fromObjc(value: self, change: change, error: error))
+        }, keyPaths: keyPaths, minimumInterval: minimumInterval)
+    }
+
+    /**
+     Registers a block to be called on the given dispatch queue each time the results collection changes.
+
+     This works like `addNotificationBlock(_:)`, except that the block is called asynchronously on `queue` rather than
+     on the current thread, and the current thread does not need to run a run loop. The notifications for all queues
+     are computed on a single background thread managed by Realm.
+
+     The `Results` passed to the block belongs to a Realm opened for the thread which the queue is running the block on,
+     and must not be used after the block returns.
+
+     - warning: This method cannot be called during a write transaction, or when the containing Realm is read-only.
+
+     - parameter queue: The serial queue to call the block on.
+     - parameter block: The block to be called whenever a change occurs.
+     - returns: A token which must be held for as long as you want updates to be delivered.
+     */
+    public func addNotificationBlock(on queue: DispatchQueue,
+                                     _ block: @escaping (RealmCollectionChange<Results>) -> Void) -> NotificationToken {
+        return rlmResults.addNotificationBlock({ collection, change, error in
+            block(RealmCollectionChange.fromObjc(value: collection.map { Results($0) } ?? self, change: change, error: error))
+        }, queue: queue)
+    }
+
+    /**
+     Evaluates the results on a background thread, and calls the block on the current thread once they are ready.
+     Reading the results from the block does not need to run the query again.
+
+     The block is called at most once, and the returned token does not need to be retained. Call `stop()` on the token
+     to cancel the evaluation.
+
+     - warning: This method cannot be called during a write transaction, or when the containing Realm is read-only.
+
+     - parameter completion: The block to be called with the evaluated results, or with an error.
+     - returns: A token which can be used to cancel the evaluation.
+     */
+    @discardableResult
+    public func evaluateAsync(_ completion: @escaping (Results<T>?, Swift.Error?) -> Void) -> NotificationToken {
+        return rlmResults.evaluateAsync { results, error in
+            completion(results.map { _ in self }, error)
+        }
+    }
 }
 
 extension Results: RealmCollection {
@@ -387,6 +1046,27 @@ extension Results: RealmCollection {
         return RLMIterator(collection: rlmResults)
     }
 
+    /**
+     Returns a `RLMIterator` that yields a single object which is updated to refer to each element of the results in
+     turn, rather than creating a new object for every element.
+
+     - warning: Each object yielded by the iterator is only valid until `next()` is next called, and must not be
+                stored or otherwise escape from the loop body.
+     */
+    public func makeReusingIterator() -> RLMIterator<T> {
+        return RLMIterator(collection: rlmResults.objectsReusingAccessor())
+    }
+
+    /**
+     Returns a `RLMIterator` that yields successive elements in the results, resolving the to-one relationships along
+     the given key paths for each batch of elements at once so that reading them in the loop body is cheap.
+
+     - parameter keyPaths: Key paths made up of to-one relationships, such as `"author"` or `"author.team"`.
+     */
+    public func makeIterator(includingKeyPaths keyPaths: [String]) -> RLMIterator<T> {
+        return RLMIterator(collection: rlmResults.objects(includingKeyPaths: keyPaths))
+    }
+
     // MARK: Collection Support
 
     /// The position of the first element in a non-empty collection.
@@ -423,6 +1103,39 @@ extension Results: AssistedObjectiveCBridgeable {
     }
 }
 
+// MARK: Prepared Queries
+
+/**
+ A predicate which has been parsed ahead of time, and is then run any number of times with different arguments.
+
+ Only parsing the format string is done ahead of time. The query is still built from the parsed predicate each time it
+ is run, as the values it compares with are part of the query.
+
+ Prepared queries are created with `Realm.prepareQuery(_:for:)`, and are confined to the thread of the Realm they were
+ created with.
+ */
+public final class PreparedQuery<T: Object> {
+    internal let rlmPreparedQuery: RLMPreparedQuery
+
+    internal init(_ rlmPreparedQuery: RLMPreparedQuery) {
+        self.rlmPreparedQuery = rlmPreparedQuery
+    }
+
+    /// The number of arguments which must be supplied when running the query.
+    public var argumentCount: Int { return Int(rlmPreparedQuery.argumentCount) }
+
+    /**
+     Runs the query with the given arguments.
+
+     - parameter arguments: The values to use for `$0`, `$1` and so on in the predicate format string.
+
+     - returns: A `Results` containing the objects matching the predicate.
+     */
+    public func results(_ arguments: Any...) -> Results<T> {
+        return Results<T>(rlmPreparedQuery.results(withArguments: arguments))
+    }
+}
+
 // MARK: Unavailable
 
 extension Results {
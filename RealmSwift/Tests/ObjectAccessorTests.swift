@@ -211,6 +211,28 @@ class ObjectAccessorTests: TestCase {
         }
     }
 
+    func testListFirstUsedAfterChangesOrDeletion() {
+        let realm = try! Realm()
+        try! realm.write {
+            realm.create(SwiftArrayPropertyObject.self, value: ["a", [["x"]], []])
+        }
+        let object = realm.objects(SwiftArrayPropertyObject.self).first!
+        let copy = realm.objects(SwiftArrayPropertyObject.self).first!
+
+        try! realm.write {
+            object.array.append(SwiftStringObject(value: ["y"]))
+        }
+        XCTAssertEqual(copy.array.count, 2)
+        XCTAssertEqual(copy.array.last!.stringCol, "y")
+
+        let unused = realm.objects(SwiftArrayPropertyObject.self).first!
+        try! realm.write {
+            realm.delete(object)
+        }
+        XCTAssertTrue(unused.array.isInvalidated)
+        XCTAssertTrue(unused.intArray.isInvalidated)
+    }
+
     func testSettingOptionalPropertyOnDeletedObjectsThrows() {
         let realm = try! Realm()
         try! realm.write {
@@ -226,6 +248,21 @@ class ObjectAccessorTests: TestCase {
         }
     }
 
+    func testReadingOptionalPropertyOnDeletedObjectsThrows() {
+        let realm = try! Realm()
+        try! realm.write {
+            let obj = realm.create(SwiftOptionalObject.self, value: ["optIntCol": 1, "optBoolCol": true])
+            XCTAssertEqual(obj.optIntCol.value, 1)
+            XCTAssertEqual(obj.optBoolCol.value, true)
+            XCTAssertNil(obj.optDoubleCol.value)
+            realm.delete(obj)
+
+            self.assertThrows(obj.optIntCol.value)
+            self.assertThrows(obj.optBoolCol.value)
+            self.assertThrows(obj.optDoubleCol.value)
+        }
+    }
+
     func setAndTestAllOptionalProperties(_ object: SwiftOptionalObject) {
         object.optNSStringCol = ""
         XCTAssertEqual(object.optNSStringCol!, "")
@@ -53,6 +53,24 @@ class CTTStringList: Object {
     let array = List<CTTStringObjectWithLink>()
 }
 
+struct CTTAggregateSummary: RealmProjection {
+    static let projectedProperties = ["intCol", "int8Col", "doubleCol", "boolCol", "dateCol"]
+
+    let int: Int
+    let int8: Int8
+    let double: Double
+    let bool: Bool
+    let date: Date
+
+    init(row: ProjectedRow) {
+        int = row.value("intCol")
+        int8 = row.value("int8Col")
+        double = row.value("doubleCol")
+        bool = row.value("boolCol")
+        date = row.value("dateCol")
+    }
+}
+
 class RealmCollectionTypeTests: TestCase {
     var str1: CTTStringObjectWithLink?
     var str2: CTTStringObjectWithLink?
@@ -582,6 +600,68 @@ class ResultsTests: RealmCollectionTypeTests {
         }
     }
 
+    func testReusingIterator() {
+        let iterator = collectionBase().makeReusingIterator()
+        var first: CTTStringObjectWithLink?
+        var str = ""
+        while let obj = iterator.next() {
+            if first == nil {
+                first = obj
+            }
+            XCTAssertTrue(obj === first)
+            str += obj.stringCol
+        }
+        XCTAssertEqual(str, "12")
+    }
+
+    func testWithUnsafeBufferPointer() {
+        _ = makeAggregateableObjects()
+        let results = realmWithTestPath().objects(CTTAggregateObject.self)
+        let ints = results.withUnsafeBufferPointer(of: "intCol", as: Int64.self) { Array($0) }
+        XCTAssertEqual(ints.count, 3)
+        XCTAssertEqual(ints.reduce(0, +), 6)
+        let doubleSum = results.withUnsafeBufferPointer(of: "doubleCol", as: Double.self) { $0.reduce(0, +) }
+        XCTAssertEqualWithAccuracy(5.55, doubleSum, accuracy: 0.001)
+
+        assertThrows(results.withUnsafeBufferPointer(of: "intCol", as: Double.self) { $0.count },
+                     reason: "Cannot read values of int property 'intCol' into a buffer of Double.")
+        assertThrows(results.withUnsafeBufferPointer(of: "noSuchCol", as: Double.self) { $0.count },
+                     named: "Invalid property name")
+    }
+
+    func testProject() {
+        _ = makeAggregateableObjects()
+        let results = realmWithTestPath().objects(CTTAggregateObject.self).sorted(byKeyPath: "intCol")
+        let summaries = results.project(into: CTTAggregateSummary.self)
+        XCTAssertEqual(summaries.map { $0.int }, [1, 2, 3])
+        XCTAssertEqual(summaries.map { $0.int8 }, [1, 2, 3])
+        XCTAssertEqual(summaries.map { $0.double }, [1.11, 2.22, 2.22])
+        XCTAssertEqual(summaries.map { $0.bool }, [false, false, false])
+        XCTAssertEqual(summaries.map { $0.date }, [Date(timeIntervalSince1970: 1), Date(timeIntervalSince1970: 2),
+                                                   Date(timeIntervalSince1970: 2)])
+
+        let indexes: [Int] = results.project([]) { $0.index }
+        XCTAssertEqual(indexes, [0, 1, 2])
+        XCTAssertEqual(results.filter("intCol > 5").project(into: CTTAggregateSummary.self).count, 0)
+
+        let realm = realmWithTestPath()
+        try! realm.write {
+            realm.create(SwiftOptionalObject.self, value: ["optStringCol": "a", "optIntCol": 1])
+            realm.create(SwiftOptionalObject.self)
+        }
+        let optionals: [(String?, Int?)] = realm.objects(SwiftOptionalObject.self).project(["optStringCol", "optIntCol"]) {
+            ($0.value("optStringCol"), $0.value("optIntCol"))
+        }
+        XCTAssertEqual(optionals.map { $0.0 ?? "nil" }, ["a", "nil"])
+        XCTAssertEqual(optionals.map { $0.1 ?? -1 }, [1, -1])
+
+        assertThrows(results.project(["noSuchCol"]) { $0.index }, named: "Invalid property name")
+        assertThrows(results.project(["stringListCol"]) { $0.index },
+                     reason: "Cannot project array property 'stringListCol'.")
+        assertThrows(results.project(["intCol"]) { $0.value("doubleCol") as Double },
+                     reason: "Property 'doubleCol' is not one of the projected properties.")
+    }
+
     func addObjectToResults() {
         let realm = realmWithTestPath()
         try! realm.write {
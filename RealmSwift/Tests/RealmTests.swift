@@ -473,6 +473,22 @@ class RealmTests: TestCase {
         assertThrows(try! Realm().dynamicObjects("Object"))
     }
 
+    func testPrepareQuery() {
+        let realm = try! Realm()
+        try! realm.write {
+            realm.create(SwiftIntObject.self, value: [100])
+            realm.create(SwiftIntObject.self, value: [200])
+            realm.create(SwiftIntObject.self, value: [300])
+        }
+
+        let query = realm.prepareQuery("intCol > $0", for: SwiftIntObject.self)
+        XCTAssertEqual(1, query.argumentCount)
+        XCTAssertEqual(2, query.results(100).count)
+        XCTAssertEqual(0, query.results(300).count)
+        XCTAssertEqual(300, query.results(200).first!.intCol)
+        assertThrows(query.results())
+    }
+
     func testDynamicObjectProperties() {
         try! Realm().write {
             try! Realm().create(SwiftObject.self)
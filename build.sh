@@ -67,6 +67,7 @@ command:
   test-tvos-devices:    tests ObjC & Swift tvOS frameworks on all attached tvOS devices
   test-osx:             tests OS X framework
   test-osx-swift:       tests RealmSwift OS X framework
+  benchmark-osx-object-server: runs the sync benchmarks against a local Object Server
   verify:               verifies docs, osx, osx-swift, ios-static, ios-dynamic, ios-swift, ios-device in both Debug and Release configurations, swiftlint
   docs:                 builds docs in docs/output
   examples:             builds all examples
@@ -710,6 +711,13 @@ case "$COMMAND" in
         exit 0
         ;;
 
+    "benchmark-osx-object-server")
+        mkdir -p build
+        export REALM_SYNC_BENCHMARK_OUTPUT="${REALM_SYNC_BENCHMARK_OUTPUT:-$(pwd)/build/sync-benchmarks.json}"
+        xc "-scheme 'Object Server Tests' -configuration Release -sdk macosx -only-testing:ObjectServerTests/RLMSyncBenchmarkTests test"
+        exit 0
+        ;;
+
     ######################################
     # Full verification
     ######################################